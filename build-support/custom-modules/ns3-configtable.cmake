@@ -146,6 +146,9 @@ macro(write_configtable)
   string(APPEND out "MPI Support                   : ")
   check_on_or_off("${NS3_MPI}" "${MPI_FOUND}")
 
+  string(APPEND out "Multithreaded simulation      : ")
+  check_on_or_off("${NS3_MTP}" "${NS3_MTP}")
+
   string(APPEND out "NS-3 Click Integration        : ")
   check_on_or_off("ON" "${NS3_CLICK}")
 
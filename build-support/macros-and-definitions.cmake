@@ -508,6 +508,10 @@ macro(process_options)
     add_definitions(-DENABLE_DES_METRICS)
   endif()
 
+  if(${NS3_MTP})
+    add_definitions(-DNS3_MTP)
+  endif()
+
   if(${NS3_SANITIZE} AND ${NS3_SANITIZE_MEMORY})
     message(
       FATAL_ERROR
@@ -515,10 +519,21 @@ macro(process_options)
     )
   endif()
 
+  if(${NS3_SANITIZE_THREAD} AND (${NS3_SANITIZE} OR ${NS3_SANITIZE_MEMORY}))
+    message(
+      FATAL_ERROR
+        "The thread sanitizer can't be used with other sanitizers. Disable one of them."
+    )
+  endif()
+
   if(${NS3_SANITIZE})
     set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsanitize=address,leak,undefined")
   endif()
 
+  if(${NS3_SANITIZE_THREAD})
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsanitize=thread")
+  endif()
+
   if(${NS3_SANITIZE_MEMORY})
     if(${CLANG})
       set(blacklistfile ${PROJECT_SOURCE_DIR}/memory-sanitizer-blacklist.txt)
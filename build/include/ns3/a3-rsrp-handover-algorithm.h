@@ -0,0 +1 @@
+/root/repo/src/lte/model/a3-rsrp-handover-algorithm.h
\ No newline at end of file
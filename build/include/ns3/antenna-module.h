@@ -0,0 +1 @@
+/tmp/baseinc/ns3/antenna-module.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/helper/application-container.h
\ No newline at end of file
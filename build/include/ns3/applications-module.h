@@ -0,0 +1 @@
+/tmp/baseinc/ns3/applications-module.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/arp-cache.h
\ No newline at end of file
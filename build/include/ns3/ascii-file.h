@@ -0,0 +1 @@
+/root/repo/src/core/model/ascii-file.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/attribute-accessor-helper.h
\ No newline at end of file
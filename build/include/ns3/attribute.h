@@ -0,0 +1 @@
+/root/repo/src/core/model/attribute.h
\ No newline at end of file
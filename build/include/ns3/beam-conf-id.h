@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/beam-conf-id.h
\ No newline at end of file
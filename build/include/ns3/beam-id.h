@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/beam-id.h
\ No newline at end of file
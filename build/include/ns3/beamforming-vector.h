@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/beamforming-vector.h
\ No newline at end of file
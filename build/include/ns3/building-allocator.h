@@ -0,0 +1 @@
+/root/repo/src/buildings/helper/building-allocator.h
\ No newline at end of file
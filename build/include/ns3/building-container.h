@@ -0,0 +1 @@
+/root/repo/src/buildings/helper/building-container.h
\ No newline at end of file
@@ -0,0 +1 @@
+/tmp/baseinc/ns3/buildings-module.h
\ No newline at end of file
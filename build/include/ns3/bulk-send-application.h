@@ -0,0 +1 @@
+/root/repo/src/applications/model/bulk-send-application.h
\ No newline at end of file
@@ -0,0 +1 @@
+/tmp/baseinc/ns3/config-store-config.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/config.h
\ No newline at end of file
@@ -0,0 +1 @@
+/tmp/baseinc/ns3/core-config.h
\ No newline at end of file
@@ -0,0 +1 @@
+/tmp/baseinc/ns3/csma-module.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet-apps/helper/dhcp-helper.h
\ No newline at end of file
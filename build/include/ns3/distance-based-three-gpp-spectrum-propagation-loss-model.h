@@ -0,0 +1 @@
+/root/repo/contrib/nr/utils/distance-based-three-gpp-spectrum-propagation-loss-model.h
\ No newline at end of file
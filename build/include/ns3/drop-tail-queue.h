@@ -0,0 +1 @@
+/root/repo/src/network/utils/drop-tail-queue.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/helper/emu-epc-helper.h
\ No newline at end of file
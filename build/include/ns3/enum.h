@@ -0,0 +1 @@
+/root/repo/src/core/model/enum.h
\ No newline at end of file
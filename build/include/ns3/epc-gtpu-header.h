@@ -0,0 +1 @@
+/root/repo/src/lte/model/epc-gtpu-header.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/epc-s1ap-sap.h
\ No newline at end of file
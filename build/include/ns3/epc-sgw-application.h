@@ -0,0 +1 @@
+/root/repo/src/lte/model/epc-sgw-application.h
\ No newline at end of file
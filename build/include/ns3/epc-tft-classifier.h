@@ -0,0 +1 @@
+/root/repo/src/lte/model/epc-tft-classifier.h
\ No newline at end of file
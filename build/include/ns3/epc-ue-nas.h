@@ -0,0 +1 @@
+/root/repo/src/lte/model/epc-ue-nas.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/epc-x2-header.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/ethernet-trailer.h
\ No newline at end of file
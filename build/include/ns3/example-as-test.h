@@ -0,0 +1 @@
+/root/repo/src/core/model/example-as-test.h
\ No newline at end of file
@@ -0,0 +1 @@
+/tmp/baseinc/ns3/fd-net-device-module.h
\ No newline at end of file
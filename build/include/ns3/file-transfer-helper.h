@@ -0,0 +1 @@
+/root/repo/contrib/nr/utils/file-transfer-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/tmp/baseinc/ns3/flow-monitor-module.h
\ No newline at end of file
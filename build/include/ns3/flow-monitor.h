@@ -0,0 +1 @@
+/root/repo/src/flow-monitor/model/flow-monitor.h
\ No newline at end of file
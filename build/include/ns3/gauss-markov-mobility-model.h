@@ -0,0 +1 @@
+/root/repo/src/mobility/model/gauss-markov-mobility-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/global-route-manager-impl.h
\ No newline at end of file
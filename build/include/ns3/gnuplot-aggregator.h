@@ -0,0 +1 @@
+/root/repo/src/stats/model/gnuplot-aggregator.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/hash-murmur3.h
\ No newline at end of file
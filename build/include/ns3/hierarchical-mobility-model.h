@@ -0,0 +1 @@
+/root/repo/src/mobility/model/hierarchical-mobility-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/inet-socket-address.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/inet6-socket-address.h
\ No newline at end of file
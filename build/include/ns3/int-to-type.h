@@ -0,0 +1 @@
+/root/repo/src/core/model/int-to-type.h
\ No newline at end of file
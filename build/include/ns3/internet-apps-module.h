@@ -0,0 +1 @@
+/tmp/baseinc/ns3/internet-apps-module.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/ipv4-routing-protocol.h
\ No newline at end of file
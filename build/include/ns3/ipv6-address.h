@@ -0,0 +1 @@
+/root/repo/src/network/utils/ipv6-address.h
\ No newline at end of file
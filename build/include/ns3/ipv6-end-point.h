@@ -0,0 +1 @@
+/root/repo/src/internet/model/ipv6-end-point.h
\ No newline at end of file
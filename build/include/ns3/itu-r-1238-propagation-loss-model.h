@@ -0,0 +1 @@
+/root/repo/src/buildings/model/itu-r-1238-propagation-loss-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/llc-snap-header.h
\ No newline at end of file
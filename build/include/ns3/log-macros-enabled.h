@@ -0,0 +1 @@
+/root/repo/src/core/model/log-macros-enabled.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/loopback-net-device.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-control-messages.h
\ No newline at end of file
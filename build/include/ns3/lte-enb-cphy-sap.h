@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-enb-cphy-sap.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-enb-phy.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-ffr-distributed-algorithm.h
\ No newline at end of file
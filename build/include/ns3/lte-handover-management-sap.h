@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-handover-management-sap.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-interference.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-rlc-sap.h
\ No newline at end of file
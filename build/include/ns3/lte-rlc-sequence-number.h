@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-rlc-sequence-number.h
\ No newline at end of file
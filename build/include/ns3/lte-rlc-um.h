@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-rlc-um.h
\ No newline at end of file
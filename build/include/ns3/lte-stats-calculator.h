@@ -0,0 +1 @@
+/root/repo/src/lte/helper/lte-stats-calculator.h
\ No newline at end of file
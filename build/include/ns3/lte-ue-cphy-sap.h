@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-ue-cphy-sap.h
\ No newline at end of file
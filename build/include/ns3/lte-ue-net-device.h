@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-ue-net-device.h
\ No newline at end of file
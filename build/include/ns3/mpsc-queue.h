@@ -0,0 +1 @@
+/root/repo/src/core/model/mpsc-queue.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/model/net-device.h
\ No newline at end of file
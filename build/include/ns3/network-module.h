@@ -0,0 +1 @@
+/tmp/baseinc/ns3/network-module.h
\ No newline at end of file
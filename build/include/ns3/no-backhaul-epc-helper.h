@@ -0,0 +1 @@
+/root/repo/src/lte/helper/no-backhaul-epc-helper.h
\ No newline at end of file
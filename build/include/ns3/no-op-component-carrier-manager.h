@@ -0,0 +1 @@
+/root/repo/src/lte/model/no-op-component-carrier-manager.h
\ No newline at end of file
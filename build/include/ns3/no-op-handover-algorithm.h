@@ -0,0 +1 @@
+/root/repo/src/lte/model/no-op-handover-algorithm.h
\ No newline at end of file
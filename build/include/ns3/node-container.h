@@ -0,0 +1 @@
+/root/repo/src/network/helper/node-container.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/helper/node-distribution-scenario-interface.h
\ No newline at end of file
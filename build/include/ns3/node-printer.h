@@ -0,0 +1 @@
+/root/repo/src/core/model/node-printer.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/non-communicating-net-device.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-amc.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/helper/nr-bearer-stats-connector.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-cg-occasion-table.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/utils/nr-columnar-stats-reader.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/helper/nr-columnar-stats.h
\ No newline at end of file
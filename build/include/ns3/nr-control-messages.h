@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-control-messages.h
\ No newline at end of file
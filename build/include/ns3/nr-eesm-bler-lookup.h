@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-eesm-bler-lookup.h
\ No newline at end of file
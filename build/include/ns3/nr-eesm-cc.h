@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-eesm-cc.h
\ No newline at end of file
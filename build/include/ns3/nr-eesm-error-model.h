@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-eesm-error-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-eesm-ir.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-eesm-sinr-kernel.h
\ No newline at end of file
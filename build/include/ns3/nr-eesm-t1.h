@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-eesm-t1.h
\ No newline at end of file
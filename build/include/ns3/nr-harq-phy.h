@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-harq-phy.h
\ No newline at end of file
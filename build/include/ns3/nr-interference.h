@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-interference.h
\ No newline at end of file
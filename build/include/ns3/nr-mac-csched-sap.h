@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-mac-csched-sap.h
\ No newline at end of file
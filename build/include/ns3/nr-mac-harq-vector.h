@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-mac-harq-vector.h
\ No newline at end of file
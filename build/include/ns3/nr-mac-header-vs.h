@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-mac-header-vs.h
\ No newline at end of file
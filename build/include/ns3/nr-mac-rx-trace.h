@@ -0,0 +1 @@
+/root/repo/contrib/nr/helper/nr-mac-rx-trace.h
\ No newline at end of file
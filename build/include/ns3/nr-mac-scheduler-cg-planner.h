@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-mac-scheduler-cg-planner.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-mac-scheduler-ofdma-edf.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-mac-scheduler.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-mac-short-bsr-ce.h
\ No newline at end of file
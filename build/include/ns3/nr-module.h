@@ -0,0 +1 @@
+/tmp/baseinc/ns3/nr-module.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-radio-bearer-tag.h
\ No newline at end of file
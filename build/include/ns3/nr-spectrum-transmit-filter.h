@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/nr-spectrum-transmit-filter.h
\ No newline at end of file
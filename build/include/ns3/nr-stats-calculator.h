@@ -0,0 +1 @@
+/root/repo/contrib/nr/helper/nr-stats-calculator.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/helper/nr-trace-sink.h
\ No newline at end of file
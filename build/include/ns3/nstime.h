@@ -0,0 +1 @@
+/root/repo/src/core/model/nstime.h
\ No newline at end of file
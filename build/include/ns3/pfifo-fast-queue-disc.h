@@ -0,0 +1 @@
+/root/repo/src/traffic-control/model/pfifo-fast-queue-disc.h
\ No newline at end of file
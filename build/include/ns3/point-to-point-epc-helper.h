@@ -0,0 +1 @@
+/root/repo/src/lte/helper/point-to-point-epc-helper.h
\ No newline at end of file
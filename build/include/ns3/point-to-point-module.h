@@ -0,0 +1 @@
+/tmp/baseinc/ns3/point-to-point-module.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/helper/radio-environment-map-helper.h
\ No newline at end of file
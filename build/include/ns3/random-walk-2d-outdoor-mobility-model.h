@@ -0,0 +1 @@
+/root/repo/src/buildings/model/random-walk-2d-outdoor-mobility-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/helper/rip-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/ripng-header.h
\ No newline at end of file
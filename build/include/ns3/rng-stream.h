@@ -0,0 +1 @@
+/root/repo/src/core/model/rng-stream.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/rtt-estimator.h
\ No newline at end of file
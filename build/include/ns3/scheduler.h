@@ -0,0 +1 @@
+/root/repo/src/core/model/scheduler.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/applications/model/seq-ts-echo-header.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/contrib/nr/model/sfnsf.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/helper/simple-net-device-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/simple-net-device.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/simple-ref-count.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/simulation-singleton.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/simulator.h
\ No newline at end of file
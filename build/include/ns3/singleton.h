@@ -0,0 +1 @@
+/root/repo/src/core/model/singleton.h
\ No newline at end of file
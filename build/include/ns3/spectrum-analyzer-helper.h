@@ -0,0 +1 @@
+/root/repo/src/spectrum/helper/spectrum-analyzer-helper.h
\ No newline at end of file
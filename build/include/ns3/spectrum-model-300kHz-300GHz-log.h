@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/spectrum-model-300kHz-300GHz-log.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/spectrum-phy.h
\ No newline at end of file
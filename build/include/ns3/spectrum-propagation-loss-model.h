@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/spectrum-propagation-loss-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/spectrum-transmit-filter.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/system-wall-clock-ms.h
\ No newline at end of file
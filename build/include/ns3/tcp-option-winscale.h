@@ -0,0 +1 @@
+/root/repo/src/internet/model/tcp-option-winscale.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/tcp-rate-ops.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/tcp-westwood.h
\ No newline at end of file
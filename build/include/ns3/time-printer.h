@@ -0,0 +1 @@
+/root/repo/src/core/model/time-printer.h
\ No newline at end of file
@@ -0,0 +1 @@
+/tmp/baseinc/ns3/traffic-control-module.h
\ No newline at end of file
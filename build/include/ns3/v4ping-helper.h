@@ -0,0 +1 @@
+/root/repo/src/internet-apps/helper/v4ping-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet-apps/model/v4ping.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/val-array.h
\ No newline at end of file
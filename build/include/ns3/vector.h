@@ -0,0 +1 @@
+/root/repo/src/core/model/vector.h
\ No newline at end of file
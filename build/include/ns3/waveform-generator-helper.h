@@ -0,0 +1 @@
+/root/repo/src/spectrum/helper/waveform-generator-helper.h
\ No newline at end of file
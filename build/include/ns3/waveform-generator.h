@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/waveform-generator.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/worker-pool.h
\ No newline at end of file
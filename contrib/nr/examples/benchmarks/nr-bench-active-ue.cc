@@ -0,0 +1,253 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "ns3/core-module.h"
+#include "ns3/nr-gnb-mac.h"
+#include "ns3/nr-phy-sap.h"
+#include "ns3/nr-amc.h"
+#include "ns3/nr-mac-scheduler-ofdma-rr.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * \file nr-bench-active-ue.cc
+ * \ingroup examples
+ * \brief Benchmark of the computation of the active UEs of a slot.
+ *
+ * At every DL slot, the scheduler looks at the UEs with buffered data, and marks as active
+ * the ones that have data to transmit and a free HARQ process
+ * (NrMacSchedulerNs3::ComputeActiveUe). The benchmark configures a number of
+ * UEs, all with DL data and with a number of HARQ processes in use (each one
+ * with its DCI and its RLC PDUs), and computes the active UEs:
+ *
+ * - copying the HARQ vector of each UE, as the scheduler did before using
+ *   a reference to it;
+ * - with the reference to the HARQ vector.
+ *
+ * For each configuration, the benchmark prints the time per slot of both,
+ * and whether they found the same number of active UEs.
+ *
+ * ./ns3 run "nr-bench-active-ue --slots=1000 --ues=500 --harq=16"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NrBenchActiveUe");
+
+/**
+ * \brief Fake PHY, that only tells the slot composition
+ */
+class BenchPhySapProvider : public NrPhySapProvider
+{
+public:
+  virtual uint32_t GetSymbolsPerSlot () const override { return 14; }
+  virtual Ptr<const SpectrumModel> GetSpectrumModel () override { return nullptr; }
+  virtual uint16_t GetBwpId () const override { return 0; }
+  virtual uint16_t GetCellId () const override { return 0; }
+  virtual Time GetSlotPeriod () const override { return MicroSeconds (500); }
+  virtual void SendMacPdu (const Ptr<Packet> &p, const SfnSf &sfn, uint8_t symStart, uint8_t streamId) override {}
+  virtual void SendControlMessage (Ptr<NrControlMessage> msg) override {}
+  virtual void SendRachPreamble (uint8_t PreambleId, uint8_t Rnti) override {}
+  virtual void SetSlotAllocInfo (const SlotAllocInfo &slotAllocInfo) override {}
+  virtual void NotifyConnectionSuccessful () override {}
+  virtual uint32_t GetRbNum () const override { return 0; }
+  virtual void NotifyMacActivity () override {}
+  virtual BeamConfId GetBeamConfId (uint8_t rnti) const override
+  {
+    return BeamConfId (BeamId (0, 0.0), BeamId::GetEmptyBeamId ());
+  }
+  virtual Time GetTbUlEncodeLatency () const override { return Time (0); }
+};
+
+/**
+ * \brief Scheduler with the computation of the active UEs made public
+ */
+class BenchScheduler : public NrMacSchedulerOfdmaRR
+{
+public:
+  using NrMacSchedulerOfdmaRR::ComputeActiveUe;
+  using NrMacSchedulerOfdmaRR::GetUeInfo;
+  using NrMacSchedulerOfdmaRR::ActiveUeMap;
+};
+
+/**
+ * \brief Configure the scheduler, its UEs, their DL buffer and HARQ processes
+ * \param scheduler the scheduler
+ * \param mac the MAC (created by the function)
+ * \param phy the PHY
+ * \param numUes the number of UEs
+ * \param numHarq the number of HARQ processes per UE
+ * \param usedHarq the number of HARQ processes in use per UE
+ */
+static void
+Configure (const Ptr<BenchScheduler> &scheduler, Ptr<NrGnbMac> *mac, BenchPhySapProvider *phy,
+           uint32_t numUes, uint8_t numHarq, uint8_t usedHarq)
+{
+  *mac = CreateObject<NrGnbMac> ();
+  (*mac)->SetNumHarqProcess (numHarq);
+  (*mac)->SetNrMacSchedSapProvider (scheduler->GetMacSchedSapProvider ());
+  (*mac)->SetNrMacCschedSapProvider (scheduler->GetMacCschedSapProvider ());
+  (*mac)->SetPhySapProvider (phy);
+  scheduler->SetMacSchedSapUser ((*mac)->GetNrMacSchedSapUser ());
+  scheduler->SetMacCschedSapUser ((*mac)->GetNrMacCschedSapUser ());
+
+  NrMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_ulBandwidth = 106;
+  cellParams.m_dlBandwidth = 106;
+  scheduler->DoCschedCellConfigReq (cellParams);
+  scheduler->InstallDlAmc (CreateObject<NrAmc> ());
+  scheduler->InstallUlAmc (CreateObject<NrAmc> ());
+
+  for (uint32_t i = 0; i < numUes; ++i)
+    {
+      uint16_t rnti = static_cast<uint16_t> (i + 1);
+      NrMacCschedSapProvider::CschedUeConfigReqParameters paramsUe;
+      paramsUe.m_rnti = rnti;
+      paramsUe.m_beamConfId = phy->GetBeamConfId (0);
+      scheduler->DoCschedUeConfigReq (paramsUe);
+
+      NrMacCschedSapProvider::CschedLcConfigReqParameters paramsLc;
+      paramsLc.m_rnti = rnti;
+      paramsLc.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 1;
+      lc.m_logicalChannelGroup = 1;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_DL;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      paramsLc.m_logicalChannelConfigList.emplace_back (lc);
+      scheduler->DoCschedLcConfigReq (paramsLc);
+
+      NrMacSchedSapProvider::SchedDlRlcBufferReqParameters buffer;
+      buffer.m_rnti = rnti;
+      buffer.m_logicalChannelIdentity = 1;
+      buffer.m_rlcTransmissionQueueSize = 10000;
+      buffer.m_rlcTransmissionQueueHolDelay = 0;
+      buffer.m_rlcRetransmissionQueueSize = 0;
+      buffer.m_rlcRetransmissionHolDelay = 0;
+      buffer.m_rlcStatusPduSize = 0;
+      scheduler->DoSchedDlRlcBufferReq (buffer);
+
+      auto &harq = scheduler->GetUeInfo (rnti)->m_dlHarq;
+      for (uint8_t p = 0; p < usedHarq; ++p)
+        {
+          auto dci = std::make_shared<DciInfoElementTdma> (rnti, DciInfoElementTdma::DL, 1, 2,
+                                                           std::vector<uint8_t> {10},
+                                                           std::vector<uint32_t> {2000},
+                                                           std::vector<uint8_t> {1},
+                                                           std::vector<uint8_t> {0},
+                                                           DciInfoElementTdma::DATA, 0, 1);
+          HarqProcess process (true, HarqProcess::WAITING_FEEDBACK, 0, dci);
+          process.m_rlcPduInfo.emplace_back (4, RlcPduInfo (1, 500));
+          uint8_t id;
+          harq.Insert (&id, process);
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t slots = 1000;
+  uint32_t ues = 500;
+  uint32_t harq = 16;
+
+  CommandLine cmd;
+  cmd.AddValue ("slots", "Number of slots for each configuration", slots);
+  cmd.AddValue ("ues", "Number of UEs", ues);
+  cmd.AddValue ("harq", "Number of HARQ processes per UE", harq);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (6) << "UEs"
+            << std::setw (6) << "HARQ"
+            << std::setw (6) << "used"
+            << std::setw (14) << "copy us"
+            << std::setw (14) << "ref us"
+            << std::setw (10) << "speedup"
+            << std::setw (8) << "active"
+            << std::setw (8) << "same" << std::endl;
+
+  for (uint32_t used : {0u, harq / 4, harq / 2, harq - 1, harq})
+    {
+      BenchPhySapProvider phy;
+      Ptr<BenchScheduler> scheduler = CreateObject<BenchScheduler> ();
+      Ptr<NrGnbMac> mac;
+      Configure (scheduler, &mac, &phy, ues, static_cast<uint8_t> (harq), static_cast<uint8_t> (used));
+
+      // All the UEs have DL data
+      std::vector<UePtr> buffered;
+      for (uint32_t i = 0; i < ues; ++i)
+        {
+          buffered.push_back (scheduler->GetUeInfo (static_cast<uint16_t> (i + 1)));
+        }
+
+      // The copy is returned through a reference, as the function type requires
+      NrMacHarqVector copy;
+      NrMacSchedulerUeInfo::GetHarqVectorFn copyHarq = [&copy] (const UePtr &ue) -> NrMacHarqVector &
+        {
+          copy = NrMacHarqVector (ue->m_dlHarq);
+          return copy;
+        };
+
+      double copyNs = 0.0;
+      double refNs = 0.0;
+      bool same = true;
+      std::size_t active = 0;
+      for (uint32_t slot = 0; slot < slots; ++slot)
+        {
+          BenchScheduler::ActiveUeMap copyActive;
+          BenchScheduler::ActiveUeMap refActive;
+          auto start = std::chrono::steady_clock::now ();
+          scheduler->ComputeActiveUe (&copyActive, &buffered, &NrMacSchedulerUeInfo::GetDlLCG,
+                                      copyHarq, "DL");
+          auto mid = std::chrono::steady_clock::now ();
+          scheduler->ComputeActiveUe (&refActive, &buffered, &NrMacSchedulerUeInfo::GetDlLCG,
+                                      &NrMacSchedulerUeInfo::GetDlHarqVector, "DL");
+          auto end = std::chrono::steady_clock::now ();
+          copyNs += std::chrono::duration<double, std::nano> (mid - start).count ();
+          refNs += std::chrono::duration<double, std::nano> (end - mid).count ();
+
+          std::size_t copyCount = 0;
+          std::size_t refCount = 0;
+          for (const auto &beam : copyActive)
+            {
+              copyCount += beam.second.size ();
+            }
+          for (const auto &beam : refActive)
+            {
+              refCount += beam.second.size ();
+            }
+          same = same && copyCount == refCount;
+          active = refCount;
+        }
+
+      std::cout << std::setw (6) << ues
+                << std::setw (6) << harq
+                << std::setw (6) << used
+                << std::fixed << std::setprecision (1)
+                << std::setw (14) << copyNs / 1e3 / slots
+                << std::setw (14) << refNs / 1e3 / slots
+                << std::setw (10) << std::setprecision (2) << copyNs / std::max (refNs, 1.0)
+                << std::setw (8) << active
+                << std::setw (8) << (same ? "yes" : "no")
+                << std::defaultfloat << std::endl;
+    }
+
+  return 0;
+}
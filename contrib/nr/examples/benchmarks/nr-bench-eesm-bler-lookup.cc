@@ -0,0 +1,175 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/nr-eesm-t1.h"
+#include "ns3/nr-eesm-t2.h"
+#include "ns3/nr-eesm-bler-lookup.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * \file nr-bench-eesm-bler-lookup.cc
+ * \ingroup examples
+ * \brief Microbenchmark of the BLER-SINR table lookup of the EESM error model.
+ *
+ * The benchmark draws a set of random (base graph, MCS, CB size, SINR)
+ * queries and resolves them with two methods:
+ *
+ * - the original search, which copies the per-MCS map of curves out of the
+ *   table, looks up the CB size in the map and binary-searches the SINR
+ *   vector of the selected curve;
+ * - the compiled lookup in NrEesmBlerLookup.
+ *
+ * Both methods must return the same BLER for every query; the benchmark aborts
+ * otherwise. For each MCS table, it prints the time per query of both methods.
+ *
+ * ./ns3 run "nr-bench-eesm-bler-lookup --queries=100000 --rounds=20"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NrBenchEesmBlerLookup");
+
+/**
+ * \brief A lookup query
+ */
+struct Query
+{
+  uint8_t m_bg;        //!< Base graph type
+  uint8_t m_mcs;       //!< MCS
+  uint32_t m_cbSize;   //!< CB size (bits)
+  double m_sinrDb;     //!< SINR (dB)
+};
+
+/**
+ * \brief The search that NrEesmErrorModel::MappingSinrBler did before the compiled lookup
+ */
+static double
+LegacyBler (const NrEesmErrorModel::SimulatedBlerFromSINR *table, const Query &q)
+{
+  auto cbMap = table->at (q.m_bg).at (q.m_mcs);
+  auto cbIt = cbMap.upper_bound (q.m_cbSize);
+  if (cbIt != cbMap.begin ())
+    {
+      cbIt--;
+    }
+
+  const std::vector<double> &sinr = std::get<0> (table->at (q.m_bg).at (q.m_mcs).at (cbIt->first));
+  const std::vector<double> &bler = std::get<1> (table->at (q.m_bg).at (q.m_mcs).at (cbIt->first));
+  if (q.m_sinrDb < sinr.front ())
+    {
+      return 1.0;
+    }
+  else if (q.m_sinrDb > sinr.back ())
+    {
+      return 0.0;
+    }
+  auto sinrIt = std::upper_bound (sinr.begin (), sinr.end (), q.m_sinrDb);
+  if (sinrIt != sinr.begin ())
+    {
+      sinrIt--;
+    }
+  return bler.at (std::distance (sinr.begin (), sinrIt));
+}
+
+/**
+ * \brief Run the benchmark over a table
+ * \param name name of the table
+ * \param table the original table
+ * \param lookup the compiled table
+ * \param queries number of queries
+ * \param rounds number of times the queries are repeated
+ */
+static void
+Bench (const std::string &name, const NrEesmErrorModel::SimulatedBlerFromSINR *table,
+       const NrEesmBlerLookup *lookup, uint32_t queries, uint32_t rounds)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<Query> q (queries);
+  for (auto &v : q)
+    {
+      v.m_bg = static_cast<uint8_t> (rng->GetInteger (0, table->size () - 1));
+      v.m_mcs = static_cast<uint8_t> (rng->GetInteger (0, table->at (v.m_bg).size () - 1));
+      v.m_cbSize = rng->GetInteger (40, 8448);
+      v.m_sinrDb = rng->GetValue (-5.0, 30.0);
+    }
+
+  for (const auto &v : q)
+    {
+      NS_ABORT_MSG_IF (LegacyBler (table, v) != lookup->GetBler (v.m_bg, v.m_mcs, v.m_cbSize, v.m_sinrDb),
+                       "Mismatch for BG " << +v.m_bg << " MCS " << +v.m_mcs <<
+                       " CBS " << v.m_cbSize << " SINR " << v.m_sinrDb);
+    }
+
+  double sum = 0.0; // keeps the optimizer from dropping the loops
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  for (uint32_t r = 0; r < rounds; ++r)
+    {
+      for (const auto &v : q)
+        {
+          sum += LegacyBler (table, v);
+        }
+    }
+  int64_t legacyMs = clock.End ();
+
+  clock.Start ();
+  for (uint32_t r = 0; r < rounds; ++r)
+    {
+      for (const auto &v : q)
+        {
+          sum += lookup->GetBler (v.m_bg, v.m_mcs, v.m_cbSize, v.m_sinrDb);
+        }
+    }
+  int64_t compiledMs = clock.End ();
+
+  double total = static_cast<double> (queries) * rounds;
+  std::cout << std::fixed << std::setprecision (1)
+            << name << ": " << total << " lookups, compiled table "
+            << lookup->GetMemoryUsage () / 1024.0 << " KiB" << std::endl
+            << "  legacy   " << std::setw (10) << legacyMs << " ms "
+            << std::setw (10) << legacyMs * 1e6 / total << " ns/lookup" << std::endl
+            << "  compiled " << std::setw (10) << compiledMs << " ms "
+            << std::setw (10) << compiledMs * 1e6 / total << " ns/lookup" << std::endl
+            << "  speedup  " << std::setprecision (2)
+            << static_cast<double> (legacyMs) / std::max<int64_t> (compiledMs, 1)
+            << " (checksum " << sum << ")" << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t queries = 100000;
+  uint32_t rounds = 20;
+
+  CommandLine cmd;
+  cmd.AddValue ("queries", "Number of random lookups", queries);
+  cmd.AddValue ("rounds", "Number of times the lookups are repeated", rounds);
+  cmd.Parse (argc, argv);
+
+  NrEesmT1 t1;
+  NrEesmT2 t2;
+  Bench ("Table1", t1.m_simulatedBlerFromSINR, t1.m_blerLookup, queries, rounds);
+  Bench ("Table2", t2.m_simulatedBlerFromSINR, t2.m_blerLookup, queries, rounds);
+
+  return 0;
+}
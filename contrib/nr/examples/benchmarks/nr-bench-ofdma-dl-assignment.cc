@@ -0,0 +1,322 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "ns3/core-module.h"
+#include "ns3/nr-gnb-mac.h"
+#include "ns3/nr-phy-sap.h"
+#include "ns3/nr-amc.h"
+#include "ns3/nr-mac-scheduler-ofdma-rr.h"
+#include "ns3/nr-mac-scheduler-ofdma-pf.h"
+#include "ns3/nr-mac-scheduler-ofdma-mr.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * \file nr-bench-ofdma-dl-assignment.cc
+ * \ingroup examples
+ * \brief Scaling benchmark of the DL RBG assignment of the OFDMA schedulers.
+ *
+ * For the RR, PF and MR OFDMA schedulers, the benchmark creates a number of
+ * UEs with random MCS and buffer, and assigns the DL RBGs of a slot with:
+ *
+ * - the legacy loop, that sorted all the UEs at every RBG and then
+ *   updated the metric of all the UEs that did not get it;
+ * - NrMacSchedulerOfdma::AssignDLRBG, that keeps the UEs in a heap.
+ *
+ * The two methods run on two identical schedulers. For each scheduler,
+ * number of UEs and bandwidth, the benchmark prints the time per slot of
+ * both, and whether they assigned the same amounts of RBGs (as RR assigns
+ * the same amount to UEs with the same metric, the RBGs are compared as a
+ * sorted list of per-UE amounts).
+ *
+ * ./ns3 run "nr-bench-ofdma-dl-assignment --slots=100"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NrBenchOfdmaDlAssignment");
+
+/**
+ * \brief Fake PHY, that only tells the slot composition
+ */
+class BenchPhySapProvider : public NrPhySapProvider
+{
+public:
+  virtual uint32_t GetSymbolsPerSlot () const override { return 14; }
+  virtual Ptr<const SpectrumModel> GetSpectrumModel () override { return nullptr; }
+  virtual uint16_t GetBwpId () const override { return 0; }
+  virtual uint16_t GetCellId () const override { return 0; }
+  virtual Time GetSlotPeriod () const override { return MicroSeconds (500); }
+  virtual void SendMacPdu (const Ptr<Packet> &p, const SfnSf &sfn, uint8_t symStart, uint8_t streamId) override {}
+  virtual void SendControlMessage (Ptr<NrControlMessage> msg) override {}
+  virtual void SendRachPreamble (uint8_t PreambleId, uint8_t Rnti) override {}
+  virtual void SetSlotAllocInfo (const SlotAllocInfo &slotAllocInfo) override {}
+  virtual void NotifyConnectionSuccessful () override {}
+  virtual uint32_t GetRbNum () const override { return 0; }
+  virtual void NotifyMacActivity () override {}
+  virtual BeamConfId GetBeamConfId (uint8_t rnti) const override
+  {
+    return BeamConfId (BeamId (0, 0.0), BeamId::GetEmptyBeamId ());
+  }
+  virtual Time GetTbUlEncodeLatency () const override { return Time (0); }
+};
+
+/**
+ * \brief Interface of the benchmarked schedulers
+ */
+class BenchScheduler
+{
+public:
+  virtual ~BenchScheduler () = default;
+  /**
+   * \return the scheduler
+   */
+  virtual Ptr<NrMacSchedulerNs3> Get () const = 0;
+  /**
+   * \brief Assign the DL RBGs of a slot
+   * \param legacy true to use the legacy loop
+   * \param active the active UEs, with their buffer
+   * \return the DL RBGs of each UE
+   */
+  virtual std::vector<uint32_t> AssignDl (bool legacy, const std::vector<std::pair<uint16_t, uint32_t>> &active) = 0;
+};
+
+/**
+ * \brief Gives access to the DL assignment of a scheduler
+ */
+template <class T>
+class BenchSchedulerT : public BenchScheduler
+{
+public:
+  /**
+   * \brief Scheduler with the protected methods made public, and the legacy loop
+   */
+  class Sched : public T
+  {
+  public:
+    using T::AssignDLRBG;
+    using T::GetUeInfo;
+    using typename T::UePtrAndBufferReq;
+    using typename T::ActiveUeMap;
+    using typename T::FTResources;
+
+    /**
+     * \brief The DL assignment as it was before the heap
+     * \param symAvail the available symbols
+     * \param activeDl the active UEs
+     */
+    void LegacyAssignDLRBG (uint32_t symAvail, const ActiveUeMap &activeDl) const
+    {
+      auto symPerBeam = this->GetSymPerBeam (symAvail, activeDl);
+      for (const auto &el : activeDl)
+        {
+          uint32_t beamSym = symPerBeam.at (el.first);
+          uint32_t rbgAssignable = 1 * beamSym;
+          std::vector<UePtrAndBufferReq> ueVector (el.second);
+          FTResources assigned (0,0);
+          uint32_t resources = this->GetBandwidthInRbg ();
+
+          for (auto &ue : ueVector)
+            {
+              this->BeforeDlSched (ue, FTResources (rbgAssignable * beamSym, beamSym));
+            }
+
+          while (resources > 0)
+            {
+              std::sort (ueVector.begin (), ueVector.end (), this->GetUeCompareDlFn ());
+              auto schedInfoIt = ueVector.begin ();
+              while (schedInfoIt != ueVector.end () && this->IsDlBufferCovered (*schedInfoIt))
+                {
+                  schedInfoIt++;
+                }
+              if (schedInfoIt == ueVector.end ())
+                {
+                  break;
+                }
+
+              schedInfoIt->first->m_dlRBG += rbgAssignable;
+              assigned.m_rbg += rbgAssignable;
+              schedInfoIt->first->m_dlSym = beamSym;
+              assigned.m_sym = beamSym;
+              resources -= 1;
+
+              this->AssignedDlResources (*schedInfoIt, FTResources (rbgAssignable, beamSym), assigned);
+              for (auto &ue : ueVector)
+                {
+                  if (ue.first->m_rnti != schedInfoIt->first->m_rnti)
+                    {
+                      this->NotAssignedDlResources (ue, FTResources (rbgAssignable, beamSym), assigned);
+                    }
+                }
+            }
+        }
+    }
+  };
+
+  BenchSchedulerT () : m_sched (CreateObject<Sched> ())
+  {
+  }
+
+  virtual Ptr<NrMacSchedulerNs3> Get () const override
+  {
+    return m_sched;
+  }
+
+  virtual std::vector<uint32_t> AssignDl (bool legacy, const std::vector<std::pair<uint16_t, uint32_t>> &active) override
+  {
+    typename Sched::ActiveUeMap activeDl;
+    auto &ueVector = activeDl[BeamConfId (BeamId (0, 0.0), BeamId::GetEmptyBeamId ())];
+    ueVector.reserve (active.size ());
+    for (const auto &ue : active)
+      {
+        auto ueInfo = m_sched->GetUeInfo (ue.first);
+        ueInfo->ResetDlSchedInfo ();
+        ueVector.emplace_back (ueInfo, ue.second);
+      }
+    legacy ? m_sched->LegacyAssignDLRBG (13, activeDl) : (void) m_sched->AssignDLRBG (13, activeDl);
+
+    std::vector<uint32_t> rbg;
+    for (const auto &ue : ueVector)
+      {
+        rbg.push_back (ue.first->m_dlRBG);
+      }
+    return rbg;
+  }
+
+private:
+  Ptr<Sched> m_sched; //!< The scheduler
+};
+
+/**
+ * \brief Configure the scheduler and its UEs
+ * \param sched the scheduler
+ * \param mac the MAC (created by the function)
+ * \param phy the PHY
+ * \param bandwidth the bandwidth, in RBs
+ * \param mcs the DL MCS of each UE
+ */
+static void
+Configure (BenchScheduler *sched, Ptr<NrGnbMac> *mac, BenchPhySapProvider *phy,
+           uint16_t bandwidth, const std::vector<uint8_t> &mcs)
+{
+  Ptr<NrMacSchedulerNs3> scheduler = sched->Get ();
+  *mac = CreateObject<NrGnbMac> ();
+  (*mac)->SetNrMacSchedSapProvider (scheduler->GetMacSchedSapProvider ());
+  (*mac)->SetNrMacCschedSapProvider (scheduler->GetMacCschedSapProvider ());
+  (*mac)->SetPhySapProvider (phy);
+  scheduler->SetMacSchedSapUser ((*mac)->GetNrMacSchedSapUser ());
+  scheduler->SetMacCschedSapUser ((*mac)->GetNrMacCschedSapUser ());
+
+  NrMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_ulBandwidth = bandwidth;
+  cellParams.m_dlBandwidth = bandwidth;
+  scheduler->DoCschedCellConfigReq (cellParams);
+  scheduler->InstallDlAmc (CreateObject<NrAmc> ());
+  scheduler->InstallUlAmc (CreateObject<NrAmc> ());
+
+  for (uint32_t i = 0; i < mcs.size (); ++i)
+    {
+      NrMacCschedSapProvider::CschedUeConfigReqParameters paramsUe;
+      paramsUe.m_rnti = static_cast<uint16_t> (i + 1);
+      paramsUe.m_beamConfId = phy->GetBeamConfId (0);
+      scheduler->DoCschedUeConfigReq (paramsUe);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t slots = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("slots", "Number of slots assigned for each configuration", slots);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (6) << "sched"
+            << std::setw (6) << "UEs"
+            << std::setw (6) << "RBs"
+            << std::setw (14) << "legacy us"
+            << std::setw (14) << "heap us"
+            << std::setw (10) << "speedup"
+            << std::setw (8) << "same" << std::endl;
+
+  std::vector<std::pair<std::string, std::function<BenchScheduler * ()>>> schedulers = {
+    {"RR", [] () { return new BenchSchedulerT<NrMacSchedulerOfdmaRR> (); }},
+    {"PF", [] () { return new BenchSchedulerT<NrMacSchedulerOfdmaPF> (); }},
+    {"MR", [] () { return new BenchSchedulerT<NrMacSchedulerOfdmaMR> (); }},
+  };
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  for (const auto &s : schedulers)
+    {
+      for (uint16_t bandwidth : {52, 106, 273})
+        {
+          for (uint32_t numUes : {10, 50, 100, 250, 500, 1000})
+            {
+              std::vector<uint8_t> mcs;
+              std::vector<std::pair<uint16_t, uint32_t>> active;
+              for (uint32_t i = 0; i < numUes; ++i)
+                {
+                  mcs.push_back (static_cast<uint8_t> (rng->GetInteger (0, 27)));
+                  active.emplace_back (static_cast<uint16_t> (i + 1), rng->GetInteger (100, 20000));
+                }
+
+              BenchPhySapProvider phy;
+              std::unique_ptr<BenchScheduler> legacy (s.second ());
+              std::unique_ptr<BenchScheduler> heap (s.second ());
+              Ptr<NrGnbMac> legacyMac;
+              Ptr<NrGnbMac> heapMac;
+              Configure (legacy.get (), &legacyMac, &phy, bandwidth, mcs);
+              Configure (heap.get (), &heapMac, &phy, bandwidth, mcs);
+
+              double legacyNs = 0.0;
+              double heapNs = 0.0;
+              bool same = true;
+              for (uint32_t slot = 0; slot < slots; ++slot)
+                {
+                  auto start = std::chrono::steady_clock::now ();
+                  std::vector<uint32_t> legacyRbg = legacy->AssignDl (true, active);
+                  auto mid = std::chrono::steady_clock::now ();
+                  std::vector<uint32_t> heapRbg = heap->AssignDl (false, active);
+                  auto end = std::chrono::steady_clock::now ();
+                  legacyNs += std::chrono::duration<double, std::nano> (mid - start).count ();
+                  heapNs += std::chrono::duration<double, std::nano> (end - mid).count ();
+
+                  std::sort (legacyRbg.begin (), legacyRbg.end ());
+                  std::sort (heapRbg.begin (), heapRbg.end ());
+                  same = same && legacyRbg == heapRbg;
+                }
+
+              std::cout << std::setw (6) << s.first
+                        << std::setw (6) << numUes
+                        << std::setw (6) << bandwidth
+                        << std::fixed << std::setprecision (1)
+                        << std::setw (14) << legacyNs / 1e3 / slots
+                        << std::setw (14) << heapNs / 1e3 / slots
+                        << std::setw (10) << std::setprecision (2) << legacyNs / std::max (heapNs, 1.0)
+                        << std::setw (8) << (same ? "yes" : "no")
+                        << std::defaultfloat << std::endl;
+            }
+        }
+    }
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/socket.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/lte-rlc-sdu-status-tag.h"
+#include "ns3/nr-radio-bearer-tag.h"
+#include <iomanip>
+#include <iostream>
+
+/**
+ * \file nr-bench-packet-tags.cc
+ * \ingroup examples
+ * \brief Cost of the packet tags of an NR PDU along an RLC, MAC, PHY, MAC,
+ * RLC round trip.
+ *
+ * Each iteration follows the packet tag operations of the downlink data
+ * path for one SDU:
+ *
+ * - the RLC tags the SDU with a LteRlcSduStatusTag, and segments it in two
+ *   PDUs with Packet::CreateFragment, updating the status tag of both, as
+ *   LteRlcUm::DoNotifyTxOpportunity does; it then removes the status tag;
+ * - the MAC adds a NrRadioBearerTag to each PDU;
+ * - each receiver of the signal peeks the NrRadioBearerTag, as
+ *   NrSpectrumPhy does, and the intended one copies the PDU;
+ * - the receiving MAC removes the NrRadioBearerTag from the copy.
+ *
+ * The SDU can carry a number of tags of the upper layers (socket and flow
+ * tags), which the PDUs inherit. The PacketTagList stores the first
+ * PacketTagList::INLINE_TAGS small tags inside the packet, so the round trip
+ * does not allocate unless there are more tags than that.
+ *
+ * It prints the time per SDU for each number of receivers and of upper
+ * layer tags; run it on two builds to compare their tag stores.
+ *
+ * ./ns3 run "nr-bench-packet-tags --iterations=200000"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NrBenchPacketTags");
+
+/**
+ * \brief Add upper layer tags to an SDU
+ * \param sdu the SDU
+ * \param upperTags the number of tags, up to 5
+ */
+static void
+AddUpperTags (Ptr<Packet> sdu, uint32_t upperTags)
+{
+  if (upperTags > 0)
+    {
+      SocketPriorityTag tag;
+      tag.SetPriority (1);
+      sdu->AddPacketTag (tag);
+    }
+  if (upperTags > 1)
+    {
+      SocketIpTosTag tag;
+      tag.SetTos (0xb8);
+      sdu->AddPacketTag (tag);
+    }
+  if (upperTags > 2)
+    {
+      SocketIpTtlTag tag;
+      tag.SetTtl (64);
+      sdu->AddPacketTag (tag);
+    }
+  if (upperTags > 3)
+    {
+      FlowIdTag tag (7);
+      sdu->AddPacketTag (tag);
+    }
+  if (upperTags > 4)
+    {
+      SocketIpv6HopLimitTag tag;
+      tag.SetHopLimit (64);
+      sdu->AddPacketTag (tag);
+    }
+}
+
+/**
+ * \brief Run the tag operations of the round trip of an SDU
+ * \param sduSize the size of the SDU
+ * \param upperTags the number of upper layer tags of the SDU
+ * \param receivers the number of receivers of each PDU
+ * \return the size of the received PDUs
+ */
+static uint32_t
+RoundTrip (uint32_t sduSize, uint32_t upperTags, uint32_t receivers)
+{
+  uint32_t rxSize = 0;
+
+  // RLC: the SDU enters the transmission buffer
+  Ptr<Packet> sdu = Create<Packet> (sduSize);
+  AddUpperTags (sdu, upperTags);
+  LteRlcSduStatusTag status;
+  status.SetStatus (LteRlcSduStatusTag::FULL_SDU);
+  sdu->AddPacketTag (status);
+
+  // RLC: segment the SDU in two PDUs
+  Ptr<Packet> segment = sdu->CreateFragment (0, sduSize / 2);
+  LteRlcSduStatusTag oldTag, newTag;
+  sdu->RemovePacketTag (oldTag);
+  segment->RemovePacketTag (newTag);
+  newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
+  oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
+  sdu->RemoveAtStart (sduSize / 2);
+  sdu->AddPacketTag (oldTag);
+  segment->AddPacketTag (newTag);
+
+  for (Ptr<Packet> pdu : {segment, sdu})
+    {
+      pdu->RemovePacketTag (status);
+
+      // MAC
+      NrRadioBearerTag bearerTag (1, 3, pdu->GetSize ());
+      pdu->AddPacketTag (bearerTag);
+
+      // PHY: every receiver of the signal looks at the tag
+      for (uint32_t r = 0; r < receivers; ++r)
+        {
+          NrRadioBearerTag rxTag;
+          NS_ABORT_IF (!pdu->PeekPacketTag (rxTag));
+          if (r == 0)
+            {
+              // MAC of the intended receiver
+              Ptr<Packet> rx = pdu->Copy ();
+              rx->RemovePacketTag (rxTag);
+              rxSize += rx->GetSize () + rxTag.GetRnti ();
+            }
+        }
+    }
+
+  return rxSize;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t iterations = 200000;
+  uint32_t sduSize = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue ("iterations", "Number of SDUs for each configuration", iterations);
+  cmd.AddValue ("sduSize", "Size of the SDUs, in bytes", sduSize);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Inline tags: " << PacketTagList::INLINE_TAGS
+            << " of up to " << PacketTagList::INLINE_TAG_SIZE << " bytes" << std::endl;
+  std::cout << std::setw (11) << "upper tags"
+            << std::setw (11) << "receivers"
+            << std::setw (12) << "ns per SDU" << std::endl;
+
+  for (uint32_t upperTags : {0, 2, 4, 5})
+    {
+      for (uint32_t receivers : {1, 4, 16})
+        {
+          uint64_t checksum = 0;  // keeps the optimizer from dropping the loop
+          SystemWallClockMs clock;
+          clock.Start ();
+          for (uint32_t i = 0; i < iterations; ++i)
+            {
+              checksum += RoundTrip (sduSize, upperTags, receivers);
+            }
+          int64_t ms = clock.End ();
+
+          NS_ABORT_IF (checksum == 0);
+          std::cout << std::setw (11) << upperTags
+                    << std::setw (11) << receivers << std::fixed << std::setprecision (1)
+                    << std::setw (12) << ms * 1e6 / iterations
+                    << std::defaultfloat << std::endl;
+        }
+    }
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/antenna-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/nr-spectrum-value-helper.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * \file nr-bench-parallel-start-tx.cc
+ * \ingroup examples
+ * \brief Scaling benchmark of the parallel computation of the received PSDs
+ * in MultiModelSpectrumChannel::StartTx.
+ *
+ * A gNB transmits to a number of UEs over a MultiModelSpectrumChannel with the
+ * 3GPP spectrum propagation loss model (UMi, 28 GHz). After a first
+ * transmission, that generates the channel matrices, the benchmark times the
+ * StartTx of the gNB transmissions with different values of the attribute
+ * MultiModelSpectrumChannel::NumThreads, and prints the time per transmission,
+ * the speedup over the serial computation, and whether the received PSDs are
+ * identical (bit by bit, and in the same order) to the serial ones.
+ *
+ * ./ns3 run "nr-bench-parallel-start-tx --txs=20 --rbs=273"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NrBenchParallelStartTx");
+
+/**
+ * \brief SpectrumPhy that hashes the PSDs that it receives
+ */
+class BenchRxPhy : public SpectrumPhy
+{
+public:
+  /**
+   * \brief Constructor
+   * \param model the spectrum model
+   * \param antenna the antenna
+   * \param hash the hash of all the receptions
+   */
+  BenchRxPhy (Ptr<const SpectrumModel> model, Ptr<PhasedArrayModel> antenna, uint64_t *hash)
+    : m_model (model), m_antenna (antenna), m_hash (hash)
+  {}
+
+  virtual void SetDevice (Ptr<NetDevice> d) override { m_device = d; }
+  virtual Ptr<NetDevice> GetDevice () const override { return m_device; }
+  virtual void SetMobility (Ptr<MobilityModel> m) override { m_mobility = m; }
+  virtual Ptr<MobilityModel> GetMobility () const override { return m_mobility; }
+  virtual void SetChannel (Ptr<SpectrumChannel> c) override {}
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const override { return m_model; }
+  virtual Ptr<Object> GetAntenna () const override { return m_antenna; }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params) override
+  {
+    // FNV-1a over the node id and the bits of the PSD values
+    auto mix = [this] (uint64_t v)
+      {
+        *m_hash = (*m_hash ^ v) * 1099511628211ULL;
+      };
+    mix (m_device->GetNode ()->GetId ());
+    for (auto it = params->psd->ConstValuesBegin (); it != params->psd->ConstValuesEnd (); ++it)
+      {
+        uint64_t bits;
+        std::memcpy (&bits, &(*it), sizeof (bits));
+        mix (bits);
+      }
+  }
+
+private:
+  Ptr<const SpectrumModel> m_model;  //!< Spectrum model
+  Ptr<PhasedArrayModel> m_antenna;   //!< Antenna
+  Ptr<NetDevice> m_device;           //!< Device
+  Ptr<MobilityModel> m_mobility;     //!< Mobility
+  uint64_t *m_hash;                  //!< Hash of the receptions
+};
+
+/**
+ * \brief Create a node with a device, a mobility model and a BenchRxPhy
+ * \param position the position of the node
+ * \param rows the rows of the antenna array
+ * \param columns the columns of the antenna array
+ * \param model the spectrum model
+ * \param hash the hash of the receptions
+ * \return the phy
+ */
+static Ptr<BenchRxPhy>
+CreatePhy (const Vector &position, uint32_t rows, uint32_t columns,
+           Ptr<const SpectrumModel> model, uint64_t *hash)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+  node->AddDevice (dev);
+  dev->SetNode (node);
+  Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+  mob->SetPosition (position);
+  node->AggregateObject (mob);
+
+  Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray> (
+    "NumRows", UintegerValue (rows), "NumColumns", UintegerValue (columns),
+    "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+  Ptr<BenchRxPhy> phy = Create<BenchRxPhy> (model, antenna, hash);
+  phy->SetDevice (dev);
+  phy->SetMobility (mob);
+  return phy;
+}
+
+/**
+ * \brief Point the beam of a phy towards another
+ * \param phy the phy
+ * \param other the phy to point at
+ */
+static void
+PointBeam (Ptr<BenchRxPhy> phy, Ptr<BenchRxPhy> other)
+{
+  Ptr<PhasedArrayModel> antenna = DynamicCast<PhasedArrayModel> (phy->GetAntenna ());
+  Angles angles (other->GetMobility ()->GetPosition (), phy->GetMobility ()->GetPosition ());
+  antenna->SetBeamformingVector (antenna->GetBeamformingVector (angles));
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t txs = 20;
+  uint32_t rbs = 273;
+  uint32_t maxThreads = 8;
+
+  CommandLine cmd;
+  cmd.AddValue ("txs", "Number of timed transmissions for each configuration", txs);
+  cmd.AddValue ("rbs", "Number of RBs of the PSD", rbs);
+  cmd.AddValue ("maxThreads", "Maximum number of threads", maxThreads);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (6) << "UEs"
+            << std::setw (9) << "threads"
+            << std::setw (14) << "us per tx"
+            << std::setw (10) << "speedup"
+            << std::setw (8) << "same" << std::endl;
+
+  Ptr<const SpectrumModel> model = NrSpectrumValueHelper::GetSpectrumModel (rbs, 28e9, 30e3);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+
+  for (uint32_t numUes : {100, 250, 500})
+    {
+      uint64_t hash = 14695981039346656037ULL;
+
+      Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+      lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (28e9));
+      lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMi-StreetCanyon"));
+      lossModel->SetChannelModelAttribute ("ChannelConditionModel",
+                                           PointerValue (CreateObject<ThreeGppUmiStreetCanyonChannelConditionModel> ()));
+      Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+      channel->AddPhasedArraySpectrumPropagationLossModel (lossModel);
+
+      Ptr<BenchRxPhy> gnb = CreatePhy (Vector (0.0, 0.0, 10.0), 4, 8, model, &hash);
+      std::vector<Ptr<BenchRxPhy>> ues;
+      for (uint32_t i = 0; i < numUes; ++i)
+        {
+          Vector position (rng->GetValue (-200.0, 200.0), rng->GetValue (-200.0, 200.0), 1.5);
+          ues.push_back (CreatePhy (position, 2, 2, model, &hash));
+          channel->AddRx (ues.back ());
+          PointBeam (ues.back (), gnb);
+        }
+      PointBeam (gnb, ues.front ());
+
+      Ptr<SpectrumValue> psd = Create<SpectrumValue> (model);
+      *psd = 1e-9;
+      Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+      params->psd = psd;
+      params->txPhy = gnb;
+      params->duration = MicroSeconds (500);
+
+      // generate the channels
+      channel->StartTx (params);
+      Simulator::Run ();
+
+      double serialNs = 0.0;
+      uint64_t serialHash = 0;
+      for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+          channel->SetAttribute ("NumThreads", UintegerValue (threads));
+          hash = 14695981039346656037ULL;
+          double ns = 0.0;
+          for (uint32_t tx = 0; tx < txs; ++tx)
+            {
+              auto start = std::chrono::steady_clock::now ();
+              channel->StartTx (params);
+              auto end = std::chrono::steady_clock::now ();
+              ns += std::chrono::duration<double, std::nano> (end - start).count ();
+              Simulator::Run ();
+            }
+          if (threads == 1)
+            {
+              serialNs = ns;
+              serialHash = hash;
+            }
+
+          std::cout << std::setw (6) << numUes
+                    << std::setw (9) << threads
+                    << std::fixed << std::setprecision (1)
+                    << std::setw (14) << ns / 1e3 / txs
+                    << std::setw (10) << std::setprecision (2) << serialNs / std::max (ns, 1.0)
+                    << std::setw (8) << (hash == serialHash ? "yes" : "no")
+                    << std::defaultfloat << std::endl;
+        }
+      Simulator::Destroy ();
+    }
+
+  return 0;
+}
@@ -0,0 +1,416 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "ns3/core-module.h"
+#include "ns3/nr-gnb-mac.h"
+#include "ns3/nr-phy-sap.h"
+#include "ns3/nr-amc.h"
+#include "ns3/nr-mac-short-bsr-ce.h"
+#include "ns3/nr-mac-scheduler-ofdma-rr.h"
+#include "ns3/nr-mac-scheduler-ofdma-pf.h"
+#include "ns3/nr-mac-scheduler-ofdma-edf.h"
+#include "ns3/nr-mac-scheduler-ofdma-aoi.h"
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * \file nr-bench-ul-deadline-scheduler.cc
+ * \ingroup examples
+ * \brief Benchmark of the deadline-aware UL schedulers against RR and PF.
+ *
+ * Every UE generates periodic packets, each with a deadline (generation time
+ * plus a per-UE delay budget, signaled to the scheduler with a CGR). At every
+ * slot, the UEs send their BSR and the scheduler assigns the UL RBGs of the
+ * slot (NrMacSchedulerOfdma::AssignULRBG, 5GL-OFDMA access mode). The
+ * assigned TBs drain the UE queues in FIFO order, and a packet that is
+ * transmitted after its deadline (or that is still queued past it at the end
+ * of the run) is counted as a miss.
+ *
+ * For each scheduler and number of UEs, the benchmark prints the deadline
+ * miss ratio and the CPU time spent by the scheduler per slot (BSR
+ * processing and RBG assignment).
+ *
+ * ./ns3 run "nr-bench-ul-deadline-scheduler --slots=2000 --bandwidth=106"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NrBenchUlDeadlineScheduler");
+
+/**
+ * \brief Fake PHY, that only tells the slot composition
+ */
+class BenchPhySapProvider : public NrPhySapProvider
+{
+public:
+  virtual uint32_t GetSymbolsPerSlot () const override { return 14; }
+  virtual Ptr<const SpectrumModel> GetSpectrumModel () override { return nullptr; }
+  virtual uint16_t GetBwpId () const override { return 0; }
+  virtual uint16_t GetCellId () const override { return 0; }
+  virtual Time GetSlotPeriod () const override { return MicroSeconds (500); }
+  virtual void SendMacPdu (const Ptr<Packet> &p, const SfnSf &sfn, uint8_t symStart, uint8_t streamId) override {}
+  virtual void SendControlMessage (Ptr<NrControlMessage> msg) override {}
+  virtual void SendRachPreamble (uint8_t PreambleId, uint8_t Rnti) override {}
+  virtual void SetSlotAllocInfo (const SlotAllocInfo &slotAllocInfo) override {}
+  virtual void NotifyConnectionSuccessful () override {}
+  virtual uint32_t GetRbNum () const override { return 0; }
+  virtual void NotifyMacActivity () override {}
+  virtual BeamConfId GetBeamConfId (uint8_t rnti) const override
+  {
+    return BeamConfId (BeamId (0, 0.0), BeamId::GetEmptyBeamId ());
+  }
+  virtual Time GetTbUlEncodeLatency () const override { return Time (0); }
+};
+
+/**
+ * \brief Interface of the benchmarked schedulers
+ */
+class BenchScheduler
+{
+public:
+  virtual ~BenchScheduler () = default;
+  /**
+   * \return the scheduler
+   */
+  virtual Ptr<NrMacSchedulerNs3> Get () const = 0;
+  /**
+   * \brief Assign the UL RBGs of a slot
+   * \param symAvail the available symbols
+   * \param active the active UEs, with their buffer
+   */
+  virtual void AssignUl (uint32_t symAvail, const std::vector<std::pair<uint16_t, uint32_t>> &active) = 0;
+  /**
+   * \brief Get the UE representation
+   * \param rnti the RNTI
+   * \return the UE representation
+   */
+  virtual std::shared_ptr<NrMacSchedulerUeInfo> GetUe (uint16_t rnti) const = 0;
+};
+
+/**
+ * \brief Gives access to the UL assignment of a scheduler
+ */
+template <class T>
+class BenchSchedulerT : public BenchScheduler
+{
+public:
+  /**
+   * \brief Scheduler with the protected methods made public
+   */
+  class Sched : public T
+  {
+  public:
+    using T::AssignULRBG;
+    using T::GetUeInfo;
+  };
+
+  BenchSchedulerT () : m_sched (CreateObject<Sched> ())
+  {
+  }
+
+  virtual Ptr<NrMacSchedulerNs3> Get () const override
+  {
+    return m_sched;
+  }
+
+  virtual void AssignUl (uint32_t symAvail, const std::vector<std::pair<uint16_t, uint32_t>> &active) override
+  {
+    NrMacSchedulerNs3::ActiveUeMap activeUl;
+    auto &ueVector = activeUl[BeamConfId (BeamId (0, 0.0), BeamId::GetEmptyBeamId ())];
+    ueVector.reserve (active.size ());
+    for (const auto &ue : active)
+      {
+        auto ueInfo = m_sched->GetUeInfo (ue.first);
+        ueInfo->ResetUlSchedInfo ();
+        ueVector.emplace_back (ueInfo, ue.second);
+      }
+    m_sched->AssignULRBG (symAvail, activeUl);
+  }
+
+  virtual std::shared_ptr<NrMacSchedulerUeInfo> GetUe (uint16_t rnti) const override
+  {
+    return m_sched->GetUeInfo (rnti);
+  }
+
+private:
+  Ptr<Sched> m_sched; //!< The scheduler
+};
+
+/**
+ * \brief A packet in the UE queue
+ */
+struct BenchPacket
+{
+  Time m_deadline;    //!< Deadline
+  uint32_t m_bytes;   //!< Bytes still to transmit
+};
+
+/**
+ * \brief Traffic and queue of an UE
+ */
+struct BenchUe
+{
+  uint16_t m_rnti;                 //!< RNTI
+  Time m_period;                   //!< Packet period
+  Time m_budget;                   //!< Delay budget
+  uint32_t m_size;                 //!< Packet size
+  Time m_nextPacket;               //!< Generation time of the next packet
+  std::deque<BenchPacket> m_queue; //!< Queue
+  uint32_t m_queued {0};           //!< Bytes in the queue
+};
+
+/**
+ * \brief One run of the benchmark
+ */
+class BenchRun
+{
+public:
+  /**
+   * \brief Create the run
+   * \param sched the scheduler
+   * \param ues the UEs (with empty queues)
+   * \param bandwidth the UL bandwidth, in RBs
+   * \param slots the number of slots
+   */
+  BenchRun (BenchScheduler *sched, const std::vector<BenchUe> &ues, uint16_t bandwidth, uint32_t slots);
+
+  /**
+   * \brief Run the slots
+   */
+  void Run ();
+
+  uint64_t m_delivered {0}; //!< Packets transmitted within the deadline
+  uint64_t m_missed {0};    //!< Packets that missed the deadline
+  double m_schedNs {0.0};   //!< Time spent in the scheduler, in ns
+
+private:
+  /**
+   * \brief Process a slot
+   */
+  void Slot ();
+
+  BenchScheduler *m_sched;         //!< The scheduler
+  std::vector<BenchUe> m_ues;      //!< The UEs
+  Ptr<NrGnbMac> m_mac;             //!< The MAC
+  BenchPhySapProvider m_phy;       //!< The PHY
+  uint32_t m_slots;                //!< Slots to run
+  uint32_t m_slot {0};             //!< Current slot
+  Time m_slotPeriod;               //!< Slot duration
+};
+
+BenchRun::BenchRun (BenchScheduler *sched, const std::vector<BenchUe> &ues,
+                    uint16_t bandwidth, uint32_t slots)
+  : m_sched (sched), m_ues (ues), m_slots (slots), m_slotPeriod (m_phy.GetSlotPeriod ())
+{
+  Ptr<NrMacSchedulerNs3> scheduler = m_sched->Get ();
+  m_mac = CreateObject<NrGnbMac> ();
+  m_mac->SetNrMacSchedSapProvider (scheduler->GetMacSchedSapProvider ());
+  m_mac->SetNrMacCschedSapProvider (scheduler->GetMacCschedSapProvider ());
+  m_mac->SetPhySapProvider (&m_phy);
+  scheduler->SetMacSchedSapUser (m_mac->GetNrMacSchedSapUser ());
+  scheduler->SetMacCschedSapUser (m_mac->GetNrMacCschedSapUser ());
+
+  NrMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_ulBandwidth = bandwidth;
+  cellParams.m_dlBandwidth = bandwidth;
+  scheduler->DoCschedCellConfigReq (cellParams);
+  scheduler->InstallUlAmc (CreateObject<NrAmc> ());
+  scheduler->InstallDlAmc (CreateObject<NrAmc> ());
+
+  NrMacSchedSapProvider::SchedUlCgrInfoReqParameters cgr;
+  for (const auto &ue : m_ues)
+    {
+      NrMacCschedSapProvider::CschedUeConfigReqParameters paramsUe;
+      paramsUe.m_rnti = ue.m_rnti;
+      paramsUe.m_beamConfId = m_phy.GetBeamConfId (0);
+      scheduler->DoCschedUeConfigReq (paramsUe);
+
+      NrMacCschedSapProvider::CschedLcConfigReqParameters paramsLc;
+      paramsLc.m_rnti = ue.m_rnti;
+      paramsLc.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 1;
+      lc.m_logicalChannelGroup = 1;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_UL;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      paramsLc.m_logicalChannelConfigList.emplace_back (lc);
+      scheduler->DoCschedLcConfigReq (paramsLc);
+
+      m_sched->GetUe (ue.m_rnti)->m_ulMcs = 10;
+
+      cgr.m_srList.push_back (ue.m_rnti);
+      cgr.m_bufCgr.push_back (ue.m_size);
+      cgr.m_TraffPCgr.push_back (static_cast<uint8_t> (ue.m_period.GetMilliSeconds ()));
+      cgr.m_TraffInitCgr.push_back (ue.m_nextPacket);
+      cgr.m_TraffDeadlineCgr.push_back (ue.m_budget);
+    }
+  cgr.lcid = 1;
+  scheduler->DoSchedUlCgrInfoReq (cgr);
+}
+
+void
+BenchRun::Run ()
+{
+  Simulator::Schedule (m_slotPeriod, &BenchRun::Slot, this);
+  Simulator::Run ();
+
+  // Packets still queued past their deadline are misses as well
+  Time end = Simulator::Now ();
+  for (const auto &ue : m_ues)
+    {
+      for (const auto &p : ue.m_queue)
+        {
+          if (p.m_deadline < end)
+            {
+              ++m_missed;
+            }
+        }
+    }
+  Simulator::Destroy ();
+}
+
+void
+BenchRun::Slot ()
+{
+  Time now = Simulator::Now ();
+
+  NrMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsr;
+  std::vector<std::pair<uint16_t, uint32_t>> active;
+  for (auto &ue : m_ues)
+    {
+      while (ue.m_nextPacket <= now)
+        {
+          ue.m_queue.push_back ({ue.m_nextPacket + ue.m_budget, ue.m_size});
+          ue.m_queued += ue.m_size;
+          ue.m_nextPacket += ue.m_period;
+        }
+
+      MacCeElement ce;
+      ce.m_rnti = ue.m_rnti;
+      ce.m_macCeType = MacCeElement::BSR;
+      ce.m_macCeValue.m_bufferStatus.resize (4, 0);
+      ce.m_macCeValue.m_bufferStatus.at (1) = NrMacShortBsrCe::FromBytesToLevel (ue.m_queued);
+      bsr.m_macCeList.push_back (ce);
+
+      if (ue.m_queued > 0)
+        {
+          // The same overhead that NrMacSchedulerNs3 adds to the BSR
+          active.emplace_back (ue.m_rnti, ue.m_queued + 10);
+        }
+    }
+
+  auto start = std::chrono::steady_clock::now ();
+  m_sched->Get ()->DoSchedUlMacCtrlInfoReq (bsr);
+  if (! active.empty ())
+    {
+      m_sched->AssignUl (13, active);
+    }
+  m_schedNs += std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+
+  // The TBs are received at the end of the slot
+  Time rx = now + m_slotPeriod;
+  for (auto &ue : m_ues)
+    {
+      if (ue.m_queued == 0)
+        {
+          continue;
+        }
+      uint32_t tb = m_sched->GetUe (ue.m_rnti)->m_ulTbSize;
+      while (tb > 0 && ! ue.m_queue.empty ())
+        {
+          BenchPacket &p = ue.m_queue.front ();
+          uint32_t sent = std::min (tb, p.m_bytes);
+          p.m_bytes -= sent;
+          ue.m_queued -= sent;
+          tb -= sent;
+          if (p.m_bytes == 0)
+            {
+              rx <= p.m_deadline ? ++m_delivered : ++m_missed;
+              ue.m_queue.pop_front ();
+            }
+        }
+    }
+
+  if (++m_slot < m_slots)
+    {
+      Simulator::Schedule (m_slotPeriod, &BenchRun::Slot, this);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t slots = 2000;
+  uint16_t bandwidth = 106;
+
+  CommandLine cmd;
+  cmd.AddValue ("slots", "Number of slots of each run", slots);
+  cmd.AddValue ("bandwidth", "UL bandwidth, in RBs", bandwidth);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (6) << "UEs"
+            << std::setw (12) << "scheduler"
+            << std::setw (12) << "miss ratio"
+            << std::setw (14) << "us per slot" << std::endl;
+
+  for (uint32_t numUes : {100, 250, 500, 1000})
+    {
+      // The same traffic for all the schedulers
+      RngSeedManager::SetRun (numUes);
+      Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+      std::vector<BenchUe> ues;
+      for (uint32_t i = 0; i < numUes; ++i)
+        {
+          BenchUe ue;
+          ue.m_rnti = static_cast<uint16_t> (i + 1);
+          ue.m_period = MilliSeconds (rng->GetInteger (5, 50));
+          ue.m_budget = MicroSeconds (rng->GetInteger (1000, 10000));
+          ue.m_size = rng->GetInteger (20, 200);
+          ue.m_nextPacket = MicroSeconds (rng->GetInteger (0, ue.m_period.GetMicroSeconds ()));
+          ues.push_back (ue);
+        }
+
+      std::vector<std::pair<std::string, std::function<BenchScheduler * ()>>> schedulers = {
+        {"RR", [] () { return new BenchSchedulerT<NrMacSchedulerOfdmaRR> (); }},
+        {"PF", [] () { return new BenchSchedulerT<NrMacSchedulerOfdmaPF> (); }},
+        {"EDF", [] () { return new BenchSchedulerT<NrMacSchedulerOfdmaEdf> (); }},
+        {"AoI", [] () { return new BenchSchedulerT<NrMacSchedulerOfdmaAoI> (); }},
+      };
+
+      for (const auto &s : schedulers)
+        {
+          BenchScheduler *sched = s.second ();
+          BenchRun run (sched, ues, bandwidth, slots);
+          run.Run ();
+          delete sched;
+
+          uint64_t total = run.m_delivered + run.m_missed;
+          std::cout << std::setw (6) << numUes
+                    << std::setw (12) << s.first
+                    << std::setw (12) << std::fixed << std::setprecision (4)
+                    << (total > 0 ? static_cast<double> (run.m_missed) / total : 0.0)
+                    << std::setw (14) << std::setprecision (1) << run.m_schedNs / 1e3 / slots
+                    << std::defaultfloat << std::endl;
+        }
+    }
+
+  return 0;
+}
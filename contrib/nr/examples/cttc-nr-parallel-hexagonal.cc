@@ -0,0 +1,281 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \ingroup examples
+ * \file cttc-nr-parallel-hexagonal.cc
+ * \brief A multi-cell deployment that runs the cells in parallel
+ *
+ * This example deploys a central site and a number of outer rings of
+ * sites on an hexagonal grid, with one (omnidirectional) cell per site and
+ * a number of UEs per cell. The remote host sends a CBR downlink flow to
+ * every UE.
+ *
+ * With "--threads" greater than zero, the simulator is a
+ * MultithreadedSimulatorImpl: NrHelper::AssignSimulatorPartitions () puts
+ * each cell, with its UEs, in a partition, and the partitions run on up to
+ * that number of threads. With "--threads=0" (the default), the simulator
+ * is the default, sequential one. The example prints the number of packets
+ * received by the UEs, the number of executed events and the wall clock
+ * time of the traffic phase: with the MultithreadedSimulatorImpl, the first
+ * two do not depend on the number of threads.
+ *
+ * The UEs connect to the network while the simulator runs with one thread,
+ * as the GNBs call the MME directly; the traffic phase uses all the
+ * threads.
+ *
+ * \code{.unparsed}
+$ ./ns3 run "cttc-nr-parallel-hexagonal --numRings=1 --threads=4"
+    \endcode
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/nr-module.h"
+#include <ns3/antenna-module.h>
+#include <ns3/multithreaded-simulator-impl.h>
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("CttcNrParallelHexagonal");
+
+int
+main (int argc, char *argv[])
+{
+  uint16_t numRings = 1;
+  uint16_t ueNumPergNb = 4;
+  uint32_t threads = 0;
+  double centralFrequency = 3.5e9;
+  double bandwidth = 20e6;
+  uint16_t numerology = 1;
+  double txPower = 43;
+  uint32_t udpPacketSize = 1000;
+  uint32_t lambda = 1000;
+  Time appStartTime = MilliSeconds (400);
+  Time simTime = MilliSeconds (1000);
+
+  CommandLine cmd;
+  cmd.AddValue ("numRings",
+                "The number of rings of sites around the central site",
+                numRings);
+  cmd.AddValue ("ueNumPergNb",
+                "The number of UEs per gNb",
+                ueNumPergNb);
+  cmd.AddValue ("threads",
+                "The maximum number of threads of the simulation; 0 runs "
+                "the default, sequential simulator",
+                threads);
+  cmd.AddValue ("centralFrequency",
+                "The central frequency of the band",
+                centralFrequency);
+  cmd.AddValue ("bandwidth",
+                "The bandwidth of the band",
+                bandwidth);
+  cmd.AddValue ("numerology",
+                "The numerology of the bandwidth part",
+                numerology);
+  cmd.AddValue ("txPower",
+                "The transmission power of the gNbs, in dBm",
+                txPower);
+  cmd.AddValue ("packetSize",
+                "The size of the UDP packets, in bytes",
+                udpPacketSize);
+  cmd.AddValue ("lambda",
+                "The number of UDP packets per second of each flow",
+                lambda);
+  cmd.AddValue ("appStartTime",
+                "The start of the traffic; the UEs must be connected by then",
+                appStartTime);
+  cmd.AddValue ("simTime",
+                "The duration of the simulation",
+                simTime);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_IF (appStartTime >= simTime);
+
+  // The simulator implementation must be selected before the first event
+  if (threads > 0)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::MultithreadedSimulatorImpl"));
+    }
+
+  Config::SetDefault ("ns3::LteRlcUm::MaxTxBufferSize", UintegerValue (999999999));
+
+  HexagonalGridScenarioHelper gridScenario;
+  gridScenario.SetSectorization (HexagonalGridScenarioHelper::SINGLE);
+  gridScenario.SetNumRings (numRings);
+  gridScenario.SetScenarioParameters ("UMa");
+  gridScenario.SetUtNumber (gridScenario.GetNumCells () * ueNumPergNb);
+  int64_t randomStream = 1;
+  randomStream += gridScenario.AssignStreams (randomStream);
+  gridScenario.CreateScenario ();
+
+  Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper> ();
+  Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+  Ptr<NrHelper> nrHelper = CreateObject<NrHelper> ();
+
+  nrHelper->SetBeamformingHelper (idealBeamformingHelper);
+  nrHelper->SetEpcHelper (epcHelper);
+
+  // The events between the cells and the core network cross partitions:
+  // their links need a delay, which bounds the lookahead of the simulator.
+  epcHelper->SetAttribute ("S1uLinkDelay", TimeValue (MilliSeconds (1)));
+  epcHelper->SetAttribute ("X2LinkDelay", TimeValue (MilliSeconds (1)));
+  epcHelper->SetAttribute ("S11LinkDelay", TimeValue (MilliSeconds (1)));
+
+  CcBwpCreator ccBwpCreator;
+  CcBwpCreator::SimpleOperationBandConf bandConf (centralFrequency, bandwidth, 1, BandwidthPartInfo::UMa);
+  OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc (bandConf);
+
+  Config::SetDefault ("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue (MilliSeconds (0)));
+  nrHelper->SetChannelConditionModelAttribute ("UpdatePeriod", TimeValue (MilliSeconds (0)));
+  nrHelper->SetPathlossAttribute ("ShadowingEnabled", BooleanValue (false));
+
+  nrHelper->InitializeOperationBand (&band);
+  BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps ({band});
+
+  idealBeamformingHelper->SetAttribute ("BeamformingMethod", TypeIdValue (DirectPathBeamforming::GetTypeId ()));
+
+  nrHelper->SetUeAntennaAttribute ("NumRows", UintegerValue (1));
+  nrHelper->SetUeAntennaAttribute ("NumColumns", UintegerValue (1));
+  nrHelper->SetUeAntennaAttribute ("AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+
+  nrHelper->SetGnbAntennaAttribute ("NumRows", UintegerValue (4));
+  nrHelper->SetGnbAntennaAttribute ("NumColumns", UintegerValue (4));
+  nrHelper->SetGnbAntennaAttribute ("AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+
+  nrHelper->SetGnbPhyAttribute ("Numerology", UintegerValue (numerology));
+  nrHelper->SetGnbPhyAttribute ("TxPower", DoubleValue (txPower));
+
+  NetDeviceContainer gnbNetDev = nrHelper->InstallGnbDevice (gridScenario.GetBaseStations (), allBwps);
+  NetDeviceContainer ueNetDev = nrHelper->InstallUeDevice (gridScenario.GetUserTerminals (), allBwps);
+
+  randomStream += nrHelper->AssignStreams (gnbNetDev, randomStream);
+  randomStream += nrHelper->AssignStreams (ueNetDev, randomStream);
+
+  for (auto it = gnbNetDev.Begin (); it != gnbNetDev.End (); ++it)
+    {
+      DynamicCast<NrGnbNetDevice> (*it)->UpdateConfig ();
+    }
+
+  for (auto it = ueNetDev.Begin (); it != ueNetDev.End (); ++it)
+    {
+      DynamicCast<NrUeNetDevice> (*it)->UpdateConfig ();
+    }
+
+  // create the internet and install the IP stack on the UEs
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (2500));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (Seconds (0.000)));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  ipv4h.Assign (internetDevices);
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+  internet.Install (gridScenario.GetUserTerminals ());
+
+  Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (ueNetDev);
+
+  for (uint32_t j = 0; j < gridScenario.GetUserTerminals ().GetN (); ++j)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (gridScenario.GetUserTerminals ().Get (j)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+
+  nrHelper->AttachToClosestEnb (ueNetDev, gnbNetDev);
+
+  // One CBR downlink flow per UE
+  uint16_t dlPort = 1234;
+  UdpServerHelper dlPacketSink (dlPort);
+  ApplicationContainer serverApps = dlPacketSink.Install (gridScenario.GetUserTerminals ());
+
+  UdpClientHelper dlClient;
+  dlClient.SetAttribute ("RemotePort", UintegerValue (dlPort));
+  dlClient.SetAttribute ("MaxPackets", UintegerValue (0xFFFFFFFF));
+  dlClient.SetAttribute ("PacketSize", UintegerValue (udpPacketSize));
+  dlClient.SetAttribute ("Interval", TimeValue (Seconds (1.0 / lambda)));
+
+  ApplicationContainer clientApps;
+  for (uint32_t i = 0; i < ueIpIface.GetN (); ++i)
+    {
+      dlClient.SetAttribute ("RemoteAddress", AddressValue (ueIpIface.GetAddress (i)));
+      clientApps.Add (dlClient.Install (remoteHost));
+    }
+
+  serverApps.Start (appStartTime);
+  clientApps.Start (appStartTime);
+  serverApps.Stop (simTime);
+  clientApps.Stop (simTime);
+
+  // Put each cell, with its UEs, in a partition of the simulator
+  nrHelper->AssignSimulatorPartitions (gnbNetDev, ueNetDev);
+
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != nullptr)
+    {
+      std::cout << "Partitions: " << impl->GetNPartitions ()
+                << ", lookahead: " << impl->GetLookahead ().As (Time::NS) << std::endl;
+
+      // The GNBs call the MME directly while the UEs connect
+      impl->SetAttribute ("MaxThreads", UintegerValue (1));
+      Simulator::Stop (appStartTime);
+      Simulator::Run ();
+      impl->SetAttribute ("MaxThreads", UintegerValue (threads));
+    }
+
+  auto start = std::chrono::steady_clock::now ();
+  Simulator::Stop (simTime - Simulator::Now ());
+  Simulator::Run ();
+  auto end = std::chrono::steady_clock::now ();
+
+  uint64_t rxPackets = 0;
+  for (uint32_t i = 0; i < serverApps.GetN (); ++i)
+    {
+      rxPackets += DynamicCast<UdpServer> (serverApps.Get (i))->GetReceived ();
+    }
+
+  std::cout << "Cells: " << gnbNetDev.GetN () << ", UEs: " << ueNetDev.GetN ()
+            << ", threads: " << threads << std::endl;
+  std::cout << "Received packets: " << rxPackets << std::endl;
+  std::cout << "Events: " << Simulator::GetEventCount () << std::endl;
+  std::cout << "Wall clock time of the traffic phase: "
+            << std::chrono::duration<double> (end - start).count () << " s" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,84 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/nr-trace-sink.h"
+#include <fstream>
+#include <iostream>
+
+/**
+ * \file nr-trace-convert.cc
+ * \ingroup examples
+ * \brief Convert the binary trace files of NrTraceSink to text.
+ *
+ * A simulation that enables the traces with
+ * NrHelper::EnableTraces (NrTraceSink::BINARY) writes, e.g., RxPacketTrace.bin
+ * in place of RxPacketTrace.txt. This program writes the text file that the
+ * simulation would have written with the default format:
+ *
+ * ./ns3 run "nr-trace-convert --input=RxPacketTrace.bin"
+ *
+ * By default, the output file has the name of the input with ".txt" in place
+ * of ".bin"; use "--output=-" to print it on the standard output.
+ */
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "The binary trace file", input);
+  cmd.AddValue ("output", "The text file to write (- for the standard output)", output);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (input.empty (), "Missing --input");
+  if (output.empty ())
+    {
+      const std::string bin = ".bin";
+      output = input;
+      if (output.size () >= bin.size ()
+          && output.compare (output.size () - bin.size (), bin.size (), bin) == 0)
+        {
+          output.erase (output.size () - bin.size ());
+        }
+      output += ".txt";
+    }
+
+  std::ifstream in (input, std::ios_base::binary);
+  NS_ABORT_MSG_IF (!in.is_open (), "Could not open " << input);
+
+  bool ok;
+  if (output == "-")
+    {
+      ok = NrTraceSink::ConvertToText (in, std::cout);
+    }
+  else
+    {
+      std::ofstream out (output);
+      NS_ABORT_MSG_IF (!out.is_open (), "Could not open " << output);
+      ok = NrTraceSink::ConvertToText (in, out);
+    }
+  NS_ABORT_MSG_IF (!ok, input << " is not a valid binary trace, or it is truncated");
+
+  return 0;
+}
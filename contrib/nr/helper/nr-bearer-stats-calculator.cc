@@ -39,6 +39,19 @@ NS_LOG_COMPONENT_DEFINE ("NrBearerStatsCalculator");
 
 NS_OBJECT_ENSURE_REGISTERED ( NrBearerStatsCalculator);
 
+/// Columns of the columnar files of NrBearerStatsCalculator
+static const NrColumnarStats::Columns g_columns = {
+  {"start(s)", NrColumnarStats::DOUBLE}, {"end(s)", NrColumnarStats::DOUBLE},
+  {"CellId", NrColumnarStats::UINT}, {"IMSI", NrColumnarStats::UINT},
+  {"RNTI", NrColumnarStats::UINT}, {"LCID", NrColumnarStats::UINT},
+  {"nTxPDUs", NrColumnarStats::UINT}, {"TxBytes", NrColumnarStats::UINT},
+  {"nRxPDUs", NrColumnarStats::UINT}, {"RxBytes", NrColumnarStats::UINT},
+  {"delay(s)", NrColumnarStats::DOUBLE}, {"delayStdDev(s)", NrColumnarStats::DOUBLE},
+  {"delayMin(s)", NrColumnarStats::DOUBLE}, {"delayMax(s)", NrColumnarStats::DOUBLE},
+  {"PduSize", NrColumnarStats::DOUBLE}, {"PduSizeStdDev", NrColumnarStats::DOUBLE},
+  {"PduSizeMin", NrColumnarStats::DOUBLE}, {"PduSizeMax", NrColumnarStats::DOUBLE}
+};
+
 NrBearerStatsCalculator::NrBearerStatsCalculator ()
   : m_firstWrite (true),
   m_pendingOutput (false),
@@ -110,6 +123,8 @@ NrBearerStatsCalculator::DoDispose ()
     {
       ShowResults ();
     }
+  m_ulWriter = nullptr;
+  m_dlWriter = nullptr;
 }
 
 void
@@ -230,6 +245,19 @@ NrBearerStatsCalculator::ShowResults (void)
   std::ofstream ulOutFile;
   std::ofstream dlOutFile;
 
+  if (m_outputFormat == COLUMNAR)
+    {
+      if (!m_ulWriter)
+        {
+          m_ulWriter = CreateColumnarWriter (GetUlOutputFilename (), g_columns);
+          m_dlWriter = CreateColumnarWriter (GetDlOutputFilename (), g_columns);
+        }
+      WriteColumnarResults (m_ulWriter, true);
+      WriteColumnarResults (m_dlWriter, false);
+      m_pendingOutput = false;
+      return;
+    }
+
   if (m_firstWrite == true)
     {
       ulOutFile.open (GetUlOutputFilename ().c_str ());
@@ -369,6 +397,33 @@ NrBearerStatsCalculator::WriteDlResults (std::ofstream& outFile)
   outFile.close ();
 }
 
+void
+NrBearerStatsCalculator::WriteColumnarResults (Ptr<NrColumnarStatsWriter> writer, bool uplink)
+{
+  NS_LOG_FUNCTION (this << uplink);
+
+  const Uint32Map &txPackets = uplink ? m_ulTxPackets : m_dlTxPackets;
+  Time endTime = m_startTime + m_epochDuration;
+  for (const auto &it : txPackets)
+    {
+      ImsiLcidPair_t p = it.first;
+      std::vector<double> delay = uplink ? GetUlDelayStats (p.m_imsi, p.m_lcId)
+                                         : GetDlDelayStats (p.m_imsi, p.m_lcId);
+      std::vector<double> pduSize = uplink ? GetUlPduSizeStats (p.m_imsi, p.m_lcId)
+                                           : GetDlPduSizeStats (p.m_imsi, p.m_lcId);
+      NS_ASSERT (delay.size () == 4 && pduSize.size () == 4);
+      writer->AddRow (m_startTime.GetSeconds (), endTime.GetSeconds (),
+                      uplink ? GetUlCellId (p.m_imsi, p.m_lcId) : GetDlCellId (p.m_imsi, p.m_lcId),
+                      p.m_imsi, m_flowId[p].m_rnti, m_flowId[p].m_lcId,
+                      uplink ? GetUlTxPackets (p.m_imsi, p.m_lcId) : GetDlTxPackets (p.m_imsi, p.m_lcId),
+                      uplink ? GetUlTxData (p.m_imsi, p.m_lcId) : GetDlTxData (p.m_imsi, p.m_lcId),
+                      uplink ? GetUlRxPackets (p.m_imsi, p.m_lcId) : GetDlRxPackets (p.m_imsi, p.m_lcId),
+                      uplink ? GetUlRxData (p.m_imsi, p.m_lcId) : GetDlRxData (p.m_imsi, p.m_lcId),
+                      delay[0] * 1e-9, delay[1] * 1e-9, delay[2] * 1e-9, delay[3] * 1e-9,
+                      pduSize[0], pduSize[1], pduSize[2], pduSize[3]);
+    }
+}
+
 void
 NrBearerStatsCalculator::ResetResults (void)
 {
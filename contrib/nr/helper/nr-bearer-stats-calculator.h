@@ -295,6 +295,13 @@ private:
    * @param outFile ofstream for DL statistics
    */
   void WriteDlResults (std::ofstream& outFile);
+  /**
+   * Writes collected statistics to a columnar output file
+   * (OutputFormat set to COLUMNAR).
+   * @param writer the writer of the UL or DL file
+   * @param uplink true for the UL statistics, false for the DL ones
+   */
+  void WriteColumnarResults (Ptr<NrColumnarStatsWriter> writer, bool uplink);
   /**
    * Erases collected statistics
    */
@@ -365,6 +372,8 @@ private:
   std::string m_ulPdcpOutputFilename;
   std::ofstream m_dlOutFile;
   std::ofstream m_ulOutFile;
+  Ptr<NrColumnarStatsWriter> m_dlWriter; //!< Columnar writer of the DL stats
+  Ptr<NrColumnarStatsWriter> m_ulWriter; //!< Columnar writer of the UL stats
 };
 
 } // namespace ns3
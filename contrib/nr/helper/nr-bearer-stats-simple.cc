@@ -20,6 +20,8 @@
 #include "nr-bearer-stats-simple.h"
 #include "ns3/string.h"
 #include "ns3/nstime.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
 #include <ns3/log.h>
 #include <vector>
 #include <algorithm>
@@ -30,12 +32,43 @@ NS_LOG_COMPONENT_DEFINE ("NrBearerStatsSimple");
 NS_OBJECT_ENSURE_REGISTERED (NrBearerStatsBase);
 NS_OBJECT_ENSURE_REGISTERED (NrBearerStatsSimple);
 
+/// Columns of the columnar TX files of NrBearerStatsSimple
+static const NrColumnarStats::Columns g_txColumns = {
+  {"time(s)", NrColumnarStats::DOUBLE}, {"cellId", NrColumnarStats::UINT},
+  {"rnti", NrColumnarStats::UINT}, {"lcid", NrColumnarStats::UINT},
+  {"packetSize", NrColumnarStats::UINT}
+};
+
+/// Columns of the columnar RX files of NrBearerStatsSimple
+static const NrColumnarStats::Columns g_rxColumns = {
+  {"time(s)", NrColumnarStats::DOUBLE}, {"cellId", NrColumnarStats::UINT},
+  {"rnti", NrColumnarStats::UINT}, {"lcid", NrColumnarStats::UINT},
+  {"packetSize", NrColumnarStats::UINT}, {"delay(s)", NrColumnarStats::DOUBLE}
+};
+
 TypeId
 NrBearerStatsBase::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::NrBearerStatsBase")
     .SetParent<Object> ()
     .SetGroupName ("nr")
+    .AddAttribute ("OutputFormat",
+                   "Format of the output files: tab-separated text, or columnar "
+                   "files (named as the text files, with .ncol in place of .txt)",
+                   EnumValue (NrBearerStatsBase::TEXT),
+                   MakeEnumAccessor (&NrBearerStatsBase::m_outputFormat),
+                   MakeEnumChecker (NrBearerStatsBase::TEXT, "Text",
+                                    NrBearerStatsBase::COLUMNAR, "Columnar"))
+    .AddAttribute ("ColumnarCompression",
+                   "Compress (LZ4) the chunks of the columnar files",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&NrBearerStatsBase::m_columnarCompression),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ColumnarChunkRows",
+                   "Number of rows buffered and written together in the columnar files",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&NrBearerStatsBase::m_columnarChunkRows),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -47,6 +80,20 @@ NrBearerStatsBase::DoDispose ()
   Object::DoDispose ();
 }
 
+Ptr<NrColumnarStatsWriter>
+NrBearerStatsBase::CreateColumnarWriter (const std::string &textFileName,
+                                         const NrColumnarStats::Columns &columns) const
+{
+  std::string fileName = textFileName;
+  std::size_t ext = fileName.rfind (".txt");
+  if (ext != std::string::npos && ext == fileName.size () - 4)
+    {
+      fileName.resize (ext);
+    }
+  fileName += ".ncol";
+  return Create<NrColumnarStatsWriter> (fileName, columns, m_columnarCompression, m_columnarChunkRows);
+}
+
 
 NrBearerStatsSimple::NrBearerStatsSimple ()
   : m_protocolType ("RLC")
@@ -125,6 +172,10 @@ NrBearerStatsSimple::DoDispose ()
   m_dlRxOutFile.close (); //!< Output file strem to which DL RLC RX stats will be written
   m_ulTxOutFile.close (); //!< Output file strem to which UL RLC TX stats will be written
   m_ulRxOutFile.close (); //!< Output file strem to which UL RLC RX stats will be written
+  m_dlTxWriter = nullptr;
+  m_dlRxWriter = nullptr;
+  m_ulTxWriter = nullptr;
+  m_ulRxWriter = nullptr;
   NrBearerStatsBase::DoDispose ();
 }
 
@@ -133,6 +184,16 @@ NrBearerStatsSimple::UlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uin
 {
   NS_LOG_FUNCTION (this << cellId << imsi << rnti << (uint32_t) lcid << packetSize);
 
+  if (m_outputFormat == COLUMNAR)
+    {
+      if (!m_ulTxWriter)
+        {
+          m_ulTxWriter = CreateColumnarWriter (GetUlTxOutputFilename (), g_txColumns);
+        }
+      m_ulTxWriter->AddRow (Simulator::Now ().GetSeconds (), cellId, rnti, lcid, packetSize);
+      return;
+    }
+
   if (!m_ulTxOutFile.is_open ())
     {
       m_ulTxOutFile.open (GetUlTxOutputFilename ().c_str ());
@@ -147,6 +208,16 @@ NrBearerStatsSimple::DlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uin
 {
   NS_LOG_FUNCTION (this << cellId << imsi << rnti << (uint32_t) lcid << packetSize);
 
+  if (m_outputFormat == COLUMNAR)
+    {
+      if (!m_dlTxWriter)
+        {
+          m_dlTxWriter = CreateColumnarWriter (GetDlTxOutputFilename (), g_txColumns);
+        }
+      m_dlTxWriter->AddRow (Simulator::Now ().GetSeconds (), cellId, rnti, lcid, packetSize);
+      return;
+    }
+
   if (!m_dlTxOutFile.is_open ())
     {
       m_dlTxOutFile.open (GetDlTxOutputFilename ().c_str ());
@@ -162,6 +233,16 @@ NrBearerStatsSimple::UlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uin
 {
   NS_LOG_FUNCTION (this << cellId << imsi << rnti << (uint32_t) lcid << packetSize << delay);
 
+  if (m_outputFormat == COLUMNAR)
+    {
+      if (!m_ulRxWriter)
+        {
+          m_ulRxWriter = CreateColumnarWriter (GetUlRxOutputFilename (), g_rxColumns);
+        }
+      m_ulRxWriter->AddRow (Simulator::Now ().GetSeconds (), cellId, rnti, lcid, packetSize, delay * 1e-9);
+      return;
+    }
+
   if (!m_ulRxOutFile.is_open ())
     {
       m_ulRxOutFile.open (GetUlRxOutputFilename ().c_str ());
@@ -176,6 +257,16 @@ NrBearerStatsSimple::DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uin
 {
   NS_LOG_FUNCTION (this << cellId << imsi << rnti << (uint32_t) lcid << packetSize << delay);
 
+  if (m_outputFormat == COLUMNAR)
+    {
+      if (!m_dlRxWriter)
+        {
+          m_dlRxWriter = CreateColumnarWriter (GetDlRxOutputFilename (), g_rxColumns);
+        }
+      m_dlRxWriter->AddRow (Simulator::Now ().GetSeconds (), cellId, rnti, lcid, packetSize, delay * 1e-9);
+      return;
+    }
+
   if (!m_dlRxOutFile.is_open ())
     {
       m_dlRxOutFile.open (GetDlRxOutputFilename ().c_str ());
@@ -26,6 +26,7 @@
 #include "ns3/object.h"
 #include "ns3/basic-data-calculators.h"
 #include "ns3/lte-common.h"
+#include "nr-columnar-stats.h"
 #include <string>
 #include <map>
 #include <fstream>
@@ -38,10 +39,25 @@ namespace ns3 {
  *
  * Defines the minimum set of functions that RLC or PDC stats classs should implement.
  * See also NrBearerStatsSimple and NrBearerStatsSimple.
+ *
+ * The statistics are written as tab-separated text, or, with the attribute
+ * OutputFormat set to COLUMNAR, in columnar files (see NrColumnarStats) that
+ * take the name of the text files with ".ncol" in place of ".txt". The
+ * columns of a columnar file are named as in the header of the text file,
+ * and can be loaded one at a time with NrColumnarStatsReader.
  */
 class NrBearerStatsBase : public Object
 {
 public:
+  /**
+   * \brief Format of the output files
+   */
+  enum OutputFormat
+  {
+    TEXT,     //!< Tab-separated text
+    COLUMNAR  //!< Columnar files, see NrColumnarStats
+  };
+
   // Inherited from ns3::Object
   /**
    *  Register this type.
@@ -87,6 +103,21 @@ public:
    * @param delay RLC to RLC delay in nanoseconds
    */
   virtual void DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize, uint64_t delay) = 0;
+
+protected:
+  /**
+   * \brief Create a columnar output file, as configured by the attributes
+   * \param textFileName the name of the text file (".txt" is replaced,
+   * or followed, by ".ncol")
+   * \param columns the columns of the file
+   * \return the writer of the file
+   */
+  Ptr<NrColumnarStatsWriter> CreateColumnarWriter (const std::string &textFileName,
+                                                   const NrColumnarStats::Columns &columns) const;
+
+  OutputFormat m_outputFormat {TEXT};  //!< Format of the output files
+  bool m_columnarCompression {true};   //!< Compress the columnar files
+  uint32_t m_columnarChunkRows {4096}; //!< Rows per chunk of the columnar files
 };
 
 /**
@@ -211,6 +242,10 @@ private:
   std::ofstream m_dlRxOutFile; //!< Output file strem to which DL RLC RX stats will be written
   std::ofstream m_ulTxOutFile; //!< Output file strem to which UL RLC TX stats will be written
   std::ofstream m_ulRxOutFile; //!< Output file strem to which UL RLC RX stats will be written
+  Ptr<NrColumnarStatsWriter> m_dlTxWriter; //!< Columnar writer of the DL TX stats
+  Ptr<NrColumnarStatsWriter> m_dlRxWriter; //!< Columnar writer of the DL RX stats
+  Ptr<NrColumnarStatsWriter> m_ulTxWriter; //!< Columnar writer of the UL TX stats
+  Ptr<NrColumnarStatsWriter> m_ulRxWriter; //!< Columnar writer of the UL RX stats
 
 };
 
@@ -0,0 +1,407 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-columnar-stats.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrColumnarStats");
+
+const char NrColumnarStats::MAGIC[8] = {'N', 'R', 'C', 'O', 'L', 'S', 'T', '1'};
+
+// LZ4 block format parameters
+static const std::size_t LZ4_MIN_MATCH = 4;      //!< Minimum match length
+static const std::size_t LZ4_LAST_LITERALS = 5;  //!< The last 5 bytes are always literals
+static const std::size_t LZ4_MF_LIMIT = 12;      //!< A match can not start in the last 12 bytes
+static const std::size_t LZ4_MAX_OFFSET = 65535; //!< Maximum match distance
+static const uint32_t LZ4_HASH_LOG = 12;         //!< Size (log2) of the match finder table
+
+/**
+ * \brief Read four bytes
+ * \param p the pointer
+ * \return the bytes as an integer
+ */
+static inline uint32_t
+Read32 (const uint8_t *p)
+{
+  uint32_t v;
+  std::memcpy (&v, p, sizeof (v));
+  return v;
+}
+
+/**
+ * \brief Write a LZ4 length extension (the part of a length above 15)
+ * \param out the block
+ * \param len the length, minus 15
+ */
+static void
+WriteLz4Length (std::vector<uint8_t> *out, std::size_t len)
+{
+  while (len >= 255)
+    {
+      out->push_back (255);
+      len -= 255;
+    }
+  out->push_back (static_cast<uint8_t> (len));
+}
+
+/**
+ * \brief Write a LZ4 sequence
+ * \param out the block
+ * \param literals the literals
+ * \param litLen the number of literals
+ * \param offset the match offset (not used if matchLen is 0)
+ * \param matchLen the match length, or 0 for the last sequence
+ */
+static void
+WriteLz4Sequence (std::vector<uint8_t> *out, const uint8_t *literals, std::size_t litLen,
+                  std::size_t offset, std::size_t matchLen)
+{
+  std::size_t ml = matchLen > 0 ? matchLen - LZ4_MIN_MATCH : 0;
+  out->push_back (static_cast<uint8_t> ((std::min<std::size_t> (litLen, 15) << 4)
+                                        | std::min<std::size_t> (ml, 15)));
+  if (litLen >= 15)
+    {
+      WriteLz4Length (out, litLen - 15);
+    }
+  out->insert (out->end (), literals, literals + litLen);
+  if (matchLen == 0)
+    {
+      return;
+    }
+  out->push_back (static_cast<uint8_t> (offset & 0xFF));
+  out->push_back (static_cast<uint8_t> (offset >> 8));
+  if (ml >= 15)
+    {
+      WriteLz4Length (out, ml - 15);
+    }
+}
+
+void
+NrColumnarStats::Lz4Compress (const uint8_t *src, std::size_t size, std::vector<uint8_t> *out)
+{
+  out->clear ();
+  std::size_t anchor = 0;
+  if (size > LZ4_MF_LIMIT)
+    {
+      std::vector<int64_t> table (1u << LZ4_HASH_LOG, -1);
+      const std::size_t mfLimit = size - LZ4_MF_LIMIT;
+      const std::size_t matchLimit = size - LZ4_LAST_LITERALS;
+      std::size_t ip = 0;
+      while (ip < mfLimit)
+        {
+          const uint32_t seq = Read32 (src + ip);
+          const uint32_t h = (seq * 2654435761u) >> (32 - LZ4_HASH_LOG);
+          const int64_t ref = table[h];
+          table[h] = static_cast<int64_t> (ip);
+          if (ref < 0 || ip - ref > LZ4_MAX_OFFSET || Read32 (src + ref) != seq)
+            {
+              ++ip;
+              continue;
+            }
+
+          std::size_t len = LZ4_MIN_MATCH;
+          while (ip + len < matchLimit && src[ref + len] == src[ip + len])
+            {
+              ++len;
+            }
+          WriteLz4Sequence (out, src + anchor, ip - anchor, ip - ref, len);
+          ip += len;
+          anchor = ip;
+        }
+    }
+  WriteLz4Sequence (out, src + anchor, size - anchor, 0, 0);
+}
+
+bool
+NrColumnarStats::Lz4Decompress (const uint8_t *src, std::size_t size, uint8_t *dst, std::size_t dstSize)
+{
+  std::size_t ip = 0;
+  std::size_t op = 0;
+
+  auto readLength = [&] (std::size_t *len) -> bool
+    {
+      uint8_t b;
+      do
+        {
+          if (ip >= size)
+            {
+              return false;
+            }
+          b = src[ip++];
+          *len += b;
+        }
+      while (b == 255);
+      return true;
+    };
+
+  while (ip < size)
+    {
+      const uint8_t token = src[ip++];
+      std::size_t litLen = token >> 4;
+      if (litLen == 15 && !readLength (&litLen))
+        {
+          return false;
+        }
+      if (litLen > size - ip || litLen > dstSize - op)
+        {
+          return false;
+        }
+      std::memcpy (dst + op, src + ip, litLen);
+      ip += litLen;
+      op += litLen;
+
+      if (ip == size)
+        {
+          break; // last sequence, without match
+        }
+
+      if (size - ip < 2)
+        {
+          return false;
+        }
+      const std::size_t offset = src[ip] | (static_cast<std::size_t> (src[ip + 1]) << 8);
+      ip += 2;
+      std::size_t matchLen = token & 0x0F;
+      if (matchLen == 15 && !readLength (&matchLen))
+        {
+          return false;
+        }
+      matchLen += LZ4_MIN_MATCH;
+      if (offset == 0 || offset > op || matchLen > dstSize - op)
+        {
+          return false;
+        }
+      // byte by byte: the match can overlap the output
+      for (std::size_t i = 0; i < matchLen; ++i, ++op)
+        {
+          dst[op] = dst[op - offset];
+        }
+    }
+  return op == dstSize;
+}
+
+NrColumnarStats::Codec
+NrColumnarStats::EncodeColumn (ColumnType type, const std::vector<uint64_t> &values,
+                               bool compress, std::vector<uint8_t> *out)
+{
+  const std::size_t n = values.size ();
+  std::vector<uint8_t> transposed (n * sizeof (uint64_t));
+  uint64_t prev = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      uint64_t x;
+      if (type == DOUBLE)
+        {
+          // equal or close values share sign, exponent and high mantissa bits
+          x = values[i] ^ prev;
+        }
+      else
+        {
+          // zigzag of the difference, so that small negative steps stay small
+          uint64_t d = values[i] - prev;
+          x = (d << 1) ^ static_cast<uint64_t> (static_cast<int64_t> (d) >> 63);
+        }
+      prev = values[i];
+      for (std::size_t b = 0; b < sizeof (uint64_t); ++b)
+        {
+          transposed[b * n + i] = static_cast<uint8_t> (x >> (8 * b));
+        }
+    }
+
+  if (compress)
+    {
+      Lz4Compress (transposed.data (), transposed.size (), out);
+      if (out->size () < transposed.size ())
+        {
+          return LZ4;
+        }
+    }
+  out->swap (transposed);
+  return TRANSPOSED;
+}
+
+bool
+NrColumnarStats::DecodeColumn (ColumnType type, Codec codec, const uint8_t *data, std::size_t size,
+                               uint32_t numRows, std::vector<uint64_t> *values)
+{
+  const std::size_t n = numRows;
+  std::vector<uint8_t> buffer;
+  const uint8_t *transposed = data;
+  if (codec == LZ4)
+    {
+      buffer.resize (n * sizeof (uint64_t));
+      if (!Lz4Decompress (data, size, buffer.data (), buffer.size ()))
+        {
+          return false;
+        }
+      transposed = buffer.data ();
+    }
+  else if (codec != TRANSPOSED || size != n * sizeof (uint64_t))
+    {
+      return false;
+    }
+
+  uint64_t prev = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      uint64_t x = 0;
+      for (std::size_t b = 0; b < sizeof (uint64_t); ++b)
+        {
+          x |= static_cast<uint64_t> (transposed[b * n + i]) << (8 * b);
+        }
+      if (type == DOUBLE)
+        {
+          prev ^= x;
+        }
+      else
+        {
+          prev += (x >> 1) ^ (~(x & 1) + 1);
+        }
+      values->push_back (prev);
+    }
+  return true;
+}
+
+NrColumnarStatsWriter::NrColumnarStatsWriter (const std::string &fileName,
+                                              const NrColumnarStats::Columns &columns,
+                                              bool compress, uint32_t chunkRows)
+  : m_fileName (fileName),
+    m_columnTypes (columns),
+    m_columns (columns.size ()),
+    m_compress (compress),
+    m_chunkRows (chunkRows)
+{
+  NS_LOG_FUNCTION (this << fileName << columns.size () << compress << chunkRows);
+  NS_ABORT_MSG_IF (chunkRows == 0, "A chunk must have at least one row");
+
+  m_file.open (m_fileName.c_str (), std::ios_base::out | std::ios_base::binary);
+  if (!m_file.is_open ())
+    {
+      NS_FATAL_ERROR ("Can't open file " << m_fileName);
+    }
+
+  std::vector<char> header (NrColumnarStats::MAGIC, NrColumnarStats::MAGIC + sizeof (NrColumnarStats::MAGIC));
+  uint32_t numColumns = static_cast<uint32_t> (columns.size ());
+  header.insert (header.end (), reinterpret_cast<const char *> (&numColumns),
+                 reinterpret_cast<const char *> (&numColumns) + sizeof (numColumns));
+  for (const auto &c : columns)
+    {
+      NS_ABORT_MSG_IF (c.first.size () > UINT8_MAX, "Column name too long: " << c.first);
+      header.push_back (static_cast<char> (c.second));
+      header.push_back (static_cast<char> (c.first.size ()));
+      header.insert (header.end (), c.first.begin (), c.first.end ());
+    }
+  m_file.write (header.data (), static_cast<std::streamsize> (header.size ()));
+
+  for (auto &c : m_columns)
+    {
+      c.reserve (m_chunkRows);
+    }
+}
+
+NrColumnarStatsWriter::~NrColumnarStatsWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_file.close ();
+}
+
+const std::string &
+NrColumnarStatsWriter::GetFileName () const
+{
+  return m_fileName;
+}
+
+void
+NrColumnarStatsWriter::Append (std::size_t column, double v)
+{
+  uint64_t bits;
+  switch (m_columnTypes[column].second)
+    {
+    case NrColumnarStats::UINT:
+      bits = static_cast<uint64_t> (v);
+      break;
+    case NrColumnarStats::INT:
+      bits = static_cast<uint64_t> (static_cast<int64_t> (v));
+      break;
+    default:
+      std::memcpy (&bits, &v, sizeof (bits));
+    }
+  m_columns[column].push_back (bits);
+}
+
+void
+NrColumnarStatsWriter::Append (std::size_t column, uint64_t v)
+{
+  if (m_columnTypes[column].second == NrColumnarStats::DOUBLE)
+    {
+      Append (column, static_cast<double> (v));
+      return;
+    }
+  m_columns[column].push_back (v);
+}
+
+void
+NrColumnarStatsWriter::Append (std::size_t column, int64_t v)
+{
+  if (m_columnTypes[column].second == NrColumnarStats::DOUBLE)
+    {
+      Append (column, static_cast<double> (v));
+      return;
+    }
+  m_columns[column].push_back (static_cast<uint64_t> (v));
+}
+
+void
+NrColumnarStatsWriter::Flush ()
+{
+  NS_LOG_FUNCTION (this << m_numRows);
+  if (m_numRows == 0)
+    {
+      return;
+    }
+
+  std::vector<std::vector<uint8_t>> data (m_columns.size ());
+  std::vector<char> header;
+  header.insert (header.end (), reinterpret_cast<const char *> (&m_numRows),
+                 reinterpret_cast<const char *> (&m_numRows) + sizeof (m_numRows));
+  for (std::size_t i = 0; i < m_columns.size (); ++i)
+    {
+      NrColumnarStats::Codec codec = NrColumnarStats::EncodeColumn (m_columnTypes[i].second, m_columns[i],
+                                                                    m_compress, &data[i]);
+      uint32_t size = static_cast<uint32_t> (data[i].size ());
+      header.push_back (static_cast<char> (codec));
+      header.insert (header.end (), reinterpret_cast<const char *> (&size),
+                     reinterpret_cast<const char *> (&size) + sizeof (size));
+      m_columns[i].clear ();
+    }
+
+  m_file.write (header.data (), static_cast<std::streamsize> (header.size ()));
+  for (const auto &d : data)
+    {
+      m_file.write (reinterpret_cast<const char *> (d.data ()), static_cast<std::streamsize> (d.size ()));
+    }
+  m_file.flush ();
+  m_numRows = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,244 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef NR_COLUMNAR_STATS_H
+#define NR_COLUMNAR_STATS_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/assert.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup helper
+ * \brief Definitions and encoding of the columnar statistics files
+ *
+ * A columnar file stores a table with a fixed set of typed columns. After a
+ * small header, that lists the name and the type of the columns, the rows are
+ * stored in chunks. Each chunk stores its rows column by column: the values of
+ * a column are transformed (delta encoding for integers, XOR with the previous
+ * value for doubles), their bytes are transposed (all the first bytes, then
+ * all the second bytes, ...) and the result is optionally compressed in the
+ * LZ4 block format. The chunk header contains the size of every column, so
+ * that a reader can load a column skipping the others.
+ *
+ * File layout (little endian on the usual hosts, as the host byte order is
+ * used):
+ *
+ *   magic (8 bytes) | number of columns (uint32) |
+ *   for each column: type (uint8) | name length (uint8) | name
+ *
+ * followed by the chunks:
+ *
+ *   number of rows (uint32) |
+ *   for each column: codec (uint8) | size in the file (uint32) |
+ *   the data of each column
+ *
+ * The file is written incrementally by NrColumnarStatsWriter, and read by
+ * NrColumnarStatsReader.
+ */
+class NrColumnarStats
+{
+public:
+  /**
+   * \brief Type of a column
+   */
+  enum ColumnType : uint8_t
+  {
+    UINT,   //!< Unsigned 64-bit integer
+    INT,    //!< Signed 64-bit integer
+    DOUBLE  //!< Double
+  };
+
+  /**
+   * \brief Encoding of the data of a column in a chunk
+   */
+  enum Codec : uint8_t
+  {
+    TRANSPOSED = 0, //!< Transformed and transposed values, not compressed
+    LZ4 = 1         //!< Transformed and transposed values, in a LZ4 block
+  };
+
+  /// Name and type of the columns of a file
+  typedef std::vector<std::pair<std::string, ColumnType>> Columns;
+
+  static const char MAGIC[8]; //!< Magic at the beginning of the file
+
+  /**
+   * \brief Encode the values of a column of a chunk
+   * \param type the type of the column
+   * \param values the values (bit pattern of the typed values)
+   * \param compress whether to try the LZ4 compression
+   * \param out the encoded data
+   * \return the codec of the encoded data
+   */
+  static Codec EncodeColumn (ColumnType type, const std::vector<uint64_t> &values,
+                             bool compress, std::vector<uint8_t> *out);
+
+  /**
+   * \brief Decode the values of a column of a chunk
+   * \param type the type of the column
+   * \param codec the codec of the data
+   * \param data the encoded data
+   * \param size the size of the encoded data
+   * \param numRows the number of values
+   * \param values the vector to which the values are appended
+   * \return false if the data is corrupted
+   */
+  static bool DecodeColumn (ColumnType type, Codec codec, const uint8_t *data, std::size_t size,
+                            uint32_t numRows, std::vector<uint64_t> *values);
+
+  /**
+   * \brief Compress a buffer in the LZ4 block format
+   * \param src the buffer
+   * \param size the size of the buffer
+   * \param out the compressed block
+   */
+  static void Lz4Compress (const uint8_t *src, std::size_t size, std::vector<uint8_t> *out);
+
+  /**
+   * \brief Decompress a LZ4 block
+   * \param src the block
+   * \param size the size of the block
+   * \param dst the decompressed buffer
+   * \param dstSize the size of the decompressed buffer
+   * \return false if the block is corrupted, or it does not decompress
+   * to exactly dstSize bytes
+   */
+  static bool Lz4Decompress (const uint8_t *src, std::size_t size, uint8_t *dst, std::size_t dstSize);
+};
+
+/**
+ * \ingroup helper
+ * \brief Writer of a columnar statistics file (see NrColumnarStats)
+ *
+ * The rows are buffered in memory and written in chunks of a fixed number
+ * of rows, so that the file grows during the simulation; the last (partial)
+ * chunk is written by Flush () or by the destructor.
+ */
+class NrColumnarStatsWriter : public SimpleRefCount<NrColumnarStatsWriter>
+{
+public:
+  /**
+   * \brief Create the file and write its header
+   * \param fileName the file name
+   * \param columns the name and the type of the columns
+   * \param compress whether to compress the chunks
+   * \param chunkRows the number of rows of a chunk
+   */
+  NrColumnarStatsWriter (const std::string &fileName, const NrColumnarStats::Columns &columns,
+                         bool compress, uint32_t chunkRows = 4096);
+
+  /**
+   * \brief Destructor: writes the buffered rows and closes the file
+   */
+  ~NrColumnarStatsWriter ();
+
+  /**
+   * \brief Add a row
+   *
+   * The number of values must be the number of columns. Each value is
+   * converted to the type of its column.
+   *
+   * \param values the values of the row
+   */
+  template <typename... Args>
+  void AddRow (const Args &... values);
+
+  /**
+   * \brief Write the buffered rows as a chunk
+   */
+  void Flush ();
+
+  /**
+   * \return the name of the file
+   */
+  const std::string & GetFileName () const;
+
+private:
+  /**
+   * \brief Append a value to a column
+   * \param column the column index
+   * \param v the value
+   */
+  void Append (std::size_t column, double v);
+  /**
+   * \brief Append a value to a column
+   * \param column the column index
+   * \param v the value
+   */
+  void Append (std::size_t column, uint64_t v);
+  /**
+   * \brief Append a value to a column
+   * \param column the column index
+   * \param v the value
+   */
+  void Append (std::size_t column, int64_t v);
+
+  std::string m_fileName;                   //!< Name of the file
+  std::ofstream m_file;                     //!< The file
+  NrColumnarStats::Columns m_columnTypes;   //!< Name and type of the columns
+  std::vector<std::vector<uint64_t>> m_columns; //!< Buffered values, per column
+  bool m_compress {true};                   //!< Compress the chunks
+  uint32_t m_chunkRows {4096};              //!< Rows per chunk
+  uint32_t m_numRows {0};                   //!< Buffered rows
+};
+
+template <typename... Args>
+void
+NrColumnarStatsWriter::AddRow (const Args &... values)
+{
+  NS_ASSERT_MSG (sizeof... (Args) == m_columns.size (),
+                 "Row with " << sizeof... (Args) << " values for " << m_columns.size () << " columns");
+  std::size_t i = 0;
+  auto append = [this, &i] (const auto &v)
+    {
+      typedef typename std::decay<decltype (v)>::type T;
+      static_assert (std::is_arithmetic<T>::value, "Columns can only store numbers");
+      if constexpr (std::is_floating_point<T>::value)
+        {
+          Append (i++, static_cast<double> (v));
+        }
+      else if constexpr (std::is_signed<T>::value)
+        {
+          Append (i++, static_cast<int64_t> (v));
+        }
+      else
+        {
+          Append (i++, static_cast<uint64_t> (v));
+        }
+    };
+  (append (values), ...);
+
+  if (++m_numRows >= m_chunkRows)
+    {
+      Flush ();
+    }
+}
+
+} // namespace ns3
+
+#endif // NR_COLUMNAR_STATS_H
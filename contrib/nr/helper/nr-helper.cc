@@ -54,8 +54,15 @@
 #include <ns3/three-gpp-v2v-propagation-loss-model.h>
 #include <ns3/three-gpp-v2v-channel-condition-model.h>
 #include <ns3/uniform-planar-array.h>
+#include <ns3/nr-spectrum-transmit-filter.h>
+#include <ns3/multithreaded-simulator-impl.h>
+#include <ns3/mobility-model.h>
+#include <ns3/boolean.h>
 
 #include <algorithm>
+#include <limits>
+#include <map>
+#include <thread>
 
 namespace ns3 {
 
@@ -98,6 +105,7 @@ NrHelper::NrHelper (void)
   Config::SetDefault ("ns3::EpsBearer::Release", UintegerValue (15));
 
   m_phyStats = CreateObject<NrPhyRxTrace> ();
+  m_macStats = CreateObject<NrMacRxTrace> ();
   m_macSchedStats = CreateObject <NrMacSchedulingStats> ();
 }
 
@@ -319,6 +327,7 @@ NrHelper::InitializeOperationBand (OperationBandInfo *band, uint8_t flags)
               bwp->m_channel = m_channelFactory.Create<SpectrumChannel> ();
               bwp->m_channel->AddPropagationLossModel (bwp->m_propagation);
               bwp->m_channel->AddPhasedArraySpectrumPropagationLossModel (bwp->m_3gppChannel);
+              bwp->m_channel->AddSpectrumTransmitFilter (CreateObject<NrSpectrumTransmitFilter> ());
             }
         }
     }
@@ -1064,6 +1073,175 @@ NrHelper::AttachToEnb (const Ptr<NetDevice> &ueDevice,
 
 
 
+void
+NrHelper::PrecomputeChannels (const NetDeviceContainer &gnbDevices, const NetDeviceContainer &ueDevices,
+                              uint32_t numThreads)
+{
+  NS_LOG_FUNCTION (this << gnbDevices.GetN () << ueDevices.GetN () << numThreads);
+
+  if (numThreads == 0)
+    {
+      numThreads = std::max (std::thread::hardware_concurrency (), 1u);
+    }
+
+  // The spectrum phys of the UEs, with the antenna array of each
+  std::vector<std::pair<Ptr<NrSpectrumPhy>, Ptr<const PhasedArrayModel>>> uePhys;
+  for (auto it = ueDevices.Begin (); it != ueDevices.End (); ++it)
+    {
+      Ptr<NrUeNetDevice> ueDev = DynamicCast<NrUeNetDevice> (*it);
+      NS_ABORT_MSG_IF (ueDev == nullptr, "PrecomputeChannels: not a UE device");
+      for (uint32_t bwp = 0; bwp < ueDev->GetCcMapSize (); ++bwp)
+        {
+          Ptr<NrUePhy> phy = ueDev->GetPhy (static_cast<uint8_t> (bwp));
+          for (uint8_t streamIndex = 0; streamIndex < phy->GetNumberOfStreams (); streamIndex++)
+            {
+              Ptr<NrSpectrumPhy> spectrumPhy = phy->GetSpectrumPhy (streamIndex);
+              uePhys.emplace_back (spectrumPhy, DynamicCast<const PhasedArrayModel> (spectrumPhy->GetAntenna ()));
+            }
+        }
+    }
+
+  // The links of each channel model, in the order of the containers
+  std::vector<std::pair<Ptr<ThreeGppChannelModel>, std::vector<ThreeGppChannelModel::ChannelLink>>> links;
+  for (auto it = gnbDevices.Begin (); it != gnbDevices.End (); ++it)
+    {
+      Ptr<NrGnbNetDevice> gnbDev = DynamicCast<NrGnbNetDevice> (*it);
+      NS_ABORT_MSG_IF (gnbDev == nullptr, "PrecomputeChannels: not a GNB device");
+      for (uint32_t bwp = 0; bwp < gnbDev->GetCcMapSize (); ++bwp)
+        {
+          Ptr<NrGnbPhy> phy = gnbDev->GetPhy (static_cast<uint8_t> (bwp));
+          for (uint8_t streamIndex = 0; streamIndex < phy->GetNumberOfStreams (); streamIndex++)
+            {
+              Ptr<NrSpectrumPhy> gnbPhy = phy->GetSpectrumPhy (streamIndex);
+              Ptr<SpectrumChannel> channel = gnbPhy->GetSpectrumChannel ();
+              if (channel == nullptr)
+                {
+                  continue;
+                }
+              Ptr<ThreeGppSpectrumPropagationLossModel> lossModel =
+                DynamicCast<ThreeGppSpectrumPropagationLossModel> (channel->GetPhasedArraySpectrumPropagationLossModel ());
+              Ptr<ThreeGppChannelModel> channelModel =
+                lossModel != nullptr ? DynamicCast<ThreeGppChannelModel> (lossModel->GetChannelModel ()) : nullptr;
+              if (channelModel == nullptr)
+                {
+                  NS_LOG_INFO ("The channel of a GNB does not use a ThreeGppChannelModel, skipped");
+                  continue;
+                }
+
+              auto modelIt = std::find_if (links.begin (), links.end (),
+                                           [&channelModel] (const auto &modelLinks) { return modelLinks.first == channelModel; });
+              if (modelIt == links.end ())
+                {
+                  modelIt = links.emplace (links.end (), channelModel, std::vector<ThreeGppChannelModel::ChannelLink> ());
+                }
+
+              Ptr<const PhasedArrayModel> gnbAntenna = DynamicCast<const PhasedArrayModel> (gnbPhy->GetAntenna ());
+              for (const auto &uePhy : uePhys)
+                {
+                  if (uePhy.first->GetSpectrumChannel () == channel)
+                    {
+                      modelIt->second.push_back ({gnbPhy->GetMobility (), uePhy.first->GetMobility (),
+                                                  gnbAntenna, uePhy.second});
+                    }
+                }
+            }
+        }
+    }
+
+  for (const auto &modelLinks : links)
+    {
+      NS_LOG_INFO ("Precomputing " << modelLinks.second.size () << " channels with " << numThreads << " threads");
+      modelLinks.first->PrecomputeChannels (modelLinks.second, numThreads);
+    }
+}
+
+void
+NrHelper::AssignSimulatorPartitions (const NetDeviceContainer &gnbDevices,
+                                     const NetDeviceContainer &ueDevices)
+{
+  NS_LOG_FUNCTION (this << gnbDevices.GetN () << ueDevices.GetN ());
+
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl == nullptr)
+    {
+      NS_LOG_WARN ("The simulator is not a MultithreadedSimulatorImpl: the cells run serially");
+      return;
+    }
+
+  std::map<Ptr<const NrGnbNetDevice>, uint32_t> partitionOfGnb;
+  std::vector<Ptr<MobilityModel>> gnbMobility;
+  for (uint32_t i = 0; i < gnbDevices.GetN (); ++i)
+    {
+      Ptr<NrGnbNetDevice> gnbDev = DynamicCast<NrGnbNetDevice> (gnbDevices.Get (i));
+      NS_ABORT_MSG_IF (gnbDev == nullptr, "AssignSimulatorPartitions: not a GNB device");
+      NS_ABORT_MSG_IF (impl->GetPartition (gnbDev->GetNode ()->GetId ()) != MultithreadedSimulatorImpl::SERIAL_PARTITION
+                       && impl->GetPartition (gnbDev->GetNode ()->GetId ()) != i,
+                       "AssignSimulatorPartitions: node " << gnbDev->GetNode ()->GetId ()
+                       << " has more than one GNB device");
+      impl->SetPartition (gnbDev->GetNode ()->GetId (), i);
+      partitionOfGnb[gnbDev] = i;
+      gnbMobility.push_back (gnbDev->GetNode ()->GetObject<MobilityModel> ());
+    }
+
+  std::vector<Ptr<MobilityModel>> ueMobility;
+  for (uint32_t i = 0; i < ueDevices.GetN (); ++i)
+    {
+      Ptr<NrUeNetDevice> ueDev = DynamicCast<NrUeNetDevice> (ueDevices.Get (i));
+      NS_ABORT_MSG_IF (ueDev == nullptr, "AssignSimulatorPartitions: not a UE device");
+      auto it = partitionOfGnb.find (ueDev->GetTargetEnb ());
+      NS_ABORT_MSG_IF (it == partitionOfGnb.end (),
+                       "AssignSimulatorPartitions: the UE of node " << ueDev->GetNode ()->GetId ()
+                       << " is not attached to a GNB of the container");
+      impl->SetPartition (ueDev->GetNode ()->GetId (), it->second);
+      ueMobility.push_back (ueDev->GetNode ()->GetObject<MobilityModel> ());
+    }
+
+  // The minimum distance between the transmitters and the receivers
+  double minDistance = std::numeric_limits<double>::max ();
+  auto updateDistance = [&minDistance] (const std::vector<Ptr<MobilityModel>> &a,
+                                        const std::vector<Ptr<MobilityModel>> &b)
+    {
+      for (const auto &ma : a)
+        {
+          for (const auto &mb : b)
+            {
+              if (ma != nullptr && mb != nullptr && ma != mb)
+                {
+                  minDistance = std::min (minDistance, ma->GetDistanceFrom (mb));
+                }
+            }
+        }
+    };
+  updateDistance (gnbMobility, gnbMobility);
+  updateDistance (gnbMobility, ueMobility);
+  BooleanValue ueUeInterference;
+  CreateObject<NrSpectrumTransmitFilter> ()->GetAttribute ("UeUeInterference", ueUeInterference);
+  if (ueUeInterference.Get ())
+    {
+      updateDistance (ueMobility, ueMobility);
+    }
+  Time lookahead = Seconds (minDistance / 299792458.0);
+
+  if (m_epcHelper != nullptr)
+    {
+      for (const char *link : {"S1uLinkDelay", "X2LinkDelay", "S11LinkDelay"})
+        {
+          TimeValue delay;
+          if (m_epcHelper->GetAttributeFailSafe (link, delay))
+            {
+              lookahead = std::min (lookahead, delay.Get ());
+            }
+        }
+    }
+
+  NS_ABORT_MSG_UNLESS (lookahead.IsStrictlyPositive (),
+                       "AssignSimulatorPartitions: the lookahead is zero; the nodes must not "
+                       "be co-located, and the S1-U, X2 and S11 links must have a delay");
+  NS_LOG_INFO ("Assigned " << gnbDevices.GetN () << " partitions, with lookahead " << lookahead);
+  impl->SetLookahead (lookahead);
+}
+
 uint8_t
 NrHelper::ActivateDedicatedEpsBearer (NetDeviceContainer ueDevices, EpsBearer bearer, Ptr<EpcTft> tft)
 {
@@ -1519,6 +1697,15 @@ NrHelper::EnableTraces (void)
   EnablePathlossTraces ();
 }
 
+void
+NrHelper::EnableTraces (NrTraceSink::Format format, uint32_t bufferSize)
+{
+  NS_LOG_FUNCTION (this << format << bufferSize);
+  m_phyStats->SetTraceFormat (format, bufferSize);
+  m_macStats->SetTraceFormat (format, bufferSize);
+  EnableTraces ();
+}
+
 Ptr<NrPhyRxTrace>
 NrHelper::GetPhyRxTrace (void)
 {
@@ -33,6 +33,7 @@
 #include "ideal-beamforming-helper.h"
 #include "cc-bwp-helper.h"
 #include "nr-mac-scheduling-stats.h"
+#include "nr-trace-sink.h"
 
 namespace ns3 {
 
@@ -318,6 +319,55 @@ public:
    */
   void AttachToEnb (const Ptr<NetDevice> &ueDevice, const Ptr<NetDevice> &gnbDevice);
 
+  /**
+   * \brief Generate the channel matrices between the GNBs and the UEs
+   *
+   * Without this call, the 3GPP channel model generates the channel of a
+   * pair of antennas at the first transmission between them, which slows
+   * down the first slots of large scenarios. This method generates, for
+   * every BWP of every GNB, the channel towards each UE whose PHY uses the
+   * same channel, with ThreeGppChannelModel::PrecomputeChannels: the
+   * channel parameters are drawn serially, in the order of the
+   * containers, and the channel coefficients are computed on a pool of
+   * threads. The realizations do not depend on the number of threads.
+   *
+   * Call it after the installation of the devices (and after AssignStreams,
+   * if used) and before the start of the simulation. Channels that do not
+   * use a ThreeGppChannelModel are skipped.
+   *
+   * \param gnbDevices the GNB devices
+   * \param ueDevices the UE devices
+   * \param numThreads the number of threads; 0 selects the number of
+   * hardware threads
+   */
+  void PrecomputeChannels (const NetDeviceContainer &gnbDevices, const NetDeviceContainer &ueDevices,
+                           uint32_t numThreads = 0);
+
+  /**
+   * \brief Run each GNB, with its UEs, in a partition of the simulator
+   *
+   * If the simulator is a MultithreadedSimulatorImpl, the node of the i-th
+   * GNB goes to the partition i, and the node of each UE to the partition
+   * of the GNB to which it is attached; the cells then run in parallel.
+   * The other nodes (e.g., the core network and the remote hosts) run on
+   * the main thread. The lookahead of the simulator is set to the minimum
+   * propagation delay between the nodes that share a channel (without the
+   * UE to UE links, if NrSpectrumTransmitFilter skips them), and to the
+   * delay of the S1-U, X2 and S11 links, if lower: these must be positive.
+   *
+   * Call it after the attachment of the UEs and before the start of the
+   * simulation. The nodes must not move closer than at the time of the
+   * call, and the UEs must not hand over. The GNBs call the MME directly
+   * while the UEs connect: run that phase with the "MaxThreads" attribute
+   * of the simulator set to 1. The trace sinks connected with
+   * EnableTraces () are shared by the cells: they are not thread safe.
+   *
+   * \param gnbDevices the GNB devices
+   * \param ueDevices the UE devices
+   */
+  void AssignSimulatorPartitions (const NetDeviceContainer &gnbDevices,
+                                  const NetDeviceContainer &ueDevices);
+
   /**
    * \brief Enables the following traces:
    * Transmitted/Received Control Messages
@@ -328,6 +378,24 @@ public:
    */
   void EnableTraces ();
 
+  /**
+   * \brief Enables the same traces of EnableTraces (), selecting the
+   * format of the PHY and MAC trace files (RxPacketTrace, DlCtrlSinr,
+   * control messages, pathloss, ...)
+   *
+   * With NrTraceSink::BUFFERED_TEXT the files have the same content of the
+   * default format, but they are written through a large buffer instead of
+   * being flushed at every record. With NrTraceSink::BINARY the records are
+   * written in binary form, in ".bin" files that can be converted to the
+   * text files with the nr-trace-convert program.
+   *
+   * \param format the format of the PHY and MAC trace files
+   * \param bufferSize the size, in bytes, of the buffer of each file
+   * (not used with NrTraceSink::FLUSHED_TEXT). The per-UE and per-cell files
+   * use a smaller buffer, see NrPhyRxTrace::SetTraceFormat
+   */
+  void EnableTraces (NrTraceSink::Format format, uint32_t bufferSize = 1 << 20);
+
   /**
    * \brief Activate a Data Radio Bearer on a given UE devices
    *
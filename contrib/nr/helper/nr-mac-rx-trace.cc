@@ -21,7 +21,6 @@
 #include "nr-mac-rx-trace.h"
 #include <ns3/simulator.h>
 #include <stdio.h>
-#include <fstream>
 
 namespace ns3 {
 
@@ -29,15 +28,45 @@ NS_LOG_COMPONENT_DEFINE ("NrMacRxTrace");
 
 NS_OBJECT_ENSURE_REGISTERED (NrMacRxTrace);
 
-std::ofstream NrMacRxTrace::m_rxedGnbMacCtrlMsgsFile;
-std::string NrMacRxTrace::m_rxedGnbMacCtrlMsgsFileName;
-std::ofstream NrMacRxTrace::m_txedGnbMacCtrlMsgsFile;
-std::string NrMacRxTrace::m_txedGnbMacCtrlMsgsFileName;
+Ptr<NrTraceSink> NrMacRxTrace::m_rxedGnbMacCtrlMsgsFile;
+Ptr<NrTraceSink> NrMacRxTrace::m_txedGnbMacCtrlMsgsFile;
 
-std::ofstream NrMacRxTrace::m_rxedUeMacCtrlMsgsFile;
-std::string NrMacRxTrace::m_rxedUeMacCtrlMsgsFileName;
-std::ofstream NrMacRxTrace::m_txedUeMacCtrlMsgsFile;
-std::string NrMacRxTrace::m_txedUeMacCtrlMsgsFileName;
+Ptr<NrTraceSink> NrMacRxTrace::m_rxedUeMacCtrlMsgsFile;
+Ptr<NrTraceSink> NrMacRxTrace::m_txedUeMacCtrlMsgsFile;
+
+/**
+ * Layout of the MAC control messages records. The header of the files
+ * has a VarTTI column, which is not written in the records.
+ */
+static const NrTraceSink::Layout g_ctrlMsgsLayout {{{"Time", NrTraceSink::DOUBLE},
+                                                    {"Entity", NrTraceSink::STRING},
+                                                    {"Frame", NrTraceSink::UINT},
+                                                    {"SF", NrTraceSink::UINT},
+                                                    {"Slot", NrTraceSink::UINT},
+                                                    {"nodeId", NrTraceSink::UINT},
+                                                    {"RNTI", NrTraceSink::UINT},
+                                                    {"bwpId", NrTraceSink::UINT},
+                                                    {"MsgType", NrTraceSink::STRING}}};
+
+/**
+ * \brief Name of a control message type, as written in the control messages traces
+ * \param msg the message
+ * \param types the message types reported by the trace
+ * \return the name of the type, or "Other" if it is not one of the reported types
+ */
+static const char *
+CtrlMsgTypeName (Ptr<const NrControlMessage> msg,
+                 std::initializer_list<std::pair<NrControlMessage::messageType, const char *>> types)
+{
+  for (const auto &t : types)
+    {
+      if (msg->GetMessageType () == t.first)
+        {
+          return t.second;
+        }
+    }
+  return "Other";
+}
 
 NrMacRxTrace::NrMacRxTrace ()
 {
@@ -45,25 +74,11 @@ NrMacRxTrace::NrMacRxTrace ()
 
 NrMacRxTrace::~NrMacRxTrace ()
 {
-  if (m_rxedGnbMacCtrlMsgsFile.is_open ())
-    {
-      m_rxedGnbMacCtrlMsgsFile.close ();
-    }
-
-  if (m_txedGnbMacCtrlMsgsFile.is_open ())
-    {
-      m_txedGnbMacCtrlMsgsFile.close ();
-    }
-
-  if (m_rxedUeMacCtrlMsgsFile.is_open ())
-    {
-      m_rxedUeMacCtrlMsgsFile.close ();
-    }
-
-  if (m_txedUeMacCtrlMsgsFile.is_open ())
-    {
-      m_txedUeMacCtrlMsgsFile.close ();
-    }
+  // releasing the sinks flushes and closes the files
+  m_rxedGnbMacCtrlMsgsFile = nullptr;
+  m_txedGnbMacCtrlMsgsFile = nullptr;
+  m_rxedUeMacCtrlMsgsFile = nullptr;
+  m_txedUeMacCtrlMsgsFile = nullptr;
 }
 
 TypeId
@@ -77,197 +92,97 @@ NrMacRxTrace::GetTypeId (void)
 }
 
 void
-NrMacRxTrace::RxedGnbMacCtrlMsgsCallback (Ptr<NrMacRxTrace> macStats, std::string path,
-                                              SfnSf sfn, uint16_t nodeId, uint16_t rnti,
-                                              uint8_t bwpId, Ptr<const NrControlMessage> msg)
+NrMacRxTrace::SetTraceFormat (NrTraceSink::Format format, uint32_t bufferSize)
 {
-  if (!m_rxedGnbMacCtrlMsgsFile.is_open ())
-      {
-        m_rxedGnbMacCtrlMsgsFileName = "RxedGnbMacCtrlMsgsTrace.txt";
-        m_rxedGnbMacCtrlMsgsFile.open (m_rxedGnbMacCtrlMsgsFileName.c_str ());
-        m_rxedGnbMacCtrlMsgsFile << "Time" << "\t" << "Entity" << "\t" <<
-                                    "Frame" << "\t" << "SF" << "\t" << "Slot" <<
-                                    "\t" << "VarTTI" << "\t" << "nodeId" <<
-                                    "\t" << "RNTI" << "\t" << "bwpId"<<
-                                    "\t" << "MsgType" << std::endl;
-
-        if (!m_rxedGnbMacCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
+  m_format = format;
+  m_bufferSize = bufferSize;
+}
 
-  m_rxedGnbMacCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                              "\t" << "ENB MAC Rxed"  << "\t" << sfn.GetFrame () <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                              "\t" << nodeId << "\t" << rnti <<
-                              "\t" << static_cast<uint32_t> (bwpId) << "\t";
+Ptr<NrTraceSink>
+NrMacRxTrace::OpenSink (const std::string &fileName, const std::string &header) const
+{
+  return NrTraceSink::Open (fileName, header, m_format, m_bufferSize);
+}
 
-  if (msg->GetMessageType () == NrControlMessage::SR)
-    {
-      m_rxedGnbMacCtrlMsgsFile << "SR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_CQI)
-    {
-      m_rxedGnbMacCtrlMsgsFile << "DL_CQI";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::BSR)
-    {
-      m_rxedGnbMacCtrlMsgsFile << "BSR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_HARQ)
-    {
-      m_rxedGnbMacCtrlMsgsFile << "DL_HARQ";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::RACH_PREAMBLE)
-    {
-      m_rxedGnbMacCtrlMsgsFile << "RACH_PREAMBLE";
-    }
-  else
+void
+NrMacRxTrace::RxedGnbMacCtrlMsgsCallback (Ptr<NrMacRxTrace> macStats, std::string path,
+                                          SfnSf sfn, uint16_t nodeId, uint16_t rnti,
+                                          uint8_t bwpId, Ptr<const NrControlMessage> msg)
+{
+  if (!m_rxedGnbMacCtrlMsgsFile)
     {
-      m_rxedGnbMacCtrlMsgsFile << "Other";
+      m_rxedGnbMacCtrlMsgsFile = macStats->OpenSink ("RxedGnbMacCtrlMsgsTrace.txt",
+                                                     "Time\tEntity\tFrame\tSF\tSlot\tVarTTI\tnodeId\tRNTI\tbwpId\tMsgType");
     }
-  m_rxedGnbMacCtrlMsgsFile << std::endl;
+
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::SR, "SR"},
+                                               {NrControlMessage::DL_CQI, "DL_CQI"},
+                                               {NrControlMessage::BSR, "BSR"},
+                                               {NrControlMessage::DL_HARQ, "DL_HARQ"},
+                                               {NrControlMessage::RACH_PREAMBLE, "RACH_PREAMBLE"}});
+
+  m_rxedGnbMacCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                   "ENB MAC Rxed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                   nodeId, rnti, bwpId, msgType);
 }
 
 void
 NrMacRxTrace::TxedGnbMacCtrlMsgsCallback (Ptr<NrMacRxTrace> macStats, std::string path,
-                                              SfnSf sfn, uint16_t nodeId, uint16_t rnti,
-                                              uint8_t bwpId, Ptr<const NrControlMessage> msg)
+                                          SfnSf sfn, uint16_t nodeId, uint16_t rnti,
+                                          uint8_t bwpId, Ptr<const NrControlMessage> msg)
 {
-  if (!m_txedGnbMacCtrlMsgsFile.is_open ())
-      {
-        m_txedGnbMacCtrlMsgsFileName = "TxedGnbMacCtrlMsgsTrace.txt";
-        m_txedGnbMacCtrlMsgsFile.open (m_txedGnbMacCtrlMsgsFileName.c_str ());
-        m_txedGnbMacCtrlMsgsFile << "Time" << "\t" << "Entity" << "\t" <<
-                                    "Frame" << "\t" << "SF" << "\t" << "Slot" <<
-                                    "\t" << "VarTTI" "\t" << "nodeId" <<
-                                    "\t" << "RNTI" << "\t" << "bwpId" <<
-                                    "\t" << "MsgType" << std::endl;
-
-        if (!m_txedGnbMacCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_txedGnbMacCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                              "\t" << "ENB MAC Txed"  << "\t" << sfn.GetFrame () <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                              "\t" << nodeId << "\t" << rnti <<
-                              "\t" << static_cast<uint32_t> (bwpId) << "\t";
-
-  if (msg->GetMessageType () == NrControlMessage::RAR)
-    {
-      m_txedGnbMacCtrlMsgsFile << "RAR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_CQI)
+  if (!m_txedGnbMacCtrlMsgsFile)
     {
-      m_txedGnbMacCtrlMsgsFile << "DL_CQI";
-    }
-  else
-    {
-      m_txedGnbMacCtrlMsgsFile << "Other";
+      m_txedGnbMacCtrlMsgsFile = macStats->OpenSink ("TxedGnbMacCtrlMsgsTrace.txt",
+                                                     "Time\tEntity\tFrame\tSF\tSlot\tVarTTI\tnodeId\tRNTI\tbwpId\tMsgType");
     }
 
-  m_txedGnbMacCtrlMsgsFile << std::endl;
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::RAR, "RAR"},
+                                               {NrControlMessage::DL_CQI, "DL_CQI"}});
+
+  m_txedGnbMacCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                   "ENB MAC Txed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                   nodeId, rnti, bwpId, msgType);
 }
 
 void
 NrMacRxTrace::RxedUeMacCtrlMsgsCallback (Ptr<NrMacRxTrace> macStats, std::string path,
-                                             SfnSf sfn, uint16_t nodeId, uint16_t rnti,
-                                             uint8_t bwpId, Ptr<const NrControlMessage> msg)
+                                        SfnSf sfn, uint16_t nodeId, uint16_t rnti,
+                                        uint8_t bwpId, Ptr<const NrControlMessage> msg)
 {
-  if (!m_rxedUeMacCtrlMsgsFile.is_open ())
-      {
-        m_rxedUeMacCtrlMsgsFileName = "RxedUeMacCtrlMsgsTrace.txt";
-        m_rxedUeMacCtrlMsgsFile.open (m_rxedUeMacCtrlMsgsFileName.c_str ());
-        m_rxedUeMacCtrlMsgsFile << "Time" << "\t" << "Entity" << "\t" <<
-                                   "Frame" << "\t" << "SF" << "\t" << "Slot" <<
-                                   "\t" << "VarTTI" << "\t" << "nodeId" <<
-                                   "\t" << "RNTI" << "\t" << "bwpId" <<
-                                   "\t" << "MsgType" << std::endl;
-
-        if (!m_rxedUeMacCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_rxedUeMacCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                             "\t" << "UE  MAC Rxed" << "\t" << sfn.GetFrame () <<
-                             "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                             "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                             "\t" << nodeId << "\t" << rnti <<
-                             "\t" << static_cast<uint32_t> (bwpId) << "\t";
-
-  if (msg->GetMessageType () == NrControlMessage::UL_DCI)
-    {
-      m_rxedUeMacCtrlMsgsFile << "UL_DCI";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_DCI)
+  if (!m_rxedUeMacCtrlMsgsFile)
     {
-      m_rxedUeMacCtrlMsgsFile << "DL_DCI";
+      m_rxedUeMacCtrlMsgsFile = macStats->OpenSink ("RxedUeMacCtrlMsgsTrace.txt",
+                                                    "Time\tEntity\tFrame\tSF\tSlot\tVarTTI\tnodeId\tRNTI\tbwpId\tMsgType");
     }
-  else if (msg->GetMessageType () == NrControlMessage::RAR)
-    {
-      m_rxedUeMacCtrlMsgsFile << "RAR";
-    }
-  else
-    {
-      m_rxedUeMacCtrlMsgsFile << "Other";
-    }
-  m_rxedUeMacCtrlMsgsFile << std::endl;
+
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::UL_DCI, "UL_DCI"},
+                                               {NrControlMessage::DL_DCI, "DL_DCI"},
+                                               {NrControlMessage::RAR, "RAR"}});
+
+  m_rxedUeMacCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                  "UE  MAC Rxed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                  nodeId, rnti, bwpId, msgType);
 }
 
 void
 NrMacRxTrace::TxedUeMacCtrlMsgsCallback (Ptr<NrMacRxTrace> macStats, std::string path,
-                                             SfnSf sfn, uint16_t nodeId, uint16_t rnti,
-                                             uint8_t bwpId, Ptr<const NrControlMessage> msg)
+                                        SfnSf sfn, uint16_t nodeId, uint16_t rnti,
+                                        uint8_t bwpId, Ptr<const NrControlMessage> msg)
 {
-  if (!m_txedUeMacCtrlMsgsFile.is_open ())
-      {
-        m_txedUeMacCtrlMsgsFileName = "TxedUeMacCtrlMsgsTrace.txt";
-        m_txedUeMacCtrlMsgsFile.open (m_txedUeMacCtrlMsgsFileName.c_str ());
-        m_txedUeMacCtrlMsgsFile << "Time" << "\t" << "Entity" << "\t" <<
-                                   "Frame" << "\t" << "SF" <<
-                                   "\t" << "Slot" << "\t" << "VarTTI" <<
-                                   "\t" << "nodeId" << "\t" << "RNTI" <<
-                                   "\t" << "bwpId" <<
-                                   "\t" << "MsgType" << std::endl;
-
-        if (!m_txedUeMacCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_txedUeMacCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                             "\t" << "UE  MAC Txed" << "\t" << sfn.GetFrame () <<
-                             "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                             "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                             "\t" << nodeId << "\t" << rnti <<
-                             "\t" << static_cast<uint32_t> (bwpId) << "\t";
-
-  if (msg->GetMessageType () == NrControlMessage::BSR)
+  if (!m_txedUeMacCtrlMsgsFile)
     {
-      m_txedUeMacCtrlMsgsFile << "BSR";
+      m_txedUeMacCtrlMsgsFile = macStats->OpenSink ("TxedUeMacCtrlMsgsTrace.txt",
+                                                    "Time\tEntity\tFrame\tSF\tSlot\tVarTTI\tnodeId\tRNTI\tbwpId\tMsgType");
     }
-  else if (msg->GetMessageType () == NrControlMessage::SR)
-    {
-      m_txedUeMacCtrlMsgsFile << "SR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::RACH_PREAMBLE)
-    {
-      m_txedUeMacCtrlMsgsFile << "RACH_PREAMBLE";
-    }
-  else
-    {
-      m_txedUeMacCtrlMsgsFile << "Other";
-    }
-  m_txedUeMacCtrlMsgsFile << std::endl;
+
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::BSR, "BSR"},
+                                               {NrControlMessage::SR, "SR"},
+                                               {NrControlMessage::RACH_PREAMBLE, "RACH_PREAMBLE"}});
+
+  m_txedUeMacCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                  "UE  MAC Txed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                  nodeId, rnti, bwpId, msgType);
 }
 
 } /* namespace ns3 */
@@ -25,6 +25,7 @@
 #include <ns3/nr-phy-mac-common.h>
 #include <ns3/nr-control-messages.h>
 #include <ns3/nr-gnb-mac.h>
+#include <ns3/nr-trace-sink.h>
 #include <iostream>
 
 namespace ns3 {
@@ -36,6 +37,14 @@ public:
   virtual ~NrMacRxTrace ();
   static TypeId GetTypeId (void);
 
+  /**
+   * \brief Set the format of the trace files opened from now on
+   * \param format the format
+   * \param bufferSize the size, in bytes, of the buffer of each BUFFERED_TEXT
+   * or BINARY file
+   */
+  void SetTraceFormat (NrTraceSink::Format format, uint32_t bufferSize);
+
   /**
    *  Trace sink for Enb Mac Received Control Messages.
    *
@@ -101,16 +110,22 @@ public:
                                          uint8_t bwpId, Ptr<const NrControlMessage> msg);
 
 private:
+  /**
+   * \brief Open a trace file, in the format of this object
+   * \param fileName the file name
+   * \param header the header of the file
+   * \return the sink
+   */
+  Ptr<NrTraceSink> OpenSink (const std::string &fileName, const std::string &header) const;
+
+  NrTraceSink::Format m_format {NrTraceSink::FLUSHED_TEXT}; //!< Format of the files
+  uint32_t m_bufferSize {1 << 20};                          //!< Buffer size of the files
 
-  static std::ofstream m_rxedGnbMacCtrlMsgsFile;
-  static std::string m_rxedGnbMacCtrlMsgsFileName;
-  static std::ofstream m_txedGnbMacCtrlMsgsFile;
-  static std::string m_txedGnbMacCtrlMsgsFileName;
+  static Ptr<NrTraceSink> m_rxedGnbMacCtrlMsgsFile; //!< Control messages received by the gNB MAC
+  static Ptr<NrTraceSink> m_txedGnbMacCtrlMsgsFile; //!< Control messages transmitted by the gNB MAC
 
-  static std::ofstream m_rxedUeMacCtrlMsgsFile;
-  static std::string m_rxedUeMacCtrlMsgsFileName;
-  static std::ofstream m_txedUeMacCtrlMsgsFile;
-  static std::string m_txedUeMacCtrlMsgsFileName;
+  static Ptr<NrTraceSink> m_rxedUeMacCtrlMsgsFile;  //!< Control messages received by the UE MAC
+  static Ptr<NrTraceSink> m_txedUeMacCtrlMsgsFile;  //!< Control messages transmitted by the UE MAC
 };
 
 } /* namespace ns3 */
@@ -33,6 +33,7 @@
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/nr-gnb-net-device.h>
 #include <stdio.h>
+#include <algorithm>
 #include <ns3/string.h>
 
 namespace ns3 {
@@ -41,33 +42,124 @@ NS_LOG_COMPONENT_DEFINE ("NrPhyRxTrace");
 
 NS_OBJECT_ENSURE_REGISTERED (NrPhyRxTrace);
 
-std::ofstream NrPhyRxTrace::m_dlDataSinrFile;
-std::string NrPhyRxTrace::m_dlDataSinrFileName;
-
-std::ofstream NrPhyRxTrace::m_dlCtrlSinrFile;
-std::string NrPhyRxTrace::m_dlCtrlSinrFileName;
-
-std::ofstream NrPhyRxTrace::m_rxPacketTraceFile;
-std::string NrPhyRxTrace::m_rxPacketTraceFilename;
+Ptr<NrTraceSink> NrPhyRxTrace::m_dlDataSinrFile;
+Ptr<NrTraceSink> NrPhyRxTrace::m_dlCtrlSinrFile;
+Ptr<NrTraceSink> NrPhyRxTrace::m_rxPacketTraceFile;
 std::string NrPhyRxTrace::m_simTag;
 
-std::ofstream NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFile;
-std::string NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFileName;
-std::ofstream NrPhyRxTrace::m_txedGnbPhyCtrlMsgsFile;
-std::string NrPhyRxTrace::m_txedGnbPhyCtrlMsgsFileName;
-
-std::ofstream NrPhyRxTrace::m_rxedUePhyCtrlMsgsFile;
-std::string NrPhyRxTrace::m_rxedUePhyCtrlMsgsFileName;
-std::ofstream NrPhyRxTrace::m_txedUePhyCtrlMsgsFile;
-std::string NrPhyRxTrace::m_txedUePhyCtrlMsgsFileName;
-std::ofstream NrPhyRxTrace::m_rxedUePhyDlDciFile;
-std::string NrPhyRxTrace::m_rxedUePhyDlDciFileName;
-
-std::ofstream NrPhyRxTrace::m_dlPathlossFile;
-std::string NrPhyRxTrace::m_dlPathlossFileName;
-std::ofstream NrPhyRxTrace::m_ulPathlossFile;
-std::string NrPhyRxTrace::m_ulPathlossFileName;
-
+Ptr<NrTraceSink> NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFile;
+Ptr<NrTraceSink> NrPhyRxTrace::m_txedGnbPhyCtrlMsgsFile;
+
+Ptr<NrTraceSink> NrPhyRxTrace::m_rxedUePhyCtrlMsgsFile;
+Ptr<NrTraceSink> NrPhyRxTrace::m_txedUePhyCtrlMsgsFile;
+Ptr<NrTraceSink> NrPhyRxTrace::m_rxedUePhyDlDciFile;
+
+Ptr<NrTraceSink> NrPhyRxTrace::m_dlPathlossFile;
+Ptr<NrTraceSink> NrPhyRxTrace::m_ulPathlossFile;
+
+std::map<uint64_t, Ptr<NrTraceSink>> NrPhyRxTrace::m_ulSinrFiles;
+std::map<uint64_t, Ptr<NrTraceSink>> NrPhyRxTrace::m_interferenceFiles;
+std::map<uint64_t, Ptr<NrTraceSink>> NrPhyRxTrace::m_powerFiles;
+std::map<uint64_t, Ptr<NrTraceSink>> NrPhyRxTrace::m_uePacketCountFiles;
+std::map<uint64_t, Ptr<NrTraceSink>> NrPhyRxTrace::m_gnbPacketCountFiles;
+std::map<uint64_t, Ptr<NrTraceSink>> NrPhyRxTrace::m_tbSizeFiles;
+std::deque<std::pair<std::map<uint64_t, Ptr<NrTraceSink>> *, uint64_t>> NrPhyRxTrace::m_openIdSinks;
+
+/// Layout of the DL DATA and CTRL SINR records
+static const NrTraceSink::Layout g_sinrLayout {{{"Time", NrTraceSink::DOUBLE},
+                                                {"CellId", NrTraceSink::UINT},
+                                                {"RNTI", NrTraceSink::UINT},
+                                                {"BWPId", NrTraceSink::UINT},
+                                                {"StreamId", NrTraceSink::UINT},
+                                                {"SINR(dB)", NrTraceSink::DOUBLE}}};
+
+/// Layout of the PHY control messages records
+static const NrTraceSink::Layout g_ctrlMsgsLayout {{{"Time", NrTraceSink::DOUBLE},
+                                                    {"Entity", NrTraceSink::STRING},
+                                                    {"Frame", NrTraceSink::UINT},
+                                                    {"SF", NrTraceSink::UINT},
+                                                    {"Slot", NrTraceSink::UINT},
+                                                    {"nodeId", NrTraceSink::UINT},
+                                                    {"RNTI", NrTraceSink::UINT},
+                                                    {"bwpId", NrTraceSink::UINT},
+                                                    {"MsgType", NrTraceSink::STRING}}};
+
+/// Layout of the DL DCI and HARQ feedback records
+static const NrTraceSink::Layout g_dlDciLayout {{{"Time", NrTraceSink::DOUBLE},
+                                                 {"Entity", NrTraceSink::STRING},
+                                                 {"Frame", NrTraceSink::UINT},
+                                                 {"SF", NrTraceSink::UINT},
+                                                 {"Slot", NrTraceSink::UINT},
+                                                 {"nodeId", NrTraceSink::UINT},
+                                                 {"RNTI", NrTraceSink::UINT},
+                                                 {"bwpId", NrTraceSink::UINT},
+                                                 {"Harq ID", NrTraceSink::UINT},
+                                                 {"K1 Delay", NrTraceSink::UINT}}};
+
+/// Layout of the DL records of RxPacketTrace
+static const NrTraceSink::Layout g_rxPacketDlLayout {{{"Time", NrTraceSink::DOUBLE},
+                                                      {"direction", NrTraceSink::STRING},
+                                                      {"frame", NrTraceSink::UINT},
+                                                      {"subF", NrTraceSink::UINT},
+                                                      {"slot", NrTraceSink::UINT},
+                                                      {"1stSym", NrTraceSink::UINT},
+                                                      {"nSymbol", NrTraceSink::UINT},
+                                                      {"cellId", NrTraceSink::UINT},
+                                                      {"bwpId", NrTraceSink::UINT},
+                                                      {"streamId", NrTraceSink::UINT},
+                                                      {"rnti", NrTraceSink::UINT},
+                                                      {"tbSize", NrTraceSink::UINT},
+                                                      {"mcs", NrTraceSink::UINT},
+                                                      {"rv", NrTraceSink::UINT},
+                                                      {"SINR(dB)", NrTraceSink::DOUBLE},
+                                                      {"CQI", NrTraceSink::UINT},
+                                                      {"corrupt", NrTraceSink::UINT},
+                                                      {"TBler", NrTraceSink::DOUBLE}}};
+
+/// Layout of the UL records of RxPacketTrace (no CQI)
+static const NrTraceSink::Layout g_rxPacketUlLayout {{{"Time", NrTraceSink::DOUBLE},
+                                                      {"direction", NrTraceSink::STRING},
+                                                      {"frame", NrTraceSink::UINT},
+                                                      {"subF", NrTraceSink::UINT},
+                                                      {"slot", NrTraceSink::UINT},
+                                                      {"1stSym", NrTraceSink::UINT},
+                                                      {"nSymbol", NrTraceSink::UINT},
+                                                      {"cellId", NrTraceSink::UINT},
+                                                      {"bwpId", NrTraceSink::UINT},
+                                                      {"streamId", NrTraceSink::UINT},
+                                                      {"rnti", NrTraceSink::UINT},
+                                                      {"tbSize", NrTraceSink::UINT},
+                                                      {"mcs", NrTraceSink::UINT},
+                                                      {"rv", NrTraceSink::UINT},
+                                                      {"SINR(dB)", NrTraceSink::DOUBLE},
+                                                      {"corrupt", NrTraceSink::UINT},
+                                                      {"TBler", NrTraceSink::DOUBLE}}};
+
+/// Layout of the DL and UL pathloss records
+static const NrTraceSink::Layout g_pathlossLayout {{{"Time(sec)", NrTraceSink::DOUBLE},
+                                                    {"CellId", NrTraceSink::UINT},
+                                                    {"BwpId", NrTraceSink::UINT},
+                                                    {"txStreamId", NrTraceSink::UINT},
+                                                    {"IMSI", NrTraceSink::UINT},
+                                                    {"rxStreamId", NrTraceSink::UINT},
+                                                    {"pathLoss(dB)", NrTraceSink::DOUBLE}}};
+
+/// Layout of the per-RB records of the per-UE SINR, interference and power traces
+static const NrTraceSink::Layout g_perRbLayout {{{"Subframe", NrTraceSink::UINT},
+                                                 {"Slot", NrTraceSink::UINT},
+                                                 {"RB", NrTraceSink::UINT},
+                                                 {"Value(dB)", NrTraceSink::FIXED}},
+                                                "\t", "\t "};
+
+/// Layout of the per-UE and per-cell packet count records
+static const NrTraceSink::Layout g_packetCountLayout {{{"Subframe", NrTraceSink::UINT},
+                                                       {"TxBytes", NrTraceSink::UINT},
+                                                       {"RxBytes", NrTraceSink::UINT}}};
+
+/// Layout of the per-UE DL TB size records
+static const NrTraceSink::Layout g_tbSizeLayout {{{"Time(us)", NrTraceSink::UINT},
+                                                  {"TbSize", NrTraceSink::UINT}},
+                                                 " \t ", ""};
 
 NrPhyRxTrace::NrPhyRxTrace ()
 {
@@ -75,55 +167,24 @@ NrPhyRxTrace::NrPhyRxTrace ()
 
 NrPhyRxTrace::~NrPhyRxTrace ()
 {
-  if (m_dlDataSinrFile.is_open ())
-    {
-      m_dlDataSinrFile.close ();
-    }
-
-  if (m_dlCtrlSinrFile.is_open ())
-    {
-      m_dlCtrlSinrFile.close ();
-    }
-
-  if (m_rxPacketTraceFile.is_open ())
-    {
-      m_rxPacketTraceFile.close ();
-    }
-
-  if (m_rxedGnbPhyCtrlMsgsFile.is_open ())
-    {
-      m_rxedGnbPhyCtrlMsgsFile.close ();
-    }
-
-  if (m_txedGnbPhyCtrlMsgsFile.is_open ())
-    {
-      m_txedGnbPhyCtrlMsgsFile.close ();
-    }
-
-  if (m_rxedUePhyCtrlMsgsFile.is_open ())
-    {
-      m_rxedUePhyCtrlMsgsFile.close ();
-    }
-
-  if (m_txedUePhyCtrlMsgsFile.is_open ())
-    {
-      m_txedUePhyCtrlMsgsFile.close ();
-    }
-
-  if (m_rxedUePhyDlDciFile.is_open ())
-    {
-      m_rxedUePhyDlDciFile.close ();
-    }
-
-  if (m_dlPathlossFile.is_open ())
-    {
-      m_dlPathlossFile.close ();
-    }
-
-  if (m_ulPathlossFile.is_open ())
-    {
-      m_ulPathlossFile.close ();
-    }
+  // releasing the sinks flushes and closes the files
+  m_dlDataSinrFile = nullptr;
+  m_dlCtrlSinrFile = nullptr;
+  m_rxPacketTraceFile = nullptr;
+  m_rxedGnbPhyCtrlMsgsFile = nullptr;
+  m_txedGnbPhyCtrlMsgsFile = nullptr;
+  m_rxedUePhyCtrlMsgsFile = nullptr;
+  m_txedUePhyCtrlMsgsFile = nullptr;
+  m_rxedUePhyDlDciFile = nullptr;
+  m_dlPathlossFile = nullptr;
+  m_ulPathlossFile = nullptr;
+  m_ulSinrFiles.clear ();
+  m_interferenceFiles.clear ();
+  m_powerFiles.clear ();
+  m_uePacketCountFiles.clear ();
+  m_gnbPacketCountFiles.clear ();
+  m_tbSizeFiles.clear ();
+  m_openIdSinks.clear ();
 }
 
 TypeId
@@ -149,57 +210,73 @@ NrPhyRxTrace::SetSimTag (const std::string &simTag)
 }
 
 void
-NrPhyRxTrace::DlDataSinrCallback ([[maybe_unused]]Ptr<NrPhyRxTrace> phyStats, [[maybe_unused]] std::string path,
+NrPhyRxTrace::SetTraceFormat (NrTraceSink::Format format, uint32_t bufferSize)
+{
+  m_format = format;
+  m_bufferSize = bufferSize;
+}
+
+Ptr<NrTraceSink>
+NrPhyRxTrace::OpenSink (const std::string &fileName, const std::string &header) const
+{
+  return NrTraceSink::Open (fileName, header, m_format, m_bufferSize);
+}
+
+const Ptr<NrTraceSink> &
+NrPhyRxTrace::GetIdSink (std::map<uint64_t, Ptr<NrTraceSink>> &files, uint64_t id,
+                         const char *fileNameFormat) const
+{
+  auto it = files.find (id);
+  if (it == files.end ())
+    {
+      // With many UEs, keeping every file open would take a descriptor and
+      // a buffer per UE: the oldest file is closed, and reopened (these
+      // traces are appended to the files) if it is written again
+      if (m_openIdSinks.size () >= MAX_OPEN_ID_SINKS)
+        {
+          m_openIdSinks.front ().first->erase (m_openIdSinks.front ().second);
+          m_openIdSinks.pop_front ();
+        }
+      char fname[255];
+      snprintf (fname, sizeof (fname), fileNameFormat, (long long unsigned) id);
+      it = files.emplace (id, NrTraceSink::Open (fname, "", m_format,
+                                                 std::min (m_bufferSize, ID_SINK_BUFFER_SIZE),
+                                                 true)).first;
+      m_openIdSinks.emplace_back (&files, id);
+    }
+  return it->second;
+}
+
+void
+NrPhyRxTrace::DlDataSinrCallback (Ptr<NrPhyRxTrace> phyStats, [[maybe_unused]] std::string path,
                                   uint16_t cellId, uint16_t rnti, double avgSinr, uint16_t bwpId, uint8_t streamId)
 {
   NS_LOG_INFO ("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId << "->Generate RsrpSinrTrace");
-  if (!m_dlDataSinrFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "DlDataSinr" << m_simTag.c_str () << ".txt";
-        m_dlDataSinrFileName = oss.str ();
-        m_dlDataSinrFile.open (m_dlDataSinrFileName.c_str ());
-
-        m_dlDataSinrFile << "Time" << "\t" << "CellId" << "\t" << "RNTI" << "\t" << "BWPId"
-                       << "\t" << "StreamId" << "\t" << "SINR(dB)" << std::endl;
-
-        if (!m_dlDataSinrFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_dlDataSinrFile << Simulator::Now ().GetSeconds () <<
-                    "\t" << cellId << "\t" << rnti << "\t" << bwpId <<
-                    "\t" << +streamId << "\t" << 10 * log10 (avgSinr) << std::endl;
+  if (!m_dlDataSinrFile)
+    {
+      m_dlDataSinrFile = phyStats->OpenSink ("DlDataSinr" + m_simTag + ".txt",
+                                             "Time\tCellId\tRNTI\tBWPId\tStreamId\tSINR(dB)");
+    }
+
+  m_dlDataSinrFile->Write (g_sinrLayout, Simulator::Now ().GetSeconds (), cellId, rnti,
+                           bwpId, streamId, 10 * log10 (avgSinr));
 }
 
 
 void
-NrPhyRxTrace::DlCtrlSinrCallback ([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats, [[maybe_unused]] std::string path,
+NrPhyRxTrace::DlCtrlSinrCallback (Ptr<NrPhyRxTrace> phyStats, [[maybe_unused]] std::string path,
                                   uint16_t cellId, uint16_t rnti, double avgSinr, uint16_t bwpId, uint8_t streamId)
 {
   NS_LOG_INFO ("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId << "->Generate RsrpSinrTrace");
 
-  if (!m_dlCtrlSinrFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "DlCtrlSinr" << m_simTag.c_str () << ".txt";
-        m_dlCtrlSinrFileName = oss.str ();
-        m_dlCtrlSinrFile.open (m_dlCtrlSinrFileName.c_str ());
-
-        m_dlCtrlSinrFile << "Time" << "\t" << "CellId" << "\t" << "RNTI" << "\t" << "BWPId"
-                       << "\t" << "StreamId" << "\t" << "SINR(dB)" << std::endl;
-
-        if (!m_dlCtrlSinrFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_dlCtrlSinrFile << Simulator::Now ().GetSeconds () <<
-                    "\t" << cellId << "\t" << rnti << "\t" << bwpId <<
-                    "\t" << +streamId << "\t" << 10 * log10 (avgSinr) << std::endl;
+  if (!m_dlCtrlSinrFile)
+    {
+      m_dlCtrlSinrFile = phyStats->OpenSink ("DlCtrlSinr" + m_simTag + ".txt",
+                                             "Time\tCellId\tRNTI\tBWPId\tStreamId\tSINR(dB)");
+    }
+
+  m_dlCtrlSinrFile->Write (g_sinrLayout, Simulator::Now ().GetSeconds (), cellId, rnti,
+                           bwpId, streamId, 10 * log10 (avgSinr));
 }
 
 void
@@ -209,84 +286,59 @@ NrPhyRxTrace::UlSinrTraceCallback (Ptr<NrPhyRxTrace> phyStats, std::string path,
   NS_LOG_INFO ("UE" << imsi << "->Generate UlSinrTrace");
   uint64_t tti_count = Now ().GetMicroSeconds () / 125;
   uint32_t rb_count = 1;
-  FILE* log_file;
-  char fname[255];
-  sprintf (fname, "UE_%llu_UL_SINR_dB.txt", (long long unsigned ) imsi);
-  log_file = fopen (fname, "a");
+  const Ptr<NrTraceSink> &file = phyStats->GetIdSink (m_ulSinrFiles, imsi, "UE_%llu_UL_SINR_dB.txt");
   Values::iterator it = sinr.ValuesBegin ();
   while (it != sinr.ValuesEnd ())
     {
-      //fprintf(log_file, "%d\t%d\t%f\t \n", tti_count/2, rb_count, 10*log10(*it));
-      fprintf (log_file, "%llu\t%llu\t%d\t%f\t \n",(long long unsigned )tti_count / 8 + 1, (long long unsigned )tti_count % 8 + 1, rb_count, 10 * log10 (*it));
+      file->Write (g_perRbLayout, tti_count / 8 + 1, tti_count % 8 + 1, rb_count, 10 * log10 (*it));
       rb_count++;
       it++;
     }
-  fflush (log_file);
-  fclose (log_file);
   //phyStats->ReportInterferenceTrace (imsi, sinr);
   //phyStats->ReportPowerTrace (imsi, power);
 }
 
+/**
+ * \brief Name of a control message type, as written in the control messages traces
+ * \param msg the message
+ * \param types the message types reported by the trace
+ * \return the name of the type, or "Other" if it is not one of the reported types
+ */
+static const char *
+CtrlMsgTypeName (Ptr<const NrControlMessage> msg,
+                 std::initializer_list<std::pair<NrControlMessage::messageType, const char *>> types)
+{
+  for (const auto &t : types)
+    {
+      if (msg->GetMessageType () == t.first)
+        {
+          return t.second;
+        }
+    }
+  return "Other";
+}
+
 void
 NrPhyRxTrace::RxedGnbPhyCtrlMsgsCallback (Ptr<NrPhyRxTrace> phyStats, std::string path,
                                               SfnSf sfn, uint16_t nodeId, uint16_t rnti,
                                               uint8_t bwpId, Ptr<const NrControlMessage> msg)
 {
-  if (!m_rxedGnbPhyCtrlMsgsFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "RxedGnbPhyCtrlMsgsTrace" << m_simTag.c_str () << ".txt";
-        m_rxedGnbPhyCtrlMsgsFileName = oss.str ();
-        m_rxedGnbPhyCtrlMsgsFile.open (m_rxedGnbPhyCtrlMsgsFileName.c_str ());
-
-        m_rxedGnbPhyCtrlMsgsFile << "Time" << "\t" << "Entity"  << "\t" <<
-                                    "Frame" << "\t" << "SF" << "\t" << "Slot" <<
-                                    "\t" << "nodeId" << "\t" << "RNTI" <<
-                                    "\t" << "bwpId" << "\t" << "MsgType" << std::endl;
-
-        if (!m_rxedGnbPhyCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_rxedGnbPhyCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                              "\t" << "ENB PHY Rxed" << "\t" << sfn.GetFrame () <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                              "\t" << nodeId << "\t" << rnti <<
-                              "\t" << static_cast<uint32_t> (bwpId) << "\t";
-
-
-  if (msg->GetMessageType () == NrControlMessage::DL_CQI)
-    {
-      m_rxedGnbPhyCtrlMsgsFile << "DL_CQI";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::SR)
-    {
-      m_rxedGnbPhyCtrlMsgsFile << "SR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::BSR)
-    {
-      m_rxedGnbPhyCtrlMsgsFile << "BSR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::RACH_PREAMBLE)
-    {
-      m_rxedGnbPhyCtrlMsgsFile << "RACH_PREAMBLE";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_HARQ)
+  if (!m_rxedGnbPhyCtrlMsgsFile)
     {
-      m_rxedGnbPhyCtrlMsgsFile << "DL_HARQ";
+      m_rxedGnbPhyCtrlMsgsFile = phyStats->OpenSink ("RxedGnbPhyCtrlMsgsTrace" + m_simTag + ".txt",
+                                                     "Time\tEntity\tFrame\tSF\tSlot\tnodeId\tRNTI\tbwpId\tMsgType");
     }
-  else if (msg->GetMessageType () == NrControlMessage::SRS)
-    {
-      m_rxedGnbPhyCtrlMsgsFile << "SRS";
-    }
-  else
-    {
-      m_rxedGnbPhyCtrlMsgsFile << "Other";
-    }
-  m_rxedGnbPhyCtrlMsgsFile << std::endl;
+
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::DL_CQI, "DL_CQI"},
+                                               {NrControlMessage::SR, "SR"},
+                                               {NrControlMessage::BSR, "BSR"},
+                                               {NrControlMessage::RACH_PREAMBLE, "RACH_PREAMBLE"},
+                                               {NrControlMessage::DL_HARQ, "DL_HARQ"},
+                                               {NrControlMessage::SRS, "SRS"}});
+
+  m_rxedGnbPhyCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                   "ENB PHY Rxed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                   nodeId, rnti, bwpId, msgType);
 }
 
 void
@@ -294,56 +346,21 @@ NrPhyRxTrace::TxedGnbPhyCtrlMsgsCallback (Ptr<NrPhyRxTrace> phyStats, std::strin
                                               SfnSf sfn, uint16_t nodeId, uint16_t rnti,
                                               uint8_t bwpId, Ptr<const NrControlMessage> msg)
 {
-  if (!m_txedGnbPhyCtrlMsgsFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "TxedGnbPhyCtrlMsgsTrace" << m_simTag.c_str () << ".txt";
-        m_txedGnbPhyCtrlMsgsFileName = oss.str ();
-        m_txedGnbPhyCtrlMsgsFile.open (m_txedGnbPhyCtrlMsgsFileName.c_str ());
-
-        m_txedGnbPhyCtrlMsgsFile << "Time" << "\t" << "Entity" << "\t" <<
-                                    "Frame" << "\t" << "SF" << "\t" << "Slot" <<
-                                    "\t" << "nodeId" << "\t" << "RNTI"<<
-                                    "\t" << "bwpId" << "\t" << "MsgType" << std::endl;
-
-        if (!m_txedGnbPhyCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_txedGnbPhyCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                              "\t" << "ENB PHY Txed" << "\t" << sfn.GetFrame () <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                              "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                              "\t" << nodeId << "\t" << rnti <<
-                              "\t" << static_cast<uint32_t> (bwpId) << "\t";
-
-  if (msg->GetMessageType () == NrControlMessage::MIB)
-    {
-      m_txedGnbPhyCtrlMsgsFile << "MIB";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::SIB1)
-    {
-      m_txedGnbPhyCtrlMsgsFile << "SIB1";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::RAR)
-    {
-      m_txedGnbPhyCtrlMsgsFile << "RAR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_DCI)
-    {
-      m_txedGnbPhyCtrlMsgsFile << "DL_DCI";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::UL_DCI)
-    {
-      m_txedGnbPhyCtrlMsgsFile << "UL_UCI";
-    }
-  else
+  if (!m_txedGnbPhyCtrlMsgsFile)
     {
-      m_txedGnbPhyCtrlMsgsFile << "Other";
+      m_txedGnbPhyCtrlMsgsFile = phyStats->OpenSink ("TxedGnbPhyCtrlMsgsTrace" + m_simTag + ".txt",
+                                                     "Time\tEntity\tFrame\tSF\tSlot\tnodeId\tRNTI\tbwpId\tMsgType");
     }
-  m_txedGnbPhyCtrlMsgsFile << std::endl;
+
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::MIB, "MIB"},
+                                               {NrControlMessage::SIB1, "SIB1"},
+                                               {NrControlMessage::RAR, "RAR"},
+                                               {NrControlMessage::DL_DCI, "DL_DCI"},
+                                               {NrControlMessage::UL_DCI, "UL_UCI"}});
+
+  m_txedGnbPhyCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                   "ENB PHY Txed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                   nodeId, rnti, bwpId, msgType);
 }
 
 void
@@ -351,56 +368,21 @@ NrPhyRxTrace::RxedUePhyCtrlMsgsCallback (Ptr<NrPhyRxTrace> phyStats, std::string
                                              SfnSf sfn, uint16_t nodeId, uint16_t rnti,
                                              uint8_t bwpId, Ptr<const NrControlMessage> msg)
 {
-  if (!m_rxedUePhyCtrlMsgsFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "RxedUePhyCtrlMsgsTrace" << m_simTag.c_str () << ".txt";
-        m_rxedUePhyCtrlMsgsFileName = oss.str ();
-        m_rxedUePhyCtrlMsgsFile.open (m_rxedUePhyCtrlMsgsFileName.c_str ());
-
-        m_rxedUePhyCtrlMsgsFile << "Time" << "\t" << "Entity" << "\t" <<
-                                   "Frame" << "\t" << "SF" << "\t" << "Slot" <<
-                                   "\t" << "nodeId" << "\t" << "RNTI" <<
-                                   "\t" << "bwpId" << "\t" << "MsgType" << std::endl;
-
-        if (!m_rxedUePhyCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_rxedUePhyCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                             "\t" << "UE  PHY Rxed" << "\t" << sfn.GetFrame ()<<
-                             "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                             "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                             "\t" << nodeId << "\t" << rnti <<
-                             "\t" << static_cast<uint32_t> (bwpId) << "\t";
-
-  if (msg->GetMessageType () == NrControlMessage::UL_DCI)
-    {
-      m_rxedUePhyCtrlMsgsFile << "UL_DCI";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_DCI)
-    {
-      m_rxedUePhyCtrlMsgsFile << "DL_DCI";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::MIB)
-    {
-      m_rxedUePhyCtrlMsgsFile << "MIB";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::SIB1)
+  if (!m_rxedUePhyCtrlMsgsFile)
     {
-      m_rxedUePhyCtrlMsgsFile << "SIB1";
+      m_rxedUePhyCtrlMsgsFile = phyStats->OpenSink ("RxedUePhyCtrlMsgsTrace" + m_simTag + ".txt",
+                                                    "Time\tEntity\tFrame\tSF\tSlot\tnodeId\tRNTI\tbwpId\tMsgType");
     }
-  else if (msg->GetMessageType () == NrControlMessage::RAR)
-    {
-      m_rxedUePhyCtrlMsgsFile << "RAR";
-    }
-  else
-    {
-      m_rxedUePhyCtrlMsgsFile << "Other";
-    }
-  m_rxedUePhyCtrlMsgsFile << std::endl;
+
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::UL_DCI, "UL_DCI"},
+                                               {NrControlMessage::DL_DCI, "DL_DCI"},
+                                               {NrControlMessage::MIB, "MIB"},
+                                               {NrControlMessage::SIB1, "SIB1"},
+                                               {NrControlMessage::RAR, "RAR"}});
+
+  m_rxedUePhyCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                  "UE  PHY Rxed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                  nodeId, rnti, bwpId, msgType);
 }
 
 void
@@ -408,61 +390,22 @@ NrPhyRxTrace::TxedUePhyCtrlMsgsCallback (Ptr<NrPhyRxTrace> phyStats, std::string
                                              SfnSf sfn, uint16_t nodeId, uint16_t rnti,
                                              uint8_t bwpId, Ptr<const NrControlMessage> msg)
 {
-  if (!m_txedUePhyCtrlMsgsFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "TxedUePhyCtrlMsgsTrace" << m_simTag.c_str () << ".txt";
-        m_txedUePhyCtrlMsgsFileName = oss.str ();
-        m_txedUePhyCtrlMsgsFile.open (m_txedUePhyCtrlMsgsFileName.c_str ());
-
-        m_txedUePhyCtrlMsgsFile << "Time" << "\t" << "Entity" << "\t" <<
-                                   "Frame" << "\t" << "SF" << "\t" << "Slot" <<
-                                   "\t" << "nodeId" <<
-                                   "\t" << "RNTI" << "\t" << "bwpId" <<
-                                   "\t" << "MsgType" << std::endl;
-
-        if (!m_txedUePhyCtrlMsgsFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_txedUePhyCtrlMsgsFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                             "\t" << "UE  PHY Txed" << "\t" << sfn.GetFrame () <<
-                             "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                             "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                             "\t" << nodeId << "\t" << rnti <<
-                             "\t" << static_cast<uint32_t> (bwpId) << "\t";
-
-  if (msg->GetMessageType () == NrControlMessage::RACH_PREAMBLE)
-    {
-      m_txedUePhyCtrlMsgsFile << "RACH_PREAMBLE";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::SR)
-    {
-      m_txedUePhyCtrlMsgsFile << "SR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::BSR)
-    {
-      m_txedUePhyCtrlMsgsFile << "BSR";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_CQI)
-    {
-      m_txedUePhyCtrlMsgsFile << "DL_CQI";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::DL_HARQ)
-    {
-      m_txedUePhyCtrlMsgsFile << "DL_HARQ";
-    }
-  else if (msg->GetMessageType () == NrControlMessage::SRS)
+  if (!m_txedUePhyCtrlMsgsFile)
     {
-      m_txedUePhyCtrlMsgsFile << "SRS";
+      m_txedUePhyCtrlMsgsFile = phyStats->OpenSink ("TxedUePhyCtrlMsgsTrace" + m_simTag + ".txt",
+                                                    "Time\tEntity\tFrame\tSF\tSlot\tnodeId\tRNTI\tbwpId\tMsgType");
     }
-  else
-    {
-      m_txedUePhyCtrlMsgsFile << "Other";
-    }
-  m_txedUePhyCtrlMsgsFile << std::endl;
+
+  const char *msgType = CtrlMsgTypeName (msg, {{NrControlMessage::RACH_PREAMBLE, "RACH_PREAMBLE"},
+                                               {NrControlMessage::SR, "SR"},
+                                               {NrControlMessage::BSR, "BSR"},
+                                               {NrControlMessage::DL_CQI, "DL_CQI"},
+                                               {NrControlMessage::DL_HARQ, "DL_HARQ"},
+                                               {NrControlMessage::SRS, "SRS"}});
+
+  m_txedUePhyCtrlMsgsFile->Write (g_ctrlMsgsLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                                  "UE  PHY Txed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                                  nodeId, rnti, bwpId, msgType);
 }
 
 void
@@ -470,32 +413,15 @@ NrPhyRxTrace::RxedUePhyDlDciCallback (Ptr<NrPhyRxTrace> phyStats, std::string pa
                                           SfnSf sfn, uint16_t nodeId, uint16_t rnti,
                                           uint8_t bwpId, uint8_t harqId, uint32_t k1Delay)
 {
-  if (!m_rxedUePhyDlDciFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "RxedUePhyDlDciTrace" << m_simTag.c_str () << ".txt";
-        m_rxedUePhyDlDciFileName = oss.str ();
-        m_rxedUePhyDlDciFile.open (m_rxedUePhyDlDciFileName.c_str ());
-
-        m_rxedUePhyDlDciFile << "Time" << "\t" << "Entity"  << "\t" << "Frame" <<
-                                "\t" << "SF" << "\t" << "Slot" << "\t" <<
-                                "nodeId" << "\t" << "RNTI" << "\t" << "bwpId" <<
-                                "\t" << "Harq ID" << "\t" << "K1 Delay" << std::endl;
-
-        if (!m_rxedUePhyDlDciFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_rxedUePhyDlDciFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                          "\t" << "DL DCI Rxed" << "\t" << sfn.GetFrame () <<
-                          "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                          "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                          "\t" << nodeId << "\t" << rnti << "\t" <<
-                          static_cast<uint32_t> (bwpId) << "\t" <<
-                          static_cast<uint32_t> (harqId) << "\t" <<
-                          k1Delay << std::endl;
+  if (!m_rxedUePhyDlDciFile)
+    {
+      m_rxedUePhyDlDciFile = phyStats->OpenSink ("RxedUePhyDlDciTrace" + m_simTag + ".txt",
+                                                 "Time\tEntity\tFrame\tSF\tSlot\tnodeId\tRNTI\tbwpId\tHarq ID\tK1 Delay");
+    }
+
+  m_rxedUePhyDlDciFile->Write (g_dlDciLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                               "DL DCI Rxed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                               nodeId, rnti, bwpId, harqId, k1Delay);
 }
 
 void
@@ -503,32 +429,15 @@ NrPhyRxTrace::TxedUePhyHarqFeedbackCallback (Ptr<NrPhyRxTrace> phyStats, std::st
                                              SfnSf sfn, uint16_t nodeId, uint16_t rnti,
                                              uint8_t bwpId, uint8_t harqId, uint32_t k1Delay)
 {
-  if (!m_rxedUePhyDlDciFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "RxedUePhyDlDciTrace" << m_simTag.c_str () << ".txt";
-        m_rxedUePhyDlDciFileName = oss.str ();
-        m_rxedUePhyDlDciFile.open (m_rxedUePhyDlDciFileName.c_str ());
-
-        m_rxedUePhyDlDciFile << "Time" << "\t" << "Entity"  << "\t" << "Frame" <<
-                                "\t" << "SF" << "\t" << "Slot" << "\t" <<
-                                "nodeId" << "\t" << "RNTI" << "\t" << "bwpId" <<
-                                "\t" << "Harq ID" << "\t" << "K1 Delay" << std::endl;
-
-        if (!m_rxedUePhyDlDciFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open tracefile");
-          }
-      }
-
-  m_rxedUePhyDlDciFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                          "\t" << "HARQ FD Txed" << "\t" << sfn.GetFrame () <<
-                          "\t" << static_cast<uint32_t> (sfn.GetSubframe ()) <<
-                          "\t" << static_cast<uint32_t> (sfn.GetSlot ()) <<
-                          "\t" << nodeId << "\t" << rnti << "\t" <<
-                          static_cast<uint32_t> (bwpId) << "\t" <<
-                          static_cast<uint32_t> (harqId) << "\t" <<
-                          k1Delay << std::endl;
+  if (!m_rxedUePhyDlDciFile)
+    {
+      m_rxedUePhyDlDciFile = phyStats->OpenSink ("RxedUePhyDlDciTrace" + m_simTag + ".txt",
+                                                 "Time\tEntity\tFrame\tSF\tSlot\tnodeId\tRNTI\tbwpId\tHarq ID\tK1 Delay");
+    }
+
+  m_rxedUePhyDlDciFile->Write (g_dlDciLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                               "HARQ FD Txed", sfn.GetFrame (), sfn.GetSubframe (), sfn.GetSlot (),
+                               nodeId, rnti, bwpId, harqId, k1Delay);
 }
 
 void
@@ -536,20 +445,14 @@ NrPhyRxTrace::ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr)
 {
   uint64_t tti_count = Now ().GetMicroSeconds () / 125;
   uint32_t rb_count = 1;
-  FILE* log_file;
-  char fname[255];
-  sprintf (fname, "UE_%llu_SINR_dB.txt", (long long unsigned ) imsi);
-  log_file = fopen (fname, "a");
+  const Ptr<NrTraceSink> &file = GetIdSink (m_interferenceFiles, imsi, "UE_%llu_SINR_dB.txt");
   Values::iterator it = sinr.ValuesBegin ();
   while (it != sinr.ValuesEnd ())
     {
-      //fprintf(log_file, "%d\t%d\t%f\t \n", tti_count/2, rb_count, 10*log10(*it));
-      fprintf (log_file, "%llu\t%llu\t%d\t%f\t \n",(long long unsigned) tti_count / 8 + 1, (long long unsigned) tti_count % 8 + 1, rb_count, 10 * log10 (*it));
+      file->Write (g_perRbLayout, tti_count / 8 + 1, tti_count % 8 + 1, rb_count, 10 * log10 (*it));
       rb_count++;
       it++;
     }
-  fflush (log_file);
-  fclose (log_file);
 }
 
 void
@@ -558,19 +461,14 @@ NrPhyRxTrace::ReportPowerTrace (uint64_t imsi, SpectrumValue& power)
 
   uint32_t tti_count = Now ().GetMicroSeconds () / 125;
   uint32_t rb_count = 1;
-  FILE* log_file;
-  char fname[255];
-  printf (fname, "UE_%llu_ReceivedPower_dB.txt", (long long unsigned) imsi);
-  log_file = fopen (fname, "a");
+  const Ptr<NrTraceSink> &file = GetIdSink (m_powerFiles, imsi, "UE_%llu_ReceivedPower_dB.txt");
   Values::iterator it = power.ValuesBegin ();
   while (it != power.ValuesEnd ())
     {
-      fprintf (log_file, "%llu\t%llu\t%d\t%f\t \n",(long long unsigned) tti_count / 8 + 1,(long long unsigned) tti_count % 8 + 1, rb_count, 10 * log10 (*it));
+      file->Write (g_perRbLayout, tti_count / 8 + 1, tti_count % 8 + 1, rb_count, 10 * log10 (*it));
       rb_count++;
       it++;
     }
-  fflush (log_file);
-  fclose (log_file);
 }
 
 void
@@ -598,101 +496,55 @@ NrPhyRxTrace::ReportDownLinkTBSize (Ptr<NrPhyRxTrace> phyStats, std::string path
 void
 NrPhyRxTrace::ReportPacketCountUe (UePhyPacketCountParameter param)
 {
-  FILE* log_file;
-  char fname[255];
-  sprintf (fname,"UE_%llu_Packet_Trace.txt", (long long unsigned) param.m_imsi);
-  log_file = fopen (fname, "a");
+  const Ptr<NrTraceSink> &file = GetIdSink (m_uePacketCountFiles, param.m_imsi, "UE_%llu_Packet_Trace.txt");
   if (param.m_isTx)
     {
-      fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, param.m_noBytes, 0);
+      file->Write (g_packetCountLayout, param.m_subframeno, param.m_noBytes, 0);
     }
   else
     {
-      fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, 0, param.m_noBytes);
+      file->Write (g_packetCountLayout, param.m_subframeno, 0, param.m_noBytes);
     }
-
-  fflush (log_file);
-  fclose (log_file);
-
 }
 
 void
 NrPhyRxTrace::ReportPacketCountEnb (GnbPhyPacketCountParameter param)
 {
-  FILE* log_file;
-  char fname[255];
-  sprintf (fname,"BS_%llu_Packet_Trace.txt",(long long unsigned) param.m_cellId);
-  log_file = fopen (fname, "a");
+  const Ptr<NrTraceSink> &file = GetIdSink (m_gnbPacketCountFiles, param.m_cellId, "BS_%llu_Packet_Trace.txt");
   if (param.m_isTx)
     {
-      fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, param.m_noBytes, 0);
+      file->Write (g_packetCountLayout, param.m_subframeno, param.m_noBytes, 0);
     }
   else
     {
-      fprintf (log_file, "%d\t%d\t%d\n", param.m_subframeno, 0, param.m_noBytes);
+      file->Write (g_packetCountLayout, param.m_subframeno, 0, param.m_noBytes);
     }
-
-  fflush (log_file);
-  fclose (log_file);
 }
 
 void
 NrPhyRxTrace::ReportDLTbSize (uint64_t imsi, uint64_t tbSize)
 {
-  FILE* log_file;
-  char fname[255];
-  sprintf (fname,"UE_%llu_Tb_Size.txt", (long long unsigned) imsi);
-  log_file = fopen (fname, "a");
-
-  fprintf (log_file, "%llu \t %llu\n", (long long unsigned )Now ().GetMicroSeconds (), (long long unsigned )tbSize);
-  fprintf (log_file, "%lld \t %llu \n",(long long int) Now ().GetMicroSeconds (), (long long unsigned) tbSize);
-  fflush (log_file);
-  fclose (log_file);
+  const Ptr<NrTraceSink> &file = GetIdSink (m_tbSizeFiles, imsi, "UE_%llu_Tb_Size.txt");
+  file->Write (g_tbSizeLayout, Now ().GetMicroSeconds (), tbSize);
 }
 
 void
 NrPhyRxTrace::RxPacketTraceUeCallback (Ptr<NrPhyRxTrace> phyStats, std::string path, RxPacketTraceParams params)
 {
-  if (!m_rxPacketTraceFile.is_open ())
+  if (!m_rxPacketTraceFile)
     {
-      std::ostringstream oss;
-      oss << "RxPacketTrace" << m_simTag.c_str() << ".txt";
-      m_rxPacketTraceFilename = oss.str ();
-      m_rxPacketTraceFile.open (m_rxPacketTraceFilename.c_str ());
-
-      m_rxPacketTraceFile << "Time" << "\t" << "direction" << "\t" <<
-                             "frame" << "\t" << "subF" << "\t" << "slot" <<
-                             "\t" << "1stSym" << "\t" << "nSymbol" <<
-                             "\t" << "cellId" << "\t" << "bwpId" <<
-                             "\t" << "streamId" << "\t" << "rnti" <<
-                             "\t" << "tbSize" << "\t" << "mcs" <<
-                             "\t" << "rv" << "\t" << "SINR(dB)" << "\t" << "CQI" <<
-                             "\t" << "corrupt" << "\t" << "TBler" << std::endl;
-
-      if (!m_rxPacketTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
+      m_rxPacketTraceFile = phyStats->OpenSink ("RxPacketTrace" + m_simTag + ".txt",
+                                                "Time\tdirection\tframe\tsubF\tslot\t1stSym\tnSymbol\t"
+                                                "cellId\tbwpId\tstreamId\trnti\ttbSize\tmcs\trv\t"
+                                                "SINR(dB)\tCQI\tcorrupt\tTBler");
     }
 
-  m_rxPacketTraceFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                         "\t" << "DL" <<
-                         "\t" << params.m_frameNum <<
-                         "\t" << (unsigned)params.m_subframeNum <<
-                         "\t" << (unsigned)params.m_slotNum <<
-                         "\t" << (unsigned)params.m_symStart <<
-                         "\t" << (unsigned)params.m_numSym <<
-                         "\t" << params.m_cellId <<
-                         "\t" << (unsigned)params.m_bwpId <<
-                         "\t" << static_cast<uint16_t> (params.m_streamId) <<
-                         "\t" << params.m_rnti <<
-                         "\t" << params.m_tbSize <<
-                         "\t" << (unsigned)params.m_mcs <<
-                         "\t" << (unsigned)params.m_rv <<
-                         "\t" << 10 * log10 (params.m_sinr) <<
-                         "\t" << (unsigned)params.m_cqi <<
-                         "\t" << params.m_corrupt <<
-                         "\t" << params.m_tbler << std::endl;
+  m_rxPacketTraceFile->Write (g_rxPacketDlLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                              "DL", params.m_frameNum, params.m_subframeNum, params.m_slotNum,
+                              params.m_symStart, params.m_numSym, params.m_cellId, params.m_bwpId,
+                              params.m_streamId, params.m_rnti, params.m_tbSize, params.m_mcs,
+                              params.m_rv, 10 * log10 (params.m_sinr), params.m_cqi,
+                              params.m_corrupt, params.m_tbler);
 
   if (params.m_corrupt)
     {
@@ -715,44 +567,20 @@ NrPhyRxTrace::RxPacketTraceUeCallback (Ptr<NrPhyRxTrace> phyStats, std::string p
 void
 NrPhyRxTrace::RxPacketTraceEnbCallback (Ptr<NrPhyRxTrace> phyStats, std::string path, RxPacketTraceParams params)
 {
-  if (!m_rxPacketTraceFile.is_open ())
+  if (!m_rxPacketTraceFile)
     {
-      std::ostringstream oss;
-      oss << "RxPacketTrace" << m_simTag.c_str () << ".txt";
-      m_rxPacketTraceFilename = oss.str ();
-      m_rxPacketTraceFile.open (m_rxPacketTraceFilename.c_str ());
-
-      m_rxPacketTraceFile << "Time" << "\t" << "direction" << "\t" <<
-                             "frame" << "\t" << "subF" << "\t" << "slot" <<
-                             "\t" << "1stSym" << "\t" << "nSymbol" <<
-                             "\t" << "cellId" << "\t" << "bwpId" <<
-                             "\t" << "streamId" << "\t" << "rnti" <<
-                             "\t" << "tbSize" << "\t" << "mcs" <<
-                             "\t" << "rv" << "\t" << "SINR(dB)" <<
-                             "\t" << "corrupt" << "\t" << "TBler" << std::endl;
-
-      if (!m_rxPacketTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
+      m_rxPacketTraceFile = phyStats->OpenSink ("RxPacketTrace" + m_simTag + ".txt",
+                                                "Time\tdirection\tframe\tsubF\tslot\t1stSym\tnSymbol\t"
+                                                "cellId\tbwpId\tstreamId\trnti\ttbSize\tmcs\trv\t"
+                                                "SINR(dB)\tcorrupt\tTBler");
     }
-  m_rxPacketTraceFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 <<
-                         "\t" << "UL" <<
-                         "\t" << params.m_frameNum <<
-                         "\t" << (unsigned)params.m_subframeNum <<
-                         "\t" << (unsigned)params.m_slotNum <<
-                         "\t" << (unsigned)params.m_symStart <<
-                         "\t" << (unsigned)params.m_numSym <<
-                         "\t" << params.m_cellId <<
-                         "\t" << (unsigned)params.m_bwpId <<
-                         "\t" << static_cast<uint16_t> (params.m_streamId) <<
-                         "\t" << params.m_rnti <<
-                         "\t" << params.m_tbSize <<
-                         "\t" << (unsigned)params.m_mcs <<
-                         "\t" << (unsigned)params.m_rv <<
-                         "\t" << 10 * log10 (params.m_sinr) <<
-                         "\t" << params.m_corrupt <<
-                         "\t" << params.m_tbler << std::endl;
+
+  m_rxPacketTraceFile->Write (g_rxPacketUlLayout, Simulator::Now ().GetNanoSeconds () / (double) 1e9,
+                              "UL", params.m_frameNum, params.m_subframeNum, params.m_slotNum,
+                              params.m_symStart, params.m_numSym, params.m_cellId, params.m_bwpId,
+                              params.m_streamId, params.m_rnti, params.m_tbSize, params.m_mcs,
+                              params.m_rv, 10 * log10 (params.m_sinr),
+                              params.m_corrupt, params.m_tbler);
 
   if (params.m_corrupt)
     {
@@ -832,31 +660,19 @@ NrPhyRxTrace::WriteDlPathlossTrace (Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                                     Ptr<NrSpectrumPhy> rxNrSpectrumPhy,
                                     double lossDb)
 {
-  if (!m_dlPathlossFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "DlPathlossTrace" << m_simTag.c_str () << ".txt";
-        m_dlPathlossFileName = oss.str ();
-        m_dlPathlossFile.open (m_dlPathlossFileName.c_str ());
-
-        m_dlPathlossFile << "Time(sec)" << "\t" << "CellId" << "\t"
-                         << "BwpId" << "\t"  << "txStreamId "<< "\t"
-                         << "IMSI" << "\t" << "rxStreamId" << "\t"
-                         << "pathLoss(dB)" << std::endl;
-
-        if (!m_dlPathlossFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open DL pathloss tracefile");
-          }
-      }
-
-  m_dlPathlossFile << Simulator::Now ().GetSeconds () << "\t"
-                   << txNrSpectrumPhy->GetDevice ()->GetObject<NrGnbNetDevice> ()->GetCellId () << "\t"
-                   << txNrSpectrumPhy->GetBwpId () << "\t"
-                   << +txNrSpectrumPhy->GetStreamId () << "\t"
-                   << rxNrSpectrumPhy->GetDevice ()->GetObject<NrUeNetDevice> ()->GetImsi () << "\t"
-                   << +rxNrSpectrumPhy->GetStreamId () << "\t"
-                   << lossDb << std::endl;
+  if (!m_dlPathlossFile)
+    {
+      m_dlPathlossFile = OpenSink ("DlPathlossTrace" + m_simTag + ".txt",
+                                   "Time(sec)\tCellId\tBwpId\ttxStreamId \tIMSI\trxStreamId\tpathLoss(dB)");
+    }
+
+  m_dlPathlossFile->Write (g_pathlossLayout, Simulator::Now ().GetSeconds (),
+                           txNrSpectrumPhy->GetDevice ()->GetObject<NrGnbNetDevice> ()->GetCellId (),
+                           txNrSpectrumPhy->GetBwpId (),
+                           txNrSpectrumPhy->GetStreamId (),
+                           rxNrSpectrumPhy->GetDevice ()->GetObject<NrUeNetDevice> ()->GetImsi (),
+                           rxNrSpectrumPhy->GetStreamId (),
+                           lossDb);
 
 }
 
@@ -865,31 +681,19 @@ NrPhyRxTrace::WriteUlPathlossTrace (Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                                     Ptr<NrSpectrumPhy> rxNrSpectrumPhy,
                                     double lossDb)
 {
-  if (!m_ulPathlossFile.is_open ())
-      {
-        std::ostringstream oss;
-        oss << "UlPathlossTrace" << m_simTag.c_str () << ".txt";
-        m_ulPathlossFileName = oss.str ();
-        m_ulPathlossFile.open (m_ulPathlossFileName.c_str ());
-
-        m_ulPathlossFile << "Time(sec)" << "\t" << "CellId" << "\t"
-                         << "BwpId" << "\t"  << "txStreamId "<< "\t"
-                         << "IMSI" << "\t" << "rxStreamId" << "\t"
-                         << "pathLoss(dB)" << std::endl;
-
-        if (!m_ulPathlossFile.is_open ())
-          {
-            NS_FATAL_ERROR ("Could not open UL pathloss tracefile");
-          }
-      }
-
-  m_ulPathlossFile << Simulator::Now ().GetSeconds () << "\t"
-                   << txNrSpectrumPhy->GetDevice ()->GetObject<NrUeNetDevice> ()->GetCellId () << "\t"
-                   << txNrSpectrumPhy->GetBwpId () << "\t"
-                   << +txNrSpectrumPhy->GetStreamId () << "\t"
-                   << txNrSpectrumPhy->GetDevice ()->GetObject<NrUeNetDevice> ()->GetImsi () << "\t"
-                   << +rxNrSpectrumPhy->GetStreamId () << "\t"
-                   << lossDb << std::endl;
+  if (!m_ulPathlossFile)
+    {
+      m_ulPathlossFile = OpenSink ("UlPathlossTrace" + m_simTag + ".txt",
+                                   "Time(sec)\tCellId\tBwpId\ttxStreamId \tIMSI\trxStreamId\tpathLoss(dB)");
+    }
+
+  m_ulPathlossFile->Write (g_pathlossLayout, Simulator::Now ().GetSeconds (),
+                           txNrSpectrumPhy->GetDevice ()->GetObject<NrUeNetDevice> ()->GetCellId (),
+                           txNrSpectrumPhy->GetBwpId (),
+                           txNrSpectrumPhy->GetStreamId (),
+                           txNrSpectrumPhy->GetDevice ()->GetObject<NrUeNetDevice> ()->GetImsi (),
+                           rxNrSpectrumPhy->GetStreamId (),
+                           lossDb);
 }
 
 } /* namespace ns3 */
@@ -35,8 +35,10 @@
 #include <ns3/nr-control-messages.h>
 #include <ns3/nr-spectrum-phy.h>
 #include <ns3/spectrum-phy.h>
-#include <fstream>
+#include <ns3/nr-trace-sink.h>
 #include <iostream>
+#include <deque>
+#include <map>
 
 namespace ns3 {
 
@@ -54,6 +56,15 @@ public:
    */
   void SetSimTag (const std::string &simTag);
 
+  /**
+   * \brief Set the format of the trace files opened from now on
+   * \param format the format
+   * \param bufferSize the size, in bytes, of the buffer of each BUFFERED_TEXT
+   * or BINARY file. The per-UE and per-cell files use at most
+   * ID_SINK_BUFFER_SIZE bytes.
+   */
+  void SetTraceFormat (NrTraceSink::Format format, uint32_t bufferSize);
+
   /**
    * \brief Trace sink for DL Average SINR of DATA (in dB).
    * \param [in] phyStats NrPhyRxTrace object
@@ -197,6 +208,25 @@ public:
                                      double lossDb);
 
 private:
+  /**
+   * \brief Open a trace file, in the format of this object
+   * \param fileName the file name
+   * \param header the header of the file
+   * \return the sink
+   */
+  Ptr<NrTraceSink> OpenSink (const std::string &fileName, const std::string &header) const;
+  /**
+   * \brief Get the sink of a per-UE (or per-cell) trace, opening it the first
+   * time. These traces are appended to the existing files, without header.
+   * At most MAX_OPEN_ID_SINKS of these files are kept open.
+   * \param files the open sinks, indexed by id
+   * \param id the IMSI or cell ID
+   * \param fileNameFormat the printf format of the file name, with the id
+   * \return the sink
+   */
+  const Ptr<NrTraceSink> & GetIdSink (std::map<uint64_t, Ptr<NrTraceSink>> &files, uint64_t id,
+                                      const char *fileNameFormat) const;
+
   void ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr);
   void ReportPowerTrace (uint64_t imsi, SpectrumValue& power);
   void ReportPacketCountUe (UePhyPacketCountParameter param);
@@ -226,30 +256,33 @@ private:
 
   static std::string m_simTag;   //!< The `SimTag` attribute.
 
-  static std::ofstream m_dlDataSinrFile;
-  static std::string m_dlDataSinrFileName;
+  static constexpr uint32_t ID_SINK_BUFFER_SIZE = 8192; //!< Maximum buffer size of a per-UE (or per-cell) file
+  static constexpr std::size_t MAX_OPEN_ID_SINKS = 64;  //!< Maximum number of per-UE (or per-cell) files open
+
+  NrTraceSink::Format m_format {NrTraceSink::FLUSHED_TEXT}; //!< Format of the files
+  uint32_t m_bufferSize {1 << 20};                          //!< Buffer size of the files
 
-  static std::ofstream m_dlCtrlSinrFile;
-  static std::string m_dlCtrlSinrFileName;
+  static Ptr<NrTraceSink> m_dlDataSinrFile;         //!< DL DATA SINR trace
+  static Ptr<NrTraceSink> m_dlCtrlSinrFile;         //!< DL CTRL SINR trace
+  static Ptr<NrTraceSink> m_rxPacketTraceFile;      //!< DL and UL RxPacketTrace
 
-  static std::ofstream m_rxPacketTraceFile;
-  static std::string m_rxPacketTraceFilename;
+  static Ptr<NrTraceSink> m_rxedGnbPhyCtrlMsgsFile; //!< Control messages received by the gNB PHY
+  static Ptr<NrTraceSink> m_txedGnbPhyCtrlMsgsFile; //!< Control messages transmitted by the gNB PHY
 
-  static std::ofstream m_rxedGnbPhyCtrlMsgsFile;
-  static std::string m_rxedGnbPhyCtrlMsgsFileName;
-  static std::ofstream m_txedGnbPhyCtrlMsgsFile;
-  static std::string m_txedGnbPhyCtrlMsgsFileName;
+  static Ptr<NrTraceSink> m_rxedUePhyCtrlMsgsFile;  //!< Control messages received by the UE PHY
+  static Ptr<NrTraceSink> m_txedUePhyCtrlMsgsFile;  //!< Control messages transmitted by the UE PHY
+  static Ptr<NrTraceSink> m_rxedUePhyDlDciFile;     //!< DL DCIs received and HARQ feedback transmitted by the UE PHY
+  static Ptr<NrTraceSink> m_dlPathlossFile;         //!< DL pathloss trace
+  static Ptr<NrTraceSink> m_ulPathlossFile;         //!< UL pathloss trace
 
-  static std::ofstream m_rxedUePhyCtrlMsgsFile;
-  static std::string m_rxedUePhyCtrlMsgsFileName;
-  static std::ofstream m_txedUePhyCtrlMsgsFile;
-  static std::string m_txedUePhyCtrlMsgsFileName;
-  static std::ofstream m_rxedUePhyDlDciFile;
-  static std::string m_rxedUePhyDlDciFileName;
-  static std::ofstream m_dlPathlossFile;
-  static std::string m_dlPathlossFileName;
-  static std::ofstream m_ulPathlossFile;
-  static std::string m_ulPathlossFileName;
+  static std::map<uint64_t, Ptr<NrTraceSink>> m_ulSinrFiles;         //!< UL SINR traces, per IMSI
+  static std::map<uint64_t, Ptr<NrTraceSink>> m_interferenceFiles;   //!< SINR traces, per IMSI
+  static std::map<uint64_t, Ptr<NrTraceSink>> m_powerFiles;          //!< Received power traces, per IMSI
+  static std::map<uint64_t, Ptr<NrTraceSink>> m_uePacketCountFiles;  //!< Packet count traces, per IMSI
+  static std::map<uint64_t, Ptr<NrTraceSink>> m_gnbPacketCountFiles; //!< Packet count traces, per cell ID
+  static std::map<uint64_t, Ptr<NrTraceSink>> m_tbSizeFiles;         //!< DL TB size traces, per IMSI
+  /// Per-UE (and per-cell) sinks open, from the oldest
+  static std::deque<std::pair<std::map<uint64_t, Ptr<NrTraceSink>> *, uint64_t>> m_openIdSinks;
 };
 
 } /* namespace ns3 */
@@ -0,0 +1,475 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-trace-sink.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrTraceSink");
+
+/*
+ * Binary file:
+ *
+ *   magic (8 bytes) | header length (uint32) | header
+ *
+ * followed by blocks, each one starting with a tag:
+ *
+ *   'L' | id (uint8) | number of fields (uint8) |
+ *       for each field: type (uint8) | name length (uint8) | name |
+ *       separator length (uint8) | separator | terminator length (uint8) | terminator
+ *   'R' | id (uint8) | fields (8 bytes each; strings: length (uint16) | characters)
+ *
+ * A layout definition always precedes the first record that uses it.
+ */
+static const char BINARY_MAGIC[8] = {'N', 'R', 'T', 'R', 'A', 'C', 'E', '2'}; //!< Binary file magic
+
+/**
+ * \brief Append the bytes of a value to a buffer
+ * \param buf the buffer
+ * \param v the value
+ */
+template <typename T>
+static void
+AppendBytes (std::vector<char> &buf, const T &v)
+{
+  const char *p = reinterpret_cast<const char *> (&v);
+  buf.insert (buf.end (), p, p + sizeof (T));
+}
+
+/**
+ * \brief Append a short string, preceded by its length, to a buffer
+ * \param buf the buffer
+ * \param s the string
+ */
+static void
+AppendShortString (std::vector<char> &buf, const std::string &s)
+{
+  NS_ABORT_MSG_IF (s.size () > UINT8_MAX, "String too long for a binary trace: " << s);
+  buf.push_back (static_cast<char> (s.size ()));
+  buf.insert (buf.end (), s.begin (), s.end ());
+}
+
+Ptr<NrTraceSink>
+NrTraceSink::Open (const std::string &fileName, const std::string &header,
+                   Format format, uint32_t bufferSize, bool append)
+{
+  return Ptr<NrTraceSink> (new NrTraceSink (fileName, header, format, bufferSize, append), false);
+}
+
+NrTraceSink::NrTraceSink (const std::string &fileName, const std::string &header,
+                          Format format, uint32_t bufferSize, bool append)
+  : m_fileName (fileName),
+    m_format (format)
+{
+  NS_LOG_FUNCTION (this << fileName << format << bufferSize << append);
+
+  std::ios_base::openmode mode = std::ios_base::out;
+  if (m_format == BINARY)
+    {
+      const std::string txt = ".txt";
+      if (m_fileName.size () >= txt.size ()
+          && m_fileName.compare (m_fileName.size () - txt.size (), txt.size (), txt) == 0)
+        {
+          m_fileName.erase (m_fileName.size () - txt.size ());
+        }
+      m_fileName += ".bin";
+      mode |= std::ios_base::binary;
+    }
+  if (append)
+    {
+      mode |= std::ios_base::app | std::ios_base::ate;
+    }
+
+  if (m_format != FLUSHED_TEXT && bufferSize > 0)
+    {
+      // the buffer must be installed before opening the file
+      m_buffer.resize (bufferSize);
+      m_file.rdbuf ()->pubsetbuf (m_buffer.data (), static_cast<std::streamsize> (m_buffer.size ()));
+    }
+  m_file.open (m_fileName.c_str (), mode);
+  if (!m_file.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open tracefile " << m_fileName);
+    }
+
+  // when appending, the header is already in the file, unless it is empty
+  if (append && m_file.tellp () > 0)
+    {
+      return;
+    }
+
+  if (m_format == BINARY)
+    {
+      std::vector<char> start (BINARY_MAGIC, BINARY_MAGIC + sizeof (BINARY_MAGIC));
+      AppendBytes (start, static_cast<uint32_t> (header.size ()));
+      start.insert (start.end (), header.begin (), header.end ());
+      m_file.write (start.data (), static_cast<std::streamsize> (start.size ()));
+    }
+  else if (!header.empty ())
+    {
+      m_file << header << std::endl;
+    }
+}
+
+NrTraceSink::~NrTraceSink ()
+{
+  NS_LOG_FUNCTION (this);
+  // close here, while the buffer of the stream is still alive
+  m_file.close ();
+}
+
+const std::string &
+NrTraceSink::GetFileName () const
+{
+  return m_fileName;
+}
+
+void
+NrTraceSink::Flush ()
+{
+  m_file.flush ();
+}
+
+uint8_t
+NrTraceSink::GetLayoutId (const Layout &layout)
+{
+  for (std::size_t i = 0; i < m_layouts.size (); ++i)
+    {
+      if (m_layouts[i] == &layout)
+        {
+          return static_cast<uint8_t> (i);
+        }
+    }
+
+  NS_ABORT_MSG_IF (m_layouts.size () > UINT8_MAX, "Too many layouts in " << m_fileName);
+  NS_ABORT_MSG_IF (layout.m_fields.size () > UINT8_MAX, "Too many fields in a layout of " << m_fileName);
+  uint8_t id = static_cast<uint8_t> (m_layouts.size ());
+  m_layouts.push_back (&layout);
+
+  std::vector<char> def;
+  def.push_back ('L');
+  def.push_back (static_cast<char> (id));
+  def.push_back (static_cast<char> (layout.m_fields.size ()));
+  for (const auto &field : layout.m_fields)
+    {
+      def.push_back (static_cast<char> (field.second));
+      AppendShortString (def, field.first);
+    }
+  AppendShortString (def, layout.m_separator);
+  AppendShortString (def, layout.m_terminator);
+  m_file.write (def.data (), static_cast<std::streamsize> (def.size ()));
+  return id;
+}
+
+void
+NrTraceSink::Pack (FieldType type, uint64_t v)
+{
+  switch (type)
+    {
+    case UINT:
+      AppendBytes (m_record, v);
+      break;
+    case INT:
+      AppendBytes (m_record, static_cast<int64_t> (v));
+      break;
+    case DOUBLE:
+    case FIXED:
+      AppendBytes (m_record, static_cast<double> (v));
+      break;
+    default:
+      NS_FATAL_ERROR ("Integer value in a string field of " << m_fileName);
+    }
+}
+
+void
+NrTraceSink::Pack (FieldType type, int64_t v)
+{
+  switch (type)
+    {
+    case UINT:
+      AppendBytes (m_record, static_cast<uint64_t> (v));
+      break;
+    case INT:
+      AppendBytes (m_record, v);
+      break;
+    case DOUBLE:
+    case FIXED:
+      AppendBytes (m_record, static_cast<double> (v));
+      break;
+    default:
+      NS_FATAL_ERROR ("Integer value in a string field of " << m_fileName);
+    }
+}
+
+void
+NrTraceSink::Pack (FieldType type, double v)
+{
+  switch (type)
+    {
+    case UINT:
+      AppendBytes (m_record, static_cast<uint64_t> (v));
+      break;
+    case INT:
+      AppendBytes (m_record, static_cast<int64_t> (v));
+      break;
+    case DOUBLE:
+    case FIXED:
+      AppendBytes (m_record, v);
+      break;
+    default:
+      NS_FATAL_ERROR ("Double value in a string field of " << m_fileName);
+    }
+}
+
+void
+NrTraceSink::Pack (FieldType type, const char *s, std::size_t len)
+{
+  NS_ABORT_MSG_IF (type != STRING, "String value in a numeric field of " << m_fileName);
+  NS_ABORT_MSG_IF (len > MAX_STRING_LENGTH, "String of " << len << " characters in " << m_fileName);
+  AppendBytes (m_record, static_cast<uint16_t> (len));
+  m_record.insert (m_record.end (), s, s + len);
+}
+
+void
+NrTraceSink::Print (FieldType type, uint64_t v)
+{
+  switch (type)
+    {
+    case UINT:
+      m_file << v;
+      break;
+    case INT:
+      m_file << static_cast<int64_t> (v);
+      break;
+    default:
+      Print (type, static_cast<double> (v));
+    }
+}
+
+void
+NrTraceSink::Print (FieldType type, int64_t v)
+{
+  switch (type)
+    {
+    case UINT:
+      m_file << static_cast<uint64_t> (v);
+      break;
+    case INT:
+      m_file << v;
+      break;
+    default:
+      Print (type, static_cast<double> (v));
+    }
+}
+
+void
+NrTraceSink::Print (FieldType type, double v)
+{
+  switch (type)
+    {
+    case UINT:
+      m_file << static_cast<uint64_t> (v);
+      break;
+    case INT:
+      m_file << static_cast<int64_t> (v);
+      break;
+    case DOUBLE:
+      m_file << v;
+      break;
+    case FIXED:
+      {
+        char buf[64];
+        int len = std::snprintf (buf, sizeof (buf), "%f", v);
+        m_file.write (buf, std::min<int> (len, sizeof (buf) - 1));
+        break;
+      }
+    default:
+      NS_FATAL_ERROR ("Double value in a string field of " << m_fileName);
+    }
+}
+
+void
+NrTraceSink::Print (FieldType type, const char *s, std::size_t len)
+{
+  NS_ABORT_MSG_IF (type != STRING, "String value in a numeric field of " << m_fileName);
+  m_file.write (s, static_cast<std::streamsize> (len));
+}
+
+/**
+ * \brief Read a value from a binary trace
+ * \param in the binary trace
+ * \param v the value
+ * \return false at the end of the input
+ */
+template <typename T>
+static bool
+ReadBytes (std::istream &in, T &v)
+{
+  return static_cast<bool> (in.read (reinterpret_cast<char *> (&v), sizeof (T)));
+}
+
+/**
+ * \brief Read a short string, preceded by its length, from a binary trace
+ * \param in the binary trace
+ * \param s the string
+ * \return false at the end of the input
+ */
+static bool
+ReadShortString (std::istream &in, std::string &s)
+{
+  uint8_t len;
+  if (!ReadBytes (in, len))
+    {
+      return false;
+    }
+  s.resize (len);
+  return len == 0 || static_cast<bool> (in.read (&s[0], len));
+}
+
+bool
+NrTraceSink::ConvertToText (std::istream &in, std::ostream &out)
+{
+  char magic[sizeof (BINARY_MAGIC)];
+  uint32_t headerLen;
+  if (!in.read (magic, sizeof (magic))
+      || std::memcmp (magic, BINARY_MAGIC, sizeof (magic)) != 0
+      || !ReadBytes (in, headerLen))
+    {
+      return false;
+    }
+  std::string header (headerLen, '\0');
+  if (headerLen > 0 && !in.read (&header[0], headerLen))
+    {
+      return false;
+    }
+  if (!header.empty ())
+    {
+      out << header << "\n";
+    }
+
+  std::map<uint8_t, Layout> layouts;
+  char tag;
+  while (in.get (tag))
+    {
+      uint8_t id;
+      if (!ReadBytes (in, id))
+        {
+          return false;
+        }
+
+      if (tag == 'L')
+        {
+          // a file written in append mode can redefine the ids
+          Layout &layout = layouts[id];
+          uint8_t numFields;
+          if (!ReadBytes (in, numFields))
+            {
+              return false;
+            }
+          layout.m_fields.resize (numFields);
+          for (auto &field : layout.m_fields)
+            {
+              uint8_t type;
+              if (!ReadBytes (in, type) || type > STRING || !ReadShortString (in, field.first))
+                {
+                  return false;
+                }
+              field.second = static_cast<FieldType> (type);
+            }
+          if (!ReadShortString (in, layout.m_separator) || !ReadShortString (in, layout.m_terminator))
+            {
+              return false;
+            }
+          continue;
+        }
+
+      auto it = layouts.find (id);
+      if (tag != 'R' || it == layouts.end ())
+        {
+          return false;
+        }
+      const Layout &layout = it->second;
+      for (std::size_t i = 0; i < layout.m_fields.size (); ++i)
+        {
+          if (i > 0)
+            {
+              out << layout.m_separator;
+            }
+          bool ok = true;
+          switch (layout.m_fields[i].second)
+            {
+            case UINT:
+              {
+                uint64_t v;
+                ok = ReadBytes (in, v);
+                out << v;
+                break;
+              }
+            case INT:
+              {
+                int64_t v;
+                ok = ReadBytes (in, v);
+                out << v;
+                break;
+              }
+            case DOUBLE:
+              {
+                double v;
+                ok = ReadBytes (in, v);
+                out << v;
+                break;
+              }
+            case FIXED:
+              {
+                double v;
+                ok = ReadBytes (in, v);
+                char buf[64];
+                std::snprintf (buf, sizeof (buf), "%f", v);
+                out << buf;
+                break;
+              }
+            case STRING:
+              {
+                uint16_t len;
+                std::string s;
+                ok = ReadBytes (in, len);
+                if (ok && len > 0)
+                  {
+                    s.resize (len);
+                    ok = static_cast<bool> (in.read (&s[0], len));
+                  }
+                out << s;
+                break;
+              }
+            }
+          if (!ok)
+            {
+              return false;
+            }
+        }
+      out << layout.m_terminator << "\n";
+    }
+  return true;
+}
+
+} // namespace ns3
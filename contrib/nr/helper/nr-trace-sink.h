@@ -0,0 +1,305 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef NR_TRACE_SINK_H
+#define NR_TRACE_SINK_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/assert.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup helper
+ * \brief Output file of a trace (e.g., RxPacketTrace.txt), in text or binary form
+ *
+ * A sink is a cached, open output file: the trace helpers (NrPhyRxTrace,
+ * NrMacRxTrace) open a sink the first time that a stream is written, keep it,
+ * and write every record through it. The sink is closed (and its buffer
+ * flushed) when its last reference is released.
+ *
+ * Each record is written following a Layout, that lists the name and the
+ * type of its fields, and how the fields are separated in the text output.
+ * The format and the buffer size of a sink are given when it is opened (the
+ * trace helpers take them from NrHelper::EnableTraces), and the format can be:
+ *
+ * - FLUSHED_TEXT: text, flushed at every record. This is the historical
+ * output of the trace helpers, and the default;
+ * - BUFFERED_TEXT: the same text, but written through a buffer that is
+ * flushed only when full and when the sink is closed;
+ * - BINARY: binary records, in a file with the same name and ".bin" in place
+ * of ".txt". Integers and doubles take 8 bytes, strings 2 bytes for their
+ * length followed by their characters. The file describes its own layouts,
+ * and ConvertToText (or the nr-trace-convert tool) produces from it the
+ * same text of the other formats.
+ *
+ * The binary records are written in the byte order of the host.
+ */
+class NrTraceSink : public SimpleRefCount<NrTraceSink>
+{
+public:
+  /**
+   * \brief Format of the sinks
+   */
+  enum Format
+  {
+    FLUSHED_TEXT,  //!< Text, flushed at every record
+    BUFFERED_TEXT, //!< Text, through a large buffer
+    BINARY         //!< Fixed-width binary records
+  };
+
+  /**
+   * \brief Type of a field of a record
+   */
+  enum FieldType : uint8_t
+  {
+    UINT,   //!< Unsigned integer
+    INT,    //!< Signed integer
+    DOUBLE, //!< Double, printed as with std::ostream (i.e., "%g")
+    FIXED,  //!< Double, printed in fixed notation with 6 decimals ("%f")
+    STRING  //!< String of at most MAX_STRING_LENGTH characters
+  };
+
+  /**
+   * \brief Maximum length of a STRING field
+   */
+  static constexpr std::size_t MAX_STRING_LENGTH = UINT16_MAX;
+
+  /**
+   * \brief Layout of a record
+   *
+   * Layouts are meant to be defined once, as constants, and reused for every
+   * record: a binary sink identifies a layout by its address.
+   */
+  struct Layout
+  {
+    std::vector<std::pair<std::string, FieldType>> m_fields; //!< Name and type of the fields
+    std::string m_separator {"\t"};                           //!< Text between two fields
+    std::string m_terminator;                                 //!< Text before the end of line
+  };
+
+  /**
+   * \brief Open a sink
+   *
+   * \param fileName the name of the text file (for a binary sink, ".txt" is
+   * replaced, or followed, by ".bin")
+   * \param header the first line of the file (without end of line), or an
+   * empty string for no header
+   * \param format the format of the file
+   * \param bufferSize the size, in bytes, of the buffer of a BUFFERED_TEXT
+   * or BINARY sink (0 for the default buffer of the file stream)
+   * \param append if true, the records are appended to an existing file,
+   * and the header is written only if the file is empty
+   * \return the sink
+   */
+  static Ptr<NrTraceSink> Open (const std::string &fileName, const std::string &header,
+                                Format format = FLUSHED_TEXT, uint32_t bufferSize = 0,
+                                bool append = false);
+
+  /**
+   * \brief Convert a binary trace to text
+   * \param in the binary trace
+   * \param out the output text
+   * \return false if the input is not a valid binary trace
+   */
+  static bool ConvertToText (std::istream &in, std::ostream &out);
+
+  /**
+   * \brief Destructor: flushes and closes the file
+   */
+  ~NrTraceSink ();
+
+  /**
+   * \return the name of the file written by the sink
+   */
+  const std::string & GetFileName () const;
+
+  /**
+   * \brief Write a record
+   *
+   * The number of values must be the number of fields of the layout.
+   * Integral values can be written into UINT, INT, DOUBLE or FIXED fields,
+   * floating point values into DOUBLE, FIXED or integer fields, and
+   * strings (const char * or std::string) only into STRING fields.
+   *
+   * \param layout the layout of the record
+   * \param values the values of the fields
+   */
+  template <typename... Args>
+  void Write (const Layout &layout, const Args &... values);
+
+  /**
+   * \brief Flush the buffered records to the file
+   */
+  void Flush ();
+
+private:
+  /**
+   * \brief Constructor
+   * \param fileName the file name
+   * \param header the header
+   * \param format the format
+   * \param bufferSize the buffer size
+   * \param append true to append to an existing file
+   */
+  NrTraceSink (const std::string &fileName, const std::string &header, Format format,
+               uint32_t bufferSize, bool append);
+
+  /**
+   * \brief Get the binary id of a layout, writing its definition in the file
+   * the first time that the layout is used
+   * \param layout the layout
+   * \return the id
+   */
+  uint8_t GetLayoutId (const Layout &layout);
+
+  /**
+   * \brief Append an unsigned value to the binary record
+   * \param type the type of the field
+   * \param v the value
+   */
+  void Pack (FieldType type, uint64_t v);
+  /**
+   * \brief Append a signed value to the binary record
+   * \param type the type of the field
+   * \param v the value
+   */
+  void Pack (FieldType type, int64_t v);
+  /**
+   * \brief Append a double to the binary record
+   * \param type the type of the field
+   * \param v the value
+   */
+  void Pack (FieldType type, double v);
+  /**
+   * \brief Append a string to the binary record
+   * \param type the type of the field
+   * \param s the string
+   * \param len the length of the string
+   */
+  void Pack (FieldType type, const char *s, std::size_t len);
+
+  /**
+   * \brief Print an unsigned value in the text file
+   * \param type the type of the field
+   * \param v the value
+   */
+  void Print (FieldType type, uint64_t v);
+  /**
+   * \brief Print a signed value in the text file
+   * \param type the type of the field
+   * \param v the value
+   */
+  void Print (FieldType type, int64_t v);
+  /**
+   * \brief Print a double in the text file
+   * \param type the type of the field
+   * \param v the value
+   */
+  void Print (FieldType type, double v);
+  /**
+   * \brief Print a string in the text file
+   * \param type the type of the field
+   * \param s the string
+   * \param len the length of the string
+   */
+  void Print (FieldType type, const char *s, std::size_t len);
+
+  /**
+   * \brief Write a value, in the format of the sink
+   * \param type the type of the field
+   * \param v the value
+   */
+  template <typename T>
+  void WriteField (FieldType type, const T &v);
+
+  std::string m_fileName;              //!< Name of the file
+  Format m_format;                     //!< Format of the file
+  std::ofstream m_file;                //!< The file
+  std::vector<char> m_buffer;          //!< Buffer of the file stream
+  std::vector<const Layout *> m_layouts; //!< Layouts already defined in the binary file
+  std::vector<char> m_record;          //!< Binary record being built
+};
+
+template <typename T>
+void
+NrTraceSink::WriteField (FieldType type, const T &v)
+{
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      m_format == BINARY ? Pack (type, static_cast<double> (v)) : Print (type, static_cast<double> (v));
+    }
+  else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value)
+    {
+      m_format == BINARY ? Pack (type, static_cast<int64_t> (v)) : Print (type, static_cast<int64_t> (v));
+    }
+  else if constexpr (std::is_integral<T>::value)
+    {
+      m_format == BINARY ? Pack (type, static_cast<uint64_t> (v)) : Print (type, static_cast<uint64_t> (v));
+    }
+  else if constexpr (std::is_same<T, std::string>::value)
+    {
+      m_format == BINARY ? Pack (type, v.data (), v.size ()) : Print (type, v.data (), v.size ());
+    }
+  else
+    {
+      const char *s = v;
+      m_format == BINARY ? Pack (type, s, std::strlen (s)) : Print (type, s, std::strlen (s));
+    }
+}
+
+template <typename... Args>
+void
+NrTraceSink::Write (const Layout &layout, const Args &... values)
+{
+  NS_ASSERT_MSG (sizeof... (Args) == layout.m_fields.size (),
+                 "Record with " << sizeof... (Args) << " values for a layout of " <<
+                 layout.m_fields.size () << " fields");
+  std::size_t i = 0;
+  if (m_format == BINARY)
+    {
+      uint8_t id = GetLayoutId (layout);
+      m_record.clear ();
+      m_record.push_back ('R');
+      m_record.push_back (static_cast<char> (id));
+      (WriteField (layout.m_fields[i++].second, values), ...);
+      m_file.write (m_record.data (), static_cast<std::streamsize> (m_record.size ()));
+    }
+  else
+    {
+      ((i > 0 ? (void) (m_file << layout.m_separator) : (void) 0,
+        WriteField (layout.m_fields[i++].second, values)), ...);
+      m_file << layout.m_terminator << '\n';
+      if (m_format == FLUSHED_TEXT)
+        {
+          m_file.flush ();
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif // NR_TRACE_SINK_H
@@ -19,6 +19,7 @@
 
 #include "nr-amc.h"
 #include <ns3/log.h>
+#include <ns3/abort.h>
 #include <ns3/double.h>
 #include <ns3/math.h>
 #include <ns3/enum.h>
@@ -27,6 +28,10 @@
 #include "nr-lte-mi-error-model.h"
 #include "lena-error-model.h"
 #include <ns3/nr-spectrum-value-helper.h>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NrAmc");
@@ -46,6 +51,8 @@ NrAmc::SetDlMode ()
 {
   NS_LOG_FUNCTION (this);
   m_emMode = NrErrorModel::DL;
+  m_mcsCache.clear ();
+  m_tbSizeTable.reset ();
 }
 
 void
@@ -53,6 +60,8 @@ NrAmc::SetUlMode ()
 {
   NS_LOG_FUNCTION (this);
   m_emMode = NrErrorModel::UL;
+  m_mcsCache.clear ();
+  m_tbSizeTable.reset ();
 }
 
 TypeId
@@ -81,6 +90,25 @@ NrAmc::GetTypeId (void)
                    MakeTypeIdAccessor (&NrAmc::SetErrorModelType,
                                        &NrAmc::GetErrorModelType),
                    MakeTypeIdChecker ())
+    .AddAttribute ("McsSearch",
+                   "Algorithm used to find the MCS of the CQI feedback when AmcModel "
+                   "is set to ErrorModel. Linear evaluates all the MCSs up to the first "
+                   "one above the target TBLER (exact); Bisection assumes that the TBLER "
+                   "grows with the MCS and bisects the MCS range, which is faster but can "
+                   "return a higher MCS than Linear when the TBLER is not monotone",
+                   EnumValue (NrAmc::LinearMcsSearch),
+                   MakeEnumAccessor (&NrAmc::SetMcsSearch,
+                                     &NrAmc::GetMcsSearch),
+                   MakeEnumChecker (NrAmc::LinearMcsSearch, "Linear",
+                                    NrAmc::BisectionMcsSearch, "Bisection"))
+    .AddAttribute ("McsCacheSinrStep",
+                   "Quantization step (dB) of the SINR of each RB used to memoize the "
+                   "MCS of the CQI feedback, when AmcModel is set to ErrorModel. "
+                   "0 disables the memo",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&NrAmc::SetMcsCacheSinrStep,
+                                       &NrAmc::GetMcsCacheSinrStep),
+                   MakeDoubleChecker<double> (0.0))
     .AddConstructor <NrAmc> ()
   ;
   return tid;
@@ -122,6 +150,8 @@ void NrAmc::SetNumRefScPerRb(uint8_t nref)
 {
   NS_LOG_FUNCTION (this);
   m_numRefScPerRb = nref;
+  m_mcsCache.clear ();
+  m_tbSizeTable.reset ();
 }
 
 uint32_t
@@ -132,6 +162,93 @@ NrAmc::CalculateTbSize (uint8_t mcs, uint32_t nprb) const
   NS_ASSERT_MSG (mcs <= m_errorModel->GetMaxMcs (), "MCS=" << static_cast<uint32_t> (mcs) <<
                  " while maximum MCS is " << static_cast<uint32_t> (m_errorModel->GetMaxMcs ()));
 
+  uint32_t tbSize = nprb <= m_maxTableRb ? FillTbSizeTable (mcs, nprb).at (nprb)
+                                         : ComputeTbSize (mcs, nprb);
+
+  NS_LOG_INFO (" mcs:" << (unsigned) mcs << " TB size:" << tbSize);
+
+  return tbSize;
+}
+
+uint32_t
+NrAmc::GetMinNumRbForBytes (uint8_t mcs, uint32_t bytes) const
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (mcs) << bytes);
+
+  NS_ASSERT_MSG (mcs <= m_errorModel->GetMaxMcs (), "MCS=" << static_cast<uint32_t> (mcs) <<
+                 " while maximum MCS is " << static_cast<uint32_t> (m_errorModel->GetMaxMcs ()));
+
+  // The running maximum is sorted, and it reaches the bytes for the first
+  // time exactly where the TB size does
+  uint32_t nprb = 1;
+  while (nprb <= m_maxTableRb)
+    {
+      FillTbSizeTable (mcs, nprb);
+      const std::vector<uint32_t> &maxTbSize = m_tbSizeTable->m_maxTbSize.at (mcs);
+      auto it = std::lower_bound (maxTbSize.begin () + 1, maxTbSize.end (), bytes);
+      if (it != maxTbSize.end ())
+        {
+          return static_cast<uint32_t> (it - maxTbSize.begin ());
+        }
+      nprb = nprb < m_maxTableRb ? std::min (2 * static_cast<uint32_t> (maxTbSize.size ()), m_maxTableRb)
+                                 : m_maxTableRb + 1;
+    }
+
+  // Beyond the table (very low MCSs and large buffers), as CalculateTbSize
+  while (ComputeTbSize (mcs, nprb) < bytes)
+    {
+      ++nprb;
+    }
+  return nprb;
+}
+
+const std::vector<uint32_t> &
+NrAmc::FillTbSizeTable (uint8_t mcs, uint32_t nprb) const
+{
+  // The TB size does not depend on anything else than these. The tables
+  // are kept for the whole simulation: they are small, and the
+  // configurations are few. They are filled on demand, so each thread
+  // has its own ones: the instances can run on several threads with the
+  // MultithreadedSimulatorImpl.
+  typedef std::tuple<uint16_t, uint8_t, uint8_t> Key;
+  static thread_local std::map<Key, std::shared_ptr<TbSizeTable>> tables;
+  if (m_tbSizeTable == nullptr || m_tbSizeTableOwner != &tables)
+    {
+      m_tbSizeTableOwner = &tables;
+      Key key (m_errorModelType.GetUid (), static_cast<uint8_t> (m_emMode), m_numRefScPerRb);
+      std::shared_ptr<TbSizeTable> &table = tables[key];
+      if (table == nullptr)
+        {
+          table = std::make_shared<TbSizeTable> ();
+        }
+      m_tbSizeTable = table;
+    }
+
+  if (m_tbSizeTable->m_tbSize.size () <= mcs)
+    {
+      m_tbSizeTable->m_tbSize.resize (mcs + 1);
+      m_tbSizeTable->m_maxTbSize.resize (mcs + 1);
+    }
+
+  std::vector<uint32_t> &tbSize = m_tbSizeTable->m_tbSize[mcs];
+  std::vector<uint32_t> &maxTbSize = m_tbSizeTable->m_maxTbSize[mcs];
+  if (tbSize.empty ())
+    {
+      tbSize.push_back (ComputeTbSize (mcs, 0));
+      maxTbSize.push_back (0);
+    }
+  while (tbSize.size () <= nprb)
+    {
+      uint32_t value = ComputeTbSize (mcs, static_cast<uint32_t> (tbSize.size ()));
+      tbSize.push_back (value);
+      maxTbSize.push_back (std::max (maxTbSize.back (), value));
+    }
+  return tbSize;
+}
+
+uint32_t
+NrAmc::ComputeTbSize (uint8_t mcs, uint32_t nprb) const
+{
   uint32_t payloadSize = GetPayloadSize (mcs, nprb);
   uint32_t tbSize = payloadSize;
 
@@ -149,8 +266,6 @@ NrAmc::CalculateTbSize (uint8_t mcs, uint32_t nprb) const
         }
     }
 
-  NS_LOG_INFO (" mcs:" << (unsigned) mcs << " TB size:" << tbSize);
-
   return tbSize;
 }
 
@@ -226,39 +341,57 @@ NrAmc::CreateCqiFeedbackWbTdma (const SpectrumValue& sinr, uint8_t &mcs) const
     {
       std::vector <int> rbMap;
       int rbId = 0;
-      double sinrAvg = 0;
       for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
         {
           if (*it != 0.0)
             {
               rbMap.push_back (rbId);
-              sinrAvg += *it;
             }
           rbId += 1;
         }
-      sinrAvg /= rbMap.size ();
 
-      mcs = 0;
-      Ptr<NrErrorModelOutput> output;
-      while (mcs <= m_errorModel->GetMaxMcs ())
+      uint8_t firstMcsAboveTarget = 0;
+      if (m_mcsCacheSinrStep > 0.0)
         {
-          output = m_errorModel->GetTbDecodificationStats (sinr, rbMap,
-                                                           CalculateTbSize (mcs, rbMap.size ()),
-                                                           mcs,
-                                                           NrErrorModel::NrErrorModelHistory ());
-          if (output->m_tbler > 0.1)
+          // FNV-1a hash of the quantized SINR of each RB
+          uint64_t hash = 14695981039346656037ULL;
+          m_mcsCacheKey.clear ();
+          for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
             {
-              break;
+              int32_t q = std::numeric_limits<int32_t>::min ();
+              if (*it != 0.0)
+                {
+                  q = static_cast<int32_t> (std::floor (10 * std::log10 (*it) / m_mcsCacheSinrStep));
+                }
+              m_mcsCacheKey.push_back (q);
+              hash = (hash ^ static_cast<uint32_t> (q)) * 1099511628211ULL;
             }
-          mcs++;
-        }
 
-      if (mcs > 0)
+          if (m_mcsCache.empty ())
+            {
+              m_mcsCache.resize (m_mcsCacheSize);
+            }
+          McsCacheEntry &entry = m_mcsCache[hash % m_mcsCacheSize];
+          if (entry.m_sinrKey == m_mcsCacheKey)
+            {
+              firstMcsAboveTarget = entry.m_firstMcsAboveTarget;
+            }
+          else
+            {
+              firstMcsAboveTarget = GetFirstMcsAboveTargetTbler (sinr, rbMap);
+              entry.m_sinrKey = m_mcsCacheKey;
+              entry.m_firstMcsAboveTarget = firstMcsAboveTarget;
+            }
+        }
+      else
         {
-          mcs--;
+          firstMcsAboveTarget = GetFirstMcsAboveTargetTbler (sinr, rbMap);
         }
 
-      if ((output->m_tbler > 0.1) && (mcs == 0))
+      mcs = firstMcsAboveTarget > 0 ? firstMcsAboveTarget - 1 : 0;
+
+      // when MCS 0 or MCS 1 do not reach the target, there is no valid CQI
+      if (firstMcsAboveTarget <= 1)
         {
           cqi = 0;
         }
@@ -280,6 +413,53 @@ NrAmc::CreateCqiFeedbackWbTdma (const SpectrumValue& sinr, uint8_t &mcs) const
   return cqi;
 }
 
+bool
+NrAmc::IsMcsAboveTargetTbler (const SpectrumValue& sinr, const std::vector<int> &rbMap,
+                              uint8_t mcs) const
+{
+  Ptr<NrErrorModelOutput> output;
+  output = m_errorModel->GetTbDecodificationStats (sinr, rbMap,
+                                                   CalculateTbSize (mcs, rbMap.size ()),
+                                                   mcs,
+                                                   NrErrorModel::NrErrorModelHistory ());
+  return output->m_tbler > 0.1;
+}
+
+uint8_t
+NrAmc::GetFirstMcsAboveTargetTbler (const SpectrumValue& sinr, const std::vector<int> &rbMap) const
+{
+  NS_LOG_FUNCTION (this);
+  const uint8_t maxMcs = m_errorModel->GetMaxMcs ();
+
+  if (m_mcsSearch == LinearMcsSearch)
+    {
+      uint8_t mcs = 0;
+      while (mcs <= maxMcs && ! IsMcsAboveTargetTbler (sinr, rbMap, mcs))
+        {
+          mcs++;
+        }
+      return mcs;
+    }
+
+  NS_ASSERT (m_mcsSearch == BisectionMcsSearch);
+  // the MCSs in [0, low) reach the target, the ones in [high, maxMcs] do not
+  uint8_t low = 0;
+  uint8_t high = maxMcs + 1;
+  while (low < high)
+    {
+      uint8_t mid = low + (high - low) / 2;
+      if (IsMcsAboveTargetTbler (sinr, rbMap, mid))
+        {
+          high = mid;
+        }
+      else
+        {
+          low = mid + 1;
+        }
+    }
+  return low;
+}
+
 uint8_t
 NrAmc::GetCqiFromSpectralEfficiency (double s) const
 {
@@ -329,6 +509,36 @@ NrAmc::GetAmcModel () const
   return m_amcModel;
 }
 
+void
+NrAmc::SetMcsSearch (NrAmc::McsSearch s)
+{
+  NS_LOG_FUNCTION (this);
+  m_mcsSearch = s;
+  m_mcsCache.clear ();
+}
+
+NrAmc::McsSearch
+NrAmc::GetMcsSearch () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_mcsSearch;
+}
+
+void
+NrAmc::SetMcsCacheSinrStep (double step)
+{
+  NS_LOG_FUNCTION (this << step);
+  m_mcsCacheSinrStep = step;
+  m_mcsCache.clear ();
+}
+
+double
+NrAmc::GetMcsCacheSinrStep () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_mcsCacheSinrStep;
+}
+
 void
 NrAmc::SetErrorModelType (const TypeId &type)
 {
@@ -339,6 +549,8 @@ NrAmc::SetErrorModelType (const TypeId &type)
   factory.SetTypeId (m_errorModelType);
   m_errorModel = DynamicCast<NrErrorModel> (factory.Create ());
   NS_ASSERT (m_errorModel != nullptr);
+  m_mcsCache.clear ();
+  m_tbSizeTable.reset ();
 }
 
 TypeId
@@ -21,6 +21,8 @@
 
 #include <ns3/nr-phy-mac-common.h>
 #include <ns3/nr-error-model.h>
+#include <memory>
+#include <vector>
 
 namespace ns3 {
 
@@ -43,6 +45,46 @@ namespace ns3 {
  * for what regards the GNB side (DL or UL). It is important to note that the
  * UE gets a pointer to the GNB AMC to which is connected to.
  *
+ * \section nr_amc_mcs_search MCS search
+ *
+ * With the ErrorModel model, the CQI feedback is obtained by looking for the
+ * highest MCS whose TBLER stays below the target. The search can be done in two
+ * ways, selected with the attribute "McsSearch":
+ *
+ * - LinearMcsSearch: all the MCSs are evaluated, from 0 up to the first one
+ * that does not reach the target. This is the strict reference, and the default.
+ * - BisectionMcsSearch: the search assumes that the TBLER grows with the MCS,
+ * and bisects the MCS range; it evaluates the error model around log2(maxMcs)
+ * times instead of up to maxMcs times. It is an approximation: the TBLER is
+ * not always monotone in the MCS, as it can drop at a change of modulation,
+ * at the code rate steps of the MCS table, and with the TB size quantization
+ * of allocations of a few RBs. The bisection then returns an MCS that reaches
+ * the target while the next one does not, but it can be higher than the one
+ * of the linear search, i.e., an MCS that the linear search rejects because
+ * a lower MCS already fails the target. The windows in which this happens
+ * change with the SINR, the number of RBs and the error model, so there is no
+ * confirmation step cheaper than the linear search itself; use the bisection
+ * only when that deviation is acceptable.
+ *
+ * On top of that, the attribute "McsCacheSinrStep" enables a memo of the
+ * result of the search, keyed by the SINR of each RB quantized with the given
+ * step (in dB). Frequency-selective channels with the same average SINR do
+ * not share an entry, while UEs with the same per-RB channel quality (e.g.,
+ * frequency-flat channels at the same distance) share the result of a single
+ * search. The memo is a direct-mapped table of a fixed number of entries, so its
+ * memory does not grow with the length of the simulation: a new key replaces
+ * the entry with the same hash. A step of 0 (the default) disables the memo.
+ *
+ * \section nr_amc_tb_size TB size table
+ *
+ * The TB size depends only on the error model type, on the mode (DL or UL)
+ * and on the number of reference subcarriers per RB. CalculateTbSize () keeps
+ * the values already computed in a table per MCS and number of RBs, filled
+ * on demand and shared by all the NrAmc instances with the same
+ * configuration. The table also gives the inverse lookup of
+ * GetMinNumRbForBytes (), that the schedulers use to size an allocation
+ * without trying every number of RBs.
+ *
  * \todo Pass NrAmc parameters through RRC, and don't pass pointers to AMC
  * between GNB and UE
  */
@@ -100,6 +142,17 @@ public:
     ErrorModel    //!< Error Model version (can use different error models, see NrErrorModel)
   };
 
+  /**
+   * \brief Algorithm used to find the MCS of the CQI feedback (ErrorModel model)
+   *
+   * \see CreateCqiFeedbackWbTdma
+   */
+  enum McsSearch
+  {
+    LinearMcsSearch,   //!< Evaluate the MCSs one by one, from the lowest (strict reference)
+    BisectionMcsSearch //!< Bisect the MCS range, assuming TBLER monotone in the MCS
+  };
+
   /**
    * \brief Get the MCS value from a CQI value
    * \param cqi the CQI
@@ -166,6 +219,28 @@ public:
    */
   AmcModel GetAmcModel () const;
 
+  /**
+   * \brief Set the MCS search algorithm
+   * \param s the MCS search algorithm
+   */
+  void SetMcsSearch (McsSearch s);
+  /**
+   * \brief Get the MCS search algorithm
+   * \return the MCS search algorithm
+   */
+  McsSearch GetMcsSearch () const;
+
+  /**
+   * \brief Set the SINR quantization step of the MCS memo
+   * \param step the step in dB; 0 disables the memo
+   */
+  void SetMcsCacheSinrStep (double step);
+  /**
+   * \brief Get the SINR quantization step of the MCS memo
+   * \return the step in dB
+   */
+  double GetMcsCacheSinrStep () const;
+
   /**
    * \brief Set Error model type
    * \param type the Error model type
@@ -189,6 +264,17 @@ public:
    */
   uint32_t CalculateTbSize (uint8_t mcs, uint32_t nprb) const;
 
+  /**
+   * \brief Get the minimum number of RB whose TB contains the given bytes
+   *
+   * It is the smallest nprb > 0 for which CalculateTbSize (mcs, nprb) >= bytes.
+   *
+   * \param mcs the MCS of the transmission
+   * \param bytes the bytes to transmit
+   * \return the number of RB (not RBG)
+   */
+  uint32_t GetMinNumRbForBytes (uint8_t mcs, uint32_t bytes) const;
+
   /**
    * \brief Calculate the Payload Size (in bytes) from MCS and the number of RB
    * \param mcs MCS of the transmission
@@ -203,6 +289,53 @@ private:
    */
   double GetBer () const;
 
+  /**
+   * \brief Check if a MCS reaches the target TBLER of the CQI feedback
+   * \param sinr the SINR values
+   * \param rbMap the RBs with signal
+   * \param mcs the MCS to check
+   * \return true if the TBLER with the given MCS is above the target
+   */
+  bool IsMcsAboveTargetTbler (const SpectrumValue& sinr, const std::vector<int> &rbMap,
+                              uint8_t mcs) const;
+
+  /**
+   * \brief Find the first MCS that does not reach the target TBLER
+   *
+   * The search follows the algorithm configured with SetMcsSearch ().
+   *
+   * \param sinr the SINR values
+   * \param rbMap the RBs with signal
+   * \return the lowest MCS whose TBLER is above the target, or GetMaxMcs () + 1
+   * if all of them reach the target
+   */
+  uint8_t GetFirstMcsAboveTargetTbler (const SpectrumValue& sinr, const std::vector<int> &rbMap) const;
+
+  /**
+   * \brief TB sizes of an AMC configuration, filled on demand
+   */
+  struct TbSizeTable
+  {
+    std::vector<std::vector<uint32_t>> m_tbSize;    //!< TB size, per MCS and number of RB
+    std::vector<std::vector<uint32_t>> m_maxTbSize; //!< Maximum TB size from 1 RB up to a number of RB, per MCS
+  };
+
+  /**
+   * \brief Compute the TB size, without the table
+   * \param mcs the MCS of the transmission
+   * \param nprb the number of RB
+   * \return the TBS in bytes
+   */
+  uint32_t ComputeTbSize (uint8_t mcs, uint32_t nprb) const;
+
+  /**
+   * \brief Fill the table of an MCS up to (at least) a number of RB
+   * \param mcs the MCS
+   * \param nprb the number of RB
+   * \return the TB sizes of the MCS
+   */
+  const std::vector<uint32_t> & FillTbSizeTable (uint8_t mcs, uint32_t nprb) const;
+
 private:
   AmcModel m_amcModel;             //!< Type of the CQI feedback model
   Ptr<NrErrorModel> m_errorModel;  //!< Pointer to an instance of ErrorModel
@@ -210,6 +343,26 @@ private:
   uint8_t m_numRefScPerRb {1};     //!< number of reference subcarriers per RB
   NrErrorModel::Mode m_emMode {NrErrorModel::DL}; //!< Error model mode
   static const unsigned int m_crcLen = 24 / 8; //!< CRC length (in bytes)
+  McsSearch m_mcsSearch {LinearMcsSearch}; //!< MCS search algorithm for the CQI feedback
+  double m_mcsCacheSinrStep {0.0}; //!< SINR quantization step of the MCS memo (dB), 0 to disable it
+  /**
+   * \brief Entry of the memo of the first MCS above the target TBLER
+   */
+  struct McsCacheEntry
+  {
+    std::vector<int32_t> m_sinrKey;     //!< Quantized SINR of each RB (INT32_MIN without signal), empty if the entry is free
+    uint8_t m_firstMcsAboveTarget {0};  //!< Result of the search for the key
+  };
+  static constexpr uint32_t m_mcsCacheSize = 1024; //!< Number of entries of the MCS memo
+  mutable std::vector<McsCacheEntry> m_mcsCache; //!< Direct-mapped MCS memo, indexed by the hash of the key
+  mutable std::vector<int32_t> m_mcsCacheKey;     //!< Key of the current lookup in the MCS memo
+  /**
+   * \brief TB size table of the current configuration (shared with the other
+   * instances with the same configuration), or nullptr if not yet looked up
+   */
+  mutable std::shared_ptr<TbSizeTable> m_tbSizeTable;
+  mutable const void *m_tbSizeTableOwner {nullptr}; //!< The tables of the thread that looked up m_tbSizeTable
+  static constexpr uint32_t m_maxTableRb = 16384; //!< Above this number of RB, the TB size is not stored
 };
 
 } // end namespace ns3
@@ -0,0 +1,151 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-cg-occasion-table.h"
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrCgOccasionTable");
+
+uint8_t
+NrCgOccasionTable::AddConfig (uint32_t periodSlots, uint32_t repetitions)
+{
+  NS_LOG_FUNCTION (this << periodSlots << repetitions);
+  NS_ABORT_MSG_IF (periodSlots == 0, "The configured grant period must be at least one slot");
+  NS_ABORT_MSG_IF (repetitions == 0 || repetitions > periodSlots,
+                   "Invalid number of repetitions " << repetitions <<
+                   " for a period of " << periodSlots << " slots");
+  NS_ABORT_MSG_IF (m_configs.size () > UINT8_MAX, "Too many configured grant configurations");
+
+  Config config;
+  config.m_periodSlots = periodSlots;
+  config.m_repetitions = repetitions;
+  config.m_occasionTable.resize (periodSlots);
+  m_configs.emplace_back (std::move (config));
+  return static_cast<uint8_t> (m_configs.size () - 1);
+}
+
+bool
+NrCgOccasionTable::AddResource (uint8_t configId, uint64_t firstSlot,
+                                const std::shared_ptr<DciInfoElementTdma> &dci)
+{
+  NS_LOG_FUNCTION (this << +configId << firstSlot);
+  NS_ASSERT (configId < m_configs.size ());
+  NS_ASSERT (dci != nullptr);
+  auto & config = m_configs[configId];
+
+  uint32_t offset = static_cast<uint32_t> (firstSlot % config.m_periodSlots);
+  for (uint32_t index : config.m_occasionTable[offset])
+    {
+      const auto & resource = config.m_resources[index];
+      if (resource.m_firstSlot % config.m_periodSlots == offset
+          && resource.m_dci->m_symStart == dci->m_symStart)
+        {
+          NS_LOG_INFO ("Configuration " << +configId << " has already a resource at offset " <<
+                       offset << " symbol " << +dci->m_symStart << ", ignoring it");
+          return false;
+        }
+    }
+
+  uint32_t index = static_cast<uint32_t> (config.m_resources.size ());
+  config.m_resources.push_back ({firstSlot, dci});
+  for (uint32_t r = 0; r < config.m_repetitions; ++r)
+    {
+      config.m_occasionTable[(offset + r) % config.m_periodSlots].push_back (index);
+    }
+  NS_LOG_INFO ("Configuration " << +configId << " resource " << index << " from slot " <<
+               firstSlot << " every " << config.m_periodSlots << " slots");
+  return true;
+}
+
+void
+NrCgOccasionTable::GetOccasions (uint64_t slot, std::vector<Occasion> *occasions) const
+{
+  occasions->clear ();
+  for (std::size_t configId = 0; configId < m_configs.size (); ++configId)
+    {
+      const auto & config = m_configs[configId];
+      for (uint32_t index : config.m_occasionTable[slot % config.m_periodSlots])
+        {
+          const auto & resource = config.m_resources[index];
+          if (slot >= resource.m_firstSlot)
+            {
+              occasions->push_back ({static_cast<uint8_t> (configId), resource.m_dci});
+            }
+        }
+    }
+}
+
+bool
+NrCgOccasionTable::GetNextOccasionSlot (uint64_t fromSlot, uint64_t *slot) const
+{
+  bool found = false;
+  uint64_t next = UINT64_MAX;
+  for (const auto & config : m_configs)
+    {
+      for (const auto & resource : config.m_resources)
+        {
+          uint64_t candidate = resource.m_firstSlot;
+          if (fromSlot > resource.m_firstSlot)
+            {
+              uint64_t inPeriod = (fromSlot - resource.m_firstSlot) % config.m_periodSlots;
+              candidate = inPeriod < config.m_repetitions
+                ? fromSlot : fromSlot + config.m_periodSlots - inPeriod;
+            }
+          next = std::min (next, candidate);
+          found = true;
+        }
+    }
+  if (found)
+    {
+      *slot = next;
+    }
+  return found;
+}
+
+std::size_t
+NrCgOccasionTable::GetNumConfigs () const
+{
+  return m_configs.size ();
+}
+
+std::size_t
+NrCgOccasionTable::GetNumResources (uint8_t configId) const
+{
+  NS_ASSERT (configId < m_configs.size ());
+  return m_configs[configId].m_resources.size ();
+}
+
+uint32_t
+NrCgOccasionTable::GetPeriod (uint8_t configId) const
+{
+  NS_ASSERT (configId < m_configs.size ());
+  return m_configs[configId].m_periodSlots;
+}
+
+void
+NrCgOccasionTable::Clear ()
+{
+  NS_LOG_FUNCTION (this);
+  m_configs.clear ();
+}
+
+} // namespace ns3
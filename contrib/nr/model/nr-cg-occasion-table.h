@@ -0,0 +1,144 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef NR_CG_OCCASION_TABLE_H
+#define NR_CG_OCCASION_TABLE_H
+
+#include "nr-phy-mac-common.h"
+#include <memory>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup ue-mac
+ * \brief The configured grant occasions of a UE
+ *
+ * A UE can have several configured grant configurations at the same time,
+ * e.g., one with a short period for a URLLC flow and one with a long period
+ * for a monitoring flow. A configuration has a periodicity, in slots (so that
+ * periods shorter than a subframe can be used with numerologies > 0), and a
+ * number of repetitions, i.e., of consecutive slots with an occasion in each
+ * period. The resources of a configuration are the DCIs of its transmissions;
+ * a resource that starts at the slot firstSlot has an occasion in the slots
+ * firstSlot + n * period + r, with n >= 0 and r < repetitions. The offset of
+ * the resource in the period is then firstSlot % period.
+ *
+ * The occasions are computed arithmetically: each configuration stores, for
+ * each slot of its period, the resources that have an occasion in that slot.
+ * Looking for the occasions of a slot costs a modulo per configuration, and
+ * using an occasion does not modify the table.
+ *
+ * The slots are absolute slot numbers, as returned by SfnSf::Normalize().
+ */
+class NrCgOccasionTable
+{
+public:
+  /**
+   * \brief A transmission occasion
+   */
+  struct Occasion
+  {
+    uint8_t m_configId {0};                      //!< Configuration of the occasion
+    std::shared_ptr<DciInfoElementTdma> m_dci;   //!< Resources of the occasion
+  };
+
+  /**
+   * \brief Add a configuration
+   * \param periodSlots the periodicity of the occasions, in slots
+   * \param repetitions the number of consecutive slots with an occasion in each period
+   * \return the ID of the configuration
+   */
+  uint8_t AddConfig (uint32_t periodSlots, uint32_t repetitions = 1);
+
+  /**
+   * \brief Add a resource to a configuration
+   * \param configId the ID of the configuration
+   * \param firstSlot the slot of the first occasion of the resource
+   * \param dci the DCI that describes the resource
+   * \return false if the configuration has already a resource with the same
+   * offset and starting symbol (the resource is then ignored)
+   */
+  bool AddResource (uint8_t configId, uint64_t firstSlot,
+                    const std::shared_ptr<DciInfoElementTdma> &dci);
+
+  /**
+   * \brief Get the occasions of a slot
+   * \param slot the slot
+   * \param occasions the vector to fill (it is cleared first), ordered by
+   * configuration and then by the insertion order of the resources
+   */
+  void GetOccasions (uint64_t slot, std::vector<Occasion> *occasions) const;
+
+  /**
+   * \brief Get the first slot with an occasion
+   * \param fromSlot the first slot to consider
+   * \param slot the first slot, not before fromSlot, with at least an occasion
+   * \return false if there are no resources (slot is then not modified)
+   */
+  bool GetNextOccasionSlot (uint64_t fromSlot, uint64_t *slot) const;
+
+  /**
+   * \return the number of configurations
+   */
+  std::size_t GetNumConfigs () const;
+
+  /**
+   * \param configId the ID of the configuration
+   * \return the number of resources of the configuration
+   */
+  std::size_t GetNumResources (uint8_t configId) const;
+
+  /**
+   * \param configId the ID of the configuration
+   * \return the periodicity of the configuration, in slots
+   */
+  uint32_t GetPeriod (uint8_t configId) const;
+
+  /**
+   * \brief Remove all the configurations
+   */
+  void Clear ();
+
+private:
+  /**
+   * \brief A resource of a configuration
+   */
+  struct Resource
+  {
+    uint64_t m_firstSlot {0};                    //!< Slot of the first occasion
+    std::shared_ptr<DciInfoElementTdma> m_dci;   //!< The resources
+  };
+
+  /**
+   * \brief A configuration
+   */
+  struct Config
+  {
+    uint32_t m_periodSlots {1};                  //!< Periodicity, in slots
+    uint32_t m_repetitions {1};                  //!< Occasions per period
+    std::vector<Resource> m_resources;           //!< The resources
+    std::vector<std::vector<uint32_t>> m_occasionTable; //!< Resources with an occasion, per slot of the period
+  };
+
+  std::vector<Config> m_configs; //!< The configurations, indexed by ID
+};
+
+} // namespace ns3
+
+#endif // NR_CG_OCCASION_TABLE_H
@@ -0,0 +1,170 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-eesm-bler-lookup.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrEesmBlerLookup");
+
+NrEesmBlerLookup::NrEesmBlerLookup (const NrEesmErrorModel::SimulatedBlerFromSINR &table)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (table.empty (), "Empty BLER-SINR table");
+
+  m_numMcs = static_cast<uint32_t> (table.front ().size ());
+  m_ranges.resize (table.size () * m_numMcs);
+
+  for (uint32_t bg = 0; bg < table.size (); ++bg)
+    {
+      NS_ABORT_MSG_IF (table.at (bg).size () != m_numMcs,
+                       "All the base graphs must have the same number of MCS");
+      for (uint32_t mcs = 0; mcs < m_numMcs; ++mcs)
+        {
+          CurveRange &range = m_ranges.at (bg * m_numMcs + mcs);
+          range.m_first = static_cast<uint32_t> (m_curves.size ());
+          range.m_num = static_cast<uint32_t> (table.at (bg).at (mcs).size ());
+
+          // std::map iterates the CB sizes in ascending order
+          for (const auto &cb : table.at (bg).at (mcs))
+            {
+              const std::vector<double> &sinr = std::get<0> (cb.second);
+              const std::vector<double> &bler = std::get<1> (cb.second);
+              NS_ABORT_MSG_IF (sinr.empty () || sinr.size () != bler.size (),
+                               "Malformed BLER-SINR curve for BG " << bg + 1 <<
+                               " MCS " << mcs << " CBS " << cb.first);
+              NS_ABORT_MSG_IF (sinr.size () > std::numeric_limits<uint16_t>::max (),
+                               "Too many points in BLER-SINR curve");
+              NS_ABORT_MSG_UNLESS (std::is_sorted (sinr.begin (), sinr.end ()),
+                                   "SINR points must be sorted");
+
+              Curve curve;
+              curve.m_sinrMin = sinr.front ();
+              curve.m_sinrMax = sinr.back ();
+              curve.m_firstPoint = static_cast<uint32_t> (m_sinrDb.size ());
+              curve.m_numPoints = static_cast<uint32_t> (sinr.size ());
+              curve.m_firstBucket = static_cast<uint32_t> (m_bucketPoint.size ());
+
+              // The grid step is the minimum distance between two points, so
+              // that (almost) every bucket start falls in the same interval of
+              // the curve as the whole bucket.
+              double span = curve.m_sinrMax - curve.m_sinrMin;
+              double step = span;
+              for (uint32_t i = 1; i < sinr.size (); ++i)
+                {
+                  double gap = sinr.at (i) - sinr.at (i - 1);
+                  if (gap > 0.0)
+                    {
+                      step = std::min (step, gap);
+                    }
+                }
+              step = std::max (step, span / MAX_BUCKETS_PER_CURVE);
+              if (step <= 0.0)
+                {
+                  step = 1.0; // single point (or flat) curve: one bucket
+                }
+              curve.m_invStep = 1.0 / step;
+              curve.m_numBuckets = static_cast<uint32_t> (std::floor (span * curve.m_invStep)) + 1;
+
+              uint16_t point = 0;
+              for (uint32_t k = 0; k < curve.m_numBuckets; ++k)
+                {
+                  double bucketStart = curve.m_sinrMin + k * step;
+                  while (point + 1u < sinr.size () && sinr.at (point + 1) <= bucketStart)
+                    {
+                      ++point;
+                    }
+                  m_bucketPoint.push_back (point);
+                }
+
+              m_sinrDb.insert (m_sinrDb.end (), sinr.begin (), sinr.end ());
+              m_bler.insert (m_bler.end (), bler.begin (), bler.end ());
+              m_cbSize.push_back (cb.first);
+              m_curves.push_back (curve);
+            }
+        }
+    }
+
+  NS_LOG_INFO ("Compiled " << m_curves.size () << " BLER-SINR curves with " <<
+               m_sinrDb.size () << " points and " << m_bucketPoint.size () <<
+               " grid buckets, " << GetMemoryUsage () << " bytes");
+}
+
+double
+NrEesmBlerLookup::GetBler (uint8_t bgType, uint8_t mcs, uint32_t cbSizeBit, double sinrDb) const
+{
+  NS_ASSERT (mcs < m_numMcs);
+  NS_ASSERT (bgType * m_numMcs + mcs < m_ranges.size ());
+
+  const CurveRange &range = m_ranges[bgType * m_numMcs + mcs];
+  NS_ASSERT (range.m_num > 0);
+
+  // take the highest simulated CB size not above cbSizeBit, or the lowest one
+  const uint32_t *cbBegin = m_cbSize.data () + range.m_first;
+  const uint32_t *cbIt = std::upper_bound (cbBegin, cbBegin + range.m_num, cbSizeBit);
+  if (cbIt != cbBegin)
+    {
+      --cbIt;
+    }
+  const Curve &curve = m_curves[range.m_first + (cbIt - cbBegin)];
+
+  if (!(sinrDb >= curve.m_sinrMin))
+    {
+      return 1.0;
+    }
+  if (sinrDb > curve.m_sinrMax)
+    {
+      return 0.0;
+    }
+
+  uint32_t bucket = static_cast<uint32_t> ((sinrDb - curve.m_sinrMin) * curve.m_invStep);
+  bucket = std::min (bucket, curve.m_numBuckets - 1);
+
+  const double *sinr = m_sinrDb.data () + curve.m_firstPoint;
+  uint32_t point = m_bucketPoint[curve.m_firstBucket + bucket];
+  // correct the grid guess: rounding at bucket edges, or capped grids
+  while (point + 1 < curve.m_numPoints && sinr[point + 1] <= sinrDb)
+    {
+      ++point;
+    }
+  while (point > 0 && sinr[point] > sinrDb)
+    {
+      --point;
+    }
+
+  return m_bler[curve.m_firstPoint + point];
+}
+
+std::size_t
+NrEesmBlerLookup::GetMemoryUsage () const
+{
+  return sizeof (*this)
+         + m_ranges.capacity () * sizeof (CurveRange)
+         + m_cbSize.capacity () * sizeof (uint32_t)
+         + m_curves.capacity () * sizeof (Curve)
+         + m_sinrDb.capacity () * sizeof (double)
+         + m_bler.capacity () * sizeof (double)
+         + m_bucketPoint.capacity () * sizeof (uint16_t);
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef NR_EESM_BLER_LOOKUP_H
+#define NR_EESM_BLER_LOOKUP_H
+
+#include "nr-eesm-error-model.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup error-models
+ * \brief Compiled, read-only form of a BLER-SINR table
+ *
+ * The BLER-SINR curves of NrEesmT1 and NrEesmT2 are stored as a nested
+ * vector/map structure, which is convenient to write down but slow to query:
+ * each query walks a std::map for the CB size and binary-searches the SINR
+ * vector of the selected curve.
+ *
+ * This class flattens one of those tables into a handful of contiguous arrays,
+ * indexed by (base graph, MCS, CB-size bucket). Each curve also gets a
+ * uniform-step SINR grid that points directly into its SINR points, so that
+ * the position of a SINR value in the curve is found with one multiplication
+ * and (at most) a couple of comparisons. A query does not allocate memory.
+ *
+ * The result of GetBler () is exactly the one of the original table search:
+ * the BLER of the highest simulated SINR point that is lower or equal to the
+ * requested SINR, taken from the curve of the highest simulated CB size lower
+ * or equal to the requested one (or the lowest one, if none is lower). SINR
+ * values below (above) the simulated range return a BLER of 1 (0).
+ *
+ * The object is built once per table; NrEesmT1 and NrEesmT2 keep a single
+ * instance that is shared by all the error models that use the table.
+ */
+class NrEesmBlerLookup
+{
+public:
+  /**
+   * \brief Build the compiled lookup from a BLER-SINR table
+   * \param table the table, as stored in NrEesmT1 or NrEesmT2
+   */
+  NrEesmBlerLookup (const NrEesmErrorModel::SimulatedBlerFromSINR &table);
+
+  /**
+   * \brief Get the BLER of a code block
+   * \param bgType the LDPC base graph (0 for BG1, 1 for BG2)
+   * \param mcs the MCS
+   * \param cbSizeBit the size of the CB in bits
+   * \param sinrDb the effective SINR in dB
+   * \return the code block error rate
+   */
+  double GetBler (uint8_t bgType, uint8_t mcs, uint32_t cbSizeBit, double sinrDb) const;
+
+  /**
+   * \return the memory used by the compiled arrays, in bytes
+   */
+  std::size_t GetMemoryUsage () const;
+
+private:
+  /**
+   * \brief A single BLER-SINR curve
+   */
+  struct Curve
+  {
+    double m_sinrMin {0.0};        //!< SINR of the first point (dB)
+    double m_sinrMax {0.0};        //!< SINR of the last point (dB)
+    double m_invStep {0.0};        //!< Inverse of the grid step (1/dB)
+    uint32_t m_firstPoint {0};     //!< Index of the first point in m_sinrDb/m_bler
+    uint32_t m_numPoints {0};      //!< Number of points of the curve
+    uint32_t m_firstBucket {0};    //!< Index of the first grid bucket in m_bucketPoint
+    uint32_t m_numBuckets {0};     //!< Number of grid buckets of the curve
+  };
+
+  /**
+   * \brief The range of curves available for a (base graph, MCS) pair
+   */
+  struct CurveRange
+  {
+    uint32_t m_first {0};  //!< Index of the first curve in m_cbSize/m_curves
+    uint32_t m_num {0};    //!< Number of curves (CB sizes)
+  };
+
+  /**
+   * \brief Maximum number of grid buckets per curve
+   *
+   * Curves with very close SINR points would otherwise need a very fine grid;
+   * with the cap, a lookup may need to move a few points from the bucket start.
+   */
+  static constexpr uint32_t MAX_BUCKETS_PER_CURVE = 1024;
+
+  uint32_t m_numMcs {0};                  //!< Number of MCS per base graph
+  std::vector<CurveRange> m_ranges;       //!< Curve range, indexed by bg * m_numMcs + mcs
+  std::vector<uint32_t> m_cbSize;         //!< CB size of each curve, ascending inside a range
+  std::vector<Curve> m_curves;            //!< Curves, parallel to m_cbSize
+  std::vector<double> m_sinrDb;           //!< SINR points of all the curves
+  std::vector<double> m_bler;             //!< BLER points of all the curves
+  std::vector<uint16_t> m_bucketPoint;    //!< For each grid bucket, the last point not above its start
+};
+
+} // namespace ns3
+
+#endif // NR_EESM_BLER_LOOKUP_H
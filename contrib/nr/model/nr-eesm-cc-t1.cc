@@ -62,6 +62,12 @@ NrEesmCcT1::GetSimulatedBlerFromSINR() const
   return m_t1.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerLookup *
+NrEesmCcT1::GetBlerLookup() const
+{
+  return m_t1.m_blerLookup;
+}
+
 const std::vector<uint8_t> *
 NrEesmCcT1::GetMcsMTable() const
 {
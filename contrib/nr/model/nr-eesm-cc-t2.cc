@@ -62,6 +62,12 @@ NrEesmCcT2::GetSimulatedBlerFromSINR() const
   return m_t2.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerLookup *
+NrEesmCcT2::GetBlerLookup() const
+{
+  return m_t2.m_blerLookup;
+}
+
 const std::vector<uint8_t> *
 NrEesmCcT2::GetMcsMTable() const
 {
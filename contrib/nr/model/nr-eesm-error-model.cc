@@ -20,6 +20,8 @@
 */
 
 #include "nr-eesm-error-model.h"
+#include "nr-eesm-bler-lookup.h"
+#include "nr-eesm-sinr-kernel.h"
 #include "ns3/log.h"
 #include <cmath>
 #include <algorithm>
@@ -70,12 +72,17 @@ NrEesmErrorModel::GetInstanceTypeId() const
 
 double
 NrEesmErrorModel::SinrEff (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs, double a, double b) const
+{
+  return SinrEffFromExpSum (SinrExp (sinr, map, mcs), mcs, a, b);
+}
+
+double
+NrEesmErrorModel::SinrEffFromExpSum (double sinrExpSum, uint8_t mcs, double a, double b) const
 {
   // it follows: SINReff = - beta * ln [1/b * (sum (exp (-sinr/beta)) + a)]
   // for HARQ-IR: b = sum (map.size()), a = sum_j(sum_n (exp (-sinr/beta))) (for previous retx, till j=q-1)
   // for HARQ-CC: b = map.size(), a = 0.0 (SINRs are already combined in sinr input)
 
-  double sinrExpSum = SinrExp (sinr, map, mcs);
   double beta = GetBetaTable ()->at (mcs);
   double SINR = -beta * log ((a + sinrExpSum)/b);
 
@@ -92,31 +99,10 @@ NrEesmErrorModel::SinrExp (const SpectrumValue& sinr, const std::vector<int>& ma
   NS_ABORT_MSG_IF (map.size () == 0,
                    " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
 
-  double SINRexp = 0.0;
-  double SINRsum = 0.0;
   double beta = GetBetaTable ()->at (mcs);
-  SpectrumValue sinrCopy = sinr;
-  for (uint32_t i = 0; i < map.size (); i++)
-    {
-      double sinrLin = sinrCopy [map.at (i)];
-      SINRexp = exp (-sinrLin / beta);
-      SINRsum += SINRexp;
-    }
-  return SINRsum;
-}
-
-const std::vector<double> &
-NrEesmErrorModel::GetSinrDbVectorFromSimulatedValues (NrEesmErrorModel::GraphType graphType,
-                                                      uint8_t mcs, uint32_t cbSizeIndex) const
-{
-  return std::get<0> (GetSimulatedBlerFromSINR ()->at (graphType).at (mcs).at (cbSizeIndex));
-}
-
-const std::vector<double> &
-NrEesmErrorModel::GetBLERVectorFromSimulatedValues (NrEesmErrorModel::GraphType graphType,
-                                                    uint8_t mcs, uint32_t cbSizeIndex) const
-{
-  return std::get<1> (GetSimulatedBlerFromSINR ()->at (graphType).at (mcs).at (cbSizeIndex));
+  // operate in place over the SINR values, without copying them
+  return NrEesmSinrKernel::SinrExpSum (&(*sinr.ConstValuesBegin ()), sinr.GetValuesN (),
+                                       map.data (), map.size (), beta);
 }
 
 double
@@ -127,46 +113,14 @@ NrEesmErrorModel::MappingSinrBler (double sinr, uint8_t mcs, uint32_t cbSizeBit)
 
   // use cbSize to obtain the index of CBSIZE in the map, jointly with mcs and sinr. take the
   // lowest CBSIZE simulated including this CB for removing CB size quatization
-  // errors. sinr is also lower-bounded.
-  double bler = 0.0;
+  // errors. sinr is also lower-bounded. The search runs over the compiled
+  // version of the table, see NrEesmBlerLookup.
   double sinr_db = 10 * log10 (sinr);
   GraphType bg_type = GetBaseGraphType (cbSizeBit, mcs);
 
-  // Get the index of CBSIZE in the map
   NS_LOG_INFO ("For sinr " << sinr << " and mcs " << +mcs <<
                 " CbSizebit " << cbSizeBit << " we got bg type " << m_bgTypeName[bg_type]);
-  auto cbMap = GetSimulatedBlerFromSINR ()->at (bg_type).at (mcs);
-  auto cbIt = cbMap.upper_bound (cbSizeBit);
-
-  if (cbIt != cbMap.begin ())
-    {
-      cbIt--;
-    }
-
-  if (sinr_db < GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).front ())
-    {
-      bler = 1.0;
-    }
-  else if (sinr_db > GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).back ())
-    {
-      bler = 0.0;
-    }
-  else
-    {
-      // Get the index of SINR in the vector
-      auto sinrIt = std::upper_bound (GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin (),
-                                      GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).end (),
-                                      sinr_db);
-
-      if (sinrIt != GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin ())
-        {
-          sinrIt--;
-        }
-
-      auto sinr_index = std::distance (GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin (),
-                                       sinrIt);
-      bler = GetBLERVectorFromSimulatedValues (bg_type, mcs, cbIt->first).at (sinr_index);
-    }
+  double bler = GetBlerLookup ()->GetBler (bg_type, mcs, cbSizeBit, sinr_db);
 
   NS_LOG_LOGIC ("SINR effective: " << sinr << " BLER:" << bler);
   return bler;
@@ -291,9 +245,9 @@ NrEesmErrorModel::GetTbBitDecodificationStats (const SpectrumValue& sinr,
   NS_LOG_FUNCTION (this);
   NS_ABORT_IF (mcs > GetMaxMcs ());
 
-  double tbSinr = SinrEff (sinr, map, mcs, 0, map.size());  // effective SINR for this tx
-  double SINR = tbSinr;
   double sinrExpSum = SinrExp (sinr, map, mcs);  // exponential sum of SINRs for this tx
+  double tbSinr = SinrEffFromExpSum (sinrExpSum, mcs, 0, map.size());  // effective SINR for this tx
+  double SINR = tbSinr;
 
   NS_LOG_DEBUG (" mcs " << +mcs << " TBSize in bit " << sizeBit <<
                 " history elements: " << sinrHistory.size () << " SINR of the tx: " <<
@@ -25,6 +25,7 @@
 namespace ns3 {
 
 class NrL2smEesmTestCase;
+class NrEesmBlerLookup;
 
 /**
  * \ingroup error-models
@@ -193,10 +194,25 @@ protected:
    */
   double SinrEff (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs, double a, double b) const;
 
+  /**
+   * \brief compute the effective SINR for the specified MCS, from an already
+   * computed sum of exponential SINRs (see SinrExp)
+   *
+   * \param sinrExpSum the sum of exponential SINRs of the TB
+   * \param mcs the MCS of the TB
+   * \param a the sum term to the exponential SINR
+   * \param b the denominator for the exponentials sum
+   * \return the effective SINR
+   * \see SinrEff
+   */
+  double SinrEffFromExpSum (double sinrExpSum, uint8_t mcs, double a, double b) const;
+
   /**
    * \brief compute the sum of exponential SINRs for the specified MCS and SINR, according
    * to the EESM method, used in HARQ-IR
    *
+   * The sum is computed by NrEesmSinrKernel, directly over the SINR values.
+   *
    * \param sinr the perceived sinrs in the whole bandwidth (vector, per RB)
    * \param map the actives RBs for the TB
    * \param mcs the MCS of the TB
@@ -246,6 +262,10 @@ protected:
    * \return pointer to a table of BLER vs SINR
    */
   virtual const SimulatedBlerFromSINR * GetSimulatedBlerFromSINR () const = 0;
+  /**
+   * \return pointer to the compiled form of the table of BLER vs SINR
+   */
+  virtual const NrEesmBlerLookup * GetBlerLookup () const = 0;
   /**
    * \return pointer to a static vector that represents the MCS-M table
    */
@@ -321,23 +341,6 @@ private:
    */
   std::pair<uint32_t, uint32_t>
   CodeBlockSegmentation (uint32_t B, GraphType bg_type) const;
-
-  /**
-   * \brief Get SinrDb Vector From Simulated Values
-   * \param graphType
-   * \param mcs
-   * \param cbSizeIndex
-   * \return
-   */
-  const std::vector<double> & GetSinrDbVectorFromSimulatedValues (GraphType graphType, uint8_t mcs, uint32_t cbSizeIndex) const;
-  /**
-   * \brief Get BLER Vector From Simulated Values
-   * \param graphType
-   * \param mcs
-   * \param cbSizeIndex
-   * \return
-   */
-  const std::vector<double> & GetBLERVectorFromSimulatedValues (GraphType graphType, uint8_t mcs, uint32_t cbSizeIndex) const;
 };
 
 
@@ -62,6 +62,12 @@ NrEesmIrT1::GetSimulatedBlerFromSINR() const
   return m_t1.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerLookup *
+NrEesmIrT1::GetBlerLookup() const
+{
+  return m_t1.m_blerLookup;
+}
+
 const std::vector<uint8_t> *
 NrEesmIrT1::GetMcsMTable() const
 {
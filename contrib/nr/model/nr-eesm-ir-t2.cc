@@ -61,6 +61,12 @@ NrEesmIrT2::GetSimulatedBlerFromSINR() const
   return m_t2.m_simulatedBlerFromSINR;
 }
 
+const NrEesmBlerLookup *
+NrEesmIrT2::GetBlerLookup() const
+{
+  return m_t2.m_blerLookup;
+}
+
 const std::vector<uint8_t> *
 NrEesmIrT2::GetMcsMTable() const
 {
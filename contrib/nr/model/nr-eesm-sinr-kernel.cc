@@ -0,0 +1,284 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-eesm-sinr-kernel.h"
+#include <ns3/assert.h>
+#include <ns3/fatal-error.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined (__AVX2__)
+#include <immintrin.h>
+#define NR_EESM_SINR_KERNEL_AVX2
+#endif
+#if defined (__SSE4_1__)
+#include <smmintrin.h>
+#define NR_EESM_SINR_KERNEL_SSE41
+#endif
+
+namespace ns3 {
+
+#if defined (NR_EESM_SINR_KERNEL_AVX2) || defined (NR_EESM_SINR_KERNEL_SSE41)
+/*
+ * Coefficients of the exponential approximation (Cephes exp ()): the argument
+ * is reduced to r = x - n ln2, with |r| <= ln2/2, and
+ * exp (r) = 1 + 2 r P(r^2) / (Q(r^2) - r P(r^2)).
+ */
+static const double EXP_MIN_ARG = -708.39641853226410622; //!< Below this, exp () underflows to 0
+static const double EXP_MAX_ARG = 709.0;                  //!< Upper clamp of the argument
+static const double EXP_LOG2E = 1.4426950408889634073599; //!< 1/ln2
+static const double EXP_C1 = 6.93145751953125E-1;         //!< ln2, high part
+static const double EXP_C2 = 1.42860682030941723212E-6;   //!< ln2, low part
+static const double EXP_P0 = 1.26177193074810590878E-4;   //!< P(x) coefficient
+static const double EXP_P1 = 3.02994407707441961300E-2;   //!< P(x) coefficient
+static const double EXP_P2 = 9.99999999999999999910E-1;   //!< P(x) coefficient
+static const double EXP_Q0 = 3.00198505138664455042E-6;   //!< Q(x) coefficient
+static const double EXP_Q1 = 2.52448340349684104192E-3;   //!< Q(x) coefficient
+static const double EXP_Q2 = 2.27265548208155028766E-1;   //!< Q(x) coefficient
+static const double EXP_Q3 = 2.00000000000000000009E0;    //!< Q(x) coefficient
+#endif
+
+#if defined (NR_EESM_SINR_KERNEL_AVX2)
+/**
+ * \brief Exponential of four doubles
+ * \param x the arguments
+ * \return exp (x)
+ */
+static inline __m256d
+Exp4 (__m256d x)
+{
+  const __m256d underflow = _mm256_cmp_pd (x, _mm256_set1_pd (EXP_MIN_ARG), _CMP_LT_OQ);
+  x = _mm256_min_pd (_mm256_max_pd (x, _mm256_set1_pd (EXP_MIN_ARG)), _mm256_set1_pd (EXP_MAX_ARG));
+
+  const __m256d n = _mm256_round_pd (_mm256_mul_pd (x, _mm256_set1_pd (EXP_LOG2E)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  x = _mm256_sub_pd (x, _mm256_mul_pd (n, _mm256_set1_pd (EXP_C1)));
+  x = _mm256_sub_pd (x, _mm256_mul_pd (n, _mm256_set1_pd (EXP_C2)));
+
+  const __m256d xx = _mm256_mul_pd (x, x);
+  __m256d px = _mm256_add_pd (_mm256_mul_pd (_mm256_set1_pd (EXP_P0), xx), _mm256_set1_pd (EXP_P1));
+  px = _mm256_add_pd (_mm256_mul_pd (px, xx), _mm256_set1_pd (EXP_P2));
+  px = _mm256_mul_pd (px, x);
+  __m256d qx = _mm256_add_pd (_mm256_mul_pd (_mm256_set1_pd (EXP_Q0), xx), _mm256_set1_pd (EXP_Q1));
+  qx = _mm256_add_pd (_mm256_mul_pd (qx, xx), _mm256_set1_pd (EXP_Q2));
+  qx = _mm256_add_pd (_mm256_mul_pd (qx, xx), _mm256_set1_pd (EXP_Q3));
+  x = _mm256_div_pd (px, _mm256_sub_pd (qx, px));
+  x = _mm256_add_pd (_mm256_set1_pd (1.0), _mm256_add_pd (x, x));
+
+  // 2^n, built directly in the exponent field
+  __m128i e = _mm_add_epi32 (_mm256_cvtpd_epi32 (n), _mm_set1_epi32 (1023));
+  __m256i pow2n = _mm256_slli_epi64 (_mm256_cvtepi32_epi64 (e), 52);
+  x = _mm256_mul_pd (x, _mm256_castsi256_pd (pow2n));
+
+  return _mm256_andnot_pd (underflow, x);
+}
+#endif
+
+#if defined (NR_EESM_SINR_KERNEL_SSE41)
+/**
+ * \brief Exponential of two doubles
+ * \param x the arguments
+ * \return exp (x)
+ */
+static inline __m128d
+Exp2 (__m128d x)
+{
+  const __m128d underflow = _mm_cmplt_pd (x, _mm_set1_pd (EXP_MIN_ARG));
+  x = _mm_min_pd (_mm_max_pd (x, _mm_set1_pd (EXP_MIN_ARG)), _mm_set1_pd (EXP_MAX_ARG));
+
+  const __m128d n = _mm_round_pd (_mm_mul_pd (x, _mm_set1_pd (EXP_LOG2E)),
+                                  _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  x = _mm_sub_pd (x, _mm_mul_pd (n, _mm_set1_pd (EXP_C1)));
+  x = _mm_sub_pd (x, _mm_mul_pd (n, _mm_set1_pd (EXP_C2)));
+
+  const __m128d xx = _mm_mul_pd (x, x);
+  __m128d px = _mm_add_pd (_mm_mul_pd (_mm_set1_pd (EXP_P0), xx), _mm_set1_pd (EXP_P1));
+  px = _mm_add_pd (_mm_mul_pd (px, xx), _mm_set1_pd (EXP_P2));
+  px = _mm_mul_pd (px, x);
+  __m128d qx = _mm_add_pd (_mm_mul_pd (_mm_set1_pd (EXP_Q0), xx), _mm_set1_pd (EXP_Q1));
+  qx = _mm_add_pd (_mm_mul_pd (qx, xx), _mm_set1_pd (EXP_Q2));
+  qx = _mm_add_pd (_mm_mul_pd (qx, xx), _mm_set1_pd (EXP_Q3));
+  x = _mm_div_pd (px, _mm_sub_pd (qx, px));
+  x = _mm_add_pd (_mm_set1_pd (1.0), _mm_add_pd (x, x));
+
+  // 2^n, built directly in the exponent field
+  __m128i e = _mm_add_epi32 (_mm_cvtpd_epi32 (n), _mm_set1_epi32 (1023));
+  __m128i pow2n = _mm_slli_epi64 (_mm_cvtepi32_epi64 (e), 52);
+  x = _mm_mul_pd (x, _mm_castsi128_pd (pow2n));
+
+  return _mm_andnot_pd (underflow, x);
+}
+#endif
+
+/**
+ * \brief Scalar implementation of the kernel
+ * \param sinr the SINR values
+ * \param map the indexes of the allocated RBs
+ * \param n the number of allocated RBs
+ * \param beta the EESM beta
+ * \return the sum of the exponential SINRs
+ */
+static double
+SinrExpSumScalar (const double *sinr, const int *map, std::size_t n, double beta)
+{
+  double sum = 0.0;
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      sum += std::exp (-sinr[map[i]] / beta);
+    }
+  return sum;
+}
+
+#if defined (NR_EESM_SINR_KERNEL_AVX2)
+/**
+ * \brief AVX2 implementation of the kernel
+ * \param sinr the SINR values
+ * \param map the indexes of the allocated RBs
+ * \param n the number of allocated RBs
+ * \param beta the EESM beta
+ * \return the sum of the exponential SINRs
+ */
+static double
+SinrExpSumAvx2 (const double *sinr, const int *map, std::size_t n, double beta)
+{
+  const __m256d minusBeta = _mm256_set1_pd (-beta);
+  __m256d acc = _mm256_setzero_pd ();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      __m128i idx = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (map + i));
+      __m256d s = _mm256_i32gather_pd (sinr, idx, 8);
+      acc = _mm256_add_pd (acc, Exp4 (_mm256_div_pd (s, minusBeta)));
+    }
+  __m128d acc2 = _mm_add_pd (_mm256_castpd256_pd128 (acc), _mm256_extractf128_pd (acc, 1));
+  double sum = _mm_cvtsd_f64 (_mm_add_sd (acc2, _mm_unpackhi_pd (acc2, acc2)));
+  return sum + SinrExpSumScalar (sinr, map + i, n - i, beta);
+}
+#endif
+
+#if defined (NR_EESM_SINR_KERNEL_SSE41)
+/**
+ * \brief SSE4.1 implementation of the kernel
+ * \param sinr the SINR values
+ * \param map the indexes of the allocated RBs
+ * \param n the number of allocated RBs
+ * \param beta the EESM beta
+ * \return the sum of the exponential SINRs
+ */
+static double
+SinrExpSumSse41 (const double *sinr, const int *map, std::size_t n, double beta)
+{
+  const __m128d minusBeta = _mm_set1_pd (-beta);
+  __m128d acc = _mm_setzero_pd ();
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    {
+      __m128d s = _mm_set_pd (sinr[map[i + 1]], sinr[map[i]]);
+      acc = _mm_add_pd (acc, Exp2 (_mm_div_pd (s, minusBeta)));
+    }
+  double sum = _mm_cvtsd_f64 (_mm_add_sd (acc, _mm_unpackhi_pd (acc, acc)));
+  return sum + SinrExpSumScalar (sinr, map + i, n - i, beta);
+}
+#endif
+
+/**
+ * \brief Check that an RB map indexes only the given SINR values
+ * \param map the indexes of the allocated RBs
+ * \param n the number of allocated RBs
+ * \param sinrSize the number of SINR values
+ * \return true if all the indexes are in [0, sinrSize)
+ */
+static bool
+IsMapInRange (const int *map, std::size_t n, std::size_t sinrSize)
+{
+  return std::all_of (map, map + n, [sinrSize] (int rb)
+                      { return rb >= 0 && static_cast<std::size_t> (rb) < sinrSize; });
+}
+
+double
+NrEesmSinrKernel::SinrExpSum (const double *sinr, std::size_t sinrSize,
+                              const int *map, std::size_t n, double beta)
+{
+#if defined (NR_EESM_SINR_KERNEL_AVX2)
+  return SinrExpSum (AVX2, sinr, sinrSize, map, n, beta);
+#elif defined (NR_EESM_SINR_KERNEL_SSE41)
+  return SinrExpSum (SSE41, sinr, sinrSize, map, n, beta);
+#else
+  return SinrExpSum (SCALAR, sinr, sinrSize, map, n, beta);
+#endif
+}
+
+double
+NrEesmSinrKernel::SinrExpSum (Implementation impl, const double *sinr, std::size_t sinrSize,
+                              const int *map, std::size_t n, double beta)
+{
+  // The kernels index the SINR values (and gather them) without any check
+  NS_ASSERT_MSG (IsMapInRange (map, n, sinrSize), "RB map out of the " << sinrSize << " SINR values");
+
+  switch (impl)
+    {
+    case SCALAR:
+      return SinrExpSumScalar (sinr, map, n, beta);
+#if defined (NR_EESM_SINR_KERNEL_SSE41)
+    case SSE41:
+      return SinrExpSumSse41 (sinr, map, n, beta);
+#endif
+#if defined (NR_EESM_SINR_KERNEL_AVX2)
+    case AVX2:
+      return SinrExpSumAvx2 (sinr, map, n, beta);
+#endif
+    default:
+      NS_FATAL_ERROR ("The " << GetImplementationName (impl) << " EESM kernel is not compiled");
+    }
+  return 0.0;
+}
+
+std::vector<NrEesmSinrKernel::Implementation>
+NrEesmSinrKernel::GetImplementations ()
+{
+  std::vector<Implementation> impls {SCALAR};
+#if defined (NR_EESM_SINR_KERNEL_SSE41)
+  impls.push_back (SSE41);
+#endif
+#if defined (NR_EESM_SINR_KERNEL_AVX2)
+  impls.push_back (AVX2);
+#endif
+  return impls;
+}
+
+const char *
+NrEesmSinrKernel::GetImplementationName (Implementation impl)
+{
+  switch (impl)
+    {
+    case AVX2:
+      return "avx2";
+    case SSE41:
+      return "sse4.1";
+    default:
+      return "scalar";
+    }
+}
+
+const char *
+NrEesmSinrKernel::GetImplementationName ()
+{
+  return GetImplementationName (GetImplementations ().back ());
+}
+
+} // namespace ns3
@@ -0,0 +1,112 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef NR_EESM_SINR_KERNEL_H
+#define NR_EESM_SINR_KERNEL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup error-models
+ * \brief Kernel of the EESM effective SINR computation
+ *
+ * The EESM effective SINR of a TB is built on the sum of exp (-sinr/beta)
+ * over the RBs allocated to the TB. This class computes that sum directly over
+ * the SINR values (as stored in a SpectrumValue) and the RB map, without
+ * copying any of them.
+ *
+ * The implementations are selected at compile time:
+ *
+ * - with AVX2 available (e.g., when building with NS3_NATIVE_OPTIMIZATIONS on
+ * a recent x86 CPU), the allocated RBs are gathered four at a time and the
+ * exponential is evaluated with a vectorized polynomial approximation;
+ * - with SSE4.1 available, the same is done two RBs at a time;
+ * - a scalar loop based on std::exp, which gives the same results as the
+ * original per-RB implementation, is always compiled.
+ *
+ * SinrExpSum () uses the fastest compiled implementation; the others can be
+ * called explicitly, e.g., to compare them against the scalar one.
+ *
+ * The vectorized exponential has a relative error in the order of 1e-16, but
+ * the vectorized sum accumulates the terms in a different order; therefore,
+ * the results of the SIMD implementations can differ from the scalar one in
+ * the last bits.
+ */
+class NrEesmSinrKernel
+{
+public:
+  /**
+   * \brief The implementations of the kernel
+   */
+  enum Implementation
+  {
+    SCALAR, //!< Scalar loop, always compiled
+    SSE41,  //!< SSE4.1, two RBs at a time
+    AVX2    //!< AVX2, four RBs at a time
+  };
+
+  /**
+   * \brief Compute sum_i exp (-sinr[map[i]] / beta) with the fastest compiled
+   * implementation
+   * \param sinr the SINR values (linear), per RB
+   * \param sinrSize the number of SINR values
+   * \param map the indexes of the allocated RBs, each lower than sinrSize
+   * \param n the number of allocated RBs (size of map)
+   * \param beta the EESM beta
+   * \return the sum of the exponential SINRs
+   */
+  static double SinrExpSum (const double *sinr, std::size_t sinrSize,
+                            const int *map, std::size_t n, double beta);
+
+  /**
+   * \brief Compute sum_i exp (-sinr[map[i]] / beta) with a given implementation
+   * \param impl the implementation, which has to be compiled
+   * \param sinr the SINR values (linear), per RB
+   * \param sinrSize the number of SINR values
+   * \param map the indexes of the allocated RBs, each lower than sinrSize
+   * \param n the number of allocated RBs (size of map)
+   * \param beta the EESM beta
+   * \return the sum of the exponential SINRs
+   */
+  static double SinrExpSum (Implementation impl, const double *sinr, std::size_t sinrSize,
+                            const int *map, std::size_t n, double beta);
+
+  /**
+   * \return the compiled implementations, from the slowest (SCALAR) to the
+   * fastest, which is the one used by SinrExpSum ()
+   */
+  static std::vector<Implementation> GetImplementations ();
+
+  /**
+   * \param impl the implementation
+   * \return the name of the implementation ("avx2", "sse4.1" or "scalar")
+   */
+  static const char * GetImplementationName (Implementation impl);
+
+  /**
+   * \return the name of the implementation used by SinrExpSum ()
+   */
+  static const char * GetImplementationName ();
+};
+
+} // namespace ns3
+
+#endif // NR_EESM_SINR_KERNEL_H
@@ -8185,9 +8185,13 @@ static const std::vector<uint8_t> McsMTable1 = {
 
 NrEesmT1::NrEesmT1 ()
 {
+  // built on first use, then shared
+  static const NrEesmBlerLookup BlerLookup1 (BlerForSinr1);
+
   m_betaTable = &BetaTable1;
   m_mcsEcrTable = &McsEcrTable1;
   m_simulatedBlerFromSINR = &BlerForSinr1;
+  m_blerLookup = &BlerLookup1;
   m_mcsMTable = &McsMTable1;
   m_spectralEfficiencyForMcs = &SpectralEfficiencyForMcs1;
   m_spectralEfficiencyForCqi = &SpectralEfficiencyForCqi1;
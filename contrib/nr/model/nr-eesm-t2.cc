@@ -7481,9 +7481,13 @@ static const NrEesmErrorModel::SimulatedBlerFromSINR BlerForSinr2 = {
 
 NrEesmT2::NrEesmT2 ()
 {
+  // built on first use, then shared
+  static const NrEesmBlerLookup BlerLookup2 (BlerForSinr2);
+
   m_betaTable = &BetaTable2;
   m_mcsEcrTable = &McsEcrTable2;
   m_simulatedBlerFromSINR = &BlerForSinr2;
+  m_blerLookup = &BlerLookup2;
   m_mcsMTable = &McsMTable2;
   m_spectralEfficiencyForMcs = &SpectralEfficiencyForMcs2;
   m_spectralEfficiencyForCqi = &SpectralEfficiencyForCqi2;
@@ -21,6 +21,7 @@
 
 #include <vector>
 #include "nr-eesm-error-model.h"
+#include "nr-eesm-bler-lookup.h"
 
 namespace ns3 {
 
@@ -51,6 +52,7 @@ struct NrEesmT2
   const std::vector<double> *m_betaTable {nullptr};  //!< Beta table
   const std::vector<double> *m_mcsEcrTable {nullptr}; //!< MCS-ECR table
   const NrEesmErrorModel::SimulatedBlerFromSINR *m_simulatedBlerFromSINR {nullptr}; //!< BLER from SINR table
+  const NrEesmBlerLookup *m_blerLookup {nullptr}; //!< Compiled BLER from SINR table, shared by all instances
   const std::vector<uint8_t> *m_mcsMTable {nullptr}; //!< MCS-M table
   const std::vector<double> *m_spectralEfficiencyForMcs {nullptr}; //!< Spectral-efficiency for MCS
   const std::vector<double> *m_spectralEfficiencyForCqi {nullptr}; //!< Spectral-efficiency for CQI
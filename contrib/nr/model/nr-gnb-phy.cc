@@ -516,6 +516,8 @@ NrGnbPhy::StartEventLoop (uint16_t frame, uint8_t subframe, uint16_t slot)
                 "\t Num. RB: " << GetRbNum ());
   SfnSf startSlot (frame, subframe, slot, GetNumerology ());
   InitializeMessageList ();
+  // The MAC schedules L1L2CtrlLatency slots in advance, plus the K delays
+  ReserveSlotAllocHorizon (GetL1L2CtrlLatency () + std::max ({m_n0Delay, m_n1Delay, m_n2Delay}));
   StartSlot (startSlot);
 }
 
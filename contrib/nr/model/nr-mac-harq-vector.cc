@@ -23,18 +23,14 @@ namespace ns3 {
 bool
 NrMacHarqVector::Erase (uint8_t id)
 {
-  at (id).Erase ();
-  --m_usedSize;
-
-  uint32_t count = 0;
-  for (const auto & v : *this)
+  NS_ASSERT (Exist (id));
+  NS_ASSERT (IsActive (id) == m_processes[id].second.m_active);
+  m_processes[id].second.Erase ();
+  if (IsActive (id))
     {
-      if (v.second.m_active)
-        {
-          ++count;
-        }
+      m_activeMask &= ~(1ULL << id);
+      --m_usedSize;
     }
-  NS_ASSERT (count == m_usedSize);
   return true;
 }
 
@@ -54,10 +50,10 @@ NrMacHarqVector::Insert (uint8_t *id, const HarqProcess& element)
       return false;
     }
 
-  NS_ABORT_IF (at (*id).m_active == true);
-  at (*id) = element;
+  NS_ABORT_IF (m_processes[*id].second.m_active == true);
+  m_processes[*id].second = element;
+  m_activeMask |= 1ULL << *id;
 
-  NS_ABORT_IF (at (*id).m_active == false);
   NS_ABORT_IF (this->FirstAvailableId () == *id);
 
   ++m_usedSize;
@@ -67,7 +63,7 @@ NrMacHarqVector::Insert (uint8_t *id, const HarqProcess& element)
 std::ostream &
 operator<< (std::ostream & os, NrMacHarqVector const & item)
 {
-  for (const auto & p : item)
+  for (const auto & p : item.m_processes)
     {
       os << "Process ID " << static_cast<uint32_t> (p.first)
          << ": " << p.second << std::endl;
@@ -18,7 +18,8 @@
  */
 #pragma once
 
-#include <unordered_map>
+#include <vector>
+#include <utility>
 #include "nr-mac-harq-process.h"
 
 namespace ns3 {
@@ -27,29 +28,38 @@ namespace ns3 {
  * \ingroup scheduler
  * \brief Data structure to save all the HARQ process of an UE
  *
- * The data is stored as an unordered_map between the process ID and the
- * real data, saved in the structure HarqProcess. The vector (yes, it is an
- * improper name) is always full (i.e., it always contains almost 20 HARQ processes)
- * but they can be inactive (i.e., no data is stored there). The duty of finding
- * an empty spot is split between Insert and FirstAvailableId.
+ * The processes are stored in an array, allocated once by SetMaxSize(), of
+ * pairs between the process ID and the real data, saved in the structure
+ * HarqProcess. The element of a process is at the position of its ID, so that
+ * finding a process is a direct access; the iterators to the elements stay
+ * valid for the whole life of the vector. The vector is always full (i.e., it
+ * always contains the configured number of HARQ processes, 20 by default) but
+ * they can be inactive (i.e., no data is stored there). A bitmask keeps track
+ * of the active processes: checking if a process can be inserted, or finding
+ * an empty spot, does not need to look at the processes themselves.
  *
  * The class does not support going "out of space", or in other words, if all
  * the spots are filled with active processes, the next insert will fail.
  *
  * \see HarqProcess
  */
-class NrMacHarqVector : private std::unordered_map<uint8_t, HarqProcess>
+class NrMacHarqVector
 {
 public:
   friend std::ostream &  operator<< (std::ostream & os, NrMacHarqVector const & item);
   /**
-   * \brief iterator of the map
+   * \brief iterator of the vector
    */
-  typedef typename std::unordered_map<uint8_t, HarqProcess>::iterator iterator;
+  typedef typename std::vector<std::pair<uint8_t, HarqProcess>>::iterator iterator;
   /**
-   * \brief const_iterator of the map
+   * \brief const_iterator of the vector
    */
-  typedef typename std::unordered_map<uint8_t, HarqProcess>::const_iterator const_iterator;
+  typedef typename std::vector<std::pair<uint8_t, HarqProcess>>::const_iterator const_iterator;
+
+  /**
+   * \brief Maximum number of processes (the size of the bitmask)
+   */
+  static const uint8_t MAX_SIZE = 64;
 
   /**
     * \brief Default constructor
@@ -60,15 +70,18 @@ public:
    * \brief Set and reserve the size of the vector
    * \param size the vector size
    *
-   * The method will reserve and create the necessary processes.
+   * The method will reserve and create the necessary processes. It must be
+   * called once, before any other method.
    */
   void SetMaxSize (uint8_t size)
   {
+    NS_ABORT_MSG_IF (size > MAX_SIZE, "At most " << +MAX_SIZE << " HARQ processes are supported");
+    NS_ASSERT (m_processes.empty ());
     m_maxSize = size;
-    reserve (size);
+    m_processes.reserve (size);
     for (auto i = 0; i < size; ++i)
       {
-        emplace (i, HarqProcess ());
+        m_processes.emplace_back (i, HarqProcess ());
       }
   }
 
@@ -95,7 +108,17 @@ public:
   const iterator
   Find (uint8_t key)
   {
-    return this->find (key);
+    return Exist (key) ? m_processes.begin () + key : m_processes.end ();
+  }
+  /**
+   * \brief Find a process
+   * \param key ID of the process to find
+   * \return a const iterator to the process
+   */
+  const_iterator
+  Find (uint8_t key) const
+  {
+    return Exist (key) ? m_processes.cbegin () + key : m_processes.cend ();
   }
   /**
    * \brief Begin of the vector
@@ -104,7 +127,7 @@ public:
   const iterator
   Begin ()
   {
-    return this->begin ();
+    return m_processes.begin ();
   }
   /**
    * \brief End of the vector
@@ -113,36 +136,35 @@ public:
   const iterator
   End ()
   {
-    return this->end ();
+    return m_processes.end ();
   }
   /**
    * \brief Const begin of the vector
    * \return a const iterator to the first element
    */
   const_iterator
-  CBegin ()
+  CBegin () const
   {
-    return this->cbegin ();
+    return m_processes.cbegin ();
   }
   /**
    * \brief Const end of the vector
    * \return a const iterator to the end() element
    */
   const_iterator
-  CEnd ()
+  CEnd () const
   {
-    return this->cend ();
+    return m_processes.cend ();
   }
   /**
-   * \brief Check if the ID exists in the map
+   * \brief Check if the ID exists in the vector
    * \param id ID to check
    * \return true if the ID exists, false if the ID is outside the maximum number
    * of stored elements
    */
   bool Exist (uint8_t id) const
   {
-    // could be id > max_size?
-    return find (id) != end ();
+    return id < m_processes.size ();
   }
   /**
    * \brief Get a reference to a process
@@ -152,7 +174,7 @@ public:
   HarqProcess & Get (uint8_t id)
   {
     NS_ASSERT (Exist (id));
-    return find (id)->second;
+    return m_processes[id].second;
   }
   /**
    * \brief Get a const reference to a process
@@ -162,19 +184,40 @@ public:
   const HarqProcess & Get (uint8_t id) const
   {
     NS_ASSERT (Exist (id));
-    return find (id)->second;
+    return m_processes[id].second;
+  }
+  /**
+   * \brief Check if a process is active
+   * \param id ID of the process
+   * \return true if the process identified by the parameter id is active
+   */
+  bool IsActive (uint8_t id) const
+  {
+    NS_ASSERT (Exist (id));
+    return (m_activeMask >> id) & 1;
+  }
+  /**
+   * \brief Get the bitmask of the active processes
+   * \return a bitmask in which the bit i is set if the process i is active
+   */
+  uint64_t GetActiveMask () const
+  {
+    return m_activeMask;
   }
   /**
    * \brief Find the first (INACTIVE) ID
    * \return an usable ID, or 255 in case no ID are available
+   *
+   * The IDs are scanned from the highest one, the order in which the
+   * processes were visited when they were stored in a hash map.
    */
   uint8_t FirstAvailableId () const
   {
-    for (const auto & it : *this)
+    for (int id = m_maxSize - 1; id >= 0; --id)
       {
-        if (!it.second.m_active)
+        if (((m_activeMask >> id) & 1) == 0)
           {
-            return it.first;
+            return static_cast<uint8_t> (id);
           }
       }
     return 255;
@@ -197,6 +240,8 @@ public:
   }
 
 private:
+  std::vector<std::pair<uint8_t, HarqProcess>> m_processes; //!< The processes, indexed by their ID
+  uint64_t m_activeMask {0}; //!< Bitmask of the ACTIVE processes
   uint8_t m_maxSize  {0}; //!< Maximum size (or the number of processes stored)
   uint8_t m_usedSize {0}; //!< Number of ACTIVE processes
 };
@@ -0,0 +1,135 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-mac-scheduler-cg-planner.h"
+#include <ns3/log.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrMacSchedulerCgPlanner");
+
+NrMacSchedulerCgPlanner::NrMacSchedulerCgPlanner (const Ptr<const NrAmc> &amc,
+                                                  uint32_t rbgInOneSymbol)
+  : m_amc (amc),
+    m_rbgInOneSymbol (rbgInOneSymbol)
+{
+  NS_LOG_FUNCTION (this << rbgInOneSymbol);
+  NS_ASSERT (amc != nullptr);
+
+  // Feasible widths: each divisor and its complement, skipping the widths
+  // already found. If the RBGs are a prime number, one RBG is left out.
+  for (uint32_t tiled : {rbgInOneSymbol, rbgInOneSymbol - 1})
+    {
+      for (uint32_t width = 2; width < tiled; ++width)
+        {
+          if (tiled % width == 0
+              && std::find (m_rbgWidths.begin (), m_rbgWidths.end (), width) == m_rbgWidths.end ())
+            {
+              m_rbgWidths.push_back (width);
+              m_rbgWidths.push_back (tiled / width);
+              NS_LOG_DEBUG ("Feasible RBG widths: " << width << " and " << tiled / width);
+            }
+        }
+      m_tiledRbg = tiled;
+      if (! m_rbgWidths.empty ())
+        {
+          m_defaultWidth = tiled;
+          break;
+        }
+    }
+}
+
+bool
+NrMacSchedulerCgPlanner::IsValidFor (const Ptr<const NrAmc> &amc, uint32_t rbgInOneSymbol) const
+{
+  return m_amc == amc && m_rbgInOneSymbol == rbgInOneSymbol;
+}
+
+uint32_t
+NrMacSchedulerCgPlanner::GetPacketRb (uint8_t mcs, uint32_t bytes)
+{
+  if (bytes == 0)
+    {
+      return 2;
+    }
+
+  uint64_t key = (static_cast<uint64_t> (mcs) << 32) | bytes;
+  auto it = m_packetRb.find (key);
+  if (it != m_packetRb.end ())
+    {
+      return it->second;
+    }
+
+  // At least 2 RBs; the loop only runs if the TB size is not monotone
+  uint32_t rb = std::max (m_amc->GetMinNumRbForBytes (mcs, bytes), 2u);
+  while (m_amc->CalculateTbSize (mcs, rb) < bytes)
+    {
+      ++rb;
+    }
+  m_packetRb.emplace (key, rb + 1);
+  return rb + 1;
+}
+
+uint32_t
+NrMacSchedulerCgPlanner::GetRbgWidth (uint32_t numUes, uint32_t packetRb)
+{
+  numUes = std::max (numUes, 1u);
+  auto key = std::make_pair (numUes, packetRb);
+  auto it = m_width.find (key);
+  if (it != m_width.end ())
+    {
+      return it->second;
+    }
+
+  uint32_t width = m_defaultWidth;
+  uint32_t minWaste = 1000;
+  for (uint32_t w : m_rbgWidths)
+    {
+      // Groups per UE in a symbol, and symbols to transmit the packet
+      uint32_t groups = std::max ((m_tiledRbg / numUes) / w, 1u);
+      uint32_t numSym = (packetRb + w * groups - 1) / (w * groups);
+      uint32_t waste = w * groups * numSym - packetRb;
+
+      // Only if the packet enters in less than one slot
+      if (waste < minWaste && numSym < 12)
+        {
+          width = w;
+          minWaste = waste;
+        }
+    }
+
+  NS_LOG_DEBUG ("Layout of " << numUes << " UEs with packets of " << packetRb <<
+                " RBs: groups of " << width << " RBGs, wasting " << minWaste << " RBs");
+  m_width.emplace (key, width);
+  return width;
+}
+
+const std::vector<uint32_t> &
+NrMacSchedulerCgPlanner::GetRbgWidths () const
+{
+  return m_rbgWidths;
+}
+
+uint32_t
+NrMacSchedulerCgPlanner::GetTiledRbg () const
+{
+  return m_tiledRbg;
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#pragma once
+
+#include "nr-amc.h"
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief Plan of the RB-OFDMA configured grant allocations
+ *
+ * The RB-OFDMA access mode (attribute schOFDMA of NrMacSchedulerOfdma equal to
+ * 3) tiles the UL RBGs of a symbol in groups of the same width, and gives each
+ * configured UE the groups that it needs, symbol after symbol. The width is
+ * chosen to waste the least RBs for the packet of the UEs: this class
+ * precomputes everything that the choice needs, so that scheduling a CG slot
+ * is a lookup:
+ *
+ * - the minimum number of RBs for a packet of each MCS and size, from the
+ * TB size table of the AMC (see NrAmc::GetMinNumRbForBytes);
+ * - the feasible group widths: the divisors of the RBGs in a symbol (or of
+ * the RBGs minus one, if they are a prime number), in the order in which
+ * they are tried;
+ * - the width of the layout for each number of UEs and packet size, solved
+ * the first time that the pair is seen.
+ *
+ * The plan is valid for an AMC and a number of RBGs: NrMacSchedulerOfdma
+ * builds a new one when any of the two changes.
+ */
+class NrMacSchedulerCgPlanner
+{
+public:
+  /**
+   * \brief Build the plan
+   * \param amc the UL AMC
+   * \param rbgInOneSymbol the (not notched) RBGs in a symbol
+   */
+  NrMacSchedulerCgPlanner (const Ptr<const NrAmc> &amc, uint32_t rbgInOneSymbol);
+
+  /**
+   * \brief Check if the plan has been built for an AMC and a number of RBGs
+   * \param amc the UL AMC
+   * \param rbgInOneSymbol the RBGs in a symbol
+   * \return true if the plan can be used
+   */
+  bool IsValidFor (const Ptr<const NrAmc> &amc, uint32_t rbgInOneSymbol) const;
+
+  /**
+   * \brief Get the RBs that a packet needs
+   *
+   * The value is one more than the minimum number of RBs (at least 2) whose
+   * TB contains the packet: it is the result of the linear search of the
+   * first RB-OFDMA implementation, that the layouts keep reproducing.
+   *
+   * \param mcs the MCS of the UE
+   * \param bytes the bytes of the packet
+   * \return the RBs of the packet
+   */
+  uint32_t GetPacketRb (uint8_t mcs, uint32_t bytes);
+
+  /**
+   * \brief Get the width of the RBG groups for a layout
+   *
+   * The width is the feasible one for which the packet, spread over
+   * the groups of its UE, takes less than 12 symbols and wastes the least
+   * RBs. With no such width, the groups take all the tiled RBGs.
+   *
+   * \param numUes the number of UEs that share the symbols
+   * \param packetRb the RBs of the packet (see GetPacketRb)
+   * \return the width, in RBGs
+   */
+  uint32_t GetRbgWidth (uint32_t numUes, uint32_t packetRb);
+
+  /**
+   * \return the feasible widths of the RBG groups
+   */
+  const std::vector<uint32_t> & GetRbgWidths () const;
+
+  /**
+   * \return the RBGs tiled by the groups
+   */
+  uint32_t GetTiledRbg () const;
+
+private:
+  Ptr<const NrAmc> m_amc;                   //!< The AMC
+  uint32_t m_rbgInOneSymbol {0};            //!< RBGs in a symbol
+  uint32_t m_tiledRbg {0};                  //!< RBGs tiled by the groups
+  uint32_t m_defaultWidth {2};              //!< Width if no feasible width fits the packet
+  std::vector<uint32_t> m_rbgWidths;        //!< Feasible widths, in the order of the search
+  std::unordered_map<uint64_t, uint32_t> m_packetRb;    //!< RBs per (MCS, bytes)
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> m_width; //!< Width per (UEs, packet RBs)
+};
+
+} // namespace ns3
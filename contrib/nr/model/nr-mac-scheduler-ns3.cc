@@ -569,6 +569,8 @@ NrMacSchedulerNs3::DoCschedUeReleaseReq (const NrMacCschedSapProvider::CschedUeR
   NS_ABORT_IF (itUe == m_ueMap.end ());
 
   m_schedulerSrs->RemoveUe (itUe->second->m_srsOffset);
+  RemoveBufferedUe (&m_dlBufferedUe, params.m_rnti);
+  RemoveBufferedUe (&m_ulBufferedUe, params.m_rnti);
   m_ueMap.erase (itUe);
 
   // When it will be the case of reducing the periodicity? Question for the
@@ -731,6 +733,7 @@ NrMacSchedulerNs3::DoSchedDlRlcBufferReq (const NrMacSchedSapProvider::SchedDlRl
           NS_LOG_INFO ("Updating DL LC Info: " << params <<
                        " in LCG: " << static_cast<uint32_t> (lcg.first));
           lcg.second->UpdateInfo (params);
+          InsertBufferedUe (&m_dlBufferedUe, itUe->second);
           return;
         }
     }
@@ -783,6 +786,8 @@ NrMacSchedulerNs3::BSRReceivedFromUe (const MacCeElement &bsr)
 
       itLcg->second->UpdateInfo (bufSize);
     }
+
+  InsertBufferedUe (&m_ulBufferedUe, itUe->second);
 }
 
 /**
@@ -1237,27 +1242,33 @@ NrMacSchedulerNs3::ComputeActiveHarq (ActiveHarqMap *activeUlHarq,
 
 /**
  * \brief Compute the number of active DL and UL UE
- * \param activeDlUe map of active DL UE to be filled
+ * \param activeUe map of active UE to be filled
+ * \param bufferedUe UEs that may have data, ordered by RNTI
  * \param GetLCGFn Function to retrieve the LCG of a UE
+ * \param GetHarqVector Function to retrieve the HARQ vector of a UE
  * \param mode UL or DL (to be printed in debug messages)
  *
- * The function loops all available UEs and checks their LC. If one (or more)
- * LC contains bytes, they are marked active and inserted in one of the
- * list passed as input parameters. Every UE is marked as active if it has
- * data to transmit; it is a duty for someone else to not assign two DCI for
- * the same RNTI.
+ * The function loops the UEs that received data since they were last found
+ * empty, and checks their LC. If one (or more) LC contains bytes, they are
+ * marked active and inserted in one of the list passed as input parameters.
+ * The UEs without data are removed from bufferedUe: they will be inserted
+ * again when a buffer report arrives. Therefore, the cost of the function
+ * depends on the UEs that have data, and not on all the attached UEs.
+ * Every UE is marked as active if it has data to transmit; it is a duty for
+ * someone else to not assign two DCI for the same RNTI.
  */
 void
 NrMacSchedulerNs3::ComputeActiveUe (ActiveUeMap *activeUe,
-                                        const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn,
-                                        const NrMacSchedulerUeInfo::GetHarqVectorFn &GetHarqVector,
-                                        const std::string &mode) const
+                                    std::vector<UePtr> *bufferedUe,
+                                    const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn,
+                                    const NrMacSchedulerUeInfo::GetHarqVectorFn &GetHarqVector,
+                                    const std::string &mode) const
 {
   NS_LOG_FUNCTION (this);
-  for (const auto &ueInfo : m_ueMap)
+  auto last = bufferedUe->begin ();
+  for (const auto &ue : *bufferedUe)
     {
       uint32_t totBuffer = 0;
-      const auto & ue = ueInfo.second;
 
       // compute total DL and UL bytes buffered
       for (const auto & lcgInfo : GetLCGFn (ue))
@@ -1272,16 +1283,27 @@ NrMacSchedulerNs3::ComputeActiveUe (ActiveUeMap *activeUe,
           totBuffer += lcg->GetTotalSize ();
         }
 
-      auto harqV = GetHarqVector (ue);
+      if (totBuffer == 0)
+        {
+          continue;
+        }
+      *last++ = ue;
 
-      if (totBuffer > 0 && harqV.CanInsert ())
+      const auto & harqV = GetHarqVector (ue);
+
+      if (harqV.CanInsert ())
         {
           auto it = activeUe->find (ue->m_beamConfId);
           if (it == activeUe->end ())
             {
-              std::vector<std::pair<std::shared_ptr<NrMacSchedulerUeInfo>, uint32_t> > tmp;
+              std::vector<UePtrAndBufferReq> tmp;
+              if (! m_activeUeVectors.empty ())
+                {
+                  tmp = std::move (m_activeUeVectors.back ());
+                  m_activeUeVectors.pop_back ();
+                }
               tmp.emplace_back (ue, totBuffer);
-              activeUe->insert (std::make_pair (ue->m_beamConfId, tmp));
+              activeUe->insert (std::make_pair (ue->m_beamConfId, std::move (tmp)));
             }
           else
             {
@@ -1289,6 +1311,40 @@ NrMacSchedulerNs3::ComputeActiveUe (ActiveUeMap *activeUe,
             }
         }
     }
+  bufferedUe->erase (last, bufferedUe->end ());
+}
+
+void
+NrMacSchedulerNs3::InsertBufferedUe (std::vector<UePtr> *bufferedUe, const UePtr &ue)
+{
+  auto it = std::lower_bound (bufferedUe->begin (), bufferedUe->end (), ue->m_rnti,
+                              [] (const UePtr &a, uint16_t rnti) { return a->m_rnti < rnti; });
+  if (it == bufferedUe->end () || (*it)->m_rnti != ue->m_rnti)
+    {
+      bufferedUe->insert (it, ue);
+    }
+}
+
+void
+NrMacSchedulerNs3::RemoveBufferedUe (std::vector<UePtr> *bufferedUe, uint16_t rnti)
+{
+  auto it = std::lower_bound (bufferedUe->begin (), bufferedUe->end (), rnti,
+                              [] (const UePtr &a, uint16_t r) { return a->m_rnti < r; });
+  if (it != bufferedUe->end () && (*it)->m_rnti == rnti)
+    {
+      bufferedUe->erase (it);
+    }
+}
+
+void
+NrMacSchedulerNs3::ReleaseActiveUe (ActiveUeMap *activeUe) const
+{
+  for (auto &beam : *activeUe)
+    {
+      beam.second.clear ();
+      m_activeUeVectors.emplace_back (std::move (beam.second));
+    }
+  activeUe->clear ();
 }
 
 /**
@@ -1904,11 +1960,12 @@ NrMacSchedulerNs3::ScheduleDl (const NrMacSchedSapProvider::SchedDlTriggerReqPar
   ComputeActiveHarq (&activeDlHarq, dlHarqFeedback);
 
   ActiveUeMap activeDlUe;
-  ComputeActiveUe (&activeDlUe, &NrMacSchedulerUeInfo::GetDlLCG,
+  ComputeActiveUe (&activeDlUe, &m_dlBufferedUe, &NrMacSchedulerUeInfo::GetDlLCG,
                    &NrMacSchedulerUeInfo::GetDlHarqVector, "DL");
 
   DoScheduleDl (dlHarqFeedback, activeDlHarq, &activeDlUe, params.m_snfSf,
                 ulAllocations, &dlSlot.m_slotAllocInfo, params.m_slotType);
+  ReleaseActiveUe (&activeDlUe);
 
   // if the number of allocated symbols is greater than GetUlCtrlSymbols (), then don't delete
   // the allocation, as it will be removed when the CQI will be processed.
@@ -2116,10 +2173,14 @@ NrMacSchedulerNs3::DoScheduleUl (const std::vector <UlHarqInfo> &ulHarqFeedback,
      {
        DoScheduleUlSr (&ulAssignationStartPoint, m_srList);
       }
+     for (const auto & rnti : m_srList)
+       {
+         InsertBufferedUe (&m_ulBufferedUe, m_ueMap.at (rnti));
+       }
      m_srList.clear ();
    }
   ActiveUeMap activeUlUe;
-  ComputeActiveUe (&activeUlUe, &NrMacSchedulerUeInfo::GetUlLCG,
+  ComputeActiveUe (&activeUlUe, &m_ulBufferedUe, &NrMacSchedulerUeInfo::GetUlLCG,
                    &NrMacSchedulerUeInfo::GetUlHarqVector, "UL");
 
   GetSecond GetUeInfoList;
@@ -2154,6 +2215,7 @@ NrMacSchedulerNs3::DoScheduleUl (const std::vector <UlHarqInfo> &ulHarqFeedback,
                    static_cast<uint32_t> (usedUl) << " symbols for UL data tx");
       ulSymAvail -= usedUl;
     }
+  ReleaseActiveUe (&activeUlUe);
 
   std::vector<uint32_t> symToAl;
   symToAl.resize (15, 0);
@@ -2307,6 +2369,13 @@ NrMacSchedulerNs3::GetBandwidthInRbg() const
   return m_bandwidth;
 }
 
+std::shared_ptr<NrMacSchedulerUeInfo>
+NrMacSchedulerNs3::GetUeInfo (uint16_t rnti) const
+{
+  auto it = m_ueMap.find (rnti);
+  return it != m_ueMap.end () ? it->second : nullptr;
+}
+
 /**
  * \brief Schedule DL HARQ and data
  * \param dlSfnSf Slot number
@@ -32,6 +32,7 @@
 namespace ns3 {
 
 class NrSchedGeneralTestCase;
+class NrSchedBufferedUeTestCase;
 class NrMacSchedulerHarqRr;
 class NrMacSchedulerSrsDefault;
 
@@ -861,9 +862,6 @@ private:
                           std::deque<VarTtiAllocInfo> *allocations) const;
 
 
-  void ComputeActiveUe (ActiveUeMap *activeDlUe, const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn,
-                        const NrMacSchedulerUeInfo::GetHarqVectorFn &GetHarqVector,
-                        const std::string &mode) const;
   void ComputeActiveHarq (ActiveHarqMap *activeDlHarq, const std::vector <DlHarqInfo> &dlHarqFeedback) const;
   void ComputeActiveHarq (ActiveHarqMap *activeUlHarq, const std::vector <UlHarqInfo> &ulHarqFeedback) const;
 
@@ -884,6 +882,24 @@ private:
   static const uint32_t m_subHdrSize = 4;  //!< Sub Header size (?)
   static const unsigned m_rlcHdrSize = 3;  //!< RLC Header size
 
+  /**
+   * \brief Insert a UE in a list of UEs that may have data, if not present
+   * \param bufferedUe the list, ordered by RNTI
+   * \param ue the UE
+   */
+  static void InsertBufferedUe (std::vector<UePtr> *bufferedUe, const UePtr &ue);
+  /**
+   * \brief Remove a UE from a list of UEs that may have data
+   * \param bufferedUe the list, ordered by RNTI
+   * \param rnti the RNTI of the UE
+   */
+  static void RemoveBufferedUe (std::vector<UePtr> *bufferedUe, uint16_t rnti);
+  /**
+   * \brief Give back the vectors of an active UE map, to reuse them in the next slots
+   * \param activeUe the map, that is cleared
+   */
+  void ReleaseActiveUe (ActiveUeMap *activeUe) const;
+
   //Configured Grant
   void DoScheduleUlresources_configuredGrant (PointInFTPlane *spoint, const std::list<uint16_t> &rntiList) const;
 
@@ -905,8 +921,32 @@ protected:
    */
   uint16_t GetBandwidthInRbg () const;
 
+  /**
+   * \brief Get the representation of an UE
+   * \param rnti the RNTI of the UE
+   * \return the UE representation, or nullptr if the UE is not known
+   */
+  std::shared_ptr<NrMacSchedulerUeInfo> GetUeInfo (uint16_t rnti) const;
+
+  /**
+   * \brief Compute the UEs that have data to transmit and a free HARQ process
+   * \param activeDlUe map of active UE to be filled, grouped by beam
+   * \param bufferedUe UEs that may have data, ordered by RNTI; the ones that
+   * have no data anymore are removed
+   * \param GetLCGFn Function to retrieve the LCG of a UE
+   * \param GetHarqVector Function to retrieve the HARQ vector of a UE
+   * \param mode UL or DL (to be printed in debug messages)
+   */
+  void ComputeActiveUe (ActiveUeMap *activeDlUe, std::vector<UePtr> *bufferedUe,
+                        const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn,
+                        const NrMacSchedulerUeInfo::GetHarqVectorFn &GetHarqVector,
+                        const std::string &mode) const;
+
 private:
   std::unordered_map<uint16_t, std::shared_ptr<NrMacSchedulerUeInfo> > m_ueMap; //!< The map of between RNTI and their data
+  std::vector<UePtr> m_dlBufferedUe; //!< UEs that may have DL data, ordered by RNTI
+  std::vector<UePtr> m_ulBufferedUe; //!< UEs that may have UL data, ordered by RNTI
+  mutable std::vector<std::vector<UePtrAndBufferReq> > m_activeUeVectors; //!< Vectors of the active UE maps, kept for reuse
 
   /**
    * Map of previous allocated UE per RBG
@@ -947,6 +987,7 @@ private:
   uint32_t m_srsSlotCounter {0}; //!< Counter for UL slots
 
   friend NrSchedGeneralTestCase;
+  friend NrSchedBufferedUeTestCase;
 
   bool m_enableHarqReTx  {true}; //!< Flag to enable or disable HARQ ReTx (attribute)
  
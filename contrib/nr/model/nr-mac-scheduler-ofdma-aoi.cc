@@ -0,0 +1,63 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-mac-scheduler-ofdma-aoi.h"
+#include "nr-mac-scheduler-ue-info-edf.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrMacSchedulerOfdmaAoI");
+NS_OBJECT_ENSURE_REGISTERED (NrMacSchedulerOfdmaAoI);
+
+TypeId
+NrMacSchedulerOfdmaAoI::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NrMacSchedulerOfdmaAoI")
+    .SetParent<NrMacSchedulerOfdmaEdf> ()
+    .AddConstructor<NrMacSchedulerOfdmaAoI> ()
+  ;
+  return tid;
+}
+
+NrMacSchedulerOfdmaAoI::NrMacSchedulerOfdmaAoI () : NrMacSchedulerOfdmaEdf ()
+{
+}
+
+Time
+NrMacSchedulerOfdmaAoI::GetAgePriority (const Time &arrival, const Time &lastDelivered)
+{
+  // Data without a known generation time is assumed to be just generated
+  Time generated = arrival == Time::Max () ? Simulator::Now () : arrival;
+  return lastDelivered - generated;
+}
+
+Time
+NrMacSchedulerOfdmaAoI::GetDlPriority (const NrMacSchedulerUeInfoEdf &ue) const
+{
+  return GetAgePriority (ue.m_dlArrival, ue.m_dlLastDelivered);
+}
+
+Time
+NrMacSchedulerOfdmaAoI::GetUlPriority (const NrMacSchedulerUeInfoEdf &ue) const
+{
+  return GetAgePriority (ue.m_ulArrival, ue.m_ulLastDelivered);
+}
+
+} // namespace ns3
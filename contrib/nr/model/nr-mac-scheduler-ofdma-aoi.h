@@ -0,0 +1,82 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#pragma once
+
+#include "nr-mac-scheduler-ofdma-edf.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief Assign frequencies to maximize the reduction of the age of information
+ *
+ * The age of information of an UE is the time elapsed since the generation
+ * of the last data that has been scheduled for it. Serving an UE reduces
+ * its age by the difference between the generation time of its oldest
+ * pending data and the generation time of the data scheduled for last:
+ * the scheduler greedily serves first the UEs with the largest reduction.
+ *
+ * The generation times are tracked as in NrMacSchedulerOfdmaEdf, which
+ * this class extends only by redefining the priorities.
+ */
+class NrMacSchedulerOfdmaAoI : public NrMacSchedulerOfdmaEdf
+{
+public:
+  /**
+   * \brief GetTypeId
+   * \return The TypeId of the class
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief NrMacSchedulerOfdmaAoI constructor
+   */
+  NrMacSchedulerOfdmaAoI ();
+
+  /**
+   * \brief ~NrMacSchedulerOfdmaAoI deconstructor
+   */
+  virtual ~NrMacSchedulerOfdmaAoI () override
+  {
+  }
+
+protected:
+  /**
+   * \brief Get the DL priority of an UE: the opposite of its age reduction
+   * \param ue the UE
+   * \return the priority (lower values are served first)
+   */
+  virtual Time GetDlPriority (const NrMacSchedulerUeInfoEdf &ue) const override;
+  /**
+   * \brief Get the UL priority of an UE: the opposite of its age reduction
+   * \param ue the UE
+   * \return the priority (lower values are served first)
+   */
+  virtual Time GetUlPriority (const NrMacSchedulerUeInfoEdf &ue) const override;
+
+private:
+  /**
+   * \brief Compute the priority from the generation times
+   * \param arrival generation time of the oldest pending data
+   * \param lastDelivered generation time of the last data scheduled
+   * \return the priority
+   */
+  static Time GetAgePriority (const Time &arrival, const Time &lastDelivered);
+};
+
+} // namespace ns3
@@ -0,0 +1,362 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-mac-scheduler-ofdma-edf.h"
+#include "nr-mac-scheduler-ue-info-edf.h"
+#include "nr-mac-short-bsr-ce.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrMacSchedulerOfdmaEdf");
+NS_OBJECT_ENSURE_REGISTERED (NrMacSchedulerOfdmaEdf);
+
+TypeId
+NrMacSchedulerOfdmaEdf::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NrMacSchedulerOfdmaEdf")
+    .SetParent<NrMacSchedulerOfdmaRR> ()
+    .AddConstructor<NrMacSchedulerOfdmaEdf> ()
+    .AddAttribute ("DlDelayBudget",
+                   "Delay budget of the DL data: the deadline is the generation time of the oldest data plus this budget",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&NrMacSchedulerOfdmaEdf::m_dlDelayBudget),
+                   MakeTimeChecker (Time (0)))
+    .AddAttribute ("UlDelayBudget",
+                   "Delay budget of the UL data, for the UEs that did not signal a traffic deadline in a CGR",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&NrMacSchedulerOfdmaEdf::m_ulDelayBudget),
+                   MakeTimeChecker (Time (0)))
+  ;
+  return tid;
+}
+
+NrMacSchedulerOfdmaEdf::NrMacSchedulerOfdmaEdf () : NrMacSchedulerOfdmaRR ()
+{
+}
+
+std::shared_ptr<NrMacSchedulerUeInfo>
+NrMacSchedulerOfdmaEdf::CreateUeRepresentation (const NrMacCschedSapProvider::CschedUeConfigReqParameters &params) const
+{
+  NS_LOG_FUNCTION (this);
+  return std::make_shared <NrMacSchedulerUeInfoEdf> (params.m_rnti, params.m_beamConfId,
+                                                     std::bind (&NrMacSchedulerOfdmaEdf::GetNumRbPerRbg, this));
+}
+
+void
+NrMacSchedulerOfdmaEdf::DoSchedDlRlcBufferReq (const NrMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  NrMacSchedulerOfdmaRR::DoSchedDlRlcBufferReq (params);
+
+  auto ue = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (GetUeInfo (params.m_rnti));
+  NS_ASSERT (ue != nullptr);
+
+  uint32_t bytes = params.m_rlcTransmissionQueueSize + params.m_rlcRetransmissionQueueSize;
+  uint16_t holDelay = std::max (params.m_rlcTransmissionQueueHolDelay,
+                                params.m_rlcRetransmissionHolDelay);
+  ue->UpdateDlArrival (params.m_logicalChannelIdentity, bytes,
+                       Simulator::Now () - MilliSeconds (holDelay));
+}
+
+void
+NrMacSchedulerOfdmaEdf::DoSchedUlMacCtrlInfoReq (const NrMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  NrMacSchedulerOfdmaRR::DoSchedUlMacCtrlInfoReq (params);
+
+  // The BSR does not tell when the data has been generated: the oldest UL
+  // data is assumed to be generated when the buffer becomes non-empty.
+  for (const auto &element : params.m_macCeList)
+    {
+      if (element.m_macCeType != MacCeElement::BSR)
+        {
+          continue;
+        }
+
+      auto ue = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (GetUeInfo (element.m_rnti));
+      NS_ASSERT (ue != nullptr);
+
+      uint64_t bytes = 0;
+      for (const auto &level : element.m_macCeValue.m_bufferStatus)
+        {
+          bytes += NrMacShortBsrCe::FromLevelToBytes (level);
+        }
+
+      if (bytes == 0)
+        {
+          ue->m_ulArrival = Time::Max ();
+        }
+      else if (ue->m_ulArrival == Time::Max ())
+        {
+          ue->m_ulArrival = Simulator::Now ();
+        }
+    }
+}
+
+void
+NrMacSchedulerOfdmaEdf::DoSchedUlCgrInfoReq (const NrMacSchedSapProvider::SchedUlCgrInfoReqParameters &params)
+{
+  NS_LOG_FUNCTION (this);
+  NrMacSchedulerOfdmaRR::DoSchedUlCgrInfoReq (params);
+
+  for (std::size_t i = 0; i < params.m_srList.size (); ++i)
+    {
+      auto ue = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (GetUeInfo (params.m_srList.at (i)));
+      if (ue == nullptr)
+        {
+          continue;
+        }
+
+      if (i < params.m_TraffDeadlineCgr.size ())
+        {
+          ue->m_ulDelayBudget = params.m_TraffDeadlineCgr.at (i);
+        }
+      if (i < params.m_TraffInitCgr.size () && ue->m_ulArrival == Time::Max ())
+        {
+          ue->m_ulArrival = params.m_TraffInitCgr.at (i);
+        }
+      NS_LOG_INFO ("UE " << params.m_srList.at (i) << " UL delay budget " <<
+                   ue->m_ulDelayBudget << " arrival " << ue->m_ulArrival);
+    }
+}
+
+Time
+NrMacSchedulerOfdmaEdf::GetDlPriority (const NrMacSchedulerUeInfoEdf &ue) const
+{
+  if (ue.m_dlArrival == Time::Max ())
+    {
+      return Time::Max ();
+    }
+  return ue.m_dlArrival + m_dlDelayBudget;
+}
+
+Time
+NrMacSchedulerOfdmaEdf::GetUlPriority (const NrMacSchedulerUeInfoEdf &ue) const
+{
+  if (ue.m_ulArrival == Time::Max ())
+    {
+      return Time::Max ();
+    }
+  return ue.m_ulArrival + (ue.m_ulDelayBudget.IsStrictlyPositive () ? ue.m_ulDelayBudget
+                                                                     : m_ulDelayBudget);
+}
+
+void
+NrMacSchedulerOfdmaEdf::DlScheduled (NrMacSchedulerUeInfoEdf &ue,
+                                     [[maybe_unused]] bool covered) const
+{
+  ue.m_dlLastDelivered = ue.m_dlArrival;
+}
+
+void
+NrMacSchedulerOfdmaEdf::UlScheduled (NrMacSchedulerUeInfoEdf &ue, bool covered) const
+{
+  ue.m_ulLastDelivered = ue.m_ulArrival;
+  if (covered)
+    {
+      // The next BSR tells if new data has arrived in the meantime
+      ue.m_ulArrival = Time::Max ();
+    }
+}
+
+bool
+NrMacSchedulerOfdmaEdf::ServedAfter (const HeapEntry &lhs, const HeapEntry &rhs)
+{
+  // std::make_heap puts on top the "largest" entry: the one with the lowest
+  // priority value and, with the same priority, the lowest RNTI.
+  if (lhs.m_priority != rhs.m_priority)
+    {
+      return lhs.m_priority > rhs.m_priority;
+    }
+  return lhs.m_rnti > rhs.m_rnti;
+}
+
+/**
+ * \brief Assign the available DL RBG to the UEs, in order of priority
+ * \param symAvail Available symbols
+ * \param activeDl Map of active UE and their beams
+ * \return a map between beams and the symbol they need
+ *
+ * The symbols of each beam are calculated by GetSymPerBeam(), as in
+ * NrMacSchedulerOfdma. Inside a beam, the UE on top of the priority heap gets
+ * the RBGs, one at a time, until its buffer is covered; then, it is removed
+ * from the heap and the next UE is served.
+ */
+NrMacSchedulerNs3::BeamSymbolMap
+NrMacSchedulerOfdmaEdf::AssignDLRBG (uint32_t symAvail, const ActiveUeMap &activeDl) const
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_DEBUG ("# beams active flows: " << activeDl.size () << ", # sym: " << symAvail);
+
+  GetFirst GetBeamId;
+  GetSecond GetUeVector;
+  GetFirst GetUe;
+  BeamSymbolMap symPerBeam = GetSymPerBeam (symAvail, activeDl);
+
+  for (const auto &el : activeDl)
+    {
+      uint32_t beamSym = symPerBeam.at (GetBeamId (el));
+      uint32_t rbgAssignable = 1 * beamSym;
+      FTResources assigned (0,0);
+      const std::vector<uint8_t> dlNotchedRBGsMask = GetDlNotchedRbgMask ();
+      uint32_t resources = dlNotchedRBGsMask.size () > 0 ? std::count (dlNotchedRBGsMask.begin (),
+                                                                     dlNotchedRBGsMask.end (),
+                                                                     1) : GetBandwidthInRbg ();
+      NS_ASSERT (resources > 0);
+
+      std::vector<HeapEntry> heap;
+      heap.reserve (GetUeVector (el).size ());
+      for (const auto &ue : GetUeVector (el))
+        {
+          BeforeDlSched (ue, FTResources (rbgAssignable * beamSym, beamSym));
+          auto uePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (GetUe (ue));
+          heap.push_back ({GetDlPriority (*uePtr), uePtr->m_rnti, ue});
+        }
+      std::make_heap (heap.begin (), heap.end (), &NrMacSchedulerOfdmaEdf::ServedAfter);
+
+      while (resources > 0 && ! heap.empty ())
+        {
+          const UePtrAndBufferReq &top = heap.front ().m_ue;
+          if (IsDlBufferCovered (top))
+            {
+              std::pop_heap (heap.begin (), heap.end (), &NrMacSchedulerOfdmaEdf::ServedAfter);
+              heap.pop_back ();
+              continue;
+            }
+
+          GetUe (top)->m_dlRBG += rbgAssignable;
+          assigned.m_rbg += rbgAssignable;
+
+          GetUe (top)->m_dlSym = beamSym;
+          assigned.m_sym = beamSym;
+
+          resources -= 1; // Resources are RBG, so they do not consider the beamSym
+
+          NS_LOG_DEBUG ("Assigned " << rbgAssignable <<
+                        " DL RBG, spanned over " << beamSym << " SYM, to UE " <<
+                        GetUe (top)->m_rnti);
+          AssignedDlResources (top, FTResources (rbgAssignable, beamSym), assigned);
+        }
+
+      for (const auto &ue : GetUeVector (el))
+        {
+          if (GetUe (ue)->m_dlRBG > 0)
+            {
+              auto uePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (GetUe (ue));
+              DlScheduled (*uePtr, IsDlBufferCovered (ue));
+            }
+        }
+    }
+
+  return symPerBeam;
+}
+
+/**
+ * \brief Assign the available UL RBG to the UEs, in order of priority
+ * \param symAvail Available symbols
+ * \param activeUl Map of active UE and their beams
+ * \return a map between beams and the symbol they need
+ *
+ * As AssignDLRBG, for the 5GL-OFDMA access mode; the other access modes
+ * are left to NrMacSchedulerOfdma::AssignULRBG.
+ */
+NrMacSchedulerNs3::BeamSymbolMap
+NrMacSchedulerOfdmaEdf::AssignULRBG (uint32_t symAvail, const ActiveUeMap &activeUl) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (GetScheduler () != 1)
+    {
+      return NrMacSchedulerOfdmaRR::AssignULRBG (symAvail, activeUl);
+    }
+
+  NS_LOG_DEBUG ("# beams active flows: " << activeUl.size () << ", # sym: " << symAvail);
+
+  GetFirst GetBeamId;
+  GetSecond GetUeVector;
+  GetFirst GetUe;
+  BeamSymbolMap symPerBeam = GetSymPerBeam (symAvail, activeUl);
+
+  auto isCovered = [&GetUe] (const UePtrAndBufferReq &ue)
+    {
+      return GetUe (ue)->m_ulTbSize >= std::max (ue.second, 7U);
+    };
+
+  for (const auto &el : activeUl)
+    {
+      uint32_t beamSym = symPerBeam.at (GetBeamId (el));
+      uint32_t rbgAssignable = 1 * beamSym;
+      FTResources assigned (0,0);
+      const std::vector<uint8_t> ulNotchedRBGsMask = GetUlNotchedRbgMask ();
+      uint32_t resources = ulNotchedRBGsMask.size () > 0 ? std::count (ulNotchedRBGsMask.begin (),
+                                                                     ulNotchedRBGsMask.end (),
+                                                                     1) : GetBandwidthInRbg ();
+      NS_ASSERT (resources > 0);
+
+      std::vector<HeapEntry> heap;
+      heap.reserve (GetUeVector (el).size ());
+      for (const auto &ue : GetUeVector (el))
+        {
+          BeforeUlSched (ue, FTResources (rbgAssignable * beamSym, beamSym));
+          auto uePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (GetUe (ue));
+          heap.push_back ({GetUlPriority (*uePtr), uePtr->m_rnti, ue});
+        }
+      std::make_heap (heap.begin (), heap.end (), &NrMacSchedulerOfdmaEdf::ServedAfter);
+
+      while (resources > 0 && ! heap.empty ())
+        {
+          const UePtrAndBufferReq &top = heap.front ().m_ue;
+          if (isCovered (top))
+            {
+              std::pop_heap (heap.begin (), heap.end (), &NrMacSchedulerOfdmaEdf::ServedAfter);
+              heap.pop_back ();
+              continue;
+            }
+
+          GetUe (top)->m_ulRBG += rbgAssignable;
+          assigned.m_rbg += rbgAssignable;
+
+          GetUe (top)->m_ulSym = beamSym;
+          assigned.m_sym = beamSym;
+
+          resources -= 1; // Resources are RBG, so they do not consider the beamSym
+
+          NS_LOG_DEBUG ("Assigned " << rbgAssignable <<
+                        " UL RBG, spanned over " << beamSym << " SYM, to UE " <<
+                        GetUe (top)->m_rnti);
+          AssignedUlResources (top, FTResources (rbgAssignable, beamSym), assigned);
+        }
+
+      for (const auto &ue : GetUeVector (el))
+        {
+          if (GetUe (ue)->m_ulRBG > 0)
+            {
+              auto uePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (GetUe (ue));
+              UlScheduled (*uePtr, isCovered (ue));
+            }
+        }
+    }
+
+  return symPerBeam;
+}
+
+} // namespace ns3
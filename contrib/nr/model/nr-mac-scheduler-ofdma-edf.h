@@ -0,0 +1,173 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#pragma once
+
+#include "nr-mac-scheduler-ofdma-rr.h"
+
+namespace ns3 {
+
+class NrMacSchedulerUeInfoEdf;
+
+/**
+ * \ingroup scheduler
+ * \brief Assign frequencies following the earliest deadline first policy
+ *
+ * The deadline of an UE is the generation time of its oldest data plus a
+ * delay budget. The generation time is taken:
+ *
+ * - in DL, from the head-of-line delay of the RLC buffer status reports;
+ * - in UL, from the time of the first non-empty BSR, or from the traffic
+ * start time signaled in a CGR.
+ *
+ * The delay budget is the attribute DlDelayBudget in DL; in UL, it is the
+ * traffic deadline signaled by the UE in a CGR or, if the UE did not send
+ * any, the attribute UlDelayBudget.
+ *
+ * Inside a beam, the UEs are kept in a binary heap ordered by their
+ * priority (ties are broken by RNTI), and every RBG goes to the UE on top of
+ * the heap, until its buffer is covered; then, the UE is removed from the
+ * heap. Each RBG decision therefore costs O(log N) instead of sorting
+ * the N UEs of the beam, and the UEs that did not get the RBG are not
+ * visited.
+ *
+ * The priority is computed once per slot by GetDlPriority and
+ * GetUlPriority (the lower, the earlier the UE is served): subclasses
+ * can redefine them to implement other deadline-aware policies, like
+ * NrMacSchedulerOfdmaAoI.
+ *
+ * In UL, the heap is used with the 5GL-OFDMA access mode (attribute
+ * schOFDMA equal to 1); the other access modes keep the allocation of
+ * NrMacSchedulerOfdma.
+ */
+class NrMacSchedulerOfdmaEdf : public NrMacSchedulerOfdmaRR
+{
+public:
+  /**
+   * \brief GetTypeId
+   * \return The TypeId of the class
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief NrMacSchedulerOfdmaEdf constructor
+   */
+  NrMacSchedulerOfdmaEdf ();
+
+  /**
+   * \brief ~NrMacSchedulerOfdmaEdf deconstructor
+   */
+  virtual ~NrMacSchedulerOfdmaEdf () override
+  {
+  }
+
+  /**
+   * \brief Update the DL buffer, and the generation time of the DL data
+   * \param params RLC buffer status
+   */
+  virtual void
+  DoSchedDlRlcBufferReq (const NrMacSchedSapProvider::SchedDlRlcBufferReqParameters& params) override;
+  /**
+   * \brief Update the UL buffer, and the generation time of the UL data
+   * \param params the BSRs
+   */
+  virtual void
+  DoSchedUlMacCtrlInfoReq (const NrMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params) override;
+  /**
+   * \brief Store the CGRs, and the UL delay budget and data generation time
+   * that they carry
+   * \param params the CGRs
+   */
+  virtual void
+  DoSchedUlCgrInfoReq (const NrMacSchedSapProvider::SchedUlCgrInfoReqParameters &params) override;
+
+protected:
+  /**
+   * \brief Create an UE representation of the type NrMacSchedulerUeInfoEdf
+   * \param params parameters
+   * \return NrMacSchedulerUeInfoEdf instance
+   */
+  virtual std::shared_ptr<NrMacSchedulerUeInfo>
+  CreateUeRepresentation (const NrMacCschedSapProvider::CschedUeConfigReqParameters& params) const override;
+
+  /**
+   * \brief Assign the DL RBG, in order of priority
+   * \param symAvail available symbols for DL
+   * \param activeDl Map of Beam and active UE per beam
+   * \return a map of symbols dedicated to each beam
+   */
+  virtual BeamSymbolMap
+  AssignDLRBG (uint32_t symAvail, const ActiveUeMap &activeDl) const override;
+  /**
+   * \brief Assign the UL RBG, in order of priority
+   * \param symAvail available symbols for UL
+   * \param activeUl Map of Beam and active UE per beam
+   * \return a map of symbols dedicated to each beam
+   */
+  virtual BeamSymbolMap
+  AssignULRBG (uint32_t symAvail, const ActiveUeMap &activeUl) const override;
+
+  /**
+   * \brief Get the DL priority of an UE: its DL deadline
+   * \param ue the UE
+   * \return the priority (lower values are served first)
+   */
+  virtual Time GetDlPriority (const NrMacSchedulerUeInfoEdf &ue) const;
+  /**
+   * \brief Get the UL priority of an UE: its UL deadline
+   * \param ue the UE
+   * \return the priority (lower values are served first)
+   */
+  virtual Time GetUlPriority (const NrMacSchedulerUeInfoEdf &ue) const;
+
+  /**
+   * \brief Called, at the end of the DL assignment, for each UE that got RBGs
+   * \param ue the UE
+   * \param covered true if the assigned RBGs cover the UE buffer
+   */
+  virtual void DlScheduled (NrMacSchedulerUeInfoEdf &ue, bool covered) const;
+  /**
+   * \brief Called, at the end of the UL assignment, for each UE that got RBGs
+   * \param ue the UE
+   * \param covered true if the assigned RBGs cover the UE buffer
+   */
+  virtual void UlScheduled (NrMacSchedulerUeInfoEdf &ue, bool covered) const;
+
+private:
+  /**
+   * \brief Entry of the priority heap
+   */
+  struct HeapEntry
+  {
+    Time m_priority;          //!< Priority of the UE
+    uint16_t m_rnti;          //!< RNTI of the UE, to break ties
+    UePtrAndBufferReq m_ue;   //!< The UE
+  };
+
+  /**
+   * \brief Ordering of the heap
+   * \param lhs first entry
+   * \param rhs second entry
+   * \return true if lhs should be served after rhs
+   */
+  static bool ServedAfter (const HeapEntry &lhs, const HeapEntry &rhs);
+
+  Time m_dlDelayBudget; //!< DL delay budget
+  Time m_ulDelayBudget; //!< UL delay budget, for UEs that did not signal one
+};
+
+} // namespace ns3
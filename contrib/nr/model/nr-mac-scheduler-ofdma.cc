@@ -28,6 +28,7 @@
 #include "nr-mac-scheduler-ofdma.h"
 #include <ns3/log.h>
 #include <algorithm>
+#include <numeric>
 #include "math.h"
 
 namespace ns3 {
@@ -141,6 +142,76 @@ NrMacSchedulerOfdma::GetSymPerBeam (uint32_t symAvail,
   return ret;
 }
 
+/**
+ * \brief Check if the DL TBs assigned to an UE cover its buffer
+ * \param ue the UE and its buffer
+ * \return true if the UE does not need more resources
+ *
+ * With more than one stream (MIMO), the streams that are not needed to
+ * empty the buffer get a TB size of zero.
+ */
+bool
+NrMacSchedulerOfdma::IsDlBufferCovered (const UePtrAndBufferReq &ue) const
+{
+  GetFirst GetUe;
+  uint32_t bufQueueSize = ue.second;
+
+  //if there are two streams we add the TbSizes of the two
+  //streams to satisfy the bufQueueSize
+  uint32_t tbSize = 0;
+  for (const auto &it:GetUe (ue)->m_dlTbSize)
+    {
+      tbSize += it;
+    }
+
+  if (tbSize < std::max (bufQueueSize, 7U))
+    {
+      return false;
+    }
+
+  if (GetUe (ue)->m_dlTbSize.size () > 1)
+    {
+      // This "if" is purely for MIMO. In MIMO, for example, if the
+      // first TB size is big enough to empty the buffer then we
+      // should not allocate anything to the second stream. In this
+      // case, if we allocate bytes to the second stream, the UE
+      // would expect the TB but the gNB would not be able to transmit
+      // it. This would break HARQ TX state machine at UE PHY.
+
+      uint8_t streamCounter = 0;
+      uint32_t copyBufQueueSize = bufQueueSize;
+      auto dlTbSizeIt = GetUe (ue)->m_dlTbSize.begin ();
+      while (dlTbSizeIt != GetUe (ue)->m_dlTbSize.end ())
+        {
+          if (copyBufQueueSize != 0)
+            {
+              NS_LOG_DEBUG ("Stream " << +streamCounter << " with TB size " << *dlTbSizeIt << " needed to TX MIMO TB");
+              if (*dlTbSizeIt >= copyBufQueueSize)
+                {
+                  copyBufQueueSize = 0;
+                }
+              else
+                {
+                  copyBufQueueSize = copyBufQueueSize - *dlTbSizeIt;
+                }
+              streamCounter++;
+              dlTbSizeIt++;
+            }
+          else
+            {
+              // if we are here, that means previously iterated
+              // streams were enough to empty the buffer. We do
+              // not need this stream. Make its TB size zero.
+              NS_LOG_DEBUG ("Stream " << +streamCounter << " with TB size " << *dlTbSizeIt << " not needed to TX MIMO TB");
+              *dlTbSizeIt = 0;
+              streamCounter++;
+              dlTbSizeIt++;
+            }
+        }
+    }
+  return true;
+}
+
 /**
  * \brief Assign the available DL RBG to the UEs
  * \param symAvail Available symbols
@@ -153,16 +224,27 @@ NrMacSchedulerOfdma::GetSymPerBeam (uint32_t symAvail,
  * The pseudocode is the following (please note that sym_of_beam is a value
  * returned by the GetSymPerBeam() function):
  * <pre>
+ * make_heap (ueVector);
  * while frequencies > 0:
- *    sort (ueVector);
- *    ueVector.first().m_dlRBG += 1 * sym_of_beam;
+ *    ue = pop_heap (ueVector);
+ *    ue.m_dlRBG += 1 * sym_of_beam;
  *    frequencies--;
- *    UpdateUeDlMetric (ueVector.first());
+ *    UpdateUeDlMetric (ue);
+ *    push_heap (ueVector, ue);
  * </pre>
  *
- * To sort the UEs, the method uses the function returned by GetUeCompareDlFn().
+ * To order the UEs, the method uses the function returned by GetUeCompareDlFn()
+ * (UEs that compare equal are served in the order of the vector). The heap
+ * is kept ordered incrementally: only the UE that got the RBG changes its
+ * metric, so it is re-inserted in O(log N), without sorting all the UEs at
+ * every RBG. For the same reason, NotAssignedDlResources() is called only
+ * after the first RBG, for all the UEs that did not get it: calling it
+ * again for an UE whose assignment did not change would not change its
+ * metric.
+ *
  * Two fairness helper are hard-coded in the method: the first one is avoid
- * to assign resources to UEs that already have their buffer requirement covered,
+ * to assign resources to UEs that already have their buffer requirement covered
+ * (they are removed from the heap, as their TBs can only grow),
  * and the other one is avoid to assign symbols when all the UEs have their
  * requirements covered.
  */
@@ -201,82 +283,44 @@ NrMacSchedulerOfdma::AssignDLRBG (uint32_t symAvail, const ActiveUeMap &activeDl
           BeforeDlSched (ue, FTResources (rbgAssignable * beamSym, beamSym));
         }
 
+      // Heap of the UE indexes: on top, the UE that the compare function
+      // puts first (or, between equal UEs, the first in the vector)
+      auto compare = GetUeCompareDlFn ();
+      auto servedAfter = [&compare, &ueVector] (std::size_t lhs, std::size_t rhs)
+        {
+          if (compare (ueVector[rhs], ueVector[lhs]))
+            {
+              return true;
+            }
+          return ! compare (ueVector[lhs], ueVector[rhs]) && rhs < lhs;
+        };
+      std::vector<std::size_t> heap (ueVector.size ());
+      std::iota (heap.begin (), heap.end (), 0);
+      std::make_heap (heap.begin (), heap.end (), servedAfter);
+      bool firstRbg = true;
+
       while (resources > 0)
         {
           GetFirst GetUe;
-          std::sort (ueVector.begin (), ueVector.end (), GetUeCompareDlFn ());
-          auto schedInfoIt = ueVector.begin ();
 
-          // Ensure fairness: pass over UEs which already has enough resources to transmit
-          while (schedInfoIt != ueVector.end ())
+          // Ensure fairness: remove the UEs which already has enough resources to transmit
+          while (! heap.empty () && IsDlBufferCovered (ueVector[heap.front ()]))
             {
-              uint32_t bufQueueSize = schedInfoIt->second;
-
-              //if there are two streams we add the TbSizes of the two
-              //streams to satisfy the bufQueueSize
-              uint32_t tbSize = 0;
-              for (const auto &it:GetUe (*schedInfoIt)->m_dlTbSize)
-                {
-                  tbSize += it;
-                }
-
-              if (tbSize >= std::max (bufQueueSize, 7U))
-                {
-                  if (GetUe (*schedInfoIt)->m_dlTbSize.size () > 1)
-                    {
-                      // This "if" is purely for MIMO. In MIMO, for example, if the
-                      // first TB size is big enough to empty the buffer then we
-                      // should not allocate anything to the second stream. In this
-                      // case, if we allocate bytes to the second stream, the UE
-                      // would expect the TB but the gNB would not be able to transmit
-                      // it. This would break HARQ TX state machine at UE PHY.
-
-                      uint8_t streamCounter = 0;
-                      uint32_t copyBufQueueSize = bufQueueSize;
-                      auto dlTbSizeIt = GetUe (*schedInfoIt)->m_dlTbSize.begin ();
-                      while (dlTbSizeIt != GetUe (*schedInfoIt)->m_dlTbSize.end ())
-                        {
-                          if (copyBufQueueSize != 0)
-                            {
-                              NS_LOG_DEBUG ("Stream " << +streamCounter << " with TB size " << *dlTbSizeIt << " needed to TX MIMO TB");
-                              if (*dlTbSizeIt >= copyBufQueueSize)
-                                {
-                                  copyBufQueueSize = 0;
-                                }
-                              else
-                                {
-                                  copyBufQueueSize = copyBufQueueSize - *dlTbSizeIt;
-                                }
-                              streamCounter++;
-                              dlTbSizeIt++;
-                            }
-                          else
-                            {
-                              // if we are here, that means previously iterated
-                              // streams were enough to empty the buffer. We do
-                              // not need this stream. Make its TB size zero.
-                              NS_LOG_DEBUG ("Stream " << +streamCounter << " with TB size " << *dlTbSizeIt << " not needed to TX MIMO TB");
-                              *dlTbSizeIt = 0;
-                              streamCounter++;
-                              dlTbSizeIt++;
-                            }
-                        }
-                    }
-                  schedInfoIt++;
-                }
-              else
-                {
-                  break;
-                }
+              std::pop_heap (heap.begin (), heap.end (), servedAfter);
+              heap.pop_back ();
             }
 
           // In the case that all the UE already have their requirements fullfilled,
           // then stop the beam processing and pass to the next
-          if (schedInfoIt == ueVector.end ())
+          if (heap.empty ())
             {
               break;
             }
 
+          // Take the UE out of the heap while its metric is updated
+          std::pop_heap (heap.begin (), heap.end (), servedAfter);
+          auto schedInfoIt = ueVector.begin () + heap.back ();
+
           // Assign 1 RBG for each available symbols for the beam,
           // and then update the count of available resources
           GetUe (*schedInfoIt)->m_dlRBG += rbgAssignable;
@@ -299,14 +343,24 @@ NrMacSchedulerOfdma::AssignDLRBG (uint32_t symAvail, const ActiveUeMap &activeDl
           AssignedDlResources (*schedInfoIt, FTResources (rbgAssignable, beamSym),
                                assigned);
 
-          // Update metrics for the unsuccessfull UEs (who did not get any resource in this iteration)
-          for (auto & ue : ueVector)
+          if (firstRbg)
             {
-              if (GetUe (ue)->m_rnti != GetUe (*schedInfoIt)->m_rnti)
+              // Update metrics for the unsuccessfull UEs (who did not get any resource in this iteration)
+              for (auto & ue : ueVector)
                 {
-                  NotAssignedDlResources (ue, FTResources (rbgAssignable, beamSym),
-                                          assigned);
+                  if (GetUe (ue)->m_rnti != GetUe (*schedInfoIt)->m_rnti)
+                    {
+                      NotAssignedDlResources (ue, FTResources (rbgAssignable, beamSym),
+                                              assigned);
+                    }
                 }
+              // All the metrics may have changed
+              std::make_heap (heap.begin (), heap.end (), servedAfter);
+              firstRbg = false;
+            }
+          else
+            {
+              std::push_heap (heap.begin (), heap.end (), servedAfter);
             }
         }
     }
@@ -631,6 +685,17 @@ NrMacSchedulerOfdma::ChangeUlBeam (PointInFTPlane *spoint, uint32_t symOfBeam) c
   spoint->m_sym -= symOfBeam;
 }
 
+NrMacSchedulerCgPlanner &
+NrMacSchedulerOfdma::GetCgPlanner (uint32_t rbgInOneSymbol) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_cgPlanner == nullptr || ! m_cgPlanner->IsValidFor (m_ulAmc, rbgInOneSymbol))
+    {
+      m_cgPlanner = std::make_unique<NrMacSchedulerCgPlanner> (m_ulAmc, rbgInOneSymbol);
+    }
+  return *m_cgPlanner;
+}
+
 uint8_t
 NrMacSchedulerOfdma::GetTpc () const
 {
@@ -681,11 +746,15 @@ NrMacSchedulerOfdma::AssignULRBG (uint32_t symAvail, const ActiveUeMap &activeUl
               BeforeUlSched (ue, FTResources (rbgAssignable * beamSym, beamSym));
             }
 
+          // The UEs are not sorted, to assign the packets in order: the RBGs go
+          // to the first UE whose buffer is not covered. As the TBs only grow,
+          // the UEs passed over are never visited again.
+          auto schedInfoIt = ueVector.begin ();
+          bool firstRbg = true;
+
           while (resources > 0)
             {
               GetFirst GetUe;
-              //std::sort (ueVector.begin (), ueVector.end (), GetUeCompareUlFn ()); //Comment out this line to assign the packets in order
-              auto schedInfoIt = ueVector.begin ();
 
               // Ensure fairness: pass over UEs which already has enough resources to transmit
               while (schedInfoIt != ueVector.end ())
@@ -725,14 +794,20 @@ NrMacSchedulerOfdma::AssignULRBG (uint32_t symAvail, const ActiveUeMap &activeUl
               AssignedUlResources (*schedInfoIt, FTResources (rbgAssignable, beamSym),
                                    assigned);
 
-              // Update metrics for the unsuccessfull UEs (who did not get any resource in this iteration)
-              for (auto & ue : ueVector)
+              // Update metrics for the unsuccessfull UEs (who did not get any resource in this iteration).
+              // As in AssignDLRBG, repeating the update for the UEs whose assignment did not
+              // change would not change their metric.
+              if (firstRbg)
                 {
-                  if (GetUe (ue)->m_rnti != GetUe (*schedInfoIt)->m_rnti)
+                  for (auto & ue : ueVector)
                     {
-                      NotAssignedUlResources (ue, FTResources (rbgAssignable, beamSym),
-                                              assigned);
+                      if (GetUe (ue)->m_rnti != GetUe (*schedInfoIt)->m_rnti)
+                        {
+                          NotAssignedUlResources (ue, FTResources (rbgAssignable, beamSym),
+                                                  assigned);
+                        }
                     }
+                  firstRbg = false;
                 }
             }
         }
@@ -768,114 +843,23 @@ NrMacSchedulerOfdma::AssignULRBG (uint32_t symAvail, const ActiveUeMap &activeUl
                 BeforeUlSched (ue, FTResources (resources, beamSym));
               }
 
-            //Find the minimum RB to assign 1 TBS
-            // We could find the optimal RB to assign
-
-            uint32_t rbPacket = 2;
             uint32_t rbgAssignable = 2;
             GetFirst GetUe;
 
-            // Calculate the RBs to schedule for a UE
-            auto it_packetTBS = ueVector.begin ();
-            uint32_t tbs = 0;
-            while(tbs < it_packetTBS->second)
-             {
-            //GetUe (*it_packetTBS)->m_ulMcs
-                tbs = m_ulAmc->CalculateTbSize (GetUe (*it_packetTBS)->m_ulMcs,rbPacket);
-                rbPacket++;
-            }
-            std::vector<uint32_t> v_rbgAssignable;
-            if (v_rbgAssignable.size() == 0)
-            {
-                v_rbgAssignable = std::vector<uint32_t> (rbgInOneSymbol/2 , 0);
-            }
-            uint8_t posRBassignable = 0;
-            uint32_t rbgInOneSymbolPrime = 0;
-            rbgInOneSymbolPrime = rbgInOneSymbol;
-            uint32_t rbAssignableMin = 0;
-            uint32_t  rbAssignableMinStored = 1000;
-            bool alreadyAssigned = false;
             if (m_schType_OFDMA==3)
             {
-                while(1)
-                {
-                    while(rbgAssignable < rbgInOneSymbolPrime)
-                     {
-                       if (rbgInOneSymbolPrime%rbgAssignable == 0)
-                        {
-                          for(uint8_t posFind = 0;posFind < posRBassignable; posFind++)
-                          {
-                              if (v_rbgAssignable[posFind]==rbgAssignable)
-                              {
-                                  alreadyAssigned = true;
-                                  break;
-                              }
-                          }
-                          if (!alreadyAssigned)
-                          {
-                             v_rbgAssignable[posRBassignable] = rbgAssignable;
-                             posRBassignable++;
-                             v_rbgAssignable[posRBassignable] = rbgInOneSymbolPrime/rbgAssignable;
-                             posRBassignable++;
-
-                             std::cout << "Assigned RBs: First = " << v_rbgAssignable[posRBassignable-1] << " and Second = "<< v_rbgAssignable[posRBassignable-2] <<'\n';
-                          }
-                          alreadyAssigned = false;
-                        }
-                       rbgAssignable ++;
-                     }
-
-                    if (posRBassignable == 0)
-                    {
-                      rbgAssignable = 2;
-                      rbgInOneSymbolPrime = rbgInOneSymbol-1;
-                    }
-                    else
-                    {
-                        break;
-                    }
-                }
-
-                for (uint8_t ii = 0; ii <= v_rbgAssignable.size(); ii++)
-                {
-                    if(v_rbgAssignable[ii] == 0)
-                    {
-                        v_rbgAssignable[ii] = 1000;
-                    }
-                    else
-                    {
-                        int numRbgAssignable = (rbgInOneSymbolPrime/(ueVector.size()))/v_rbgAssignable[ii];
-                        if (numRbgAssignable == 0)
-                        {
-                          numRbgAssignable = 1;
-                        }
-                        double numSym = ceil(rbPacket/(v_rbgAssignable[ii]*numRbgAssignable));
-                        if (rbPacket%(v_rbgAssignable[ii]*numRbgAssignable)!= 0){numSym = rbPacket/(v_rbgAssignable[ii]*numRbgAssignable) +1;} //ceil
-                        rbAssignableMin = uint32_t(v_rbgAssignable[ii]*numRbgAssignable*numSym - rbPacket);
-
-                        if (rbAssignableMin < rbAssignableMinStored)
-                        {
-                          // Only if the packet enters in less than one slot
-                          if (numSym < 12)
-                           {
-                               rbgAssignable =  v_rbgAssignable[ii];
-                               rbAssignableMinStored = rbAssignableMin;
-                               std::cout << "Assignable RBs: " << rbgAssignable << " we are going to loss " << rbAssignableMin << " resources"<<'\n';
-                           }
-                        }
-                    }
-                }
-            }
-
-
-            if (m_schType_OFDMA==2)
-            {
-                rbgAssignable = 2;
+                // The width of the RBG groups comes from the CG plan, for the
+                // packet of the first UE
+                NrMacSchedulerCgPlanner &planner = GetCgPlanner (rbgInOneSymbol);
+                auto it_packetTBS = ueVector.begin ();
+                uint32_t rbPacket = planner.GetPacketRb (GetUe (*it_packetTBS)->m_ulMcs, it_packetTBS->second);
+                rbgAssignable = planner.GetRbgWidth (static_cast<uint32_t> (ueVector.size ()), rbPacket);
+                NS_LOG_DEBUG ("Assignable RBs: " << rbgAssignable << " for packets of " << rbPacket << " RBs");
             }
 
-            static uint8_t nextSymbol = 1;
-            static uint8_t nextUE = 0;
-            static uint8_t initSym = 1;
+            uint8_t &nextSymbol = m_cgNextSymbol;
+            uint8_t &nextUE = m_cgNextUe;
+            uint8_t &initSym = m_cgInitSym;
 
             int countPos = 0;
             int initRNTIpos = 0;
@@ -19,7 +19,9 @@
 #pragma once
 
 #include "nr-mac-scheduler-tdma.h"
+#include "nr-mac-scheduler-cg-planner.h"
 #include <ns3/traced-value.h>
+#include <memory>
 
 namespace ns3 {
 
@@ -112,6 +114,8 @@ protected:
   NrMacSchedulerOfdma::BeamSymbolMap
   GetSymPerBeam (uint32_t symAvail, const ActiveUeMap &activeDl) const;
 
+  bool IsDlBufferCovered (const UePtrAndBufferReq &ue) const;
+
   virtual uint8_t GetTpc () const override;
 
   // Configured Grant
@@ -121,11 +125,23 @@ protected:
   CreateUlCGConfig (PointInFTPlane *spoint, const std::shared_ptr<NrMacSchedulerUeInfo> &ueInfo,
                uint32_t maxSym) const override;
 
+  /**
+   * \brief Get the plan of the RB-OFDMA allocations, building it if the
+   * UL AMC or the RBGs changed
+   * \param rbgInOneSymbol the RBGs in a symbol
+   * \return the plan
+   */
+  NrMacSchedulerCgPlanner & GetCgPlanner (uint32_t rbgInOneSymbol) const;
+
 private:
 
   TracedValue<uint32_t> m_tracedValueSymPerBeam;
 
   // Configured Grant
   uint8_t m_schType_OFDMA {1}; //!<
+  mutable std::unique_ptr<NrMacSchedulerCgPlanner> m_cgPlanner; //!< Plan of the RB-OFDMA allocations
+  mutable uint8_t m_cgNextSymbol {1}; //!< Sym-OFDMA: next symbol to fill
+  mutable uint8_t m_cgNextUe {0};     //!< RB-OFDMA: UEs scheduled in the previous symbols
+  mutable uint8_t m_cgInitSym {1};    //!< RB-OFDMA: first symbol of the current UE group
 };
 } // namespace ns3
@@ -0,0 +1,86 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#pragma once
+
+#include "nr-mac-scheduler-ue-info-rr.h"
+#include <ns3/nstime.h>
+#include <algorithm>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief UE representation for the deadline-aware (EDF and AoI) schedulers
+ *
+ * On top of the RR representation, it stores when the data that the UE has
+ * to transmit (or to receive) has been generated, the delay budget that the
+ * UE signaled with a CGR, and when the data scheduled for last was
+ * generated. The schedulers NrMacSchedulerOfdmaEdf and NrMacSchedulerOfdmaAoi
+ * derive their priorities from these values.
+ *
+ * \see NrMacSchedulerOfdmaEdf
+ */
+class NrMacSchedulerUeInfoEdf : public NrMacSchedulerUeInfoRR
+{
+public:
+  /**
+   * \brief NrMacSchedulerUeInfoEdf constructor
+   * \param rnti RNTI of the UE
+   * \param beamConfId BeamConfId of the UE
+   * \param fn A function that tells how many RB per RBG
+   */
+  NrMacSchedulerUeInfoEdf (uint16_t rnti, BeamConfId beamConfId, const GetRbPerRbgFn &fn)
+    : NrMacSchedulerUeInfoRR (rnti, beamConfId, fn)
+  {
+  }
+
+  /**
+   * \brief Update the generation time of the oldest DL data of a LC
+   * \param lcid the LC
+   * \param bytes the bytes in the LC queues
+   * \param arrival the generation time of the head-of-line data of the LC
+   */
+  void UpdateDlArrival (uint8_t lcid, uint32_t bytes, const Time &arrival)
+  {
+    if (bytes == 0)
+      {
+        m_dlLcArrival.erase (lcid);
+      }
+    else
+      {
+        m_dlLcArrival[lcid] = arrival;
+      }
+
+    m_dlArrival = Time::Max ();
+    for (const auto &lc : m_dlLcArrival)
+      {
+        m_dlArrival = std::min (m_dlArrival, lc.second);
+      }
+  }
+
+  std::map<uint8_t, Time> m_dlLcArrival; //!< Generation time of the oldest DL data, per LC with data
+  Time m_dlArrival {Time::Max ()};      //!< Generation time of the oldest DL data (Max if no data)
+  Time m_ulArrival {Time::Max ()};      //!< Generation time of the oldest UL data (Max if no data)
+  Time m_ulDelayBudget {0};             //!< UL delay budget signaled in a CGR (0 if none)
+  Time m_dlLastDelivered {0};           //!< Generation time of the last DL data scheduled
+  Time m_ulLastDelivered {0};           //!< Generation time of the last UL data scheduled
+};
+
+} // namespace ns3
@@ -146,6 +146,15 @@ public:
    */
   virtual uint32_t GetRbNum () const = 0;
 
+  /**
+   * \brief Notify the PHY that the MAC has something new to do
+   *
+   * The MAC calls it when new data arrives in its buffers, or when it starts
+   * a random access. A PHY that is skipping its idle slots has to resume the
+   * per-slot processing; otherwise, nothing happens.
+   */
+  virtual void NotifyMacActivity () = 0;
+
   // Configured Grant
   virtual Time GetTbUlEncodeLatency () const = 0;
 };
@@ -304,8 +313,44 @@ public:
    */
   virtual uint8_t GetNumHarqProcess () const = 0;
 
-  //Configured Grant  
-  virtual bool SlotIndication_configuredGrant (SfnSf s) = 0;
+  /**
+   * \brief Check if the MAC is idle
+   * \return true if the MAC has nothing to do in the next slots, unless a
+   * DCI is received or new data arrives in its buffers
+   *
+   * The PHY may stop the slot indications while the MAC is idle.
+   */
+  virtual bool IsIdle () const = 0;
+
+  /**
+   * \brief Indicate to an idle MAC the slot in which the PHY resumed
+   * \param s SfnSf of the slot
+   * \param slotStart the time at which the slot started
+   *
+   * After skipping a number of idle slots, the PHY may resume in the middle of
+   * a slot; in that case, it calls this method in place of SlotIndication.
+   */
+  virtual void IdleSlotIndication (SfnSf s, Time slotStart) = 0;
+
+  /**
+   * \brief Get the first slot with a configured grant occasion
+   * \param fromSlot the first slot to consider, as returned by SfnSf::Normalize
+   * \param slot the first slot, not before fromSlot, with an occasion
+   * \return false if the MAC has no configured grant occasions
+   *
+   * An idle PHY does not skip the slots with an occasion.
+   */
+  virtual bool GetNextCgOccasion (uint64_t fromSlot, uint64_t *slot) const = 0;
+
+  //Configured Grant
+  /**
+   * \brief Trigger the indication of a new slot for the MAC, with configured grant
+   * \param s SfnSf
+   * \param ulDcis filled by the MAC with the DCIs of the configured grant
+   * occasions in which it transmitted data in this slot: the PHY has to
+   * allocate them
+   */
+  virtual void SlotIndication_configuredGrant (SfnSf s, std::vector<std::shared_ptr<DciInfoElementTdma> > *ulDcis) = 0;
 };
 
 }
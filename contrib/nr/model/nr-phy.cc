@@ -72,6 +72,8 @@ public:
 
   virtual uint32_t GetRbNum () const override;
 
+  virtual void NotifyMacActivity () override;
+
   // Configured Grant
   virtual Time GetTbUlEncodeLatency () const override;
 
@@ -157,6 +159,12 @@ NrMemberPhySapProvider::GetRbNum () const
   return m_phy->GetRbNum ();
 }
 
+void
+NrMemberPhySapProvider::NotifyMacActivity ()
+{
+  m_phy->NotifyMacActivity ();
+}
+
 // Configured Grant
 Time
 NrMemberPhySapProvider::GetTbUlEncodeLatency() const
@@ -202,6 +210,7 @@ NrPhy::FromRBGBitmaskToRBAssignment (const std::vector<uint8_t> rbgBitmask) cons
 
 NrPhy::NrPhy ()
   : m_currSlotAllocInfo (SfnSf (0,0,0,0)),
+    m_slotRing (16),
     m_tbDecodeLatencyUs (100.0)
 {
   NS_LOG_FUNCTION (this);
@@ -217,9 +226,9 @@ void
 NrPhy::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_slotAllocInfo.clear ();
+  std::vector<SlotEntry> (1).swap (m_slotRing);
+  m_numSlotAllocs = 0;
   m_controlMessageQueue.clear ();
-  m_packetBurstMap.clear();
   m_ctrlMsgs.clear ();
   m_tddPattern.clear ();
   m_netDevice = nullptr;
@@ -354,12 +363,15 @@ NrPhy::SetMacPdu (const Ptr<Packet> &p, const SfnSf & sfn, uint8_t symStart, uin
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (sfn.GetNumerology () == GetNumerology());
-  uint64_t key = sfn.GetEncForStreamWithSymStart (streamId, symStart);
-  auto it = m_packetBurstMap.find (key);
+  uint16_t key = static_cast<uint16_t> ((streamId << 8) | symStart);
+  auto & bursts = GetSlotEntry (sfn.Normalize ()).m_bursts;
+  auto it = std::find_if (bursts.begin (), bursts.end (),
+                          [key] (const std::pair<uint16_t, Ptr<PacketBurst>> &b) { return b.first == key; });
 
-  if (it == m_packetBurstMap.end ())
+  if (it == bursts.end ())
     {
-      it = m_packetBurstMap.insert (std::make_pair (key, CreateObject<PacketBurst> ())).first;
+      bursts.emplace_back (key, CreateObject<PacketBurst> ());
+      it = bursts.end () - 1;
     }
   it->second->AddPacket (p);
   NS_LOG_INFO ("Adding a packet for the Packet Burst of " << sfn <<
@@ -372,26 +384,38 @@ NrPhy::NotifyConnectionSuccessful ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+NrPhy::NotifyMacActivity ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
 Ptr<PacketBurst>
 NrPhy::GetPacketBurst (SfnSf sfn, uint8_t sym, uint8_t streamId)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (sfn.GetNumerology () == GetNumerology());
   Ptr<PacketBurst> pburst;
-  auto it = m_packetBurstMap.find (sfn.GetEncForStreamWithSymStart (streamId, sym));
+  uint16_t key = static_cast<uint16_t> ((streamId << 8) | sym);
+  SlotEntry *entry = FindSlotEntry (sfn.Normalize ());
 
-  if (it == m_packetBurstMap.end ())
+  if (entry != nullptr)
     {
-      // For instance, this can happen with low BW and low MCS: The MAC
-      // ignores the txOpportunity.
-      NS_LOG_WARN ("Packet burst not found for " << sfn << " at sym " << +sym);
-      return pburst;
-    }
-  else
-    {
-      pburst = it->second;
-      m_packetBurstMap.erase (it);
+      auto & bursts = entry->m_bursts;
+      auto it = std::find_if (bursts.begin (), bursts.end (),
+                              [key] (const std::pair<uint16_t, Ptr<PacketBurst>> &b) { return b.first == key; });
+      if (it != bursts.end ())
+        {
+          pburst = it->second;
+          std::iter_swap (it, bursts.end () - 1);
+          bursts.pop_back ();
+          return pburst;
+        }
     }
+
+  // For instance, this can happen with low BW and low MCS: The MAC
+  // ignores the txOpportunity.
+  NS_LOG_WARN ("Packet burst not found for " << sfn << " at sym " << +sym);
   return pburst;
 }
 
@@ -462,7 +486,8 @@ NrPhy::EnqueueCtrlMessage (const Ptr<NrControlMessage> &m)
 {
   NS_LOG_FUNCTION (this);
 
-  m_controlMessageQueue.at (m_controlMessageQueue.size () - 1).push_back (m);
+  std::size_t size = m_controlMessageQueue.size ();
+  m_controlMessageQueue.at ((m_ctrlMsgHead + size - 1) % size).push_back (m);
 }
 
 void
@@ -470,16 +495,14 @@ NrPhy::EnqueueCtrlMsgNow (const Ptr<NrControlMessage> &msg)
 {
   NS_LOG_FUNCTION (this);
 
-  m_controlMessageQueue.at (0).push_back (msg);
+  m_controlMessageQueue.at (m_ctrlMsgHead).push_back (msg);
 }
 
 void
 NrPhy::EnqueueCtrlMsgNow (const std::list<Ptr<NrControlMessage> > &listOfMsgs)
 {
-  for (const auto & msg : listOfMsgs)
-    {
-      m_controlMessageQueue.at (0).push_back (msg);
-    }
+  auto & list = m_controlMessageQueue.at (m_ctrlMsgHead);
+  list.insert (list.end (), listOfMsgs.begin (), listOfMsgs.end ());
 }
 
 void
@@ -618,11 +641,8 @@ NrPhy::InitializeMessageList ()
 {
   NS_LOG_FUNCTION (this);
   m_controlMessageQueue.clear ();
-
-  for (unsigned i = 0; i <= GetL1L2CtrlLatency (); i++)
-    {
-      m_controlMessageQueue.push_back (std::list<Ptr<NrControlMessage> > ());
-    }
+  m_controlMessageQueue.resize (GetL1L2CtrlLatency () + 1);
+  m_ctrlMsgHead = 0;
 }
 
 
@@ -630,28 +650,17 @@ std::list<Ptr<NrControlMessage> >
 NrPhy::PopCurrentSlotCtrlMsgs (void)
 {
   NS_LOG_FUNCTION (this);
+  std::list<Ptr<NrControlMessage> > ret;
   if (m_controlMessageQueue.empty ())
     {
-      std::list<Ptr<NrControlMessage> > emptylist;
-      return (emptylist);
+      return ret;
     }
 
-  if (m_controlMessageQueue.at (0).size () > 0)
-    {
-      std::list<Ptr<NrControlMessage> > ret = m_controlMessageQueue.front ();
-      m_controlMessageQueue.erase (m_controlMessageQueue.begin ());
-      std::list<Ptr<NrControlMessage> > newlist;
-      m_controlMessageQueue.push_back (newlist);
-      return (ret);
-    }
-  else
-    {
-      m_controlMessageQueue.erase (m_controlMessageQueue.begin ());
-      std::list<Ptr<NrControlMessage> > newlist;
-      m_controlMessageQueue.push_back (newlist);
-      std::list<Ptr<NrControlMessage> > emptylist;
-      return (emptylist);
-    }
+  // The list of the current slot becomes the one of the last slot of the
+  // latency window: move the head, instead of shifting the lists
+  ret.swap (m_controlMessageQueue.at (m_ctrlMsgHead));
+  m_ctrlMsgHead = (m_ctrlMsgHead + 1) % m_controlMessageQueue.size ();
+  return ret;
 }
 
 void
@@ -706,39 +715,150 @@ NrPhy::GetPhySapProvider ()
   return m_phySapProvider;
 }
 
+const NrPhy::SlotEntry *
+NrPhy::FindSlotEntry (uint64_t slot) const
+{
+  const SlotEntry &entry = m_slotRing[slot & (m_slotRing.size () - 1)];
+  return entry.m_slot == slot ? &entry : nullptr;
+}
+
+NrPhy::SlotEntry *
+NrPhy::FindSlotEntry (uint64_t slot)
+{
+  SlotEntry &entry = m_slotRing[slot & (m_slotRing.size () - 1)];
+  return entry.m_slot == slot ? &entry : nullptr;
+}
+
+NrPhy::SlotEntry &
+NrPhy::GetSlotEntry (uint64_t slot)
+{
+  while (true)
+    {
+      SlotEntry &entry = m_slotRing[slot & (m_slotRing.size () - 1)];
+      if (entry.m_slot == slot)
+        {
+          return entry;
+        }
+      if (! entry.m_hasAlloc && (entry.m_bursts.empty () || entry.m_slot < m_ringCurrentSlot))
+        {
+          if (! entry.m_bursts.empty ())
+            {
+              NS_LOG_WARN ("Discarding " << entry.m_bursts.size () <<
+                           " packet bursts never transmitted in slot " << entry.m_slot);
+              entry.m_bursts.clear ();
+            }
+          entry.m_slot = slot;
+          return entry;
+        }
+      GrowSlotRing ();
+    }
+}
+
 void
-NrPhy::PushBackSlotAllocInfo (const SlotAllocInfo &slotAllocInfo)
+NrPhy::GrowSlotRing ()
 {
   NS_LOG_FUNCTION (this);
+  std::vector<SlotEntry> ring (m_slotRing.size () * 2);
+  for (auto & entry : m_slotRing)
+    {
+      // Two slots with different positions in the old ring have different
+      // positions in the new one, as the size is doubled
+      if (entry.m_hasAlloc || ! entry.m_bursts.empty ())
+        {
+          ring[entry.m_slot & (ring.size () - 1)] = std::move (entry);
+        }
+    }
+  m_slotRing.swap (ring);
+  NS_LOG_INFO ("Slot ring grown to " << m_slotRing.size () << " slots");
+}
 
-  NS_LOG_DEBUG ("setting info for slot " << slotAllocInfo.m_sfnSf);
+void
+NrPhy::ReserveSlotAllocHorizon (uint32_t slots)
+{
+  NS_LOG_FUNCTION (this << slots);
+  while (m_slotRing.size () <= slots)
+    {
+      GrowSlotRing ();
+    }
+}
+
+void
+NrPhy::StoreSlotAlloc (const SlotAllocInfo &slotAllocInfo)
+{
+  uint64_t slot = slotAllocInfo.m_sfnSf.Normalize ();
+  uint64_t first = m_numSlotAllocs > 0 ? std::min (m_firstAllocSlot, slot) : slot;
+  uint64_t last = m_numSlotAllocs > 0 ? std::max (m_lastAllocSlot, slot) : slot;
 
-  // That's not so complex, as the list would typically be of 2 or 3 elements.
-  bool updated = false;
-  for (auto & alloc : m_slotAllocInfo)
+  // All the pending allocations are kept in one lap of the ring, so that the
+  // next allocation is found by advancing from the first one
+  while (last - first >= m_slotRing.size ())
     {
-      if (alloc.m_sfnSf == slotAllocInfo.m_sfnSf)
+      GrowSlotRing ();
+    }
+
+  SlotEntry &entry = GetSlotEntry (slot);
+  NS_ASSERT (! entry.m_hasAlloc);
+  entry.m_alloc = slotAllocInfo;
+  entry.m_hasAlloc = true;
+  ++m_numSlotAllocs;
+  m_firstAllocSlot = first;
+  m_lastAllocSlot = last;
+}
+
+SlotAllocInfo
+NrPhy::TakeSlotAlloc (SlotEntry *entry)
+{
+  NS_ASSERT (entry != nullptr && entry->m_hasAlloc);
+  SlotAllocInfo ret (std::move (entry->m_alloc));
+  uint64_t slot = entry->m_slot;
+  entry->m_hasAlloc = false;
+
+  if (--m_numSlotAllocs == 0)
+    {
+      m_firstAllocSlot = UINT64_MAX;
+      m_lastAllocSlot = 0;
+    }
+  else if (slot == m_firstAllocSlot)
+    {
+      do
         {
-          NS_LOG_INFO ("Merging inside existing allocation");
-          alloc.Merge (slotAllocInfo);
-          updated = true;
-          break;
+          ++m_firstAllocSlot;
+          entry = FindSlotEntry (m_firstAllocSlot);
         }
+      while (entry == nullptr || ! entry->m_hasAlloc);
     }
-  if (! updated)
+  else if (slot == m_lastAllocSlot)
     {
-      m_slotAllocInfo.push_back (slotAllocInfo);
-      m_slotAllocInfo.sort ();
-      NS_LOG_INFO ("Pushing allocation at the end of the list");
+      do
+        {
+          --m_lastAllocSlot;
+          entry = FindSlotEntry (m_lastAllocSlot);
+        }
+      while (entry == nullptr || ! entry->m_hasAlloc);
     }
+  return ret;
+}
+
+void
+NrPhy::PushBackSlotAllocInfo (const SlotAllocInfo &slotAllocInfo)
+{
+  NS_LOG_FUNCTION (this);
 
-  std::stringstream output;
+  NS_LOG_DEBUG ("setting info for slot " << slotAllocInfo.m_sfnSf);
 
-  for (const auto & alloc : m_slotAllocInfo)
+  SlotEntry *entry = FindSlotEntry (slotAllocInfo.m_sfnSf.Normalize ());
+  if (entry != nullptr && entry->m_hasAlloc)
+    {
+      NS_LOG_INFO ("Merging inside existing allocation");
+      entry->m_alloc.Merge (slotAllocInfo);
+      NS_LOG_INFO (entry->m_alloc);
+    }
+  else
     {
-      output << alloc;
+      StoreSlotAlloc (slotAllocInfo);
+      NS_LOG_INFO ("Storing a new allocation");
+      NS_LOG_INFO (slotAllocInfo);
     }
-  NS_LOG_INFO (output.str ());
 }
 
 void
@@ -746,30 +866,31 @@ NrPhy::PushFrontSlotAllocInfo (const SfnSf &newSfnSf, const SlotAllocInfo &slotA
 {
   NS_LOG_FUNCTION (this);
 
-  m_slotAllocInfo.push_front (slotAllocInfo);
-  SfnSf currentSfn = newSfnSf;
-  std::unordered_map<uint64_t, Ptr<PacketBurst>> newBursts; // map between new sfn and the packet burst
-  std::unordered_map<uint64_t, uint64_t> sfnMap; // map between new and old sfn, for debugging
+  // all the slot allocations (and their packet burst) have to be "adjusted":
+  // they are taken out of the ring, in order, and stored again in consecutive
+  // slots starting from newSfnSf, with the burst of their data allocations.
+  std::vector<std::pair<SlotAllocInfo, std::vector<std::pair<uint16_t, Ptr<PacketBurst>>>>> allocs;
+  allocs.emplace_back (slotAllocInfo, std::vector<std::pair<uint16_t, Ptr<PacketBurst>>> ());
+  while (m_numSlotAllocs > 0)
+    {
+      allocs.emplace_back (TakeSlotAlloc (FindSlotEntry (m_firstAllocSlot)),
+                           std::vector<std::pair<uint16_t, Ptr<PacketBurst>>> ());
+    }
 
-  // all the slot allocations  (and their packet burst) have to be "adjusted":
-  // directly modify the sfn for the allocation, and temporarly store the
-  // burst (along with the new sfn) into newBursts.
-  for (auto it = m_slotAllocInfo.begin (); it != m_slotAllocInfo.end (); ++it)
+  for (auto & alloc : allocs)
     {
-      auto slotSfn = it->m_sfnSf;
-      for (const auto &alloc : it->m_varTtiAllocInfo)
+      auto slotSfn = alloc.first.m_sfnSf;
+      for (const auto &varTti : alloc.first.m_varTtiAllocInfo)
         {
-          if (alloc.m_dci->m_type == DciInfoElementTdma::DATA)
+          if (varTti.m_dci->m_type == DciInfoElementTdma::DATA)
             {
               //move the pkt burst of all the streams correctly.
-              for (uint8_t stream = 0; stream < alloc.m_dci->m_tbSize.size (); stream++)
+              for (uint8_t stream = 0; stream < varTti.m_dci->m_tbSize.size (); stream++)
                 {
-                  Ptr<PacketBurst> pburst = GetPacketBurst (slotSfn, alloc.m_dci->m_symStart, stream);
+                  Ptr<PacketBurst> pburst = GetPacketBurst (slotSfn, varTti.m_dci->m_symStart, stream);
                   if (pburst && pburst->GetNPackets() > 0)
                     {
-                      newBursts.insert (std::make_pair (currentSfn.GetEncodingWithSymStart (alloc.m_dci->m_symStart), pburst));
-                      sfnMap.insert (std::make_pair (currentSfn.GetEncodingWithSymStart (alloc.m_dci->m_symStart),
-                                                     it->m_sfnSf.GetEncodingWithSymStart (alloc.m_dci->m_symStart)));
+                      alloc.second.emplace_back (static_cast<uint16_t> ((stream << 8) | varTti.m_dci->m_symStart), pburst);
                     }
                   else
                     {
@@ -778,20 +899,22 @@ NrPhy::PushFrontSlotAllocInfo (const SfnSf &newSfnSf, const SlotAllocInfo &slotA
                 }
             }
         }
-
-      NS_LOG_INFO ("Set slot allocation for " << it->m_sfnSf << " to " << currentSfn);
-      it->m_sfnSf = currentSfn;
-      currentSfn.Add (1);
     }
 
-  for (const auto & burstPair : newBursts)
+  SfnSf currentSfn = newSfnSf;
+  for (auto & alloc : allocs)
     {
-      SfnSf old, latest;
-      old.Decode (sfnMap.at (burstPair.first));
-      latest.Decode (burstPair.first);
-      m_packetBurstMap.insert (std::make_pair (burstPair.first, burstPair.second));
-      NS_LOG_INFO ("PacketBurst with " << burstPair.second->GetNPackets() <<
-                   "packets for SFN " << old << " now moved to SFN " << latest);
+      NS_LOG_INFO ("Set slot allocation for " << alloc.first.m_sfnSf << " to " << currentSfn);
+      for (const auto & burst : alloc.second)
+        {
+          NS_LOG_INFO ("PacketBurst with " << burst.second->GetNPackets() <<
+                       "packets for SFN " << alloc.first.m_sfnSf << " now moved to SFN " << currentSfn);
+        }
+      alloc.first.m_sfnSf = currentSfn;
+      StoreSlotAlloc (alloc.first);
+      auto & bursts = GetSlotEntry (currentSfn.Normalize ()).m_bursts;
+      bursts.insert (bursts.end (), alloc.second.begin (), alloc.second.end ());
+      currentSfn.Add (1);
     }
 }
 
@@ -801,23 +924,17 @@ NrPhy::SlotAllocInfoExists (const SfnSf &retVal) const
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (retVal.GetNumerology () == GetNumerology ());
-  for (const auto & alloc : m_slotAllocInfo)
-    {
-      if (alloc.m_sfnSf == retVal)
-        {
-          return true;
-        }
-    }
-  return false;
+  const SlotEntry *entry = FindSlotEntry (retVal.Normalize ());
+  return entry != nullptr && entry->m_hasAlloc;
 }
 
 SlotAllocInfo
 NrPhy::RetrieveSlotAllocInfo ()
 {
   NS_LOG_FUNCTION (this);
-  SlotAllocInfo ret = *m_slotAllocInfo.begin ();
-  m_slotAllocInfo.erase (m_slotAllocInfo.begin ());
-  return ret;
+  NS_ASSERT (m_numSlotAllocs > 0);
+  m_ringCurrentSlot = std::max (m_ringCurrentSlot, m_firstAllocSlot);
+  return TakeSlotAlloc (FindSlotEntry (m_firstAllocSlot));
 }
 
 
@@ -827,14 +944,12 @@ NrPhy::RetrieveSlotAllocInfo (const SfnSf &sfnsf)
   NS_LOG_FUNCTION (" slot " << sfnsf);
   NS_ASSERT (sfnsf.GetNumerology () == GetNumerology ());
 
-  for (auto allocIt = m_slotAllocInfo.begin(); allocIt != m_slotAllocInfo.end (); ++allocIt)
+  uint64_t slot = sfnsf.Normalize ();
+  SlotEntry *entry = FindSlotEntry (slot);
+  if (entry != nullptr && entry->m_hasAlloc)
     {
-      if (allocIt->m_sfnSf == sfnsf)
-        {
-          SlotAllocInfo ret = *allocIt;
-          m_slotAllocInfo.erase (allocIt);
-          return ret;
-        }
+      m_ringCurrentSlot = std::max (m_ringCurrentSlot, slot);
+      return TakeSlotAlloc (entry);
     }
 
   NS_FATAL_ERROR("Didn't found the slot");
@@ -846,12 +961,10 @@ NrPhy::PeekSlotAllocInfo (const SfnSf &sfnsf)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (sfnsf.GetNumerology () == GetNumerology ());
-  for (auto & alloc : m_slotAllocInfo)
+  SlotEntry *entry = FindSlotEntry (sfnsf.Normalize ());
+  if (entry != nullptr && entry->m_hasAlloc)
     {
-      if (alloc.m_sfnSf == sfnsf)
-        {
-          return alloc;
-        }
+      return entry->m_alloc;
     }
 
   NS_FATAL_ERROR ("Didn't found the slot");
@@ -861,14 +974,40 @@ size_t
 NrPhy::SlotAllocInfoSize() const
 {
   NS_LOG_FUNCTION (this);
-  return m_slotAllocInfo.size ();
+  return m_numSlotAllocs;
+}
+
+bool
+NrPhy::GetFirstSlotAllocSfnSf (SfnSf *sfnsf) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_numSlotAllocs == 0)
+    {
+      return false;
+    }
+  *sfnsf = FindSlotEntry (m_firstAllocSlot)->m_alloc.m_sfnSf;
+  return true;
 }
 
 bool
 NrPhy::IsCtrlMsgListEmpty() const
 {
   NS_LOG_FUNCTION (this);
-  return m_controlMessageQueue.empty () || m_controlMessageQueue.at (0).empty();
+  return m_controlMessageQueue.empty () || m_controlMessageQueue.at (m_ctrlMsgHead).empty ();
+}
+
+bool
+NrPhy::IsCtrlMsgQueueEmpty () const
+{
+  NS_LOG_FUNCTION (this);
+  for (const auto & list : m_controlMessageQueue)
+    {
+      if (! list.empty ())
+        {
+          return false;
+        }
+    }
+  return true;
 }
 
 Ptr<const SpectrumModel>
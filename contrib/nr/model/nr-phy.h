@@ -44,29 +44,33 @@ class BeamConfId;
  *
  * \section phy_management_ctrl Management of the control message list
  *
- * The control message list is maintained as a list that has, always, a number
- * of element equals to the latency between PHY and MAC, plus one. The list
+ * The control message list is maintained as a ring of lists that has, always,
+ * a number of element equals to the latency between PHY and MAC, plus one. The ring
  * is initialized by a call to InitializeMessageList(). The messages
- * are enqueued by MAC at the end of the list through the method EnqueueCtrlMessage().
+ * are enqueued by MAC at the end of the ring through the method EnqueueCtrlMessage().
  * If the PHY has the necessity of adding a message, then it can use the
  * no-latency version of it, namely EnqueueCtrlMsgNow(). The messages for the
- * current slot (i.e., the messages at the front of the list) can be retrieved
- * with PopCurrentSlotCtrlMsgs(). To know if there are messages for the current
- * slot, use IsCtrlMsgListEmpty(). The list is stored in the variable
- * m_controlMessageQueue.
+ * current slot (i.e., the messages at the head of the ring) can be retrieved
+ * with PopCurrentSlotCtrlMsgs(), that advances the head by one slot. To know
+ * if there are messages for the current slot, use IsCtrlMsgListEmpty(). The
+ * ring is stored in the variable m_controlMessageQueue.
  *
  * \section phy_slot Management of the slot allocation list
  *
  * At the gNb, After the MAC does the slot allocation, it is saved in the PHY with the method
  * PushBackSlotAllocInfo(), and if an allocation for the same slot is already
- * present, the two will be merged together. The slot allocation is stored
- * inside the variable m_slotAllocInfo.
+ * present, the two will be merged together. The slot allocations are stored
+ * in the ring m_slotRing, indexed by the absolute slot number
+ * (SfnSf::Normalize) modulo the size of the ring: finding, peeking or
+ * retrieving the allocation of a slot is a direct access. The ring covers
+ * the scheduling horizon (see ReserveSlotAllocHorizon()), and it grows if
+ * an allocation falls beyond it.
  *
  * \section phy_mac_pdu Management of the MAC PDU that waits to be transmitted
  *
  * With each allocation, will come also one (or more) MAC PDU, that are stored
- * within the method SetMacPdu(). The storage is based on the SfnSf inside the
- * variable m_packetBurstMap.
+ * within the method SetMacPdu(). The PDUs are stored in the entry of their
+ * slot in m_slotRing, next to the slot allocation.
  *
  * \section phy_numerology Configuration of the numerology and the related settings
  *
@@ -140,6 +144,13 @@ public:
    */
   void NotifyConnectionSuccessful ();
 
+  /**
+   * \brief Notify PHY that the MAC has something new to do
+   *
+   * \see NrPhySapProvider::NotifyMacActivity
+   */
+  virtual void NotifyMacActivity ();
+
   /**
    * \brief Configures TB decode latency
    * \param us decode latency
@@ -541,12 +552,38 @@ protected:
    */
   size_t SlotAllocInfoSize () const;
 
+  /**
+   * \brief Retrieve the SfnSf of the first slot that has an allocation
+   * \param sfnsf where the SfnSf is stored
+   * \return false if there are no allocations stored
+   */
+  bool GetFirstSlotAllocSfnSf (SfnSf *sfnsf) const;
+
+  /**
+   * \brief Make the slot ring cover at least the specified number of slots
+   *
+   * The allocations are stored at most a few slots in advance (the
+   * L1L2CtrlLatency plus the K0/K1/K2 delays, or a configured grant period);
+   * sizing the ring to that horizon at the start avoids to grow it later.
+   *
+   * \param slots the number of slots between the current slot and the
+   * furthest allocation
+   */
+  void ReserveSlotAllocHorizon (uint32_t slots);
+
   /**
    * \brief Check if there are no control messages queued for this slot
    * \return true if there are no control messages queued for this slot
    */
   bool IsCtrlMsgListEmpty () const;
 
+  /**
+   * \brief Check if there are no control messages queued, for this slot and
+   * for all the next slots
+   * \return true if no control message is waiting in the queue
+   */
+  bool IsCtrlMsgQueueEmpty () const;
+
   /**
    * \brief Enqueue a CTRL message without considering L1L2CtrlLatency
    * \param msg The message to enqueue
@@ -576,8 +613,6 @@ protected:
   double m_txPower {0.0};                //!< Transmission power (attribute)
   double m_noiseFigure {0.0};            //!< Noise figure (attribute)
 
-  std::unordered_map<uint64_t, Ptr<PacketBurst> > m_packetBurstMap; //!< Map between SfnSf and PacketBurst
-
   SlotAllocInfo m_currSlotAllocInfo;  //!< Current slot allocation
 
   NrPhySapProvider* m_phySapProvider; //!< Pointer to the MAC
@@ -592,8 +627,71 @@ protected:
    std::list <Ptr<NrControlMessage>> m_ctrlMsgs_TX;
 
 private:
-  std::list<SlotAllocInfo> m_slotAllocInfo; //!< slot allocation info list
-  std::vector<std::list<Ptr<NrControlMessage>>> m_controlMessageQueue; //!< CTRL message queue
+  /**
+   * \brief Entry of the slot ring: the allocation and the MAC PDUs of a slot
+   */
+  struct SlotEntry
+  {
+    uint64_t m_slot {UINT64_MAX};  //!< Absolute slot (SfnSf::Normalize) of the entry, UINT64_MAX if unused
+    bool m_hasAlloc {false};       //!< True if m_alloc is a pending allocation
+    SlotAllocInfo m_alloc {SfnSf ()}; //!< Allocation of the slot (valid if m_hasAlloc)
+    std::vector<std::pair<uint16_t, Ptr<PacketBurst>>> m_bursts; //!< PacketBurst of the slot, by stream and symbol
+  };
+
+  /**
+   * \brief Find the entry of a slot
+   * \param slot the absolute slot number
+   * \return the entry, or nullptr if the slot has no entry
+   */
+  const SlotEntry * FindSlotEntry (uint64_t slot) const;
+
+  /**
+   * \brief Find the entry of a slot
+   * \param slot the absolute slot number
+   * \return the entry, or nullptr if the slot has no entry
+   */
+  SlotEntry * FindSlotEntry (uint64_t slot);
+
+  /**
+   * \brief Get the entry of a slot, assigning it if needed
+   *
+   * The ring grows if the position of the slot is taken by a pending
+   * allocation, or by the MAC PDUs of a slot that is not over yet. The MAC
+   * PDUs of a past slot were not claimed by the PHY: they are discarded.
+   *
+   * \param slot the absolute slot number
+   * \return the entry of the slot
+   */
+  SlotEntry & GetSlotEntry (uint64_t slot);
+
+  /**
+   * \brief Store an allocation in its (free) entry, updating the first and
+   * last allocated slots
+   * \param slotAllocInfo the allocation
+   */
+  void StoreSlotAlloc (const SlotAllocInfo &slotAllocInfo);
+
+  /**
+   * \brief Remove the allocation from an entry, updating the first and last
+   * allocated slots
+   * \param entry the entry
+   * \return the allocation
+   */
+  SlotAllocInfo TakeSlotAlloc (SlotEntry *entry);
+
+  /**
+   * \brief Double the size of the slot ring, moving the entries
+   */
+  void GrowSlotRing ();
+
+  std::vector<SlotEntry> m_slotRing;     //!< Ring of the slots, the size is a power of two
+  uint32_t m_numSlotAllocs {0};          //!< Number of pending allocations in the ring
+  uint64_t m_firstAllocSlot {UINT64_MAX}; //!< First slot with a pending allocation
+  uint64_t m_lastAllocSlot {0};          //!< Last slot with a pending allocation
+  uint64_t m_ringCurrentSlot {0};        //!< Latest slot whose allocation was retrieved
+
+  std::vector<std::list<Ptr<NrControlMessage>>> m_controlMessageQueue; //!< CTRL message ring
+  std::size_t m_ctrlMsgHead {0};         //!< Position of the current slot in m_controlMessageQueue
 
   Time m_tbDecodeLatencyUs {MicroSeconds(100)}; //!< transport block decode latency
   double m_centralFrequency {-1.0};             //!< Channel central frequency -- set by the helper
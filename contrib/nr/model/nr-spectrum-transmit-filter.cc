@@ -0,0 +1,79 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "nr-spectrum-transmit-filter.h"
+#include "nr-spectrum-phy.h"
+#include "nr-gnb-net-device.h"
+#include <ns3/log.h>
+#include <ns3/boolean.h>
+#include <ns3/spectrum-signal-parameters.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrSpectrumTransmitFilter");
+NS_OBJECT_ENSURE_REGISTERED (NrSpectrumTransmitFilter);
+
+TypeId
+NrSpectrumTransmitFilter::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::NrSpectrumTransmitFilter")
+    .SetParent<SpectrumTransmitFilter> ()
+    .SetGroupName ("nr")
+    .AddConstructor<NrSpectrumTransmitFilter> ()
+    .AddAttribute ("UeUeInterference",
+                   "If true, the signals of the UEs reach the other UEs (as "
+                   "interference); if false, the channel skips the UE to UE links",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NrSpectrumTransmitFilter::m_ueUeInterference),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+NrSpectrumTransmitFilter::NrSpectrumTransmitFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+NrSpectrumTransmitFilter::IsNrUe (Ptr<const SpectrumPhy> phy)
+{
+  if (DynamicCast<const NrSpectrumPhy> (phy) == nullptr)
+    {
+      return false;
+    }
+  Ptr<NetDevice> device = phy->GetDevice ();
+  return device != nullptr && DynamicCast<NrGnbNetDevice> (device) == nullptr;
+}
+
+bool
+NrSpectrumTransmitFilter::DoFilter (Ptr<const SpectrumSignalParameters> params,
+                                    Ptr<const SpectrumPhy> receiverPhy) const
+{
+  NS_LOG_FUNCTION (this << params << receiverPhy);
+
+  if (m_ueUeInterference)
+    {
+      return false;
+    }
+
+  return IsNrUe (receiverPhy) && IsNrUe (params->txPhy);
+}
+
+} // namespace ns3
@@ -0,0 +1,80 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef NR_SPECTRUM_TRANSMIT_FILTER_H
+#define NR_SPECTRUM_TRANSMIT_FILTER_H
+
+#include <ns3/spectrum-transmit-filter.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ * \brief Filter of the NR links that no PHY decodes or counts as interference
+ *
+ * Without sidelink, a UE never decodes the signals of the other UEs, and
+ * NrSpectrumPhy only adds them to the interference. The filter skips, in the
+ * channel, every UE to UE link: the channel does not compute their
+ * propagation loss nor their channel matrix, and does not schedule their
+ * reception, so that the cost of an UL transmission does not grow with the
+ * number of UEs. All the other links (gNB to UE, UE to gNB, gNB to gNB, of
+ * the same cell or of neighbour cells, and with non-NR PHYs) are kept.
+ *
+ * The UE to UE interference (e.g., for cross-link interference studies with
+ * different TDD patterns in neighbour cells) can be kept through the attribute
+ * "UeUeInterference".
+ *
+ * NrHelper installs the filter on the channels that it creates.
+ */
+class NrSpectrumTransmitFilter : public SpectrumTransmitFilter
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \brief NrSpectrumTransmitFilter constructor
+   */
+  NrSpectrumTransmitFilter ();
+
+private:
+  /**
+   * \brief Check if a PHY is the NrSpectrumPhy of a UE
+   * \param phy the PHY
+   * \return true if phy is a NrSpectrumPhy attached to a device that is not a gNB
+   */
+  static bool IsNrUe (Ptr<const SpectrumPhy> phy);
+
+  /**
+   * \brief Skip the UE to UE links, unless UeUeInterference is true
+   * \param params the parameters of the transmitted signal
+   * \param receiverPhy the receiver
+   * \return true if the receiver has to be skipped
+   */
+  virtual bool DoFilter (Ptr<const SpectrumSignalParameters> params,
+                         Ptr<const SpectrumPhy> receiverPhy) const override;
+
+  bool m_ueUeInterference {false}; //!< Keep the UE to UE links
+};
+
+} // namespace ns3
+
+#endif // NR_SPECTRUM_TRANSMIT_FILTER_H
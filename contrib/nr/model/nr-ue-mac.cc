@@ -177,8 +177,14 @@ public:
 
   virtual uint8_t GetNumHarqProcess () const override;
 
+  virtual bool IsIdle () const override;
+
+  virtual void IdleSlotIndication (SfnSf sfn, Time slotStart) override;
+
+  virtual bool GetNextCgOccasion (uint64_t fromSlot, uint64_t *slot) const override;
+
   //Configured Grant
-  virtual bool SlotIndication_configuredGrant (SfnSf sfn) override;
+  virtual void SlotIndication_configuredGrant (SfnSf sfn, std::vector<std::shared_ptr<DciInfoElementTdma> > *ulDcis) override;
 
 private:
   NrUeMac* m_mac;
@@ -213,6 +219,24 @@ MacUeMemberPhySapUser::GetNumHarqProcess () const
   return m_mac->GetNumHarqProcess();
 }
 
+bool
+MacUeMemberPhySapUser::IsIdle () const
+{
+  return m_mac->IsIdle ();
+}
+
+void
+MacUeMemberPhySapUser::IdleSlotIndication (SfnSf sfn, Time slotStart)
+{
+  m_mac->DoIdleSlotIndication (sfn, slotStart);
+}
+
+bool
+MacUeMemberPhySapUser::GetNextCgOccasion (uint64_t fromSlot, uint64_t *slot) const
+{
+  return m_mac->GetNextCgOccasion (fromSlot, slot);
+}
+
 //-----------------------------------------------------------------------
 
 TypeId
@@ -254,6 +278,19 @@ NrUeMac::GetTypeId (void)
                    MakeUintegerAccessor (&NrUeMac::SetCGPeriod,
                                          &NrUeMac::GetCGPeriod),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("CGPeriodSlots",
+                   "The periodicity of configured grant transmissions, in slots. "
+                   "If not 0, it is used in place of CGPeriod, e.g., to have "
+                   "periods shorter than a subframe",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NrUeMac::m_cgPeriodSlots),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CGRepetitions",
+                   "The number of consecutive slots with a configured grant "
+                   "occasion in each period",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&NrUeMac::m_cgRepetitions),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -408,6 +445,8 @@ void
 NrUeMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters params)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (params.lcid));
+  // Wake up the PHY, if it is skipping idle slots, before any state change
+  m_phySapProvider->NotifyMacActivity ();
   ue_mac_Ue_Time_Map[params.rnti] = Simulator::Now().GetMilliSeconds(); // 가장 최신 데이터 생성 시점 저장
 
   auto it = m_ulBsrReceived.find (params.lcid);
@@ -599,6 +638,40 @@ NrUeMac::DoSlotIndication (const SfnSf &sfn)
   // Feedback missing
 }
 
+bool
+NrUeMac::IsIdle () const
+{
+  if (m_cgScheduling)
+    {
+      return m_srState_configuredGrant != TO_SEND_TrafficInfo && m_srState_configuredGrant != SCH_CG_DATA;
+    }
+  return m_srState != TO_SEND;
+}
+
+bool
+NrUeMac::GetNextCgOccasion (uint64_t fromSlot, uint64_t *slot) const
+{
+  if (! m_cgScheduling)
+    {
+      return false;
+    }
+  return m_cgOccasions.GetNextOccasionSlot (fromSlot, slot);
+}
+
+void
+NrUeMac::DoIdleSlotIndication (const SfnSf &sfn, const Time &slotStart)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsIdle ());
+  // An idle MAC does, in DoSlotIndication and DoSlotIndication_configuredGrant,
+  // nothing more than this
+  m_currentSlot = sfn;
+  m_startSlotTime = slotStart;
+  NS_LOG_INFO ("Idle slot " << m_currentSlot);
+
+  RefreshHarqProcessesPacketBuffer ();
+}
+
 void
 NrUeMac::SendSR () const
 {
@@ -677,36 +750,33 @@ NrUeMac::ProcessUlDci (const Ptr<NrUlDciMessage> &dciMsg)
   // It represents the TO_RECEIVE_CG state
   if (m_cgScheduling)
     {
-      m_dciGranted_stored[cg_slot_counter_DCI] = std::make_shared <DciInfoElementTdma> (m_ulDci->m_rnti,
-                                                                                 m_ulDci->m_format,
-                                                                                 m_ulDci->m_symStart,
-                                                                                 m_ulDci->m_numSym,
-                                                                                 m_ulDci->m_mcs,
-                                                                                 m_ulDci->m_tbSize,
-                                                                                 m_ulDci->m_ndi,
-                                                                                 m_ulDci->m_rv,
-                                                                                 m_ulDci->m_type,
-                                                                                 m_ulDci -> m_bwpIndex,
-                                                                                 m_ulDci->m_harqProcess,
-                                                                                 m_ulDci->m_rbgBitmask,
-                                                                                 m_ulDci->m_tpc);
-
-      uint8_t streamId = 0;
-      SfnSf dataSfn_cg = m_currentSlot;
-      uint8_t number_slots_for_processing_configurationPeriod = 5;
-      uint8_t numberOfSlot_insideOneSubframe = pow(2,(m_currentSlot.GetNumerology ()));
-      m_configurationTime = GetConfigurationTime();
-      uint8_t number_slots_configuration = (GetConfigurationTime()*numberOfSlot_insideOneSubframe)-number_slots_for_processing_configurationPeriod;
-      dataSfn_cg.Add(number_slots_configuration);
-      uint64_t key = dataSfn_cg.GetEncForStreamWithSymStart (streamId, m_dciGranted_stored[cg_slot_counter_DCI]->m_symStart);
-
-      auto it_1 = m_dci_cg_map.find (key);
-
-      if (it_1 == m_dci_cg_map.end ())
+      auto dci = std::make_shared <DciInfoElementTdma> (m_ulDci->m_rnti,
+                                                        m_ulDci->m_format,
+                                                        m_ulDci->m_symStart,
+                                                        m_ulDci->m_numSym,
+                                                        m_ulDci->m_mcs,
+                                                        m_ulDci->m_tbSize,
+                                                        m_ulDci->m_ndi,
+                                                        m_ulDci->m_rv,
+                                                        m_ulDci->m_type,
+                                                        m_ulDci -> m_bwpIndex,
+                                                        m_ulDci->m_harqProcess,
+                                                        m_ulDci->m_rbgBitmask,
+                                                        m_ulDci->m_tpc);
+
+      // The DCIs received in the configuration phase are the resources of the
+      // default configuration. Their first occasion is at the end of the
+      // configuration phase; then, they repeat every period.
+      if (! m_hasDefaultCgConfig)
         {
-          it_1 = m_dci_cg_map.insert (std::make_pair (key, m_dciGranted_stored[cg_slot_counter_DCI])).first;
-          cg_slot_counter_DCI = cg_slot_counter_DCI +1;
+          m_defaultCgConfig = m_cgOccasions.AddConfig (GetCgPeriodSlots (), m_cgRepetitions);
+          m_hasDefaultCgConfig = true;
         }
+      uint32_t number_slots_for_processing_configurationPeriod = 5;
+      uint32_t number_slots_configuration = (GetConfigurationTime () * m_currentSlot.GetSlotPerSubframe ()) - number_slots_for_processing_configurationPeriod;
+      m_cgOccasions.AddResource (m_defaultCgConfig,
+                                 m_currentSlot.Normalize () + number_slots_configuration,
+                                 dci);
     }
 
   m_macRxedCtrlMsgsTrace (m_currentSlot, GetCellId (), m_rnti, GetBwpId (), dciMsg);
@@ -1130,6 +1200,7 @@ NrUeMac::SendRaPreamble ([[maybe_unused]] bool contention)
   rachMsg->SetSourceBwp (GetBwpId ());
   m_macTxedCtrlMsgsTrace (m_currentSlot, GetCellId (), m_rnti, GetBwpId (), rachMsg);
 
+  m_phySapProvider->NotifyMacActivity ();
   m_phySapProvider->SendRachPreamble (m_raPreambleId, m_raRnti);
 }
 
@@ -1182,13 +1253,15 @@ NrUeMac::AssignStreams (int64_t stream)
 
 //Configured Grant
 
-bool  MacUeMemberPhySapUser::SlotIndication_configuredGrant (SfnSf sfn)
+void
+MacUeMemberPhySapUser::SlotIndication_configuredGrant (SfnSf sfn, std::vector<std::shared_ptr<DciInfoElementTdma> > *ulDcis)
 {
-  return m_mac->DoSlotIndication_configuredGrant(sfn);
+  m_mac->DoSlotIndication_configuredGrant (sfn, ulDcis);
 }
 
-bool
-NrUeMac::DoSlotIndication_configuredGrant (const SfnSf &sfn)
+void
+NrUeMac::DoSlotIndication_configuredGrant (const SfnSf &sfn,
+                                           std::vector<std::shared_ptr<DciInfoElementTdma> > *ulDcis)
 {
 
   NS_LOG_FUNCTION (this);
@@ -1221,65 +1294,37 @@ NrUeMac::DoSlotIndication_configuredGrant (const SfnSf &sfn)
       SendTrafficInfo();
 
       m_srState_configuredGrant = TO_RECEIVE_CG;
-      configuredGrant_state = false;
-      return configuredGrant_state;
     }
   else if (m_srState_configuredGrant == SCH_CG_DATA)
     {
-
-      if (m_dciGranted_stored[cg_slot_counter_DCI_2] == nullptr)
-        {
-          // The packet has already been transmitted, we switch to the ACTIVE_CG status,
-          // We will be in this state until the following periodic transmission.
-          m_srState_configuredGrant = ACTIVE_CG;
-          cg_slot_counter_DCI_2 = 0;
-        }
-      else
+      // Transmit in the occasions of this slot, until the buffer is empty.
+      // Then, we switch to the ACTIVE_CG status, and we will be there until
+      // the following packet.
+      m_cgOccasions.GetOccasions (m_currentSlot.Normalize (), &m_cgSlotOccasions);
+      for (const auto & occasion : m_cgSlotOccasions)
         {
-          uint8_t streamId = 0;
-          auto it = m_dci_cg_map.find (m_currentSlot.GetEncForStreamWithSymStart (streamId, m_dciGranted_stored[cg_slot_counter_DCI_2]->m_symStart));
-
-          if (it == m_dci_cg_map.end ())
+          if (GetTotalBufSize () == 0)
             {
-              // Do nothing
+              break;
             }
-          else
-            {
-              // Processes the current packet
-              m_ulDciSfnsf = m_currentSlot;
-              m_ulDci = it->second;
-              m_dci_cg_map.erase (it);
-              ProcessULPacket();
-
-              NS_LOG_INFO ("Sending a packet to PHY layer in slot " << m_ulDciSfnsf);
-
-              // Prepare resources for future transmission
-              SfnSf dataSfn_cg = m_currentSlot;
-              uint8_t numberOfSlot_insideOneSubframe = pow(2,(m_currentSlot.GetNumerology ()));
-              m_cgPeriod = GetCGPeriod();
-              uint8_t number_slots_configuration = (m_cgPeriod*numberOfSlot_insideOneSubframe);
-              dataSfn_cg.Add(number_slots_configuration);
-              uint64_t key = dataSfn_cg.GetEncForStreamWithSymStart (streamId, m_dciGranted_stored[cg_slot_counter_DCI_2]->m_symStart);
-
-              auto it_1 = m_dci_cg_map.find (key);
-
-              if (it_1 == m_dci_cg_map.end ())
-                {
-                  it_1 = m_dci_cg_map.insert (std::make_pair (key, m_dciGranted_stored[cg_slot_counter_DCI_2])).first;
-                  cg_slot_counter_DCI_2 = cg_slot_counter_DCI_2 +1;
-                }
+          m_ulDciSfnsf = m_currentSlot;
+          m_ulDci = occasion.m_dci;
+          ProcessULPacket ();
+          ulDcis->push_back (occasion.m_dci);
 
-            }
+          NS_LOG_INFO ("Sending a packet to PHY layer in slot " << m_ulDciSfnsf <<
+                       " with the configuration " << +occasion.m_configId);
+        }
+
+      if (GetTotalBufSize () == 0)
+        {
+          m_srState_configuredGrant = ACTIVE_CG;
+          NS_LOG_INFO ("SCH_CG_DATA -> ACTIVE_CG");
         }
-      //Send the SCH_CG_DATA state to UE-PHY
-      configuredGrant_state = true;
-      return configuredGrant_state;
     }
   else
     {
       m_startSlotTime = Simulator::Now ();
-      configuredGrant_state = false;
-      return configuredGrant_state;
     }
   // Feedback missing
 }
@@ -1369,6 +1414,33 @@ NrUeMac::SetCGPeriod (uint8_t v)
   m_cgPeriod = v;
 }
 
+uint32_t
+NrUeMac::GetCgPeriodSlots () const
+{
+  if (m_cgPeriodSlots > 0)
+    {
+      return m_cgPeriodSlots;
+    }
+  return m_cgPeriod * m_currentSlot.GetSlotPerSubframe ();
+}
+
+uint8_t
+NrUeMac::AddCgConfig (uint32_t periodSlots, uint32_t repetitions)
+{
+  NS_LOG_FUNCTION (this << periodSlots << repetitions);
+  return m_cgOccasions.AddConfig (periodSlots, repetitions);
+}
+
+void
+NrUeMac::AddCgResource (uint8_t configId, const SfnSf &firstOccasion,
+                        const std::shared_ptr<DciInfoElementTdma> &dci)
+{
+  NS_LOG_FUNCTION (this << +configId << firstOccasion);
+  NS_ABORT_MSG_IF (configId >= m_cgOccasions.GetNumConfigs (),
+                   "Configured grant configuration " << +configId << " does not exist");
+  m_cgOccasions.AddResource (configId, firstOccasion.Normalize (), dci);
+}
+
 void
 NrUeMac::SetCG (bool CGsch)
 {
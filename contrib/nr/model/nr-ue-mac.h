@@ -22,6 +22,7 @@
 
 #include "nr-phy-mac-common.h"
 #include "nr-mac-pdu-info.h"
+#include "nr-cg-occasion-table.h"
 #include "nr-ue-phy.h"
 
 
@@ -233,6 +234,31 @@ public:
   void SetCGPeriod (uint8_t CGPeriod);
   uint8_t GetCGPeriod () const;
 
+  /**
+   * \brief Add a configured grant configuration, in addition to the default one
+   * \param periodSlots the periodicity of the occasions, in slots
+   * \param repetitions the number of consecutive slots with an occasion in each period
+   * \return the ID of the configuration, to be used in AddCgResource()
+   *
+   * The default configuration is created when the first configured grant is
+   * received, with the periodicity of the attributes CGPeriodSlots (or CGPeriod)
+   * and CGRepetitions; its resources are the DCIs received in the
+   * configuration phase. The other configurations let the UE transmit,
+   * e.g., a fast periodic flow alongside a slower one; the gNB has to be
+   * configured accordingly.
+   */
+  uint8_t AddCgConfig (uint32_t periodSlots, uint32_t repetitions = 1);
+
+  /**
+   * \brief Add a resource to a configured grant configuration
+   * \param configId the ID of the configuration
+   * \param firstOccasion the slot of the first occasion of the resource; it
+   * also sets the offset of the resource in the period
+   * \param dci the DCI with the resources of the transmissions
+   */
+  void AddCgResource (uint8_t configId, const SfnSf &firstOccasion,
+                      const std::shared_ptr<DciInfoElementTdma> &dci);
+
 protected:
   /**
    * \brief DoDispose method inherited from Object
@@ -266,6 +292,27 @@ private:
    */
   void DoSlotIndication (const SfnSf &sfn);
 
+  /**
+   * \brief Check if the MAC is idle, i.e., it has no SR or CG data to process
+   * \return true if the MAC has nothing to do until new data or a DCI arrives
+   */
+  bool IsIdle () const;
+
+  /**
+   * \brief Get the first slot with a configured grant occasion
+   * \param fromSlot the first slot to consider
+   * \param slot the first slot, not before fromSlot, with an occasion
+   * \return false if there are no configured grant occasions
+   */
+  bool GetNextCgOccasion (uint64_t fromSlot, uint64_t *slot) const;
+
+  /**
+   * \brief The PHY resumed in the middle of a slot, after skipping idle slots
+   * \param sfn the slot
+   * \param slotStart the time at which the slot started
+   */
+  void DoIdleSlotIndication (const SfnSf &sfn, const Time &slotStart);
+
   /**
    * \brief Get the total size of the RLC buffers.
    * \return The number of bytes that are in the RLC buffers
@@ -403,11 +450,15 @@ private:
   /**
    * \brief We begin a new slot
    * \param sfn the new slot
-   * \param totalSymConfGrant the number of total allocated symbols
-   * \return Send to the PHY (true) if it is transmission phase and a
-   * new packet is generated in the UE.
+   * \param ulDcis filled with the DCIs of the configured grant occasions in
+   * which the MAC transmitted in this slot (transmission phase)
+   */
+  void DoSlotIndication_configuredGrant (const SfnSf &sfn,
+                                         std::vector<std::shared_ptr<DciInfoElementTdma> > *ulDcis);
+  /**
+   * \return the periodicity of the default configured grant configuration, in slots
    */
-  bool DoSlotIndication_configuredGrant (const SfnSf &sfn);
+  uint32_t GetCgPeriodSlots () const;
   /**
    * \brief Called by CCM
    * \param params the BSR params
@@ -554,22 +605,18 @@ private:
   };
   SrCgMachine m_srState_configuredGrant {INACTIVE_CG};   //!< Default state for the configured grant state machine.
 
-  std::shared_ptr<DciInfoElementTdma> m_dciGranted_stored[100]; //!< The stored DCI-s for CG allocation.
-                                                                //!< [num] is the maximum number of
-                                                                //!< slots that can be configured
-
+  NrCgOccasionTable m_cgOccasions; //!< The configured grant occasions
+  std::vector<NrCgOccasionTable::Occasion> m_cgSlotOccasions; //!< The occasions of the current slot
+  uint8_t m_defaultCgConfig {0};       //!< ID of the default configuration
+  bool m_hasDefaultCgConfig {false};   //!< True when the default configuration is created
+  uint32_t m_cgPeriodSlots {0};        //!< Periodicity of the default configuration, in slots (0: use m_cgPeriod)
+  uint32_t m_cgRepetitions {1};        //!< Repetitions of the default configuration
 
   uint8_t m_totalGrantedSymbols {0};
-  bool configuredGrant_state = false; //!< It indicates to the PHY layer if
-                                      //!< a new message is generated in the
-                                      //!< transmission phase.
 
   uint8_t cg_slot_counter = 0;
   bool newSlot = false;
   bool newSlot_continue = false;
-  std::unordered_map <uint64_t, std::shared_ptr<DciInfoElementTdma>> m_dci_cg_map;
-  uint8_t cg_slot_counter_DCI = 0;
-  uint8_t cg_slot_counter_DCI_2 = 0;
 
   uint8_t m_configurationTime = 0;
   uint8_t m_cgPeriod = 0;
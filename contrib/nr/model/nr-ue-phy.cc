@@ -158,6 +158,17 @@ NrUePhy::GetTypeId (void)
                    MakeDoubleAccessor (&NrUePhy::SetRiSinrThreshold2,
                                        &NrUePhy::GetRiSinrThreshold2),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("EventDrivenSlots",
+                   "If true, the UE stops the per-slot processing when it is idle, "
+                   "i.e., when it has no allocations in the next slot, no CTRL "
+                   "messages to send, and nothing to do in the MAC. The UE is woken "
+                   "up at the slot of the next known allocation (e.g., a configured "
+                   "grant occasion), when it receives a CTRL message (e.g., a DCI), "
+                   "or when new data arrives in the MAC buffers. While idle, the "
+                   "current SfnSf of the UE is not updated.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NrUePhy::m_eventDrivenSlots),
+                   MakeBooleanChecker ())
     .AddTraceSource ("DlDataSinr",
                      "DL DATA SINR statistics.",
                      MakeTraceSourceAccessor (&NrUePhy::m_dlDataSinrTrace),
@@ -198,6 +209,11 @@ NrUePhy::GetTypeId (void)
                      "Power Spectral Density data.",
                      MakeTraceSourceAccessor (&NrUePhy::m_reportPowerSpectralDensity),
                      "ns3::NrUePhy::PowerSpectralDensityTracedCallback")
+    .AddTraceSource ("SlotStart",
+                     "The UE starts the processing of a slot. With EventDrivenSlots, "
+                     "the slots skipped while idle are not reported.",
+                     MakeTraceSourceAccessor (&NrUePhy::m_slotStartTrace),
+                     "ns3::NrUePhy::SlotStartTracedCallback")
      // Configured Grant
     .AddAttribute ("CG",
                    "Activate configured grant scheduling for UL periodic transmissions",
@@ -210,13 +226,19 @@ NrUePhy::GetTypeId (void)
                    UintegerValue (10),
                    MakeUintegerAccessor (&NrUePhy::SetConfigurationTime,
                                          &NrUePhy::GetConfigurationTime),
-                   MakeUintegerChecker<uint8_t> ())
+                   MakeUintegerChecker<uint8_t> (),
+                   TypeId::DEPRECATED,
+                   "The configured grant occasions are computed by NrUeMac; "
+                   "use ns3::NrUeMac::ConfigurationTime")
     .AddAttribute ("CGPeriod",
                   "The periodicity of configured grant transmissions",
                    UintegerValue (10),
                    MakeUintegerAccessor (&NrUePhy::SetCGPeriod,
                                          &NrUePhy::GetCGPeriod),
-                   MakeUintegerChecker<uint8_t> ())
+                   MakeUintegerChecker<uint8_t> (),
+                   TypeId::DEPRECATED,
+                   "The configured grant occasions are computed by NrUeMac; "
+                   "use ns3::NrUeMac::CGPeriod or ns3::NrUeMac::CGPeriodSlots")
       ;
   return tid;
 }
@@ -312,6 +334,7 @@ NrUePhy::DoSendControlMessage (Ptr<NrControlMessage> msg)
 {
   NS_LOG_FUNCTION (this << msg);
   EnqueueCtrlMessage (msg);
+  WakeUp ();
 }
 
 void
@@ -319,6 +342,7 @@ NrUePhy::DoSendControlMessageNow (Ptr<NrControlMessage> msg)
 {
   NS_LOG_FUNCTION (this << msg);
   EnqueueCtrlMsgNow (msg);
+  WakeUp ();
 }
 
 void
@@ -481,6 +505,31 @@ NrUePhy::PhyCtrlMessagesReceived (const Ptr<NrControlMessage> &msg)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_idle)
+    {
+      std::shared_ptr<DciInfoElementTdma> dci;
+      if (msg->GetMessageType () == NrControlMessage::DL_DCI)
+        {
+          dci = DynamicCast<NrDlDciMessage> (msg)->GetDciInfoElement ();
+        }
+      else if (msg->GetMessageType () == NrControlMessage::UL_DCI)
+        {
+          dci = DynamicCast<NrUlDciMessage> (msg)->GetDciInfoElement ();
+        }
+
+      if (dci && dci->m_rnti != 0 && dci->m_rnti != m_rnti)
+        {
+          // DCI not for me, we can stay idle
+          SfnSf currentSlot = m_currentSlot;
+          currentSlot.Add (GetIdleSlotsElapsed ());
+          m_phyRxedCtrlMsgsTrace (currentSlot, GetCellId (), m_rnti, GetBwpId (), msg);
+          return;
+        }
+
+      // the message refers to the current slot, that must be rebuilt first
+      ResumeIdleSlot ();
+    }
+
   if (msg->GetMessageType () == NrControlMessage::DL_DCI)
     {
       auto dciMsg = DynamicCast<NrDlDciMessage> (msg);
@@ -551,22 +600,8 @@ NrUePhy::PhyCtrlMessagesReceived (const Ptr<NrControlMessage> &msg)
             {
               // We allocate resources for a frist trnasmission followeb by receiving CG,
               // this transmission is not necessary, but we will perform it to empty the buffer.
-              InsertFutureAllocation (ulSfnSf, dciInfoElem);
-
-              /** We allocate resources for ht efirst trnasmission where the UEs
-               * do not have to request resources to transmit the packet
-               *
-               *  Number Of Slots = (number of sub-frames for configuration period)*(number of slots inside a sub-frame 2 power of numerology) - 3 slots - 4 slots
-               *  3 slots => (number of slots until gNB receives UL CTRL (SR), this number is fixed in this scenario -> L2L1processing)
-               *  4 slots => (the slots are prepared in DoSlotUlIndication for 4 slots later, this number is fixed in this scenario -> k2 = 4)
-               *
-               *
-               *  If configuration period is 10ms and numerology is 1 : Number of slots = (10*2)-3-4 = 20-7 = 13 slots*/
-              uint8_t numberOfSlot_insideOneSubframe = pow(2,GetNumerology ());
-              uint8_t number_slots_for_processing_configurationPeriod = 7;
-              uint8_t number_slots_configuration = (configurationTime*numberOfSlot_insideOneSubframe)-number_slots_for_processing_configurationPeriod;
-              ulSfnSf.Add(number_slots_configuration);
-
+              // The following transmissions, in the configured grant
+              // occasions, are allocated when the MAC uses them.
               InsertFutureAllocation (ulSfnSf, dciInfoElem);
             }
           else
@@ -760,58 +795,19 @@ NrUePhy::StartSlot (const SfnSf &s)
   NS_LOG_FUNCTION (this);
   m_currentSlot = s;
   m_lastSlotStart = Simulator::Now ();
+  m_slotStartTrace (m_currentSlot, false);
 
-  // If the configured grant is used, the physical layer must know if the UE is
-  // in SCH_CG_DATA state in order to prepare the resources for the transmission of the next packet.
-  // The resources are stored using InsertFutureAllocation
+  // If the configured grant is used, the MAC transmits in the configured
+  // grant occasions of this slot, if it has data; the PHY allocates the
+  // occasions that the MAC used, before retrieving the slot allocations.
   if (m_cgScheduling)
     {
-      // The UE PHY layer receives the information from the MAC layer if a new packet is generated in the UE (transmission phase).
-       m_ulPacketToTransmit = m_phySapUser->SlotIndication_configuredGrant (m_currentSlot);
-
-       if (m_ulPacketToTransmit)
-         {
-           if (m_dciGranted[cg_slot_counter_futureTx] == nullptr)
-             {
-               cg_slot_counter_futureTx = 0;
-             }
-           else
-             {
-               uint8_t streamId = 0;
-               auto it = m_dci_cg_map.find (m_currentSlot.GetEncForStreamWithSymStart (streamId, m_dciGranted[cg_slot_counter_futureTx]->m_symStart));
-
-               if (it == m_dci_cg_map.end ())
-                 {
-                   // Do nothing
-                 }
-               else
-                 {
-                   SfnSf m_sfnsfConfiguredGrantPeriod = m_currentSlot;
-                   uint8_t numberOfSlot_insideOneSubframe = pow(2,GetNumerology ());
-                   // Calculate in which symbol starts the next periodic transmission
-                   m_sfnsfConfiguredGrantPeriod.Add(numberOfSlot_insideOneSubframe*configuredGrant_periodicity);
-
-                   m_ulDci = it->second;
-
-                   InsertFutureAllocation(m_sfnsfConfiguredGrantPeriod, m_ulDci);
-
-                   m_dci_cg_map.erase (it);
-
-                   NS_LOG_INFO ("Sending a packet to PHY layer in slot " << m_sfnsfConfiguredGrantPeriod);
-
-                   uint64_t key = m_sfnsfConfiguredGrantPeriod.GetEncForStreamWithSymStart (streamId, m_dciGranted[cg_slot_counter_futureTx]->m_symStart);
-
-                   auto it_1 = m_dci_cg_map.find (key);
-
-                   if (it_1 == m_dci_cg_map.end ())
-                     {
-                       it_1 = m_dci_cg_map.insert (std::make_pair (key, m_dciGranted[cg_slot_counter_futureTx])).first;
-                       cg_slot_counter_futureTx = cg_slot_counter_futureTx +1;
-                     }
-
-                 }
-             }
-         }
+      m_cgUlDcis.clear ();
+      m_phySapUser->SlotIndication_configuredGrant (m_currentSlot, &m_cgUlDcis);
+      for (const auto & dci : m_cgUlDcis)
+        {
+          InsertFutureAllocation (m_currentSlot, dci);
+        }
     }
   else
     {
@@ -1158,52 +1154,18 @@ NrUePhy::EndVarTti (const std::shared_ptr<DciInfoElementTdma> &dci)
       // end of slot
       m_currentSlot.Add (1);
 
-      Simulator::Schedule (m_lastSlotStart + GetSlotPeriod () - Simulator::Now (),
-                           &NrUePhy::StartSlot, this, m_currentSlot);
+      if (m_eventDrivenSlots && IsIdle ())
+        {
+          SkipIdleSlots ();
+        }
+      else
+        {
+          Simulator::Schedule (m_lastSlotStart + GetSlotPeriod () - Simulator::Now (),
+                               &NrUePhy::StartSlot, this, m_currentSlot);
+        }
     }
   else
     {
-      // In the case of configured grant scheduling, the CG information
-      // transmitted by the gNB to the UE must be saved in the phy layer.
-      // The UE-MAC is currently in the TO_RECEIVE_CG state.
-      if (m_cgScheduling)
-        {
-          if (dci->m_type == DciInfoElementTdma::DATA && dci->m_format == DciInfoElementTdma::UL && m_ulPacketToTransmit == false)
-            {
-              m_dciGranted[cg_slot_counter] = std::make_shared <DciInfoElementTdma> (dci->m_rnti,
-                                                                                  dci->m_format,
-                                                                                  dci->m_symStart,
-                                                                                  dci->m_numSym,
-                                                                                  dci->m_mcs,
-                                                                                  dci->m_tbSize,
-                                                                                  dci->m_ndi,
-                                                                                  dci->m_rv,
-                                                                                  dci->m_type,
-                                                                                  dci -> m_bwpIndex,
-                                                                                  dci->m_harqProcess,
-                                                                                  dci->m_rbgBitmask,
-                                                                                  dci->m_tpc);
-
-              uint8_t streamId = 0;
-              SfnSf dataSfn_cg = m_currentSlot;
-              uint8_t number_slots_for_processing_configurationPeriod = 7; //5 in the mac 7 in the phy becasue it has 2 slots of processing time in phy
-              uint8_t numberOfSlot_insideOneSubframe = pow(2,(m_currentSlot.GetNumerology ()));
-              uint8_t number_slots_configuration = (configurationTime*numberOfSlot_insideOneSubframe)-number_slots_for_processing_configurationPeriod;
-              dataSfn_cg.Add(number_slots_configuration);
-
-              uint64_t key = dataSfn_cg.GetEncForStreamWithSymStart (streamId, m_dciGranted[cg_slot_counter]->m_symStart);
-
-              auto it = m_dci_cg_map.find (key);
-
-              if (it == m_dci_cg_map.end ())
-                {
-                  it = m_dci_cg_map.insert (std::make_pair (key, m_dciGranted[cg_slot_counter])).first;
-                  cg_slot_counter = cg_slot_counter +1;
-
-                }
-            }
-        }
-
       VarTtiAllocInfo allocation = m_currSlotAllocInfo.m_varTtiAllocInfo.front ();
       m_currSlotAllocInfo.m_varTtiAllocInfo.pop_front ();
 
@@ -1221,6 +1183,161 @@ NrUePhy::EndVarTti (const std::shared_ptr<DciInfoElementTdma> &dci)
   m_receptionEnabled = false;
 }
 
+bool
+NrUePhy::IsIdle () const
+{
+  NS_LOG_FUNCTION (this);
+  SfnSf nextAlloc;
+  if (GetFirstSlotAllocSfnSf (&nextAlloc) && ! (m_currentSlot < nextAlloc))
+    {
+      return false;
+    }
+  uint64_t nextOccasion;
+  if (m_phySapUser->GetNextCgOccasion (m_currentSlot.Normalize (), &nextOccasion)
+      && nextOccasion == m_currentSlot.Normalize ())
+    {
+      return false;
+    }
+  return m_ctrlMsgs.empty () && IsCtrlMsgQueueEmpty () && m_phySapUser->IsIdle ();
+}
+
+void
+NrUePhy::SkipIdleSlots ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (! m_idle);
+
+  m_idle = true;
+  m_idleSlotStart = m_lastSlotStart + GetSlotPeriod ();
+
+  // wake up at the first slot with an allocation or a configured grant
+  // occasion, whichever comes first
+  const uint64_t currentSlot = m_currentSlot.Normalize ();
+  bool wakeUp = false;
+  uint64_t wakeUpSlot = UINT64_MAX;
+  SfnSf nextAlloc;
+  if (GetFirstSlotAllocSfnSf (&nextAlloc))
+    {
+      NS_ASSERT (m_currentSlot < nextAlloc);
+      wakeUpSlot = nextAlloc.Normalize ();
+      wakeUp = true;
+    }
+  uint64_t nextOccasion;
+  if (m_phySapUser->GetNextCgOccasion (currentSlot, &nextOccasion))
+    {
+      NS_ASSERT (nextOccasion > currentSlot);
+      wakeUpSlot = std::min (wakeUpSlot, nextOccasion);
+      wakeUp = true;
+    }
+
+  if (wakeUp)
+    {
+      int64_t slots = static_cast<int64_t> (wakeUpSlot - currentSlot);
+      m_wakeUpEvent = Simulator::Schedule (m_idleSlotStart + GetSlotPeriod () * slots - Simulator::Now (),
+                                           &NrUePhy::WakeUp, this);
+      NS_LOG_INFO ("UE " << m_rnti << " idle from slot " << m_currentSlot <<
+                   ", wake up in " << slots << " slots");
+    }
+  else
+    {
+      NS_LOG_INFO ("UE " << m_rnti << " idle from slot " << m_currentSlot);
+    }
+}
+
+uint32_t
+NrUePhy::GetIdleSlotsElapsed () const
+{
+  NS_ASSERT (m_idle && Simulator::Now () >= m_idleSlotStart);
+  return static_cast<uint32_t> ((Simulator::Now () - m_idleSlotStart).GetTimeStep () /
+                                GetSlotPeriod ().GetTimeStep ());
+}
+
+void
+NrUePhy::FastForwardIdleSlots ()
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t skipped = GetIdleSlotsElapsed ();
+  m_idle = false;
+  m_wakeUpEvent.Cancel ();
+
+  m_currentSlot.Add (skipped);
+  m_lastSlotStart = m_idleSlotStart + GetSlotPeriod () * skipped;
+
+  NS_LOG_INFO ("UE " << m_rnti << " resumes in slot " << m_currentSlot <<
+               " after " << skipped << " idle slots");
+}
+
+void
+NrUePhy::WakeUp ()
+{
+  NS_LOG_FUNCTION (this);
+  if (! m_idle)
+    {
+      return;
+    }
+
+  FastForwardIdleSlots ();
+
+  if (m_lastSlotStart == Simulator::Now ())
+    {
+      // After the current event, as it would happen if StartSlot was already
+      // scheduled (e.g., a HARQ feedback is enqueued before the slot starts)
+      Simulator::ScheduleNow (&NrUePhy::StartSlot, this, m_currentSlot);
+    }
+  else
+    {
+      m_phySapUser->IdleSlotIndication (m_currentSlot, m_lastSlotStart);
+      SfnSf nextSlot = m_currentSlot;
+      nextSlot.Add (1);
+      Simulator::Schedule (m_lastSlotStart + GetSlotPeriod () - Simulator::Now (),
+                           &NrUePhy::StartSlot, this, nextSlot);
+    }
+}
+
+void
+NrUePhy::ResumeIdleSlot ()
+{
+  NS_LOG_FUNCTION (this);
+
+  FastForwardIdleSlots ();
+  NS_ASSERT (! SlotAllocInfoExists (m_currentSlot));
+  m_slotStartTrace (m_currentSlot, true);
+
+  m_phySapUser->IdleSlotIndication (m_currentSlot, m_lastSlotStart);
+
+  m_currSlotAllocInfo = SlotAllocInfo (m_currentSlot);
+  PushCtrlAllocations (m_currentSlot);
+  TryToPerformLbt ();
+  // The CTRL message queue is empty (it is a condition to become idle), so
+  // there is nothing to pop or route for this slot.
+
+  VarTtiAllocInfo allocation = m_currSlotAllocInfo.m_varTtiAllocInfo.front ();
+  m_currSlotAllocInfo.m_varTtiAllocInfo.pop_front ();
+
+  Time varTtiStart = m_lastSlotStart + GetSymbolPeriod () * allocation.m_dci->m_symStart;
+  if (varTtiStart >= Simulator::Now ())
+    {
+      Simulator::Schedule (varTtiStart - Simulator::Now (), &NrUePhy::StartVarTti, this, allocation.m_dci);
+    }
+  else
+    {
+      // The DL CTRL that carried the message: the spectrum PHY received it
+      // while we were idle. Finish it at its original time.
+      NS_ASSERT (allocation.m_dci->m_type == DciInfoElementTdma::CTRL &&
+                 allocation.m_dci->m_format == DciInfoElementTdma::DL);
+      Time varTtiEnd = varTtiStart + DlCtrl (allocation.m_dci);
+      NS_ASSERT (varTtiEnd >= Simulator::Now ());
+      Simulator::Schedule (varTtiEnd - Simulator::Now (), &NrUePhy::EndVarTti, this, allocation.m_dci);
+    }
+}
+
+void
+NrUePhy::NotifyMacActivity ()
+{
+  NS_LOG_FUNCTION (this);
+  WakeUp ();
+}
+
 void
 NrUePhy::PhyDataPacketReceived (const Ptr<Packet> &p)
 {
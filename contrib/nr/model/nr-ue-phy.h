@@ -451,6 +451,14 @@ public:
    */
   virtual void ScheduleStartEventLoop (uint32_t nodeId, uint16_t frame, uint8_t subframe, uint16_t slot) override;
 
+  /**
+   * \brief The MAC has something new to do: if the PHY is skipping idle
+   * slots, resume the per-slot processing from the next slot
+   *
+   * \see NrPhySapProvider::NotifyMacActivity
+   */
+  virtual void NotifyMacActivity () override;
+
   /**
    * \brief Called when rsReceivedPower is fired
    * \param power the power received
@@ -494,6 +502,15 @@ public:
                                                       const Time &time, uint16_t rnti,
                                                       uint64_t imsi, uint16_t bwpId, uint16_t cellId);
 
+  /**
+   * \brief TracedCallback signature for the slot start trace source
+   *
+   * \param [in] sfnSf the slot
+   * \param [in] resumed true if the slot is resumed in its middle, after
+   * skipping idle slots, instead of starting at its beginning
+   */
+  typedef void (* SlotStartTracedCallback)(const SfnSf &sfnSf, bool resumed);
+
   //Configured Grant
 
 
@@ -630,6 +647,59 @@ private:
    */
   void EndVarTti (const std::shared_ptr<DciInfoElementTdma> &dci);
 
+  /**
+   * \brief Check if the UE can skip the next slots
+   * \return true if there are no allocations for the next slot, no
+   * configured grant occasions in it, no CTRL messages to send and the MAC
+   * is idle
+   */
+  bool IsIdle () const;
+
+  /**
+   * \brief Stop the per-slot processing at the end of the slot
+   *
+   * Instead of scheduling the next StartSlot, remember the start of the next
+   * slot and, if there is an allocation or a configured grant occasion in the
+   * future, schedule the wake up at the beginning of the first of their slots.
+   *
+   * \see WakeUp
+   */
+  void SkipIdleSlots ();
+
+  /**
+   * \brief Get the number of slots started since the UE became idle
+   * \return the number of slots to add to m_currentSlot to get the slot that
+   * contains the current time
+   */
+  uint32_t GetIdleSlotsElapsed () const;
+
+  /**
+   * \brief Leave the idle state, moving m_currentSlot and m_lastSlotStart to
+   * the slot that contains the current time
+   *
+   * The number of slots skipped is computed from the time elapsed since the
+   * UE became idle, so no event is needed for the idle slots.
+   */
+  void FastForwardIdleSlots ();
+
+  /**
+   * \brief Resume the per-slot processing after skipping idle slots
+   *
+   * If we are at the beginning of a slot, the slot is started as usual;
+   * otherwise, the MAC is notified of the current slot, and the processing
+   * restarts from the beginning of the next slot.
+   */
+  void WakeUp ();
+
+  /**
+   * \brief Resume the per-slot processing in the middle of the current slot
+   *
+   * Called when a CTRL message (e.g., a DCI) is received while idle: the
+   * current slot is rebuilt as StartSlot would have done, and the
+   * allocations that are not started yet are scheduled at their original time.
+   */
+  void ResumeIdleSlot ();
+
   /**
    * \brief Set the Tx power spectral density based on the RB index vector
    * \param mask vector of the index of the RB (in SpectrumValue array)
@@ -808,6 +878,11 @@ private:
   Time m_wbCqiLast;
   Time m_lastSlotStart; //!< Time of the last slot start
 
+  bool m_eventDrivenSlots {false}; //!< Skip the processing of the slots in which the UE is idle (attribute)
+  bool m_idle {false};             //!< True if the UE is skipping idle slots
+  Time m_idleSlotStart;            //!< Start time of the first skipped slot (m_currentSlot)
+  EventId m_wakeUpEvent;           //!< Wake up at the slot of the next known allocation
+
   bool m_ulConfigured {false};     //!< Flag to indicate if RRC configured the UL
   bool m_receptionEnabled {false}; //!< Flag to indicate if we are currently receiveing data
   uint16_t m_rnti {0};             //!< Current RNTI of the user
@@ -881,6 +956,12 @@ private:
    */
   TracedCallback<SfnSf, uint16_t, uint16_t, uint8_t, uint8_t, uint32_t> m_phyUeTxedHarqFeedbackTrace;
 
+  /**
+   * The slots processed by the UE: the SfnSf, and whether the slot is
+   * resumed in its middle. The slots skipped while idle are not reported.
+   */
+  TracedCallback<const SfnSf &, bool> m_slotStartTrace;
+
   NrPhyDlHarqFeedbackCallback m_phyDlHarqFeedbackCallback; //!< callback that is notified when the DL HARQ feedback is being generated
 
   DlHarqInfo m_dlHarqInfo; //!< The attribute used to merge HARQ infos from different NrSpectrumPhy instances belonging to this NrUePhy, i.e., if there are two streams, should be cleaned after triggering m_phyDlHarqFeedbackCallback
@@ -923,20 +1004,12 @@ private:
   void EndVarTti_configuredGrant (const std::shared_ptr<DciInfoElementTdma> &dci);
   uint8_t m_totalGrantedSymbols {0}; //!< Total granted symbols
   SfnSf m_SlotsGranted = SfnSf (0,0,0,GetNumerology());
-  bool m_ulPacketToTransmit{false}; //!< It indicates if a new message is generated
-                                    //!< in the transmission phase
-  std::shared_ptr<DciInfoElementTdma> m_dciGranted[100]; //!< The stored DCI-s for CG allocation.
-                                                         //!< [num] is the maximum number of
-                                                         //!< slots that can be configured
+  std::vector<std::shared_ptr<DciInfoElementTdma> > m_cgUlDcis; //!< The configured grant occasions used by the MAC in the current slot
 
   uint8_t configuredGrant_periodicity = 0; //!< Set up CG parameters: CG tx periodicity
   uint8_t configurationTime = 0; //!< Set up CG parameters: Configuration phase
 
 
-  uint8_t cg_slot_counter = 0;
-  uint8_t cg_slot_counter_futureTx = 0;
-  std::unordered_map <uint64_t, std::shared_ptr<DciInfoElementTdma>> m_dci_cg_map;
-  std::shared_ptr<DciInfoElementTdma> m_ulDci;
   bool m_cgScheduling = true;
 
 };
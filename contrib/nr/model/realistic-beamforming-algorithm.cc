@@ -416,7 +416,7 @@ RealisticBeamformingAlgorithm::GetEstimatedLongTermComponent (const Ptr<const Ma
   NS_ABORT_IF (srsSinr == 0);
 
   double varError = 1 / (srsSinr); // SINR the SINR from UL SRS reception
-  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel[0][0].size ());
+  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel.GetNumPages ());
 
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
@@ -429,7 +429,7 @@ RealisticBeamformingAlgorithm::GetEstimatedLongTermComponent (const Ptr<const Ma
               //error is generated from the normal random variable with mean 0 and  variance varError*sqrt(1/2) for real/imaginary parts
               std::complex<double> error = std::complex <double> (m_normalRandomVariable->GetValue (0, sqrt (0.5) * varError),
                                                                   m_normalRandomVariable->GetValue (0, sqrt (0.5) * varError)) ;
-              std::complex<double> hEstimate = channelMatrix->m_channel [uIndex][sIndex][cIndex] + error;
+              std::complex<double> hEstimate = channelMatrix->m_channel (uIndex, sIndex, cIndex) + error;
               rxSum += uW[uIndex] * (hEstimate);
             }
           txSum = txSum + sW[sIndex] * rxSum;
@@ -0,0 +1,343 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-spectrum-value-helper.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/enum.h>
+#include <ns3/double.h>
+#include <ns3/object-factory.h>
+#include <ns3/nr-error-model.h>
+#include <algorithm>
+#include <numeric>
+
+/**
+ * \file nr-test-amc-mcs-search.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the MCS search of the CQI feedback in NrAmc. The test
+ * checks that the default search is the linear (exact) one; that the bisection
+ * search returns the same CQI and MCS of the linear search when the TBLER is
+ * monotone in the MCS, and an MCS that reaches the target TBLER while the next
+ * one does not otherwise; and that the memo of the selected MCS returns the
+ * same result of the linear search, also for frequency-selective SINRs with
+ * the same average. It does so for flat and frequency-selective SINRs and for
+ * different error models and bandwidths.
+ * It also checks the TB size table of NrAmc, and its inverse lookup, against
+ * the TB size computed from the error model.
+ */
+namespace ns3 {
+
+/**
+ * \brief Compare the MCS searches of NrAmc against the linear search
+ */
+class NrAmcMcsSearchTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param errorModel the error model type name
+   * \param numRbs the number of RBs of the bandwidth
+   */
+  NrAmcMcsSearchTestCase (const std::string &errorModel, uint32_t numRbs)
+    : TestCase ("MCS search with " + errorModel + " and " + std::to_string (numRbs) + " RBs"),
+      m_errorModel (errorModel),
+      m_numRbs (numRbs)
+  {}
+
+private:
+  virtual void DoRun (void) override;
+  /**
+   * \brief Create an AMC with the given search configuration
+   * \param search the MCS search algorithm
+   * \param cacheStep the SINR step of the memo (0 to disable it)
+   * \return the AMC
+   */
+  Ptr<NrAmc> CreateAmc (NrAmc::McsSearch search, double cacheStep) const;
+  /**
+   * \brief Check whether an MCS is above the target TBLER, as NrAmc does
+   * \param em the error model
+   * \param amc the AMC, for the TB size
+   * \param sinr the SINR
+   * \param mcs the MCS
+   * \return true if the TBLER of the MCS is above the target
+   */
+  bool IsAboveTarget (const Ptr<NrErrorModel> &em, const Ptr<NrAmc> &amc,
+                      const SpectrumValue &sinr, uint8_t mcs) const;
+
+  std::string m_errorModel;  //!< Error model type
+  uint32_t m_numRbs {0};     //!< Number of RBs
+};
+
+Ptr<NrAmc>
+NrAmcMcsSearchTestCase::CreateAmc (NrAmc::McsSearch search, double cacheStep) const
+{
+  Ptr<NrAmc> amc = CreateObject<NrAmc> ();
+  amc->SetAttribute ("ErrorModelType", TypeIdValue (TypeId::LookupByName (m_errorModel)));
+  amc->SetAttribute ("AmcModel", EnumValue (NrAmc::ErrorModel));
+  amc->SetAttribute ("McsSearch", EnumValue (search));
+  amc->SetAttribute ("McsCacheSinrStep", DoubleValue (cacheStep));
+  return amc;
+}
+
+bool
+NrAmcMcsSearchTestCase::IsAboveTarget (const Ptr<NrErrorModel> &em, const Ptr<NrAmc> &amc,
+                                       const SpectrumValue &sinr, uint8_t mcs) const
+{
+  std::vector<int> rbMap (m_numRbs);
+  std::iota (rbMap.begin (), rbMap.end (), 0);
+  Ptr<NrErrorModelOutput> output;
+  output = em->GetTbDecodificationStats (sinr, rbMap, amc->CalculateTbSize (mcs, m_numRbs),
+                                         mcs, NrErrorModel::NrErrorModelHistory ());
+  return output->m_tbler > 0.1;
+}
+
+void
+NrAmcMcsSearchTestCase::DoRun ()
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<NrAmc> linear = CreateAmc (NrAmc::LinearMcsSearch, 0.0);
+  Ptr<NrAmc> bisection = CreateAmc (NrAmc::BisectionMcsSearch, 0.0);
+  Ptr<NrAmc> cached = CreateAmc (NrAmc::LinearMcsSearch, 0.01);
+
+  NS_TEST_ASSERT_MSG_EQ (CreateObject<NrAmc> ()->GetMcsSearch (), NrAmc::LinearMcsSearch,
+                         "The default MCS search is not the exact one");
+
+  ObjectFactory factory;
+  factory.SetTypeId (m_errorModel);
+  Ptr<NrErrorModel> em = DynamicCast<NrErrorModel> (factory.Create ());
+  const uint8_t maxMcs = linear->GetMaxMcs ();
+
+  Ptr<const SpectrumModel> sm = NrSpectrumValueHelper::GetSpectrumModel (m_numRbs, 28e9, 30e3);
+  Ptr<UniformRandomVariable> fading = CreateObject<UniformRandomVariable> ();
+
+  for (double sinrDb = -10.0; sinrDb <= 40.0; sinrDb += 0.25)
+    {
+      for (bool flat : {true, false})
+        {
+          SpectrumValue sinr (sm);
+          for (uint32_t rb = 0; rb < m_numRbs; ++rb)
+            {
+              double rbSinrDb = flat ? sinrDb : sinrDb + fading->GetValue (-6.0, 6.0);
+              sinr[rb] = std::pow (10.0, rbSinrDb / 10.0);
+            }
+
+          uint8_t linearMcs = 0;
+          uint8_t linearCqi = linear->CreateCqiFeedbackWbTdma (sinr, linearMcs);
+          uint8_t bisectionMcs = 0;
+          uint8_t bisectionCqi = bisection->CreateCqiFeedbackWbTdma (sinr, bisectionMcs);
+
+          // The MCSs above the target TBLER
+          std::vector<bool> above;
+          for (uint8_t m = 0; m <= maxMcs; ++m)
+            {
+              above.push_back (IsAboveTarget (em, linear, sinr, m));
+            }
+
+          if (std::is_sorted (above.begin (), above.end ()))
+            {
+              NS_TEST_ASSERT_MSG_EQ (+bisectionMcs, +linearMcs, "Bisection MCS differs at " << sinrDb << " dB");
+              NS_TEST_ASSERT_MSG_EQ (+bisectionCqi, +linearCqi, "Bisection CQI differs at " << sinrDb << " dB");
+            }
+          else
+            {
+              // The bisection stops at one of the steps of the TBLER
+              // across the target, which is not always the first one
+              NS_TEST_ASSERT_MSG_GT_OR_EQ (+bisectionMcs, +linearMcs, "Bisection MCS below the linear one at " << sinrDb << " dB");
+              // MCS 0 is also the result when no MCS reaches the target
+              if (bisectionMcs > 0 || !above.at (0))
+                {
+                  NS_TEST_ASSERT_MSG_EQ (above.at (bisectionMcs), false, "Bisection MCS above the target at " << sinrDb << " dB");
+                  if (bisectionMcs < maxMcs)
+                    {
+                      NS_TEST_ASSERT_MSG_EQ (above.at (bisectionMcs + 1), true, "Bisection MCS not at a step at " << sinrDb << " dB");
+                    }
+                }
+            }
+
+          // twice: the first call fills the memo, the second one reads it
+          for (uint32_t i = 0; i < 2; ++i)
+            {
+              uint8_t cachedMcs = 0;
+              uint8_t cachedCqi = cached->CreateCqiFeedbackWbTdma (sinr, cachedMcs);
+              NS_TEST_ASSERT_MSG_EQ (+cachedMcs, +linearMcs, "Memoized MCS differs at " << sinrDb << " dB");
+              NS_TEST_ASSERT_MSG_EQ (+cachedCqi, +linearCqi, "Memoized CQI differs at " << sinrDb << " dB");
+            }
+        }
+
+      if (m_numRbs > 1)
+        {
+          // A frequency-selective SINR and a flat one with the same average:
+          // the memo must not give the result of one to the other
+          SpectrumValue selective (sm);
+          for (uint32_t rb = 0; rb < m_numRbs; ++rb)
+            {
+              selective[rb] = std::pow (10.0, (sinrDb + (rb % 2 ? 10.0 : -10.0)) / 10.0);
+            }
+          double average = 0.0;
+          for (uint32_t rb = 0; rb < m_numRbs; ++rb)
+            {
+              average += selective[rb] / m_numRbs;
+            }
+          SpectrumValue flat (sm);
+          flat = average;
+
+          for (const SpectrumValue *sinr : {&selective, &flat, &selective})
+            {
+              uint8_t linearMcs = 0;
+              uint8_t linearCqi = linear->CreateCqiFeedbackWbTdma (*sinr, linearMcs);
+              uint8_t cachedMcs = 0;
+              uint8_t cachedCqi = cached->CreateCqiFeedbackWbTdma (*sinr, cachedMcs);
+              NS_TEST_ASSERT_MSG_EQ (+cachedMcs, +linearMcs, "Memoized MCS differs with the same average SINR at " << sinrDb << " dB");
+              NS_TEST_ASSERT_MSG_EQ (+cachedCqi, +linearCqi, "Memoized CQI differs with the same average SINR at " << sinrDb << " dB");
+            }
+        }
+    }
+}
+
+/**
+ * \brief Check the TB size table of NrAmc against the error model
+ */
+class NrAmcTbSizeTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param errorModel the error model type name
+   */
+  NrAmcTbSizeTestCase (const std::string &errorModel)
+    : TestCase ("TB size table with " + errorModel),
+      m_errorModel (errorModel)
+  {}
+
+private:
+  virtual void DoRun (void) override;
+  /**
+   * \brief Compute the TB size as NrAmc does (for error models other than
+   * LenaErrorModel), without the table
+   * \param em the error model
+   * \param mode the error model mode
+   * \param mcs the MCS
+   * \param nprb the number of RBs
+   * \return the TB size
+   */
+  uint32_t ComputeTbSize (const Ptr<NrErrorModel> &em, NrErrorModel::Mode mode,
+                          uint8_t mcs, uint32_t nprb) const;
+
+  std::string m_errorModel;  //!< Error model type
+};
+
+uint32_t
+NrAmcTbSizeTestCase::ComputeTbSize (const Ptr<NrErrorModel> &em, NrErrorModel::Mode mode,
+                                    uint8_t mcs, uint32_t nprb) const
+{
+  const uint32_t crcLen = 3;
+  uint32_t payloadSize = em->GetPayloadSize (NrSpectrumValueHelper::SUBCARRIERS_PER_RB - 1,
+                                             mcs, nprb, mode);
+  uint32_t tbSize = payloadSize;
+  if (payloadSize >= crcLen)
+    {
+      tbSize = payloadSize - crcLen;
+    }
+  uint32_t cbSize = em->GetMaxCbSize (payloadSize, mcs);
+  if (tbSize > cbSize)
+    {
+      double C = ceil (tbSize / cbSize);
+      tbSize = payloadSize - static_cast<uint32_t> (C * crcLen);
+    }
+  return tbSize;
+}
+
+void
+NrAmcTbSizeTestCase::DoRun ()
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_errorModel);
+  Ptr<NrErrorModel> em = DynamicCast<NrErrorModel> (factory.Create ());
+
+  Ptr<NrAmc> amc = CreateObject<NrAmc> ();
+  amc->SetAttribute ("ErrorModelType", TypeIdValue (TypeId::LookupByName (m_errorModel)));
+  Ptr<NrAmc> other = CreateObject<NrAmc> ();
+  other->SetAttribute ("ErrorModelType", TypeIdValue (TypeId::LookupByName (m_errorModel)));
+
+  for (NrErrorModel::Mode mode : {NrErrorModel::DL, NrErrorModel::UL})
+    {
+      // The mode of an AMC changes after its table has been filled
+      mode == NrErrorModel::DL ? amc->SetDlMode () : amc->SetUlMode ();
+      mode == NrErrorModel::DL ? other->SetDlMode () : other->SetUlMode ();
+
+      for (uint8_t mcs = 0; mcs <= amc->GetMaxMcs (); ++mcs)
+        {
+          // Random access first, then in order (filled and shared table)
+          for (uint32_t nprb : {273u, 1u, 50u})
+            {
+              NS_TEST_ASSERT_MSG_EQ (amc->CalculateTbSize (mcs, nprb), ComputeTbSize (em, mode, mcs, nprb),
+                                     "TB size differs for MCS " << +mcs << " and " << nprb << " RBs");
+            }
+          for (uint32_t nprb = 1; nprb <= 300; ++nprb)
+            {
+              uint32_t tbSize = ComputeTbSize (em, mode, mcs, nprb);
+              NS_TEST_ASSERT_MSG_EQ (amc->CalculateTbSize (mcs, nprb), tbSize,
+                                     "TB size differs for MCS " << +mcs << " and " << nprb << " RBs");
+              NS_TEST_ASSERT_MSG_EQ (other->CalculateTbSize (mcs, nprb), tbSize,
+                                     "Shared TB size differs for MCS " << +mcs << " and " << nprb << " RBs");
+            }
+
+          for (uint32_t bytes : {0u, 1u, 10u, 100u, 1000u, 5000u, 20000u})
+            {
+              uint32_t nprb = 1;
+              while (ComputeTbSize (em, mode, mcs, nprb) < bytes)
+                {
+                  ++nprb;
+                }
+              NS_TEST_ASSERT_MSG_EQ (amc->GetMinNumRbForBytes (mcs, bytes), nprb,
+                                     "Minimum RBs differ for MCS " << +mcs << " and " << bytes << " bytes");
+            }
+        }
+    }
+}
+
+/**
+ * \brief Test suite for the MCS search of the CQI feedback
+ */
+class NrTestAmcMcsSearch : public TestSuite
+{
+public:
+  NrTestAmcMcsSearch () : TestSuite ("nr-test-amc-mcs-search", UNIT)
+  {
+    for (const auto & em : {"ns3::NrEesmCcT1", "ns3::NrEesmCcT2", "ns3::NrEesmIrT1", "ns3::NrLteMiErrorModel"})
+      {
+        for (uint32_t numRbs : {1, 25, 106, 273})
+          {
+            AddTestCase (new NrAmcMcsSearchTestCase (em, numRbs), QUICK);
+          }
+      }
+    for (const auto & em : {"ns3::NrEesmCcT1", "ns3::NrEesmIrT2", "ns3::NrLteMiErrorModel"})
+      {
+        AddTestCase (new NrAmcTbSizeTestCase (em), QUICK);
+      }
+  }
+};
+
+static NrTestAmcMcsSearch g_nrTestAmcMcsSearch; //!< MCS search test suite
+
+}  // namespace ns3
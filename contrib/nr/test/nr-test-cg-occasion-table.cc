@@ -0,0 +1,163 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-cg-occasion-table.h>
+
+/**
+ * \file nr-test-cg-occasion-table.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrCgOccasionTable. The test adds two configurations,
+ * a short one with repetitions and a long one, and checks the occasions of a
+ * range of slots against their definition.
+ */
+namespace ns3 {
+
+/**
+ * \brief Test the occasions of several configured grant configurations
+ */
+class NrCgOccasionTableTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  NrCgOccasionTableTestCase ()
+    : TestCase ("NR configured grant occasion table")
+  {}
+
+private:
+  virtual void DoRun (void) override;
+};
+
+/**
+ * \brief Create the DCI of a resource
+ * \param symStart the starting symbol
+ * \return the DCI
+ */
+static std::shared_ptr<DciInfoElementTdma>
+CreateDci (uint8_t symStart)
+{
+  return std::make_shared<DciInfoElementTdma> (1, DciInfoElementTdma::UL, symStart, 2,
+                                               std::vector<uint8_t> {10},
+                                               std::vector<uint32_t> {200},
+                                               std::vector<uint8_t> {1},
+                                               std::vector<uint8_t> {0},
+                                               DciInfoElementTdma::DATA, 0, 1);
+}
+
+void
+NrCgOccasionTableTestCase::DoRun ()
+{
+  NrCgOccasionTable table;
+  std::vector<NrCgOccasionTable::Occasion> occasions;
+
+  uint64_t next = 0;
+  table.GetOccasions (0, &occasions);
+  NS_TEST_ASSERT_MSG_EQ (occasions.size (), 0, "Occasions without configurations");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNextOccasionSlot (0, &next), false, "Next occasion without configurations");
+
+  // A period of 4 slots (e.g., 0.5 ms with numerology 3), two slots per period
+  uint8_t fast = table.AddConfig (4, 2);
+  // A period of 40 slots
+  uint8_t slow = table.AddConfig (40);
+  NS_TEST_ASSERT_MSG_EQ (table.GetNumConfigs (), 2, "Wrong number of configurations");
+  NS_TEST_ASSERT_MSG_EQ (table.GetPeriod (fast), 4, "Wrong period");
+  NS_TEST_ASSERT_MSG_EQ (table.GetPeriod (slow), 40, "Wrong period");
+
+  struct Expected
+  {
+    uint8_t configId;
+    uint64_t firstSlot;
+    uint32_t period;
+    uint32_t repetitions;
+    std::shared_ptr<DciInfoElementTdma> dci;
+  };
+  std::vector<Expected> resources {
+    {fast, 10, 4, 2, CreateDci (2)},
+    {slow, 25, 40, 1, CreateDci (2)},
+    {slow, 27, 40, 1, CreateDci (4)},
+  };
+  for (const auto &r : resources)
+    {
+      NS_TEST_ASSERT_MSG_EQ (table.AddResource (r.configId, r.firstSlot, r.dci), true,
+                             "Resource not added");
+    }
+  // Same offset and symbol of an existing resource
+  NS_TEST_ASSERT_MSG_EQ (table.AddResource (slow, 65, CreateDci (2)), false,
+                         "Duplicated resource added");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNumResources (fast), 1, "Wrong number of resources");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNumResources (slow), 2, "Wrong number of resources");
+
+  for (uint64_t slot = 0; slot < 200; ++slot)
+    {
+      std::vector<NrCgOccasionTable::Occasion> expected;
+      for (const auto &r : resources)
+        {
+          if (slot >= r.firstSlot && (slot - r.firstSlot) % r.period < r.repetitions)
+            {
+              expected.push_back ({r.configId, r.dci});
+            }
+        }
+
+      table.GetOccasions (slot, &occasions);
+      NS_TEST_ASSERT_MSG_EQ (occasions.size (), expected.size (),
+                             "Wrong number of occasions in slot " << slot);
+      for (std::size_t i = 0; i < expected.size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (+occasions[i].m_configId, +expected[i].m_configId,
+                                 "Wrong configuration in slot " << slot);
+          NS_TEST_ASSERT_MSG_EQ ((occasions[i].m_dci == expected[i].m_dci), true,
+                                 "Wrong resource in slot " << slot);
+        }
+    }
+
+  // The next occasion is the first slot, from the given one, that has occasions
+  for (uint64_t slot = 0; slot < 160; ++slot)
+    {
+      uint64_t expected = slot;
+      table.GetOccasions (expected, &occasions);
+      while (occasions.empty ())
+        {
+          table.GetOccasions (++expected, &occasions);
+        }
+      NS_TEST_ASSERT_MSG_EQ (table.GetNextOccasionSlot (slot, &next), true, "No next occasion from slot " << slot);
+      NS_TEST_ASSERT_MSG_EQ (next, expected, "Wrong next occasion from slot " << slot);
+    }
+
+  table.Clear ();
+  table.GetOccasions (10, &occasions);
+  NS_TEST_ASSERT_MSG_EQ (occasions.size (), 0, "Occasions after the removal of the configurations");
+}
+
+/**
+ * \brief Test suite for NrCgOccasionTable
+ */
+class NrTestCgOccasionTable : public TestSuite
+{
+public:
+  NrTestCgOccasionTable () : TestSuite ("nr-test-cg-occasion-table", UNIT)
+  {
+    AddTestCase (new NrCgOccasionTableTestCase (), QUICK);
+  }
+};
+
+static NrTestCgOccasionTable g_nrTestCgOccasionTable; //!< NrCgOccasionTable test suite
+
+}  // namespace ns3
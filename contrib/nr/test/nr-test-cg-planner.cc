@@ -0,0 +1,185 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-mac-scheduler-cg-planner.h>
+#include <algorithm>
+
+/**
+ * \file nr-test-cg-planner.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the plan of the RB-OFDMA configured grant
+ * allocations. The test checks that NrMacSchedulerCgPlanner returns the
+ * same packet RBs and RBG group widths of the search that the RB-OFDMA
+ * access mode did at every slot, for several carriers, numbers of UEs,
+ * MCS and packet sizes.
+ */
+namespace ns3 {
+
+/**
+ * \brief Test the CG planner against the per-slot search
+ */
+class NrCgPlannerTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param rbgInOneSymbol the RBGs in a symbol
+   */
+  NrCgPlannerTestCase (uint32_t rbgInOneSymbol)
+    : TestCase ("CG planner with " + std::to_string (rbgInOneSymbol) + " RBGs"),
+      m_rbgInOneSymbol (rbgInOneSymbol)
+  {}
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * \brief The search of the packet RBs done at every slot
+   * \param amc the AMC
+   * \param mcs the MCS
+   * \param bytes the packet size
+   * \return the packet RBs
+   */
+  static uint32_t SearchPacketRb (const Ptr<NrAmc> &amc, uint8_t mcs, uint32_t bytes);
+
+  /**
+   * \brief The search of the RBG group width done at every slot
+   * \param rbgInOneSymbol the RBGs in a symbol
+   * \param numUes the number of UEs
+   * \param rbPacket the packet RBs
+   * \return the width
+   */
+  static uint32_t SearchRbgWidth (uint32_t rbgInOneSymbol, uint32_t numUes, uint32_t rbPacket);
+
+  uint32_t m_rbgInOneSymbol; //!< RBGs in a symbol
+};
+
+uint32_t
+NrCgPlannerTestCase::SearchPacketRb (const Ptr<NrAmc> &amc, uint8_t mcs, uint32_t bytes)
+{
+  uint32_t rbPacket = 2;
+  uint32_t tbs = 0;
+  while (tbs < bytes)
+    {
+      tbs = amc->CalculateTbSize (mcs, rbPacket);
+      rbPacket++;
+    }
+  return rbPacket;
+}
+
+uint32_t
+NrCgPlannerTestCase::SearchRbgWidth (uint32_t rbgInOneSymbol, uint32_t numUes, uint32_t rbPacket)
+{
+  std::vector<uint32_t> widths;
+  uint32_t prime = rbgInOneSymbol;
+  uint32_t rbgAssignable = 2;
+  while (true)
+    {
+      while (rbgAssignable < prime)
+        {
+          if (prime % rbgAssignable == 0
+              && std::find (widths.begin (), widths.end (), rbgAssignable) == widths.end ())
+            {
+              widths.push_back (rbgAssignable);
+              widths.push_back (prime / rbgAssignable);
+            }
+          rbgAssignable++;
+        }
+      if (widths.empty ())
+        {
+          rbgAssignable = 2;
+          prime = rbgInOneSymbol - 1;
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  uint32_t minStored = 1000;
+  for (uint32_t w : widths)
+    {
+      int num = (prime / numUes) / w;
+      if (num == 0)
+        {
+          num = 1;
+        }
+      uint32_t numSym = rbPacket / (w * num);
+      if (rbPacket % (w * num) != 0)
+        {
+          numSym++;
+        }
+      uint32_t waste = w * num * numSym - rbPacket;
+      if (waste < minStored && numSym < 12)
+        {
+          rbgAssignable = w;
+          minStored = waste;
+        }
+    }
+  return rbgAssignable;
+}
+
+void
+NrCgPlannerTestCase::DoRun ()
+{
+  Ptr<NrAmc> amc = CreateObject<NrAmc> ();
+  amc->SetUlMode ();
+  NrMacSchedulerCgPlanner planner (amc, m_rbgInOneSymbol);
+
+  NS_TEST_ASSERT_MSG_EQ (planner.IsValidFor (amc, m_rbgInOneSymbol), true, "Plan not valid for its AMC");
+  NS_TEST_ASSERT_MSG_EQ (planner.IsValidFor (amc, m_rbgInOneSymbol + 1), false, "Plan valid for other RBGs");
+
+  for (uint8_t mcs : {0, 5, 10, 20, 27})
+    {
+      for (uint32_t bytes : {0, 7, 20, 64, 100, 250, 1000, 3000})
+        {
+          uint32_t rbPacket = planner.GetPacketRb (mcs, bytes);
+          NS_TEST_ASSERT_MSG_EQ (rbPacket, SearchPacketRb (amc, mcs, bytes),
+                                 "Packet RBs for MCS " << +mcs << " and " << bytes << " bytes");
+
+          for (uint32_t numUes : {1, 2, 5, 10, 20})
+            {
+              NS_TEST_ASSERT_MSG_EQ (planner.GetRbgWidth (numUes, rbPacket),
+                                     SearchRbgWidth (m_rbgInOneSymbol, numUes, rbPacket),
+                                     "RBG width for " << numUes << " UEs and " << rbPacket << " RBs");
+            }
+        }
+    }
+}
+
+/**
+ * \brief Test suite for the CG planner
+ */
+class NrCgPlannerTestSuite : public TestSuite
+{
+public:
+  NrCgPlannerTestSuite () : TestSuite ("nr-test-cg-planner", UNIT)
+  {
+    for (uint32_t rbg : {11, 24, 25, 51, 53, 106, 273})
+      {
+        AddTestCase (new NrCgPlannerTestCase (rbg), TestCase::QUICK);
+      }
+  }
+};
+
+static NrCgPlannerTestSuite nrCgPlannerTestSuite; //!< CG planner test suite
+
+} // namespace ns3
@@ -0,0 +1,192 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-columnar-stats.h>
+#include <ns3/nr-columnar-stats-reader.h>
+#include <cmath>
+#include <cstdio>
+
+/**
+ * \file nr-test-columnar-stats.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the columnar statistics files. The test checks that
+ * LZ4 blocks decompress to the original buffer, and that the values written
+ * by NrColumnarStatsWriter, in several chunks, compressed or not, are read
+ * back exactly by NrColumnarStatsReader, one column at a time.
+ */
+namespace ns3 {
+
+/**
+ * \brief Test the LZ4 block compressor and decompressor
+ */
+class NrLz4TestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  NrLz4TestCase ()
+    : TestCase ("LZ4 block round trip")
+  {}
+
+private:
+  virtual void DoRun (void) override;
+  /**
+   * \brief Compress and decompress a buffer
+   * \param src the buffer
+   * \param what description of the buffer
+   */
+  void RoundTrip (const std::vector<uint8_t> &src, const std::string &what);
+};
+
+void
+NrLz4TestCase::RoundTrip (const std::vector<uint8_t> &src, const std::string &what)
+{
+  std::vector<uint8_t> block;
+  NrColumnarStats::Lz4Compress (src.data (), src.size (), &block);
+  std::vector<uint8_t> dst (src.size ());
+  NS_TEST_ASSERT_MSG_EQ (NrColumnarStats::Lz4Decompress (block.data (), block.size (), dst.data (), dst.size ()),
+                         true, "Invalid block for " << what);
+  NS_TEST_ASSERT_MSG_EQ ((dst == src), true, "Wrong decompressed data for " << what);
+
+  if (!src.empty ())
+    {
+      // a wrong output size must be detected
+      std::vector<uint8_t> shorter (src.size () - 1);
+      NS_TEST_ASSERT_MSG_EQ (NrColumnarStats::Lz4Decompress (block.data (), block.size (), shorter.data (), shorter.size ()),
+                             false, "Wrong size not detected for " << what);
+    }
+}
+
+void
+NrLz4TestCase::DoRun (void)
+{
+  RoundTrip ({}, "empty buffer");
+  RoundTrip ({1, 2, 3}, "short buffer");
+
+  std::vector<uint8_t> zeros (100000, 0);
+  RoundTrip (zeros, "zeros");
+  std::vector<uint8_t> block;
+  NrColumnarStats::Lz4Compress (zeros.data (), zeros.size (), &block);
+  NS_TEST_ASSERT_MSG_LT (block.size (), 1000, "Zeros should compress well");
+
+  std::vector<uint8_t> pattern;
+  for (uint32_t i = 0; i < 70000; ++i)
+    {
+      pattern.push_back (static_cast<uint8_t> ((i % 300) * 7));
+    }
+  RoundTrip (pattern, "repeated pattern");
+
+  std::vector<uint8_t> noise;
+  uint32_t x = 12345;
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      x = x * 1103515245 + 12345;
+      noise.push_back (static_cast<uint8_t> (x >> 16));
+    }
+  RoundTrip (noise, "noise");
+}
+
+/**
+ * \brief Test the writer and the reader of the columnar files
+ */
+class NrColumnarStatsTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param compress whether to compress the chunks
+   */
+  NrColumnarStatsTestCase (bool compress)
+    : TestCase (compress ? "Columnar stats, compressed" : "Columnar stats, not compressed"),
+      m_compress (compress)
+  {}
+
+private:
+  virtual void DoRun (void) override;
+
+  bool m_compress {true}; //!< Compress the chunks
+};
+
+void
+NrColumnarStatsTestCase::DoRun (void)
+{
+  const NrColumnarStats::Columns columns = {
+    {"time(s)", NrColumnarStats::DOUBLE}, {"rnti", NrColumnarStats::UINT},
+    {"offset", NrColumnarStats::INT}, {"delay(s)", NrColumnarStats::DOUBLE}
+  };
+  const uint32_t numRows = 1000;
+  std::string fileName = CreateTempDirFilename (m_compress ? "stats-lz4.ncol" : "stats.ncol");
+
+  std::vector<double> time;
+  std::vector<uint64_t> rnti;
+  std::vector<int64_t> offset;
+  std::vector<double> delay;
+  {
+    // 64 rows per chunk: the last chunk is partial, and written on destruction
+    Ptr<NrColumnarStatsWriter> writer = Create<NrColumnarStatsWriter> (fileName, columns, m_compress, 64);
+    for (uint32_t i = 0; i < numRows; ++i)
+      {
+        time.push_back (i * 0.000125);
+        rnti.push_back (1 + i % 10);
+        offset.push_back (static_cast<int64_t> (i % 7) - 3 - (i == 500 ? INT64_C (1) << 40 : 0));
+        delay.push_back (std::sin (i) * 1e-3);
+        writer->AddRow (time.back (), static_cast<uint16_t> (rnti.back ()), offset.back (), delay.back ());
+      }
+  }
+
+  NrColumnarStatsReader reader (fileName);
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNColumns (), columns.size (), "Wrong number of columns");
+  for (std::size_t i = 0; i < columns.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reader.GetColumnName (i), columns[i].first, "Wrong column name");
+      NS_TEST_ASSERT_MSG_EQ (reader.GetColumnType (i), columns[i].second, "Wrong column type");
+    }
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNRows (), numRows, "Wrong number of rows");
+
+  // read the columns out of order, to check that the others are skipped
+  NS_TEST_ASSERT_MSG_EQ ((reader.ReadColumn ("delay(s)") == delay), true, "Wrong delay column");
+  NS_TEST_ASSERT_MSG_EQ ((reader.ReadIntColumn ("offset") == offset), true, "Wrong offset column");
+  NS_TEST_ASSERT_MSG_EQ ((reader.ReadUintColumn ("rnti") == rnti), true, "Wrong rnti column");
+  NS_TEST_ASSERT_MSG_EQ ((reader.ReadColumn ("time(s)") == time), true, "Wrong time column");
+  std::vector<double> rntiAsDouble = reader.ReadColumn ("rnti");
+  NS_TEST_ASSERT_MSG_EQ (rntiAsDouble.size (), numRows, "Wrong size of the converted column");
+  NS_TEST_ASSERT_MSG_EQ (rntiAsDouble[13], 4.0, "Wrong converted value");
+
+  std::remove (fileName.c_str ());
+}
+
+/**
+ * \brief Test suite for the columnar statistics files
+ */
+class NrTestColumnarStats : public TestSuite
+{
+public:
+  NrTestColumnarStats () : TestSuite ("nr-test-columnar-stats", UNIT)
+  {
+    AddTestCase (new NrLz4TestCase (), QUICK);
+    AddTestCase (new NrColumnarStatsTestCase (true), QUICK);
+    AddTestCase (new NrColumnarStatsTestCase (false), QUICK);
+  }
+};
+
+static NrTestColumnarStats g_nrTestColumnarStats; //!< Columnar statistics test suite
+
+}  // namespace ns3
@@ -0,0 +1,130 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-eesm-sinr-kernel.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/rng-seed-manager.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+/**
+ * \file nr-test-eesm-sinr-kernel.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the implementations of NrEesmSinrKernel. Each
+ * implementation compiled in the module (the SIMD ones depend on the target
+ * of the build) is compared with the scalar one, which gives the same results
+ * as the original per-RB loop, over random RB maps of every length from 0 to
+ * a full bandwidth, so that the tails left by the vector width are covered.
+ * The SINR values span from a SINR of 0 (exp () of 0) to SINRs for which the
+ * exponential underflows.
+ */
+namespace ns3 {
+
+/**
+ * \brief Compare an implementation of the EESM kernel with the scalar one
+ */
+class NrEesmSinrKernelTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param impl the implementation to test
+   */
+  NrEesmSinrKernelTestCase (NrEesmSinrKernel::Implementation impl)
+    : TestCase (std::string ("EESM kernel ") + NrEesmSinrKernel::GetImplementationName (impl)),
+      m_impl (impl)
+  {}
+
+private:
+  virtual void DoRun (void) override;
+
+  NrEesmSinrKernel::Implementation m_impl; //!< Implementation under test
+};
+
+void
+NrEesmSinrKernelTestCase::DoRun ()
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+
+  const uint32_t numRbs = 273;
+  for (double beta : {1.6, 4.71, 45.0})
+    {
+      for (uint32_t n = 0; n <= numRbs; ++n)
+        {
+          std::vector<double> sinr (numRbs);
+          for (double &s : sinr)
+            {
+              s = std::pow (10.0, rng->GetValue (-10.0, 40.0) / 10.0);
+            }
+          // the corner cases of the exponential
+          sinr.at (rng->GetInteger (0, numRbs - 1)) = 0.0;
+          sinr.at (rng->GetInteger (0, numRbs - 1)) = 1e6 * beta;
+
+          // n RBs out of the bandwidth, in random order
+          std::vector<int> map (numRbs);
+          std::iota (map.begin (), map.end (), 0);
+          for (uint32_t i = numRbs - 1; i > 0; --i)
+            {
+              std::swap (map.at (i), map.at (rng->GetInteger (0, i)));
+            }
+          map.resize (n);
+
+          double scalar = NrEesmSinrKernel::SinrExpSum (NrEesmSinrKernel::SCALAR, sinr.data (), numRbs,
+                                                        map.data (), map.size (), beta);
+          double tested = NrEesmSinrKernel::SinrExpSum (m_impl, sinr.data (), numRbs,
+                                                        map.data (), map.size (), beta);
+          // a sum of positive terms, of up to numRbs terms of relative error ~1e-16
+          NS_TEST_ASSERT_MSG_EQ_TOL (tested, scalar, 1e-13 * scalar,
+                                     "Sum over " << n << " RBs differs with beta " << beta);
+        }
+    }
+
+  // The dispatch of SinrExpSum () uses the fastest implementation
+  if (m_impl == NrEesmSinrKernel::GetImplementations ().back ())
+    {
+      std::vector<double> sinr {0.5, 2.0, 8.0, 0.1, 30.0};
+      std::vector<int> map {4, 0, 2, 1, 3};
+      NS_TEST_ASSERT_MSG_EQ (NrEesmSinrKernel::SinrExpSum (sinr.data (), sinr.size (), map.data (), map.size (), 4.71),
+                             NrEesmSinrKernel::SinrExpSum (m_impl, sinr.data (), sinr.size (), map.data (), map.size (), 4.71),
+                             "SinrExpSum () does not use " << NrEesmSinrKernel::GetImplementationName (m_impl));
+    }
+}
+
+/**
+ * \brief Test suite for the implementations of the EESM kernel
+ */
+class NrTestEesmSinrKernel : public TestSuite
+{
+public:
+  NrTestEesmSinrKernel () : TestSuite ("nr-test-eesm-sinr-kernel", UNIT)
+  {
+    for (NrEesmSinrKernel::Implementation impl : NrEesmSinrKernel::GetImplementations ())
+      {
+        AddTestCase (new NrEesmSinrKernelTestCase (impl), QUICK);
+      }
+  }
+};
+
+static NrTestEesmSinrKernel g_nrTestEesmSinrKernel; //!< EESM kernel test suite
+
+}  // namespace ns3
@@ -23,6 +23,8 @@
 #include <ns3/nr-eesm-cc-t2.h>
 #include <ns3/nr-eesm-ir-t1.h>
 #include <ns3/nr-eesm-ir-t2.h>
+#include <ns3/nr-eesm-bler-lookup.h>
+#include <algorithm>
 /**
  * \file nr-test-l2sm-eesm.cc
  * \ingroup test
@@ -30,7 +32,9 @@
  * \brief This test validates specific functions of the NR PHY abstraction model.
  * The test checks two issues: 1) LDPC base graph (BG) selection works properly, and 2)
  * BLER values are properly obtained from the BLER-SINR look up tables for different
- * block sizes, MCS Tables, BG types, and SINR values.
+ * block sizes, MCS Tables, BG types, and SINR values. It also checks that the
+ * compiled form of the tables (NrEesmBlerLookup) returns exactly the values of
+ * a plain search over the original tables.
  *
  */
 namespace ns3 {
@@ -55,6 +59,8 @@ private:
   void TestMappingSinrBler2 (const Ptr<NrEesmErrorModel> &em);
   void TestBgType1 (const Ptr<NrEesmErrorModel> &em);
   void TestBgType2 (const Ptr<NrEesmErrorModel> &em);
+  void TestBlerLookup (const NrEesmErrorModel::SimulatedBlerFromSINR *table,
+                       const NrEesmBlerLookup *lookup, const std::string &tableName);
 
   void TestEesmCcTable1 ();
   void TestEesmCcTable2 ();
@@ -187,6 +193,82 @@ NrL2smEesmTestCase::TestMappingSinrBler2 (const Ptr<NrEesmErrorModel> &em)
     }
 
 }
+/**
+ * \brief Reference BLER search over the original (non compiled) table
+ * \param table the BLER-SINR table
+ * \param bg the base graph type
+ * \param mcs the MCS
+ * \param cbSizeBit the CB size in bits
+ * \param sinrDb the SINR in dB
+ * \return the BLER
+ */
+static double
+ReferenceBler (const NrEesmErrorModel::SimulatedBlerFromSINR *table, uint8_t bg,
+               uint8_t mcs, uint32_t cbSizeBit, double sinrDb)
+{
+  const auto &cbMap = table->at (bg).at (mcs);
+  auto cbIt = cbMap.upper_bound (cbSizeBit);
+  if (cbIt != cbMap.begin ())
+    {
+      cbIt--;
+    }
+  const std::vector<double> &sinr = std::get<0> (cbIt->second);
+  const std::vector<double> &bler = std::get<1> (cbIt->second);
+  if (sinrDb < sinr.front ())
+    {
+      return 1.0;
+    }
+  if (sinrDb > sinr.back ())
+    {
+      return 0.0;
+    }
+  auto sinrIt = std::upper_bound (sinr.begin (), sinr.end (), sinrDb);
+  if (sinrIt != sinr.begin ())
+    {
+      sinrIt--;
+    }
+  return bler.at (std::distance (sinr.begin (), sinrIt));
+}
+
+void
+NrL2smEesmTestCase::TestBlerLookup (const NrEesmErrorModel::SimulatedBlerFromSINR *table,
+                                    const NrEesmBlerLookup *lookup, const std::string &tableName)
+{
+  for (uint8_t bg = 0; bg < table->size (); ++bg)
+    {
+      for (uint8_t mcs = 0; mcs < table->at (bg).size (); ++mcs)
+        {
+          for (const auto &cb : table->at (bg).at (mcs))
+            {
+              // probe each point, slightly around it, and the middle of each interval
+              std::vector<double> probes;
+              const std::vector<double> &sinr = std::get<0> (cb.second);
+              for (uint32_t i = 0; i < sinr.size (); ++i)
+                {
+                  probes.push_back (sinr.at (i));
+                  probes.push_back (sinr.at (i) - 1e-9);
+                  probes.push_back (sinr.at (i) + 1e-9);
+                  if (i + 1 < sinr.size ())
+                    {
+                      probes.push_back ((sinr.at (i) + sinr.at (i + 1)) / 2.0);
+                    }
+                }
+              for (uint32_t cbSize : {cb.first, cb.first + 1, cb.first > 0 ? cb.first - 1 : 0})
+                {
+                  for (double sinrDb : probes)
+                    {
+                      NS_TEST_ASSERT_MSG_EQ (lookup->GetBler (bg, mcs, cbSize, sinrDb),
+                                             ReferenceBler (table, bg, mcs, cbSize, sinrDb),
+                                             "TestBlerLookup " << tableName << ": BG " << bg + 1 <<
+                                             " MCS " << +mcs << " CBS " << cbSize <<
+                                             " SINR " << sinrDb << " dB");
+                    }
+                }
+            }
+        }
+    }
+}
+
 void
 NrL2smEesmTestCase::TestEesmCcTable1 ()
 {
@@ -254,6 +336,11 @@ NrL2smEesmTestCase::DoRun ()
   TestEesmCcTable2 ();
   TestEesmIrTable1 ();
   TestEesmIrTable2 ();
+
+  NrEesmT1 t1;
+  TestBlerLookup (t1.m_simulatedBlerFromSINR, t1.m_blerLookup, "Table1");
+  NrEesmT2 t2;
+  TestBlerLookup (t2.m_simulatedBlerFromSINR, t2.m_blerLookup, "Table2");
 }
 
 class NrTestL2smEesm : public TestSuite
@@ -0,0 +1,124 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-mac-harq-vector.h>
+
+/**
+ * \file nr-test-mac-harq-vector.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrMacHarqVector. The test fills and empties the
+ * processes of a vector, and checks the IDs that are given, the active
+ * bitmask, and that the iterators to the processes stay valid.
+ */
+namespace ns3 {
+
+/**
+ * \brief Test the insertion and the removal of HARQ processes
+ */
+class NrMacHarqVectorTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  NrMacHarqVectorTestCase ()
+    : TestCase ("NR MAC HARQ vector")
+  {}
+
+private:
+  virtual void DoRun (void) override;
+};
+
+void
+NrMacHarqVectorTestCase::DoRun ()
+{
+  NrMacHarqVector harq;
+  harq.SetMaxSize (16);
+
+  NS_TEST_ASSERT_MSG_EQ (harq.Size (), 0, "New vector with active processes");
+  NS_TEST_ASSERT_MSG_EQ (harq.CanInsert (), true, "New vector is full");
+  NS_TEST_ASSERT_MSG_EQ (harq.Exist (15), true, "Process 15 does not exist");
+  NS_TEST_ASSERT_MSG_EQ (harq.Exist (16), false, "Process 16 exists");
+  NS_TEST_ASSERT_MSG_EQ ((harq.Find (16) == harq.End ()), true, "Process 16 found");
+
+  auto dci = std::make_shared<DciInfoElementTdma> (1, DciInfoElementTdma::DL, 1, 2,
+                                                   std::vector<uint8_t> {10},
+                                                   std::vector<uint32_t> {2000},
+                                                   std::vector<uint8_t> {1},
+                                                   std::vector<uint8_t> {0},
+                                                   DciInfoElementTdma::DATA, 0, 1);
+  HarqProcess process (true, HarqProcess::WAITING_FEEDBACK, 0, dci);
+
+  // The IDs are given from the highest one
+  auto first = harq.Begin ();
+  for (uint32_t i = 0; i < 16; ++i)
+    {
+      uint8_t id = 255;
+      NS_TEST_ASSERT_MSG_EQ (harq.Insert (&id, process), true, "Insert failed with free processes");
+      NS_TEST_ASSERT_MSG_EQ (+id, 15 - i, "Unexpected process ID");
+      NS_TEST_ASSERT_MSG_EQ (harq.IsActive (id), true, "Inserted process not active");
+      NS_TEST_ASSERT_MSG_EQ (+harq.Find (id)->first, +id, "Process found with a wrong ID");
+    }
+  NS_TEST_ASSERT_MSG_EQ (harq.Size (), 16, "Wrong number of active processes");
+  NS_TEST_ASSERT_MSG_EQ (harq.GetActiveMask (), 0xFFFF, "Wrong active mask");
+  NS_TEST_ASSERT_MSG_EQ (harq.CanInsert (), false, "Full vector can insert");
+  uint8_t id = 0;
+  NS_TEST_ASSERT_MSG_EQ (harq.Insert (&id, process), false, "Insert in a full vector");
+  NS_TEST_ASSERT_MSG_EQ ((harq.Begin () == first), true, "Processes moved by the insertions");
+
+  // A freed ID is given again
+  harq.Erase (5);
+  NS_TEST_ASSERT_MSG_EQ (harq.IsActive (5), false, "Erased process active");
+  NS_TEST_ASSERT_MSG_EQ ((harq.Get (5).m_dciElement == nullptr), true, "Erased process has a DCI");
+  NS_TEST_ASSERT_MSG_EQ (harq.Size (), 15, "Wrong number of active processes");
+  NS_TEST_ASSERT_MSG_EQ (harq.GetActiveMask (), 0xFFDF, "Wrong active mask");
+  NS_TEST_ASSERT_MSG_EQ (+harq.FirstAvailableId (), 5, "Freed ID not available");
+  NS_TEST_ASSERT_MSG_EQ (harq.Insert (&id, process), true, "Insert failed with a free process");
+  NS_TEST_ASSERT_MSG_EQ (+id, 5, "Freed ID not given");
+
+  // The const accessors see the same processes
+  const NrMacHarqVector &constHarq = harq;
+  NS_TEST_ASSERT_MSG_EQ ((constHarq.Get (5).m_dciElement == dci), true, "Wrong DCI through const access");
+  NS_TEST_ASSERT_MSG_EQ (constHarq.Find (5)->second.m_active, true, "Process not active through const access");
+
+  for (uint8_t i = 0; i < 16; ++i)
+    {
+      harq.Erase (i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (harq.Size (), 0, "Active processes after erasing all");
+  NS_TEST_ASSERT_MSG_EQ (harq.GetActiveMask (), 0, "Active mask after erasing all");
+  NS_TEST_ASSERT_MSG_EQ (+harq.FirstAvailableId (), 15, "Highest ID not available");
+}
+
+/**
+ * \brief Test suite for NrMacHarqVector
+ */
+class NrTestMacHarqVector : public TestSuite
+{
+public:
+  NrTestMacHarqVector () : TestSuite ("nr-test-mac-harq-vector", UNIT)
+  {
+    AddTestCase (new NrMacHarqVectorTestCase (), QUICK);
+  }
+};
+
+static NrTestMacHarqVector g_nrTestMacHarqVector; //!< NrMacHarqVector test suite
+
+}  // namespace ns3
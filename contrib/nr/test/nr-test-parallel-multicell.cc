@@ -0,0 +1,327 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/nr-module.h"
+#include "ns3/antenna-module.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include <tuple>
+
+/**
+ * \file nr-test-parallel-multicell.cc
+ * \ingroup test
+ *
+ * \brief Test the multi-cell NR simulations run by the
+ * MultithreadedSimulatorImpl, with NrHelper::AssignSimulatorPartitions.
+ *
+ * Three interfering cells, each with two UEs with DL and UL UDP traffic, are
+ * put in three partitions. After the attach phase, run on one thread, the
+ * traffic phase is run on one and on three threads. The test checks that
+ * the TBs received by every device, and the packets (with their uids)
+ * received by every application, are the same, and that the UL packets carry
+ * the uids of the partitions of their UEs.
+ *
+ * The signals of a cell reach the devices of the other partitions, with
+ * their packets and control messages. Without the NS3_MTP build option the
+ * partitions run on one thread; build ns-3 with NS3_MTP and
+ * NS3_SANITIZE_THREAD to check with the thread sanitizer that the
+ * partitions do not share state without synchronization.
+ */
+
+namespace ns3 {
+
+/**
+ * \brief Compare a multi-cell scenario run on one and on many threads
+ */
+class NrParallelMultiCellTestCase : public TestCase
+{
+public:
+  /** \brief Constructor */
+  NrParallelMultiCellTestCase ()
+    : TestCase ("Multi-cell NR on the MultithreadedSimulatorImpl")
+  {}
+
+private:
+  virtual void DoRun (void) override;
+
+  /// A received TB: RNTI, slot, first symbol, number of symbols, size, SINR, corrupted
+  typedef std::tuple<uint16_t, uint64_t, uint8_t, uint8_t, uint32_t, double, bool> RxTb;
+  /// A received packet: time, size, uid
+  typedef std::tuple<Time, uint32_t, uint64_t> RxPacket;
+
+  /**
+   * \brief What is observed in a run; each device and application has its
+   * own record, written only by its partition
+   */
+  struct Result
+  {
+    std::vector<std::vector<RxTb>> m_rxTbs;          //!< TBs received, per device
+    std::vector<std::vector<RxPacket>> m_rxPackets;  //!< Packets received, per application
+    std::vector<uint32_t> m_ulServers;               //!< Indexes of the UL servers
+  };
+
+  /**
+   * \brief Run the scenario
+   * \param threads the number of threads of the traffic phase
+   * \return what is observed
+   */
+  Result Run (uint32_t threads) const;
+
+  /**
+   * \brief Record a received TB
+   * \param tbs the TBs of the device
+   * \param params the reception
+   */
+  static void RxTbTrace (std::vector<RxTb> *tbs, RxPacketTraceParams params);
+  /**
+   * \brief Record a received packet
+   * \param packets the packets of the application
+   * \param p the packet
+   */
+  static void RxPacketTrace (std::vector<RxPacket> *packets, Ptr<const Packet> p);
+
+  static const uint32_t CELLS = 3;        //!< Number of cells
+  static const uint32_t UES_PER_CELL = 2; //!< Number of UEs per cell
+};
+
+void
+NrParallelMultiCellTestCase::RxTbTrace (std::vector<RxTb> *tbs, RxPacketTraceParams params)
+{
+  tbs->emplace_back (params.m_rnti, (static_cast<uint64_t> (params.m_frameNum) << 16)
+                     | (params.m_subframeNum << 8) | params.m_slotNum,
+                     params.m_symStart, params.m_numSym, params.m_tbSize, params.m_sinr,
+                     params.m_corrupt);
+}
+
+void
+NrParallelMultiCellTestCase::RxPacketTrace (std::vector<RxPacket> *packets, Ptr<const Packet> p)
+{
+  packets->emplace_back (Simulator::Now (), p->GetSize (), p->GetUid ());
+}
+
+NrParallelMultiCellTestCase::Result
+NrParallelMultiCellTestCase::Run (uint32_t threads) const
+{
+  Result result;
+
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  NodeContainer gnbNodes;
+  NodeContainer ueNodes;
+  gnbNodes.Create (CELLS);
+  ueNodes.Create (CELLS * UES_PER_CELL);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (gnbNodes);
+  mobility.Install (ueNodes);
+  for (uint32_t i = 0; i < CELLS; ++i)
+    {
+      gnbNodes.Get (i)->GetObject<MobilityModel> ()->SetPosition (Vector (60.0 * i, 0.0, 10.0));
+      for (uint32_t j = 0; j < UES_PER_CELL; ++j)
+        {
+          ueNodes.Get (i * UES_PER_CELL + j)->GetObject<MobilityModel> ()
+            ->SetPosition (Vector (60.0 * i + 10.0 + 5.0 * j, 15.0 - 30.0 * j, 1.5));
+        }
+    }
+
+  Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper> ();
+  Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper> ();
+  Ptr<NrHelper> nrHelper = CreateObject<NrHelper> ();
+  idealBeamformingHelper->SetAttribute ("BeamformingMethod", TypeIdValue (DirectPathBeamforming::GetTypeId ()));
+  nrHelper->SetBeamformingHelper (idealBeamformingHelper);
+  nrHelper->SetEpcHelper (epcHelper);
+
+  CcBwpCreator ccBwpCreator;
+  CcBwpCreator::SimpleOperationBandConf bandConf (28e9, 100e6, 1, BandwidthPartInfo::UMi_StreetCanyon);
+  OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc (bandConf);
+
+  Config::SetDefault ("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue (MilliSeconds (0)));
+  nrHelper->SetChannelConditionModelAttribute ("UpdatePeriod", TimeValue (MilliSeconds (0)));
+  nrHelper->SetPathlossAttribute ("ShadowingEnabled", BooleanValue (false));
+  nrHelper->InitializeOperationBand (&band);
+  BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps ({band});
+
+  nrHelper->SetGnbPhyAttribute ("Numerology", UintegerValue (2));
+  nrHelper->SetUeAntennaAttribute ("NumRows", UintegerValue (1));
+  nrHelper->SetUeAntennaAttribute ("NumColumns", UintegerValue (1));
+  nrHelper->SetGnbAntennaAttribute ("NumRows", UintegerValue (2));
+  nrHelper->SetGnbAntennaAttribute ("NumColumns", UintegerValue (2));
+
+  NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice (gnbNodes, allBwps);
+  NetDeviceContainer ueDevs = nrHelper->InstallUeDevice (ueNodes, allBwps);
+  nrHelper->AssignStreams (gnbDevs, 1);
+  nrHelper->AssignStreams (ueDevs, 1);
+
+  for (auto it = gnbDevs.Begin (); it != gnbDevs.End (); ++it)
+    {
+      DynamicCast<NrGnbNetDevice> (*it)->UpdateConfig ();
+    }
+  for (auto it = ueDevs.Begin (); it != ueDevs.End (); ++it)
+    {
+      DynamicCast<NrUeNetDevice> (*it)->UpdateConfig ();
+    }
+
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (2500));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign (internetDevices);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+  internet.Install (ueNodes);
+  Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (ueDevs);
+  for (uint32_t i = 0; i < ueNodes.GetN (); ++i)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ueNodes.Get (i)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+  nrHelper->AttachToClosestEnb (ueDevs, gnbDevs);
+
+  ApplicationContainer serverApps;
+  ApplicationContainer clientApps;
+  const uint16_t dlPort = 1234;
+  const uint16_t ulPort = 2000;
+  for (uint32_t i = 0; i < ueNodes.GetN (); ++i)
+    {
+      UdpServerHelper dlServer (dlPort);
+      serverApps.Add (dlServer.Install (ueNodes.Get (i)));
+      UdpClientHelper dlClient (ueIpIface.GetAddress (i), dlPort);
+      dlClient.SetAttribute ("Interval", TimeValue (MicroSeconds (1000 + 100 * i)));
+      dlClient.SetAttribute ("MaxPackets", UintegerValue (0xFFFFFFFF));
+      dlClient.SetAttribute ("PacketSize", UintegerValue (1000));
+      clientApps.Add (dlClient.Install (remoteHost));
+
+      result.m_ulServers.push_back (serverApps.GetN ());
+      UdpServerHelper ulServer (ulPort + i);
+      serverApps.Add (ulServer.Install (remoteHost));
+      UdpClientHelper ulClient (internetIpIfaces.GetAddress (1), ulPort + i);
+      ulClient.SetAttribute ("Interval", TimeValue (MicroSeconds (2000 + 300 * i)));
+      ulClient.SetAttribute ("MaxPackets", UintegerValue (0xFFFFFFFF));
+      ulClient.SetAttribute ("PacketSize", UintegerValue (200));
+      clientApps.Add (ulClient.Install (ueNodes.Get (i)));
+    }
+  const Time appStartTime = MilliSeconds (400);
+  serverApps.Start (MilliSeconds (300));
+  clientApps.Start (appStartTime);
+  clientApps.Stop (MilliSeconds (500));
+
+  result.m_rxPackets.resize (serverApps.GetN ());
+  for (uint32_t i = 0; i < serverApps.GetN (); ++i)
+    {
+      serverApps.Get (i)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&RxPacketTrace, &result.m_rxPackets.at (i)));
+    }
+  result.m_rxTbs.resize (gnbDevs.GetN () + ueDevs.GetN ());
+  for (uint32_t i = 0; i < gnbDevs.GetN (); ++i)
+    {
+      nrHelper->GetGnbPhy (gnbDevs.Get (i), 0)->GetSpectrumPhy ()
+        ->TraceConnectWithoutContext ("RxPacketTraceEnb", MakeBoundCallback (&RxTbTrace, &result.m_rxTbs.at (i)));
+    }
+  for (uint32_t i = 0; i < ueDevs.GetN (); ++i)
+    {
+      nrHelper->GetUePhy (ueDevs.Get (i), 0)->GetSpectrumPhy ()
+        ->TraceConnectWithoutContext ("RxPacketTraceUe",
+                                      MakeBoundCallback (&RxTbTrace, &result.m_rxTbs.at (gnbDevs.GetN () + i)));
+    }
+
+  nrHelper->AssignSimulatorPartitions (gnbDevs, ueDevs);
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_ABORT_UNLESS (impl != nullptr && impl->GetNPartitions () == CELLS);
+
+  // The GNBs call the MME directly while the UEs connect
+  impl->SetAttribute ("MaxThreads", UintegerValue (1));
+  Simulator::Stop (appStartTime);
+  Simulator::Run ();
+  impl->SetAttribute ("MaxThreads", UintegerValue (threads));
+  Simulator::Stop (MilliSeconds (600) - Simulator::Now ());
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::Reset ();
+  return result;
+}
+
+void
+NrParallelMultiCellTestCase::DoRun ()
+{
+  Result serial = Run (1);
+  Result parallel = Run (CELLS);
+
+  for (std::size_t i = 0; i < serial.m_rxTbs.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_GT (serial.m_rxTbs.at (i).size (), 0, "No TB received by device " << i);
+      NS_TEST_EXPECT_MSG_EQ ((parallel.m_rxTbs.at (i) == serial.m_rxTbs.at (i)), true,
+                             "Different TBs received by device " << i);
+    }
+  for (std::size_t i = 0; i < serial.m_rxPackets.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_GT (serial.m_rxPackets.at (i).size (), 0, "No packet received by application " << i);
+      NS_TEST_EXPECT_MSG_EQ ((parallel.m_rxPackets.at (i) == serial.m_rxPackets.at (i)), true,
+                             "Different packets received by application " << i);
+    }
+
+  // The UL packets are created by the UEs, in the partition of their cell
+  for (uint32_t ue = 0; ue < serial.m_ulServers.size (); ++ue)
+    {
+      uint64_t partition = ue / UES_PER_CELL;
+      for (const RxPacket &packet : serial.m_rxPackets.at (serial.m_ulServers.at (ue)))
+        {
+          uint64_t uidPartition = std::get<2> (packet) >> 40;
+          NS_TEST_ASSERT_MSG_EQ (uidPartition, partition + 1,
+                                 "UL packet of UE " << ue << " without the uid of its partition");
+        }
+    }
+}
+
+/**
+ * \brief Test suite for multi-cell NR on the MultithreadedSimulatorImpl
+ */
+class NrTestParallelMultiCell : public TestSuite
+{
+public:
+  NrTestParallelMultiCell () : TestSuite ("nr-test-parallel-multicell", SYSTEM)
+  {
+    AddTestCase (new NrParallelMultiCellTestCase (), QUICK);
+  }
+};
+
+static NrTestParallelMultiCell g_nrTestParallelMultiCell; //!< Multi-cell NR on many threads test suite
+
+} // namespace ns3
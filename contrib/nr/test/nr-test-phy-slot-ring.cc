@@ -0,0 +1,338 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-gnb-phy.h>
+#include <ns3/packet.h>
+#include <ns3/packet-burst.h>
+#include <map>
+#include <memory>
+
+/**
+ * \file nr-test-phy-slot-ring.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the ring of the slot allocations and MAC PDUs of
+ * NrPhy. The tests store allocations and packet bursts through the methods
+ * used by the MAC and by the PHY, and check that they are found again:
+ * while the ring wraps around, after it grows with pending entries, after
+ * the allocations are moved by PushFrontSlotAllocInfo (), and that the
+ * bursts of a slot already over are discarded when their entry is reused.
+ */
+namespace ns3 {
+
+/**
+ * \brief A gNB PHY that exposes the methods that manage the slot ring
+ */
+class NrSlotRingTestPhy : public NrGnbPhy
+{
+public:
+  using NrPhy::PushFrontSlotAllocInfo;
+  using NrPhy::SlotAllocInfoExists;
+  using NrPhy::RetrieveSlotAllocInfo;
+  using NrPhy::PeekSlotAllocInfo;
+  using NrPhy::SlotAllocInfoSize;
+  using NrPhy::GetFirstSlotAllocSfnSf;
+  using NrPhy::GetPacketBurst;
+  using NrPhy::ReserveSlotAllocHorizon;
+};
+
+/**
+ * \brief Test the slot ring of NrPhy
+ */
+class NrPhySlotRingTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  NrPhySlotRingTestCase () : TestCase ("Slot ring of NrPhy") {}
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * \brief Store wrapping allocations while retrieving the first one
+   */
+  void TestWrapAround ();
+  /**
+   * \brief Grow the ring while it has allocations and bursts
+   */
+  void TestGrowth ();
+  /**
+   * \brief Move allocations and bursts with PushFrontSlotAllocInfo
+   */
+  void TestPushFront ();
+  /**
+   * \brief Reuse the entry of a slot with bursts never transmitted
+   */
+  void TestStaleBursts ();
+
+  /**
+   * \brief Create an allocation with a DL data DCI
+   * \param sfn the slot of the allocation
+   * \param symStart the first symbol of the DCI
+   * \param tbSize the TB size of the DCI, used to identify the allocation
+   * \return the allocation
+   */
+  static SlotAllocInfo CreateAlloc (const SfnSf &sfn, uint8_t symStart, uint32_t tbSize);
+  /**
+   * \brief Check the allocation retrieved for a slot
+   * \param alloc the allocation
+   * \param sfn the expected slot
+   * \param tbSize the expected TB size of the first DCI
+   */
+  void CheckAlloc (const SlotAllocInfo &alloc, const SfnSf &sfn, uint32_t tbSize);
+  /**
+   * \brief Check the burst of a slot, removing it
+   * \param phy the PHY
+   * \param sfn the slot
+   * \param symStart the first symbol
+   * \param size the expected size of the only packet, or 0 for no burst
+   */
+  void CheckBurst (const Ptr<NrSlotRingTestPhy> &phy, const SfnSf &sfn, uint8_t symStart, uint32_t size);
+};
+
+SlotAllocInfo
+NrPhySlotRingTestCase::CreateAlloc (const SfnSf &sfn, uint8_t symStart, uint32_t tbSize)
+{
+  SlotAllocInfo alloc (sfn);
+  alloc.m_type = SlotAllocInfo::DL;
+  alloc.m_numSymAlloc = 1;
+  auto dci = std::make_shared<DciInfoElementTdma> (1, DciInfoElementTdma::DL, symStart, 1,
+                                                   std::vector<uint8_t> {1},
+                                                   std::vector<uint32_t> {tbSize},
+                                                   std::vector<uint8_t> {1},
+                                                   std::vector<uint8_t> {0},
+                                                   DciInfoElementTdma::DATA, 0, 0);
+  alloc.m_varTtiAllocInfo.emplace_back (dci);
+  return alloc;
+}
+
+void
+NrPhySlotRingTestCase::CheckAlloc (const SlotAllocInfo &alloc, const SfnSf &sfn, uint32_t tbSize)
+{
+  NS_TEST_ASSERT_MSG_EQ (alloc.m_sfnSf, sfn, "Allocation of the wrong slot");
+  NS_TEST_ASSERT_MSG_EQ (alloc.m_varTtiAllocInfo.empty (), false, "Allocation without DCI");
+  NS_TEST_ASSERT_MSG_EQ (alloc.m_varTtiAllocInfo.front ().m_dci->m_tbSize.at (0), tbSize,
+                         "Wrong allocation in slot " << sfn);
+}
+
+void
+NrPhySlotRingTestCase::CheckBurst (const Ptr<NrSlotRingTestPhy> &phy, const SfnSf &sfn,
+                                   uint8_t symStart, uint32_t size)
+{
+  Ptr<PacketBurst> burst = phy->GetPacketBurst (sfn, symStart, 0);
+  if (size == 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (burst, nullptr, "Unexpected burst in slot " << sfn);
+      return;
+    }
+  NS_TEST_ASSERT_MSG_NE (burst, nullptr, "Missing burst in slot " << sfn);
+  NS_TEST_ASSERT_MSG_EQ (burst->GetNPackets (), 1, "Wrong burst in slot " << sfn);
+  NS_TEST_ASSERT_MSG_EQ (burst->GetSize (), size, "Wrong burst in slot " << sfn);
+}
+
+void
+NrPhySlotRingTestCase::TestWrapAround ()
+{
+  Ptr<NrSlotRingTestPhy> phy = CreateObject<NrSlotRingTestPhy> ();
+  SfnSf start (10, 0, 0, 0);
+  const uint32_t delay = 5;
+
+  // the allocations are stored delay slots in advance, and retrieved in
+  // their slot, for several laps of the (initial) ring
+  std::map<uint64_t, uint32_t> pending;
+  for (uint32_t t = 0; t < 200; ++t)
+    {
+      SfnSf future = start.GetFutureSfnSf (t + delay);
+      phy->PushBackSlotAllocInfo (CreateAlloc (future, 1, 100 + t));
+      phy->SetMacPdu (Create<Packet> (1 + t), future, 1, 0);
+      pending.emplace (future.Normalize (), 100 + t);
+
+      SfnSf current = start.GetFutureSfnSf (t);
+      if (t < delay)
+        {
+          NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoExists (current), false, "Unexpected allocation");
+          continue;
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoSize (), pending.size (), "Wrong number of allocations");
+      SfnSf first;
+      NS_TEST_ASSERT_MSG_EQ (phy->GetFirstSlotAllocSfnSf (&first), true, "Missing allocations");
+      NS_TEST_ASSERT_MSG_EQ (first, current, "Wrong first allocation");
+      NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoExists (current), true, "Missing allocation");
+
+      CheckAlloc (phy->RetrieveSlotAllocInfo (current), current, pending.at (current.Normalize ()));
+      CheckBurst (phy, current, 1, 1 + t - delay);
+      pending.erase (current.Normalize ());
+    }
+
+  // the last allocations are retrieved from the head of the ring
+  while (! pending.empty ())
+    {
+      SfnSf sfn = phy->RetrieveSlotAllocInfo ().m_sfnSf;
+      NS_TEST_ASSERT_MSG_EQ (sfn.Normalize (), pending.begin ()->first, "Allocations out of order");
+      pending.erase (pending.begin ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoSize (), 0, "Allocations left in the ring");
+  phy->Dispose ();
+}
+
+void
+NrPhySlotRingTestCase::TestGrowth ()
+{
+  Ptr<NrSlotRingTestPhy> phy = CreateObject<NrSlotRingTestPhy> ();
+  SfnSf start (20, 3, 0, 0);
+  const uint32_t numSlots = 70;
+
+  // allocations (merged with a second one every 3 slots) and bursts far
+  // beyond the initial ring size, and bursts of slots without allocation
+  for (uint32_t i = 0; i < numSlots; ++i)
+    {
+      SfnSf sfn = start.GetFutureSfnSf (i);
+      phy->PushBackSlotAllocInfo (CreateAlloc (sfn, 4, 1000 + i));
+      if (i % 3 == 0)
+        {
+          phy->PushBackSlotAllocInfo (CreateAlloc (sfn, 8, 2000 + i));
+        }
+      phy->SetMacPdu (Create<Packet> (10 + i), sfn, 4, 0);
+      phy->SetMacPdu (Create<Packet> (20 + i), start.GetFutureSfnSf (numSlots + 3 * i), 2, 0);
+      if (i == numSlots / 2)
+        {
+          phy->ReserveSlotAllocHorizon (300);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoSize (), numSlots, "Wrong number of allocations");
+
+  for (uint32_t i = 0; i < numSlots; ++i)
+    {
+      SfnSf sfn = start.GetFutureSfnSf (i);
+      SlotAllocInfo &peeked = phy->PeekSlotAllocInfo (sfn);
+      NS_TEST_ASSERT_MSG_EQ (peeked.m_varTtiAllocInfo.size (), (i % 3 == 0 ? 2u : 1u),
+                             "Allocations not merged in slot " << sfn);
+      SlotAllocInfo alloc = phy->RetrieveSlotAllocInfo ();
+      CheckAlloc (alloc, sfn, 1000 + i);
+      if (i % 3 == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (alloc.m_varTtiAllocInfo.back ().m_dci->m_tbSize.at (0), 2000 + i,
+                                 "Wrong merged allocation in slot " << sfn);
+        }
+      CheckBurst (phy, sfn, 4, 10 + i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoSize (), 0, "Allocations left in the ring");
+
+  // the bursts of slots not over yet are still there
+  for (uint32_t i = 0; i < numSlots; ++i)
+    {
+      CheckBurst (phy, start.GetFutureSfnSf (numSlots + 3 * i), 2, 20 + i);
+    }
+  phy->Dispose ();
+}
+
+void
+NrPhySlotRingTestCase::TestPushFront ()
+{
+  Ptr<NrSlotRingTestPhy> phy = CreateObject<NrSlotRingTestPhy> ();
+  SfnSf start (30, 9, 0, 0);
+
+  // pending allocations in slots 5, 7, 8 and 30 (beyond the initial ring),
+  // with their bursts
+  const std::vector<uint32_t> offsets {5, 7, 8, 30};
+  for (uint32_t i = 0; i < offsets.size (); ++i)
+    {
+      SfnSf sfn = start.GetFutureSfnSf (offsets[i]);
+      phy->PushBackSlotAllocInfo (CreateAlloc (sfn, 2 + i, 500 + i));
+      phy->SetMacPdu (Create<Packet> (50 + i), sfn, 2 + i, 0);
+    }
+  // a burst of a slot without allocation is not moved
+  phy->SetMacPdu (Create<Packet> (99), start.GetFutureSfnSf (6), 3, 0);
+
+  // the new allocation goes in slot 3, and the others follow it in
+  // consecutive slots, up to slot 7
+  phy->PushFrontSlotAllocInfo (start.GetFutureSfnSf (3), CreateAlloc (start.GetFutureSfnSf (3), 1, 400));
+  NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoSize (), offsets.size () + 1, "Wrong number of allocations");
+  for (uint32_t offset : {8, 30})
+    {
+      NS_TEST_ASSERT_MSG_EQ (phy->SlotAllocInfoExists (start.GetFutureSfnSf (offset)), false,
+                             "Allocation left in slot " << offset);
+    }
+
+  CheckAlloc (phy->RetrieveSlotAllocInfo (start.GetFutureSfnSf (3)), start.GetFutureSfnSf (3), 400);
+  for (uint32_t i = 0; i < offsets.size (); ++i)
+    {
+      SfnSf sfn = start.GetFutureSfnSf (4 + i);
+      CheckAlloc (phy->RetrieveSlotAllocInfo (sfn), sfn, 500 + i);
+      CheckBurst (phy, sfn, 2 + i, 50 + i);
+      CheckBurst (phy, start.GetFutureSfnSf (offsets[i]), 2 + i, 0);
+    }
+  CheckBurst (phy, start.GetFutureSfnSf (6), 3, 99);
+  phy->Dispose ();
+}
+
+void
+NrPhySlotRingTestCase::TestStaleBursts ()
+{
+  // The ring of a new PHY has 16 slots: slots 16 apart share an entry
+  Ptr<NrSlotRingTestPhy> phy = CreateObject<NrSlotRingTestPhy> ();
+  SfnSf start (40, 0, 0, 0);
+
+  // a burst that is never transmitted, in a slot that is then over
+  phy->SetMacPdu (Create<Packet> (11), start.GetFutureSfnSf (2), 1, 0);
+  phy->PushBackSlotAllocInfo (CreateAlloc (start.GetFutureSfnSf (3), 1, 300));
+  CheckAlloc (phy->RetrieveSlotAllocInfo (start.GetFutureSfnSf (3)), start.GetFutureSfnSf (3), 300);
+
+  // a burst of a slot not over yet
+  phy->SetMacPdu (Create<Packet> (12), start.GetFutureSfnSf (4), 1, 0);
+
+  // the entry of slot 2 is reused, discarding its burst; the one of slot
+  // 4 is not, and the ring grows
+  phy->SetMacPdu (Create<Packet> (13), start.GetFutureSfnSf (18), 1, 0);
+  phy->SetMacPdu (Create<Packet> (14), start.GetFutureSfnSf (20), 1, 0);
+
+  CheckBurst (phy, start.GetFutureSfnSf (2), 1, 0);
+  CheckBurst (phy, start.GetFutureSfnSf (4), 1, 12);
+  CheckBurst (phy, start.GetFutureSfnSf (18), 1, 13);
+  CheckBurst (phy, start.GetFutureSfnSf (20), 1, 14);
+  phy->Dispose ();
+}
+
+void
+NrPhySlotRingTestCase::DoRun ()
+{
+  TestWrapAround ();
+  TestGrowth ();
+  TestPushFront ();
+  TestStaleBursts ();
+}
+
+/**
+ * \brief Test suite for the slot ring of NrPhy
+ */
+class NrTestPhySlotRing : public TestSuite
+{
+public:
+  NrTestPhySlotRing () : TestSuite ("nr-test-phy-slot-ring", UNIT)
+  {
+    AddTestCase (new NrPhySlotRingTestCase (), QUICK);
+  }
+};
+
+static NrTestPhySlotRing g_nrTestPhySlotRing; //!< Slot ring test suite
+
+}  // namespace ns3
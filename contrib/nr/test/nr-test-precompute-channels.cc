@@ -0,0 +1,165 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/nr-module.h>
+
+/**
+ * \file nr-test-precompute-channels.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrHelper::PrecomputeChannels. The test deploys
+ * two gNBs and four UEs, and retrieves the channel matrix of each gNB-UE
+ * pair: after PrecomputeChannels with one thread, after PrecomputeChannels
+ * with four threads, and without PrecomputeChannels (generating the
+ * channels one by one, in the same order). The three sets of channel
+ * matrices must be equal.
+ */
+namespace ns3 {
+
+/**
+ * \brief Test that the precomputed channels do not depend on the number of
+ * threads, and are the ones generated on demand
+ */
+class NrPrecomputeChannelsTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  NrPrecomputeChannelsTestCase ()
+    : TestCase ("NR precomputed channel matrices")
+  {}
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * \brief Deploy the scenario and retrieve the channel matrices
+   * \param numThreads the threads of PrecomputeChannels, 0 to not call it
+   * \return the channel matrix of each gNB-UE pair
+   */
+  std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix>> GetChannels (uint32_t numThreads);
+};
+
+std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix>>
+NrPrecomputeChannelsTestCase::GetChannels (uint32_t numThreads)
+{
+  NodeContainer gnbNodes;
+  NodeContainer ueNodes;
+  gnbNodes.Create (2);
+  ueNodes.Create (4);
+
+  Ptr<ListPositionAllocator> gnbPositions = CreateObject<ListPositionAllocator> ();
+  gnbPositions->Add (Vector (0.0, 0.0, 10.0));
+  gnbPositions->Add (Vector (100.0, 0.0, 10.0));
+  Ptr<ListPositionAllocator> uePositions = CreateObject<ListPositionAllocator> ();
+  uePositions->Add (Vector (20.0, 10.0, 1.5));
+  uePositions->Add (Vector (40.0, -30.0, 1.5));
+  uePositions->Add (Vector (70.0, 25.0, 1.5));
+  uePositions->Add (Vector (90.0, -5.0, 1.5));
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (gnbPositions);
+  mobility.Install (gnbNodes);
+  mobility.SetPositionAllocator (uePositions);
+  mobility.Install (ueNodes);
+
+  Ptr<NrHelper> nrHelper = CreateObject<NrHelper> ();
+  nrHelper->SetGnbAntennaAttribute ("NumRows", UintegerValue (4));
+  nrHelper->SetGnbAntennaAttribute ("NumColumns", UintegerValue (4));
+  nrHelper->SetUeAntennaAttribute ("NumRows", UintegerValue (2));
+  nrHelper->SetUeAntennaAttribute ("NumColumns", UintegerValue (2));
+  CcBwpCreator::SimpleOperationBandConf bandConf (28e9, 20e6, 1, BandwidthPartInfo::UMi_StreetCanyon);
+  CcBwpCreator ccBwpCreator;
+  OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc (bandConf);
+  nrHelper->InitializeOperationBand (&band);
+  BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps ({band});
+
+  NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice (gnbNodes, allBwps);
+  NetDeviceContainer ueDevs = nrHelper->InstallUeDevice (ueNodes, allBwps);
+  int64_t stream = 1;
+  stream += nrHelper->AssignStreams (gnbDevs, stream);
+  nrHelper->AssignStreams (ueDevs, stream);
+
+  if (numThreads > 0)
+    {
+      nrHelper->PrecomputeChannels (gnbDevs, ueDevs, numThreads);
+    }
+
+  std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix>> channels;
+  for (uint32_t i = 0; i < gnbDevs.GetN (); ++i)
+    {
+      Ptr<NrSpectrumPhy> gnbPhy = nrHelper->GetGnbPhy (gnbDevs.Get (i), 0)->GetSpectrumPhy ();
+      Ptr<ThreeGppSpectrumPropagationLossModel> lossModel =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel> (gnbPhy->GetSpectrumChannel ()->GetPhasedArraySpectrumPropagationLossModel ());
+      NS_ABORT_IF (lossModel == nullptr);
+      Ptr<MatrixBasedChannelModel> channelModel = lossModel->GetChannelModel ();
+      for (uint32_t j = 0; j < ueDevs.GetN (); ++j)
+        {
+          Ptr<NrSpectrumPhy> uePhy = nrHelper->GetUePhy (ueDevs.Get (j), 0)->GetSpectrumPhy ();
+          channels.push_back (channelModel->GetChannel (gnbPhy->GetMobility (), uePhy->GetMobility (),
+                                                        DynamicCast<const PhasedArrayModel> (gnbPhy->GetAntenna ()),
+                                                        DynamicCast<const PhasedArrayModel> (uePhy->GetAntenna ())));
+        }
+    }
+
+  Simulator::Destroy ();
+  return channels;
+}
+
+void
+NrPrecomputeChannelsTestCase::DoRun ()
+{
+  std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix>> serial = GetChannels (1);
+  std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix>> parallel = GetChannels (4);
+  std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix>> onDemand = GetChannels (0);
+
+  NS_TEST_ASSERT_MSG_EQ (serial.size (), 8, "Unexpected number of channels");
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), serial.size (), "Unexpected number of channels");
+  NS_TEST_ASSERT_MSG_EQ (onDemand.size (), serial.size (), "Unexpected number of channels");
+  for (std::size_t i = 0; i < serial.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (serial[i]->m_channel.GetNumRows (), 4, "The rows of H are not the UE antenna elements");
+      NS_TEST_ASSERT_MSG_EQ (serial[i]->m_channel.GetNumCols (), 16, "The columns of H are not the gNB antenna elements");
+      NS_TEST_ASSERT_MSG_EQ ((serial[i]->m_channel == parallel[i]->m_channel), true,
+                             "The channel " << i << " depends on the number of threads");
+      NS_TEST_ASSERT_MSG_EQ ((serial[i]->m_channel == onDemand[i]->m_channel), true,
+                             "The precomputed channel " << i << " differs from the one generated on demand");
+    }
+}
+
+/**
+ * \brief Test suite for NrHelper::PrecomputeChannels
+ */
+class NrTestPrecomputeChannels : public TestSuite
+{
+public:
+  NrTestPrecomputeChannels () : TestSuite ("nr-test-precompute-channels", UNIT)
+  {
+    AddTestCase (new NrPrecomputeChannelsTestCase (), QUICK);
+  }
+};
+
+static NrTestPrecomputeChannels g_nrTestPrecomputeChannels; //!< Precomputed channels test suite
+
+}  // namespace ns3
@@ -0,0 +1,497 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/boolean.h>
+#include <ns3/object-factory.h>
+#include <ns3/eps-bearer.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-mac-sched-sap.h>
+#include <ns3/nr-mac-scheduler-ns3.h>
+#include <ns3/nr-mac-short-bsr-ce.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/uinteger.h>
+#include <set>
+
+/**
+ * \file nr-test-sched-buffered-ue.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing of the index of the UEs that may have data
+ * (m_dlBufferedUe and m_ulBufferedUe) of NrMacSchedulerNs3, which replaces
+ * the scan of all the attached UEs when the active UEs of a slot are
+ * computed. The scheduler is driven through its SAPs with random sequences of
+ * RLC buffer status reports, BSRs, SRs (or CGRs, with configured grant),
+ * DL and UL slots (that drain the LCGs of the scheduled UEs), UE releases
+ * and UE re-attachments. After each step, the index is compared with a full
+ * scan of the UE map:
+ *
+ * - it is ordered by RNTI, without duplicates, and only contains attached UEs;
+ * - every UE with data in its LCGs is in the index (the ones without data can
+ * still be there, until the next computation of the active UEs);
+ * - after ComputeActiveUe, the index contains exactly the UEs with data, and
+ * the active UEs are the ones with data and a free HARQ process.
+ */
+namespace ns3 {
+
+/**
+ * \ingroup test
+ * \brief CSCHED SAP user that ignores the confirmations
+ */
+class NrBufferedUeTestCschedSapUser : public NrMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf ([[maybe_unused]] const struct CschedCellConfigCnfParameters& params) override
+  {
+  }
+  virtual void CschedUeConfigCnf ([[maybe_unused]] const struct CschedUeConfigCnfParameters& params) override
+  {
+  }
+  virtual void CschedLcConfigCnf ([[maybe_unused]] const struct CschedLcConfigCnfParameters& params) override
+  {
+  }
+  virtual void CschedLcReleaseCnf ([[maybe_unused]] const struct CschedLcReleaseCnfParameters& params) override
+  {
+  }
+  virtual void CschedUeReleaseCnf ([[maybe_unused]] const struct CschedUeReleaseCnfParameters& params) override
+  {
+  }
+  virtual void CschedUeConfigUpdateInd ([[maybe_unused]] const struct CschedUeConfigUpdateIndParameters& params) override
+  {
+  }
+  virtual void CschedCellConfigUpdateInd ([[maybe_unused]] const struct CschedCellConfigUpdateIndParameters& params) override
+  {
+  }
+};
+
+/**
+ * \ingroup test
+ * \brief SCHED SAP user with hard-coded values, that counts the data DCIs
+ */
+class NrBufferedUeTestSchedSapUser : public NrMacSchedSapUser
+{
+public:
+  virtual void SchedConfigInd (const struct SchedConfigIndParameters& params) override
+  {
+    for (const auto &alloc : params.m_slotAllocInfo.m_varTtiAllocInfo)
+      {
+        if (alloc.m_dci->m_type == DciInfoElementTdma::DATA)
+          {
+            ++m_dataDci;
+          }
+      }
+  }
+  virtual Ptr<const SpectrumModel> GetSpectrumModel () const override
+  {
+    return nullptr;
+  }
+  virtual uint32_t GetNumRbPerRbg () const override
+  {
+    return 1;
+  }
+  virtual uint8_t GetNumHarqProcess () const override
+  {
+    return 20;
+  }
+  virtual uint16_t GetBwpId () const override
+  {
+    return 0;
+  }
+  virtual uint16_t GetCellId () const override
+  {
+    return 0;
+  }
+  virtual uint32_t GetSymbolsPerSlot () const override
+  {
+    return 14;
+  }
+  virtual Time GetSlotPeriod () const override
+  {
+    return MilliSeconds (1);
+  }
+  virtual Time GetTbUlEncodeLatency () const override
+  {
+    return Seconds (0);
+  }
+
+  uint32_t m_dataDci {0}; //!< Data DCIs received
+};
+
+/**
+ * \ingroup test
+ * \brief Compare the buffered UE index of the scheduler with a full scan
+ */
+class NrSchedBufferedUeTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param scheduler the type of the scheduler
+   * \param cg true to request UL resources with CGRs, false with SRs
+   */
+  NrSchedBufferedUeTestCase (const std::string &scheduler, bool cg)
+    : TestCase (scheduler + (cg ? " with CGR" : " with SR")),
+      m_scheduler (scheduler),
+      m_cg (cg)
+  {
+  }
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * \brief Attach an UE, with a LC in the LCG 1 in both directions
+   * \param rnti the UE
+   */
+  void AddUe (uint16_t rnti);
+
+  /**
+   * \brief Check the buffered UE index of one direction
+   * \param bufferedUe the index
+   * \param GetLCGFn function to retrieve the LCGs of an UE
+   * \param exact true if the index should contain only UEs with data
+   * \param what description of the check
+   */
+  void CheckIndex (const std::vector<UePtr> &bufferedUe,
+                   const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn, bool exact,
+                   const std::string &what);
+
+  /**
+   * \brief Check both the indexes, then compute the active UEs as the
+   * scheduler does at the beginning of a slot and check the result
+   * \param what description of the check
+   */
+  void CheckActiveUe (const std::string &what);
+
+  /**
+   * \brief Total size of the LCGs of an UE
+   * \param ue the UE
+   * \param GetLCGFn function to retrieve the LCGs
+   * \return the bytes of the UE
+   */
+  static uint32_t GetBufferSize (const UePtr &ue,
+                                 const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn);
+
+  static const uint16_t UES = 20; //!< RNTIs from 1 to UES
+  static const uint8_t LCID = 4;  //!< The LC of the UEs
+
+  std::string m_scheduler;                       //!< Type of the scheduler
+  bool m_cg;                                     //!< CGR or SR
+  Ptr<NrMacSchedulerNs3> m_sched;                //!< The scheduler
+  NrBufferedUeTestCschedSapUser m_cschedSapUser; //!< CSCHED SAP user
+  NrBufferedUeTestSchedSapUser m_schedSapUser;   //!< SCHED SAP user
+};
+
+void
+NrSchedBufferedUeTestCase::AddUe (uint16_t rnti)
+{
+  NrMacCschedSapProvider::CschedUeConfigReqParameters ue;
+  ue.m_rnti = rnti;
+  // two beams, to have the active UEs grouped
+  ue.m_beamConfId = BeamConfId (BeamId (rnti % 2, 120.0), BeamId::GetEmptyBeamId ());
+  m_sched->DoCschedUeConfigReq (ue);
+
+  NrMacCschedSapProvider::CschedLcConfigReqParameters lcs;
+  LogicalChannelConfigListElement_s lc;
+  lc.m_logicalChannelIdentity = LCID;
+  lc.m_logicalChannelGroup = 1;
+  lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+  lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+  lc.m_qci = EpsBearer::NGBR_VIDEO_TCP_DEFAULT;
+  lcs.m_rnti = rnti;
+  lcs.m_reconfigureFlag = false;
+  lcs.m_logicalChannelConfigList.emplace_back (lc);
+  m_sched->DoCschedLcConfigReq (lcs);
+}
+
+uint32_t
+NrSchedBufferedUeTestCase::GetBufferSize (const UePtr &ue,
+                                          const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn)
+{
+  uint32_t bytes = 0;
+  for (const auto &lcg : GetLCGFn (ue))
+    {
+      bytes += lcg.second->GetTotalSize ();
+    }
+  return bytes;
+}
+
+void
+NrSchedBufferedUeTestCase::CheckIndex (const std::vector<UePtr> &bufferedUe,
+                                       const NrMacSchedulerUeInfo::GetLCGFn &GetLCGFn, bool exact,
+                                       const std::string &what)
+{
+  std::set<uint16_t> indexed;
+  for (std::size_t i = 0; i < bufferedUe.size (); ++i)
+    {
+      const auto &ue = bufferedUe.at (i);
+      if (i > 0)
+        {
+          NS_TEST_ASSERT_MSG_LT (bufferedUe.at (i - 1)->m_rnti, ue->m_rnti,
+                                 what << ": index not ordered by RNTI, or with duplicates");
+        }
+      auto it = m_sched->m_ueMap.find (ue->m_rnti);
+      NS_TEST_ASSERT_MSG_EQ ((it != m_sched->m_ueMap.end () && it->second == ue), true,
+                             what << ": UE " << ue->m_rnti << " in the index is not attached");
+      if (exact)
+        {
+          NS_TEST_ASSERT_MSG_GT (GetBufferSize (ue, GetLCGFn), 0,
+                                 what << ": UE " << ue->m_rnti << " without data not removed");
+        }
+      indexed.insert (ue->m_rnti);
+    }
+
+  for (const auto &ue : m_sched->m_ueMap)
+    {
+      if (GetBufferSize (ue.second, GetLCGFn) > 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (indexed.count (ue.first), 1,
+                                 what << ": UE " << ue.first << " with data is not in the index");
+        }
+    }
+}
+
+void
+NrSchedBufferedUeTestCase::CheckActiveUe (const std::string &what)
+{
+  CheckIndex (m_sched->m_dlBufferedUe, &NrMacSchedulerUeInfo::GetDlLCG, false, what + ", DL");
+  CheckIndex (m_sched->m_ulBufferedUe, &NrMacSchedulerUeInfo::GetUlLCG, false, what + ", UL");
+
+  for (bool dl : {true, false})
+    {
+      auto &bufferedUe = dl ? m_sched->m_dlBufferedUe : m_sched->m_ulBufferedUe;
+      auto GetLCG = dl ? &NrMacSchedulerUeInfo::GetDlLCG : &NrMacSchedulerUeInfo::GetUlLCG;
+      auto GetHarq = dl ? &NrMacSchedulerUeInfo::GetDlHarqVector : &NrMacSchedulerUeInfo::GetUlHarqVector;
+      std::string dir = dl ? ", DL" : ", UL";
+
+      NrMacSchedulerNs3::ActiveUeMap activeUe;
+      m_sched->ComputeActiveUe (&activeUe, &bufferedUe, GetLCG, GetHarq, dir);
+      CheckIndex (bufferedUe, GetLCG, true, what + ", active UEs computed" + dir);
+
+      // The active UEs of a full scan, in RNTI order inside each beam
+      std::map<uint16_t, std::pair<BeamConfId, uint32_t>> expected;
+      for (const auto &ue : m_sched->m_ueMap)
+        {
+          uint32_t bytes = GetBufferSize (ue.second, GetLCG);
+          if (bytes > 0 && GetHarq (ue.second).CanInsert ())
+            {
+              expected.emplace (ue.first, std::make_pair (ue.second->m_beamConfId, bytes));
+            }
+        }
+
+      std::size_t active = 0;
+      for (const auto &beam : activeUe)
+        {
+          uint16_t previous = 0;
+          for (const auto &ue : beam.second)
+            {
+              auto it = expected.find (ue.first->m_rnti);
+              NS_TEST_ASSERT_MSG_EQ ((it != expected.end ()), true,
+                                     what << dir << ": UE " << ue.first->m_rnti << " should not be active");
+              NS_TEST_ASSERT_MSG_EQ ((it->second.first == beam.first), true,
+                                     what << dir << ": UE " << ue.first->m_rnti << " in the wrong beam");
+              NS_TEST_ASSERT_MSG_EQ (ue.second, it->second.second,
+                                     what << dir << ": wrong buffer for UE " << ue.first->m_rnti);
+              NS_TEST_ASSERT_MSG_LT (previous, ue.first->m_rnti,
+                                     what << dir << ": active UEs not in RNTI order");
+              previous = ue.first->m_rnti;
+              ++active;
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (active, expected.size (), what << dir << ": active UEs missing");
+      m_sched->ReleaseActiveUe (&activeUe);
+    }
+}
+
+void
+NrSchedBufferedUeTestCase::DoRun ()
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (m_cg ? 2 : 1);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+
+  ObjectFactory factory;
+  factory.SetTypeId (m_scheduler);
+  factory.Set ("CG", BooleanValue (m_cg));
+  factory.Set ("StartingMcsDl", UintegerValue (10));
+  factory.Set ("StartingMcsUl", UintegerValue (10));
+  // No SRS: the test is about the data of the UEs
+  factory.Set ("EnableSrsInFSlots", BooleanValue (false));
+  factory.Set ("EnableSrsInUlSlots", BooleanValue (false));
+  m_sched = DynamicCast<NrMacSchedulerNs3> (factory.Create ());
+  NS_ABORT_MSG_IF (m_sched == nullptr, "Can't create a NrMacSchedulerNs3 from type " + m_scheduler);
+  m_sched->SetMacCschedSapUser (&m_cschedSapUser);
+  m_sched->SetMacSchedSapUser (&m_schedSapUser);
+  m_sched->InstallDlAmc (CreateObject<NrAmc> ());
+  m_sched->InstallUlAmc (CreateObject<NrAmc> ());
+
+  NrMacCschedSapProvider::CschedCellConfigReqParameters cell;
+  cell.m_dlBandwidth = 25;
+  cell.m_ulBandwidth = 25;
+  m_sched->DoCschedCellConfigReq (cell);
+
+  for (uint16_t rnti = 1; rnti <= UES; ++rnti)
+    {
+      AddUe (rnti);
+    }
+
+  SfnSf sfn (0, 0, 0, 0);
+  uint32_t releases = 0;
+  uint32_t reinsertions = 0;
+  for (uint32_t step = 0; step < 3000; ++step)
+    {
+      std::stringstream what;
+      what << "step " << step;
+      uint16_t rnti = static_cast<uint16_t> (rng->GetInteger (1, UES));
+      bool attached = m_sched->m_ueMap.count (rnti) > 0;
+      // Drained UEs are removed from the index by the next slot, and a report
+      // inserts them again
+      bool inDlIndex = std::any_of (m_sched->m_dlBufferedUe.begin (), m_sched->m_dlBufferedUe.end (),
+                                    [rnti] (const UePtr &ue) { return ue->m_rnti == rnti; });
+
+      switch (rng->GetInteger (0, 6))
+        {
+        case 0:
+          if (attached)
+            {
+              // The RLC queue shrinks only with the data scheduled: a report
+              // carries the same queue, or new data on top of it
+              uint32_t queue = m_sched->m_ueMap.at (rnti)->m_dlLCG.at (1)->GetTotalSizeOfLC (LCID);
+              NrMacSchedSapProvider::SchedDlRlcBufferReqParameters params;
+              params.m_rnti = rnti;
+              params.m_logicalChannelIdentity = LCID;
+              params.m_rlcTransmissionQueueSize = rng->GetInteger (0, 2) == 0 ? queue : queue + rng->GetInteger (1, 3000);
+              params.m_rlcTransmissionQueueHolDelay = 0;
+              params.m_rlcRetransmissionQueueSize = 0;
+              params.m_rlcRetransmissionHolDelay = 0;
+              params.m_rlcStatusPduSize = 0;
+              m_sched->DoSchedDlRlcBufferReq (params);
+              reinsertions += (! inDlIndex && params.m_rlcTransmissionQueueSize > 0) ? 1 : 0;
+            }
+          break;
+        case 1:
+          if (attached)
+            {
+              MacCeElement bsr;
+              bsr.m_rnti = rnti;
+              bsr.m_macCeType = MacCeElement::BSR;
+              bsr.m_macCeValue.m_bufferStatus.resize (4, 0);
+              bsr.m_macCeValue.m_bufferStatus.at (1) = rng->GetInteger (0, 2) == 0
+                ? 0 : NrMacShortBsrCe::FromBytesToLevel (rng->GetInteger (1, 3000));
+              NrMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters params;
+              params.m_macCeList.push_back (bsr);
+              m_sched->DoSchedUlMacCtrlInfoReq (params);
+            }
+          break;
+        case 2:
+          // The request is served in the next UL slot, before the UE can be
+          // released
+          if (attached)
+            {
+              if (m_cg)
+                {
+                  NrMacSchedSapProvider::SchedUlCgrInfoReqParameters params;
+                  params.m_srList = {rnti};
+                  params.m_bufCgr = {static_cast<uint32_t> (rng->GetInteger (1, 1000))};
+                  params.lcid = LCID;
+                  params.m_TraffPCgr = {10};
+                  m_sched->DoSchedUlCgrInfoReq (params);
+                }
+              else
+                {
+                  NrMacSchedSapProvider::SchedUlSrInfoReqParameters params;
+                  params.m_srList = {rnti};
+                  m_sched->DoSchedUlSrInfoReq (params);
+                }
+              NS_TEST_ASSERT_MSG_EQ (m_sched->m_srList.size (), 1, "Request not stored");
+            }
+          [[fallthrough]];
+        case 3:
+          {
+            // Flexible slots, as the ones of the default TDD pattern
+            NrMacSchedSapProvider::SchedUlTriggerReqParameters params;
+            params.m_snfSf = sfn;
+            params.m_slotType = LteNrTddSlotType::F;
+            m_sched->DoSchedUlTriggerReq (params);
+            sfn.Add (1);
+            NS_TEST_ASSERT_MSG_EQ (m_sched->m_srList.size (), 0, "Request not served");
+          }
+          break;
+        case 4:
+          {
+            NrMacSchedSapProvider::SchedDlTriggerReqParameters params;
+            params.m_snfSf = sfn;
+            params.m_slotType = LteNrTddSlotType::F;
+            m_sched->DoSchedDlTriggerReq (params);
+            sfn.Add (1);
+          }
+          break;
+        case 5:
+          if (attached && rng->GetInteger (0, 3) == 0)
+            {
+              NrMacCschedSapProvider::CschedUeReleaseReqParameters params;
+              params.m_rnti = rnti;
+              m_sched->DoCschedUeReleaseReq (params);
+              ++releases;
+            }
+          else if (! attached)
+            {
+              AddUe (rnti);
+            }
+          break;
+        case 6:
+          CheckActiveUe (what.str ());
+          break;
+        }
+
+      CheckIndex (m_sched->m_dlBufferedUe, &NrMacSchedulerUeInfo::GetDlLCG, false, what.str () + ", DL");
+      CheckIndex (m_sched->m_ulBufferedUe, &NrMacSchedulerUeInfo::GetUlLCG, false, what.str () + ", UL");
+    }
+
+  // The random sequence went through all the paths
+  NS_TEST_ASSERT_MSG_GT (releases, 0, "No UE released");
+  NS_TEST_ASSERT_MSG_GT (reinsertions, 0, "No UE inserted again in the DL index");
+  NS_TEST_ASSERT_MSG_GT (m_schedSapUser.m_dataDci, 0, "No data scheduled");
+
+  m_sched = nullptr;
+}
+
+/**
+ * \ingroup test
+ * \brief Test suite for the buffered UE index of the schedulers
+ */
+class NrTestSchedBufferedUeSuite : public TestSuite
+{
+public:
+  NrTestSchedBufferedUeSuite () : TestSuite ("nr-test-sched-buffered-ue", UNIT)
+  {
+    // The UL of the OFDMA schedulers is placed backward from the first UL
+    // symbol of the F slots, so only the TDMA ones are driven here; the
+    // index is the same for all the schedulers
+    for (const auto &scheduler : {"ns3::NrMacSchedulerTdmaRR", "ns3::NrMacSchedulerTdmaPF"})
+      {
+        AddTestCase (new NrSchedBufferedUeTestCase (scheduler, false), QUICK);
+        AddTestCase (new NrSchedBufferedUeTestCase (scheduler, true), QUICK);
+      }
+  }
+};
+
+static NrTestSchedBufferedUeSuite g_nrTestSchedBufferedUeSuite; //!< Buffered UE index test suite
+
+}  // namespace ns3
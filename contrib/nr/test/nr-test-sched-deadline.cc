@@ -0,0 +1,435 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/eps-bearer.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-mac-sched-sap.h>
+#include <ns3/nr-mac-scheduler-ofdma-aoi.h>
+#include <ns3/nr-mac-scheduler-ofdma-edf.h>
+#include <ns3/nr-mac-scheduler-ue-info-edf.h>
+#include <ns3/nr-mac-short-bsr-ce.h>
+#include <ns3/uinteger.h>
+
+/**
+ * \file nr-test-sched-deadline.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing of the order in which the deadline-aware schedulers
+ * (NrMacSchedulerOfdmaEdf and NrMacSchedulerOfdmaAoI) serve the UEs of a
+ * beam. The UEs are registered through the CSCHED SAP, and the generation
+ * time of their data is given through RLC buffer status reports, BSRs and
+ * CGRs, as done by the MAC; then, the RBGs assigned by AssignDLRBG and
+ * AssignULRBG are checked:
+ *
+ * - EDF gives all the RBGs to the UE with the earliest deadline, when its
+ * buffer needs them all;
+ * - when the buffer of the first UE is covered, the remaining RBGs go to the
+ * UE with the next deadline;
+ * - UEs with the same deadline are served in RNTI order;
+ * - AoI, in the same state, serves the UE whose information is the oldest
+ * at the receiver, which is not the one with the earliest deadline;
+ * - in UL, the deadline signaled in a CGR overrides the UlDelayBudget.
+ */
+namespace ns3 {
+
+/**
+ * \ingroup test
+ * \brief CSCHED SAP user that ignores the confirmations
+ */
+class NrDeadlineTestCschedSapUser : public NrMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf ([[maybe_unused]] const struct CschedCellConfigCnfParameters& params) override
+  {
+  }
+  virtual void CschedUeConfigCnf ([[maybe_unused]] const struct CschedUeConfigCnfParameters& params) override
+  {
+  }
+  virtual void CschedLcConfigCnf ([[maybe_unused]] const struct CschedLcConfigCnfParameters& params) override
+  {
+  }
+  virtual void CschedLcReleaseCnf ([[maybe_unused]] const struct CschedLcReleaseCnfParameters& params) override
+  {
+  }
+  virtual void CschedUeReleaseCnf ([[maybe_unused]] const struct CschedUeReleaseCnfParameters& params) override
+  {
+  }
+  virtual void CschedUeConfigUpdateInd ([[maybe_unused]] const struct CschedUeConfigUpdateIndParameters& params) override
+  {
+  }
+  virtual void CschedCellConfigUpdateInd ([[maybe_unused]] const struct CschedCellConfigUpdateIndParameters& params) override
+  {
+  }
+};
+
+/**
+ * \ingroup test
+ * \brief SCHED SAP user with hard-coded values: one RB per RBG, 14 symbols
+ */
+class NrDeadlineTestSchedSapUser : public NrMacSchedSapUser
+{
+public:
+  virtual void SchedConfigInd ([[maybe_unused]] const struct SchedConfigIndParameters& params) override
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetSpectrumModel () const override
+  {
+    return nullptr;
+  }
+  virtual uint32_t GetNumRbPerRbg () const override
+  {
+    return 1;
+  }
+  virtual uint8_t GetNumHarqProcess () const override
+  {
+    return 20;
+  }
+  virtual uint16_t GetBwpId () const override
+  {
+    return 0;
+  }
+  virtual uint16_t GetCellId () const override
+  {
+    return 0;
+  }
+  virtual uint32_t GetSymbolsPerSlot () const override
+  {
+    return 14;
+  }
+  virtual Time GetSlotPeriod () const override
+  {
+    return MilliSeconds (1);
+  }
+  virtual Time GetTbUlEncodeLatency () const override
+  {
+    return Seconds (0);
+  }
+};
+
+/**
+ * \ingroup test
+ * \brief A deadline-aware scheduler whose RBG assignment can be called
+ * directly
+ */
+template <class T>
+class NrDeadlineTestScheduler : public T
+{
+public:
+  using T::AssignDLRBG;
+  using T::AssignULRBG;
+  using T::GetUeInfo;
+  using T::GetScheduler;
+};
+
+/**
+ * \ingroup test
+ * \brief Check the order in which the EDF and AoI schedulers serve the UEs
+ */
+class NrSchedDeadlineTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  NrSchedDeadlineTestCase () : TestCase ("EDF deadline order and AoI priority")
+  {
+  }
+
+private:
+  virtual void DoRun (void) override;
+
+  /**
+   * \brief Configure a scheduler with a bandwidth of RBGS RBGs, and register
+   * the UEs 1 to 3 in the same beam, each with a LC in the LCG 1
+   * \param sched the scheduler
+   */
+  void Configure (const Ptr<NrMacSchedulerNs3> &sched);
+
+  /// The active UEs of a slot, with the bytes to serve
+  typedef std::vector<std::pair<uint16_t, uint32_t>> UeBuffers;
+
+  /**
+   * \brief Update the DL buffer of an UE through the RLC buffer status
+   * \param sched the scheduler
+   * \param rnti the UE
+   * \param bytes bytes in the RLC queue
+   * \param holDelayMs head-of-line delay, in ms
+   */
+  static void DlBuffer (const Ptr<NrMacSchedulerNs3> &sched, uint16_t rnti,
+                        uint32_t bytes, uint16_t holDelayMs);
+
+  /**
+   * \brief Assign the DL RBGs of a slot to the UEs with data
+   * \param sched the scheduler
+   * \param buffers the UEs, in the order of the active UE list, with the bytes to serve
+   * \return the RBGs assigned to the UEs 1 to 3 (index 0 unused)
+   */
+  template <class T>
+  std::vector<uint32_t> AssignDl (const Ptr<NrDeadlineTestScheduler<T>> &sched,
+                                  const UeBuffers &buffers);
+
+  /**
+   * \brief Assign the UL RBGs of a slot to the UEs with data
+   * \param sched the scheduler
+   * \param buffers the UEs, in the order of the active UE list, with the bytes to serve
+   * \return the RBGs assigned to the UEs 1 to 3 (index 0 unused)
+   */
+  template <class T>
+  std::vector<uint32_t> AssignUl (const Ptr<NrDeadlineTestScheduler<T>> &sched,
+                                  const UeBuffers &buffers);
+
+  /**
+   * \brief Check the RBGs of a slot
+   * \param rbgs the RBGs assigned to each UE, as returned by AssignDl or AssignUl
+   * \param expected the RBGs expected for the UEs 1 to 3
+   * \param what description of the check
+   */
+  void CheckRbgs (const std::vector<uint32_t> &rbgs, const std::vector<uint32_t> &expected,
+                  const std::string &what);
+
+  static const uint32_t RBGS = 10;     //!< Bandwidth in RBG
+  static const uint8_t SYMBOLS = 12;   //!< Symbols available for data
+  static const uint32_t BIG = 100000;  //!< A buffer that needs all the RBGs
+  static const BeamConfId BEAM;        //!< The beam of all the UEs
+
+  NrDeadlineTestCschedSapUser m_cschedSapUser; //!< CSCHED SAP user
+  NrDeadlineTestSchedSapUser m_schedSapUser;   //!< SCHED SAP user
+};
+
+const BeamConfId NrSchedDeadlineTestCase::BEAM = BeamConfId (BeamId (8, 120.0), BeamId::GetEmptyBeamId ());
+
+void
+NrSchedDeadlineTestCase::Configure (const Ptr<NrMacSchedulerNs3> &sched)
+{
+  sched->SetMacCschedSapUser (&m_cschedSapUser);
+  sched->SetMacSchedSapUser (&m_schedSapUser);
+  sched->SetAttribute ("StartingMcsDl", UintegerValue (10));
+  sched->SetAttribute ("StartingMcsUl", UintegerValue (10));
+  sched->InstallDlAmc (CreateObject<NrAmc> ());
+  sched->InstallUlAmc (CreateObject<NrAmc> ());
+
+  NrMacCschedSapProvider::CschedCellConfigReqParameters cell;
+  cell.m_dlBandwidth = RBGS;
+  cell.m_ulBandwidth = RBGS;
+  sched->DoCschedCellConfigReq (cell);
+
+  for (uint16_t rnti = 1; rnti <= 3; ++rnti)
+    {
+      NrMacCschedSapProvider::CschedUeConfigReqParameters ue;
+      ue.m_rnti = rnti;
+      ue.m_beamConfId = BEAM;
+      sched->DoCschedUeConfigReq (ue);
+
+      NrMacCschedSapProvider::CschedLcConfigReqParameters lcs;
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 4;
+      lc.m_logicalChannelGroup = 1;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = EpsBearer::NGBR_VIDEO_TCP_DEFAULT;
+      lcs.m_rnti = rnti;
+      lcs.m_reconfigureFlag = false;
+      lcs.m_logicalChannelConfigList.emplace_back (lc);
+      sched->DoCschedLcConfigReq (lcs);
+    }
+}
+
+void
+NrSchedDeadlineTestCase::DlBuffer (const Ptr<NrMacSchedulerNs3> &sched, uint16_t rnti,
+                                   uint32_t bytes, uint16_t holDelayMs)
+{
+  NrMacSchedSapProvider::SchedDlRlcBufferReqParameters params;
+  params.m_rnti = rnti;
+  params.m_logicalChannelIdentity = 4;
+  params.m_rlcTransmissionQueueSize = bytes;
+  params.m_rlcTransmissionQueueHolDelay = holDelayMs;
+  params.m_rlcRetransmissionQueueSize = 0;
+  params.m_rlcRetransmissionHolDelay = 0;
+  params.m_rlcStatusPduSize = 0;
+  sched->DoSchedDlRlcBufferReq (params);
+}
+
+template <class T>
+std::vector<uint32_t>
+NrSchedDeadlineTestCase::AssignDl (const Ptr<NrDeadlineTestScheduler<T>> &sched,
+                                   const UeBuffers &buffers)
+{
+  NrMacSchedulerNs3::ActiveUeMap active;
+  for (const auto &buffer : buffers)
+    {
+      auto ue = sched->GetUeInfo (buffer.first);
+      ue->ResetDlSchedInfo ();
+      active[BEAM].emplace_back (ue, buffer.second);
+    }
+  sched->AssignDLRBG (SYMBOLS, active);
+
+  std::vector<uint32_t> rbgs (4, 0);
+  for (const auto &buffer : buffers)
+    {
+      rbgs.at (buffer.first) = sched->GetUeInfo (buffer.first)->m_dlRBG / SYMBOLS;
+    }
+  return rbgs;
+}
+
+template <class T>
+std::vector<uint32_t>
+NrSchedDeadlineTestCase::AssignUl (const Ptr<NrDeadlineTestScheduler<T>> &sched,
+                                   const UeBuffers &buffers)
+{
+  NrMacSchedulerNs3::ActiveUeMap active;
+  for (const auto &buffer : buffers)
+    {
+      auto ue = sched->GetUeInfo (buffer.first);
+      ue->ResetUlSchedInfo ();
+      active[BEAM].emplace_back (ue, buffer.second);
+    }
+  sched->AssignULRBG (SYMBOLS, active);
+
+  std::vector<uint32_t> rbgs (4, 0);
+  for (const auto &buffer : buffers)
+    {
+      rbgs.at (buffer.first) = sched->GetUeInfo (buffer.first)->m_ulRBG / SYMBOLS;
+    }
+  return rbgs;
+}
+
+void
+NrSchedDeadlineTestCase::CheckRbgs (const std::vector<uint32_t> &rbgs,
+                                    const std::vector<uint32_t> &expected,
+                                    const std::string &what)
+{
+  for (uint16_t rnti = 1; rnti <= 3; ++rnti)
+    {
+      NS_TEST_ASSERT_MSG_EQ (rbgs.at (rnti), expected.at (rnti - 1),
+                             what << ": wrong RBGs for UE " << rnti);
+    }
+}
+
+void
+NrSchedDeadlineTestCase::DoRun ()
+{
+  // DL EDF: the deadline of each UE is the generation time of its oldest
+  // data (now minus the HOL delay) plus DlDelayBudget
+  auto edf = CreateObject<NrDeadlineTestScheduler<NrMacSchedulerOfdmaEdf>> ();
+  Configure (edf);
+  DlBuffer (edf, 1, BIG, 2);
+  DlBuffer (edf, 2, BIG, 8);
+  DlBuffer (edf, 3, BIG, 5);
+  CheckRbgs (AssignDl (edf, {{1, BIG}, {2, BIG}, {3, BIG}}), {0, RBGS, 0},
+             "EDF, all the buffers need the full bandwidth");
+
+  // One RBG covers the small buffer of the UE 2: the rest goes to the UE 3,
+  // the next deadline, and nothing to the UE 1
+  CheckRbgs (AssignDl (edf, {{1, BIG}, {2, 10}, {3, BIG}}), {0, 1, RBGS - 1},
+             "EDF, the first buffer is covered by one RBG");
+
+  // With the same deadline, the UEs are served in RNTI order
+  DlBuffer (edf, 1, BIG, 5);
+  DlBuffer (edf, 2, 0, 0);
+  CheckRbgs (AssignDl (edf, {{1, 10}, {3, BIG}}), {1, 0, RBGS - 1},
+             "EDF, same deadline");
+  CheckRbgs (AssignDl (edf, {{3, BIG}, {1, 10}}), {1, 0, RBGS - 1},
+             "EDF, same deadline, UEs in reverse order");
+
+  // The same state for EDF and AoI: the data of the UE 1 has been generated
+  // before the one of the UE 2, but the last data of the UE 2 that has been
+  // delivered is much older. The AoI priority is lastDelivered - arrival.
+  auto aoi = CreateObject<NrDeadlineTestScheduler<NrMacSchedulerOfdmaAoI>> ();
+  Configure (aoi);
+  for (const Ptr<NrMacSchedulerNs3> &sched : {Ptr<NrMacSchedulerNs3> (edf), Ptr<NrMacSchedulerNs3> (aoi)})
+    {
+      DlBuffer (sched, 1, BIG, 8);
+      DlBuffer (sched, 2, BIG, 3);
+      DlBuffer (sched, 3, 0, 0);
+    }
+  auto setLastDelivered = [] (const std::shared_ptr<NrMacSchedulerUeInfo> &ue, const Time &delivered)
+    {
+      std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (ue)->m_dlLastDelivered = delivered;
+    };
+  for (const auto &ue : {edf->GetUeInfo (1), aoi->GetUeInfo (1)})
+    {
+      setLastDelivered (ue, MilliSeconds (-9));
+    }
+  for (const auto &ue : {edf->GetUeInfo (2), aoi->GetUeInfo (2)})
+    {
+      setLastDelivered (ue, MilliSeconds (-20));
+    }
+  CheckRbgs (AssignDl (edf, {{1, BIG}, {2, BIG}}), {RBGS, 0, 0},
+             "EDF serves the earliest deadline");
+  CheckRbgs (AssignDl (aoi, {{1, BIG}, {2, BIG}}), {0, RBGS, 0},
+             "AoI serves the oldest information");
+
+  // Scheduling the UE moves its last delivered data to the one scheduled
+  auto aoiUe2 = std::dynamic_pointer_cast<NrMacSchedulerUeInfoEdf> (aoi->GetUeInfo (2));
+  NS_TEST_ASSERT_MSG_EQ (aoiUe2->m_dlLastDelivered, aoiUe2->m_dlArrival,
+                         "AoI did not record the delivery of the data of UE 2");
+  CheckRbgs (AssignDl (aoi, {{1, BIG}, {2, BIG}}), {RBGS, 0, 0},
+             "AoI, after the delivery of the data of UE 2");
+
+  // UL EDF: the BSRs arrive at the same time, so the deadlines are the same
+  // and the UEs are served in RNTI order; then, the UE 2 signals with a CGR
+  // data generated 1 ms ago with a budget of 2 ms, earlier than the default
+  // UlDelayBudget of the UE 1
+  auto ulEdf = CreateObject<NrDeadlineTestScheduler<NrMacSchedulerOfdmaEdf>> ();
+  Configure (ulEdf);
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (ulEdf->GetScheduler ()), 1, "The UL heap needs the 5GL-OFDMA access mode");
+  NrMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrs;
+  for (uint16_t rnti : {1, 2})
+    {
+      MacCeElement bsr;
+      bsr.m_rnti = rnti;
+      bsr.m_macCeType = MacCeElement::BSR;
+      bsr.m_macCeValue.m_bufferStatus.resize (4, 0);
+      bsr.m_macCeValue.m_bufferStatus.at (1) = NrMacShortBsrCe::FromBytesToLevel (BIG);
+      bsrs.m_macCeList.push_back (bsr);
+    }
+  ulEdf->DoSchedUlMacCtrlInfoReq (bsrs);
+  CheckRbgs (AssignUl (ulEdf, {{2, BIG}, {1, BIG}}), {RBGS, 0, 0},
+             "UL EDF, same deadline");
+
+  NrMacSchedSapProvider::SchedUlCgrInfoReqParameters cgr;
+  cgr.m_srList = {2};
+  cgr.m_bufCgr = {BIG};
+  cgr.lcid = 4;
+  cgr.m_TraffPCgr = {1};
+  cgr.m_TraffInitCgr = {MilliSeconds (-1)};
+  cgr.m_TraffDeadlineCgr = {MilliSeconds (2)};
+  ulEdf->DoSchedUlCgrInfoReq (cgr);
+  // The UE 2 had data already: its generation time is kept, only the
+  // budget changes (0 + 2 ms against 0 + 10 ms)
+  CheckRbgs (AssignUl (ulEdf, {{1, BIG}, {2, BIG}}), {0, RBGS, 0},
+             "UL EDF, deadline signaled with a CGR");
+}
+
+/**
+ * \ingroup test
+ * \brief Test suite for the order of the deadline-aware schedulers
+ */
+class NrTestSchedDeadlineSuite : public TestSuite
+{
+public:
+  NrTestSchedDeadlineSuite () : TestSuite ("nr-test-sched-deadline", UNIT)
+  {
+    AddTestCase (new NrSchedDeadlineTestCase (), QUICK);
+  }
+};
+
+static NrTestSchedDeadlineSuite g_nrTestSchedDeadlineSuite; //!< EDF and AoI order test suite
+
+}  // namespace ns3
@@ -0,0 +1,121 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/core-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/nr-module.h>
+#include <ns3/nr-spectrum-transmit-filter.h>
+
+/**
+ * \file nr-test-spectrum-transmit-filter.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrSpectrumTransmitFilter. The test deploys two gNBs
+ * and two UEs with NrHelper, checks that the channel created by the helper
+ * has the filter, and that the filter skips only the UE to UE links, or no
+ * link when the attribute UeUeInterference is true.
+ */
+namespace ns3 {
+
+/**
+ * \brief Test the links skipped by NrSpectrumTransmitFilter
+ */
+class NrSpectrumTransmitFilterTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  NrSpectrumTransmitFilterTestCase ()
+    : TestCase ("NR spectrum transmit filter")
+  {}
+
+private:
+  virtual void DoRun (void) override;
+};
+
+void
+NrSpectrumTransmitFilterTestCase::DoRun ()
+{
+  NodeContainer gnbNodes;
+  NodeContainer ueNodes;
+  gnbNodes.Create (2);
+  ueNodes.Create (2);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (gnbNodes);
+  mobility.Install (ueNodes);
+
+  Ptr<NrHelper> nrHelper = CreateObject<NrHelper> ();
+  CcBwpCreator::SimpleOperationBandConf bandConf (28e9, 20e6, 1, BandwidthPartInfo::UMi_StreetCanyon);
+  CcBwpCreator ccBwpCreator;
+  OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc (bandConf);
+  nrHelper->InitializeOperationBand (&band);
+  BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps ({band});
+
+  NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice (gnbNodes, allBwps);
+  NetDeviceContainer ueDevs = nrHelper->InstallUeDevice (ueNodes, allBwps);
+
+  Ptr<NrSpectrumPhy> gnb0 = nrHelper->GetGnbPhy (gnbDevs.Get (0), 0)->GetSpectrumPhy ();
+  Ptr<NrSpectrumPhy> gnb1 = nrHelper->GetGnbPhy (gnbDevs.Get (1), 0)->GetSpectrumPhy ();
+  Ptr<NrSpectrumPhy> ue0 = nrHelper->GetUePhy (ueDevs.Get (0), 0)->GetSpectrumPhy ();
+  Ptr<NrSpectrumPhy> ue1 = nrHelper->GetUePhy (ueDevs.Get (1), 0)->GetSpectrumPhy ();
+
+  Ptr<SpectrumTransmitFilter> filter = gnb0->GetSpectrumChannel ()->GetSpectrumTransmitFilter ();
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<NrSpectrumTransmitFilter> (filter), nullptr,
+                         "NrHelper did not install the filter on the channel");
+
+  auto skipped = [&filter] (Ptr<NrSpectrumPhy> tx, Ptr<NrSpectrumPhy> rx)
+    {
+      Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+      params->txPhy = tx;
+      return filter->Filter (params, rx);
+    };
+
+  NS_TEST_ASSERT_MSG_EQ (skipped (ue0, ue1), true, "UE to UE link not skipped");
+  NS_TEST_ASSERT_MSG_EQ (skipped (ue1, ue0), true, "UE to UE link not skipped");
+  NS_TEST_ASSERT_MSG_EQ (skipped (ue0, gnb0), false, "UE to gNB link skipped");
+  NS_TEST_ASSERT_MSG_EQ (skipped (ue1, gnb0), false, "UE to neighbour gNB link skipped");
+  NS_TEST_ASSERT_MSG_EQ (skipped (gnb0, ue0), false, "gNB to UE link skipped");
+  NS_TEST_ASSERT_MSG_EQ (skipped (gnb1, ue0), false, "Neighbour gNB to UE link skipped");
+  NS_TEST_ASSERT_MSG_EQ (skipped (gnb0, gnb1), false, "gNB to gNB link skipped");
+
+  filter->SetAttribute ("UeUeInterference", BooleanValue (true));
+  NS_TEST_ASSERT_MSG_EQ (skipped (ue0, ue1), false, "UE to UE link skipped with UeUeInterference");
+  NS_TEST_ASSERT_MSG_EQ (skipped (gnb0, ue0), false, "gNB to UE link skipped with UeUeInterference");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test suite for NrSpectrumTransmitFilter
+ */
+class NrTestSpectrumTransmitFilter : public TestSuite
+{
+public:
+  NrTestSpectrumTransmitFilter () : TestSuite ("nr-test-spectrum-transmit-filter", UNIT)
+  {
+    AddTestCase (new NrSpectrumTransmitFilterTestCase (), QUICK);
+  }
+};
+
+static NrTestSpectrumTransmitFilter g_nrTestSpectrumTransmitFilter; //!< Spectrum transmit filter test suite
+
+}  // namespace ns3
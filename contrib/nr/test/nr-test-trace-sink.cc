@@ -0,0 +1,163 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/nr-trace-sink.h>
+#include <fstream>
+#include <sstream>
+
+/**
+ * \file nr-test-trace-sink.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrTraceSink. The test writes the same records, with
+ * two layouts, in the three formats of the sink, and checks that the text
+ * files, and the text converted from the binary file, are equal to the text
+ * that the trace helpers wrote before the sinks. It also checks that a
+ * sink opened in append mode keeps the records already in the file, and that
+ * the binary records keep strings of any length.
+ */
+namespace ns3 {
+
+/**
+ * \brief Test the text and binary formats of NrTraceSink
+ */
+class NrTraceSinkTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param append true to test the append mode
+   */
+  NrTraceSinkTestCase (bool append)
+    : TestCase (append ? "Trace sink formats, append mode" : "Trace sink formats"),
+      m_append (append)
+  {}
+
+private:
+  virtual void DoRun (void) override;
+  /**
+   * \brief Write the test records
+   * \param fileName the name of the text file
+   * \param format the format of the file
+   * \return the name of the file written
+   */
+  std::string WriteRecords (const std::string &fileName, NrTraceSink::Format format) const;
+  /**
+   * \brief Read a file
+   * \param fileName the file name
+   * \return the content of the file
+   */
+  static std::string ReadFile (const std::string &fileName);
+
+  bool m_append {false}; //!< Test the append mode
+};
+
+/// First layout of the test records
+static const NrTraceSink::Layout g_packetLayout {{{"Time", NrTraceSink::DOUBLE},
+                                                  {"direction", NrTraceSink::STRING},
+                                                  {"frame", NrTraceSink::UINT},
+                                                  {"offset", NrTraceSink::INT},
+                                                  {"SINR(dB)", NrTraceSink::DOUBLE}}};
+
+/// Second layout of the test records, with custom separators
+static const NrTraceSink::Layout g_perRbLayout {{{"RB", NrTraceSink::UINT},
+                                                 {"Value(dB)", NrTraceSink::FIXED}},
+                                                " \t ", "\t "};
+
+std::string
+NrTraceSinkTestCase::WriteRecords (const std::string &fileName, NrTraceSink::Format format) const
+{
+  Ptr<NrTraceSink> sink = NrTraceSink::Open (fileName, m_append ? "" : "Time\tdirection\tframe\toffset\tSINR(dB)",
+                                             format, 4096, m_append);
+  sink->Write (g_packetLayout, 0.0012345678, "DL", static_cast<uint16_t> (1023), -3, 12.3456789);
+  sink->Write (g_perRbLayout, static_cast<uint8_t> (7), -1.5);
+  sink->Write (g_packetLayout, 1e-9, std::string ("UL"), 0u, static_cast<int64_t> (-1) << 40, -120);
+  sink->Write (g_perRbLayout, 273, 30.0000004);
+  sink->Write (g_packetLayout, 2.5, std::string ("UL_CG_LONGER_THAN_16_CHARACTERS"), 1u, 0, 0.0);
+  sink->Write (g_packetLayout, 3.0, "", 2u, 1, 1.0);
+  return sink->GetFileName ();
+}
+
+std::string
+NrTraceSinkTestCase::ReadFile (const std::string &fileName)
+{
+  std::ifstream in (fileName, std::ios_base::binary);
+  std::stringstream ss;
+  ss << in.rdbuf ();
+  return ss.str ();
+}
+
+void
+NrTraceSinkTestCase::DoRun ()
+{
+  std::string expected = "0.00123457\tDL\t1023\t-3\t12.3457\n"
+                         "7 \t -1.500000\t \n"
+                         "1e-09\tUL\t0\t-1099511627776\t-120\n"
+                         "273 \t 30.000000\t \n"
+                         "2.5\tUL_CG_LONGER_THAN_16_CHARACTERS\t1\t0\t0\n"
+                         "3\t\t2\t1\t1\n";
+  if (m_append)
+    {
+      // the records are written twice, in the same file
+      expected += expected;
+    }
+  else
+    {
+      expected = "Time\tdirection\tframe\toffset\tSINR(dB)\n" + expected;
+    }
+
+  for (auto format : {NrTraceSink::FLUSHED_TEXT, NrTraceSink::BUFFERED_TEXT, NrTraceSink::BINARY})
+    {
+      std::string fileName = CreateTempDirFilename ("trace-" + std::to_string (format) + ".txt");
+      std::string written = WriteRecords (fileName, format);
+      if (m_append)
+        {
+          WriteRecords (fileName, format);
+        }
+
+      std::string text = ReadFile (written);
+      if (format == NrTraceSink::BINARY)
+        {
+          NS_TEST_ASSERT_MSG_EQ (written, CreateTempDirFilename ("trace-2.bin"), "Wrong binary file name");
+          std::ifstream in (written, std::ios_base::binary);
+          std::ostringstream out;
+          NS_TEST_ASSERT_MSG_EQ (NrTraceSink::ConvertToText (in, out), true, "Invalid binary trace");
+          text = out.str ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (text, expected, "Wrong text for format " << format);
+      std::remove (written.c_str ());
+    }
+}
+
+/**
+ * \brief Test suite for NrTraceSink
+ */
+class NrTestTraceSink : public TestSuite
+{
+public:
+  NrTestTraceSink () : TestSuite ("nr-test-trace-sink", UNIT)
+  {
+    AddTestCase (new NrTraceSinkTestCase (false), QUICK);
+    AddTestCase (new NrTraceSinkTestCase (true), QUICK);
+  }
+};
+
+static NrTestTraceSink g_nrTestTraceSink; //!< Trace sink test suite
+
+}  // namespace ns3
@@ -0,0 +1,393 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/nr-module.h"
+#include "ns3/antenna-module.h"
+#include <set>
+#include <tuple>
+
+/**
+ * \file nr-test-ue-idle-slots.cc
+ * \ingroup test
+ *
+ * \brief Test the event-driven slots of NrUePhy (attribute EventDrivenSlots).
+ *
+ * The same scenario, a gNB with two UEs with sparse DL and UL UDP traffic,
+ * is run with the per-slot loop and with the event-driven slots. The test
+ * checks that:
+ *
+ * - the receptions are the same: the TBs received by the UEs and by the gNB
+ *   (slot, symbols, size, SINR), and the packets received by the
+ *   applications (time and size). A DCI received while idle, or new data in
+ *   the MAC buffers, has then resumed the right slot;
+ * - the event-driven UEs process a subset of the slots of the per-slot UEs,
+ *   in order, and far fewer of them; the number of simulator events drops;
+ * - with the configured grant (CG) enabled, the event-driven UEs wake up for
+ *   every CG occasion, even without a DCI for that slot.
+ */
+
+namespace ns3 {
+
+/**
+ * \brief Compare a scenario with and without the event-driven UE slots
+ */
+class NrUeIdleSlotsTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param numerology the numerology of the BWP
+   */
+  NrUeIdleSlotsTestCase (uint16_t numerology)
+    : TestCase ("Event-driven UE slots with numerology " + std::to_string (numerology)),
+      m_numerology (numerology)
+  {}
+
+private:
+  virtual void DoRun (void) override;
+
+  /// A received TB: RNTI, slot, first symbol, number of symbols, size, SINR
+  typedef std::tuple<uint16_t, uint64_t, uint8_t, uint8_t, uint32_t, double> RxTb;
+  /// A received packet: node, time, size
+  typedef std::tuple<uint32_t, Time, uint32_t> RxPacket;
+
+  /**
+   * \brief What is observed in a run
+   */
+  struct Result
+  {
+    std::vector<RxTb> m_ueRxTbs;        //!< TBs received by the UEs
+    std::vector<RxTb> m_gnbRxTbs;       //!< TBs received by the gNB
+    std::vector<RxPacket> m_rxPackets;  //!< Packets received by the applications
+    std::map<uint32_t, std::vector<std::pair<uint64_t, bool>>> m_slots; //!< Slots processed, per UE
+    std::map<uint32_t, std::vector<uint64_t>> m_cgOccasions; //!< CG occasions from the first processed slot, per UE
+    uint64_t m_events {0};              //!< Simulator events
+  };
+
+  /**
+   * \brief Run the scenario
+   * \param eventDriven the value of NrUePhy::EventDrivenSlots
+   * \return what is observed
+   */
+  Result Run (bool eventDriven) const;
+
+  /**
+   * \brief Record a received TB
+   * \param tbs the TBs
+   * \param path the trace path
+   * \param params the reception
+   */
+  static void RxTbTrace (std::vector<RxTb> *tbs, std::string path, RxPacketTraceParams params);
+  /**
+   * \brief Record a received packet
+   * \param packets the packets
+   * \param node the receiving node
+   * \param p the packet
+   */
+  static void RxPacketTrace (std::vector<RxPacket> *packets, uint32_t node, Ptr<const Packet> p);
+  /**
+   * \brief Record a processed slot
+   * \param slots the slots
+   * \param sfn the slot
+   * \param resumed true if the slot is resumed in the middle
+   */
+  static void SlotStartTrace (std::vector<std::pair<uint64_t, bool>> *slots, const SfnSf &sfn, bool resumed);
+
+  uint16_t m_numerology {0}; //!< Numerology
+};
+
+void
+NrUeIdleSlotsTestCase::RxTbTrace (std::vector<RxTb> *tbs, std::string path, RxPacketTraceParams params)
+{
+  tbs->emplace_back (params.m_rnti, (static_cast<uint64_t> (params.m_frameNum) << 16)
+                     | (params.m_subframeNum << 8) | params.m_slotNum,
+                     params.m_symStart, params.m_numSym, params.m_tbSize, params.m_sinr);
+}
+
+void
+NrUeIdleSlotsTestCase::RxPacketTrace (std::vector<RxPacket> *packets, uint32_t node, Ptr<const Packet> p)
+{
+  packets->emplace_back (node, Simulator::Now (), p->GetSize ());
+}
+
+void
+NrUeIdleSlotsTestCase::SlotStartTrace (std::vector<std::pair<uint64_t, bool>> *slots, const SfnSf &sfn, bool resumed)
+{
+  slots->emplace_back (sfn.Normalize (), resumed);
+}
+
+NrUeIdleSlotsTestCase::Result
+NrUeIdleSlotsTestCase::Run (bool eventDriven) const
+{
+  Result result;
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Config::SetDefault ("ns3::NrUePhy::EventDrivenSlots", BooleanValue (eventDriven));
+  Config::SetDefault ("ns3::NrUeMac::CG", BooleanValue (true));
+  Config::SetDefault ("ns3::NrUePhy::CG", BooleanValue (true));
+
+  NodeContainer gnbNodes;
+  NodeContainer ueNodes;
+  gnbNodes.Create (1);
+  ueNodes.Create (2);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (gnbNodes);
+  mobility.Install (ueNodes);
+  gnbNodes.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (0.0, 0.0, 10.0));
+  ueNodes.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (0.0, 10.0, 1.5));
+  ueNodes.Get (1)->GetObject<MobilityModel> ()->SetPosition (Vector (10.0, 0.0, 1.5));
+
+  Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper> ();
+  Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper> ();
+  Ptr<NrHelper> nrHelper = CreateObject<NrHelper> ();
+  idealBeamformingHelper->SetAttribute ("BeamformingMethod", TypeIdValue (DirectPathBeamforming::GetTypeId ()));
+  nrHelper->SetBeamformingHelper (idealBeamformingHelper);
+  nrHelper->SetEpcHelper (epcHelper);
+
+  CcBwpCreator ccBwpCreator;
+  CcBwpCreator::SimpleOperationBandConf bandConf (28e9, 100e6, 1, BandwidthPartInfo::UMi_StreetCanyon);
+  OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc (bandConf);
+
+  Config::SetDefault ("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue (MilliSeconds (0)));
+  nrHelper->SetChannelConditionModelAttribute ("UpdatePeriod", TimeValue (MilliSeconds (0)));
+  nrHelper->SetPathlossAttribute ("ShadowingEnabled", BooleanValue (false));
+  nrHelper->InitializeOperationBand (&band);
+  BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps ({band});
+
+  nrHelper->SetGnbPhyAttribute ("Numerology", UintegerValue (m_numerology));
+  nrHelper->SetUeAntennaAttribute ("NumRows", UintegerValue (1));
+  nrHelper->SetUeAntennaAttribute ("NumColumns", UintegerValue (1));
+  nrHelper->SetGnbAntennaAttribute ("NumRows", UintegerValue (2));
+  nrHelper->SetGnbAntennaAttribute ("NumColumns", UintegerValue (2));
+
+  NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice (gnbNodes, allBwps);
+  NetDeviceContainer ueDevs = nrHelper->InstallUeDevice (ueNodes, allBwps);
+  nrHelper->AssignStreams (gnbDevs, 1);
+  nrHelper->AssignStreams (ueDevs, 1);
+
+  for (auto it = gnbDevs.Begin (); it != gnbDevs.End (); ++it)
+    {
+      DynamicCast<NrGnbNetDevice> (*it)->UpdateConfig ();
+    }
+  for (auto it = ueDevs.Begin (); it != ueDevs.End (); ++it)
+    {
+      DynamicCast<NrUeNetDevice> (*it)->UpdateConfig ();
+    }
+
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (2500));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign (internetDevices);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+  internet.Install (ueNodes);
+  Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (ueDevs);
+  for (uint32_t i = 0; i < ueNodes.GetN (); ++i)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ueNodes.Get (i)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+  nrHelper->AttachToClosestEnb (ueDevs, gnbDevs);
+
+  // Sparse traffic: the UEs are idle most of the time
+  ApplicationContainer serverApps;
+  ApplicationContainer clientApps;
+  const uint16_t dlPort = 1234;
+  const uint16_t ulPort = 2000;
+  for (uint32_t i = 0; i < ueNodes.GetN (); ++i)
+    {
+      UdpServerHelper dlServer (dlPort);
+      serverApps.Add (dlServer.Install (ueNodes.Get (i)));
+      UdpClientHelper dlClient (ueIpIface.GetAddress (i), dlPort);
+      dlClient.SetAttribute ("Interval", TimeValue (MilliSeconds (17 + 6 * i)));
+      dlClient.SetAttribute ("MaxPackets", UintegerValue (0xFFFFFFFF));
+      dlClient.SetAttribute ("PacketSize", UintegerValue (300));
+      clientApps.Add (dlClient.Install (remoteHost));
+
+      UdpServerHelper ulServer (ulPort + i);
+      serverApps.Add (ulServer.Install (remoteHost));
+      UdpClientHelper ulClient (internetIpIfaces.GetAddress (1), ulPort + i);
+      ulClient.SetAttribute ("Interval", TimeValue (MilliSeconds (29 + 10 * i)));
+      ulClient.SetAttribute ("MaxPackets", UintegerValue (0xFFFFFFFF));
+      ulClient.SetAttribute ("PacketSize", UintegerValue (100));
+      clientApps.Add (ulClient.Install (ueNodes.Get (i)));
+    }
+  serverApps.Start (MilliSeconds (300));
+  clientApps.Start (MilliSeconds (400));
+  clientApps.Stop (MilliSeconds (700));
+
+  for (uint32_t i = 0; i < serverApps.GetN (); ++i)
+    {
+      Ptr<Application> app = serverApps.Get (i);
+      app->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&RxPacketTrace, &result.m_rxPackets,
+                                                                app->GetNode ()->GetId ()));
+    }
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMapUe/*/NrUePhy/NrSpectrumPhyList/*/RxPacketTraceUe",
+                   MakeBoundCallback (&RxTbTrace, &result.m_ueRxTbs));
+  Config::Connect ("/NodeList/*/DeviceList/*/BandwidthPartMap/*/NrGnbPhy/NrSpectrumPhyList/*/RxPacketTraceEnb",
+                   MakeBoundCallback (&RxTbTrace, &result.m_gnbRxTbs));
+  for (uint32_t i = 0; i < ueDevs.GetN (); ++i)
+    {
+      nrHelper->GetUePhy (ueDevs.Get (i), 0)->TraceConnectWithoutContext ("SlotStart",
+                                                                          MakeBoundCallback (&SlotStartTrace, &result.m_slots[i]));
+    }
+
+  Simulator::Stop (MilliSeconds (800));
+  Simulator::Run ();
+  result.m_events = Simulator::GetEventCount ();
+
+  for (uint32_t i = 0; i < ueDevs.GetN (); ++i)
+    {
+      const auto & slots = result.m_slots[i];
+      if (slots.empty ())
+        {
+          continue;
+        }
+      // Collect some occasions beyond the last processed slot: the event-driven
+      // UE could have slept through the last ones
+      NrUePhySapUser *phySapUser = nrHelper->GetUeMac (ueDevs.Get (i), 0)->GetPhySapUser ();
+      uint64_t occasion = slots.front ().first - 1;
+      while (phySapUser->GetNextCgOccasion (occasion, &occasion) && occasion <= slots.back ().first + 1000)
+        {
+          result.m_cgOccasions[i].push_back (occasion);
+        }
+    }
+  Simulator::Destroy ();
+
+  Config::Reset ();
+  return result;
+}
+
+void
+NrUeIdleSlotsTestCase::DoRun ()
+{
+  Result perSlot = Run (false);
+  Result eventDriven = Run (true);
+
+  NS_TEST_ASSERT_MSG_GT (perSlot.m_ueRxTbs.size (), 0, "No TB received by the UEs");
+  NS_TEST_ASSERT_MSG_GT (perSlot.m_gnbRxTbs.size (), 0, "No TB received by the gNB");
+  NS_TEST_ASSERT_MSG_GT (perSlot.m_rxPackets.size (), 0, "No packet received");
+
+  NS_TEST_ASSERT_MSG_EQ (eventDriven.m_ueRxTbs.size (), perSlot.m_ueRxTbs.size (), "Different number of TBs received by the UEs");
+  NS_TEST_EXPECT_MSG_EQ ((eventDriven.m_ueRxTbs == perSlot.m_ueRxTbs), true, "Different TBs received by the UEs");
+  NS_TEST_ASSERT_MSG_EQ (eventDriven.m_gnbRxTbs.size (), perSlot.m_gnbRxTbs.size (), "Different number of TBs received by the gNB");
+  NS_TEST_EXPECT_MSG_EQ ((eventDriven.m_gnbRxTbs == perSlot.m_gnbRxTbs), true, "Different TBs received by the gNB");
+  NS_TEST_ASSERT_MSG_EQ (eventDriven.m_rxPackets.size (), perSlot.m_rxPackets.size (), "Different number of packets received");
+  NS_TEST_EXPECT_MSG_EQ ((eventDriven.m_rxPackets == perSlot.m_rxPackets), true, "Different packets received");
+
+  for (const auto & ue : perSlot.m_slots)
+    {
+      const auto & all = ue.second;
+      const auto & processed = eventDriven.m_slots[ue.first];
+      NS_TEST_ASSERT_MSG_GT (processed.size (), 0, "UE " << ue.first << " never processed a slot");
+
+      // The per-slot UE processes every slot, from its start
+      for (std::size_t i = 1; i < all.size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (all.at (i).first, all.at (i - 1).first + 1, "Slot skipped by the per-slot UE " << ue.first);
+          NS_TEST_ASSERT_MSG_EQ (all.at (i).second, false, "Slot resumed by the per-slot UE " << ue.first);
+        }
+
+      // The event-driven UE processes, in order, some of the same slots
+      for (std::size_t i = 1; i < processed.size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_GT (processed.at (i).first, processed.at (i - 1).first,
+                                 "Slots out of order for the event-driven UE " << ue.first);
+        }
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (processed.front ().first, all.front ().first, "Slot before the first one for UE " << ue.first);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (processed.back ().first, all.back ().first, "Slot after the last one for UE " << ue.first);
+
+      // The event-driven UE wakes up for every CG occasion in the slots of the
+      // per-slot UE
+      std::vector<uint64_t> occasions;
+      std::vector<uint64_t> perSlotOccasions;
+      for (const auto & occasion : eventDriven.m_cgOccasions[ue.first])
+        {
+          if (occasion >= all.front ().first && occasion <= all.back ().first)
+            {
+              occasions.push_back (occasion);
+            }
+        }
+      for (const auto & occasion : perSlot.m_cgOccasions[ue.first])
+        {
+          if (occasion >= all.front ().first && occasion <= all.back ().first)
+            {
+              perSlotOccasions.push_back (occasion);
+            }
+        }
+      NS_TEST_ASSERT_MSG_GT (occasions.size (), 0, "No CG occasion for UE " << ue.first);
+      NS_TEST_EXPECT_MSG_EQ ((occasions == perSlotOccasions), true,
+                             "Different CG occasions for UE " << ue.first);
+      std::set<uint64_t> processedSlots;
+      for (const auto & slot : processed)
+        {
+          processedSlots.insert (slot.first);
+        }
+      for (const auto & occasion : occasions)
+        {
+          NS_TEST_ASSERT_MSG_EQ (processedSlots.count (occasion), 1,
+                                 "UE " << ue.first << " slept through the CG occasion in slot " << occasion);
+        }
+
+      // Most of the slots are skipped
+      NS_TEST_ASSERT_MSG_LT (processed.size () * 2, all.size (),
+                             "UE " << ue.first << " processed " << processed.size () << " slots out of " << all.size ());
+    }
+
+  NS_TEST_ASSERT_MSG_LT (eventDriven.m_events, perSlot.m_events, "The event-driven slots do not reduce the number of events");
+}
+
+/**
+ * \brief Test suite for the event-driven UE slots
+ */
+class NrTestUeIdleSlots : public TestSuite
+{
+public:
+  NrTestUeIdleSlots () : TestSuite ("nr-test-ue-idle-slots", SYSTEM)
+  {
+    AddTestCase (new NrUeIdleSlotsTestCase (0), QUICK);
+    AddTestCase (new NrUeIdleSlotsTestCase (2), QUICK);
+  }
+};
+
+static NrTestUeIdleSlots g_nrTestUeIdleSlots; //!< Event-driven UE slots test suite
+
+} // namespace ns3
@@ -96,5 +96,22 @@ DistanceBasedThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity
   return rxPsd;
 }
 
+PhasedArraySpectrumPropagationLossModel::RxPsdTask
+DistanceBasedThreeGppSpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                                                                    Ptr<const MobilityModel> a,
+                                                                                    Ptr<const MobilityModel> b,
+                                                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                                    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  NS_LOG_FUNCTION (this);
+  if (a->GetDistanceFrom (b) > m_maxDistance)
+    {
+      NS_LOG_LOGIC ("Distance between a and b is higher than max allowed distance. Return 0 PSD.");
+      *psd = 0.0;
+      return RxPsdTask ();
+    }
+  return ThreeGppSpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (psd, a, b, aPhasedArrayModel, bPhasedArrayModel);
+}
+
 
 }  // namespace ns3
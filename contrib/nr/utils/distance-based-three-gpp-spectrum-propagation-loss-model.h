@@ -84,6 +84,26 @@ public:
                                                            Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                            Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
 
+  /**
+   * \brief Computes the received PSD in two steps (see
+   * PhasedArraySpectrumPropagationLossModel::PrepareRxPowerSpectralDensity).
+   *
+   * If the distance between a and b is higher than allowed, the PSD is set
+   * to 0 and no task is returned.
+   *
+   * \param psd the tx PSD, replaced by the rx PSD
+   * \param a first node mobility model
+   * \param b second node mobility model
+   * \param aPhasedArrayModel the antenna array of the first node
+   * \param bPhasedArrayModel the antenna array of the second node
+   * \return the task that applies the beamforming gain
+   */
+  virtual RxPsdTask DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                                     Ptr<const MobilityModel> a,
+                                                     Ptr<const MobilityModel> b,
+                                                     Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                     Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
+
 private:
 
   double m_maxDistance {1000}; //!< the maximum distance of the nodes a and b in order to calcluate fast fading and the beamforming gain
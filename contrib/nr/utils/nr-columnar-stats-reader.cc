@@ -0,0 +1,208 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "nr-columnar-stats-reader.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NrColumnarStatsReader");
+
+NrColumnarStatsReader::NrColumnarStatsReader (const std::string &fileName)
+  : m_fileName (fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  m_file.open (m_fileName.c_str (), std::ios_base::in | std::ios_base::binary);
+  if (!m_file.is_open ())
+    {
+      NS_FATAL_ERROR ("Can't open file " << m_fileName);
+    }
+
+  char magic[sizeof (NrColumnarStats::MAGIC)];
+  uint32_t numColumns = 0;
+  m_file.read (magic, sizeof (magic));
+  m_file.read (reinterpret_cast<char *> (&numColumns), sizeof (numColumns));
+  NS_ABORT_MSG_IF (!m_file || std::memcmp (magic, NrColumnarStats::MAGIC, sizeof (magic)) != 0,
+                   m_fileName << " is not a columnar statistics file");
+
+  for (uint32_t i = 0; i < numColumns; ++i)
+    {
+      uint8_t type = 0;
+      uint8_t len = 0;
+      m_file.read (reinterpret_cast<char *> (&type), sizeof (type));
+      m_file.read (reinterpret_cast<char *> (&len), sizeof (len));
+      std::string name (len, '\0');
+      m_file.read (&name[0], len);
+      NS_ABORT_MSG_IF (!m_file || type > NrColumnarStats::DOUBLE,
+                       "Corrupted header in " << m_fileName);
+      m_columns.emplace_back (name, static_cast<NrColumnarStats::ColumnType> (type));
+    }
+  m_dataOffset = m_file.tellg ();
+}
+
+std::size_t
+NrColumnarStatsReader::GetNColumns () const
+{
+  return m_columns.size ();
+}
+
+const std::string &
+NrColumnarStatsReader::GetColumnName (std::size_t column) const
+{
+  NS_ASSERT (column < m_columns.size ());
+  return m_columns[column].first;
+}
+
+NrColumnarStats::ColumnType
+NrColumnarStatsReader::GetColumnType (std::size_t column) const
+{
+  NS_ASSERT (column < m_columns.size ());
+  return m_columns[column].second;
+}
+
+std::size_t
+NrColumnarStatsReader::GetColumnIndex (const std::string &name) const
+{
+  for (std::size_t i = 0; i < m_columns.size (); ++i)
+    {
+      if (m_columns[i].first == name)
+        {
+          return i;
+        }
+    }
+  NS_FATAL_ERROR ("No column " << name << " in " << m_fileName);
+  return 0;
+}
+
+uint64_t
+NrColumnarStatsReader::GetNRows ()
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t rows = 0;
+  m_file.clear ();
+  m_file.seekg (m_dataOffset);
+  uint32_t numRows;
+  while (m_file.read (reinterpret_cast<char *> (&numRows), sizeof (numRows)))
+    {
+      uint64_t dataSize = 0;
+      for (std::size_t i = 0; i < m_columns.size (); ++i)
+        {
+          uint8_t codec;
+          uint32_t size;
+          m_file.read (reinterpret_cast<char *> (&codec), sizeof (codec));
+          m_file.read (reinterpret_cast<char *> (&size), sizeof (size));
+          dataSize += size;
+        }
+      NS_ABORT_MSG_IF (!m_file, "Truncated chunk header in " << m_fileName);
+      m_file.seekg (static_cast<std::streamoff> (dataSize), std::ios_base::cur);
+      rows += numRows;
+    }
+  return rows;
+}
+
+std::vector<uint64_t>
+NrColumnarStatsReader::ReadRaw (std::size_t column)
+{
+  NS_LOG_FUNCTION (this << column);
+  std::vector<uint64_t> values;
+  std::vector<uint8_t> data;
+  std::vector<std::pair<uint8_t, uint32_t>> sizes (m_columns.size ());
+
+  m_file.clear ();
+  m_file.seekg (m_dataOffset);
+  uint32_t numRows;
+  while (m_file.read (reinterpret_cast<char *> (&numRows), sizeof (numRows)))
+    {
+      for (auto &s : sizes)
+        {
+          m_file.read (reinterpret_cast<char *> (&s.first), sizeof (s.first));
+          m_file.read (reinterpret_cast<char *> (&s.second), sizeof (s.second));
+        }
+      NS_ABORT_MSG_IF (!m_file, "Truncated chunk header in " << m_fileName);
+
+      uint64_t before = 0;
+      uint64_t after = 0;
+      for (std::size_t i = 0; i < sizes.size (); ++i)
+        {
+          if (i < column)
+            {
+              before += sizes[i].second;
+            }
+          else if (i > column)
+            {
+              after += sizes[i].second;
+            }
+        }
+
+      m_file.seekg (static_cast<std::streamoff> (before), std::ios_base::cur);
+      data.resize (sizes[column].second);
+      m_file.read (reinterpret_cast<char *> (data.data ()), static_cast<std::streamsize> (data.size ()));
+      NS_ABORT_MSG_IF (!m_file, "Truncated chunk in " << m_fileName);
+      bool ok = NrColumnarStats::DecodeColumn (m_columns[column].second,
+                                               static_cast<NrColumnarStats::Codec> (sizes[column].first),
+                                               data.data (), data.size (), numRows, &values);
+      NS_ABORT_MSG_IF (!ok, "Corrupted column " << m_columns[column].first << " in " << m_fileName);
+      m_file.seekg (static_cast<std::streamoff> (after), std::ios_base::cur);
+    }
+  return values;
+}
+
+std::vector<double>
+NrColumnarStatsReader::ReadColumn (const std::string &name)
+{
+  std::size_t column = GetColumnIndex (name);
+  std::vector<uint64_t> raw = ReadRaw (column);
+  std::vector<double> values (raw.size ());
+  for (std::size_t i = 0; i < raw.size (); ++i)
+    {
+      switch (m_columns[column].second)
+        {
+        case NrColumnarStats::UINT:
+          values[i] = static_cast<double> (raw[i]);
+          break;
+        case NrColumnarStats::INT:
+          values[i] = static_cast<double> (static_cast<int64_t> (raw[i]));
+          break;
+        default:
+          std::memcpy (&values[i], &raw[i], sizeof (double));
+        }
+    }
+  return values;
+}
+
+std::vector<uint64_t>
+NrColumnarStatsReader::ReadUintColumn (const std::string &name)
+{
+  std::size_t column = GetColumnIndex (name);
+  NS_ABORT_MSG_IF (m_columns[column].second != NrColumnarStats::UINT,
+                   "Column " << name << " is not an UINT column");
+  return ReadRaw (column);
+}
+
+std::vector<int64_t>
+NrColumnarStatsReader::ReadIntColumn (const std::string &name)
+{
+  std::size_t column = GetColumnIndex (name);
+  NS_ABORT_MSG_IF (m_columns[column].second != NrColumnarStats::INT,
+                   "Column " << name << " is not an INT column");
+  std::vector<uint64_t> raw = ReadRaw (column);
+  return std::vector<int64_t> (raw.begin (), raw.end ());
+}
+
+} // namespace ns3
@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef NR_COLUMNAR_STATS_READER_H
+#define NR_COLUMNAR_STATS_READER_H
+
+#include <ns3/nr-columnar-stats.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup utils
+ * \brief Reader of the columnar statistics files written by NrColumnarStatsWriter
+ *
+ * The constructor reads only the list of columns. A column is loaded by
+ * walking the chunk headers and reading, for each chunk, only the data of the
+ * requested column: the other columns are skipped without being read or
+ * decoded.
+ *
+ * \code
+ *   NrColumnarStatsReader reader ("NrDlRxRlcStats.ncol");
+ *   std::vector<double> delay = reader.ReadColumn ("delay(s)");
+ * \endcode
+ */
+class NrColumnarStatsReader
+{
+public:
+  /**
+   * \brief Open a file and read its columns
+   * \param fileName the file name
+   */
+  NrColumnarStatsReader (const std::string &fileName);
+
+  /**
+   * \return the number of columns
+   */
+  std::size_t GetNColumns () const;
+
+  /**
+   * \param column the column index
+   * \return the name of the column
+   */
+  const std::string & GetColumnName (std::size_t column) const;
+
+  /**
+   * \param column the column index
+   * \return the type of the column
+   */
+  NrColumnarStats::ColumnType GetColumnType (std::size_t column) const;
+
+  /**
+   * \param name the column name
+   * \return the index of the column; it aborts if there is no such column
+   */
+  std::size_t GetColumnIndex (const std::string &name) const;
+
+  /**
+   * \return the number of rows (it reads the chunk headers only)
+   */
+  uint64_t GetNRows ();
+
+  /**
+   * \brief Read a column, converted to double
+   * \param name the column name
+   * \return the values of the column
+   */
+  std::vector<double> ReadColumn (const std::string &name);
+
+  /**
+   * \brief Read an UINT column, without conversions
+   * \param name the column name
+   * \return the values of the column
+   */
+  std::vector<uint64_t> ReadUintColumn (const std::string &name);
+
+  /**
+   * \brief Read an INT column, without conversions
+   * \param name the column name
+   * \return the values of the column
+   */
+  std::vector<int64_t> ReadIntColumn (const std::string &name);
+
+private:
+  /**
+   * \brief Read the bit patterns of a column
+   * \param column the column index
+   * \return the bit patterns of the values
+   */
+  std::vector<uint64_t> ReadRaw (std::size_t column);
+
+  std::string m_fileName;              //!< Name of the file
+  std::ifstream m_file;                //!< The file
+  NrColumnarStats::Columns m_columns;  //!< Name and type of the columns
+  std::streamoff m_dataOffset {0};     //!< Offset of the first chunk
+};
+
+} // namespace ns3
+
+#endif // NR_COLUMNAR_STATS_READER_H
@@ -90,121 +90,100 @@ ThreeGppChannelModelParam::SetRo (double ro)
   m_Ro = ro;
 }
 
-Ptr<MatrixBasedChannelModel::ChannelMatrix>
-ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> channelParams,
-                                     Ptr<const ParamsTable> table3gpp,
-                                     const Ptr<const MobilityModel> sMob,
-                                     const Ptr<const MobilityModel> uMob,
-                                     Ptr<const PhasedArrayModel> sAntenna,
-                                     Ptr<const PhasedArrayModel> uAntenna
-                                     ) const
+void
+ThreeGppChannelModelParam::GenerateChannelCoefficients (const ThreeGppChannelParams &channelParams,
+                                                        const ParamsTable &table3gpp,
+                                                        const Vector &sPos,
+                                                        const Vector &uPos,
+                                                        const PhasedArrayModel &sAntenna,
+                                                        const PhasedArrayModel &uAntenna,
+                                                        ChannelMatrix *channelMatrix) const
 {
   NS_LOG_FUNCTION (this);
 
-  NS_ASSERT_MSG (m_frequency > 0.0, "Set the operating frequency first!");
-
-  // create a channel matrix instance
-  Ptr<ChannelMatrix> channelMatrix = Create<ChannelMatrix> ();
-  channelMatrix->m_generatedTime = Simulator::Now ();
-  channelMatrix->m_nodeIds = std::make_pair (sMob->GetObject<Node> ()->GetId (), uMob->GetObject<Node> ()->GetId ());
-
   // check if channelParams structure is generated in direction s-to-u or u-to-s
-  bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
-
-  MatrixBasedChannelModel::Double2DVector rayAodRadian;
-  MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-  MatrixBasedChannelModel::Double2DVector rayZodRadian;
-  MatrixBasedChannelModel::Double2DVector rayZoaRadian;
+  bool isSameDirection = (channelParams.m_nodeIds == channelMatrix->m_nodeIds);
 
   // if channel params is generated in the same direction in which we
   // generate the channel matrix, angles and zenit od departure and arrival are ok,
   // just set them to corresponding variable that will be used for the generation
   // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-  if (isSameDirection)
-    {
-      rayAodRadian = channelParams->m_rayAodRadian;
-      rayAoaRadian = channelParams->m_rayAoaRadian;
-      rayZodRadian = channelParams->m_rayZodRadian;
-      rayZoaRadian = channelParams->m_rayZoaRadian;
-    }
-  else
-    {
-      rayAodRadian = channelParams->m_rayAoaRadian;
-      rayAoaRadian = channelParams->m_rayAodRadian;
-      rayZodRadian = channelParams->m_rayZoaRadian;
-      rayZoaRadian = channelParams->m_rayZodRadian;
-    }
+  const DoubleArray &rayAodRadian = isSameDirection ? channelParams.m_rayAodRadian : channelParams.m_rayAoaRadian;
+  const DoubleArray &rayAoaRadian = isSameDirection ? channelParams.m_rayAoaRadian : channelParams.m_rayAodRadian;
+  const DoubleArray &rayZodRadian = isSameDirection ? channelParams.m_rayZodRadian : channelParams.m_rayZoaRadian;
+  const DoubleArray &rayZoaRadian = isSameDirection ? channelParams.m_rayZoaRadian : channelParams.m_rayZodRadian;
 
 
   //Step 11: Generate channel coefficients for each cluster n and each receiver
   // and transmitter element pair u,s.
 
-  Complex3DVector H_NLOS; // channel coefficients H_NLOS [u][s][n],
-  // where u and s are receive and transmit antenna element, n is cluster index.
-  uint64_t uSize = uAntenna->GetNumberOfElements ();
-  uint64_t sSize = sAntenna->GetNumberOfElements ();
+  uint64_t uSize = uAntenna.GetNumberOfElements ();
+  uint64_t sSize = sAntenna.GetNumberOfElements ();
 
-  Complex3DVector H_usn;  //channel coffecient H_usn[u][s][n];
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
-  // the total cluster will be numReducedCLuster + 4.
-
-  H_usn.resize (uSize);
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+  // the total cluster will be numReducedCLuster + 4. The second and the third
+  // sub-clusters of the strongest clusters are stored after the other clusters,
+  // in the order of the index of the strongest cluster.
+  uint8_t numStrongClusters = 0;
+  std::vector<uint8_t> subClusterIndex (channelParams.m_reducedClusterNumber, 0);
+  for (uint8_t nIndex = 0; nIndex < channelParams.m_reducedClusterNumber; nIndex++)
     {
-      H_usn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+      if (nIndex == channelParams.m_cluster1st || nIndex == channelParams.m_cluster2nd)
         {
-          H_usn[uIndex][sIndex].resize (channelParams->m_reducedClusterNumber);
+          subClusterIndex[nIndex] = channelParams.m_reducedClusterNumber + 2 * numStrongClusters++;
         }
     }
-
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_crossPolarizationPowerRatios.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZodRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAodRadian.size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_crossPolarizationPowerRatios[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZodRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAodRadian[0].size ());
-
-  double x = sMob->GetPosition ().x - uMob->GetPosition ().x;
-  double y = sMob->GetPosition ().y - uMob->GetPosition ().y;
+  // channel coefficient H_usn(u, s, n), where u and s are receive and transmit
+  // antenna element, n is cluster index.
+  Complex3DVector H_usn (uSize, sSize, channelParams.m_reducedClusterNumber + 2 * numStrongClusters);
+
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= channelParams.m_clusterPhase.GetNumPages ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= channelParams.m_clusterPower.size ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= channelParams.m_crossPolarizationPowerRatios.GetNumCols ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayZoaRadian.GetNumCols ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayZodRadian.GetNumCols ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayAoaRadian.GetNumCols ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayAodRadian.GetNumCols ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= channelParams.m_clusterPhase.GetNumCols ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= channelParams.m_crossPolarizationPowerRatios.GetNumRows ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayZoaRadian.GetNumRows ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayZodRadian.GetNumRows ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayAoaRadian.GetNumRows ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayAodRadian.GetNumRows ());
+
+  double x = sPos.x - uPos.x;
+  double y = sPos.y - uPos.y;
   double distance2D = sqrt (x * x + y * y);
   // NOTE we assume hUT = min (height(a), height(b)) and
   // hBS = max (height (a), height (b))
-  double hUt = std::min (sMob->GetPosition ().z, uMob->GetPosition ().z);
-  double hBs = std::max (sMob->GetPosition ().z, uMob->GetPosition ().z);
+  double hUt = std::min (sPos.z, uPos.z);
+  double hBs = std::max (sPos.z, uPos.z);
   // compute the 3D distance using eq. 7.4-1
   double distance3D = std::sqrt (distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
 
-  Angles sAngle (uMob->GetPosition (), sMob->GetPosition ());
-  Angles uAngle (sMob->GetPosition (), uMob->GetPosition ());
+  Angles sAngle (uPos, sPos);
+  Angles uAngle (sPos, uPos);
 
   // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      Vector uLoc = uAntenna->GetElementLocation (uIndex);
+      Vector uLoc = uAntenna.GetElementLocation (uIndex);
 
       for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
 
-          Vector sLoc = sAntenna->GetElementLocation (sIndex);
+          Vector sLoc = sAntenna.GetElementLocation (sIndex);
 
-          for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+          for (uint8_t nIndex = 0; nIndex < channelParams.m_reducedClusterNumber; nIndex++)
             {
               //Compute the N-2 weakest cluster, assuming 0 slant angle and a
               //polarization slant angle configured in the array (7.5-22)
-              if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+              if (nIndex != channelParams.m_cluster1st && nIndex != channelParams.m_cluster2nd)
                 {
                   std::complex<double> rays (0,0);
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < table3gpp.m_raysPerCluster; mIndex++)
                     {
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
+                      const double *initialPhase = &channelParams.m_clusterPhase (0, mIndex, nIndex);
 
                       double Ro = 0;
                       if (m_parametrizedCorrelation)
@@ -213,23 +192,23 @@ ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> chann
                         }
                       else
                         {
-                          double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+                          double k = channelParams.m_crossPolarizationPowerRatios (mIndex, nIndex);
                           Ro = std::sqrt (1 / k);
                         }
 
                       //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
+                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian (mIndex, nIndex)) * cos (rayAoaRadian (mIndex, nIndex)) * uLoc.x
+                                                       + sin (rayZoaRadian (mIndex, nIndex)) * sin (rayAoaRadian (mIndex, nIndex)) * uLoc.y
+                                                       + cos (rayZoaRadian (mIndex, nIndex)) * uLoc.z);
 
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
+                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian (mIndex, nIndex)) * cos (rayAodRadian (mIndex, nIndex)) * sLoc.x
+                                                       + sin (rayZodRadian (mIndex, nIndex)) * sin (rayAodRadian (mIndex, nIndex)) * sLoc.y
+                                                       + cos (rayZodRadian (mIndex, nIndex)) * sLoc.z);
                       // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
 
                       double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
+                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (rayAoaRadian (mIndex, nIndex), rayZoaRadian (mIndex, nIndex)));
+                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (rayAodRadian (mIndex, nIndex), rayZodRadian (mIndex, nIndex)));
 
                       rays += (exp (std::complex<double> (0, initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
                                +exp (std::complex<double> (0, initialPhase[1])) * Ro * rxFieldPatternTheta * txFieldPatternPhi +
@@ -238,8 +217,8 @@ ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> chann
                         * exp (std::complex<double> (0, rxPhaseDiff))
                         * exp (std::complex<double> (0, txPhaseDiff));
                     }
-                  rays *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = rays;
+                  rays *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  H_usn (uIndex, sIndex, nIndex) = rays;
                 }
               else  //(7.5-28)
                 {
@@ -247,7 +226,7 @@ ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> chann
                   std::complex<double> raysSub2 (0,0);
                   std::complex<double> raysSub3 (0,0);
 
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < table3gpp.m_raysPerCluster; mIndex++)
                     {
                       double Ro = 0;
                       if (m_parametrizedCorrelation)
@@ -256,23 +235,23 @@ ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> chann
                         }
                       else
                         {
-                          double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+                          double k = channelParams.m_crossPolarizationPowerRatios (mIndex, nIndex);
                           Ro = std::sqrt (1 / k);
                         }
 
                       //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
 
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
+                      const double *initialPhase = &channelParams.m_clusterPhase (0, mIndex, nIndex);
+                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian (mIndex, nIndex)) * cos (rayAoaRadian (mIndex, nIndex)) * uLoc.x
+                                                       + sin (rayZoaRadian (mIndex, nIndex)) * sin (rayAoaRadian (mIndex, nIndex)) * uLoc.y
+                                                       + cos (rayZoaRadian (mIndex, nIndex)) * uLoc.z);
+                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian (mIndex, nIndex)) * cos (rayAodRadian (mIndex, nIndex)) * sLoc.x
+                                                       + sin (rayZodRadian (mIndex, nIndex)) * sin (rayAodRadian (mIndex, nIndex)) * sLoc.y
+                                                       + cos (rayZodRadian (mIndex, nIndex)) * sLoc.z);
 
                       double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
+                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (rayAoaRadian (mIndex, nIndex), rayZoaRadian (mIndex, nIndex)));
+                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (rayAodRadian (mIndex, nIndex), rayZodRadian (mIndex, nIndex)));
 
                       switch (mIndex)
                         {
@@ -310,17 +289,17 @@ ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> chann
                             break;
                         }
                     }
-                  raysSub1 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub2 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub3 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = raysSub1;
-                  H_usn[uIndex][sIndex].push_back (raysSub2);
-                  H_usn[uIndex][sIndex].push_back (raysSub3);
-
-                  NS_LOG_DEBUG ("H_usn[uIndex][sIndex][nIndex]:"<< H_usn[uIndex][sIndex][nIndex]<< " uIndex:"<<uIndex<<", sIndex:"<<sIndex<<"nIndex:"<< +nIndex);
+                  raysSub1 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  raysSub2 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  raysSub3 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  H_usn (uIndex, sIndex, nIndex) = raysSub1;
+                  H_usn (uIndex, sIndex, subClusterIndex[nIndex]) = raysSub2;
+                  H_usn (uIndex, sIndex, subClusterIndex[nIndex] + 1) = raysSub3;
+
+                  NS_LOG_DEBUG ("H_usn (uIndex, sIndex, nIndex):"<< H_usn (uIndex, sIndex, nIndex)<< " uIndex:"<<uIndex<<", sIndex:"<<sIndex<<"nIndex:"<< +nIndex);
                 }
             }
-          if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+          if (channelParams.m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
             {
               std::complex<double> ray (0,0);
               double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc.x
@@ -331,8 +310,8 @@ ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> chann
                                                + cos (sAngle.GetInclination ()) * sLoc.z);
 
               double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
-              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
 
               double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
 
@@ -341,34 +320,32 @@ ThreeGppChannelModelParam::GetNewChannel (Ptr<const ThreeGppChannelParams> chann
                 * exp (std::complex<double> (0, rxPhaseDiff))
                 * exp (std::complex<double> (0, txPhaseDiff));
 
-              double K_linear = pow (10, channelParams->m_K_factor / 10);
+              double K_linear = pow (10, channelParams.m_K_factor / 10);
               // the LOS path should be attenuated if blockage is enabled.
-              H_usn[uIndex][sIndex][0] = sqrt (1 / (K_linear + 1)) * H_usn[uIndex][sIndex][0] + sqrt (K_linear / (1 + K_linear)) * ray / pow (10, channelParams->m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = H_usn[uIndex][sIndex].size ();
-              for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
+              H_usn (uIndex, sIndex, 0) = sqrt (1 / (K_linear + 1)) * H_usn (uIndex, sIndex, 0) + sqrt (K_linear / (1 + K_linear)) * ray / pow (10, channelParams.m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
+              for (uint8_t nIndex = 1; nIndex < H_usn.GetNumPages (); nIndex++)
                 {
-                  H_usn[uIndex][sIndex][nIndex] *= sqrt (1 / (K_linear + 1)); //(7.5-30) for tau = tau2...taunN
-                  NS_LOG_DEBUG ("LOS H_usn[uIndex][sIndex][nIndex]:"<< H_usn[uIndex][sIndex][nIndex]<< " uIndex:"<<uIndex<<", sIndex:"<<sIndex<<"nIndex:"<< +nIndex);
+                  H_usn (uIndex, sIndex, nIndex) *= sqrt (1 / (K_linear + 1)); //(7.5-30) for tau = tau2...taunN
+                  NS_LOG_DEBUG ("LOS H_usn (uIndex, sIndex, nIndex):"<< H_usn (uIndex, sIndex, nIndex)<< " uIndex:"<<uIndex<<", sIndex:"<<sIndex<<"nIndex:"<< +nIndex);
                 }
 
             }
         }
     }
 
-  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna->GetId () << ", " << uAntenna->GetId ());
-  for (auto& i:H_usn)
+  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna.GetId () << ", " << uAntenna.GetId ());
+  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      for (auto& j:i)
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-          for (auto& k:j)
+          for (std::size_t nIndex = 0; nIndex < H_usn.GetNumPages (); nIndex++)
             {
-              NS_LOG_DEBUG (" " << k << ",");
+              NS_LOG_DEBUG (" " << H_usn (uIndex, sIndex, nIndex) << ",");
             }
         }
     }
-  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.size () << "][" << H_usn[0].size () << "][" << H_usn[0][0].size () << "]");
-  channelMatrix->m_channel = H_usn;
-  return channelMatrix;
+  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.GetNumRows () << "][" << H_usn.GetNumCols () << "][" << H_usn.GetNumPages () << "]");
+  channelMatrix->m_channel = std::move (H_usn);
 }
 
 }  // namespace ns3
@@ -73,22 +73,23 @@ public:
 private:
 
   /**
-   * Compute the channel matrix between two devices using the procedure
-   * described in 3GPP TR 38.901
+   * Compute the coefficients of the channel matrix between two devices using
+   * the procedure described in 3GPP TR 38.901
    * \param channelParams the channel parameters
    * \param table3gpp the 3gpp parameters table
-   * \param sMob the mobility model of node s
-   * \param uMob the mobility model of node u
+   * \param sPos the position of node s
+   * \param uPos the position of node u
    * \param sAntenna the antenna array of node s
    * \param uAntenna the antenna array of node u
-   * \return the channel realization
+   * \param channelMatrix the channel matrix where the coefficients are stored
    */
-  virtual Ptr<ChannelMatrix> GetNewChannel (Ptr<const ThreeGppChannelParams> channelParams,
-                                            Ptr<const ParamsTable> table3gpp,
-                                            const Ptr<const MobilityModel> sMob,
-                                            const Ptr<const MobilityModel> uMob,
-                                            Ptr<const PhasedArrayModel> sAntenna,
-                                            Ptr<const PhasedArrayModel> uAntenna) const override;
+  virtual void GenerateChannelCoefficients (const ThreeGppChannelParams &channelParams,
+                                            const ParamsTable &table3gpp,
+                                            const Vector &sPos,
+                                            const Vector &uPos,
+                                            const PhasedArrayModel &sAntenna,
+                                            const PhasedArrayModel &uAntenna,
+                                            ChannelMatrix *channelMatrix) const override;
 
   double m_Ro {1.0}; //!< cross polarization correlation parameter
   double m_parametrizedCorrelation {true}; //!< whether the parameter Ro will be used as correlation term
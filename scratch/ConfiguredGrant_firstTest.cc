@@ -351,7 +351,8 @@ main (int argc, char *argv[]){
 
       * select_sch = 0 : Round Robin
                      1 : Proportional Fair
-                     2 : Greedy
+                     2 : Greedy (age of information)
+                     3 : Earliest deadline first
     */
     uint32_t seed = 1;  
     bool period_on = false; // 패킷 주기 on/off
@@ -481,9 +482,12 @@ main (int argc, char *argv[]){
         else if(select_sch == 1){
           nrHelper->SetSchedulerTypeId (NrMacSchedulerOfdmaPF::GetTypeId ());
         }
-        // else if(select_sch == 2){
-        //   nrHelper->SetSchedulerTypeId (NrMacSchedulerOfdmaAoIGreedy::GetTypeId ());
-        // }
+        else if(select_sch == 2){
+          nrHelper->SetSchedulerTypeId (NrMacSchedulerOfdmaAoI::GetTypeId ());
+        }
+        else if(select_sch == 3){
+          nrHelper->SetSchedulerTypeId (NrMacSchedulerOfdmaEdf::GetTypeId ());
+        }
 
         nrHelper->SetSchedulerAttribute ("schOFDMA", UintegerValue (sch)); // sch = 0 for TDMA
                                                                            // 1 for 5GL-OFDMA
@@ -89,11 +89,22 @@ PhasedArrayModel::SetBeamformingVector (const ComplexVector &beamformingVector)
   NS_LOG_FUNCTION (this << beamformingVector);
   NS_ASSERT_MSG (beamformingVector.size () == GetNumberOfElements (),
                  beamformingVector.size () << " != " << GetNumberOfElements ());
-  m_beamformingVector = beamformingVector;
+  if (!m_isBfVectorValid || m_beamformingVector != beamformingVector)
+    {
+      m_beamformingVector = beamformingVector;
+      ++m_bfVectorVersion;
+    }
   m_isBfVectorValid = true;
 }
 
 
+uint64_t
+PhasedArrayModel::GetBeamformingVectorVersion (void) const
+{
+  return m_bfVectorVersion;
+}
+
+
 PhasedArrayModel::ComplexVector
 PhasedArrayModel::GetBeamformingVector () const
 {
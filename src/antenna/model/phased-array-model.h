@@ -97,6 +97,16 @@ public:
   ComplexVector GetBeamformingVector (void) const;
 
 
+  /**
+   * Returns the version of the beamforming vector in use. The version
+   * changes only when SetBeamformingVector sets a vector different from the
+   * current one, so that the users of the vector can detect a beam change
+   * without comparing the vectors.
+   * \return the version of the current beamforming vector
+   */
+  uint64_t GetBeamformingVectorVersion (void) const;
+
+
   /**
    * Returns the beamforming vector that points towards the specified position
    * \param a the beamforming angle
@@ -143,6 +153,7 @@ protected:
   ComplexVector m_beamformingVector; //!< the beamforming vector in use
   Ptr<AntennaModel> m_antennaElement; //!< the model of the antenna element in use
   bool m_isBfVectorValid; //!< ensures the validity of the beamforming vector
+  uint64_t m_bfVectorVersion {0}; //!< the version of the beamforming vector in use
   static uint32_t m_idCounter; //!< the ID counter that is used to determine the unique antenna array ID
   uint32_t m_id {0}; //!< the ID of this antenna array instance
 };
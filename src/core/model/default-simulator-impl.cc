@@ -24,6 +24,7 @@
 #include "scheduler.h"
 #include "assert.h"
 #include "log.h"
+#include "uinteger.h"
 
 #include <cmath>
 
@@ -50,6 +51,21 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EventAllocations",
+                   "The number of events allocated by the simulation thread "
+                   "since the creation of the simulator.",
+                   TypeId::ATTR_GET, // read-only attribute
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::GetEventAllocations),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("EventHeapAllocations",
+                   "The number of events allocated from the heap by the "
+                   "simulation thread since the creation of the simulator; "
+                   "the other ones reuse the memory of expired events.",
+                   TypeId::ATTR_GET, // read-only attribute
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::GetEventHeapAllocations),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
@@ -64,8 +80,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
   m_eventCount = 0;
-  m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self ();
+  m_allocationsAtStart = EventImpl::GetAllocationStats ();
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -158,22 +174,8 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  m_eventsWithContext.Drain ([this] (const EventWithContext &event)
     {
-      return;
-    }
-
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap (eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
-    {
-      EventWithContext event = eventsWithContext.front ();
-      eventsWithContext.pop_front ();
       Scheduler::Event ev;
       ev.impl = event.event;
       ev.key.m_ts = m_currentTs + event.timestamp;
@@ -182,7 +184,7 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
       m_uid++;
       m_unscheduledEvents++;
       m_events->Insert (ev);
-    }
+    });
 }
 
 void
@@ -199,6 +201,9 @@ DefaultSimulatorImpl::Run (void)
       ProcessOneEvent ();
     }
 
+  NS_LOG_INFO ("executed " << m_eventCount << " events, allocated " << GetEventAllocations ()
+               << " events, " << GetEventHeapAllocations () << " from the heap");
+
   // If the simulator stopped naturally by lack of events, make a
   // consistency test to check that we didn't lose any events along the way.
   NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
@@ -265,11 +270,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       // Current time added in ProcessEventsWithContext()
       ev.timestamp = delay.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back (ev);
-        m_eventsWithContextEmpty = false;
-      }
+      m_eventsWithContext.Push (ev);
     }
 }
 
@@ -405,4 +406,16 @@ DefaultSimulatorImpl::GetEventCount (void) const
   return m_eventCount;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetEventAllocations (void) const
+{
+  return EventImpl::GetAllocationStats ().m_allocations - m_allocationsAtStart.m_allocations;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetEventHeapAllocations (void) const
+{
+  return EventImpl::GetAllocationStats ().m_heapAllocations - m_allocationsAtStart.m_heapAllocations;
+}
+
 } // namespace ns3
@@ -23,7 +23,8 @@
 
 #include "simulator-impl.h"
 #include "system-thread.h"
-#include "system-mutex.h"
+#include "mpsc-queue.h"
+#include "event-impl.h"
 
 #include <list>
 
@@ -78,6 +79,23 @@ public:
   virtual uint32_t GetContext (void) const;
   virtual uint64_t GetEventCount (void) const;
 
+  /**
+   * Get the number of events allocated by the calling thread since the
+   * creation of the simulator; the allocation counters are per thread,
+   * so this is meant to be called from the simulation thread.
+   *
+   * \returns The number of events allocated.
+   */
+  uint64_t GetEventAllocations (void) const;
+  /**
+   * Get the number of events allocated from the heap by the calling thread
+   * since the creation of the simulator; the other events reused the memory
+   * of the expired ones (see EventImpl).
+   *
+   * \returns The number of events allocated from the heap.
+   */
+  uint64_t GetEventHeapAllocations (void) const;
+
 private:
   virtual void DoDispose (void);
 
@@ -96,17 +114,11 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
-  /** Container type for the events from a different context. */
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
-  EventsWithContext m_eventsWithContext;
   /**
-   * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * The events from a different thread, pushed without locking and moved
+   * to the primary event queue in the order of the pushes.
    */
-  bool m_eventsWithContextEmpty;
-  /** Mutex to control access to the list of events with context. */
-  SystemMutex m_eventsWithContextMutex;
+  MpscQueue<EventWithContext> m_eventsWithContext;
 
   /** Container type for the events to run at Simulator::Destroy() */
   typedef std::list<EventId> DestroyEvents;
@@ -127,6 +139,8 @@ private:
   uint32_t m_currentContext;
   /** The event count. */
   uint64_t m_eventCount;
+  /** The event allocation counters at the creation of the simulator. */
+  EventImpl::AllocationStats m_allocationsAtStart;
   /**
    * Number of events that have been inserted but not yet scheduled,
    *  not counting the Destroy events; this is used for validation
@@ -31,6 +31,154 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Size of the smallest class of the event free lists. */
+const std::size_t EVENT_GRANULE = 16;
+/** Number of size classes of the event free lists. */
+const std::size_t EVENT_SIZE_CLASSES = 16;
+/** Maximum number of free events kept in each size class. */
+const uint32_t EVENT_MAX_FREE = 4096;
+
+/** A free event, linked to the next one of its size class. */
+struct FreeEvent
+{
+  FreeEvent *m_next; //!< Next free event
+};
+
+/**
+ * The event free lists of a thread. The type is trivial, so that the
+ * lists can still be used (and bypassed) by the events released
+ * after the end of the thread, e.g., by static destructors.
+ */
+struct EventFreeLists
+{
+  FreeEvent *m_head[EVENT_SIZE_CLASSES];   //!< First free event of each class
+  uint32_t m_length[EVENT_SIZE_CLASSES];   //!< Number of free events of each class
+  EventImpl::AllocationStats m_stats;      //!< Allocation counters
+  bool m_ready;                            //!< The releaser is registered
+  bool m_released;                         //!< The thread is exiting
+};
+
+/** The event free lists of the thread (zero initialized). */
+thread_local EventFreeLists t_eventFreeLists;
+
+/** Give back the free events to the heap at the end of the thread. */
+struct EventFreeListsReleaser
+{
+  ~EventFreeListsReleaser ()
+  {
+    EventFreeLists &lists = t_eventFreeLists;
+    lists.m_released = true;
+    for (std::size_t c = 0; c < EVENT_SIZE_CLASSES; ++c)
+      {
+        while (lists.m_head[c] != nullptr)
+          {
+            FreeEvent *ev = lists.m_head[c];
+            lists.m_head[c] = ev->m_next;
+            ::operator delete (ev);
+          }
+        lists.m_length[c] = 0;
+      }
+  }
+};
+
+/** The releaser of the free lists of the thread. */
+thread_local EventFreeListsReleaser t_eventFreeListsReleaser;
+
+/**
+ * \returns The event free lists of the thread, with their releaser
+ * registered.
+ */
+EventFreeLists &
+GetEventFreeLists (void)
+{
+  EventFreeLists &lists = t_eventFreeLists;
+  if (!lists.m_ready)
+    {
+      // Using the releaser registers its destructor for this thread
+      static_cast<void> (&t_eventFreeListsReleaser);
+      lists.m_ready = true;
+    }
+  return lists;
+}
+
+/**
+ * \param [in] size The size of an event.
+ * \returns The size class of the event; EVENT_SIZE_CLASSES if it is too large.
+ */
+inline std::size_t
+GetEventSizeClass (std::size_t size)
+{
+  std::size_t c = size == 0 ? 0 : (size - 1) / EVENT_GRANULE;
+  return c < EVENT_SIZE_CLASSES ? c : EVENT_SIZE_CLASSES;
+}
+
+} // unnamed namespace
+
+EventImpl::AllocationStats
+EventImpl::GetAllocationStats (void)
+{
+  return t_eventFreeLists.m_stats;
+}
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  EventFreeLists &lists = GetEventFreeLists ();
+  ++lists.m_stats.m_allocations;
+  std::size_t c = GetEventSizeClass (size);
+  if (c == EVENT_SIZE_CLASSES || lists.m_released)
+    {
+      ++lists.m_stats.m_heapAllocations;
+      return ::operator new (size);
+    }
+  FreeEvent *ev = lists.m_head[c];
+  if (ev != nullptr)
+    {
+      lists.m_head[c] = ev->m_next;
+      --lists.m_length[c];
+      return ev;
+    }
+  ++lists.m_stats.m_heapAllocations;
+  return ::operator new ((c + 1) * EVENT_GRANULE);
+}
+
+void
+EventImpl::operator delete (void *ptr, std::size_t size)
+{
+  if (ptr == nullptr)
+    {
+      return;
+    }
+  EventFreeLists &lists = GetEventFreeLists ();
+  std::size_t c = GetEventSizeClass (size);
+  if (c == EVENT_SIZE_CLASSES || lists.m_released || lists.m_length[c] >= EVENT_MAX_FREE)
+    {
+      ::operator delete (ptr);
+      return;
+    }
+  FreeEvent *ev = static_cast<FreeEvent *> (ptr);
+  ev->m_next = lists.m_head[c];
+  lists.m_head[c] = ev;
+  ++lists.m_length[c];
+}
+
+void *
+EventImpl::operator new (std::size_t size, std::align_val_t align)
+{
+  EventFreeLists &lists = GetEventFreeLists ();
+  ++lists.m_stats.m_allocations;
+  ++lists.m_stats.m_heapAllocations;
+  return ::operator new (size, align);
+}
+
+void
+EventImpl::operator delete (void *ptr, [[maybe_unused]] std::size_t size, std::align_val_t align)
+{
+  ::operator delete (ptr, align);
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
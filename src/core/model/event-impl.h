@@ -21,6 +21,8 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
+#include <new>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +42,12 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The events are allocated from per-thread free lists, one per size
+ * class of 16 bytes up to 256 bytes: as the arguments bound by
+ * MakeEvent() are members of the subclasses, scheduling an event
+ * usually reuses the memory of an event that has expired, instead of
+ * allocating from the heap. Larger events use the global operator new.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -48,6 +56,49 @@ public:
   EventImpl ();
   /** Destructor. */
   virtual ~EventImpl () = 0;
+
+  /** Event allocation counters of the calling thread. */
+  struct AllocationStats
+  {
+    uint64_t m_allocations;     //!< Number of events allocated
+    uint64_t m_heapAllocations; //!< Number of events allocated from the heap
+  };
+
+  /**
+   * \returns The event allocation counters of the calling thread.
+   */
+  static AllocationStats GetAllocationStats (void);
+
+  /**
+   * Allocate an event from the free list of its size class.
+   *
+   * \param [in] size The size of the event.
+   * \returns The memory of the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Give back the memory of an event to the free list of its size class.
+   *
+   * \param [in] ptr The memory of the event.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *ptr, std::size_t size);
+  /**
+   * Allocate an over-aligned event, with the global operator new.
+   *
+   * \param [in] size The size of the event.
+   * \param [in] align The alignment of the event.
+   * \returns The memory of the event.
+   */
+  static void * operator new (std::size_t size, std::align_val_t align);
+  /**
+   * Release an over-aligned event, with the global operator delete.
+   *
+   * \param [in] ptr The memory of the event.
+   * \param [in] size The size of the event.
+   * \param [in] align The alignment of the event.
+   */
+  static void operator delete (void *ptr, std::size_t size, std::align_val_t align);
   /**
    * Called by the simulation engine to notify the event that it is time
    * to execute.
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::MpscQueue declaration and implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * @ingroup thread
+ * @brief A lock-free multiple producer, single consumer queue.
+ *
+ * Any thread can Push() values, without taking a lock: a push links a new
+ * node at the head of a list with a single compare-and-swap. The consumer
+ * takes the whole list at once with Drain(), which hands the values over
+ * in the order of the pushes (the order in which the compare-and-swap
+ * operations succeeded), as a mutex-protected FIFO would.
+ *
+ * Only one thread at a time can call Drain().
+ *
+ * @tparam T The type of the values.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+  /** Create an empty queue. */
+  MpscQueue () = default;
+
+  /** Destructor: discards the values that were not drained. */
+  ~MpscQueue ()
+  {
+    Node *node = m_head.exchange (nullptr, std::memory_order_acquire);
+    while (node != nullptr)
+      {
+        Node *next = node->m_next;
+        delete node;
+        node = next;
+      }
+  }
+
+  // Delete copy constructor and assignment operator to avoid misuse
+  MpscQueue (const MpscQueue &) = delete;
+  MpscQueue & operator = (const MpscQueue &) = delete;
+
+  /**
+   * Add a value to the queue; can be called from any thread.
+   *
+   * @param [in] value The value.
+   */
+  void Push (const T &value)
+  {
+    Node *node = new Node {value, m_head.load (std::memory_order_relaxed)};
+    while (!m_head.compare_exchange_weak (node->m_next, node,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed))
+      {
+      }
+  }
+
+  /**
+   * @returns True if there are no values to drain; a concurrent Push()
+   * may make it stale as soon as it returns.
+   */
+  bool IsEmpty (void) const
+  {
+    return m_head.load (std::memory_order_relaxed) == nullptr;
+  }
+
+  /**
+   * Remove all the values of the queue, and pass them to a function
+   * in the order in which they were pushed; can only be called from the
+   * consumer thread.
+   *
+   * @tparam F \deduced The type of the function.
+   * @param [in] f The function, called as f (value) for each value.
+   * @returns The number of values.
+   */
+  template <typename F>
+  std::size_t Drain (F f)
+  {
+    if (IsEmpty ())
+      {
+        return 0;
+      }
+    Node *node = m_head.exchange (nullptr, std::memory_order_acquire);
+
+    // The list is linked from the last pushed value: reverse it
+    Node *first = nullptr;
+    while (node != nullptr)
+      {
+        Node *next = node->m_next;
+        node->m_next = first;
+        first = node;
+        node = next;
+      }
+
+    std::size_t count = 0;
+    while (first != nullptr)
+      {
+        Node *next = first->m_next;
+        f (first->m_value);
+        delete first;
+        first = next;
+        ++count;
+      }
+    return count;
+  }
+
+private:
+  /** A value, linked to the value pushed before it. */
+  struct Node
+  {
+    T m_value;     //!< The value
+    Node *m_next;  //!< The value pushed before this one
+  };
+
+  std::atomic<Node *> m_head {nullptr}; //!< The last pushed value
+};
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
@@ -0,0 +1,762 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "simulator.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "abort.h"
+#include "log.h"
+#include "uinteger.h"
+
+#include <algorithm>
+#include <thread>
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/**
+ * @ingroup simulator
+ * An event received from another partition. It runs the original event,
+ * and then hands it to the main thread to release it: the arguments of the
+ * event may be shared with the events of other partitions, and their
+ * reference counts are not thread safe.
+ */
+class ForeignEvent : public EventImpl
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param [in] event The original event.
+   * @param [in] release The list of the events to release on the main
+   * thread, of the destination partition.
+   */
+  ForeignEvent (EventImpl *event, std::vector<EventImpl *> *release)
+    : m_event (event),
+      m_release (release)
+  {}
+  virtual ~ForeignEvent ()
+  {
+    m_release->push_back (m_event);
+  }
+
+private:
+  virtual void Notify (void)
+  {
+    m_event->Invoke ();
+  }
+
+  EventImpl *m_event;                   //!< The original event
+  std::vector<EventImpl *> *m_release;  //!< Where to release the original event
+};
+
+} // unnamed namespace
+
+const uint32_t MultithreadedSimulatorImpl::SERIAL_PARTITION;
+thread_local MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::m_currentPartition = nullptr;
+thread_local bool MultithreadedSimulatorImpl::m_inParallelWindow = false;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("Lookahead",
+                   "The minimum delay of the events scheduled from a partition "
+                   "to another one, e.g., the minimum propagation delay between "
+                   "the nodes of different partitions. It is the maximum length "
+                   "of the windows run in parallel.",
+                   TimeValue (MicroSeconds (1)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::SetLookahead,
+                                     &MultithreadedSimulatorImpl::GetLookahead),
+                   MakeTimeChecker (TimeStep (1)))
+    .AddAttribute ("MaxThreads",
+                   "The maximum number of threads that run the partitions, "
+                   "including the main one; 0 means one per hardware thread. "
+                   "Without the NS3_MTP build option, the reference counts "
+                   "are not thread safe, and the partitions run on one thread.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_maxThreads),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_serial (new Partition),
+    m_distributed (false),
+    m_lookahead (1),
+    m_maxThreads (0),
+    m_windowEnd (0),
+    m_endingWindow (false),
+    m_stop (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_main = SystemThread::Self ();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_pool = 0;
+  m_partitions.push_back (std::move (m_serial));
+  for (auto &partition : m_partitions)
+    {
+      while (!partition->m_events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->m_events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      partition->m_events = 0;
+    }
+  for (auto &partition : m_partitions)
+    {
+      for (EventImpl *event : partition->m_release)
+        {
+          event->Unref ();
+        }
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT (SystemThread::Equals (m_main) && m_currentPartition == nullptr);
+  m_schedulerFactory = schedulerFactory;
+
+  auto replace = [&schedulerFactory] (Partition &partition)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (partition.m_events != 0)
+        {
+          while (!partition.m_events->IsEmpty ())
+            {
+              scheduler->Insert (partition.m_events->RemoveNext ());
+            }
+        }
+      partition.m_events = scheduler;
+    };
+  replace (*m_serial);
+  for (auto &partition : m_partitions)
+    {
+      replace (*partition);
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ABORT_MSG_IF (m_distributed, "The partitions must be set before the simulation runs");
+  NS_ABORT_MSG_IF (context == Simulator::NO_CONTEXT, "The events without context are serial");
+  if (context >= m_partitionOfContext.size ())
+    {
+      m_partitionOfContext.resize (context + 1, SERIAL_PARTITION);
+    }
+  m_partitionOfContext[context] = partition;
+  while (partition != SERIAL_PARTITION && partition >= m_partitions.size ())
+    {
+      m_partitions.emplace_back (new Partition);
+      m_partitions.back ()->m_index = GetNPartitions () - 1;
+      m_partitions.back ()->m_events = m_schedulerFactory.Create<Scheduler> ();
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context < m_partitionOfContext.size ())
+    {
+      return m_partitionOfContext[context];
+    }
+  return SERIAL_PARTITION;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions (void) const
+{
+  return static_cast<uint32_t> (m_partitions.size ());
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return TimeStep (m_lookahead);
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead (Time lookahead)
+{
+  NS_LOG_FUNCTION (this << lookahead);
+  NS_ABORT_MSG_UNLESS (lookahead.IsStrictlyPositive (), "The lookahead must be positive");
+  m_lookahead = static_cast<uint64_t> (lookahead.GetTimeStep ());
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::FindPartition (uint32_t context) const
+{
+  // Before the first Run () all the events are serial
+  uint32_t index = m_distributed ? GetPartition (context) : SERIAL_PARTITION;
+  return index == SERIAL_PARTITION ? *m_serial : *m_partitions[index];
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  if (m_currentPartition != nullptr)
+    {
+      return *m_currentPartition;
+    }
+  NS_ABORT_MSG_UNLESS (SystemThread::Equals (m_main),
+                       "MultithreadedSimulatorImpl does not support the threads of the models");
+  return *m_serial;
+}
+
+Scheduler::Event
+MultithreadedSimulatorImpl::Insert (Partition &partition, Scheduler::Event event, bool foreign)
+{
+  NS_ABORT_MSG_IF (m_endingWindow && event.key.m_ts < m_windowEnd,
+                   "Event at " << TimeStep (event.key.m_ts).As (Time::NS)
+                   << " scheduled at the end of the window that ends at "
+                   << TimeStep (m_windowEnd).As (Time::NS)
+                   << ": the delays across partitions must not be smaller than the lookahead");
+  if (foreign && &partition != m_serial.get ())
+    {
+      event.impl = new ForeignEvent (event.impl, &partition.m_release);
+    }
+  event.key.m_uid = partition.m_uid;
+  partition.m_uid++;
+  partition.m_events->Insert (event);
+  return event;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  if (!m_serial->m_events->IsEmpty ())
+    {
+      return false;
+    }
+  for (const auto &partition : m_partitions)
+    {
+      if (!partition->m_events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::DistributeEvents (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_distributed = true;
+  // The events keep their uids, hence their order
+  Ptr<Scheduler> serial = m_schedulerFactory.Create<Scheduler> ();
+  while (!m_serial->m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_serial->m_events->RemoveNext ();
+      Partition &partition = FindPartition (next.key.m_context);
+      if (&partition == m_serial.get ())
+        {
+          serial->Insert (next);
+        }
+      else
+        {
+          partition.m_events->Insert (next);
+        }
+    }
+  m_serial->m_events = serial;
+  for (auto &partition : m_partitions)
+    {
+      partition->m_uid = m_serial->m_uid;
+      partition->m_currentTs = m_serial->m_currentTs;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (Partition &partition, uint64_t end)
+{
+  Partition *previous = m_currentPartition;
+  m_currentPartition = &partition;
+  m_inParallelWindow = &partition != m_serial.get ();
+
+  // Simulator::Stop() interrupts only the serial events, so that the
+  // partitions always run up to the end of the window
+  while (!partition.m_events->IsEmpty ()
+         && partition.m_events->PeekNext ().key.m_ts < end
+         && (m_inParallelWindow || !m_stop))
+    {
+      Scheduler::Event next = partition.m_events->RemoveNext ();
+
+      PreEventHook (EventId (next.impl, next.key.m_ts,
+                             next.key.m_context, next.key.m_uid));
+
+      NS_ASSERT (next.key.m_ts >= partition.m_currentTs);
+      partition.m_eventCount++;
+      partition.m_currentTs = next.key.m_ts;
+      partition.m_currentContext = next.key.m_context;
+      partition.m_currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+
+  m_inParallelWindow = false;
+  m_currentPartition = previous;
+}
+
+void
+MultithreadedSimulatorImpl::EndWindow (void)
+{
+  m_endingWindow = true;
+
+  std::vector<std::pair<Partition *, DeferredEvent> > deferred;
+  for (auto &partition : m_partitions)
+    {
+      for (EventImpl *event : partition->m_release)
+        {
+          event->Unref ();
+        }
+      partition->m_release.clear ();
+
+      for (const RemoteEvent &remote : partition->m_outbox)
+        {
+          Partition &destination = remote.m_partition == SERIAL_PARTITION
+            ? *m_serial : *m_partitions[remote.m_partition];
+          Insert (destination, remote.m_event, true);
+        }
+      partition->m_outbox.clear ();
+
+      for (const DeferredEvent &event : partition->m_deferred)
+        {
+          deferred.emplace_back (partition.get (), event);
+        }
+      partition->m_deferred.clear ();
+    }
+
+  // The deferred calls run in the order of their time, and then of their
+  // partition and of their scheduling
+  std::stable_sort (deferred.begin (), deferred.end (),
+                    [] (const std::pair<Partition *, DeferredEvent> &a,
+                        const std::pair<Partition *, DeferredEvent> &b)
+    {
+      return a.second.m_ts < b.second.m_ts;
+    });
+  for (auto &call : deferred)
+    {
+      Partition &partition = *call.first;
+      uint64_t ts = partition.m_currentTs;
+      uint32_t context = partition.m_currentContext;
+      partition.m_currentTs = call.second.m_ts;
+      partition.m_currentContext = call.second.m_context;
+      m_currentPartition = &partition;
+
+      call.second.m_event->Invoke ();
+      call.second.m_event->Unref ();
+
+      m_currentPartition = nullptr;
+      partition.m_currentTs = ts;
+      partition.m_currentContext = context;
+    }
+
+  m_endingWindow = false;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  if (!m_distributed)
+    {
+      DistributeEvents ();
+    }
+  m_stop = false;
+
+  uint32_t numThreads = m_maxThreads;
+  if (numThreads == 0)
+    {
+      numThreads = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+  numThreads = std::max (std::min (numThreads, GetNPartitions ()), 1U);
+#ifndef NS3_MTP
+  if (numThreads > 1)
+    {
+      NS_LOG_WARN ("The reference counts are not thread safe without NS3_MTP: "
+                   "running the partitions on one thread");
+      numThreads = 1;
+    }
+#endif
+  if (m_pool == 0 || m_pool->GetNumThreads () != numThreads)
+    {
+      m_pool = Create<WorkerPool> (numThreads);
+    }
+  NS_LOG_INFO ("run " << GetNPartitions () << " partitions on " << numThreads << " threads");
+
+  std::vector<Partition *> active;
+  while (!m_stop)
+    {
+      // Find the time of the next event, and run the serial events at
+      // that time first
+      bool found = false;
+      uint64_t next = 0;
+      auto update = [&found, &next] (const Partition &partition)
+        {
+          if (!partition.m_events->IsEmpty ())
+            {
+              uint64_t ts = partition.m_events->PeekNext ().key.m_ts;
+              next = found ? std::min (next, ts) : ts;
+              found = true;
+            }
+        };
+      update (*m_serial);
+      for (const auto &partition : m_partitions)
+        {
+          update (*partition);
+        }
+      if (!found)
+        {
+          break;
+        }
+      ProcessWindow (*m_serial, next + 1);
+      if (m_stop)
+        {
+          break;
+        }
+
+      // Run the partitions until the lookahead, or until the next serial event
+      m_windowEnd = next + m_lookahead;
+      if (!m_serial->m_events->IsEmpty ())
+        {
+          m_windowEnd = std::min (m_windowEnd, m_serial->m_events->PeekNext ().key.m_ts);
+        }
+      active.clear ();
+      for (const auto &partition : m_partitions)
+        {
+          if (!partition->m_events->IsEmpty ()
+              && partition->m_events->PeekNext ().key.m_ts < m_windowEnd)
+            {
+              active.push_back (partition.get ());
+            }
+        }
+      if (active.size () == 1)
+        {
+          ProcessWindow (*active.front (), m_windowEnd);
+        }
+      else if (active.size () > 1)
+        {
+          uint64_t end = m_windowEnd;
+          m_pool->Run (active.size (), [this, &active, end] (std::size_t i)
+            {
+              ProcessWindow (*active[i], end);
+            });
+        }
+      EndWindow ();
+    }
+
+  NS_LOG_INFO ("executed " << GetEventCount () << " events");
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+  Partition &partition = GetCurrentPartition ();
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = partition.m_currentTs + static_cast<uint64_t> (delay.GetTimeStep ());
+  ev.key.m_context = partition.m_currentContext;
+  ev = Insert (partition, ev, false);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::ScheduleWithContext(): Negative delay");
+  Partition &source = GetCurrentPartition ();
+  Partition &destination = FindPartition (context);
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = source.m_currentTs + static_cast<uint64_t> (delay.GetTimeStep ());
+  ev.key.m_context = context;
+  if (&source == &destination)
+    {
+      Insert (destination, ev, false);
+    }
+  else if (m_inParallelWindow)
+    {
+      NS_ABORT_MSG_IF (ev.key.m_ts < m_windowEnd,
+                       "Event for context " << context << " scheduled with a delay of "
+                       << delay.As (Time::NS) << ", smaller than the lookahead "
+                       << GetLookahead ().As (Time::NS));
+      source.m_outbox.push_back ({destination.m_index, ev});
+    }
+  else
+    {
+      Insert (destination, ev, true);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (Time (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  std::lock_guard<std::mutex> lock (m_destroyMutex);
+  EventId id (Ptr<EventImpl> (event, false), GetCurrentPartition ().m_currentTs, 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleAtWindowEnd (EventImpl *event)
+{
+  NS_ASSERT_MSG (m_inParallelWindow, "ScheduleAtWindowEnd() outside of a parallel window");
+  Partition &partition = *m_currentPartition;
+  partition.m_deferred.push_back ({partition.m_currentTs, partition.m_currentContext, event});
+}
+
+bool
+MultithreadedSimulatorImpl::IsInParallelWindow (void)
+{
+  return m_inParallelWindow;
+}
+
+bool
+MultithreadedSimulatorImpl::GetPartitionUid (uint64_t *uid)
+{
+  Partition *partition = m_currentPartition;
+  if (partition == nullptr || partition->m_index == SERIAL_PARTITION)
+    {
+      return false;
+    }
+  *uid = static_cast<uint64_t> (partition->m_index + 1) << 40 | partition->m_objectUid++;
+  return true;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentPartition ().m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - FindPartition (id.GetContext ()).m_currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == EventId::UID::DESTROY)
+    {
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition &partition = FindPartition (id.GetContext ());
+  NS_ABORT_MSG_IF (m_inParallelWindow && &partition != m_currentPartition,
+                   "Remove() of an event of another partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition.m_events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == EventId::UID::DESTROY)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  const Partition &partition = FindPartition (id.GetContext ());
+  NS_ABORT_MSG_IF (m_inParallelWindow && &partition != m_currentPartition,
+                   "IsExpired() of an event of another partition");
+  if (id.PeekEventImpl () == 0
+      || id.GetTs () < partition.m_currentTs
+      || (id.GetTs () == partition.m_currentTs && id.GetUid () <= partition.m_currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentPartition ().m_currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  // In a parallel window, only the events of the calling partition
+  if (m_inParallelWindow)
+    {
+      return m_currentPartition->m_eventCount;
+    }
+  uint64_t count = m_serial->m_eventCount;
+  for (const auto &partition : m_partitions)
+    {
+      count += partition->m_eventCount;
+    }
+  return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-id.h"
+#include "nstime.h"
+#include "system-thread.h"
+#include "worker-pool.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * @ingroup simulator
+ * @brief A conservative parallel simulator, for one machine with many cores.
+ *
+ * The contexts (i.e., the nodes) are grouped in partitions with
+ * SetPartition(); each partition has its own event list, and the
+ * partitions run concurrently on a WorkerPool. The contexts that are not
+ * assigned to a partition, and the events without context, belong to the
+ * serial partition, which runs on the main thread while the other
+ * partitions are stopped.
+ *
+ * The simulation advances in windows. If the next event of the simulation
+ * is at time T, the serial partition first runs its events at T; then the
+ * partitions run, in parallel, their events in [T, W), where W is T plus the
+ * "Lookahead", or the time of the next serial event if it comes first.
+ * After that, on the main thread:
+ *
+ * - the events that a partition scheduled for another partition are
+ *   inserted in the destination event lists;
+ * - the calls deferred with ScheduleAtWindowEnd() are run, with the time
+ *   and the context of their callers.
+ *
+ * Hence an event can be scheduled for a context of another partition only
+ * at a time not earlier than the end of the window, i.e., with a delay
+ * not smaller than the lookahead: the simulation aborts otherwise. The
+ * typical lookahead is the minimum propagation delay between the nodes
+ * of different partitions. Channels that are shared by the partitions,
+ * such as the SpectrumChannel, defer their transmissions with
+ * ScheduleAtWindowEnd(); then the minimum propagation delay between any
+ * two nodes bounds the lookahead.
+ *
+ * The order of the events does not depend on the number of threads, nor on
+ * their timing: each partition runs its events in the (timestamp, uid)
+ * order, and the events exchanged at the end of a window are inserted
+ * in the order of their source partition, and of their scheduling in it.
+ * The packets created by a partition take their uids from a counter of the
+ * partition (see GetPartitionUid()), hence the uids do not depend on the
+ * number of threads either.
+ *
+ * The partitions share the objects that cross them, e.g., the models of a
+ * signal, and the buffers, metadata and tags of its packets, which the
+ * receivers in different partitions copy and release concurrently. Their
+ * reference counts are thread safe only if ns-3 is built with the NS3_MTP
+ * option; otherwise the partitions run on one thread, whatever the
+ * "MaxThreads" attribute. The models must not share other mutable state
+ * between partitions: random variable streams and trace sinks are not
+ * thread safe. Simulator::Remove() and Simulator::Cancel() apply only to
+ * the events of the calling partition. Simulator::Stop() takes effect at
+ * the end of the current window.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  @return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /** The partition of the contexts that are not assigned to any partition. */
+  static const uint32_t SERIAL_PARTITION = 0xffffffff;
+
+  /**
+   * Assign a context (i.e., a node id) to a partition. The partitions
+   * must be assigned before the first call to Run ().
+   *
+   * @param [in] context The context.
+   * @param [in] partition The partition, from 0 to the number of
+   * partitions - 1, or SERIAL_PARTITION.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * @param [in] context The context.
+   * @returns The partition of the context, or SERIAL_PARTITION.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /** @returns The number of partitions, without the serial one. */
+  uint32_t GetNPartitions (void) const;
+
+  /** @returns The minimum delay of the events scheduled across partitions. */
+  Time GetLookahead (void) const;
+  /**
+   * @param [in] lookahead The minimum delay of the events scheduled across
+   * partitions; it must be positive.
+   */
+  void SetLookahead (Time lookahead);
+
+  /**
+   * @returns True if the calling thread is running the events of a
+   * partition, concurrently with the other partitions.
+   */
+  static bool IsInParallelWindow (void);
+  /**
+   * Run an event on the main thread at the end of the current window,
+   * with the current time and context of the caller; only valid if
+   * IsInParallelWindow () is true. The event can schedule events for any
+   * partition, with a delay not smaller than the lookahead.
+   *
+   * @param [in] event The event.
+   */
+  static void ScheduleAtWindowEnd (EventImpl *event);
+  /**
+   * Draw a uid from the counter of the partition of the caller, for the
+   * objects that the models number, such as the packets. The uids of a
+   * partition do not depend on the other partitions, nor on the number
+   * of threads.
+   *
+   * @param [out] uid The uid: the index of the partition plus one in the
+   * bits from 40 up, and the value of the counter in the lower ones.
+   * @returns False, leaving \p uid unchanged, if the caller does not run
+   * the events of a partition (e.g., it runs the serial events, or the
+   * simulator is not a MultithreadedSimulatorImpl).
+   */
+  static bool GetPartitionUid (uint64_t *uid);
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event scheduled for another partition. */
+  struct RemoteEvent
+  {
+    uint32_t m_partition;      //!< The destination partition
+    Scheduler::Event m_event;  //!< The event, without uid
+  };
+
+  /** A call deferred to the end of the window. */
+  struct DeferredEvent
+  {
+    uint64_t m_ts;        //!< Time of the call
+    uint32_t m_context;   //!< Context of the call
+    EventImpl *m_event;   //!< The call
+  };
+
+  /** A partition: an event list and the state of its execution. */
+  struct Partition
+  {
+    uint32_t m_index {SERIAL_PARTITION};   //!< Index of the partition
+    Ptr<Scheduler> m_events;               //!< The event list
+    uint32_t m_uid {EventId::UID::VALID};  //!< Next uid of the events
+    uint32_t m_currentUid {EventId::UID::INVALID}; //!< Uid of the current event
+    uint64_t m_currentTs {0};         //!< Timestamp of the current event
+    uint32_t m_currentContext {0xffffffff}; //!< Context of the current event
+    uint64_t m_eventCount {0};        //!< Number of executed events
+    uint64_t m_objectUid {0};         //!< Counter of GetPartitionUid()
+    std::vector<RemoteEvent> m_outbox;      //!< Events for other partitions
+    std::vector<DeferredEvent> m_deferred;  //!< Calls deferred to the end of the window
+    std::vector<EventImpl *> m_release;     //!< Executed events to release on the main thread
+  };
+
+  /**
+   * @param [in] context The context.
+   * @returns The partition of the context.
+   */
+  Partition & FindPartition (uint32_t context) const;
+  /** @returns The partition of the caller. */
+  Partition & GetCurrentPartition (void) const;
+  /**
+   * Insert an event in the event list of a partition.
+   *
+   * @param [in] partition The partition.
+   * @param [in] event The event, without uid.
+   * @param [in] foreign True if the event comes from another partition.
+   * @returns The event, with its uid.
+   */
+  Scheduler::Event Insert (Partition &partition, Scheduler::Event event, bool foreign);
+  /**
+   * Run the events of a partition before the end of the window.
+   *
+   * @param [in] partition The partition.
+   * @param [in] end The end of the window; all the events before it are run.
+   */
+  void ProcessWindow (Partition &partition, uint64_t end);
+  /** Move the events scheduled before the first Run () to their partitions. */
+  void DistributeEvents (void);
+  /** Exchange the events between the partitions, and run the deferred calls. */
+  void EndWindow (void);
+
+  std::vector<std::unique_ptr<Partition> > m_partitions; //!< The partitions
+  std::unique_ptr<Partition> m_serial;        //!< The serial partition
+  std::vector<uint32_t> m_partitionOfContext; //!< Partition of each context
+  bool m_distributed;                         //!< The events are in their partitions
+  ObjectFactory m_schedulerFactory;           //!< Factory of the event lists
+  uint64_t m_lookahead;                       //!< Lookahead, in time steps
+  uint32_t m_maxThreads;                      //!< Maximum number of threads
+  Ptr<WorkerPool> m_pool;                     //!< The threads of the partitions
+  uint64_t m_windowEnd;                       //!< End of the current window
+  bool m_endingWindow;                        //!< The deferred calls are running
+  std::atomic<bool> m_stop;                   //!< Flag calling for the end of the simulation
+  SystemThread::ThreadId m_main;              //!< Main thread
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  DestroyEvents m_destroyEvents;              //!< The events to run at Destroy
+  mutable std::mutex m_destroyMutex;          //!< Protects m_destroyEvents
+
+  static thread_local Partition *m_currentPartition; //!< Partition run by the thread
+  static thread_local bool m_inParallelWindow;       //!< The thread runs a parallel window
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,329 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timing-wheel-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "abort.h"
+#include "log.h"
+#include <algorithm>
+#include <functional>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::TimingWheelScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimingWheelScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (TimingWheelScheduler);
+
+TypeId
+TimingWheelScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimingWheelScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimingWheelScheduler> ()
+    .AddAttribute ("Granularity",
+                   "The duration of a tick of the wheels. The events of the same "
+                   "tick share a bucket; a good value is the duration of the "
+                   "shortest period of the simulation, e.g., an OFDM symbol.",
+                   TimeValue (MicroSeconds (1)),
+                   MakeTimeAccessor (&TimingWheelScheduler::SetGranularity,
+                                     &TimingWheelScheduler::GetGranularity),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+TimingWheelScheduler::TimingWheelScheduler ()
+  : m_granularity (1),
+    m_curTick (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+  for (auto &wheel : m_wheels)
+    {
+      wheel.m_occupied.fill (0);
+    }
+}
+
+TimingWheelScheduler::~TimingWheelScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TimingWheelScheduler::SetGranularity (Time granularity)
+{
+  NS_LOG_FUNCTION (this << granularity);
+  NS_ABORT_MSG_UNLESS (m_size == 0, "The granularity cannot be changed with events scheduled");
+  NS_ASSERT (granularity.IsStrictlyPositive ());
+  m_granularity = static_cast<uint64_t> (granularity.GetTimeStep ());
+  m_curTick = 0;
+}
+
+Time
+TimingWheelScheduler::GetGranularity (void) const
+{
+  return TimeStep (m_granularity);
+}
+
+uint64_t
+TimingWheelScheduler::GetTick (const Scheduler::Event &ev) const
+{
+  return ev.key.m_ts / m_granularity;
+}
+
+uint32_t
+TimingWheelScheduler::GetLevel (uint64_t tick) const
+{
+  // The level is given by the most significant byte that differs
+  // from the current tick.
+  uint64_t diff = (tick ^ m_curTick) >> BITS;
+  uint32_t level = 0;
+  while (diff != 0 && level < LEVELS)
+    {
+      diff >>= BITS;
+      ++level;
+    }
+  return level;
+}
+
+void
+TimingWheelScheduler::Place (const Scheduler::Event &ev)
+{
+  uint64_t tick = GetTick (ev);
+  if (tick <= m_curTick)
+    {
+      m_current.push_back (ev);
+      std::push_heap (m_current.begin (), m_current.end (), std::greater<Scheduler::Event> ());
+      return;
+    }
+  uint32_t level = GetLevel (tick);
+  if (level == LEVELS)
+    {
+      m_overflow.push_back (ev);
+      std::push_heap (m_overflow.begin (), m_overflow.end (), std::greater<Scheduler::Event> ());
+      return;
+    }
+  uint32_t index = (tick >> (level * BITS)) & (BUCKETS - 1);
+  Wheel &wheel = m_wheels[level];
+  wheel.m_buckets[index].push_back (ev);
+  wheel.m_occupied[index / 64] |= uint64_t (1) << (index % 64);
+}
+
+uint32_t
+TimingWheelScheduler::FindNextBucket (uint32_t level) const
+{
+  // The events of a wheel are always after the current tick, hence in
+  // the buckets after the one of the current tick.
+  uint32_t start = ((m_curTick >> (level * BITS)) & (BUCKETS - 1)) + 1;
+  if (start >= BUCKETS)
+    {
+      return BUCKETS;
+    }
+  const Wheel &wheel = m_wheels[level];
+  uint32_t word = start / 64;
+  uint64_t bits = wheel.m_occupied[word] & (~uint64_t (0) << (start % 64));
+  while (bits == 0)
+    {
+      if (++word == BUCKETS / 64)
+        {
+          return BUCKETS;
+        }
+      bits = wheel.m_occupied[word];
+    }
+  return word * 64 + static_cast<uint32_t> (__builtin_ctzll (bits));
+}
+
+void
+TimingWheelScheduler::Advance (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_current.empty () && m_size > 0);
+
+  while (m_current.empty ())
+    {
+      uint32_t level = 0;
+      uint32_t index = BUCKETS;
+      while (level < LEVELS && (index = FindNextBucket (level)) == BUCKETS)
+        {
+          ++level;
+        }
+
+      if (level == LEVELS)
+        {
+          // The wheels are empty: restart them from the first event of
+          // the overflow heap, and bring in the events that now fit.
+          NS_ASSERT (!m_overflow.empty ());
+          m_curTick = GetTick (m_overflow.front ());
+          NS_LOG_LOGIC ("restart the wheels at tick " << m_curTick);
+          while (!m_overflow.empty () && GetLevel (GetTick (m_overflow.front ())) < LEVELS)
+            {
+              std::pop_heap (m_overflow.begin (), m_overflow.end (), std::greater<Scheduler::Event> ());
+              Place (m_overflow.back ());
+              m_overflow.pop_back ();
+            }
+          continue;
+        }
+
+      // Move to the first tick of the bucket, and redistribute its events:
+      // with level 0 they all fall in the current heap, otherwise they
+      // spread on the lower wheels (and maybe the current heap).
+      uint32_t shift = level * BITS;
+      uint64_t high = m_curTick >> shift >> BITS << BITS;
+      m_curTick = (high | index) << shift;
+      NS_LOG_LOGIC ("move to tick " << m_curTick << " from level " << level);
+
+      Wheel &wheel = m_wheels[level];
+      wheel.m_occupied[index / 64] &= ~(uint64_t (1) << (index % 64));
+      Bucket events;
+      events.swap (wheel.m_buckets[index]);
+      if (level == 0)
+        {
+          m_current.swap (events);
+          std::make_heap (m_current.begin (), m_current.end (), std::greater<Scheduler::Event> ());
+        }
+      else
+        {
+          for (const auto &ev : events)
+            {
+              Place (ev);
+            }
+        }
+      // Give back the storage, so that the bucket does not allocate again
+      events.clear ();
+      events.swap (wheel.m_buckets[index]);
+    }
+}
+
+void
+TimingWheelScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  Place (ev);
+  ++m_size;
+}
+
+bool
+TimingWheelScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_size == 0;
+}
+
+Scheduler::Event
+TimingWheelScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_size > 0);
+  if (!m_current.empty ())
+    {
+      return m_current.front ();
+    }
+  // The events of the lower wheels are before the ones of the upper
+  // wheels, and the events of a bucket before the ones of the next buckets.
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      uint32_t index = FindNextBucket (level);
+      if (index != BUCKETS)
+        {
+          const Bucket &bucket = m_wheels[level].m_buckets[index];
+          return *std::min_element (bucket.begin (), bucket.end ());
+        }
+    }
+  return m_overflow.front ();
+}
+
+Scheduler::Event
+TimingWheelScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_size > 0);
+  if (m_current.empty ())
+    {
+      Advance ();
+    }
+  std::pop_heap (m_current.begin (), m_current.end (), std::greater<Scheduler::Event> ());
+  Scheduler::Event ev = m_current.back ();
+  m_current.pop_back ();
+  --m_size;
+  return ev;
+}
+
+bool
+TimingWheelScheduler::RemoveFromHeap (std::vector<Scheduler::Event> *heap,
+                                      const Scheduler::Event &ev)
+{
+  auto it = std::find (heap->begin (), heap->end (), ev);
+  if (it == heap->end ())
+    {
+      return false;
+    }
+  heap->erase (it);
+  std::make_heap (heap->begin (), heap->end (), std::greater<Scheduler::Event> ());
+  return true;
+}
+
+void
+TimingWheelScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  // An event stays where Place () would put it now, as moving the
+  // current tick only moves the events of the buckets it enters.
+  bool found;
+  uint64_t tick = GetTick (ev);
+  uint32_t level = GetLevel (tick);
+  if (tick <= m_curTick)
+    {
+      found = RemoveFromHeap (&m_current, ev);
+    }
+  else if (level == LEVELS)
+    {
+      found = RemoveFromHeap (&m_overflow, ev);
+    }
+  else
+    {
+      uint32_t index = (tick >> (level * BITS)) & (BUCKETS - 1);
+      Wheel &wheel = m_wheels[level];
+      Bucket &bucket = wheel.m_buckets[index];
+      auto it = std::find (bucket.begin (), bucket.end (), ev);
+      found = it != bucket.end ();
+      if (found)
+        {
+          *it = bucket.back ();
+          bucket.pop_back ();
+          if (bucket.empty ())
+            {
+              wheel.m_occupied[index / 64] &= ~(uint64_t (1) << (index % 64));
+            }
+        }
+    }
+  NS_ASSERT_MSG (found, "Event " << ev.key.m_uid << " not found");
+  if (found)
+    {
+      --m_size;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMING_WHEEL_SCHEDULER_H
+#define TIMING_WHEEL_SCHEDULER_H
+
+#include "scheduler.h"
+#include "nstime.h"
+#include <array>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::TimingWheelScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a hierarchical timing wheel event scheduler
+ *
+ * The time is divided in ticks of a configurable duration (the
+ * "Granularity" attribute). The events of the current tick are kept in a
+ * binary heap, so that they are returned in the strict (timestamp, uid)
+ * order. The events of the future ticks are kept in four wheels of 256
+ * buckets each: the wheel of level L stores the events whose tick differs
+ * from the current one first in the L-th byte, in the bucket given by that
+ * byte. When the current tick is exhausted, the next non-empty bucket of
+ * the lowest non-empty wheel becomes the current tick (level 0), or is
+ * redistributed to the lower wheels (levels 1 to 3). The events that are
+ * more than 2^32 ticks in the future are kept in an overflow heap.
+ *
+ * The scheduler fits the slotted simulations, where most events are
+ * scheduled a few symbols or slots ahead: with the granularity set to
+ * the duration of an OFDM symbol, the events of a symbol share a bucket,
+ * and inserting or removing them does not depend on the number of
+ * events scheduled further in the future. To try it on an existing
+ * program, pass
+ *
+ *     --SchedulerType=ns3::TimingWheelScheduler
+ *     --ns3::TimingWheelScheduler::Granularity=8.9us
+ *
+ * on its command line, and compare the run time with the other schedulers;
+ * `utils/bench-simulator --wheel` gives the same comparison on a synthetic
+ * event population.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time  | Reason
+ * :----------- | :--------------- | :-----
+ * Insert()     | Constant         | Append to a bucket (or `std::push_heap()` in the current tick)
+ * IsEmpty()    | Constant         | Event counter
+ * PeekNext()   | Constant         | `std::vector::front()` (scan of the next bucket if the current tick is empty)
+ * Remove()     | Linear           | `std::find()` in the bucket or in the heap
+ * RemoveNext() | Constant         | `std::pop_heap()` on the events of a tick, and one move per level
+ *
+ * The costs are constant with respect to the total number of events: the
+ * heap operations depend only on the number of events of the same tick,
+ * and the events farther than 2^32 ticks use the overflow heap.
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                              | Reason
+ * :-------- | :---------------------------------- | :-----
+ * Overhead  | 4 x 256 x `std::vector`<br/>(24 kB) | Buckets of the wheels
+ * Per Event | 0                                   | Events stored in `std::vector` directly
+ *
+ */
+class TimingWheelScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  TimingWheelScheduler ();
+  /** Destructor. */
+  virtual ~TimingWheelScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Number of wheels. */
+  static const uint32_t LEVELS = 4;
+  /** Number of bits of the tick indexed by each wheel. */
+  static const uint32_t BITS = 8;
+  /** Number of buckets of each wheel. */
+  static const uint32_t BUCKETS = 1 << BITS;
+
+  /** A bucket: the events of a tick, or of a range of ticks. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A wheel: the buckets of a level, and the bitmap of the non-empty ones. */
+  struct Wheel
+  {
+    std::array<Bucket, BUCKETS> m_buckets;          //!< The buckets
+    std::array<uint64_t, BUCKETS / 64> m_occupied;  //!< Bit i set if bucket i is not empty
+  };
+
+  /**
+   * Set the duration of a tick.
+   *
+   * \param [in] granularity The duration of a tick.
+   */
+  void SetGranularity (Time granularity);
+  /**
+   * Get the duration of a tick.
+   *
+   * \return The duration of a tick.
+   */
+  Time GetGranularity (void) const;
+
+  /**
+   * \param [in] ev The event.
+   * \return The tick of the event.
+   */
+  uint64_t GetTick (const Scheduler::Event &ev) const;
+  /**
+   * Find the level of the wheel that stores a future event.
+   *
+   * \param [in] tick The tick of the event, after the current tick.
+   * \return The level, or LEVELS if the event goes in the overflow heap.
+   */
+  uint32_t GetLevel (uint64_t tick) const;
+  /**
+   * Store an event in the current heap, in a wheel, or in the overflow heap.
+   *
+   * \param [in] ev The event.
+   */
+  void Place (const Scheduler::Event &ev);
+  /**
+   * Find the first non-empty bucket of a wheel after the bucket of the
+   * current tick.
+   *
+   * \param [in] level The level of the wheel.
+   * \return The index of the bucket, or BUCKETS if there is none.
+   */
+  uint32_t FindNextBucket (uint32_t level) const;
+  /**
+   * Move the current tick to the next tick with events, and move these
+   * events to the current heap. There must be at least one event, and
+   * the current heap must be empty.
+   */
+  void Advance (void);
+  /**
+   * Remove an event from a heap.
+   *
+   * \param [in,out] heap The heap.
+   * \param [in] ev The event.
+   * \return \c true if the event was found.
+   */
+  static bool RemoveFromHeap (std::vector<Scheduler::Event> *heap, const Scheduler::Event &ev);
+
+  uint64_t m_granularity;             //!< Duration of a tick, in time steps
+  uint64_t m_curTick;                 //!< The current tick
+  uint32_t m_size;                    //!< Number of events
+  std::vector<Scheduler::Event> m_current;  //!< Heap of the events of the current (or of a past) tick
+  std::vector<Scheduler::Event> m_overflow; //!< Heap of the events beyond the wheels
+  std::array<Wheel, LEVELS> m_wheels; //!< The wheels
+
+};  // class TimingWheelScheduler
+
+} // namespace ns3
+
+#endif /* TIMING_WHEEL_SCHEDULER_H */
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef VAL_ARRAY_H
+#define VAL_ARRAY_H
+
+#include "assert.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup core
+ * ns3::ValArray declaration and implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * @ingroup core
+ * @brief A 3D array (rows x columns x pages) stored in one contiguous block.
+ *
+ * The values are stored in column-major order, page after page: the element
+ * (r, c, p) is at index r + numRows * (c + numCols * p). Hence the elements of
+ * a column are contiguous, and so are the columns of a page; a page is a
+ * matrix that can be accessed through GetPagePtr ().
+ *
+ * A 1D or 2D array is a ValArray with a single page (and a single column).
+ * Compared to nested std::vector, the array needs a single allocation and
+ * no per-row headers, and the elements that are read together by the loops
+ * over the first index are adjacent in memory.
+ *
+ * @tparam T The type of the elements, e.g., double or std::complex<float>.
+ */
+template <class T>
+class ValArray
+{
+public:
+  /** Create an empty array. */
+  ValArray () = default;
+
+  /**
+   * Create an array.
+   *
+   * @param [in] numRows The number of rows.
+   * @param [in] numCols The number of columns.
+   * @param [in] numPages The number of pages.
+   * @param [in] value The initial value of the elements.
+   */
+  ValArray (std::size_t numRows, std::size_t numCols = 1, std::size_t numPages = 1,
+            const T &value = T ())
+    : m_numRows (numRows),
+      m_numCols (numCols),
+      m_numPages (numPages),
+      m_values (numRows * numCols * numPages, value)
+  {}
+
+  /** @returns The number of rows. */
+  std::size_t GetNumRows (void) const
+  {
+    return m_numRows;
+  }
+
+  /** @returns The number of columns. */
+  std::size_t GetNumCols (void) const
+  {
+    return m_numCols;
+  }
+
+  /** @returns The number of pages. */
+  std::size_t GetNumPages (void) const
+  {
+    return m_numPages;
+  }
+
+  /** @returns The total number of elements. */
+  std::size_t GetSize (void) const
+  {
+    return m_values.size ();
+  }
+
+  /** @returns The number of bytes used by the elements. */
+  std::size_t GetSizeInBytes (void) const
+  {
+    return m_values.size () * sizeof (T);
+  }
+
+  /**
+   * Access an element.
+   *
+   * @param [in] rowIndex The row index.
+   * @param [in] colIndex The column index.
+   * @param [in] pageIndex The page index.
+   * @returns A reference to the element.
+   */
+  T & operator () (std::size_t rowIndex, std::size_t colIndex, std::size_t pageIndex = 0)
+  {
+    return m_values[Index (rowIndex, colIndex, pageIndex)];
+  }
+
+  /**
+   * Access an element.
+   *
+   * @param [in] rowIndex The row index.
+   * @param [in] colIndex The column index.
+   * @param [in] pageIndex The page index.
+   * @returns A const reference to the element.
+   */
+  const T & operator () (std::size_t rowIndex, std::size_t colIndex, std::size_t pageIndex = 0) const
+  {
+    return m_values[Index (rowIndex, colIndex, pageIndex)];
+  }
+
+  /**
+   * Access an element by its index in the storage order.
+   *
+   * @param [in] index The index.
+   * @returns A reference to the element.
+   */
+  T & operator [] (std::size_t index)
+  {
+    NS_ASSERT (index < m_values.size ());
+    return m_values[index];
+  }
+
+  /**
+   * Access an element by its index in the storage order.
+   *
+   * @param [in] index The index.
+   * @returns A const reference to the element.
+   */
+  const T & operator [] (std::size_t index) const
+  {
+    NS_ASSERT (index < m_values.size ());
+    return m_values[index];
+  }
+
+  /**
+   * @param [in] pageIndex The page index.
+   * @returns A pointer to the first element of the page; the element
+   * (r, c) of the page is at offset r + numRows * c.
+   */
+  T * GetPagePtr (std::size_t pageIndex)
+  {
+    NS_ASSERT (pageIndex < m_numPages);
+    return m_values.data () + m_numRows * m_numCols * pageIndex;
+  }
+
+  /**
+   * @param [in] pageIndex The page index.
+   * @returns A const pointer to the first element of the page; the element
+   * (r, c) of the page is at offset r + numRows * c.
+   */
+  const T * GetPagePtr (std::size_t pageIndex) const
+  {
+    NS_ASSERT (pageIndex < m_numPages);
+    return m_values.data () + m_numRows * m_numCols * pageIndex;
+  }
+
+  /** @returns The elements, in the storage order. */
+  const std::vector<T> & GetValues (void) const
+  {
+    return m_values;
+  }
+
+  /**
+   * @param [in] rhs The other array.
+   * @returns True if the arrays have the same shape and elements.
+   */
+  bool operator == (const ValArray<T> &rhs) const
+  {
+    return m_numRows == rhs.m_numRows && m_numCols == rhs.m_numCols
+           && m_numPages == rhs.m_numPages && m_values == rhs.m_values;
+  }
+
+  /**
+   * @param [in] rhs The other array.
+   * @returns True if the arrays differ in shape or in any element.
+   */
+  bool operator != (const ValArray<T> &rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+private:
+  /**
+   * @param [in] rowIndex The row index.
+   * @param [in] colIndex The column index.
+   * @param [in] pageIndex The page index.
+   * @returns The index of the element in m_values.
+   */
+  std::size_t Index (std::size_t rowIndex, std::size_t colIndex, std::size_t pageIndex) const
+  {
+    NS_ASSERT_MSG (rowIndex < m_numRows && colIndex < m_numCols && pageIndex < m_numPages,
+                   "Index (" << rowIndex << ", " << colIndex << ", " << pageIndex
+                   << ") out of the array of size (" << m_numRows << ", " << m_numCols
+                   << ", " << m_numPages << ")");
+    return rowIndex + m_numRows * (colIndex + m_numCols * pageIndex);
+  }
+
+  std::size_t m_numRows {0};  //!< Number of rows
+  std::size_t m_numCols {0};  //!< Number of columns
+  std::size_t m_numPages {0}; //!< Number of pages
+  std::vector<T> m_values;    //!< The elements, in column-major order
+};
+
+} // namespace ns3
+
+#endif /* VAL_ARRAY_H */
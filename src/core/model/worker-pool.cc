@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "worker-pool.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::WorkerPool implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WorkerPool");
+
+WorkerPool::WorkerPool (uint32_t numThreads)
+{
+  NS_LOG_FUNCTION (this << numThreads);
+  NS_ASSERT_MSG (numThreads > 0, "A pool needs at least one thread");
+  for (uint32_t i = 1; i < numThreads; ++i)
+    {
+      m_workers.emplace_back (&WorkerPool::Work, this);
+    }
+}
+
+WorkerPool::~WorkerPool ()
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_startCv.notify_all ();
+  for (auto &worker : m_workers)
+    {
+      worker.join ();
+    }
+}
+
+uint32_t
+WorkerPool::GetNumThreads (void) const
+{
+  return static_cast<uint32_t> (m_workers.size ()) + 1;
+}
+
+void
+WorkerPool::Run (std::size_t numTasks, const Task &task)
+{
+  NS_LOG_FUNCTION (this << numTasks);
+
+  if (m_workers.empty () || numTasks <= 1)
+    {
+      for (std::size_t i = 0; i < numTasks; ++i)
+        {
+          task (i);
+        }
+      return;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_task = &task;
+    m_numTasks = numTasks;
+    m_nextTask = 0;
+    m_busyWorkers = static_cast<uint32_t> (m_workers.size ());
+    ++m_batch;
+  }
+  m_startCv.notify_all ();
+
+  RunTasks ();
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_doneCv.wait (lock, [this] { return m_busyWorkers == 0; });
+  m_task = nullptr;
+}
+
+void
+WorkerPool::Work (void)
+{
+  uint64_t batch = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_startCv.wait (lock, [this, batch] { return m_stop || m_batch != batch; });
+        if (m_stop)
+          {
+            return;
+          }
+        batch = m_batch;
+      }
+
+      RunTasks ();
+
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        if (--m_busyWorkers == 0)
+          {
+            m_doneCv.notify_one ();
+          }
+      }
+    }
+}
+
+void
+WorkerPool::RunTasks (void)
+{
+  std::size_t i;
+  while ((i = m_nextTask.fetch_add (1)) < m_numTasks)
+    {
+      (*m_task) (i);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "simple-ref-count.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::WorkerPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * @ingroup thread
+ * @brief A fixed set of threads that run batches of independent tasks.
+ *
+ * Run() executes the tasks 0 ... n-1 of a batch on the workers and on the
+ * calling thread, and returns when all of them are done. The tasks of a batch
+ * can run in any order and concurrently: they must not touch any state that
+ * another task (or the simulator) uses, including the reference counts of
+ * shared objects, as Ptr is not thread safe. A task must not call Run().
+ *
+ * The pool is meant to be used from the simulation thread, to spread
+ * computations that are independent per node or per link; the results are
+ * then consumed in a deterministic order by the caller.
+ */
+class WorkerPool : public SimpleRefCount<WorkerPool>
+{
+public:
+  /** A task of a batch; the argument is the index of the task. */
+  typedef std::function<void (std::size_t)> Task;
+
+  /**
+   * Create the pool.
+   *
+   * @param [in] numThreads The number of threads that run the tasks,
+   * including the calling thread: numThreads - 1 workers are started.
+   */
+  WorkerPool (uint32_t numThreads);
+
+  /** Destructor: stops and joins the workers. */
+  ~WorkerPool ();
+
+  // Delete copy constructor and assignment operator to avoid misuse
+  WorkerPool (const WorkerPool &) = delete;
+  WorkerPool & operator = (const WorkerPool &) = delete;
+
+  /**
+   * @returns The number of threads that run the tasks, including the
+   * calling thread.
+   */
+  uint32_t GetNumThreads (void) const;
+
+  /**
+   * Run a batch of tasks, and wait for its completion.
+   *
+   * @param [in] numTasks The number of tasks.
+   * @param [in] task The task, called once for each index in [0, numTasks).
+   */
+  void Run (std::size_t numTasks, const Task &task);
+
+private:
+  /** Main loop of a worker. */
+  void Work (void);
+  /** Run the tasks of the current batch that are not taken yet. */
+  void RunTasks (void);
+
+  std::vector<std::thread> m_workers;   //!< The worker threads
+  std::mutex m_mutex;                   //!< Protects the batch state below
+  std::condition_variable m_startCv;    //!< Signals a new batch, or the stop
+  std::condition_variable m_doneCv;     //!< Signals the end of a batch
+  const Task *m_task {nullptr};         //!< Task of the current batch
+  std::size_t m_numTasks {0};           //!< Number of tasks of the current batch
+  std::atomic<std::size_t> m_nextTask {0}; //!< Index of the next task to run
+  uint64_t m_batch {0};                 //!< Counter of the batches
+  uint32_t m_busyWorkers {0};           //!< Workers still in the current batch
+  bool m_stop {false};                  //!< True when the workers must exit
+};
+
+} // namespace ns3
+
+#endif /* WORKER_POOL_H */
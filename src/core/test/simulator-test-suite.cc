@@ -24,6 +24,10 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/timing-wheel-scheduler.h"
+#include "ns3/nstime.h"
+#include <algorithm>
+#include <set>
 
 using namespace ns3;
 
@@ -531,6 +535,137 @@ SimulatorTemplateTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the order of the events in the TimingWheelScheduler.
+ *
+ * The events are spread on all the wheels and on the overflow heap, some
+ * of them share a tick and a timestamp, and some are removed before they
+ * expire. The events must come out in the same order as from a std::set.
+ */
+class TimingWheelSchedulerTestCase : public TestCase
+{
+public:
+  TimingWheelSchedulerTestCase ();
+  virtual void DoRun (void);
+};
+
+TimingWheelSchedulerTestCase::TimingWheelSchedulerTestCase ()
+  : TestCase ("Check the order of the events in the TimingWheelScheduler")
+{}
+
+void
+TimingWheelSchedulerTestCase::DoRun (void)
+{
+  Ptr<TimingWheelScheduler> scheduler = CreateObject<TimingWheelScheduler> ();
+  scheduler->SetAttribute ("Granularity", TimeValue (TimeStep (10)));
+  std::set<Scheduler::Event> expected;
+
+  // Linear congruential generator, to get the same events on every platform
+  uint64_t state = 12345;
+  auto next = [&state] ()
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      return state >> 16;
+    };
+
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  for (uint32_t i = 0; i < 20000; ++i)
+    {
+      uint32_t op = next () % 8;
+      if (op < 4)
+        {
+          // From the same tick to beyond the wheels (2^32 ticks)
+          static const uint64_t ranges[] = {20, 3000, 1000000, 1ULL << 40};
+          Scheduler::Event ev;
+          ev.impl = nullptr;
+          ev.key.m_ts = now + next () % ranges[op];
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          expected.insert (ev);
+        }
+      else if (op < 7 && !expected.empty ())
+        {
+          Scheduler::Event ev = scheduler->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.begin ()->key.m_uid, "Wrong event order");
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_ts, expected.begin ()->key.m_ts, "Wrong event time");
+          now = ev.key.m_ts;
+          expected.erase (expected.begin ());
+        }
+      else if (!expected.empty ())
+        {
+          auto it = expected.begin ();
+          std::advance (it, next () % std::min<std::size_t> (expected.size (), 100));
+          scheduler->Remove (*it);
+          expected.erase (it);
+        }
+      if (!expected.empty ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, expected.begin ()->key.m_uid,
+                                 "Wrong next event");
+        }
+    }
+  while (!expected.empty ())
+    {
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.begin ()->key.m_uid, "Wrong event order");
+      expected.erase (expected.begin ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "Events left in the scheduler");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the events reuse the memory of the expired ones.
+ */
+class EventAllocationTestCase : public TestCase
+{
+public:
+  EventAllocationTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Schedule the next event of the chain, and a cancelled one.
+   * \param count The number of events left.
+   */
+  void Chain (uint32_t count);
+};
+
+EventAllocationTestCase::EventAllocationTestCase ()
+  : TestCase ("Check that the events reuse the memory of the expired ones")
+{}
+
+void
+EventAllocationTestCase::Chain (uint32_t count)
+{
+  if (count > 0)
+    {
+      Simulator::Schedule (NanoSeconds (10), &EventAllocationTestCase::Chain, this, count - 1);
+      EventId ev = Simulator::Schedule (NanoSeconds (5), &EventAllocationTestCase::Chain, this, 0);
+      ev.Cancel ();
+    }
+}
+
+void
+EventAllocationTestCase::DoRun (void)
+{
+  EventImpl::AllocationStats before = EventImpl::GetAllocationStats ();
+  Simulator::Schedule (NanoSeconds (10), &EventAllocationTestCase::Chain, this, 1000);
+  Simulator::Run ();
+  EventImpl::AllocationStats after = EventImpl::GetAllocationStats ();
+  Simulator::Destroy ();
+
+  uint64_t allocations = after.m_allocations - before.m_allocations;
+  uint64_t heapAllocations = after.m_heapAllocations - before.m_heapAllocations;
+  NS_TEST_ASSERT_MSG_EQ (allocations, 2001, "Wrong number of event allocations");
+  NS_TEST_ASSERT_MSG_LT (heapAllocations, 10, "The events do not reuse the expired ones");
+}
+
 /**
  * \ingroup simulator-tests
  *  
@@ -554,6 +689,10 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (TimingWheelScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new TimingWheelSchedulerTestCase (), TestCase::QUICK);
+    AddTestCase (new EventAllocationTestCase (), TestCase::QUICK);
   }
 };
 
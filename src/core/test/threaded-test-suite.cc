@@ -26,12 +26,19 @@
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <chrono>  // seconds, milliseconds
 #include <ctime>
 #include <list>
+#include <tuple>
 #include <thread>  // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -276,6 +283,203 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that the MpscQueue keeps the values of every producer in
+ * order, while the consumer drains them concurrently.
+ */
+class MpscQueueTestCase : public TestCase
+{
+public:
+  MpscQueueTestCase ();
+  virtual void DoRun (void);
+};
+
+MpscQueueTestCase::MpscQueueTestCase ()
+  : TestCase ("Check the order of the values of the MpscQueue with concurrent producers")
+{}
+
+void
+MpscQueueTestCase::DoRun (void)
+{
+  const uint32_t numProducers = 4;
+  const uint32_t numValues = 20000;
+  MpscQueue<std::pair<uint32_t, uint32_t> > queue;
+
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < numProducers; ++p)
+    {
+      producers.emplace_back ([&queue, p, numValues] ()
+        {
+          for (uint32_t i = 0; i < numValues; ++i)
+            {
+              queue.Push (std::make_pair (p, i));
+            }
+        });
+    }
+
+  std::vector<uint32_t> next (numProducers, 0);
+  bool ordered = true;
+  std::size_t total = 0;
+  auto consume = [&next, &ordered] (const std::pair<uint32_t, uint32_t> &value)
+    {
+      ordered = ordered && value.second == next[value.first];
+      next[value.first] = value.second + 1;
+    };
+  while (total < numProducers * numValues)
+    {
+      total += queue.Drain (consume);
+    }
+  for (auto &producer : producers)
+    {
+      producer.join ();
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "The values of a producer are out of order");
+  NS_TEST_EXPECT_MSG_EQ (total, numProducers * numValues, "Wrong number of values");
+  NS_TEST_EXPECT_MSG_EQ (queue.IsEmpty (), true, "The queue is not empty");
+}
+
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that the MultithreadedSimulatorImpl runs the same events,
+ * in the same order, with any number of threads, and the same events
+ * as the DefaultSimulatorImpl.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// An executed event: time, context, sender and remaining hops.
+  typedef std::tuple<int64_t, uint32_t, uint32_t, uint32_t> Record;
+
+  /**
+   * Run the simulation.
+   * \param [in] simulatorType The simulator implementation.
+   * \param [in] threads The maximum number of threads.
+   */
+  void RunSimulation (const std::string &simulatorType, uint32_t threads);
+  /**
+   * Record a message, and forward it to a node of another partition
+   * and to the same node.
+   * \param [in] from The sender.
+   * \param [in] hops The remaining hops.
+   */
+  void Receive (uint32_t from, uint32_t hops);
+  /**
+   * Called at the end of the window: record the call, and send a
+   * message to the next node.
+   * \param [in] from The caller.
+   */
+  void Deferred (uint32_t from);
+
+  static const uint32_t NODES = 9;       //!< The nodes; the last one is serial
+  static const uint32_t PARTITIONS = 4;  //!< The partitions
+  Time m_lookahead;                      //!< The lookahead
+  std::vector<std::vector<Record> > m_logs; //!< The events of each node
+  std::vector<Record> m_deferred;        //!< The calls at the end of the windows
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase ()
+  : TestCase ("Check the determinism of the MultithreadedSimulatorImpl"),
+    m_lookahead (NanoSeconds (10))
+{}
+
+void
+MultithreadedSimulatorTestCase::Receive (uint32_t from, uint32_t hops)
+{
+  uint32_t node = Simulator::GetContext ();
+  m_logs[node].emplace_back (Simulator::Now ().GetTimeStep (), node, from, hops);
+  if (hops == 0)
+    {
+      return;
+    }
+  Simulator::ScheduleWithContext ((node + 3) % NODES,
+                                  m_lookahead + NanoSeconds ((node * 7 + hops) % 5),
+                                  &MultithreadedSimulatorTestCase::Receive, this, node, hops - 1);
+  Simulator::Schedule (NanoSeconds (hops % 3),
+                       &MultithreadedSimulatorTestCase::Receive, this, node, hops - 1);
+  if (hops % 4 == 0)
+    {
+      if (MultithreadedSimulatorImpl::IsInParallelWindow ())
+        {
+          MultithreadedSimulatorImpl::ScheduleAtWindowEnd (
+            MakeEvent (&MultithreadedSimulatorTestCase::Deferred, this, node));
+        }
+      else
+        {
+          Deferred (node);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Deferred (uint32_t from)
+{
+  m_deferred.emplace_back (Simulator::Now ().GetTimeStep (), Simulator::GetContext (), from, 0);
+  Simulator::ScheduleWithContext ((from + 1) % NODES, m_lookahead,
+                                  &MultithreadedSimulatorTestCase::Receive, this, from, 1);
+}
+
+void
+MultithreadedSimulatorTestCase::RunSimulation (const std::string &simulatorType, uint32_t threads)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (threads));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (m_lookahead));
+  m_logs.assign (NODES, std::vector<Record> ());
+  m_deferred.clear ();
+
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  for (uint32_t node = 0; impl != 0 && node < NODES - 1; ++node)
+    {
+      impl->SetPartition (node, node % PARTITIONS);
+    }
+  for (uint32_t node = 0; node < NODES; ++node)
+    {
+      Simulator::ScheduleWithContext (node, NanoSeconds (node),
+                                      &MultithreadedSimulatorTestCase::Receive, this, node, 9);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  RunSimulation ("ns3::MultithreadedSimulatorImpl", 1);
+  std::vector<std::vector<Record> > logs = m_logs;
+  std::vector<Record> deferred = m_deferred;
+  NS_TEST_ASSERT_MSG_GT (deferred.size (), std::size_t (0), "No call at the end of the windows");
+
+  for (uint32_t threads : {2, 4})
+    {
+      RunSimulation ("ns3::MultithreadedSimulatorImpl", threads);
+      NS_TEST_EXPECT_MSG_EQ ((m_logs == logs), true,
+                             "Different events with " << threads << " threads");
+      NS_TEST_EXPECT_MSG_EQ ((m_deferred == deferred), true,
+                             "Different calls at the end of the windows with " << threads << " threads");
+    }
+
+  // The sequential simulator runs the same events at the same times,
+  // though maybe in another order at the same time
+  RunSimulation ("ns3::DefaultSimulatorImpl", 1);
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  for (uint32_t node = 0; node < NODES; ++node)
+    {
+      std::sort (logs[node].begin (), logs[node].end ());
+      std::sort (m_logs[node].begin (), m_logs[node].end ());
+      NS_TEST_EXPECT_MSG_EQ ((m_logs[node] == logs[node]), true,
+                             "Different events of node " << node << " with the DefaultSimulatorImpl");
+    }
+}
+
 /**
  * \ingroup threaded-tests
  *  
@@ -297,7 +501,8 @@ public:
       "ns3::ListScheduler",
       "ns3::HeapScheduler",
       "ns3::MapScheduler",
-      "ns3::CalendarScheduler"
+      "ns3::CalendarScheduler",
+      "ns3::TimingWheelScheduler"
     };
     unsigned int threadcounts[] = {
       0,
@@ -318,6 +523,8 @@ public:
               }
           }
       }
+    AddTestCase (new MpscQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (), TestCase::QUICK);
   }
 };
 
@@ -23,6 +23,9 @@
 #include <stdint.h>
 #include <vector>
 #include <ostream>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "ns3/assert.h"
 
 #define BUFFER_FREE_LIST 1
@@ -656,6 +659,9 @@ private:
    * New user data can be safely written only outside of the "dirty
    * area" if the reference count is higher than 1 (that is, if
    * more than one Buffer instance references the same BufferData).
+   * With the NS3_MTP build option, the Buffer instances may belong to
+   * different threads: the reference count is atomic, and no data is
+   * written in a BufferData referenced by more than one Buffer.
    */
   struct Data
   {
@@ -663,7 +669,11 @@ private:
      * The reference count of an instance of this data structure.
      * Each buffer which references an instance holds a count.
      */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /**
      * the size of the m_data field below.
      */
@@ -767,7 +777,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static thread_local uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -798,9 +808,9 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList *g_freeList; //!< Buffer data container
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
 
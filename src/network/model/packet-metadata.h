@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#include <atomic>
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
@@ -412,8 +413,16 @@ private:
    * Data structure
    */
   struct Data {
-    /** number of references to this struct Data instance. */
+    /**
+     * number of references to this struct Data instance; atomic with the
+     * NS3_MTP build option, as the references may belong to different
+     * threads, which then never append items to a shared instance.
+     */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /** size (in bytes) of m_data buffer below */
     uint16_t m_size;
     /** max of the m_used field over all objects which
@@ -661,7 +670,19 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
+  /**
+   * \returns True if the items can be appended to m_data in place, i.e.,
+   * if no other PacketMetadata uses its bytes after m_used.
+   */
+  inline bool IsAppendable (void) const;
+
+  /*
+   * The free list and the maximum size are per thread, as those of Buffer,
+   * so that the threads of a MultithreadedSimulatorImpl can create
+   * packets concurrently.
+   */
+  static thread_local DataFreeList m_freeList; //!< the metadata data storage
+  static thread_local bool m_freeListDestroyed; //!< m_freeList was destroyed
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -670,9 +691,9 @@ public:
    * m_enable is false; used to detect enabling of metadata in the
    * middle of a simulation, which isn't allowed.
    */
-  static bool m_metadataSkipped;
+  static std::atomic<bool> m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
+  static thread_local uint32_t m_maxSize; //!< maximum metadata size
   static uint16_t m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
@@ -722,8 +743,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0)
         {
           PacketMetadata::Recycle (m_data);
         }
@@ -737,11 +757,20 @@ PacketMetadata::operator = (PacketMetadata const& o)
   m_packetUid = o.m_packetUid;
   return *this;
 }
+bool
+PacketMetadata::IsAppendable (void) const
+{
+#ifdef NS3_MTP
+  // The other references may belong to other threads
+  return m_data->m_count == 1;
+#else
+  return m_head == 0xffff || m_data->m_count == 1 || m_data->m_dirtyEnd == m_used;
+#endif
+}
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0)
     {
       PacketMetadata::Recycle (m_data);
     }
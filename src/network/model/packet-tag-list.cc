@@ -34,6 +34,87 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
+const uint32_t PacketTagList::INLINE_TAGS;
+const uint32_t PacketTagList::INLINE_TAG_SIZE;
+
+namespace {
+
+/** A free inline area, in the pool of a thread */
+struct FreeInlineArea
+{
+  FreeInlineArea *next; //!< The next free area
+};
+
+/** Maximum number of free inline areas kept by a thread */
+const uint32_t MAX_FREE_INLINE_AREAS = 1000;
+
+/*
+ * The pool of free inline areas is per thread, as the Buffer free list, so
+ * that the threads of a MultithreadedSimulatorImpl can create packets
+ * concurrently. The pointer and the counters are trivial, hence usable even
+ * after the destructor of the pool, which runs when the thread exits.
+ */
+thread_local FreeInlineArea *g_freeInlineAreas = 0;  //!< The free inline areas
+thread_local uint32_t g_numFreeInlineAreas = 0;      //!< Number of free inline areas
+thread_local bool g_inlineAreaPoolDestroyed = false; //!< The pool was released
+
+/** Release the pool of inline areas of a thread */
+struct InlineAreaPoolDestructor
+{
+  ~InlineAreaPoolDestructor ()
+  {
+    while (g_freeInlineAreas != 0)
+      {
+        FreeInlineArea *next = g_freeInlineAreas->next;
+        std::free (g_freeInlineAreas);
+        g_freeInlineAreas = next;
+      }
+    g_numFreeInlineAreas = 0;
+    g_inlineAreaPoolDestroyed = true;
+  }
+};
+thread_local InlineAreaPoolDestructor g_inlineAreaPoolDestructor; //!< Releases the pool of the thread
+
+} // anonymous namespace
+
+PacketTagList::InlineArea *
+PacketTagList::AllocateInlineArea (void)
+{
+  void * p;
+  if (g_freeInlineAreas != 0)
+    {
+      p = g_freeInlineAreas;
+      g_freeInlineAreas = g_freeInlineAreas->next;
+      g_numFreeInlineAreas--;
+    }
+  else
+    {
+      // A thread_local object is constructed, and hence destroyed at
+      // the exit of the thread, only if it is used
+      (void) &g_inlineAreaPoolDestructor;
+      p = std::malloc (sizeof (InlineArea));
+    }
+  InlineArea * area = new (p) InlineArea;
+  area->used = 0;
+  return area;
+}
+
+void
+PacketTagList::FreeInlineArea (InlineArea * area)
+{
+  NS_ASSERT (area->used == 0);
+  area->~InlineArea ();
+  if (g_inlineAreaPoolDestroyed || g_numFreeInlineAreas >= MAX_FREE_INLINE_AREAS)
+    {
+      std::free (area);
+      return;
+    }
+  struct FreeInlineArea * free = reinterpret_cast<struct FreeInlineArea *> (area);
+  free->next = g_freeInlineAreas;
+  g_freeInlineAreas = free;
+  g_numFreeInlineAreas++;
+}
+
 PacketTagList::TagData *
 PacketTagList::CreateTagData (size_t dataSize)
 {
@@ -51,6 +132,102 @@ PacketTagList::CreateTagData (size_t dataSize)
   return tag;
 }
 
+PacketTagList::TagData *
+PacketTagList::CreateInlineTagData (size_t dataSize)
+{
+  if (dataSize > INLINE_TAG_SIZE)
+    {
+      return 0;
+    }
+  if (m_inline == 0)
+    {
+      m_inline = AllocateInlineArea ();
+    }
+  uint32_t free = ~m_inline->used & ((1 << INLINE_TAGS) - 1);
+  if (free == 0)
+    {
+      return 0;
+    }
+  uint32_t slot = __builtin_ctz (free);
+  m_inline->used |= (1 << slot);
+  TagData * tag = new (m_inline->slots[slot].bytes) TagData;
+  tag->size = dataSize;
+  return tag;
+}
+
+void
+PacketTagList::FreeTagData (TagData * tag)
+{
+  if (IsInline (tag))
+    {
+      uint32_t slot = reinterpret_cast<InlineSlot *> (tag) - m_inline->slots;
+      m_inline->used &= ~(1 << slot);
+      tag->~TagData ();
+    }
+  else
+    {
+      tag->~TagData ();
+      std::free (tag);
+    }
+}
+
+void
+PacketTagList::CopyTags (PacketTagList const &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  NS_ASSERT (m_next == 0);
+
+  struct TagData ** prevNext = &m_next;
+  struct TagData * cur = o.m_next;
+  if (o.m_inline != 0 && o.m_inline->used != 0)
+    {
+      if (m_inline == 0)
+        {
+          m_inline = AllocateInlineArea ();
+        }
+      NS_ASSERT (m_inline->used == 0);
+
+      // Copy the slots up to the last one in use at once, then rebase the
+      // links between them
+      uint32_t slots = 32 - __builtin_clz (o.m_inline->used);
+      memcpy (m_inline->slots, o.m_inline->slots, slots * sizeof (InlineSlot));
+      m_inline->used = o.m_inline->used;
+      ptrdiff_t offset = reinterpret_cast<uint8_t *> (m_inline->slots)
+        - reinterpret_cast<const uint8_t *> (o.m_inline->slots);
+
+      while (cur != 0 && o.IsInline (cur))
+        {
+          struct TagData * copy =
+            reinterpret_cast<struct TagData *> (reinterpret_cast<uint8_t *> (cur) + offset);
+          *prevNext = copy;
+          prevNext = &copy->next;
+          cur = cur->next;
+        }
+    }
+
+#ifdef NS3_MTP
+  // Copy the other tags too, so that the lists share no TagData
+  while (cur != 0)
+    {
+      struct TagData * copy = CreateTagData (cur->size);
+      copy->count = 1;
+      copy->tid = cur->tid;
+      memcpy (copy->data, cur->data, cur->size);
+      *prevNext = copy;
+      prevNext = &copy->next;
+      cur = cur->next;
+    }
+  *prevNext = 0;
+#else
+  // Join the tree after them
+  *prevNext = cur;
+  if (cur != 0)
+    {
+      cur->count++;
+    }
+#endif
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -58,8 +235,8 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
   NS_LOG_FUNCTION (this << tid);
   NS_LOG_INFO     ("looking for " << tid);
 
-  // trivial case when list is empty
-  if (m_next == 0)
+  // trivial case when list is empty, or without tags of this type
+  if (m_next == 0 || (m_tidMask & GetTidBit (tid)) == 0)
     {
       return false;
     }
@@ -194,8 +371,7 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   if (preMerge)
     {
       // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      FreeTagData (cur);
     }
   else
     {
@@ -260,20 +436,33 @@ void
 PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  TypeId tid = tag.GetInstanceTypeId ();
   // ensure this id was not yet added
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
+      NS_ASSERT_MSG (cur->tid != tid,
                      "Error: cannot add the same kind of tag twice.");
     }
-  struct TagData * head = CreateTagData (tag.GetSerializedSize ());
+  PacketTagList * self = const_cast<PacketTagList *> (this);
+  uint32_t size = tag.GetSerializedSize ();
+  struct TagData * head = self->CreateInlineTagData (size);
+  struct TagData ** prevNext = &self->m_next;
+  if (head == 0)
+    {
+      // Keep the inline tags at the head of the list
+      head = CreateTagData (size);
+      while (*prevNext != 0 && IsInline (*prevNext))
+        {
+          prevNext = &(*prevNext)->next;
+        }
+    }
   head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
+  head->tid = tid;
+  head->next = *prevNext;
   tag.Serialize (TagBuffer (head->data, head->data + head->size));
 
-  const_cast<PacketTagList *> (this)->m_next = head;
+  *prevNext = head;
+  self->m_tidMask |= GetTidBit (tid);
 }
 
 bool
@@ -281,6 +470,10 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
+  if ((m_tidMask & GetTidBit (tid)) == 0)
+    {
+      return false;
+    }
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
       if (cur->tid == tid)
@@ -429,6 +622,7 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
       newTag->count = 1;
       newTag->next = 0;
       newTag->tid = tid;
+      m_tidMask |= GetTidBit (tid);
 
       NS_ASSERT (sizeCheck >= tagSize);
       memcpy (newTag->data, p, tagSize);
@@ -26,6 +26,7 @@
 */
 
 #include <stdint.h>
+#include <cstdlib>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -119,6 +120,34 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Inline tags </b>
+ *
+ *   - The first #INLINE_TAGS tags of up to #INLINE_TAG_SIZE bytes are
+ *     stored in the slots of an inline area owned by the PacketTagList,
+ *     instead of one heap block each. The small tags that the protocol
+ *     stacks add and remove on each hop (e.g., the RLC SDU status and bearer
+ *     tags of LTE and NR) then share one block, which is taken from a
+ *     per-thread pool with the first of them, and returned to it by
+ *     #RemoveAll. A list without small tags costs only the pointer to it.
+ *
+ *   - The inline tags are always at the head of the list, before the first
+ *     heap-allocated TagData: #Add prepends a tag only if it goes to a
+ *     slot, and otherwise inserts it after the inline tags. They are never
+ *     shared: the copy constructor and the assignment copy them to the slots
+ *     of the inline area of the new list, and join the tree after them.
+ *
+ *   - A bitmask of the types of the tags (one bit per TypeId uid, modulo 64)
+ *     lets #Peek and #Remove return in constant time when the tag is not in
+ *     the list. The bit of a removed tag may stay set.
+ *
+ * \par <b> Multithreaded simulation </b>
+ *
+ *   - With the NS3_MTP build option, the copies of a PacketTagList share
+ *     no TagData: the copy constructor and the assignment copy all the
+ *     tags. The copies of a packet can then be used by different threads
+ *     of the MultithreadedSimulatorImpl, which the tree, whose counts are
+ *     updated without synchronization, would not allow.
  */
 class PacketTagList 
 {
@@ -147,6 +176,11 @@ public:
     uint8_t data[1];            /**< Serialization buffer */
   };  /* struct TagData */
 
+  /** Maximum number of tags stored in the inline area */
+  static const uint32_t INLINE_TAGS = 6;
+  /** Maximum serialized size of a tag stored in the inline area */
+  static const uint32_t INLINE_TAG_SIZE = 8;
+
   /**
    * Create a new PacketTagList.
    */
@@ -252,6 +286,69 @@ private:
    */
   static
   TagData * CreateTagData (size_t dataSize);
+  /** Storage of an inline tag */
+  struct InlineSlot
+  {
+    alignas (TagData) uint8_t bytes[sizeof (TagData) - 1 + INLINE_TAG_SIZE]; //!< The TagData
+  };
+
+  /** The inline tags of a list */
+  struct InlineArea
+  {
+    InlineSlot slots[INLINE_TAGS];  //!< The slots
+    uint8_t used;                   //!< Bit i is set if the slot i is in use
+  };
+
+  /**
+   * Take an empty inline area from the pool of the calling thread.
+   *
+   * 
+eturns The inline area.
+   */
+  static InlineArea * AllocateInlineArea (void);
+  /**
+   * Give an inline area back to the pool of the calling thread.
+   *
+   * \param [in] area The inline area, without tags.
+   */
+  static void FreeInlineArea (InlineArea * area);
+  /**
+   * Construct a TagData struct in a free inline slot.
+   *
+   * \param [in] dataSize The serialized size of the Tag.
+   * \returns The newly constructed TagData object, or 0 if the tag is too
+   *          large or all the slots are in use.
+   */
+  TagData * CreateInlineTagData (size_t dataSize);
+  /**
+   * Destroy a TagData struct of this list, and free its memory or its slot.
+   *
+   * \param [in] tag The TagData object.
+   */
+  void FreeTagData (TagData * tag);
+  /**
+   * \param [in] tag A TagData object.
+   * \returns True if \pname{tag} is stored in an inline slot of this list.
+   */
+  inline bool IsInline (const TagData * tag) const;
+  /**
+   * Copy the inline tags of another list to this (empty) one, and join the
+   * tree after them; with NS3_MTP, copy all the tags instead.
+   *
+   * \param [in] o The PacketTagList to copy.
+   */
+  void CopyTags (PacketTagList const &o);
+  /**
+   * \param [in] o A PacketTagList.
+   * \returns True if the copies of \pname{o} must use CopyTags (),
+   * instead of sharing all its tags.
+   */
+  static inline bool CopiesTags (PacketTagList const &o);
+  /**
+   * \param [in] tid The type of a tag.
+   * \returns The bit of \pname{tid} in #m_tidMask.
+   */
+  static inline uint64_t GetTidBit (TypeId tid);
   
   /**
    * Typedef of method function pointer for copy-on-write operations
@@ -306,6 +403,10 @@ private:
    * Pointer to first \ref TagData on the list
    */
   struct TagData *m_next;
+  /** Bit (uid modulo 64) of the type of each tag in the list */
+  uint64_t m_tidMask;
+  /** The inline tags, or 0 if no small tag was added since #RemoveAll */
+  InlineArea *m_inline;
 };
 
 } // namespace ns3
@@ -317,19 +418,38 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_tidMask (0),
+    m_inline (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_next (o.m_next),
+    m_tidMask (o.m_tidMask),
+    m_inline (0)
 {
-  if (m_next != 0)
+  if (CopiesTags (o))
+    {
+      m_next = 0;
+      CopyTags (o);
+    }
+  else if (m_next != 0)
     {
       m_next->count++;
     }
 }
 
+bool
+PacketTagList::CopiesTags (PacketTagList const &o)
+{
+#ifdef NS3_MTP
+  return o.m_next != 0;
+#else
+  return o.m_inline != 0 && o.m_inline->used != 0;
+#endif
+}
+
 PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
@@ -339,6 +459,12 @@ PacketTagList::operator = (PacketTagList const &o)
       return *this;
     }
   RemoveAll ();
+  m_tidMask = o.m_tidMask;
+  if (CopiesTags (o))
+    {
+      CopyTags (o);
+      return *this;
+    }
   m_next = o.m_next;
   if (m_next != 0) 
     {
@@ -352,11 +478,41 @@ PacketTagList::~PacketTagList ()
   RemoveAll ();
 }
 
+bool
+PacketTagList::IsInline (const TagData * tag) const
+{
+  uintptr_t p = reinterpret_cast<uintptr_t> (tag);
+  return m_inline != 0
+         && p >= reinterpret_cast<uintptr_t> (&m_inline->slots[0])
+         && p < reinterpret_cast<uintptr_t> (&m_inline->slots[INLINE_TAGS]);
+}
+
+uint64_t
+PacketTagList::GetTidBit (TypeId tid)
+{
+  return uint64_t (1) << (tid.GetUid () % 64);
+}
+
 void
 PacketTagList::RemoveAll (void)
 {
+  // The inline tags are at the head of the list, and owned by this list
+  struct TagData *head = m_next;
+  while (head != 0 && IsInline (head))
+    {
+      struct TagData *next = head->next;
+      head->~TagData ();
+      head = next;
+    }
+  if (m_inline != 0)
+    {
+      FreeInlineArea (m_inline);
+      m_inline = 0;
+    }
+  m_tidMask = 0;
+
   struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  for (struct TagData *cur = head; cur != 0; cur = cur->next)
     {
       cur->count--;
       if (cur->count > 0) 
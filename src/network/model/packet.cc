@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
 #include <string>
 #include <cstdarg>
 
@@ -126,22 +127,35 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+uint64_t
+Packet::AllocateUid (void)
+{
+  // The packets created by the partitions of a MultithreadedSimulatorImpl
+  // take their uids from the counter of the partition, so that they do
+  // not depend on the number of threads
+  uint64_t uid;
+  if (MultithreadedSimulatorImpl::GetPartitionUid (&uid))
+    {
+      return uid;
+    }
+  /* The upper 32 bits of the packet id in
+   * metadata is for the system id. For non-
+   * distributed simulations, this is simply
+   * zero.  The lower 32 bits are for the
+   * global UID
+   */
+  return static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++;
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
     m_packetTagList (),
-    /* The upper 32 bits of the packet id in 
-     * metadata is for the system id. For non-
-     * distributed simulations, this is simply 
-     * zero.  The lower 32 bits are for the 
-     * global UID
-     */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (AllocateUid (), 0),
     m_nixVector (0),
     m_periodicity(),
     m_deadline()
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -176,18 +190,11 @@ Packet::Packet (uint32_t size)
   : m_buffer (size),
     m_byteTagList (),
     m_packetTagList (),
-    /* The upper 32 bits of the packet id in 
-     * metadata is for the system id. For non-
-     * distributed simulations, this is simply 
-     * zero.  The lower 32 bits are for the 
-     * global UID
-     */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0),
     m_periodicity(),
     m_deadline()
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -206,18 +213,11 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
   : m_buffer (),
     m_byteTagList (),
     m_packetTagList (),
-    /* The upper 32 bits of the packet id in 
-     * metadata is for the system id. For non-
-     * distributed simulations, this is simply 
-     * zero.  The lower 32 bits are for the 
-     * global UID
-     */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0),
     m_periodicity(),
     m_deadline()
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -1039,18 +1039,11 @@ Packet::Packet (uint32_t size, uint8_t periodicity, uint32_t deadline)
   : m_buffer (size),
     m_byteTagList (),
     m_packetTagList (),
-    /* The upper 32 bits of the packet id in
-     * metadata is for the system id. For non-
-     * distributed simulations, this is simply
-     * zero.  The lower 32 bits are for the
-     * global UID
-     */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0),
     m_periodicity(periodicity),
     m_deadline(deadline)
 {
-  m_globalUid++;
 }
 
 uint8_t
@@ -794,6 +794,11 @@ private:
   /* Please see comments above about nix-vector */
   mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+  /**
+   * \returns The uid of a new packet.
+   */
+  static uint64_t AllocateUid (void);
+
   static uint32_t m_globalUid; //!< Global counter of packets Uid
 
   // Configured Grant
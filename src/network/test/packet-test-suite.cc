@@ -1109,6 +1109,57 @@ PacketTagListTest::DoRun (void)
     ReplaceCheck (7);
   }
 
+  { // Inline tags
+    std::cout << GetName () << "check inline and heap tags" << std::endl;
+    ATestTag<20> big (1);       // too large to be stored inline
+    ATestTag<9> t9 (1);
+
+    PacketTagList ptl;
+    ptl.Add (t1);
+    ptl.Add (big);
+    ptl.Add (t2);
+    ptl.Add (t3);
+
+    PacketTagList cpy = ptl;
+    cpy.Remove (t2);
+    cpy.Add (t9);
+    cpy.Remove (big);
+
+    int n = 0;
+    for (const PacketTagList::TagData *cur = ptl.Head (); cur != 0; cur = cur->next)
+      {
+        ++n;
+      }
+    NS_TEST_EXPECT_MSG_EQ (n, 4, "inline, orig length");
+    const char * msg = "inline, orig";
+    CheckRef (ptl, t1, msg, false);
+    CheckRef (ptl, t2, msg, false);
+    CheckRef (ptl, t3, msg, false);
+    CheckRef (ptl, big, msg, false);
+    CheckRef (ptl, t9, msg, true);
+
+    ptl.RemoveAll ();
+    NS_TEST_EXPECT_MSG_EQ (ptl.Peek (t1), false, "inline, orig removed");
+    msg = "inline, copy";
+    CheckRef (cpy, t1, msg, false);
+    CheckRef (cpy, t2, msg, true);
+    CheckRef (cpy, t3, msg, false);
+    CheckRef (cpy, t9, msg, false);
+    CheckRef (cpy, big, msg, true);
+
+    // The slots freed by Remove are reused
+    for (int i = 0; i < 2 * static_cast<int> (PacketTagList::INLINE_TAGS); ++i)
+      {
+        cpy.Add (t4);
+        t4.m_data = 2;
+        cpy.Replace (t4);
+        CheckRef (cpy, t4, "inline, reuse", false);
+        t4.m_data = 1;
+        cpy.Remove (t4);
+      }
+    CheckRef (cpy, t4, "inline, reuse", true);
+  }
+
   { // Timing
     std::cout << GetName () << "add+remove timing" << std::endl;
     int flm = std::numeric_limits<int>::max ();
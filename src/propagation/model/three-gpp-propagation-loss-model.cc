@@ -221,8 +221,18 @@ ThreeGppPropagationLossModel::GetShadowing (Ptr<MobilityModel> a, Ptr<MobilityMo
     {
       // compute a new correlated shadowing loss
       Vector2D displacement (newDistance.x - it->second.m_distance.x, newDistance.y - it->second.m_distance.y);
-      double R = exp (-1 * displacement.GetLength () / GetShadowingCorrelationDistance (cond));
-      shadowingValue =  R * it->second.m_shadowing + sqrt (1 - R * R) * m_normRandomVariable->GetValue () * GetShadowingStd (a, b, cond);
+      if (displacement.GetLength () == 0)
+        {
+          // R is 1, so the value is the previous one: do not draw a random
+          // value that would be discarded, so that the draws of the other
+          // links do not depend on how many times a still link is evaluated
+          shadowingValue = it->second.m_shadowing;
+        }
+      else
+        {
+          double R = exp (-1 * displacement.GetLength () / GetShadowingCorrelationDistance (cond));
+          shadowingValue =  R * it->second.m_shadowing + sqrt (1 - R * R) * m_normRandomVariable->GetValue () * GetShadowingStd (a, b, cond);
+        }
     }
 
   // update the entry in the map
@@ -23,12 +23,15 @@
 #include <utility>
 #include <ns3/object.h>
 #include <ns3/simulator.h>
+#include <ns3/multithreaded-simulator-impl.h>
 #include <ns3/log.h>
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -79,7 +82,10 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
-  : m_numDevices {0}
+  : m_numDevices {0},
+    m_pathLossCacheEnabled {false},
+    m_pathLossCacheHits {0},
+    m_pathLossCacheMisses {0}
 {
   NS_LOG_FUNCTION (this);
 }
@@ -90,6 +96,16 @@ MultiModelSpectrumChannel::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_pendingRx.clear ();
+  m_workerPool = nullptr;
+  for (auto &mobility : m_trackedMobility)
+    {
+      mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                               MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+    }
+  m_trackedMobility.clear ();
+  m_mobilityEpochs.clear ();
+  m_pathLossCache.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -100,11 +116,75 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("NumThreads",
+                   "Number of threads that compute the received PSDs of a transmission. "
+                   "With 1, the receivers are processed serially; with more, the PSD "
+                   "computations of the PhasedArraySpectrumPropagationLossModel run on a "
+                   "pool of threads, with the same results.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MultiModelSpectrumChannel::SetNumThreads,
+                                         &MultiModelSpectrumChannel::GetNumThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("PathLossCache",
+                   "If true, the total pathloss of the links whose nodes do not move is "
+                   "computed once, and reused until one of the nodes changes its course. "
+                   "Enable it only with a PropagationLossModel that gives the same loss "
+                   "for the same positions: a value is reused only after two consecutive "
+                   "computations of the link gave it.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_pathLossCacheEnabled),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
+void
+MultiModelSpectrumChannel::SetNumThreads (uint32_t numThreads)
+{
+  NS_LOG_FUNCTION (this << numThreads);
+  m_workerPool = numThreads > 1 ? Create<WorkerPool> (numThreads) : nullptr;
+}
+
+uint32_t
+MultiModelSpectrumChannel::GetNumThreads (void) const
+{
+  return m_workerPool ? m_workerPool->GetNumThreads () : 1;
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetPathLossCacheHits (void) const
+{
+  return m_pathLossCacheHits;
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetPathLossCacheMisses (void) const
+{
+  return m_pathLossCacheMisses;
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetMobilityEpoch (Ptr<MobilityModel> mobility)
+{
+  auto it = m_mobilityEpochs.find (PeekPointer (mobility));
+  if (it == m_mobilityEpochs.end ())
+    {
+      NS_LOG_LOGIC ("Tracking the course changes of " << mobility);
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+      m_trackedMobility.push_back (mobility);
+      it = m_mobilityEpochs.insert (std::make_pair (PeekPointer (mobility), 0)).first;
+    }
+  return it->second;
+}
+
+void
+MultiModelSpectrumChannel::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  ++m_mobilityEpochs[PeekPointer (mobility)];
+}
+
 void
 MultiModelSpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
 {
@@ -121,6 +201,17 @@ MultiModelSpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
       auto phyIt = std::find (rxInfoIterator->second.m_rxPhys.begin(), rxInfoIterator->second.m_rxPhys.end(), phy);
       if (phyIt != rxInfoIterator->second.m_rxPhys.end ())
         {
+          for (auto it = m_pathLossCache.begin (); it != m_pathLossCache.end (); )
+            {
+              if (it->first.first == PeekPointer (phy) || it->first.second == PeekPointer (phy))
+                {
+                  it = m_pathLossCache.erase (it);
+                }
+              else
+                {
+                  ++it;
+                }
+            }
           rxInfoIterator->second.m_rxPhys.erase (phyIt);
           --m_numDevices;
           break; // there should be at most one entry
@@ -228,6 +319,15 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
+
+  if (MultithreadedSimulatorImpl::IsInParallelWindow ())
+    {
+      // The channel is shared by all the partitions: start the
+      // transmission on the main thread, at the end of the window
+      MultithreadedSimulatorImpl::ScheduleAtWindowEnd (MakeEvent (&MultiModelSpectrumChannel::StartTx, this, txParams));
+      return;
+    }
+
   Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
   m_txSigParamsTrace (txParamsTrace);
 
@@ -277,6 +377,12 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
+              if (m_filter && m_filter->Filter (txParams, *rxPhyIterator))
+                {
+                  NS_LOG_LOGIC ("Receiver " << *rxPhyIterator << " excluded by the transmit filter");
+                  continue;
+                }
+
               Ptr<NetDevice> rxNetDevice = (*rxPhyIterator)->GetDevice ();
               Ptr<NetDevice> txNetDevice = txParams->txPhy->GetDevice ();
 
@@ -294,6 +400,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
               Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
               rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
               Time delay = MicroSeconds (0);
+              PhasedArraySpectrumPropagationLossModel::RxPsdTask task;
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
@@ -303,27 +410,79 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   double rxAntennaGain = 0;
                   double propagationGainDb = 0;
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
                   Ptr<AntennaModel> rxAntenna = DynamicCast<AntennaModel>((*rxPhyIterator)->GetAntenna ());
-                  if (rxAntenna != 0)
+
+                  bool cacheHit = false;
+                  auto link = std::make_pair (PeekPointer (txParams->txPhy), PeekPointer (*rxPhyIterator));
+                  uint64_t txEpoch = 0;
+                  uint64_t rxEpoch = 0;
+                  if (m_pathLossCacheEnabled)
                     {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
+                      txEpoch = GetMobilityEpoch (txMobility);
+                      rxEpoch = GetMobilityEpoch (receiverMobility);
+                      auto it = m_pathLossCache.find (link);
+                      if (it != m_pathLossCache.end () && it->second.m_confirmed
+                          && it->second.m_txEpoch == txEpoch && it->second.m_rxEpoch == rxEpoch
+                          && it->second.m_txAntenna == PeekPointer (rxParams->txAntenna)
+                          && it->second.m_rxAntenna == PeekPointer (rxAntenna))
+                        {
+                          txAntennaGain = it->second.m_txAntennaGain;
+                          rxAntennaGain = it->second.m_rxAntennaGain;
+                          propagationGainDb = it->second.m_propagationGainDb;
+                          pathLossDb = it->second.m_pathLossDb;
+                          cacheHit = true;
+                          ++m_pathLossCacheHits;
+                        }
                     }
-                  if (m_propagationLoss)
+
+                  if (!cacheHit)
                     {
-                      propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
+                      if (rxParams->txAntenna != 0)
+                        {
+                          Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+                          txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+                          pathLossDb -= txAntennaGain;
+                        }
+                      if (rxAntenna != 0)
+                        {
+                          Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+                          rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+                          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+                          pathLossDb -= rxAntennaGain;
+                        }
+                      if (m_propagationLoss)
+                        {
+                          propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+                          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+                          pathLossDb -= propagationGainDb;
+                        }
+                      if (m_pathLossCacheEnabled)
+                        {
+                          ++m_pathLossCacheMisses;
+                          // a node that moves without changing its course does not
+                          // notify it, so only the links between still nodes are cached
+                          if (txMobility->GetVelocity () == Vector () && receiverMobility->GetVelocity () == Vector ())
+                            {
+                              PathLossCacheEntry entry {txEpoch, rxEpoch,
+                                                        PeekPointer (rxParams->txAntenna), PeekPointer (rxAntenna),
+                                                        txAntennaGain, rxAntennaGain, propagationGainDb, pathLossDb,
+                                                        false};
+                              // the value is reused only once the loss model gave it
+                              // twice in a row: a model that settles the random state
+                              // of a link in its first evaluations (as the shadowing of
+                              // ThreeGppPropagationLossModel) is evaluated until it did,
+                              // and a model with fading is never cached
+                              auto it = m_pathLossCache.find (link);
+                              entry.m_confirmed = it != m_pathLossCache.end ()
+                                && it->second.m_txEpoch == txEpoch && it->second.m_rxEpoch == rxEpoch
+                                && it->second.m_txAntenna == entry.m_txAntenna
+                                && it->second.m_rxAntenna == entry.m_rxAntenna
+                                && it->second.m_pathLossDb == pathLossDb;
+                              m_pathLossCache[link] = entry;
+                            }
+                        }
+                    }
                   NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
                   // Gain trace
                   m_gainTrace (txMobility, receiverMobility, txAntennaGain, rxAntennaGain, propagationGainDb, pathLossDb);
@@ -348,7 +507,14 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
                       NS_ASSERT_MSG (txPhasedArrayModel && rxPhasedArrayModel, "PhasedArrayModel instances should be installed at both TX and RX SpectrumPhy in order to use PhasedArraySpectrumPropagationLoss.");
 
-                      rxParams->psd = m_phasedArraySpectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility, txPhasedArrayModel, rxPhasedArrayModel);
+                      if (m_workerPool)
+                        {
+                          task = m_phasedArraySpectrumPropagationLoss->PrepareRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility, txPhasedArrayModel, rxPhasedArrayModel);
+                        }
+                      else
+                        {
+                          rxParams->psd = m_phasedArraySpectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility, txPhasedArrayModel, rxPhasedArrayModel);
+                        }
                      }
 
                   if (m_propagationDelay)
@@ -357,24 +523,54 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
-              if (rxNetDevice)
+              if (m_workerPool)
                 {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode = rxNetDevice->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
+                  m_pendingRx.push_back ({rxParams, *rxPhyIterator, delay, std::move (task)});
                 }
               else
                 {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
+                  ScheduleStartRx (rxParams, *rxPhyIterator, delay);
                 }
             }
         }
 
     }
 
+  if (m_workerPool)
+    {
+      // complete the PSDs, then schedule the receptions in the serial order
+      m_workerPool->Run (m_pendingRx.size (), [this] (std::size_t i)
+        {
+          if (m_pendingRx[i].m_task)
+            {
+              m_pendingRx[i].m_task ();
+            }
+        });
+      for (auto &pending : m_pendingRx)
+        {
+          ScheduleStartRx (pending.m_params, pending.m_receiver, pending.m_delay);
+        }
+      m_pendingRx.clear ();
+    }
+}
+
+void
+MultiModelSpectrumChannel::ScheduleStartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver, Time delay)
+{
+  Ptr<NetDevice> rxNetDevice = receiver->GetDevice ();
+  if (rxNetDevice)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode = rxNetDevice->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                      params, receiver);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                           params, receiver);
+    }
 }
 
 void
@@ -27,8 +27,11 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/worker-pool.h>
+#include <ns3/mobility-model.h>
 #include <map>
 #include <set>
+#include <utility>
 
 namespace ns3 {
 
@@ -102,6 +105,27 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * With the attribute NumThreads greater than one, the received PSDs of a
+ * transmission are computed in two steps: the receivers are visited in order
+ * (evaluating the antenna gains, the propagation loss, the traces and the
+ * part of the PhasedArraySpectrumPropagationLossModel that uses its state),
+ * then the remaining PSD computations run on a pool of threads, and finally
+ * the StartRx events are scheduled, in the same receiver order. The results
+ * are the same as with the serial computation.
+ *
+ * With the attribute PathLossCache, the total pathloss of a link (antenna
+ * gains of the AntennaModel instances and propagation loss) is computed once
+ * and reused while both nodes do not move: an entry is valid while the course
+ * change epochs of the two MobilityModel instances (incremented by their
+ * CourseChange trace) are the ones of its computation, and it is only stored
+ * if both nodes have a null velocity. The cache is correct only if the
+ * PropagationLossModel gives the same loss for the same positions, e.g., a
+ * ThreeGppPropagationLossModel whose ChannelConditionModel has UpdatePeriod 0,
+ * and not a model with random fading. A value is reused only after two
+ * consecutive computations of the link gave it, so that the random state a
+ * model settles in the first evaluations of a link (as the shadowing of
+ * ThreeGppPropagationLossModel) is the one the cache keeps.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -125,6 +149,17 @@ public:
   virtual std::size_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \return the number of pathloss computations avoided by the pathloss cache
+   */
+  uint64_t GetPathLossCacheHits (void) const;
+
+  /**
+   * \return the number of pathloss computations done with the pathloss cache
+   * enabled, because the link was not cached or its entry was not valid anymore
+   */
+  uint64_t GetPathLossCacheMisses (void) const;
+
 
 protected:
   void DoDispose ();
@@ -150,6 +185,73 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Schedule the StartRx of a receiver, in the context of its node.
+   *
+   * \param params The signal parameters.
+   * \param receiver A pointer to the receiver SpectrumPhy.
+   * \param delay The propagation delay.
+   */
+  void ScheduleStartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver, Time delay);
+
+  /**
+   * Set the number of threads that compute the received PSDs.
+   *
+   * \param numThreads The number of threads (1 for the serial computation).
+   */
+  void SetNumThreads (uint32_t numThreads);
+
+  /**
+   * Get the number of threads that compute the received PSDs.
+   *
+   * \return The number of threads.
+   */
+  uint32_t GetNumThreads (void) const;
+
+  /**
+   * Get the course change epoch of a mobility model, connecting the channel
+   * to its CourseChange trace the first time.
+   *
+   * \param mobility The mobility model.
+   * \return The number of course changes notified by the model.
+   */
+  uint64_t GetMobilityEpoch (Ptr<MobilityModel> mobility);
+
+  /**
+   * Invalidate the cached pathloss of the links of a mobility model, through
+   * its course change epoch.
+   *
+   * \param mobility The mobility model that changed its course.
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+
+  /**
+   * The pathloss of a link, as stored by the pathloss cache.
+   */
+  struct PathLossCacheEntry
+  {
+    uint64_t m_txEpoch;                 //!< Course change epoch of the tx mobility
+    uint64_t m_rxEpoch;                 //!< Course change epoch of the rx mobility
+    const AntennaModel *m_txAntenna;    //!< The tx antenna of the gain
+    const AntennaModel *m_rxAntenna;    //!< The rx antenna of the gain
+    double m_txAntennaGain;             //!< Tx antenna gain (dB)
+    double m_rxAntennaGain;             //!< Rx antenna gain (dB)
+    double m_propagationGainDb;         //!< Propagation gain (dB)
+    double m_pathLossDb;                //!< Total pathloss (dB)
+    bool m_confirmed;                   //!< True if the previous computation gave the same pathloss
+  };
+
+  /**
+   * A reception whose PSD is being computed by the worker pool.
+   */
+  struct PendingRx
+  {
+    Ptr<SpectrumSignalParameters> m_params; //!< The signal parameters
+    Ptr<SpectrumPhy> m_receiver;            //!< The receiver
+    Time m_delay;                           //!< The propagation delay
+    PhasedArraySpectrumPropagationLossModel::RxPsdTask m_task; //!< The remaining PSD computation
+  };
+
   /**
    * Data structure holding, for each TX SpectrumModel,  all the
    * converters to any RX SpectrumModel, and all the corresponding
@@ -170,6 +272,39 @@ private:
    */
   std::size_t m_numDevices;
 
+  /**
+   * Threads that compute the received PSDs, or null for the serial computation.
+   */
+  Ptr<WorkerPool> m_workerPool;
+
+  /**
+   * Receptions of the current transmission, with the worker pool.
+   */
+  std::vector<PendingRx> m_pendingRx;
+
+  /**
+   * True if the pathloss of the static links is cached.
+   */
+  bool m_pathLossCacheEnabled;
+
+  /**
+   * Cached pathloss, per (tx phy, rx phy) link.
+   */
+  std::map<std::pair<const SpectrumPhy *, const SpectrumPhy *>, PathLossCacheEntry> m_pathLossCache;
+
+  /**
+   * Course change epoch of the mobility models of the cached links.
+   */
+  std::map<const MobilityModel *, uint64_t> m_mobilityEpochs;
+
+  /**
+   * Mobility models whose CourseChange trace is connected to the channel.
+   */
+  std::vector<Ptr<MobilityModel> > m_trackedMobility;
+
+  uint64_t m_pathLossCacheHits;   //!< Pathloss computations avoided by the cache
+  uint64_t m_pathLossCacheMisses; //!< Pathloss computations done with the cache
+
 };
 
 
@@ -77,4 +77,31 @@ PhasedArraySpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const S
   return rxPsd;
 }
 
+PhasedArraySpectrumPropagationLossModel::RxPsdTask
+PhasedArraySpectrumPropagationLossModel::PrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                                                        Ptr<const MobilityModel> a,
+                                                                        Ptr<const MobilityModel> b,
+                                                                        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                        Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  if (m_next != 0)
+    {
+      // the models of the chain must be applied in order: no task
+      *psd = *CalcRxPowerSpectralDensity (psd, a, b, aPhasedArrayModel, bPhasedArrayModel);
+      return RxPsdTask ();
+    }
+  return DoPrepareRxPowerSpectralDensity (psd, a, b, aPhasedArrayModel, bPhasedArrayModel);
+}
+
+PhasedArraySpectrumPropagationLossModel::RxPsdTask
+PhasedArraySpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                                                          Ptr<const MobilityModel> a,
+                                                                          Ptr<const MobilityModel> b,
+                                                                          Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                          Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  *psd = *DoCalcRxPowerSpectralDensity (psd, a, b, aPhasedArrayModel, bPhasedArrayModel);
+  return RxPsdTask ();
+}
+
 } // namespace ns3
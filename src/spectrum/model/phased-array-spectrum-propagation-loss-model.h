@@ -25,6 +25,7 @@
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/phased-array-model.h>
+#include <functional>
 
 namespace ns3 {
 
@@ -82,6 +83,37 @@ public:
                                                  Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                  Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
 
+  /**
+   * Computation of a received PSD that can run out of the simulation thread
+   * (see PrepareRxPowerSpectralDensity)
+   */
+  typedef std::function<void ()> RxPsdTask;
+
+  /**
+   * Calculate the received PSD in two steps: the part that uses the state of
+   * the model (e.g., channel generation, random variables, caches) runs in
+   * this call, and the remaining computation is returned as a task, that only
+   * touches the given PSD and can run in any thread, concurrently with the
+   * tasks of other receivers.
+   *
+   * The task (if not empty) must run before the PSD is used, and before the
+   * next call to the model. The PSD is the same that
+   * CalcRxPowerSpectralDensity would return.
+   *
+   * @param psd the transmitted PSD, replaced by the received PSD
+   * @param a sender mobility
+   * @param b receiver mobility
+   * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+   * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+   *
+   * @return the task that completes the PSD, or an empty task
+   */
+  RxPsdTask PrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                           Ptr<const MobilityModel> a,
+                                           Ptr<const MobilityModel> b,
+                                           Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                           Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+
 protected:
   virtual void DoDispose ();
 
@@ -105,6 +137,24 @@ private:
                                                            Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                            Ptr<const PhasedArrayModel> bPhasedArrayModel) const = 0;
 
+  /**
+   * The default implementation computes the whole PSD with
+   * DoCalcRxPowerSpectralDensity, and returns an empty task.
+   *
+   * @param psd the transmitted PSD, replaced by the received PSD
+   * @param a sender mobility
+   * @param b receiver mobility
+   * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+   * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+   *
+   * @return the task that completes the PSD, or an empty task
+   */
+  virtual RxPsdTask DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                                     Ptr<const MobilityModel> a,
+                                                     Ptr<const MobilityModel> b,
+                                                     Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                     Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+
   Ptr<PhasedArraySpectrumPropagationLossModel> m_next; //!< PhasedArraySpectrumPropagationLossModel chained to this one.
 };
 
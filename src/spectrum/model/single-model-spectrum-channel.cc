@@ -20,6 +20,7 @@
 
 #include <ns3/object.h>
 #include <ns3/simulator.h>
+#include <ns3/multithreaded-simulator-impl.h>
 #include <ns3/log.h>
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
@@ -98,6 +99,14 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
   NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
 
+  if (MultithreadedSimulatorImpl::IsInParallelWindow ())
+    {
+      // The channel is shared by all the partitions: start the
+      // transmission on the main thread, at the end of the window
+      MultithreadedSimulatorImpl::ScheduleAtWindowEnd (MakeEvent (&SingleModelSpectrumChannel::StartTx, this, txParams));
+      return;
+    }
+
   Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
   m_txSigParamsTrace (txParamsTrace);
 
@@ -135,6 +144,12 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
             }
         }
 
+      if (m_filter && m_filter->Filter (txParams, *rxPhyIterator))
+        {
+          NS_LOG_LOGIC ("Receiver " << *rxPhyIterator << " excluded by the transmit filter");
+          continue;
+        }
+
       if ((*rxPhyIterator) != txParams->txPhy)
         {
           Time delay  = MicroSeconds (0);
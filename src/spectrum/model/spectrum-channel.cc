@@ -47,6 +47,7 @@ SpectrumChannel::DoDispose ()
   m_propagationLoss = 0;
   m_propagationDelay = 0;
   m_spectrumPropagationLoss = 0;
+  m_filter = 0;
 }
 
 TypeId
@@ -174,5 +175,22 @@ SpectrumChannel::GetPropagationLossModel ()
   return m_propagationLoss;
 }
 
+void
+SpectrumChannel::AddSpectrumTransmitFilter (Ptr<SpectrumTransmitFilter> filter)
+{
+  NS_LOG_FUNCTION (this << filter);
+  if (m_filter)
+    {
+      filter->SetNext (m_filter);
+    }
+  m_filter = filter;
+}
+
+Ptr<SpectrumTransmitFilter>
+SpectrumChannel::GetSpectrumTransmitFilter (void) const
+{
+  return m_filter;
+}
+
 
 } // namespace
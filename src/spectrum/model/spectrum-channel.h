@@ -28,6 +28,7 @@
 #include <ns3/spectrum-signal-parameters.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/phased-array-spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-transmit-filter.h>
 #include <ns3/propagation-delay-model.h>
 #include <ns3/propagation-loss-model.h>
 #include <ns3/spectrum-phy.h>
@@ -116,6 +117,19 @@ public:
    */
   Ptr<PropagationLossModel> GetPropagationLossModel (void);
 
+  /**
+   * Add a filter of the receivers of the transmissions; if other filters
+   * are already set, it is chained to them.
+   * \param filter a pointer to the filter to be used.
+   */
+  void AddSpectrumTransmitFilter (Ptr<SpectrumTransmitFilter> filter);
+
+  /**
+   * Get the filter of the receivers (the first one of the chain).
+   * \returns a pointer to the filter, or null if there is none.
+   */
+  Ptr<SpectrumTransmitFilter> GetSpectrumTransmitFilter (void) const;
+
   /**
    * Used by attached PHY instances to transmit signals on the channel
    *
@@ -233,6 +247,12 @@ protected:
    */
   Ptr<PhasedArraySpectrumPropagationLossModel> m_phasedArraySpectrumPropagationLoss;
 
+  /**
+   * Filter of the receivers of the transmissions: the receivers that it
+   * excludes get no propagation computation and no reception.
+   */
+  Ptr<SpectrumTransmitFilter> m_filter;
+
 
 };
 
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 CTTC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SPECTRUM_TRANSMIT_FILTER_H
+#define SPECTRUM_TRANSMIT_FILTER_H
+
+#include <ns3/object.h>
+
+namespace ns3 {
+
+struct SpectrumSignalParameters;
+class SpectrumPhy;
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief spectrum-aware filter of the links of a SpectrumChannel
+ *
+ * A SpectrumChannel asks its filters, before doing any computation for a
+ * receiver (propagation loss, channel matrix, scheduling of the reception),
+ * whether the receiver has any interest in the transmission. If a filter
+ * says that it has none, the receiver is skipped: it does not receive the
+ * signal, neither as a signal to decode nor as interference.
+ *
+ * Filters can be chained with SetNext (or by adding several of them to the
+ * channel): a receiver is skipped if any filter of the chain excludes it.
+ */
+class SpectrumTransmitFilter : public Object
+{
+public:
+  SpectrumTransmitFilter ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * Used to chain various instances of SpectrumTransmitFilter
+   *
+   * @param next the filter to evaluate after this one
+   */
+  void SetNext (Ptr<SpectrumTransmitFilter> next);
+
+  /**
+   * Evaluate the filter chain
+   *
+   * @param params the parameters of the transmitted signal
+   * @param receiverPhy the receiver
+   *
+   * @return true if the receiver has to be skipped
+   */
+  bool Filter (Ptr<const SpectrumSignalParameters> params, Ptr<const SpectrumPhy> receiverPhy) const;
+
+protected:
+  virtual void DoDispose ();
+
+private:
+  /**
+   * Evaluate this filter
+   *
+   * @param params the parameters of the transmitted signal
+   * @param receiverPhy the receiver
+   *
+   * @return true if the receiver has to be skipped
+   */
+  virtual bool DoFilter (Ptr<const SpectrumSignalParameters> params,
+                         Ptr<const SpectrumPhy> receiverPhy) const = 0;
+
+  Ptr<SpectrumTransmitFilter> m_next; //!< SpectrumTransmitFilter chained to this one.
+};
+
+} // namespace ns3
+
+#endif /* SPECTRUM_TRANSMIT_FILTER_H */
@@ -33,6 +33,7 @@
 #include <ns3/simulator.h>
 #include "ns3/mobility-model.h"
 #include "ns3/pointer.h"
+#include "ns3/worker-pool.h"
 
 namespace ns3 {
 
@@ -1078,11 +1079,13 @@ ThreeGppChannelModel::ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelParams>
     }
 }
 
-Ptr<const MatrixBasedChannelModel::ChannelMatrix>
-ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
-                                  Ptr<const MobilityModel> bMob,
-                                  Ptr<const PhasedArrayModel> aAntenna,
-                                  Ptr<const PhasedArrayModel> bAntenna)
+Ptr<MatrixBasedChannelModel::ChannelMatrix>
+ThreeGppChannelModel::GetValidChannel (Ptr<const MobilityModel> aMob,
+                                       Ptr<const MobilityModel> bMob,
+                                       Ptr<const PhasedArrayModel> aAntenna,
+                                       Ptr<const PhasedArrayModel> bAntenna,
+                                       Ptr<ThreeGppChannelParams> *channelParams,
+                                       Ptr<const ParamsTable> *table3gpp)
 {
   NS_LOG_FUNCTION (this);
 
@@ -1101,14 +1104,13 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   bool notFoundParams = false;
   bool notFoundMatrix = false;
   Ptr<ChannelMatrix> channelMatrix;
-  Ptr<ThreeGppChannelParams> channelParams;
 
 
   if (m_channelParamsMap.find (channelParamsKey) != m_channelParamsMap.end ())
     {
-      channelParams = m_channelParamsMap[channelParamsKey];
+      *channelParams = m_channelParamsMap[channelParamsKey];
       // check if it has to be updated
-      updateParams = ChannelParamsNeedsUpdate (channelParams, condition);
+      updateParams = ChannelParamsNeedsUpdate (*channelParams, condition);
     }
   else
     {
@@ -1126,7 +1128,7 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   double hBs = std::max (aMob->GetPosition ().z, bMob->GetPosition ().z);
 
   // get the 3GPP parameters
-  Ptr<const ParamsTable> table3gpp = GetThreeGppTable (condition, hBs, hUt, distance2D);
+  *table3gpp = GetThreeGppTable (condition, hBs, hUt, distance2D);
 
   if (notFoundParams || updateParams)
     {
@@ -1138,9 +1140,9 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
       //shuffle all the arrays to perform random coupling
       //Step 9: Generate the cross polarization power ratios
       //Step 10: Draw initial phases
-      channelParams = GenerateChannelParameters (condition, table3gpp, aMob, bMob);
+      *channelParams = GenerateChannelParameters (condition, *table3gpp, aMob, bMob);
       // store or replace the channel parameters
-      m_channelParamsMap[channelParamsKey] = channelParams;
+      m_channelParamsMap[channelParamsKey] = *channelParams;
     }
 
   if (m_channelMatrixMap.find (channelMatrixKey) != m_channelMatrixMap.end ())
@@ -1148,7 +1150,7 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
       // channel matrix present in the map
       NS_LOG_DEBUG ("channel matrix present in the map");
       channelMatrix = m_channelMatrixMap[channelMatrixKey];
-      updateMatrix = ChannelMatrixNeedsUpdate (channelParams, channelMatrix);
+      updateMatrix = ChannelMatrixNeedsUpdate (*channelParams, channelMatrix);
     }
   else
     {
@@ -1157,20 +1159,96 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
     }
 
   // If the channel is not present in the map or if it has to be updated
-  // generate a new realization
+  // a new realization has to be generated
   if (notFoundMatrix || updateMatrix)
+    {
+      return nullptr;
+    }
+  return channelMatrix;
+}
+
+Ptr<const MatrixBasedChannelModel::ChannelMatrix>
+ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
+                                  Ptr<const MobilityModel> bMob,
+                                  Ptr<const PhasedArrayModel> aAntenna,
+                                  Ptr<const PhasedArrayModel> bAntenna)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<ThreeGppChannelParams> channelParams;
+  Ptr<const ParamsTable> table3gpp;
+  Ptr<ChannelMatrix> channelMatrix = GetValidChannel (aMob, bMob, aAntenna, bAntenna, &channelParams, &table3gpp);
+
+  if (channelMatrix == nullptr)
     {
       // channel matrix not found or has to be updated, generate a new one
       channelMatrix = GetNewChannel (channelParams, table3gpp, aMob, bMob, aAntenna, bAntenna);
       channelMatrix->m_antennaPair = std::make_pair (aAntenna->GetId (), bAntenna->GetId ()); // save antenna pair, with the exact order of s and u antennas at the moment of the channel generation
 
       // store or replace the channel matrix in the channel map
-      m_channelMatrixMap[channelMatrixKey] = channelMatrix;
+      m_channelMatrixMap[GetKey (aAntenna->GetId (), bAntenna->GetId ())] = channelMatrix;
     }
 
   return channelMatrix;
 }
 
+void
+ThreeGppChannelModel::PrecomputeChannels (const std::vector<ChannelLink> &links, uint32_t numThreads)
+{
+  NS_LOG_FUNCTION (this << links.size () << numThreads);
+
+  NS_ASSERT_MSG (m_frequency > 0.0, "Set the operating frequency first!");
+
+  // The inputs of the computation of the coefficients of a channel matrix.
+  // The tasks only use raw pointers, as the reference counts are not thread
+  // safe; the objects are kept alive by the maps and by the vectors below.
+  struct Job
+  {
+    const ThreeGppChannelParams *m_params;
+    const ParamsTable *m_table;
+    Vector m_sPos;
+    Vector m_uPos;
+    const PhasedArrayModel *m_sAntenna;
+    const PhasedArrayModel *m_uAntenna;
+    ChannelMatrix *m_matrix;
+  };
+  std::vector<Job> jobs;
+  std::vector<Ptr<const ParamsTable>> tables;
+
+  for (const auto &link : links)
+    {
+      Ptr<ThreeGppChannelParams> channelParams;
+      Ptr<const ParamsTable> table3gpp;
+      if (GetValidChannel (link.m_aMob, link.m_bMob, link.m_aAntenna, link.m_bAntenna,
+                           &channelParams, &table3gpp) != nullptr)
+        {
+          continue;
+        }
+
+      Ptr<ChannelMatrix> channelMatrix = Create<ChannelMatrix> ();
+      channelMatrix->m_generatedTime = Simulator::Now ();
+      channelMatrix->m_nodeIds = std::make_pair (link.m_aMob->GetObject<Node> ()->GetId (), link.m_bMob->GetObject<Node> ()->GetId ());
+      channelMatrix->m_antennaPair = std::make_pair (link.m_aAntenna->GetId (), link.m_bAntenna->GetId ());
+      // store the matrix now, so that a repeated link finds it
+      m_channelMatrixMap[GetKey (link.m_aAntenna->GetId (), link.m_bAntenna->GetId ())] = channelMatrix;
+
+      jobs.push_back ({PeekPointer (channelParams), PeekPointer (table3gpp),
+                       link.m_aMob->GetPosition (), link.m_bMob->GetPosition (),
+                       PeekPointer (link.m_aAntenna), PeekPointer (link.m_bAntenna),
+                       PeekPointer (channelMatrix)});
+      tables.push_back (table3gpp);
+    }
+
+  NS_LOG_DEBUG ("Generating " << jobs.size () << " channel matrices of " << links.size () << " links");
+  WorkerPool pool (std::max<uint32_t> (numThreads, 1));
+  pool.Run (jobs.size (), [this, &jobs] (std::size_t i)
+    {
+      const Job &job = jobs[i];
+      GenerateChannelCoefficients (*job.m_params, *job.m_table, job.m_sPos, job.m_uPos,
+                                   *job.m_sAntenna, *job.m_uAntenna, job.m_matrix);
+    });
+}
+
 Ptr<const MatrixBasedChannelModel::ChannelParams>
 ThreeGppChannelModel::GetParams (Ptr<const MobilityModel> aMob,
                                  Ptr<const MobilityModel> bMob) const
@@ -1578,10 +1656,11 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
 
   //Step 8: Coupling of rays within a cluster for both azimuth and elevation
   //shuffle all the arrays to perform random coupling
-  MatrixBasedChannelModel::Double2DVector rayAoaRadian (channelParams->m_reducedClusterNumber, DoubleVector (table3gpp->m_raysPerCluster, 0)); //rayAoaRadian[n][m], where n is cluster index, m is ray index
-  MatrixBasedChannelModel::Double2DVector rayAodRadian (channelParams->m_reducedClusterNumber, DoubleVector (table3gpp->m_raysPerCluster, 0)); //rayAodRadian[n][m], where n is cluster index, m is ray index
-  MatrixBasedChannelModel::Double2DVector rayZoaRadian (channelParams->m_reducedClusterNumber, DoubleVector (table3gpp->m_raysPerCluster, 0)); //rayZoaRadian[n][m], where n is cluster index, m is ray index
-  MatrixBasedChannelModel::Double2DVector rayZodRadian (channelParams->m_reducedClusterNumber, DoubleVector (table3gpp->m_raysPerCluster, 0)); //rayZodRadian[n][m], where n is cluster index, m is ray index
+  //the rays of a cluster are contiguous, so that they can be shuffled in place
+  MatrixBasedChannelModel::DoubleArray rayAoaRadian (table3gpp->m_raysPerCluster, channelParams->m_reducedClusterNumber); //rayAoaRadian(m, n), where n is cluster index, m is ray index
+  MatrixBasedChannelModel::DoubleArray rayAodRadian (table3gpp->m_raysPerCluster, channelParams->m_reducedClusterNumber); //rayAodRadian(m, n), where n is cluster index, m is ray index
+  MatrixBasedChannelModel::DoubleArray rayZoaRadian (table3gpp->m_raysPerCluster, channelParams->m_reducedClusterNumber); //rayZoaRadian(m, n), where n is cluster index, m is ray index
+  MatrixBasedChannelModel::DoubleArray rayZodRadian (table3gpp->m_raysPerCluster, channelParams->m_reducedClusterNumber); //rayZodRadian(m, n), where n is cluster index, m is ray index
 
   for (uint8_t nInd = 0; nInd < channelParams->m_reducedClusterNumber; nInd++)
     {
@@ -1589,55 +1668,51 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
         {
           double tempAoa = clusterAoa[nInd] + table3gpp->m_cASA * offSetAlpha[mInd]; //(7.5-13)
           double tempZoa = clusterZoa[nInd] + table3gpp->m_cZSA * offSetAlpha[mInd]; //(7.5-18)
-          std::tie (rayAoaRadian[nInd][mInd], rayZoaRadian[nInd][mInd]) = WrapAngles (DegreesToRadians (tempAoa), DegreesToRadians (tempZoa));
+          std::tie (rayAoaRadian (mInd, nInd), rayZoaRadian (mInd, nInd)) = WrapAngles (DegreesToRadians (tempAoa), DegreesToRadians (tempZoa));
 
           double tempAod = clusterAod[nInd] + table3gpp->m_cASD * offSetAlpha[mInd]; //(7.5-13)
           double tempZod = clusterZod[nInd] + 0.375 * pow (10,table3gpp->m_uLgZSD) * offSetAlpha[mInd]; //(7.5-20)
-          std::tie (rayAodRadian[nInd][mInd], rayZodRadian[nInd][mInd]) = WrapAngles (DegreesToRadians (tempAod), DegreesToRadians (tempZod));
+          std::tie (rayAodRadian (mInd, nInd), rayZodRadian (mInd, nInd)) = WrapAngles (DegreesToRadians (tempAod), DegreesToRadians (tempZod));
         }
     }
 
   for (uint8_t cIndex = 0; cIndex < channelParams->m_reducedClusterNumber; cIndex++)
     {
-      Shuffle (&rayAodRadian[cIndex][0], &rayAodRadian[cIndex][table3gpp->m_raysPerCluster]);
-      Shuffle (&rayAoaRadian[cIndex][0], &rayAoaRadian[cIndex][table3gpp->m_raysPerCluster]);
-      Shuffle (&rayZodRadian[cIndex][0], &rayZodRadian[cIndex][table3gpp->m_raysPerCluster]);
-      Shuffle (&rayZoaRadian[cIndex][0], &rayZoaRadian[cIndex][table3gpp->m_raysPerCluster]);
+      Shuffle (&rayAodRadian (0, cIndex), &rayAodRadian (0, cIndex) + table3gpp->m_raysPerCluster);
+      Shuffle (&rayAoaRadian (0, cIndex), &rayAoaRadian (0, cIndex) + table3gpp->m_raysPerCluster);
+      Shuffle (&rayZodRadian (0, cIndex), &rayZodRadian (0, cIndex) + table3gpp->m_raysPerCluster);
+      Shuffle (&rayZoaRadian (0, cIndex), &rayZoaRadian (0, cIndex) + table3gpp->m_raysPerCluster);
     }
 
   // store values
-  channelParams->m_rayAodRadian = rayAodRadian;
-  channelParams->m_rayAoaRadian = rayAoaRadian;
-  channelParams->m_rayZodRadian = rayZodRadian;
-  channelParams->m_rayZoaRadian = rayZoaRadian;
+  channelParams->m_rayAodRadian = std::move (rayAodRadian);
+  channelParams->m_rayAoaRadian = std::move (rayAoaRadian);
+  channelParams->m_rayZodRadian = std::move (rayZodRadian);
+  channelParams->m_rayZoaRadian = std::move (rayZoaRadian);
 
   //Step 9: Generate the cross polarization power ratios
   //Step 10: Draw initial phases
-  Double2DVector crossPolarizationPowerRatios; // vector containing the cross polarization power ratios, as defined by 7.5-21
-  Double3DVector clusterPhase; //rayAoaRadian[n][m], where n is cluster index, m is ray index
+  // cross polarization power ratios, as defined by 7.5-21, crossPolarizationPowerRatios(m, n)
+  DoubleArray crossPolarizationPowerRatios (table3gpp->m_raysPerCluster, channelParams->m_reducedClusterNumber);
+  // initial phases for all the possible combination of polarization, clusterPhase(p, m, n)
+  DoubleArray clusterPhase (4, table3gpp->m_raysPerCluster, channelParams->m_reducedClusterNumber);
   for (uint8_t nInd = 0; nInd < channelParams->m_reducedClusterNumber; nInd++)
     {
-      DoubleVector temp; // used to store the XPR values
-      Double2DVector temp2; // used to store the PHI values for all the possible combination of polarization
       for (uint8_t mInd = 0; mInd < table3gpp->m_raysPerCluster; mInd++)
         {
           double uXprLinear = pow (10, table3gpp->m_uXpr / 10); // convert to linear
           double sigXprLinear = pow (10, table3gpp->m_sigXpr / 10); // convert to linear
 
-          temp.push_back (std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
-          DoubleVector temp3; // used to store the PHI valuse
+          crossPolarizationPowerRatios (mInd, nInd) = std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10);
           for (uint8_t pInd = 0; pInd < 4; pInd++)
             {
-              temp3.push_back (m_uniformRv->GetValue (-1 * M_PI, M_PI));
+              clusterPhase (pInd, mInd, nInd) = m_uniformRv->GetValue (-1 * M_PI, M_PI);
             }
-          temp2.push_back (temp3);
         }
-      crossPolarizationPowerRatios.push_back (temp);
-      clusterPhase.push_back (temp2);
     }
   // store the cluster phase
-  channelParams->m_clusterPhase = clusterPhase;
-  channelParams->m_crossPolarizationPowerRatios = crossPolarizationPowerRatios;
+  channelParams->m_clusterPhase = std::move (clusterPhase);
+  channelParams->m_crossPolarizationPowerRatios = std::move (crossPolarizationPowerRatios);
 
   uint8_t cluster1st = 0, cluster2nd = 0; // first and second strongest cluster;
   double maxPower = 0;
@@ -1782,124 +1857,173 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
   channelMatrix->m_generatedTime = Simulator::Now ();
   // save in which order is generated this matrix
   channelMatrix->m_nodeIds = std::make_pair (sMob->GetObject<Node> ()->GetId (), uMob->GetObject<Node> ()->GetId ());
-  // check if channelParams structure is generated in direction s-to-u or u-to-s
-  bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-  MatrixBasedChannelModel::Double2DVector rayAodRadian;
-  MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-  MatrixBasedChannelModel::Double2DVector rayZodRadian;
-  MatrixBasedChannelModel::Double2DVector rayZoaRadian;
+  GenerateChannelCoefficients (*channelParams, *table3gpp, sMob->GetPosition (), uMob->GetPosition (),
+                               *sAntenna, *uAntenna, PeekPointer (channelMatrix));
+  return channelMatrix;
+}
+
+void
+ThreeGppChannelModel::GenerateChannelCoefficients (const ThreeGppChannelParams &channelParams,
+                                                   const ParamsTable &table3gpp,
+                                                   const Vector &sPos,
+                                                   const Vector &uPos,
+                                                   const PhasedArrayModel &sAntenna,
+                                                   const PhasedArrayModel &uAntenna,
+                                                   ChannelMatrix *channelMatrix) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // check if channelParams structure is generated in direction s-to-u or u-to-s
+  bool isSameDirection = (channelParams.m_nodeIds == channelMatrix->m_nodeIds);
 
   // if channel params is generated in the same direction in which we
   // generate the channel matrix, angles and zenit od departure and arrival are ok,
   // just set them to corresponding variable that will be used for the generation
   // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-  if (isSameDirection)
-    {
-      rayAodRadian = channelParams->m_rayAodRadian;
-      rayAoaRadian = channelParams->m_rayAoaRadian;
-      rayZodRadian = channelParams->m_rayZodRadian;
-      rayZoaRadian = channelParams->m_rayZoaRadian;
-    }
-  else
-    {
-      rayAodRadian = channelParams->m_rayAoaRadian;
-      rayAoaRadian = channelParams->m_rayAodRadian;
-      rayZodRadian = channelParams->m_rayZoaRadian;
-      rayZoaRadian = channelParams->m_rayZodRadian;
-    }
+  const DoubleArray &rayAodRadian = isSameDirection ? channelParams.m_rayAodRadian : channelParams.m_rayAoaRadian;
+  const DoubleArray &rayAoaRadian = isSameDirection ? channelParams.m_rayAoaRadian : channelParams.m_rayAodRadian;
+  const DoubleArray &rayZodRadian = isSameDirection ? channelParams.m_rayZodRadian : channelParams.m_rayZoaRadian;
+  const DoubleArray &rayZoaRadian = isSameDirection ? channelParams.m_rayZoaRadian : channelParams.m_rayZodRadian;
+
+  uint64_t uSize = uAntenna.GetNumberOfElements ();
+  uint64_t sSize = sAntenna.GetNumberOfElements ();
+  uint8_t numRays = table3gpp.m_raysPerCluster;
+  uint8_t numReducedClusters = channelParams.m_reducedClusterNumber;
+
+  NS_ASSERT (numReducedClusters <= channelParams.m_clusterPhase.GetNumPages ());
+  NS_ASSERT (numReducedClusters <= channelParams.m_clusterPower.size ());
+  NS_ASSERT (numReducedClusters <= channelParams.m_crossPolarizationPowerRatios.GetNumCols ());
+  NS_ASSERT (numReducedClusters <= rayZoaRadian.GetNumCols ());
+  NS_ASSERT (numReducedClusters <= rayZodRadian.GetNumCols ());
+  NS_ASSERT (numReducedClusters <= rayAoaRadian.GetNumCols ());
+  NS_ASSERT (numReducedClusters <= rayAodRadian.GetNumCols ());
+  NS_ASSERT (4 <= channelParams.m_clusterPhase.GetNumRows ());
+  NS_ASSERT (numRays <= channelParams.m_clusterPhase.GetNumCols ());
+  NS_ASSERT (numRays <= channelParams.m_crossPolarizationPowerRatios.GetNumRows ());
+  NS_ASSERT (numRays <= rayZoaRadian.GetNumRows ());
+  NS_ASSERT (numRays <= rayZodRadian.GetNumRows ());
+  NS_ASSERT (numRays <= rayAoaRadian.GetNumRows ());
+  NS_ASSERT (numRays <= rayAodRadian.GetNumRows ());
 
   //Step 11: Generate channel coefficients for each cluster n and each receiver
   // and transmitter element pair u,s.
-  Complex3DVector hUsn;  //channel coffecient hUsn[u][s][n];
-  // where u and s are receive and transmit antenna element, n is cluster index.
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
-  // the total cluster will be numReducedCLuster + 4.
-  uint64_t uSize = uAntenna->GetNumberOfElements ();
-  uint64_t sSize = sAntenna->GetNumberOfElements ();
-
-  hUsn.resize (uSize);
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+  // the total cluster will be numReducedCLuster + 4. The second and the third
+  // sub-clusters of the strongest clusters are stored after the other clusters,
+  // in the order of the index of the strongest cluster.
+  uint8_t numStrongClusters = 0;
+  std::vector<uint8_t> subClusterIndex (numReducedClusters, 0);
+  for (uint8_t nIndex = 0; nIndex < numReducedClusters; nIndex++)
     {
-      hUsn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+      if (nIndex == channelParams.m_cluster1st || nIndex == channelParams.m_cluster2nd)
         {
-          hUsn[uIndex][sIndex].resize (channelParams->m_reducedClusterNumber);
+          subClusterIndex[nIndex] = numReducedClusters + 2 * numStrongClusters++;
         }
     }
+  // channel coefficient hUsn(u, s, n), where u and s are receive and transmit
+  // antenna element, n is cluster index.
+  Complex3DVector hUsn (uSize, sSize, numReducedClusters + 2 * numStrongClusters);
+
+  // The terms of a ray that do not depend on the antenna elements: the
+  // polarization term (7.5-22), and the phase of each element (the rx phase
+  // rxPhase(m, n, u) and the tx phase txPhase(m, n, s)).
+  // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
+  Complex3DVector rayPolarization (numRays, numReducedClusters);
+  Complex3DVector rxPhase (numRays, numReducedClusters, uSize);
+  Complex3DVector txPhase (numRays, numReducedClusters, sSize);
+  auto computeElementPhases = [numRays, numReducedClusters] (const DoubleArray &azimuth, const DoubleArray &zenith,
+                                                             const PhasedArrayModel &antenna, Complex3DVector &phase)
+    {
+      DoubleArray direction (3, numRays, numReducedClusters);
+      for (uint8_t nIndex = 0; nIndex < numReducedClusters; nIndex++)
+        {
+          for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+            {
+              direction (0, mIndex, nIndex) = sin (zenith (mIndex, nIndex)) * cos (azimuth (mIndex, nIndex));
+              direction (1, mIndex, nIndex) = sin (zenith (mIndex, nIndex)) * sin (azimuth (mIndex, nIndex));
+              direction (2, mIndex, nIndex) = cos (zenith (mIndex, nIndex));
+            }
+        }
+      for (uint64_t eIndex = 0; eIndex < phase.GetNumPages (); eIndex++)
+        {
+          //lambda_0 is accounted in the antenna spacing of the element location.
+          Vector loc = antenna.GetElementLocation (eIndex);
+          for (uint8_t nIndex = 0; nIndex < numReducedClusters; nIndex++)
+            {
+              for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+                {
+                  double phaseDiff = 2 * M_PI * (direction (0, mIndex, nIndex) * loc.x
+                                                 + direction (1, mIndex, nIndex) * loc.y
+                                                 + direction (2, mIndex, nIndex) * loc.z);
+                  phase (mIndex, nIndex, eIndex) = std::complex<double> (cos (phaseDiff), sin (phaseDiff));
+                }
+            }
+        }
+    };
+  computeElementPhases (rayAoaRadian, rayZoaRadian, uAntenna, rxPhase);
+  computeElementPhases (rayAodRadian, rayZodRadian, sAntenna, txPhase);
 
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_crossPolarizationPowerRatios.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZodRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAodRadian.size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_crossPolarizationPowerRatios[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZodRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAodRadian[0].size ());
-
+  for (uint8_t nIndex = 0; nIndex < numReducedClusters; nIndex++)
+    {
+      bool isStrong = (nIndex == channelParams.m_cluster1st || nIndex == channelParams.m_cluster2nd);
+      for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+        {
+          const double *initialPhase = &channelParams.m_clusterPhase (0, mIndex, nIndex);
+          double k = channelParams.m_crossPolarizationPowerRatios (mIndex, nIndex);
+          double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+          if (isStrong)
+            {
+              //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (rayAoaRadian (mIndex, nIndex), rayZoaRadian (mIndex, nIndex)));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (rayAodRadian (mIndex, nIndex), rayZodRadian (mIndex, nIndex)));
+            }
+          else
+            {
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (channelParams.m_rayAoaRadian (mIndex, nIndex), channelParams.m_rayZoaRadian (mIndex, nIndex)));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (channelParams.m_rayAodRadian (mIndex, nIndex), channelParams.m_rayZodRadian (mIndex, nIndex)));
+            }
+          rayPolarization (mIndex, nIndex) = std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
+            std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
+            std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
+            std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi;
+        }
+    }
 
-  double x = sMob->GetPosition ().x - uMob->GetPosition ().x;
-  double y = sMob->GetPosition ().y - uMob->GetPosition ().y;
+  double x = sPos.x - uPos.x;
+  double y = sPos.y - uPos.y;
   double distance2D = sqrt (x * x + y * y);
   // NOTE we assume hUT = min (height(a), height(b)) and
   // hBS = max (height (a), height (b))
-  double hUt = std::min (sMob->GetPosition ().z, uMob->GetPosition ().z);
-  double hBs = std::max (sMob->GetPosition ().z, uMob->GetPosition ().z);
+  double hUt = std::min (sPos.z, uPos.z);
+  double hBs = std::max (sPos.z, uPos.z);
   // compute the 3D distance using eq. 7.4-1
   double distance3D = std::sqrt (distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
 
-  Angles sAngle (uMob->GetPosition (), sMob->GetPosition ());
-  Angles uAngle (sMob->GetPosition (), uMob->GetPosition ());
-
+  Angles sAngle (uPos, sPos);
+  Angles uAngle (sPos, uPos);
 
   // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      Vector uLoc = uAntenna->GetElementLocation (uIndex);
-
       for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-          Vector sLoc = sAntenna->GetElementLocation (sIndex);
-
-          for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+          for (uint8_t nIndex = 0; nIndex < numReducedClusters; nIndex++)
             {
+              const std::complex<double> *polarization = &rayPolarization (0, nIndex);
+              const std::complex<double> *rxRayPhase = &rxPhase (0, nIndex, uIndex);
+              const std::complex<double> *txRayPhase = &txPhase (0, nIndex, sIndex);
               //Compute the N-2 weakest cluster, assuming 0 slant angle and a
               //polarization slant angle configured in the array (7.5-22)
-              if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+              if (nIndex != channelParams.m_cluster1st && nIndex != channelParams.m_cluster2nd)
                 {
                   std::complex<double> rays (0,0);
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
                     {
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-                      //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
-                      // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAoaRadian[nIndex][mIndex], channelParams->m_rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAodRadian[nIndex][mIndex], channelParams->m_rayZodRadian[nIndex][mIndex]));
-                      NS_ASSERT (4 <= initialPhase.size ());
-                      rays += (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                               std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                               std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                               std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                        * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
+                      rays += polarization[mIndex] * rxRayPhase[mIndex] * txRayPhase[mIndex];
                     }
-                  rays *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = rays;
+                  rays *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  hUsn (uIndex, sIndex, nIndex) = rays;
                 }
               else  //(7.5-28)
                 {
@@ -1907,31 +2031,9 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                   std::complex<double> raysSub2 (0, 0);
                   std::complex<double> raysSub3 (0, 0);
 
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
                     {
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-
-                      //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      NS_ASSERT (4 <= initialPhase.size ());
-
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
-
-                      std::complex<double> raySub = (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                                     std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                                     std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                                     std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                        * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
+                      std::complex<double> raySub = polarization[mIndex] * rxRayPhase[mIndex] * txRayPhase[mIndex];
 
                       switch (mIndex)
                         {
@@ -1954,62 +2056,80 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                             break;
                         }
                     }
-                  raysSub1 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub2 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub3 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = raysSub1;
-                  hUsn[uIndex][sIndex].push_back (raysSub2);
-                  hUsn[uIndex][sIndex].push_back (raysSub3);
+                  raysSub1 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  raysSub2 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  raysSub3 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  hUsn (uIndex, sIndex, nIndex) = raysSub1;
+                  hUsn (uIndex, sIndex, subClusterIndex[nIndex]) = raysSub2;
+                  hUsn (uIndex, sIndex, subClusterIndex[nIndex] + 1) = raysSub3;
                 }
             }
+        }
+    }
+
+  if (channelParams.m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+    {
+      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
+      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
+
+      double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
+
+      std::complex<double> losRay = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
+        * std::complex<double> (cos (-2 * M_PI * distance3D / lambda), sin (-2 * M_PI * distance3D / lambda));
+
+      PhasedArrayModel::ComplexVector rxLosPhase (uSize);
+      for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+        {
+          Vector uLoc = uAntenna.GetElementLocation (uIndex);
+          double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc.x
+                                           + sin (uAngle.GetInclination ()) * sin (uAngle.GetAzimuth ()) * uLoc.y
+                                           + cos (uAngle.GetInclination ()) * uLoc.z);
+          rxLosPhase[uIndex] = std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff));
+        }
+      PhasedArrayModel::ComplexVector txLosPhase (sSize);
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          Vector sLoc = sAntenna.GetElementLocation (sIndex);
+          double txPhaseDiff = 2 * M_PI * (sin (sAngle.GetInclination ()) * cos (sAngle.GetAzimuth ()) * sLoc.x
+                                           + sin (sAngle.GetInclination ()) * sin (sAngle.GetAzimuth ()) * sLoc.y
+                                           + cos (sAngle.GetInclination ()) * sLoc.z);
+          txLosPhase[sIndex] = std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
+        }
 
-          if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+      double kLinear = pow (10, channelParams.m_K_factor / 10);
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
             {
-              std::complex<double> ray (0, 0);
-              double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc.x
-                                               + sin (uAngle.GetInclination ()) * sin (uAngle.GetAzimuth ()) * uLoc.y
-                                               + cos (uAngle.GetInclination ()) * uLoc.z);
-              double txPhaseDiff = 2 * M_PI * (sin (sAngle.GetInclination ()) * cos (sAngle.GetAzimuth ()) * sLoc.x
-                                               + sin (sAngle.GetInclination ()) * sin (sAngle.GetAzimuth ()) * sLoc.y
-                                               + cos (sAngle.GetInclination ()) * sLoc.z);
-
-              double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
-              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
-
-              double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
-
-              ray = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
-                * std::complex<double> (cos (-2 * M_PI * distance3D / lambda), sin (-2 * M_PI * distance3D / lambda))
-                * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
-
-              double kLinear = pow (10, channelParams->m_K_factor / 10);
+              std::complex<double> ray = losRay * rxLosPhase[uIndex] * txLosPhase[sIndex];
               // the LOS path should be attenuated if blockage is enabled.
-              hUsn[uIndex][sIndex][0] = sqrt (1 / (kLinear + 1)) * hUsn[uIndex][sIndex][0] + sqrt (kLinear / (1 + kLinear)) * ray / pow (10, channelParams->m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = hUsn[uIndex][sIndex].size ();
-              for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
-                {
-                  hUsn[uIndex][sIndex][nIndex] *= sqrt (1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
-                }
+              hUsn (uIndex, sIndex, 0) = sqrt (1 / (kLinear + 1)) * hUsn (uIndex, sIndex, 0) + sqrt (kLinear / (1 + kLinear)) * ray / pow (10, channelParams.m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
             }
         }
+      for (std::size_t index = uSize * sSize; index < hUsn.GetSize (); index++)
+        {
+          hUsn[index] *= sqrt (1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
+        }
     }
 
-  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna->GetId () << ", " << uAntenna->GetId ());
-  for (auto& i:hUsn)
+  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna.GetId () << ", " << uAntenna.GetId ());
+  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      for (auto& j:i)
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-          for (auto& k:j)
+          for (std::size_t nIndex = 0; nIndex < hUsn.GetNumPages (); nIndex++)
             {
-              NS_LOG_DEBUG (" " << k << ",");
+              NS_LOG_DEBUG (" " << hUsn (uIndex, sIndex, nIndex) << ",");
             }
         }
     }
-  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.size () << "][" << hUsn[0].size () << "][" << hUsn[0][0].size () << "]");
-  channelMatrix->m_channel = hUsn;
-  return channelMatrix;
+  // a nested vector [u][s][n] would need uSize * (sSize + 1) + 1 allocations,
+  // and a vector header for each of them
+  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.GetNumRows () << "][" << hUsn.GetNumCols () << "][" << hUsn.GetNumPages () << "], "
+               << hUsn.GetSizeInBytes () << " bytes in a single allocation, "
+               << (uSize * (sSize + 1) + 1) * sizeof (PhasedArrayModel::ComplexVector) << " bytes of vector headers saved");
+  channelMatrix->m_channel = std::move (hUsn);
 }
 
 std::pair<double, double>
@@ -120,6 +120,35 @@ public:
                                        Ptr<const PhasedArrayModel> bAntenna) override;
 
 
+  /**
+   * A pair of devices, with their antenna arrays, whose channel matrix is
+   * generated by PrecomputeChannels
+   */
+  struct ChannelLink
+  {
+    Ptr<const MobilityModel> m_aMob; //!< mobility model of the a device
+    Ptr<const MobilityModel> m_bMob; //!< mobility model of the b device
+    Ptr<const PhasedArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const PhasedArrayModel> m_bAntenna; //!< antenna of the b device
+  };
+
+  /**
+   * Generate the channel matrices of a set of links, as GetChannel does when
+   * it is called for each of them, so that the first transmissions do not
+   * pay for their generation.
+   *
+   * The links are visited in order to retrieve the channel conditions and to
+   * generate the channel parameters, which draw from the random variables
+   * of the model; the channel coefficients, that do not use any random
+   * variable, are then computed on a pool of threads. Hence the realizations
+   * only depend on the order of the links, and not on the number of threads.
+   * The links whose channel matrix is present and valid are skipped.
+   *
+   * \param links the links
+   * \param numThreads the number of threads, including the calling one
+   */
+  void PrecomputeChannels (const std::vector<ChannelLink> &links, uint32_t numThreads);
+
   /**
    * Looks for the channel params associated to the aMob and bMob pair in
    * m_channelParamsMap. If not found it will return a nullptr.
@@ -180,12 +209,12 @@ protected:
     double m_DS; //!< delay spread
     double m_K_factor; //!< K factor
     uint8_t m_reducedClusterNumber; //!< reduced cluster number;
-    MatrixBasedChannelModel::Double2DVector m_rayAodRadian; //!< the vector containing AOD angles
-    MatrixBasedChannelModel::Double2DVector m_rayAoaRadian; //!< the vector containing AOA angles
-    MatrixBasedChannelModel::Double2DVector m_rayZodRadian; //!< the vector containing ZOD angles
-    MatrixBasedChannelModel::Double2DVector m_rayZoaRadian; //!< the vector containing ZOA angles
-    MatrixBasedChannelModel::Double3DVector m_clusterPhase; //!< the initial random phases
-    MatrixBasedChannelModel::Double2DVector m_crossPolarizationPowerRatios;//!< cross polarization power ratios
+    MatrixBasedChannelModel::DoubleArray m_rayAodRadian; //!< the AOD angles, (m, n) for the ray m of the cluster n
+    MatrixBasedChannelModel::DoubleArray m_rayAoaRadian; //!< the AOA angles, (m, n) for the ray m of the cluster n
+    MatrixBasedChannelModel::DoubleArray m_rayZodRadian; //!< the ZOD angles, (m, n) for the ray m of the cluster n
+    MatrixBasedChannelModel::DoubleArray m_rayZoaRadian; //!< the ZOA angles, (m, n) for the ray m of the cluster n
+    MatrixBasedChannelModel::DoubleArray m_clusterPhase; //!< the initial random phases, (p, m, n) for the polarization p of the ray m of the cluster n
+    MatrixBasedChannelModel::DoubleArray m_crossPolarizationPowerRatios;//!< cross polarization power ratios, (m, n) for the ray m of the cluster n
     Vector m_speed; //!< velocity
     double m_dis2D; //!< 2D distance between tx and rx
     double m_dis3D; //!< 3D distance between tx and rx
@@ -276,13 +305,58 @@ protected:
    * \param uAntenna the antenna array of node u
    * \return the channel realization
    */
-
-  virtual Ptr<ChannelMatrix> GetNewChannel (Ptr<const ThreeGppChannelParams> channelParams,
+  Ptr<ChannelMatrix> GetNewChannel (Ptr<const ThreeGppChannelParams> channelParams,
                                     Ptr<const ParamsTable> table3gpp,
                                     const Ptr<const MobilityModel> sMob,
                                     const Ptr<const MobilityModel> uMob,
                                     Ptr<const PhasedArrayModel> sAntenna,
                                     Ptr<const PhasedArrayModel> uAntenna) const;
+
+  /**
+   * Compute the coefficients of the channel matrix between two nodes s and
+   * u, and their antenna arrays sAntenna and uAntenna, using the procedure
+   * described in 3GPP TR 38.901 (step 11).
+   *
+   * This method does not use any random variable nor the reference counts of
+   * the objects, so that PrecomputeChannels can call it concurrently for
+   * different channel matrices.
+   *
+   * \param channelParams the channel parameters previously generated for the pair of nodes s and u
+   * \param table3gpp the 3gpp parameters table
+   * \param sPos the position of node s
+   * \param uPos the position of node u
+   * \param sAntenna the antenna array of node s
+   * \param uAntenna the antenna array of node u
+   * \param channelMatrix the channel matrix, whose m_nodeIds are set, where
+   *        the coefficients are stored
+   */
+  virtual void GenerateChannelCoefficients (const ThreeGppChannelParams &channelParams,
+                                            const ParamsTable &table3gpp,
+                                            const Vector &sPos,
+                                            const Vector &uPos,
+                                            const PhasedArrayModel &sAntenna,
+                                            const PhasedArrayModel &uAntenna,
+                                            ChannelMatrix *channelMatrix) const;
+
+  /**
+   * Retrieve the channel condition of a pair of nodes, and generate or update
+   * their channel parameters if needed.
+   * \param aMob mobility model of the a device
+   * \param bMob mobility model of the b device
+   * \param aAntenna antenna of the a device
+   * \param bAntenna antenna of the b device
+   * \param channelParams the channel parameters of the pair of nodes
+   * \param table3gpp the 3gpp parameters table of the pair of nodes
+   * \return the channel matrix of the pair of antennas if it is present and
+   *         valid, nullptr otherwise
+   */
+  Ptr<ChannelMatrix> GetValidChannel (Ptr<const MobilityModel> aMob,
+                                      Ptr<const MobilityModel> bMob,
+                                      Ptr<const PhasedArrayModel> aAntenna,
+                                      Ptr<const PhasedArrayModel> bAntenna,
+                                      Ptr<ThreeGppChannelParams> *channelParams,
+                                      Ptr<const ParamsTable> *table3gpp);
+
   /**
    * Applies the blockage model A described in 3GPP TR 38.901
    * \param channelParams the channel parameters structure
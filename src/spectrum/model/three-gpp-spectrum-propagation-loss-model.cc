@@ -29,7 +29,15 @@
 #include "ns3/string.h"
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <utility>
+
+#if defined (__AVX2__)
+#include <immintrin.h>
+#define NS3_BF_GAIN_AVX2
+#endif
 
 namespace ns3 {
 
@@ -114,27 +122,28 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   uint16_t sAntenna = static_cast<uint16_t> (sW.size ());
   uint16_t uAntenna = static_cast<uint16_t> (uW.size ());
 
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  NS_ASSERT (uAntenna == params->m_channel.GetNumRows ());
+  NS_ASSERT (sAntenna == params->m_channel.GetNumCols ());
 
   NS_LOG_DEBUG ("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
   //store the long term part to reduce computation load
   //only the small scale fading needs to be updated if the large scale parameters and antenna weights remain unchanged.
   PhasedArrayModel::ComplexVector longTerm;
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
-
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  uint8_t numCluster = static_cast<uint8_t> (params->m_channel.GetNumPages ());
+  longTerm.reserve (numCluster);
 
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
+      // the coefficients of a cluster are contiguous, H(u, s) at u + uAntenna * s
+      const std::complex<double> *hPage = params->m_channel.GetPagePtr (cIndex);
       std::complex<double> txSum (0, 0);
       for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
         {
+          const std::complex<double> *hCol = hPage + static_cast<std::size_t> (uAntenna) * sIndex;
           std::complex<double> rxSum (0, 0);
           for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
             {
-              rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
+              rxSum = rxSum + uW[uIndex] * hCol[uIndex];
             }
           txSum = txSum + sW[sIndex] * rxSum;
         }
@@ -143,19 +152,33 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   return longTerm;
 }
 
-Ptr<SpectrumValue>
-ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                                           PhasedArrayModel::ComplexVector longTerm,
+void
+ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (SpectrumValue &psd,
+                                                           const PhasedArrayModel::ComplexVector &longTerm,
                                                            Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
                                                            Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
                                                            const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
+  //channel[rx][tx][cluster]
+  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel.GetNumPages ());
+  NS_ASSERT (numCluster <= longTerm.size());
+  NS_ASSERT (numCluster <= channelParams->m_delay.size ());
+
+  PhasedArrayModel::ComplexVector doppler = CalcDoppler (channelMatrix, channelParams, sSpeed, uSpeed);
+  ApplyBeamformingGain (psd, longTerm, doppler, channelParams->m_delay, numCluster);
+}
+
+PhasedArrayModel::ComplexVector
+ThreeGppSpectrumPropagationLossModel::CalcDoppler (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                   Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                                   const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
+{
+  NS_LOG_FUNCTION (this);
 
   //channel[rx][tx][cluster]
-  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel[0][0].size ());
+  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel.GetNumPages ());
 
   // compute the doppler term
   // NOTE the update of Doppler is simplified by only taking the center angle of
@@ -175,35 +198,24 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
   NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
   NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
-  NS_ASSERT (numCluster <= longTerm.size());
 
   // check if channelParams structure is generated in direction s-to-u or u-to-s
   bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-  MatrixBasedChannelModel::DoubleVector zoa;
-  MatrixBasedChannelModel::DoubleVector zod;
-  MatrixBasedChannelModel::DoubleVector aoa;
-  MatrixBasedChannelModel::DoubleVector aod;
-
   // if channel params is generated in the same direction in which we
   // generate the channel matrix, angles and zenit od departure and arrival are ok,
-  // just set them to corresponding variable that will be used for the generation
-  // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-  if (isSameDirection)
-    {
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-  else
-    {
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-
+  // just refer to them with the names used for the generation of channel
+  // matrix, otherwise we need to flip angles and zenits of departure and arrival
+  const MatrixBasedChannelModel::Double2DVector &angle = channelParams->m_angle;
+  const MatrixBasedChannelModel::DoubleVector &zoa = angle[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX : MatrixBasedChannelModel::ZOD_INDEX];
+  const MatrixBasedChannelModel::DoubleVector &zod = angle[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX : MatrixBasedChannelModel::ZOA_INDEX];
+  const MatrixBasedChannelModel::DoubleVector &aoa = angle[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX : MatrixBasedChannelModel::AOD_INDEX];
+  const MatrixBasedChannelModel::DoubleVector &aod = angle[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX : MatrixBasedChannelModel::AOA_INDEX];
+
+  // with still nodes, only the scatterers contribute to the Doppler term
+  bool still = (sSpeed == Vector () && uSpeed == Vector ());
+
+  doppler.reserve (numCluster);
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
       // Compute alpha and D as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3
@@ -220,23 +232,43 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
       double alpha = channelParams->m_alpha [cIndex];
       double D = channelParams->m_D [cIndex];
 
-      //cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
-      double tempDoppler = factor * ((sin (zoa [cIndex] * M_PI / 180) * cos (aoa [cIndex] * M_PI / 180) * uSpeed.x
-                                       + sin (zoa [cIndex] * M_PI / 180) * sin (aoa [cIndex] * M_PI / 180) * uSpeed.y
-                                       + cos (zoa [cIndex] * M_PI / 180) * uSpeed.z)
-                                       + (sin (zod [cIndex] * M_PI / 180) * cos (aod [cIndex] * M_PI / 180) * sSpeed.x
-                                       + sin (zod [cIndex] * M_PI / 180) * sin (aod [cIndex] * M_PI / 180) * sSpeed.y
-                                       + cos (zod [cIndex] * M_PI / 180) * sSpeed.z) + 2 * alpha * D);
+      double tempDoppler;
+      if (still)
+        {
+          tempDoppler = factor * (2 * alpha * D);
+        }
+      else
+        {
+          //cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
+          double sinZoa = sin (zoa [cIndex] * M_PI / 180);
+          double sinZod = sin (zod [cIndex] * M_PI / 180);
+          tempDoppler = factor * ((sinZoa * cos (aoa [cIndex] * M_PI / 180) * uSpeed.x
+                                   + sinZoa * sin (aoa [cIndex] * M_PI / 180) * uSpeed.y
+                                   + cos (zoa [cIndex] * M_PI / 180) * uSpeed.z)
+                                   + (sinZod * cos (aod [cIndex] * M_PI / 180) * sSpeed.x
+                                   + sinZod * sin (aod [cIndex] * M_PI / 180) * sSpeed.y
+                                   + cos (zod [cIndex] * M_PI / 180) * sSpeed.z) + 2 * alpha * D);
+        }
       doppler.push_back (std::complex<double> (cos (tempDoppler), sin (tempDoppler)));
     }
 
   NS_ASSERT (numCluster <= doppler.size());
 
+  return doppler;
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGainDirect (SpectrumValue &psd,
+                                                                  const PhasedArrayModel::ComplexVector &longTerm,
+                                                                  const PhasedArrayModel::ComplexVector &doppler,
+                                                                  const MatrixBasedChannelModel::DoubleVector &clusterDelay,
+                                                                  uint8_t numCluster)
+{
   // apply the doppler term and the propagation delay to the long term component
   // to obtain the beamforming gain
-  auto vit = tempPsd->ValuesBegin (); // psd iterator
-  auto sbit = tempPsd->ConstBandsBegin (); // band iterator
-  while (vit != tempPsd->ValuesEnd ())
+  auto vit = psd.ValuesBegin (); // psd iterator
+  auto sbit = psd.ConstBandsBegin (); // band iterator
+  while (vit != psd.ValuesEnd ())
     {
       if ((*vit) != 0.00)
         {
@@ -244,7 +276,7 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
           double fsb = (*sbit).fc; // center frequency of the sub-band
           for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-              double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
+              double delay = -2 * M_PI * fsb * (clusterDelay[cIndex]);
               subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] * std::complex<double> (cos (delay), sin (delay));
             }
           *vit = (*vit) * (norm (subsbandGain));
@@ -252,73 +284,253 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
       vit++;
       sbit++;
     }
-  return tempPsd;
 }
 
+/**
+ * Number of sub-bands whose cluster phasors are advanced by the rotation,
+ * between two exact evaluations: it bounds the accumulated rounding error.
+ */
+static const std::size_t BF_GAIN_BLOCK = 32;
+
+/**
+ * Applies the beamforming gain to a block of sub-bands. The phasors of the
+ * clusters, stored in (sRe, sIm) with numPadded (a multiple of 4) entries,
+ * are multiplied by their rotation (rRe, rIm) after each sub-band. The sum
+ * over the clusters is split in 4 lanes (the cluster n goes to the lane
+ * n % 4), added in the order ((lane 0 + lane 1) + (lane 2 + lane 3)), as
+ * the AVX2 version does.
+ *
+ * \param psd the values of the sub-bands of the block
+ * \param numBands the number of sub-bands of the block
+ * \param sRe the real part of the phasors
+ * \param sIm the imaginary part of the phasors
+ * \param rRe the real part of the rotations
+ * \param rIm the imaginary part of the rotations
+ * \param numPadded the number of phasors
+ */
+static void
+BeamformingGainBlockScalar (double *psd, std::size_t numBands, double *sRe, double *sIm,
+                            const double *rRe, const double *rIm, std::size_t numPadded)
+{
+  for (std::size_t k = 0; k < numBands; ++k)
+    {
+      if (psd[k] != 0.0)
+        {
+          double accRe[4] = {0.0, 0.0, 0.0, 0.0};
+          double accIm[4] = {0.0, 0.0, 0.0, 0.0};
+          for (std::size_t n = 0; n < numPadded; ++n)
+            {
+              accRe[n % 4] += sRe[n];
+              accIm[n % 4] += sIm[n];
+            }
+          double re = (accRe[0] + accRe[1]) + (accRe[2] + accRe[3]);
+          double im = (accIm[0] + accIm[1]) + (accIm[2] + accIm[3]);
+          psd[k] *= re * re + im * im;
+        }
+      for (std::size_t n = 0; n < numPadded; ++n)
+        {
+          double re = sRe[n] * rRe[n] - sIm[n] * rIm[n];
+          double im = sRe[n] * rIm[n] + sIm[n] * rRe[n];
+          sRe[n] = re;
+          sIm[n] = im;
+        }
+    }
+}
+
+#ifdef NS3_BF_GAIN_AVX2
+/**
+ * AVX2 version of BeamformingGainBlockScalar, with the same order of the
+ * operations.
+ *
+ * \param psd the values of the sub-bands of the block
+ * \param numBands the number of sub-bands of the block
+ * \param sRe the real part of the phasors
+ * \param sIm the imaginary part of the phasors
+ * \param rRe the real part of the rotations
+ * \param rIm the imaginary part of the rotations
+ * \param numPadded the number of phasors
+ */
+static void
+BeamformingGainBlockAvx2 (double *psd, std::size_t numBands, double *sRe, double *sIm,
+                          const double *rRe, const double *rIm, std::size_t numPadded)
+{
+  for (std::size_t k = 0; k < numBands; ++k)
+    {
+      if (psd[k] != 0.0)
+        {
+          __m256d accRe = _mm256_setzero_pd ();
+          __m256d accIm = _mm256_setzero_pd ();
+          for (std::size_t n = 0; n < numPadded; n += 4)
+            {
+              accRe = _mm256_add_pd (accRe, _mm256_loadu_pd (sRe + n));
+              accIm = _mm256_add_pd (accIm, _mm256_loadu_pd (sIm + n));
+            }
+          alignas (32) double lanesRe[4];
+          alignas (32) double lanesIm[4];
+          _mm256_store_pd (lanesRe, accRe);
+          _mm256_store_pd (lanesIm, accIm);
+          double re = (lanesRe[0] + lanesRe[1]) + (lanesRe[2] + lanesRe[3]);
+          double im = (lanesIm[0] + lanesIm[1]) + (lanesIm[2] + lanesIm[3]);
+          psd[k] *= re * re + im * im;
+        }
+      for (std::size_t n = 0; n < numPadded; n += 4)
+        {
+          __m256d vsRe = _mm256_loadu_pd (sRe + n);
+          __m256d vsIm = _mm256_loadu_pd (sIm + n);
+          __m256d vrRe = _mm256_loadu_pd (rRe + n);
+          __m256d vrIm = _mm256_loadu_pd (rIm + n);
+          _mm256_storeu_pd (sRe + n, _mm256_sub_pd (_mm256_mul_pd (vsRe, vrRe), _mm256_mul_pd (vsIm, vrIm)));
+          _mm256_storeu_pd (sIm + n, _mm256_add_pd (_mm256_mul_pd (vsRe, vrIm), _mm256_mul_pd (vsIm, vrRe)));
+        }
+    }
+}
+#endif
+
+const char *
+ThreeGppSpectrumPropagationLossModel::GetBeamformingGainImplementationName ()
+{
+#ifdef NS3_BF_GAIN_AVX2
+  return "avx2";
+#else
+  return "scalar";
+#endif
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGain (SpectrumValue &psd,
+                                                            const PhasedArrayModel::ComplexVector &longTerm,
+                                                            const PhasedArrayModel::ComplexVector &doppler,
+                                                            const MatrixBasedChannelModel::DoubleVector &clusterDelay,
+                                                            uint8_t numCluster)
+{
+  std::size_t numBands = psd.GetValuesN ();
+  Bands::const_iterator bands = psd.ConstBandsBegin ();
+
+  // the recurrence needs uniformly spaced sub-bands (up to the rounding of
+  // their center frequencies)
+  bool uniform = numBands > 1;
+  double fc0 = bands[0].fc;
+  double step = uniform ? bands[1].fc - fc0 : 0.0;
+  for (std::size_t k = 2; uniform && k < numBands; ++k)
+    {
+      uniform = std::abs (bands[k].fc - (fc0 + k * step)) <= 1e-12 * std::abs (bands[k].fc);
+    }
+  if (!uniform || step == 0.0)
+    {
+      ApplyBeamformingGainDirect (psd, longTerm, doppler, clusterDelay, numCluster);
+      return;
+    }
+
+  // the clusters, padded to a multiple of 4 with null phasors
+  std::size_t numPadded = (numCluster + 3) / 4 * 4;
+  double sRe[256];
+  double sIm[256];
+  double rRe[256];
+  double rIm[256];
+  std::complex<double> h[256];
+  for (std::size_t n = 0; n < numPadded; ++n)
+    {
+      if (n < numCluster)
+        {
+          h[n] = longTerm[n] * doppler[n];
+          double rotation = -2 * M_PI * step * clusterDelay[n];
+          rRe[n] = cos (rotation);
+          rIm[n] = sin (rotation);
+        }
+      else
+        {
+          h[n] = 0.0;
+          rRe[n] = 0.0;
+          rIm[n] = 0.0;
+        }
+    }
+
+  double *values = &psd[0];
+  for (std::size_t first = 0; first < numBands; first += BF_GAIN_BLOCK)
+    {
+      std::size_t size = std::min (BF_GAIN_BLOCK, numBands - first);
+      if (std::all_of (values + first, values + first + size, [] (double v) { return v == 0.0; }))
+        {
+          continue;
+        }
+
+      // exact phasors at the first sub-band of the block
+      double fsb = bands[first].fc;
+      for (std::size_t n = 0; n < numPadded; ++n)
+        {
+          double delay = -2 * M_PI * fsb * (n < numCluster ? clusterDelay[n] : 0.0);
+          std::complex<double> phasor = h[n] * std::complex<double> (cos (delay), sin (delay));
+          sRe[n] = phasor.real ();
+          sIm[n] = phasor.imag ();
+        }
+#ifdef NS3_BF_GAIN_AVX2
+      BeamformingGainBlockAvx2 (values + first, size, sRe, sIm, rRe, rIm, numPadded);
+#else
+      BeamformingGainBlockScalar (values + first, size, sRe, sIm, rRe, rIm, numPadded);
+#endif
+    }
+}
+
+
 PhasedArrayModel::ComplexVector
 ThreeGppSpectrumPropagationLossModel::GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
 {
-  PhasedArrayModel::ComplexVector longTerm; // vector containing the long term component for each cluster
-
   // check if the channel matrix was generated considering a as the s-node and
   // b as the u-node or viceversa
-  PhasedArrayModel::ComplexVector sW, uW;
-  if (!channelMatrix->IsReverse (aPhasedArrayModel->GetId (), bPhasedArrayModel->GetId ()))
-  {
-    sW = aPhasedArrayModel->GetBeamformingVector ();
-    uW = bPhasedArrayModel->GetBeamformingVector ();
-  }
-  else
-  {
-    sW = bPhasedArrayModel->GetBeamformingVector ();
-    uW = aPhasedArrayModel->GetBeamformingVector ();
-  }
-
-  bool update = false; // indicates whether the long term has to be updated
-  bool notFound = false; // indicates if the long term has not been computed yet
+  Ptr<const PhasedArrayModel> sPhasedArrayModel = aPhasedArrayModel;
+  Ptr<const PhasedArrayModel> uPhasedArrayModel = bPhasedArrayModel;
+  if (channelMatrix->IsReverse (aPhasedArrayModel->GetId (), bPhasedArrayModel->GetId ()))
+    {
+      std::swap (sPhasedArrayModel, uPhasedArrayModel);
+    }
+  uint64_t sVersion = sPhasedArrayModel->GetBeamformingVectorVersion ();
+  uint64_t uVersion = uPhasedArrayModel->GetBeamformingVectorVersion ();
 
   // compute the long term key, the key is unique for each tx-rx pair
   uint64_t longTermId = MatrixBasedChannelModel::GetKey (aPhasedArrayModel->GetId (), bPhasedArrayModel->GetId ());
 
-  // look for the long term in the map and check if it is valid
-  if (m_longTermMap.find (longTermId) != m_longTermMap.end ())
+  // look for the long term in the map and check if it is still valid, i.e.,
+  // the channel matrix has not been updated, and the s and u beams have not
+  // been changed
+  auto it = m_longTermMap.find (longTermId);
+  if (it != m_longTermMap.end ()
+      && it->second->m_channel->m_generatedTime == channelMatrix->m_generatedTime
+      && it->second->m_sVersion == sVersion
+      && it->second->m_uVersion == uVersion)
     {
       NS_LOG_DEBUG ("found the long term component in the map");
-      longTerm = m_longTermMap[longTermId]->m_longTerm;
+      ++m_longTermHits;
+      return it->second->m_longTerm;
+    }
 
-      // check if the channel matrix has been updated
-      // or the s beam has been changed
-      // or the u beam has been changed
-      update = (m_longTermMap[longTermId]->m_channel->m_generatedTime != channelMatrix->m_generatedTime
-                || m_longTermMap[longTermId]->m_sW != sW
-                || m_longTermMap[longTermId]->m_uW != uW);
+  NS_LOG_DEBUG ("compute the long term");
+  ++m_longTermMisses;
 
-    }
-  else
-    {
-      NS_LOG_DEBUG ("long term component NOT found");
-      notFound = true;
-    }
+  // compute and store the long term component
+  Ptr<LongTerm> longTermItem = Create<LongTerm> ();
+  longTermItem->m_longTerm = CalcLongTerm (channelMatrix,
+                                           sPhasedArrayModel->GetBeamformingVector (),
+                                           uPhasedArrayModel->GetBeamformingVector ());
+  longTermItem->m_channel = channelMatrix;
+  longTermItem->m_sVersion = sVersion;
+  longTermItem->m_uVersion = uVersion;
+  m_longTermMap[longTermId] = longTermItem;
 
-  if (update || notFound)
-    {
-      NS_LOG_DEBUG ("compute the long term");
-      // compute the long term component
-      longTerm = CalcLongTerm (channelMatrix, sW, uW);
-
-      // store the long term
-      Ptr<LongTerm> longTermItem = Create<LongTerm> ();
-      longTermItem->m_longTerm = longTerm;
-      longTermItem->m_channel = channelMatrix;
-      longTermItem->m_sW = sW;
-      longTermItem->m_uW = uW;
-
-      m_longTermMap[longTermId] = longTermItem;
-    }
+  return longTermItem->m_longTerm;
+}
 
-  return longTerm;
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheHits () const
+{
+  return m_longTermHits;
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheMisses () const
+{
+  return m_longTermMisses;
 }
 
 Ptr<SpectrumValue>
@@ -352,10 +564,41 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
   PhasedArrayModel::ComplexVector longTerm = GetLongTerm (channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
 
   // apply the beamforming gain
-  rxPsd = CalcBeamformingGain (rxPsd, longTerm, channelMatrix, channelParams, a->GetVelocity (), b->GetVelocity ());
+  CalcBeamformingGain (*rxPsd, longTerm, channelMatrix, channelParams, a->GetVelocity (), b->GetVelocity ());
 
   return rxPsd;
 }
 
+PhasedArraySpectrumPropagationLossModel::RxPsdTask
+ThreeGppSpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                                                       Ptr<const MobilityModel> a,
+                                                                       Ptr<const MobilityModel> b,
+                                                                       Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                       Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ASSERT (a->GetObject<Node> ()->GetId () != b->GetObject<Node> ()->GetId ());
+  NS_ASSERT_MSG (a->GetDistanceFrom (b) > 0.0, "The position of a and b devices cannot be the same");
+  NS_ASSERT_MSG (aPhasedArrayModel && bPhasedArrayModel, "Antenna not found");
+
+  Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = m_channelModel->GetChannel (a, b, aPhasedArrayModel, bPhasedArrayModel);
+  Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams = m_channelModel->GetParams (a, b);
+
+  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel.GetNumPages ());
+  PhasedArrayModel::ComplexVector longTerm = GetLongTerm (channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
+  PhasedArrayModel::ComplexVector doppler = CalcDoppler (channelMatrix, channelParams, a->GetVelocity (), b->GetVelocity ());
+  NS_ASSERT (numCluster <= longTerm.size ());
+  NS_ASSERT (numCluster <= channelParams->m_delay.size ());
+
+  // The task owns copies of everything it reads, and refers to the PSD with
+  // a plain pointer, so that it does not touch any reference count
+  SpectrumValue *rxPsd = PeekPointer (psd);
+  return [rxPsd, longTerm = std::move (longTerm), doppler = std::move (doppler),
+          delay = channelParams->m_delay, numCluster] ()
+    {
+      ApplyBeamformingGain (*rxPsd, longTerm, doppler, delay, numCluster);
+    };
+}
 
 }  // namespace ns3
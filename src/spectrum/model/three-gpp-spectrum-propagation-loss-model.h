@@ -96,6 +96,71 @@ public:
    */
   void GetChannelModelAttribute (const std::string &name, AttributeValue &value) const;
 
+  /**
+   * Get the number of times that the cached long term component of a link
+   * was still valid (same channel realization and same beams)
+   * \return the number of hits of the long term cache
+   */
+  uint64_t GetLongTermCacheHits () const;
+
+  /**
+   * Get the number of times that the long term component of a link was
+   * computed, because it was not cached or not valid anymore
+   * \return the number of misses of the long term cache
+   */
+  uint64_t GetLongTermCacheMisses () const;
+
+  /**
+   * Applies the beamforming gain to a PSD, combining the long term component,
+   * the Doppler term and the delay of each cluster. It only touches the PSD,
+   * so that it can run out of the simulation thread.
+   *
+   * The gain of a sub-band is |sum_n h_n exp(-j 2 pi f tau_n)|^2, where h_n
+   * is the product of the long term component and of the Doppler term of
+   * the cluster n. When the sub-bands are uniformly spaced, the phasor of
+   * each cluster is evaluated exactly at the first sub-band of each block of
+   * sub-bands, and advanced through the block by a rotation (one complex
+   * product per cluster and sub-band, instead of a cos and a sin). The
+   * implementation is selected at compile time: with AVX2 available (e.g.,
+   * when building with NS3_NATIVE_OPTIMIZATIONS on a recent x86 CPU), four
+   * clusters are processed at a time; otherwise, a scalar loop with the same
+   * order of the operations is used. With non uniform sub-bands,
+   * ApplyBeamformingGainDirect is used.
+   *
+   * \param psd the PSD
+   * \param longTerm the long term component
+   * \param doppler the Doppler term
+   * \param clusterDelay the delay of each cluster
+   * \param numCluster the number of clusters
+   */
+  static void ApplyBeamformingGain (SpectrumValue &psd,
+                                    const PhasedArrayModel::ComplexVector &longTerm,
+                                    const PhasedArrayModel::ComplexVector &doppler,
+                                    const MatrixBasedChannelModel::DoubleVector &clusterDelay,
+                                    uint8_t numCluster);
+
+  /**
+   * Applies the beamforming gain to a PSD evaluating the phase of each
+   * cluster in each sub-band with a cos and a sin. It is the reference of
+   * ApplyBeamformingGain, and its fallback for non uniform sub-bands.
+   * \param psd the PSD
+   * \param longTerm the long term component
+   * \param doppler the Doppler term
+   * \param clusterDelay the delay of each cluster
+   * \param numCluster the number of clusters
+   */
+  static void ApplyBeamformingGainDirect (SpectrumValue &psd,
+                                          const PhasedArrayModel::ComplexVector &longTerm,
+                                          const PhasedArrayModel::ComplexVector &doppler,
+                                          const MatrixBasedChannelModel::DoubleVector &clusterDelay,
+                                          uint8_t numCluster);
+
+  /**
+   * \return the name of the implementation used by ApplyBeamformingGain
+   * ("avx2" or "scalar")
+   */
+  static const char * GetBeamformingGainImplementationName ();
+
   /**
    * \brief Computes the received PSD.
    *
@@ -123,6 +188,27 @@ public:
                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                    Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
 
+  /**
+   * \brief Computes the received PSD, leaving the application of the
+   * beamforming gain to the returned task.
+   *
+   * The channel matrix, the long term component and the Doppler term are
+   * obtained in this call; the task only combines them over the sub-bands of
+   * the PSD, with the same arithmetic of DoCalcRxPowerSpectralDensity.
+   *
+   * \param psd the tx PSD, replaced by the rx PSD
+   * \param a first node mobility model
+   * \param b second node mobility model
+   * \param aPhasedArrayModel the antenna array of the first node
+   * \param bPhasedArrayModel the antenna array of the second node
+   * \return the task that applies the beamforming gain
+   */
+  RxPsdTask DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> psd,
+                                             Ptr<const MobilityModel> a,
+                                             Ptr<const MobilityModel> b,
+                                             Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                             Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
+
 private:
   /**
    * Data structure that stores the long term component for a tx-rx pair
@@ -131,8 +217,8 @@ private:
   {
     PhasedArrayModel::ComplexVector m_longTerm; //!< vector containing the long term component for each cluster
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel; //!< pointer to the channel matrix used to compute the long term
-    PhasedArrayModel::ComplexVector m_sW; //!< the beamforming vector for the node s used to compute the long term
-    PhasedArrayModel::ComplexVector m_uW; //!< the beamforming vector for the node u used to compute the long term
+    uint64_t m_sVersion; //!< the version of the beamforming vector of the node s used to compute the long term
+    uint64_t m_uVersion; //!< the version of the beamforming vector of the node u used to compute the long term
   };
 
   /**
@@ -143,8 +229,10 @@ private:
 
   /**
    * Looks for the long term component in m_longTermMap. If found, checks
-   * whether it has to be updated. If not found or if it has to be updated,
-   * calls the method CalcLongTerm to compute it.
+   * whether it has to be updated, i.e., if the channel matrix has been
+   * regenerated or if the version of one of the beamforming vectors has
+   * changed. If not found or if it has to be updated, calls the method
+   * CalcLongTerm to compute it.
    * \param channelMatrix the channel matrix
    * \param aPhasedArrayModel the antenna array of the tx device
    * \param bPhasedArrayModel the antenna array of the rx device
@@ -165,22 +253,35 @@ private:
                                                 const PhasedArrayModel::ComplexVector &uW) const;
 
   /**
-   * Computes the beamforming gain and applies it to the tx PSD
-   * \param txPsd the tx PSD
+   * Computes the beamforming gain and applies it to the PSD, in place
+   * \param psd the tx PSD, that becomes the rx PSD
    * \param longTerm the long term component
    * \param channelMatrix The channel matrix structure
    * \param channelParams The channel params structure
    * \param sSpeed speed of the first node
    * \param uSpeed speed of the second node
-   * \return the rx PSD
    */
-  Ptr<SpectrumValue> CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                          PhasedArrayModel::ComplexVector longTerm,
-                                          Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                          Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-                                          const Vector &sSpeed, const Vector &uSpeed) const;
+  void CalcBeamformingGain (SpectrumValue &psd,
+                            const PhasedArrayModel::ComplexVector &longTerm,
+                            Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                            Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                            const Vector &sSpeed, const Vector &uSpeed) const;
+
+  /**
+   * Computes the Doppler term of each cluster
+   * \param channelMatrix The channel matrix structure
+   * \param channelParams The channel params structure
+   * \param sSpeed speed of the first node
+   * \param uSpeed speed of the second node
+   * \return the Doppler term of each cluster
+   */
+  PhasedArrayModel::ComplexVector CalcDoppler (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                               Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                               const Vector &sSpeed, const Vector &uSpeed) const;
 
   mutable std::unordered_map < uint64_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable uint64_t m_longTermHits {0}; //!< number of long term components found valid in m_longTermMap
+  mutable uint64_t m_longTermMisses {0}; //!< number of long term components computed
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
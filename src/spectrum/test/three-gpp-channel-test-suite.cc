@@ -22,6 +22,8 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/string.h"
 #include "ns3/angles.h"
 #include "ns3/pointer.h"
@@ -34,7 +36,11 @@
 #include "ns3/simulator.h"
 #include "ns3/channel-condition-model.h"
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/three-gpp-propagation-loss-model.h"
 #include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/spectrum-signal-parameters.h"
 
 using namespace ns3;
 
@@ -97,7 +103,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   double channelNorm = 0;
-  uint8_t numTotClusters = channelMatrix->m_channel.at (0).at (0).size ();
+  uint8_t numTotClusters = channelMatrix->m_channel.GetNumPages ();
   for (uint8_t cIndex = 0; cIndex < numTotClusters; cIndex++)
   {
     double clusterNorm = 0;
@@ -105,7 +111,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
     {
       for (uint32_t uIndex = 0; uIndex < rxAntennaElements; uIndex++)
       {
-        clusterNorm += std::pow (std::abs (channelMatrix->m_channel.at (uIndex).at (sIndex).at (cIndex)), 2);
+        clusterNorm += std::pow (std::abs (channelMatrix->m_channel (uIndex, sIndex, cIndex)), 2);
       }
     }
     channelNorm += clusterNorm;
@@ -167,8 +173,8 @@ ThreeGppChannelMatrixComputationTest::DoRun (void)
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   // check the channel matrix dimensions
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.at (0).size (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.size (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumCols (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumRows (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
 
   // test if the channel matrix is correctly generated
   uint16_t numIt = 1000;
@@ -577,6 +583,477 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * SpectrumPhy that records the PSDs that it receives
+ */
+class ThreeGppTestRecordingPhy : public SpectrumPhy
+{
+public:
+  /**
+   * A reception: the index of the receiver and the received PSD
+   */
+  typedef std::vector<std::pair<uint32_t, std::vector<double> > > Receptions;
+
+  /**
+   * Constructor
+   * \param index the index of the phy
+   * \param rxModel the spectrum model of the phy
+   * \param antenna the antenna of the phy
+   * \param receptions the list in which the receptions are recorded
+   */
+  ThreeGppTestRecordingPhy (uint32_t index, Ptr<const SpectrumModel> rxModel,
+                            Ptr<PhasedArrayModel> antenna, Receptions *receptions)
+    : m_index (index), m_rxModel (rxModel), m_antenna (antenna), m_receptions (receptions)
+  {
+  }
+
+  // inherited from SpectrumPhy
+  void SetDevice (Ptr<NetDevice> d) override
+  {
+    m_device = d;
+  }
+  Ptr<NetDevice> GetDevice () const override
+  {
+    return m_device;
+  }
+  void SetMobility (Ptr<MobilityModel> m) override
+  {
+    m_mobility = m;
+  }
+  Ptr<MobilityModel> GetMobility () const override
+  {
+    return m_mobility;
+  }
+  void SetChannel (Ptr<SpectrumChannel> c) override
+  {
+  }
+  Ptr<const SpectrumModel> GetRxSpectrumModel () const override
+  {
+    return m_rxModel;
+  }
+  Ptr<Object> GetAntenna () const override
+  {
+    return m_antenna;
+  }
+  void StartRx (Ptr<SpectrumSignalParameters> params) override
+  {
+    m_receptions->emplace_back (m_index, std::vector<double> (params->psd->ConstValuesBegin (),
+                                                              params->psd->ConstValuesEnd ()));
+  }
+
+private:
+  uint32_t m_index;                     //!< the index of the phy
+  Ptr<const SpectrumModel> m_rxModel;   //!< the spectrum model
+  Ptr<PhasedArrayModel> m_antenna;      //!< the antenna
+  Ptr<NetDevice> m_device;              //!< the device
+  Ptr<MobilityModel> m_mobility;        //!< the mobility model
+  Receptions *m_receptions;             //!< the recorded receptions
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the parallel computation of the received PSDs in
+ * MultiModelSpectrumChannel. A transmission is delivered to many receivers,
+ * first computing the PSDs on a pool of threads (which also generates the
+ * channel matrices), then serially: the receptions must be the same, bit by
+ * bit and in the same order.
+ */
+class ThreeGppParallelStartTxTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppParallelStartTxTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+};
+
+ThreeGppParallelStartTxTest::ThreeGppParallelStartTxTest ()
+  : TestCase ("Test case for the parallel computation of the received PSDs")
+{
+}
+
+void
+ThreeGppParallelStartTxTest::DoRun ()
+{
+  const uint32_t numRx = 20;
+
+  Ptr<ChannelConditionModel> condModel = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (2.4e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMa"));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (condModel));
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->AddPhasedArraySpectrumPropagationLossModel (lossModel);
+
+  WifiSpectrumValue5MhzFactory sf;
+  Ptr<SpectrumValue> txPsd = sf.CreateTxPowerSpectralDensity (0.1, 1);
+
+  ThreeGppTestRecordingPhy::Receptions receptions;
+  NodeContainer nodes;
+  nodes.Create (numRx + 1);
+  std::vector<Ptr<ThreeGppTestRecordingPhy> > phys;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      nodes.Get (i)->AddDevice (dev);
+      dev->SetNode (nodes.Get (i));
+
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (i == 0 ? Vector (0.0, 0.0, 25.0)
+                               : Vector (20.0 + 7.0 * i, 3.0 * i - 30.0, 1.5));
+      nodes.Get (i)->AggregateObject (mob);
+
+      Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (i == 0 ? 4 : 2),
+                                                                                      "NumRows", UintegerValue (i == 0 ? 4 : 2),
+                                                                                      "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+      Ptr<ThreeGppTestRecordingPhy> phy = Create<ThreeGppTestRecordingPhy> (i, txPsd->GetSpectrumModel (), antenna, &receptions);
+      phy->SetDevice (dev);
+      phy->SetMobility (mob);
+      if (i > 0)
+        {
+          channel->AddRx (phy);
+        }
+      phys.push_back (phy);
+    }
+
+  // point the gNB beam to the first receiver, and the receivers to the gNB
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<MobilityModel> other = nodes.Get (i == 0 ? 1 : 0)->GetObject<MobilityModel> ();
+      Ptr<PhasedArrayModel> antenna = DynamicCast<PhasedArrayModel> (phys[i]->GetAntenna ());
+      Angles angles (other->GetPosition (), phys[i]->GetMobility ()->GetPosition ());
+      antenna->SetBeamformingVector (antenna->GetBeamformingVector (angles));
+    }
+
+  Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters> ();
+  txParams->psd = txPsd;
+  txParams->txPhy = phys[0];
+  txParams->duration = MilliSeconds (1);
+
+  Simulator::Schedule (MilliSeconds (1), [channel, txParams] ()
+    {
+      channel->SetAttribute ("NumThreads", UintegerValue (4));
+      channel->StartTx (txParams);
+      channel->SetAttribute ("NumThreads", UintegerValue (1));
+      channel->StartTx (txParams);
+    });
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (receptions.size (), 2 * numRx, "Wrong number of receptions");
+  for (uint32_t i = 0; i < numRx; ++i)
+    {
+      const auto &parallel = receptions[i];
+      const auto &serial = receptions[numRx + i];
+      NS_TEST_ASSERT_MSG_EQ (parallel.first, serial.first, "Different order of the receptions");
+      NS_TEST_ASSERT_MSG_EQ ((parallel.second == serial.second), true,
+                             "Different PSD at receiver " << serial.first);
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the caches of the static links: the pathloss cache of
+ * MultiModelSpectrumChannel and the long term cache of
+ * ThreeGppSpectrumPropagationLossModel. The same sequence of transmissions,
+ * from the first evaluation of the links, is run without and with the
+ * pathloss cache, and the receptions must be the same, bit by bit; a beam
+ * change must invalidate only the long term component of its link, and a
+ * course change only the pathloss of the links of the node that moved.
+ */
+class ThreeGppLinkCacheTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppLinkCacheTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Run the sequence of transmissions of the test, with the same random
+   * streams at each call
+   * \param pathLossCache the value of the attribute PathLossCache
+   * \param receptions the receptions of each transmission
+   */
+  void RunScenario (bool pathLossCache, std::vector<ThreeGppTestRecordingPhy::Receptions> *receptions);
+
+  static const uint32_t m_numRx = 5;  //!< Number of receivers
+  static const uint32_t m_numTx = 5;  //!< Transmissions before the beam change
+};
+
+ThreeGppLinkCacheTest::ThreeGppLinkCacheTest ()
+  : TestCase ("Test case for the pathloss and long term caches of the static links")
+{
+}
+
+void
+ThreeGppLinkCacheTest::RunScenario (bool pathLossCache, std::vector<ThreeGppTestRecordingPhy::Receptions> *results)
+{
+  const uint32_t numRx = m_numRx;
+
+  Ptr<ChannelConditionModel> condModel = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  condModel->AssignStreams (1);
+  Ptr<ThreeGppPropagationLossModel> propagationLoss = CreateObject<ThreeGppUmaPropagationLossModel> ();
+  propagationLoss->SetAttribute ("Frequency", DoubleValue (2.4e9));
+  propagationLoss->SetChannelConditionModel (condModel);
+  propagationLoss->AssignStreams (10);
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (2.4e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMa"));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (condModel));
+  DynamicCast<ThreeGppChannelModel> (lossModel->GetChannelModel ())->AssignStreams (100);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (propagationLoss);
+  channel->AddPhasedArraySpectrumPropagationLossModel (lossModel);
+  channel->SetAttribute ("PathLossCache", BooleanValue (pathLossCache));
+
+  WifiSpectrumValue5MhzFactory sf;
+  Ptr<SpectrumValue> txPsd = sf.CreateTxPowerSpectralDensity (0.1, 1);
+
+  ThreeGppTestRecordingPhy::Receptions receptions;
+  NodeContainer nodes;
+  nodes.Create (numRx + 1);
+  std::vector<Ptr<ThreeGppTestRecordingPhy> > phys;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      nodes.Get (i)->AddDevice (dev);
+      dev->SetNode (nodes.Get (i));
+
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (i == 0 ? Vector (0.0, 0.0, 25.0)
+                               : Vector (30.0 + 11.0 * i, 5.0 * i - 20.0, 1.5));
+      nodes.Get (i)->AggregateObject (mob);
+
+      Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (2),
+                                                                                      "NumRows", UintegerValue (2),
+                                                                                      "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+      Ptr<ThreeGppTestRecordingPhy> phy = Create<ThreeGppTestRecordingPhy> (i, txPsd->GetSpectrumModel (), antenna, &receptions);
+      phy->SetDevice (dev);
+      phy->SetMobility (mob);
+      if (i > 0)
+        {
+          channel->AddRx (phy);
+        }
+      phys.push_back (phy);
+    }
+
+  auto pointBeam = [&phys] (uint32_t i, uint32_t j)
+    {
+      Ptr<PhasedArrayModel> antenna = DynamicCast<PhasedArrayModel> (phys[i]->GetAntenna ());
+      Angles angles (phys[j]->GetMobility ()->GetPosition (), phys[i]->GetMobility ()->GetPosition ());
+      antenna->SetBeamformingVector (antenna->GetBeamformingVector (angles));
+    };
+  for (uint32_t i = 1; i < nodes.GetN (); ++i)
+    {
+      pointBeam (i, 0);
+    }
+  pointBeam (0, 1);
+
+  Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters> ();
+  txParams->psd = txPsd;
+  txParams->txPhy = phys[0];
+  txParams->duration = MilliSeconds (1);
+
+  auto transmit = [&] ()
+    {
+      receptions.clear ();
+      channel->StartTx (txParams);
+      Simulator::Run ();
+      NS_TEST_EXPECT_MSG_EQ (receptions.size (), numRx, "Wrong number of receptions");
+      results->push_back (receptions);
+    };
+
+  // ThreeGppPropagationLossModel draws the shadowing of a link at its first
+  // two evaluations (the first one does not store the distance vector), so
+  // the cache reuses the pathloss from the fourth one
+  for (uint32_t k = 0; k < m_numTx; ++k)
+    {
+      transmit ();
+    }
+  if (pathLossCache)
+    {
+      NS_TEST_EXPECT_MSG_EQ (channel->GetPathLossCacheMisses (), 3 * numRx, "Wrong pathloss cache misses");
+      NS_TEST_EXPECT_MSG_EQ (channel->GetPathLossCacheHits (), (m_numTx - 3) * numRx, "Wrong pathloss cache hits");
+    }
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLongTermCacheMisses (), numRx, "Wrong long term cache misses");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLongTermCacheHits (), (m_numTx - 1) * numRx, "Wrong long term cache hits");
+
+  // setting the same beam again is not a beam change
+  pointBeam (1, 0);
+  transmit ();
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLongTermCacheMisses (), numRx, "Same beam handled as a beam change");
+
+  // a beam change only invalidates the long term component of its link
+  pointBeam (1, 2);
+  transmit ();
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLongTermCacheMisses (), numRx + 1, "Wrong long term cache misses after a beam change");
+  if (pathLossCache)
+    {
+      NS_TEST_EXPECT_MSG_EQ (channel->GetPathLossCacheHits (), (m_numTx - 1) * numRx, "Beam change invalidated the pathloss");
+    }
+
+  // a course change only invalidates the pathloss of the links of its node,
+  // which is computed twice again before it is reused
+  phys[2]->GetMobility ()->SetPosition (Vector (80.0, 40.0, 1.5));
+  transmit ();
+  transmit ();
+  transmit ();
+  if (pathLossCache)
+    {
+      NS_TEST_EXPECT_MSG_EQ (channel->GetPathLossCacheMisses (), 3 * numRx + 2, "Wrong pathloss cache misses after a course change");
+      NS_TEST_EXPECT_MSG_EQ (channel->GetPathLossCacheHits (), (m_numTx + 2) * numRx - 2, "Wrong pathloss cache hits after a course change");
+    }
+
+  Simulator::Destroy ();
+}
+
+void
+ThreeGppLinkCacheTest::DoRun ()
+{
+  std::vector<ThreeGppTestRecordingPhy::Receptions> reference;
+  std::vector<ThreeGppTestRecordingPhy::Receptions> cached;
+  RunScenario (false, &reference);
+  RunScenario (true, &cached);
+
+  NS_TEST_ASSERT_MSG_EQ (cached.size (), reference.size (), "Different number of transmissions");
+  for (uint32_t k = 0; k < reference.size (); ++k)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((cached[k] == reference[k]), true, "Different receptions with the cache at transmission " << k);
+    }
+
+  // the beam change affects only its link, the course change only the links of its node
+  const auto &beforeBeam = reference[m_numTx];
+  const auto &newBeam = reference[m_numTx + 1];
+  const auto &newCourse = reference[m_numTx + 2];
+  NS_TEST_ASSERT_MSG_EQ ((newBeam[0].second != beforeBeam[0].second), true, "Beam change not applied");
+  NS_TEST_ASSERT_MSG_EQ ((newCourse[1].second != newBeam[1].second), true, "Course change not applied");
+  for (uint32_t i = 1; i < m_numRx; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((newBeam[i] == beforeBeam[i]), true, "Beam change affected another link");
+    }
+  for (uint32_t i = 0; i < m_numRx; ++i)
+    {
+      if (i != 1)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((newCourse[i] == newBeam[i]), true, "Course change affected another link");
+        }
+    }
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the kernel that applies the beamforming gain. On uniformly
+ * spaced sub-bands, the recurrence of ApplyBeamformingGain must agree with
+ * the direct evaluation of ApplyBeamformingGainDirect, up to a small
+ * fraction of the power of the clusters, and leave the null sub-bands null.
+ * On non uniform sub-bands, the direct evaluation must be used.
+ */
+class ThreeGppBeamformingGainTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppBeamformingGainTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+};
+
+ThreeGppBeamformingGainTest::ThreeGppBeamformingGainTest ()
+  : TestCase ("Test case for the kernel of the beamforming gain")
+{
+}
+
+void
+ThreeGppBeamformingGainTest::DoRun ()
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  for (uint8_t numCluster : {1, 12, 23, 24, 64})
+    {
+      PhasedArrayModel::ComplexVector longTerm;
+      PhasedArrayModel::ComplexVector doppler;
+      MatrixBasedChannelModel::DoubleVector delay;
+      double power = 0.0; // the gain if all the clusters were in phase
+      for (uint8_t n = 0; n < numCluster; ++n)
+        {
+          longTerm.push_back (std::polar (rng->GetValue (1e-4, 1e-2), rng->GetValue (0.0, 2 * M_PI)));
+          doppler.push_back (std::polar (1.0, rng->GetValue (0.0, 2 * M_PI)));
+          delay.push_back (rng->GetValue (0.0, 3e-6));
+          power += std::abs (longTerm.back ());
+        }
+      power *= power;
+
+      // 273 RBs at 28 GHz, with a hole in the allocation and a null RB
+      std::vector<double> centerFreqs;
+      for (uint32_t k = 0; k < 273; ++k)
+        {
+          centerFreqs.push_back (28e9 + k * 360e3);
+        }
+      Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (Create<SpectrumModel> (centerFreqs));
+      for (uint32_t k = 0; k < 273; ++k)
+        {
+          (*txPsd)[k] = (k >= 40 && k < 110) || k == 200 ? 0.0 : rng->GetValue (1e-10, 1e-9);
+        }
+
+      SpectrumValue direct = *txPsd;
+      ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGainDirect (direct, longTerm, doppler, delay, numCluster);
+      SpectrumValue recurrence = *txPsd;
+      ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGain (recurrence, longTerm, doppler, delay, numCluster);
+
+      for (uint32_t k = 0; k < 273; ++k)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (recurrence[k], direct[k], 1e-9 * power * (*txPsd)[k],
+                                     "Wrong gain of RB " << k << " with " << +numCluster << " clusters");
+          if ((*txPsd)[k] == 0.0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (recurrence[k], 0.0, "Gain applied to the null RB " << k);
+            }
+        }
+
+      // non uniform sub-bands
+      centerFreqs[100] += 1e3;
+      Ptr<SpectrumValue> nonUniform = Create<SpectrumValue> (Create<SpectrumModel> (centerFreqs));
+      for (uint32_t k = 0; k < 273; ++k)
+        {
+          (*nonUniform)[k] = (*txPsd)[k];
+        }
+      SpectrumValue nonUniformDirect = *nonUniform;
+      ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGainDirect (nonUniformDirect, longTerm, doppler, delay, numCluster);
+      ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGain (*nonUniform, longTerm, doppler, delay, numCluster);
+      for (uint32_t k = 0; k < 273; ++k)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((*nonUniform)[k], nonUniformDirect[k], "Non uniform sub-bands not evaluated directly");
+        }
+    }
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -597,6 +1074,9 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppParallelStartTxTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppLinkCacheTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppBeamformingGainTest, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
 #include <string.h>
 
 #include "ns3/core-module.h"
@@ -208,6 +209,8 @@ int main (int argc, char *argv[])
   bool schedList          = false;
   bool schedMap           = true;
   bool schedPriorityQueue = false;
+  bool schedWheel         = false;
+  Time wheelGranularity   = MicroSeconds (1);
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
@@ -230,6 +233,8 @@ int main (int argc, char *argv[])
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("pri",   "use PriorityQueue",             schedPriorityQueue);
+  cmd.AddValue ("wheel", "use TimingWheelScheduler",      schedWheel);
+  cmd.AddValue ("granularity", "tick of the TimingWheelScheduler", wheelGranularity);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
@@ -258,6 +263,11 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::PriorityQueueScheduler");
     }
+  if (schedWheel)
+    {
+      factory.SetTypeId ("ns3::TimingWheelScheduler");
+      factory.Set ("Granularity", TimeValue (wheelGranularity));
+    }
       
   Simulator::SetScheduler (factory);
 
@@ -269,6 +279,10 @@ int main (int argc, char *argv[])
     {
       order = ": insertion order: " + std::string (calRev ? "reverse" : "normal");
     }
+  if (schedWheel)
+    {
+      order = ": granularity: " + std::to_string (wheelGranularity.GetNanoSeconds ()) + " ns";
+    }
   LOGME ("scheduler: " << factory.GetTypeId ().GetName () << order);
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
@@ -314,6 +328,13 @@ int main (int argc, char *argv[])
       bench->RunBench ();
     }
 
+  // Without the event free lists, every event would come from the heap
+  EventImpl::AllocationStats stats = EventImpl::GetAllocationStats ();
+  LOG ("");
+  LOGME ("event allocations: " << stats.m_allocations
+         << ", from the heap: " << stats.m_heapAllocations
+         << " (" << 100.0 * stats.m_heapAllocations / std::max<uint64_t> (stats.m_allocations, 1)
+         << "%)");
   LOG ("");
   Simulator::Destroy ();
   delete bench;